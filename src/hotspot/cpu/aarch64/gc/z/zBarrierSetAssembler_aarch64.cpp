@@ -71,15 +71,25 @@ void ZBarrierSetAssembler::load_at(MacroAssembler* masm,
 
   Label done;
 
+  // The field address is only needed in the slow path, but must be
+  // computed before the load if dst is used by the address.
+  const bool early_lea = src.uses(dst);
+
   // Load bad mask into scratch register.
   __ ldr(rscratch1, address_bad_mask_from_thread(rthread));
-  __ lea(rscratch2, src);
+  if (early_lea) {
+    __ lea(rscratch2, src);
+  }
   __ ldr(dst, src);
 
   // Test reference against bad mask. If mask bad, then we need to fix it up.
   __ tst(dst, rscratch1);
   __ br(Assembler::EQ, done);
 
+  if (!early_lea) {
+    __ lea(rscratch2, src);
+  }
+
   __ enter();
 
   __ push(savedRegs, sp);
@@ -334,6 +344,10 @@ OptoReg::Name ZBarrierSetAssembler::refine_register(const Node* node, OptoReg::N
   return opto_reg;
 }
 
+void ZBarrierSetAssembler::remove_register(RegMask& live, OptoReg::Name opto_reg) {
+  live.Remove(opto_reg);
+}
+
 #undef __
 #define __ _masm->
 
@@ -460,6 +474,12 @@ void ZBarrierSetAssembler::generate_c2_load_barrier_stub(MacroAssembler* masm, Z
     __ blr(rscratch1);
   }
 
+  if (stub->is_cas()) {
+    // Retry the CAS, now that the field has been healed
+    __ cmpxchg(stub->ref_addr().base(), stub->cas_oldval(), stub->cas_newval(), Assembler::xword,
+               stub->cas_acquire(), true /* release */, false /* weak */, stub->ref());
+  }
+
   // Stub exit
   __ b(*stub->continuation());
 }
@@ -92,6 +92,9 @@ public:
   OptoReg::Name refine_register(const Node* node,
                                 OptoReg::Name opto_reg);
 
+  void remove_register(RegMask& live,
+                       OptoReg::Name opto_reg);
+
   void generate_c2_load_barrier_stub(MacroAssembler* masm,
                                      ZLoadBarrierStubC2* stub) const;
 #endif // COMPILER2
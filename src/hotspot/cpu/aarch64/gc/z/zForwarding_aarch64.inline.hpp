@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef CPU_AARCH64_GC_Z_ZFORWARDING_AARCH64_INLINE_HPP
+#define CPU_AARCH64_GC_Z_ZFORWARDING_AARCH64_INLINE_HPP
+
+#include "gc/z/zGlobals.hpp"
+#include "utilities/count_trailing_zeros.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+// Returns the index of the first of ZForwardingProbeLength entries that is
+// either empty or matches the probe key, or ZForwardingProbeLength if none.
+inline size_t ZPlatformForwardingProbe(const volatile uint64_t* entries, uint64_t probe_key, uint64_t probe_mask) {
+  STATIC_ASSERT(ZForwardingProbeLength == 8);
+
+  // Compare two entries per NEON register. LD1 reads each aligned entry
+  // single-copy atomically. The comparison results are narrowed to one
+  // byte per entry, since there is no equivalent of a move mask.
+  uint64_t hits;
+  __asm__ volatile ("dup   v4.2d, %[key]\n\t"
+                    "dup   v5.2d, %[mask]\n\t"
+                    "ld1   {v0.2d, v1.2d, v2.2d, v3.2d}, [%[entries]]\n\t"
+                    "and   v6.16b, v0.16b, v5.16b\n\t"
+                    "cmeq  v6.2d, v6.2d, v4.2d\n\t"
+                    "cmeq  v0.2d, v0.2d, #0\n\t"
+                    "orr   v0.16b, v0.16b, v6.16b\n\t"
+                    "and   v6.16b, v1.16b, v5.16b\n\t"
+                    "cmeq  v6.2d, v6.2d, v4.2d\n\t"
+                    "cmeq  v1.2d, v1.2d, #0\n\t"
+                    "orr   v1.16b, v1.16b, v6.16b\n\t"
+                    "and   v6.16b, v2.16b, v5.16b\n\t"
+                    "cmeq  v6.2d, v6.2d, v4.2d\n\t"
+                    "cmeq  v2.2d, v2.2d, #0\n\t"
+                    "orr   v2.16b, v2.16b, v6.16b\n\t"
+                    "and   v6.16b, v3.16b, v5.16b\n\t"
+                    "cmeq  v6.2d, v6.2d, v4.2d\n\t"
+                    "cmeq  v3.2d, v3.2d, #0\n\t"
+                    "orr   v3.16b, v3.16b, v6.16b\n\t"
+                    "xtn   v6.2s, v0.2d\n\t"
+                    "xtn2  v6.4s, v1.2d\n\t"
+                    "xtn   v7.2s, v2.2d\n\t"
+                    "xtn2  v7.4s, v3.2d\n\t"
+                    "xtn   v6.4h, v6.4s\n\t"
+                    "xtn2  v6.8h, v7.4s\n\t"
+                    "xtn   v6.8b, v6.8h\n\t"
+                    "umov  %[hits], v6.d[0]"
+                    : [hits] "=r" (hits)
+                    : [entries] "r" (entries), [key] "r" (probe_key), [mask] "r" (probe_mask)
+                    : "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "memory");
+
+  return hits != 0 ? count_trailing_zeros(hits) / BitsPerByte : ZForwardingProbeLength;
+}
+
+#endif // CPU_AARCH64_GC_Z_ZFORWARDING_AARCH64_INLINE_HPP
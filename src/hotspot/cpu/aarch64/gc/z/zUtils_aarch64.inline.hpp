@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef CPU_AARCH64_GC_Z_ZUTILS_AARCH64_INLINE_HPP
+#define CPU_AARCH64_GC_Z_ZUTILS_AARCH64_INLINE_HPP
+
+#include "runtime/vm_version.hpp"
+#include "utilities/align.hpp"
+#include "utilities/debug.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+inline void ZPlatformObjectCopyNonTemporal(uintptr_t from, uintptr_t to, size_t size) {
+  assert(is_aligned(size, BytesPerWord), "Size not word aligned");
+
+  // Copy pairs of words using LDNP/STNP. The new address of the object
+  // is published with release semantics, which also orders these stores.
+  const uintptr_t end = from + align_down(size, 2 * BytesPerWord);
+  for (; from < end; from += 2 * BytesPerWord, to += 2 * BytesPerWord) {
+    uint64_t lo;
+    uint64_t hi;
+    __asm__ volatile ("ldnp %0, %1, [%2]" : "=&r" (lo), "=&r" (hi) : "r" (from) : "memory");
+    __asm__ volatile ("stnp %0, %1, [%2]" : : "r" (lo), "r" (hi), "r" (to) : "memory");
+  }
+
+  if (!is_aligned(size, 2 * BytesPerWord)) {
+    // Copy last word
+    *(uint64_t*)to = *(const uint64_t*)from;
+  }
+}
+
+inline void ZPlatformZeroNonTemporal(uintptr_t addr, size_t size) {
+  assert(is_aligned(addr, BytesPerWord), "Address not word aligned");
+  assert(is_aligned(size, BytesPerWord), "Size not word aligned");
+
+  const uintptr_t end = addr + size;
+
+  if (VM_Version::is_zva_enabled()) {
+    // Zero whole blocks using DC ZVA, which zeroes the cache lines
+    // without first reading them from memory. The unaligned head is
+    // zeroed using plain stores, and the tail as below.
+    const size_t block_size = VM_Version::zva_length();
+    const uintptr_t block_start = align_up(addr, block_size);
+    const uintptr_t block_end = align_down(end, block_size);
+    if (block_start < block_end) {
+      for (; addr < block_start; addr += BytesPerWord) {
+        *(uint64_t*)addr = 0;
+      }
+
+      for (; addr < block_end; addr += block_size) {
+        __asm__ volatile ("dc zva, %0" : : "r" (addr) : "memory");
+      }
+    }
+  }
+
+  // Zero pairs of words using STNP
+  const uintptr_t pair_end = addr + align_down(end - addr, 2 * BytesPerWord);
+  for (; addr < pair_end; addr += 2 * BytesPerWord) {
+    __asm__ volatile ("stnp xzr, xzr, [%0]" : : "r" (addr) : "memory");
+  }
+
+  if (addr < end) {
+    // Zero last word
+    *(uint64_t*)addr = 0;
+  }
+}
+
+#endif // CPU_AARCH64_GC_Z_ZUTILS_AARCH64_INLINE_HPP
@@ -94,26 +94,51 @@ void ZBarrierSetAssembler::load_at(MacroAssembler* masm,
   Register scratch = tmp1;
   if (tmp1 == noreg) {
     scratch = r12;
-    __ push(scratch);
   }
 
   assert_different_registers(dst, scratch);
 
+  // The address is only needed in the slow path, but must be computed
+  // before the load if dst is used by the address, and before the push
+  // of the scratch register if rsp is used by the address.
+  const bool early_lea = src.uses(dst) || src.uses(rsp);
+
   Label done;
+  Label done_fast;
 
   //
   // Fast Path
   //
 
-  // Load address
-  __ lea(scratch, src);
+  if (early_lea) {
+    if (tmp1 == noreg) {
+      __ push(scratch);
+    }
 
-  // Load oop at address
-  __ movptr(dst, Address(scratch, 0));
+    // Load address
+    __ lea(scratch, src);
 
-  // Test address bad mask
-  __ testptr(dst, address_bad_mask_from_thread(r15_thread));
-  __ jcc(Assembler::zero, done);
+    // Load oop at address
+    __ movptr(dst, Address(scratch, 0));
+
+    // Test address bad mask
+    __ testptr(dst, address_bad_mask_from_thread(r15_thread));
+    __ jcc(Assembler::zero, done);
+  } else {
+    // Load oop at address
+    __ movptr(dst, src);
+
+    // Test address bad mask
+    __ testptr(dst, address_bad_mask_from_thread(r15_thread));
+    __ jcc(Assembler::zero, done_fast);
+
+    if (tmp1 == noreg) {
+      __ push(scratch);
+    }
+
+    // Load address
+    __ lea(scratch, src);
+  }
 
   //
   // Slow path
@@ -183,6 +208,8 @@ void ZBarrierSetAssembler::load_at(MacroAssembler* masm,
     __ pop(scratch);
   }
 
+  __ bind(done_fast);
+
   BLOCK_COMMENT("} ZBarrierSetAssembler::load_at");
 }
 
@@ -373,6 +400,21 @@ OptoReg::Name ZBarrierSetAssembler::refine_register(const Node* node, OptoReg::N
   return opto_reg;
 }
 
+void ZBarrierSetAssembler::remove_register(RegMask& live, OptoReg::Name opto_reg) {
+  const VMReg vm_reg = OptoReg::as_VMReg(opto_reg);
+  if (vm_reg->is_XMMRegister()) {
+    // A definition kills all live parts of the register, regardless
+    // of the size it was previously used with
+    opto_reg &= ~15;
+    live.Remove(opto_reg | 1);
+    live.Remove(opto_reg | 2);
+    live.Remove(opto_reg | 4);
+    live.Remove(opto_reg | 8);
+  } else {
+    live.Remove(opto_reg);
+  }
+}
+
 // We use the vec_spill_helper from the x86.ad file to avoid reinventing this wheel
 extern int vec_spill_helper(CodeBuffer *cbuf, bool do_size, bool is_load,
                             int stack_offset, int reg, uint ireg, outputStream* st);
@@ -427,6 +469,13 @@ private:
     }
   }
 
+#ifdef _WINDOWS
+  static bool xmm_is_callee_saved(XMMRegister reg) {
+    // On Windows, xmm6-xmm15 are callee saved, but only the lower 128 bits
+    return reg->encoding() >= xmm6->encoding() && reg->encoding() <= xmm15->encoding();
+  }
+#endif
+
   bool xmm_needs_vzeroupper() const {
     return _xmm_registers.is_nonempty() && _xmm_registers.at(0)._size > 16;
   }
@@ -496,6 +545,12 @@ private:
         const VMReg vm_reg_base = OptoReg::as_VMReg(opto_reg & ~15);
         const int reg_size = xmm_slot_size(opto_reg);
         const XMMRegisterData reg_data = { vm_reg_base->as_XMMRegister(), reg_size };
+#ifdef _WINDOWS
+        if (xmm_is_callee_saved(reg_data._reg) && reg_size <= 16) {
+          // The lower 128 bits are preserved by the callee
+          continue;
+        }
+#endif
         const int reg_index = _xmm_registers.find(reg_data);
         if (reg_index == -1) {
           // Not previously appended
@@ -664,6 +719,14 @@ void ZBarrierSetAssembler::generate_c2_load_barrier_stub(MacroAssembler* masm, Z
     __ call(RuntimeAddress(stub->slow_path()));
   }
 
+  if (stub->is_cas()) {
+    // Retry the CAS, now that the field has been healed
+    assert(stub->ref() == rax, "Invalid register");
+    __ movptr(rax, stub->cas_oldval());
+    __ lock();
+    __ cmpxchgptr(stub->cas_newval(), stub->ref_addr());
+  }
+
   // Stub exit
   __ jmp(*stub->continuation());
 }
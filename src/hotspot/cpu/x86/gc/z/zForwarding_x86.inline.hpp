@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef CPU_X86_GC_Z_ZFORWARDING_X86_INLINE_HPP
+#define CPU_X86_GC_Z_ZFORWARDING_X86_INLINE_HPP
+
+#include "gc/z/zGlobals.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/vm_version.hpp"
+#include "utilities/count_trailing_zeros.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+#if defined(TARGET_COMPILER_gcc) || defined(TARGET_COMPILER_visCPP)
+#include <immintrin.h>
+
+#if defined(TARGET_COMPILER_gcc)
+// The VM is not compiled for AVX2, so enable it for this function only.
+// It is only called after checking that the processor supports AVX2.
+#define Z_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define Z_TARGET_AVX2
+#endif
+
+// Returns a bit mask with one bit per entry that is either empty or matches
+// the probe key. Compares four entries per AVX2 register. Each aligned entry
+// is read as a whole, like when read using Atomic::load().
+Z_TARGET_AVX2 inline uint32_t ZPlatformForwardingProbeAVX2(const volatile uint64_t* entries, uint64_t probe_key, uint64_t probe_mask) {
+  const __m256i key = _mm256_set1_epi64x((long long)probe_key);
+  const __m256i mask = _mm256_set1_epi64x((long long)probe_mask);
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i low = _mm256_loadu_si256((const __m256i*)entries);
+  const __m256i high = _mm256_loadu_si256((const __m256i*)(entries + 4));
+  const __m256i hits_low = _mm256_or_si256(_mm256_cmpeq_epi64(low, zero),
+                                           _mm256_cmpeq_epi64(_mm256_and_si256(low, mask), key));
+  const __m256i hits_high = _mm256_or_si256(_mm256_cmpeq_epi64(high, zero),
+                                            _mm256_cmpeq_epi64(_mm256_and_si256(high, mask), key));
+  return (uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(hits_low)) |
+         ((uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(hits_high)) << 4);
+}
+
+#undef Z_TARGET_AVX2
+#define Z_FORWARDING_PROBE_AVX2
+#endif
+
+// Returns the index of the first of ZForwardingProbeLength entries that is
+// either empty or matches the probe key, or ZForwardingProbeLength if none.
+inline size_t ZPlatformForwardingProbe(const volatile uint64_t* entries, uint64_t probe_key, uint64_t probe_mask) {
+  STATIC_ASSERT(ZForwardingProbeLength == 8);
+
+#ifdef Z_FORWARDING_PROBE_AVX2
+  if (VM_Version::supports_avx2()) {
+    const uint32_t hits = ZPlatformForwardingProbeAVX2(entries, probe_key, probe_mask);
+    return hits != 0 ? count_trailing_zeros(hits) : ZForwardingProbeLength;
+  }
+#endif
+
+  for (size_t i = 0; i < ZForwardingProbeLength; i++) {
+    const uint64_t entry = Atomic::load(entries + i);
+    if (entry == 0 || (entry & probe_mask) == probe_key) {
+      return i;
+    }
+  }
+
+  return ZForwardingProbeLength;
+}
+
+#endif // CPU_X86_GC_Z_ZFORWARDING_X86_INLINE_HPP
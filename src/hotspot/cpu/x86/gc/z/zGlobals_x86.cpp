@@ -23,13 +23,30 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zGlobals.hpp"
+#include "logging/log.hpp"
 #include "runtime/globals.hpp"
+#include "runtime/os.hpp"
+#include "utilities/count_leading_zeros.hpp"
 #include "utilities/globalDefinitions.hpp"
 #include "utilities/powerOfTwo.hpp"
 
+#ifdef LINUX
+#include <sys/mman.h>
+#endif // LINUX
+
 //
 // The heap can have three different layouts, depending on the max heap size.
 //
+// With 4-level page tables the highest valid virtual address bit is 46,
+// which limits the object offset to 44 bits (16TB). With 5-level page
+// tables the highest valid bit is 55, but the object offset is still
+// capped at ZAddressOffsetBitsMax (44 bits, 16TB), since offsets must fit
+// in the packed encodings of mark stack and forwarding entries. A larger
+// address space only gives more room for the layouts below. The metadata
+// bits always sit directly above the object offset, so the Remapped view
+// always fits below the highest valid address bit. See
+// probe_valid_max_address_bit() below.
+//
 // Address Space & Pointer Layout 1
 // --------------------------------
 //
@@ -135,9 +152,72 @@
 //  * 63-48 Fixed (16-bits, always zero)
 //
 
+// Default value if probing is not implemented for a certain platform: 128TB
+static const size_t DEFAULT_MAX_ADDRESS_BIT = 47;
+// Highest address bit to probe, covering 5-level page tables: 64PB
+static const size_t PROBE_MAX_ADDRESS_BIT = 56;
+// Minimum value returned, if probing fails: 64GB
+static const size_t MINIMUM_MAX_ADDRESS_BIT = 36;
+
+static size_t probe_valid_max_address_bit() {
+#ifdef LINUX
+  size_t max_address_bit = 0;
+  const size_t page_size = os::vm_page_size();
+  for (size_t i = PROBE_MAX_ADDRESS_BIT; i > MINIMUM_MAX_ADDRESS_BIT; --i) {
+    const uintptr_t base_addr = ((uintptr_t)1U) << i;
+    if (msync((void*)base_addr, page_size, MS_ASYNC) == 0) {
+      // msync succeeded, the address is valid, and maybe even already mapped
+      max_address_bit = i;
+      break;
+    }
+
+    if (errno != ENOMEM) {
+      // Some error occurred. This should never happen, but msync
+      // has some undefined behavior, hence ignore this bit.
+      continue;
+    }
+
+    // Since msync failed with ENOMEM, the page might not be mapped.
+    // Try to map it, to see if the address is valid. The kernel only
+    // hands out addresses above 47 bits when explicitly asked to, and
+    // otherwise returns a lower address, which means invalid here.
+    void* const result_addr = mmap((void*)base_addr, page_size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
+    if (result_addr != MAP_FAILED) {
+      munmap(result_addr, page_size);
+    }
+
+    if ((uintptr_t)result_addr == base_addr) {
+      // Address is valid
+      max_address_bit = i;
+      break;
+    }
+  }
+
+  if (max_address_bit == 0) {
+    // Probing failed, allocate a very high page and take that bit as the maximum
+    const uintptr_t high_addr = ((uintptr_t)1U) << DEFAULT_MAX_ADDRESS_BIT;
+    void* const result_addr = mmap((void*)high_addr, page_size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
+    if (result_addr != MAP_FAILED) {
+      max_address_bit = BitsPerSize_t - count_leading_zeros((size_t)result_addr) - 1;
+      munmap(result_addr, page_size);
+    }
+  }
+
+  log_info(gc, init)("Probing address space for the highest valid bit: " SIZE_FORMAT, max_address_bit);
+  return MAX2(max_address_bit, MINIMUM_MAX_ADDRESS_BIT);
+#else // LINUX
+  return DEFAULT_MAX_ADDRESS_BIT;
+#endif // LINUX
+}
+
 size_t ZPlatformAddressOffsetBits() {
-  const size_t min_address_offset_bits = 42; // 4TB
-  const size_t max_address_offset_bits = 44; // 16TB
+  // The metadata bits (4 bits) start directly above the object offset, and
+  // the highest metadata bit (Finalizable) does not need a valid address.
+  // The offset is also capped at what the packed encodings of offsets,
+  // in forwarding and mark stack entries, can hold.
+  static const size_t valid_max_address_offset_bits = probe_valid_max_address_bit() + 1;
+  const size_t max_address_offset_bits = MIN2(valid_max_address_offset_bits - 3, ZAddressOffsetBitsMax);
+  const size_t min_address_offset_bits = MIN2(max_address_offset_bits, (size_t)42); // 4TB
   const size_t address_offset = round_up_power_of_2(MaxHeapSize * ZVirtualToPhysicalRatio);
   const size_t address_offset_bits = log2_intptr(address_offset);
   return clamp(address_offset_bits, min_address_offset_bits, max_address_offset_bits);
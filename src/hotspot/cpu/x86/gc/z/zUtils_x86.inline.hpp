@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef CPU_X86_GC_Z_ZUTILS_X86_INLINE_HPP
+#define CPU_X86_GC_Z_ZUTILS_X86_INLINE_HPP
+
+#include "utilities/align.hpp"
+#include "utilities/debug.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+inline void ZPlatformObjectCopyNonTemporal(uintptr_t from, uintptr_t to, size_t size) {
+  assert(is_aligned(size, BytesPerWord), "Size not word aligned");
+
+  const uintptr_t end = from + size;
+
+#ifdef __GNUC__
+  // Copy words using MOVNTI, which is available on all x86_64 processors.
+  // The write-combining buffers merge the stores into full cache lines.
+  for (; from < end; from += BytesPerWord, to += BytesPerWord) {
+    __asm__ volatile ("movnti %1, %0" : "=m" (*(uint64_t*)to) : "r" (*(const uint64_t*)from));
+  }
+
+  // Non-temporal stores are weakly ordered. Make them globally visible
+  // before the new address of the object is published.
+  __asm__ volatile ("sfence" : : : "memory");
+#else
+  // No inline assembly, copy words using plain stores
+  for (; from < end; from += BytesPerWord, to += BytesPerWord) {
+    *(uint64_t*)to = *(const uint64_t*)from;
+  }
+#endif
+}
+
+inline void ZPlatformZeroNonTemporal(uintptr_t addr, size_t size) {
+  assert(is_aligned(addr, BytesPerWord), "Address not word aligned");
+  assert(is_aligned(size, BytesPerWord), "Size not word aligned");
+
+  const uintptr_t end = addr + size;
+
+#ifdef __GNUC__
+  // Zero words using MOVNTI, for the same reasons as when copying objects.
+  // The zeroed memory is never read, so it's not brought into the caches.
+  const uint64_t zero = 0;
+  for (; addr < end; addr += BytesPerWord) {
+    __asm__ volatile ("movnti %1, %0" : "=m" (*(uint64_t*)addr) : "r" (zero));
+  }
+
+  // Make the weakly ordered stores globally visible
+  __asm__ volatile ("sfence" : : : "memory");
+#else
+  // No inline assembly, zero words using plain stores
+  for (; addr < end; addr += BytesPerWord) {
+    *(uint64_t*)addr = 0;
+  }
+#endif
+}
+
+#endif // CPU_X86_GC_Z_ZUTILS_X86_INLINE_HPP
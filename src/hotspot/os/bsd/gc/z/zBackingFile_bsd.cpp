@@ -38,13 +38,48 @@
 #include <sys/mman.h>
 #include <sys/types.h>
 
-static int vm_flags_superpage() {
-  if (!ZLargePages::is_explicit()) {
-    return 0;
+#ifdef VM_FLAGS_SUPERPAGE_SIZE_2MB
+STATIC_ASSERT(ZGranuleSize == 2 * M);
+#define Z_VM_FLAGS_SUPERPAGE       VM_FLAGS_SUPERPAGE_SIZE_2MB
+#else
+#define Z_VM_FLAGS_SUPERPAGE       0
+#endif
+
+static bool superpages_supported() {
+  if (Z_VM_FLAGS_SUPERPAGE == 0) {
+    // Not supported on this platform
+    return false;
+  }
+
+  // Superpages are only available on some hardware, and the heap views
+  // require that memory committed with superpages can be remapped. Probe
+  // both by committing and remapping one superpage.
+  mach_vm_address_t addr = 0;
+  if (mach_vm_allocate(mach_task_self(), &addr, ZGranuleSize, VM_FLAGS_ANYWHERE | Z_VM_FLAGS_SUPERPAGE) != KERN_SUCCESS) {
+    return false;
+  }
+
+  mach_vm_address_t remap_addr = 0;
+  vm_prot_t remap_cur_prot;
+  vm_prot_t remap_max_prot;
+  const kern_return_t res = mach_vm_remap(mach_task_self(),
+                                          &remap_addr,
+                                          ZGranuleSize,
+                                          0 /* mask */,
+                                          VM_FLAGS_ANYWHERE,
+                                          mach_task_self(),
+                                          addr,
+                                          FALSE /* copy */,
+                                          &remap_cur_prot,
+                                          &remap_max_prot,
+                                          VM_INHERIT_COPY);
+  if (res == KERN_SUCCESS) {
+    mach_vm_deallocate(mach_task_self(), remap_addr, ZGranuleSize);
   }
 
-  const int page_size_in_megabytes = ZGranuleSize >> 20;
-  return page_size_in_megabytes << VM_FLAGS_SUPERPAGE_SHIFT;
+  mach_vm_deallocate(mach_task_self(), addr, ZGranuleSize);
+
+  return res == KERN_SUCCESS;
 }
 
 static ZErrno mremap(uintptr_t from_addr, uintptr_t to_addr, size_t size) {
@@ -57,7 +92,7 @@ static ZErrno mremap(uintptr_t from_addr, uintptr_t to_addr, size_t size) {
                                           &remap_addr,
                                           size,
                                           0 /* mask */,
-                                          VM_FLAGS_FIXED | VM_FLAGS_OVERWRITE | vm_flags_superpage(),
+                                          VM_FLAGS_FIXED | VM_FLAGS_OVERWRITE,
                                           mach_task_self(),
                                           from_addr,
                                           FALSE /* copy */,
@@ -71,6 +106,7 @@ static ZErrno mremap(uintptr_t from_addr, uintptr_t to_addr, size_t size) {
 ZBackingFile::ZBackingFile() :
     _base(0),
     _size(0),
+    _superpages(false),
     _initialized(false) {
 
   // Reserve address space for virtual backing file
@@ -81,6 +117,13 @@ ZBackingFile::ZBackingFile() :
     return;
   }
 
+  if (ZLargePages::is_explicit()) {
+    _superpages = superpages_supported();
+    if (!_superpages) {
+      log_warning(gc)("Superpages not supported, the Java heap will use small pages");
+    }
+  }
+
   // Successfully initialized
   _initialized = true;
 }
@@ -93,6 +136,13 @@ size_t ZBackingFile::size() const {
   return _size;
 }
 
+void ZBackingFile::update_size(size_t end) {
+  if (end > _size) {
+    // Record new virtual file size
+    _size = end;
+  }
+}
+
 bool ZBackingFile::commit_inner(size_t offset, size_t length) {
   assert(is_aligned(offset, os::vm_page_size()), "Invalid offset");
   assert(is_aligned(length, os::vm_page_size()), "Invalid length");
@@ -101,6 +151,21 @@ bool ZBackingFile::commit_inner(size_t offset, size_t length) {
                       offset / M, (offset + length) / M, length / M);
 
   const uintptr_t addr = _base + offset;
+
+  if (_superpages) {
+    // Commit memory with superpages. If no superpages are available,
+    // commit the memory using small pages instead.
+    mach_vm_address_t superpage_addr = addr;
+    const kern_return_t res = mach_vm_allocate(mach_task_self(), &superpage_addr, length,
+                                               VM_FLAGS_FIXED | VM_FLAGS_OVERWRITE | Z_VM_FLAGS_SUPERPAGE);
+    if (res == KERN_SUCCESS) {
+      update_size(offset + length);
+      return true;
+    }
+
+    log_debug(gc, heap)("Failed to commit memory with superpages (%d), using small pages", res);
+  }
+
   const void* const res = mmap((void*)addr, length, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
   if (res == MAP_FAILED) {
     ZErrno err;
@@ -108,11 +173,7 @@ bool ZBackingFile::commit_inner(size_t offset, size_t length) {
     return false;
   }
 
-  const size_t end = offset + length;
-  if (end > _size) {
-    // Record new virtual file size
-    _size = end;
-  }
+  update_size(offset + length);
 
   // Success
   return true;
@@ -38,8 +38,10 @@ class ZBackingFile {
 private:
   uintptr_t _base;
   size_t    _size;
+  bool      _superpages;
   bool      _initialized;
 
+  void update_size(size_t end);
   bool commit_inner(size_t offset, size_t length);
 
 public:
@@ -62,11 +62,12 @@ size_t ZPhysicalMemoryBacking::commit(size_t size) {
       break;
     }
 
-    // Try commit hole
+    // Try commit hole. Newly committed memory is zero filled, and
+    // is kept apart from other committed memory until allocated.
     const size_t filled = _file.commit(start, allocated);
     if (filled > 0) {
       // Successful or partialy successful
-      _committed.free(start, filled);
+      _zeroed.free(start, filled);
       committed += filled;
     }
     if (filled < allocated) {
@@ -83,7 +84,7 @@ size_t ZPhysicalMemoryBacking::commit(size_t size) {
     const size_t expanded = _file.commit(start, remaining);
     if (expanded > 0) {
       // Successful or partialy successful
-      _committed.free(start, expanded);
+      _zeroed.free(start, expanded);
       committed += expanded;
     }
   }
@@ -98,7 +99,13 @@ size_t ZPhysicalMemoryBacking::uncommit(size_t size) {
   while (uncommitted < size) {
     size_t allocated = 0;
     const size_t remaining = size - uncommitted;
-    const uintptr_t start = _committed.alloc_from_back_at_most(remaining, &allocated);
+    ZMemoryManager* from = &_committed;
+    uintptr_t start = from->alloc_from_back_at_most(remaining, &allocated);
+    if (start == UINTPTR_MAX) {
+      // Punch holes in zeroed memory last
+      from = &_zeroed;
+      start = from->alloc_from_back_at_most(remaining, &allocated);
+    }
     assert(start != UINTPTR_MAX, "Allocation should never fail");
 
     // Try punch hole
@@ -110,7 +117,7 @@ size_t ZPhysicalMemoryBacking::uncommit(size_t size) {
     }
     if (punched < allocated) {
       // Failed or partialy failed
-      _committed.free(start + punched, allocated - punched);
+      from->free(start + punched, allocated - punched);
       return uncommitted;
     }
   }
@@ -118,16 +125,43 @@ size_t ZPhysicalMemoryBacking::uncommit(size_t size) {
   return uncommitted;
 }
 
-ZPhysicalMemory ZPhysicalMemoryBacking::alloc(size_t size) {
+ZPhysicalMemory ZPhysicalMemoryBacking::alloc(size_t size, bool* zeroed) {
   assert(is_aligned(size, ZGranuleSize), "Invalid size");
 
   ZPhysicalMemory pmem;
 
-  // Allocate segments
-  for (size_t allocated = 0; allocated < size; allocated += ZGranuleSize) {
-    const uintptr_t start = _committed.alloc_from_front(ZGranuleSize);
+  // Prefer a single contiguous range, which is mapped with one mapping
+  // per heap view. Prefer memory that has been used before, to keep
+  // zeroed memory around.
+  uintptr_t start = _committed.alloc_from_front(size);
+  if (start != UINTPTR_MAX) {
+    pmem.add_segment(ZPhysicalMemorySegment(start, size));
+    *zeroed = false;
+    return pmem;
+  }
+
+  start = _zeroed.alloc_from_front(size);
+  if (start != UINTPTR_MAX) {
+    pmem.add_segment(ZPhysicalMemorySegment(start, size));
+    *zeroed = true;
+    return pmem;
+  }
+
+  // Allocate segments, as large as possible, and track if all
+  // segments are zeroed memory
+  *zeroed = true;
+
+  for (size_t allocated = 0; allocated < size;) {
+    size_t segment_size = 0;
+    start = _committed.alloc_from_front_at_most(size - allocated, &segment_size);
+    if (start == UINTPTR_MAX) {
+      start = _zeroed.alloc_from_front_at_most(size - allocated, &segment_size);
+    } else {
+      *zeroed = false;
+    }
     assert(start != UINTPTR_MAX, "Allocation should never fail");
-    pmem.add_segment(ZPhysicalMemorySegment(start, ZGranuleSize));
+    pmem.add_segment(ZPhysicalMemorySegment(start, segment_size));
+    allocated += segment_size;
   }
 
   return pmem;
@@ -182,6 +216,26 @@ void ZPhysicalMemoryBacking::pretouch(uintptr_t offset, size_t size) const {
   }
 }
 
+bool ZPhysicalMemoryBacking::collapse(uintptr_t offset, size_t size) const {
+  // Not supported
+  return false;
+}
+
+size_t ZPhysicalMemoryBacking::huge_page_coverage() const {
+  // Not supported
+  return 0;
+}
+
+bool ZPhysicalMemoryBacking::recommit(const ZPhysicalMemory& pmem) {
+  // Not supported
+  return false;
+}
+
+bool ZPhysicalMemoryBacking::refill(const ZPhysicalMemory& pmem) {
+  // Not supported, memory is never given up by recommit()
+  return true;
+}
+
 void ZPhysicalMemoryBacking::map(const ZPhysicalMemory& pmem, uintptr_t offset) const {
   if (ZVerifyViews) {
     // Map good view
@@ -34,6 +34,7 @@ private:
   ZBackingFile   _file;
   ZMemoryManager _committed;
   ZMemoryManager _uncommitted;
+  ZMemoryManager _zeroed;
 
   void pretouch_view(uintptr_t addr, size_t size) const;
   void map_view(const ZPhysicalMemory& pmem, uintptr_t addr) const;
@@ -48,13 +49,19 @@ public:
   size_t commit(size_t size);
   size_t uncommit(size_t size);
 
-  ZPhysicalMemory alloc(size_t size);
+  ZPhysicalMemory alloc(size_t size, bool* zeroed);
   void free(const ZPhysicalMemory& pmem);
 
   uintptr_t nmt_address(uintptr_t offset) const;
 
   void pretouch(uintptr_t offset, size_t size) const;
 
+  bool collapse(uintptr_t offset, size_t size) const;
+  size_t huge_page_coverage() const;
+
+  bool recommit(const ZPhysicalMemory& pmem);
+  bool refill(const ZPhysicalMemory& pmem);
+
   void map(const ZPhysicalMemory& pmem, uintptr_t offset) const;
   void unmap(const ZPhysicalMemory& pmem, uintptr_t offset) const;
 
@@ -85,8 +85,9 @@
 // Sysfs file for transparent huge page on tmpfs
 #define ZFILENAME_SHMEM_ENABLED          "/sys/kernel/mm/transparent_hugepage/shmem_enabled"
 
-// Java heap filename
+// Java heap filenames
 #define ZFILENAME_HEAP                   "java_heap"
+#define ZFILENAME_HEAP_FALLBACK          "java_heap.fallback"
 
 // Preferred tmpfs mount points, ordered by priority
 static const char* z_preferred_tmpfs_mountpoints[] = {
@@ -105,7 +106,9 @@ static const char* z_preferred_hugetlbfs_mountpoints[] = {
 static int z_fallocate_hugetlbfs_attempts = 3;
 static bool z_fallocate_supported = true;
 
-ZBackingFile::ZBackingFile() :
+ZBackingFile::ZBackingFile(bool fallback) :
+    _fallback(fallback),
+    _explicit_large_pages(!fallback && ZLargePages::is_explicit()),
     _fd(-1),
     _size(0),
     _filesystem(0),
@@ -114,7 +117,7 @@ ZBackingFile::ZBackingFile() :
     _initialized(false) {
 
   // Create backing file
-  _fd = create_fd(ZFILENAME_HEAP);
+  _fd = create_fd(_fallback ? ZFILENAME_HEAP_FALLBACK : ZFILENAME_HEAP);
   if (_fd == -1) {
     return;
   }
@@ -151,13 +154,13 @@ ZBackingFile::ZBackingFile() :
     return;
   }
 
-  if (ZLargePages::is_explicit() && !is_hugetlbfs()) {
+  if (_explicit_large_pages && !is_hugetlbfs()) {
     log_error(gc)("-XX:+UseLargePages (without -XX:+UseTransparentHugePages) can only be enabled "
                   "when using a %s filesystem", ZFILESYSTEM_HUGETLBFS);
     return;
   }
 
-  if (!ZLargePages::is_explicit() && is_hugetlbfs()) {
+  if (!_explicit_large_pages && is_hugetlbfs()) {
     log_error(gc)("-XX:+UseLargePages must be enabled when using a %s filesystem",
                   ZFILESYSTEM_HUGETLBFS);
     return;
@@ -177,15 +180,15 @@ ZBackingFile::ZBackingFile() :
 int ZBackingFile::create_mem_fd(const char* name) const {
   // Create file name
   char filename[PATH_MAX];
-  snprintf(filename, sizeof(filename), "%s%s", name, ZLargePages::is_explicit() ? ".hugetlb" : "");
+  snprintf(filename, sizeof(filename), "%s%s", name, _explicit_large_pages ? ".hugetlb" : "");
 
   // Create file
-  const int extra_flags = ZLargePages::is_explicit() ? MFD_HUGETLB : 0;
+  const int extra_flags = _explicit_large_pages ? MFD_HUGETLB : 0;
   const int fd = ZSyscall::memfd_create(filename, MFD_CLOEXEC | extra_flags);
   if (fd == -1) {
     ZErrno err;
     log_debug(gc, init)("Failed to create memfd file (%s)",
-                        ((ZLargePages::is_explicit() && err == EINVAL) ? "Hugepages not supported" : err.to_string()));
+                        ((_explicit_large_pages && err == EINVAL) ? "Hugepages not supported" : err.to_string()));
     return -1;
   }
 
@@ -195,10 +198,10 @@ int ZBackingFile::create_mem_fd(const char* name) const {
 }
 
 int ZBackingFile::create_file_fd(const char* name) const {
-  const char* const filesystem = ZLargePages::is_explicit()
+  const char* const filesystem = _explicit_large_pages
                                  ? ZFILESYSTEM_HUGETLBFS
                                  : ZFILESYSTEM_TMPFS;
-  const char** const preferred_mountpoints = ZLargePages::is_explicit()
+  const char** const preferred_mountpoints = _explicit_large_pages
                                              ? z_preferred_hugetlbfs_mountpoints
                                              : z_preferred_tmpfs_mountpoints;
 
@@ -257,6 +260,12 @@ int ZBackingFile::create_file_fd(const char* name) const {
 }
 
 int ZBackingFile::create_fd(const char* name) const {
+  if (_fallback) {
+    // The fallback file is always a memfd file, since ZPath
+    // specifies the location of the primary backing file.
+    return create_mem_fd(name);
+  }
+
   if (ZPath == NULL) {
     // If the path is not explicitly specified, then we first try to create a memfd file
     // instead of looking for a tmpfd/hugetlbfs mount point. Note that memfd_create() might
@@ -523,6 +532,13 @@ retry:
       goto retry;
     }
 
+    if (err == ENOSPC && is_hugetlbfs() && ZHugeTLBFSFallback) {
+      // Expected when the huge page pool is exhausted, the
+      // memory will be committed from the fallback file
+      log_debug(gc, heap)("Failed to commit memory (%s)", err.to_string());
+      return false;
+    }
+
     // Failed
     log_error(gc)("Failed to commit memory (%s)", err.to_string());
     return false;
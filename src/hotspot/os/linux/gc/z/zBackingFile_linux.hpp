@@ -28,14 +28,16 @@
 
 class ZErrno;
 
-class ZBackingFile {
+class ZBackingFile : public CHeapObj<mtGC> {
 private:
-  int      _fd;
-  size_t   _size;
-  uint64_t _filesystem;
-  size_t   _block_size;
-  size_t   _available;
-  bool     _initialized;
+  const bool _fallback;
+  const bool _explicit_large_pages;
+  int        _fd;
+  size_t     _size;
+  uint64_t   _filesystem;
+  size_t     _block_size;
+  size_t     _available;
+  bool       _initialized;
 
   int create_mem_fd(const char* name) const;
   int create_file_fd(const char* name) const;
@@ -58,7 +60,7 @@ private:
   bool commit_inner(size_t offset, size_t length);
 
 public:
-  ZBackingFile();
+  ZBackingFile(bool fallback);
 
   bool is_initialized() const;
 
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zCgroup_linux.hpp"
+#include "gc/z/zCPUQuota.hpp"
+#include "logging/log.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+#include <stdio.h>
+
+double ZCPUQuota::initialize_platform() {
+  // The cpu.max file has the quota and the period, in microseconds, or
+  // "max" as the quota if the process is not limited
+  char line[64];
+  uint64_t max;
+  uint64_t period;
+  if (!ZCgroup::initialize() ||
+      !ZCgroup::read_line("cpu.max", line, sizeof(line)) ||
+      sscanf(line, UINT64_FORMAT " " UINT64_FORMAT, &max, &period) != 2 ||
+      max == 0 || period == 0) {
+    // No quota, or not available
+    return 0.0;
+  }
+
+  return (double)max / (double)period;
+}
+
+bool ZCPUQuota::nr_throttled(uint64_t* value) {
+  return ZCgroup::read_key("cpu.stat", "nr_throttled", value);
+}
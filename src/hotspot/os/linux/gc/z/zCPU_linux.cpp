@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zCPU.hpp"
+#include "logging/log.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef SYS_rseq
+#if defined(AMD64)
+#define SYS_rseq 334
+#elif defined(AARCH64)
+#define SYS_rseq 293
+#endif
+#endif
+
+// Signature expected before rseq abort handlers. No restartable critical
+// sections are used, only the cpu_id field, so it is never checked.
+#if defined(AMD64)
+#define ZRSEQ_SIG 0x53053053
+#elif defined(AARCH64)
+#define ZRSEQ_SIG 0xd428bc00
+#endif
+
+#if defined(SYS_rseq) && defined(ZRSEQ_SIG)
+#define ZRSEQ_SUPPORTED
+#endif
+
+#ifdef ZRSEQ_SUPPORTED
+
+// Layout of the original 32 byte struct rseq in linux/rseq.h
+struct ZRseq {
+  volatile uint32_t _cpu_id_start;
+  volatile uint32_t _cpu_id;
+  volatile uint64_t _rseq_cs;
+  volatile uint32_t _flags;
+} __attribute__((aligned(32)));
+
+static const uint32_t ZRseqSize = 32;
+STATIC_ASSERT(sizeof(ZRseq) == ZRseqSize);
+
+// Area registered by us, when the C library doesn't know about rseq
+static THREAD_LOCAL ZRseq z_rseq;
+
+// Offset of the area registered by the C library (glibc 2.35 and later)
+// from the thread pointer, or -1 if the C library doesn't register one
+static ptrdiff_t z_rseq_libc_offset = -1;
+
+// Set when we should not register our own area, either because the C
+// library manages rseq, or because a registration has failed
+static volatile bool z_rseq_register_disabled = false;
+
+static uintptr_t z_thread_pointer() {
+#if defined(AMD64)
+  uintptr_t tp;
+  __asm__ volatile ("mov %%fs:0, %0" : "=r" (tp));
+  return tp;
+#else
+  return (uintptr_t)__builtin_thread_pointer();
+#endif
+}
+
+void ZCPU::initialize_platform() {
+  const ptrdiff_t* const offset = (const ptrdiff_t*)dlsym(RTLD_DEFAULT, "__rseq_offset");
+  const unsigned int* const size = (const unsigned int*)dlsym(RTLD_DEFAULT, "__rseq_size");
+  if (offset == NULL || size == NULL) {
+    // The C library doesn't know about rseq
+    log_debug(gc, init)("CPU Id Lookup: Restartable Sequences, if supported by the kernel");
+    return;
+  }
+
+  // A thread can only have one rseq area, so never register our own when
+  // the C library manages rseq. A size of zero means that the C library
+  // didn't register an area, for example because it has been disabled
+  // with the glibc.pthread.rseq tunable. Newer versions report the size
+  // of the features in use, which is less than the size of the original
+  // struct, but always covers the cpu_id field.
+  z_rseq_register_disabled = true;
+
+  if (*size >= offset_of(ZRseq, _cpu_id) + sizeof(uint32_t)) {
+    z_rseq_libc_offset = *offset;
+    log_debug(gc, init)("CPU Id Lookup: Restartable Sequences (libc)");
+  } else {
+    log_debug(gc, init)("CPU Id Lookup: Scheduler (Restartable Sequences disabled by libc)");
+  }
+}
+
+const volatile uint32_t* ZCPU::id_address_platform() {
+  if (z_rseq_libc_offset != -1) {
+    // Registered by the C library
+    const ZRseq* const rseq = (const ZRseq*)(z_thread_pointer() + z_rseq_libc_offset);
+    return &rseq->_cpu_id;
+  }
+
+  if (Atomic::load(&z_rseq_register_disabled)) {
+    // Not registering our own area
+    return NULL;
+  }
+
+  // Register our own area. The kernel tracks the registration for the
+  // lifetime of the thread, and the thread local area lives as long.
+  if (syscall(SYS_rseq, &z_rseq, ZRseqSize, 0, ZRSEQ_SIG) != 0) {
+    // Not supported by the kernel, or already registered by someone else
+    // (EBUSY). Back off, and don't try again for any other thread, since
+    // a registration by someone else is likely done for all threads.
+    log_debug(gc)("Failed to register rseq area (%s), using scheduler for CPU id lookup", os::strerror(errno));
+    Atomic::store(&z_rseq_register_disabled, true);
+    return NULL;
+  }
+
+  return &z_rseq._cpu_id;
+}
+
+#else // ZRSEQ_SUPPORTED
+
+void ZCPU::initialize_platform() {
+  // Not supported
+}
+
+const volatile uint32_t* ZCPU::id_address_platform() {
+  // Not supported
+  return NULL;
+}
+
+#endif // ZRSEQ_SUPPORTED
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zCgroup_linux.hpp"
+#include "logging/log.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// Control group information, see cgroups(7) and proc(5) for more details.
+#define PROC_SELF_CGROUP           "/proc/self/cgroup"
+#define PROC_SELF_MOUNTINFO        "/proc/self/mountinfo"
+#define CGROUP2_FILESYSTEM         "cgroup2"
+
+// Directory of the cgroup v2 control group of this process
+static char z_cgroup_path[PATH_MAX];
+
+bool ZCgroup::_initialized = false;
+bool ZCgroup::_available = false;
+
+static bool z_cgroup_filename(const char* name, char* filename, size_t length) {
+  return jio_snprintf(filename, length, "%s/%s", z_cgroup_path, name) > 0;
+}
+
+static bool z_find_cgroup2_mount(char** root, char** mountpoint) {
+  FILE* const file = fopen(PROC_SELF_MOUNTINFO, "r");
+  if (file == NULL) {
+    return false;
+  }
+
+  char* line = NULL;
+  size_t length = 0;
+  bool found = false;
+
+  while (!found && getline(&line, &length, file) != -1) {
+    char* line_root = NULL;
+    char* line_mountpoint = NULL;
+    char* line_filesystem = NULL;
+
+    if (sscanf(line, "%*u %*u %*u:%*u %ms %ms %*[^-]- %ms", &line_root, &line_mountpoint, &line_filesystem) == 3 &&
+        strcmp(line_filesystem, CGROUP2_FILESYSTEM) == 0) {
+      // Found, ownership of strings is passed to the caller
+      *root = line_root;
+      *mountpoint = line_mountpoint;
+      found = true;
+    } else {
+      free(line_root);
+      free(line_mountpoint);
+    }
+
+    free(line_filesystem);
+  }
+
+  free(line);
+  fclose(file);
+
+  return found;
+}
+
+static char* z_find_cgroup2_path() {
+  FILE* const file = fopen(PROC_SELF_CGROUP, "r");
+  if (file == NULL) {
+    return NULL;
+  }
+
+  char* line = NULL;
+  size_t length = 0;
+  char* path = NULL;
+
+  // The cgroup v2 hierarchy has id zero and no controller list
+  while (getline(&line, &length, file) != -1) {
+    if (sscanf(line, "0::%ms", &path) == 1) {
+      break;
+    }
+  }
+
+  free(line);
+  fclose(file);
+
+  return path;
+}
+
+bool ZCgroup::initialize_inner() {
+  char* root = NULL;
+  char* mountpoint = NULL;
+  if (!z_find_cgroup2_mount(&root, &mountpoint)) {
+    log_debug(gc, init)("Cgroup: No cgroup v2 filesystem found");
+    return false;
+  }
+
+  char* const path = z_find_cgroup2_path();
+  bool success = false;
+
+  if (path != NULL) {
+    // The mount root is a prefix of the cgroup path, unless the
+    // cgroup filesystem is mounted from inside a cgroup namespace
+    const size_t root_length = strcmp(root, "/") == 0 ? 0 : strlen(root);
+    const char* const relative = strncmp(path, root, root_length) == 0 ? path + root_length : path;
+
+    success = jio_snprintf(z_cgroup_path, sizeof(z_cgroup_path), "%s%s", mountpoint, relative) > 0 &&
+              access(z_cgroup_path, R_OK) == 0;
+
+    log_debug(gc, init)("Cgroup: %s (%s)", z_cgroup_path, success ? "Available" : "Not available");
+  }
+
+  free(root);
+  free(mountpoint);
+  free(path);
+
+  return success;
+}
+
+bool ZCgroup::initialize() {
+  if (!_initialized) {
+    _available = initialize_inner();
+    _initialized = true;
+  }
+
+  return _available;
+}
+
+bool ZCgroup::is_available() {
+  return _available;
+}
+
+bool ZCgroup::is_readable(const char* name) {
+  char filename[PATH_MAX];
+  return _available &&
+         z_cgroup_filename(name, filename, sizeof(filename)) &&
+         access(filename, R_OK) == 0;
+}
+
+bool ZCgroup::read_line(const char* name, char* buffer, int length) {
+  char filename[PATH_MAX];
+  if (!_available || !z_cgroup_filename(name, filename, sizeof(filename))) {
+    return false;
+  }
+
+  FILE* const file = fopen(filename, "r");
+  if (file == NULL) {
+    return false;
+  }
+
+  const bool success = fgets(buffer, length, file) != NULL;
+  fclose(file);
+
+  return success;
+}
+
+bool ZCgroup::read_key(const char* name, const char* key, uint64_t* value) {
+  // Read the value of a "key value" line in a flat keyed file
+  char filename[PATH_MAX];
+  if (!_available || !z_cgroup_filename(name, filename, sizeof(filename))) {
+    return false;
+  }
+
+  FILE* const file = fopen(filename, "r");
+  if (file == NULL) {
+    return false;
+  }
+
+  const size_t key_length = strlen(key);
+  char line[256];
+  bool found = false;
+
+  while (!found && fgets(line, sizeof(line), file) != NULL) {
+    found = strncmp(line, key, key_length) == 0 &&
+            line[key_length] == ' ' &&
+            sscanf(line + key_length + 1, UINT64_FORMAT, value) == 1;
+  }
+
+  fclose(file);
+
+  return found;
+}
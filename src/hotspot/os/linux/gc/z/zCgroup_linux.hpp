@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef OS_LINUX_GC_Z_ZCGROUP_LINUX_HPP
+#define OS_LINUX_GC_Z_ZCGROUP_LINUX_HPP
+
+#include "memory/allocation.hpp"
+
+// Access to the interface files of the cgroup v2 control group of
+// this process, see cgroups(7) for more details.
+class ZCgroup : public AllStatic {
+private:
+  static bool _initialized;
+  static bool _available;
+
+  static bool initialize_inner();
+
+public:
+  static bool initialize();
+  static bool is_available();
+
+  static bool is_readable(const char* name);
+  static bool read_line(const char* name, char* buffer, int length);
+  static bool read_key(const char* name, const char* key, uint64_t* value);
+};
+
+#endif // OS_LINUX_GC_Z_ZCGROUP_LINUX_HPP
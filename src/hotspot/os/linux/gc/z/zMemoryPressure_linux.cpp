@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zCgroup_linux.hpp"
+#include "gc/z/zMemoryPressure.hpp"
+#include "logging/log.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+#include <stdio.h>
+
+bool ZMemoryPressure::initialize_platform() {
+  const bool success = ZCgroup::initialize() && ZCgroup::is_readable("memory.pressure");
+  log_debug(gc, init)("Memory Pressure: %s", success ? "Available" : "Not available");
+  return success;
+}
+
+double ZMemoryPressure::pressure() {
+  // The first line has the share of time in which at least one task
+  // was stalled on memory, averaged over the last 10 seconds
+  char line[256];
+  double avg10;
+  if (!ZCgroup::read_line("memory.pressure", line, sizeof(line)) ||
+      sscanf(line, "some avg10=%lf", &avg10) != 1) {
+    return 0.0;
+  }
+
+  return avg10;
+}
+
+size_t ZMemoryPressure::limit() {
+  char line[64];
+  size_t value;
+  if (!ZCgroup::read_line("memory.high", line, sizeof(line)) ||
+      sscanf(line, SIZE_FORMAT, &value) != 1) {
+    // No limit ("max"), or not available
+    return SIZE_MAX;
+  }
+
+  return value;
+}
+
+size_t ZMemoryPressure::usage() {
+  char line[64];
+  size_t value;
+  if (!ZCgroup::read_line("memory.current", line, sizeof(line)) ||
+      sscanf(line, SIZE_FORMAT, &value) != 1) {
+    return 0;
+  }
+
+  // The usage includes the page cache of files accessed by the process,
+  // which the kernel reclaims before throttling. Exclude it, except for
+  // shared memory, which is accounted as page cache and backs the heap.
+  uint64_t file;
+  uint64_t shmem;
+  if (ZCgroup::read_key("memory.stat", "file", &file) &&
+      ZCgroup::read_key("memory.stat", "shmem", &shmem) &&
+      file > shmem) {
+    value -= MIN2(value, (size_t)(file - shmem));
+  }
+
+  return value;
+}
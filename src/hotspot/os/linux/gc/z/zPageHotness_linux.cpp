@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zPageHotness.hpp"
+#include "logging/log.hpp"
+#include "runtime/os.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Idle page tracking, see Documentation/admin-guide/mm/idle_page_tracking.rst
+// and Documentation/admin-guide/mm/pagemap.rst in the kernel sources for more
+// details. Reading page frame numbers from the pagemap requires CAP_SYS_ADMIN.
+#define PROC_SELF_PAGEMAP          "/proc/self/pagemap"
+#define SYS_PAGE_IDLE_BITMAP       "/sys/kernel/mm/page_idle/bitmap"
+
+// Pagemap entry bits
+#define PAGEMAP_PFN_MASK           ((UCONST64(1) << 55) - 1)
+#define PAGEMAP_PRESENT            (UCONST64(1) << 63)
+
+static int z_pagemap_fd = -1;
+static int z_page_idle_fd = -1;
+
+static bool read_pfn(uintptr_t addr, uint64_t* pfn) {
+  uint64_t entry;
+  const off_t offset = (off_t)(addr / os::vm_page_size()) * sizeof(entry);
+  if (pread(z_pagemap_fd, &entry, sizeof(entry), offset) != sizeof(entry) ||
+      (entry & PAGEMAP_PRESENT) == 0) {
+    // Not backed by memory
+    return false;
+  }
+
+  // The page frame number reads as zero without CAP_SYS_ADMIN
+  *pfn = entry & PAGEMAP_PFN_MASK;
+  return *pfn != 0;
+}
+
+bool ZPageHotness::initialize_platform() {
+  z_pagemap_fd = os::open(PROC_SELF_PAGEMAP, O_RDONLY|O_CLOEXEC, 0);
+  z_page_idle_fd = os::open(SYS_PAGE_IDLE_BITMAP, O_RDWR|O_CLOEXEC, 0);
+
+  // Check that the page frame numbers are readable, using
+  // a location on the stack, which is known to be mapped
+  const int probe = 0;
+  uint64_t pfn;
+  const bool success = z_pagemap_fd != -1 && z_page_idle_fd != -1 && read_pfn((uintptr_t)&probe, &pfn);
+  if (!success) {
+    if (z_pagemap_fd != -1) {
+      ::close(z_pagemap_fd);
+      z_pagemap_fd = -1;
+    }
+
+    if (z_page_idle_fd != -1) {
+      ::close(z_page_idle_fd);
+      z_page_idle_fd = -1;
+    }
+  }
+
+  log_debug(gc, init)("Idle Page Tracking: %s", success ? "Available" : "Not available");
+  return success;
+}
+
+bool ZPageHotness::test_and_clear_accessed(uintptr_t addr, bool* accessed) {
+  uint64_t pfn;
+  if (!read_pfn(addr, &pfn)) {
+    return false;
+  }
+
+  // Each word of the bitmap holds the idle bits of 64 page frames
+  const off_t offset = (off_t)(pfn / 64) * sizeof(uint64_t);
+  const uint64_t bit = UCONST64(1) << (pfn % 64);
+
+  uint64_t word;
+  if (pread(z_page_idle_fd, &word, sizeof(word), offset) != sizeof(word)) {
+    return false;
+  }
+
+  *accessed = (word & bit) == 0;
+
+  // Mark the frame idle again. Only set bits are written,
+  // which leaves the other frames in the word untouched.
+  word = bit;
+  if (pwrite(z_page_idle_fd, &word, sizeof(word), offset) != sizeof(word)) {
+    log_debug(gc)("Failed to mark frame idle (%s)", os::strerror(errno));
+  }
+
+  return true;
+}
@@ -30,6 +30,7 @@
 #include "gc/z/zNUMA.hpp"
 #include "gc/z/zPhysicalMemory.inline.hpp"
 #include "gc/z/zPhysicalMemoryBacking_linux.hpp"
+#include "gc/z/zStat.hpp"
 #include "logging/log.hpp"
 #include "runtime/globals.hpp"
 #include "runtime/init.hpp"
@@ -49,10 +50,74 @@
 #ifndef MADV_HUGEPAGE
 #define MADV_HUGEPAGE                        14
 #endif
+#ifndef MADV_COLLAPSE
+#define MADV_COLLAPSE                        25
+#endif
 
 // Proc file entry for max map mount
 #define ZFILENAME_PROC_MAX_MAP_COUNT         "/proc/sys/vm/max_map_count"
 
+// Proc file entry for memory usage summary
+#define ZFILENAME_PROC_SMAPS_ROLLUP          "/proc/self/smaps_rollup"
+
+static const ZStatCounter ZCounterMapSyscalls("Memory", "Map Syscalls", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterCollapse("Memory", "Huge Page Collapse", ZStatUnitBytesPerSecond);
+
+static volatile bool z_collapse_supported = true;
+
+ZBackingFile* ZPhysicalMemoryBacking::create_fallback_file() {
+  if (!ZHugeTLBFSFallback || !ZLargePages::is_explicit()) {
+    // Not enabled
+    return NULL;
+  }
+
+  ZBackingFile* const file = new ZBackingFile(true /* fallback */);
+  if (!file->is_initialized()) {
+    log_info(gc, init)("Huge Page Fallback: Disabled (Failed to create backing file)");
+    delete file;
+    return NULL;
+  }
+
+  log_info(gc, init)("Huge Page Fallback: Enabled");
+  return file;
+}
+
+ZPhysicalMemoryBacking::ZPhysicalMemoryBacking() :
+    _file(false /* fallback */),
+    _fallback_file(create_fallback_file()),
+    _committed(),
+    _uncommitted(),
+    _fallback_uncommitted(),
+    _zeroed() {}
+
+// Memory committed from the fallback file is given physical offsets from
+// ZAddressOffsetMax and up. The max heap size is never larger than that,
+// so ranges from the two files are never adjacent, and each physical
+// memory segment is backed by exactly one of the files.
+static uintptr_t fallback_base() {
+  return ZAddressOffsetMax;
+}
+
+bool ZPhysicalMemoryBacking::is_fallback(uintptr_t offset) const {
+  return offset >= fallback_base();
+}
+
+ZBackingFile* ZPhysicalMemoryBacking::file(uintptr_t offset) {
+  return is_fallback(offset) ? _fallback_file : &_file;
+}
+
+const ZBackingFile* ZPhysicalMemoryBacking::file(uintptr_t offset) const {
+  return is_fallback(offset) ? _fallback_file : &_file;
+}
+
+size_t ZPhysicalMemoryBacking::file_offset(uintptr_t offset) const {
+  return is_fallback(offset) ? offset - fallback_base() : offset;
+}
+
+ZMemoryManager* ZPhysicalMemoryBacking::uncommitted_for(uintptr_t offset) {
+  return is_fallback(offset) ? &_fallback_uncommitted : &_uncommitted;
+}
+
 bool ZPhysicalMemoryBacking::is_initialized() const {
   return _file.is_initialized();
 }
@@ -134,29 +199,30 @@ bool ZPhysicalMemoryBacking::supports_uncommit() {
   return commit(uncommit(ZGranuleSize)) == ZGranuleSize;
 }
 
-size_t ZPhysicalMemoryBacking::commit(size_t size) {
+size_t ZPhysicalMemoryBacking::commit_file(ZBackingFile* file, ZMemoryManager* uncommitted, uintptr_t base, size_t size) {
   size_t committed = 0;
 
   // Fill holes in the backing file
   while (committed < size) {
     size_t allocated = 0;
     const size_t remaining = size - committed;
-    const uintptr_t start = _uncommitted.alloc_from_front_at_most(remaining, &allocated);
+    const uintptr_t start = uncommitted->alloc_from_front_at_most(remaining, &allocated);
     if (start == UINTPTR_MAX) {
       // No holes to commit
       break;
     }
 
-    // Try commit hole
-    const size_t filled = _file.commit(start, allocated);
+    // Try commit hole. Newly committed memory is zero filled, and
+    // is kept apart from other committed memory until allocated.
+    const size_t filled = file->commit(start - base, allocated);
     if (filled > 0) {
       // Successful or partialy successful
-      _committed.free(start, filled);
+      _zeroed.free(start, filled);
       committed += filled;
     }
     if (filled < allocated) {
       // Failed or partialy failed
-      _uncommitted.free(start + filled, allocated - filled);
+      uncommitted->free(start + filled, allocated - filled);
       return committed;
     }
   }
@@ -164,11 +230,11 @@ size_t ZPhysicalMemoryBacking::commit(size_t size) {
   // Expand backing file
   if (committed < size) {
     const size_t remaining = size - committed;
-    const uintptr_t start = _file.size();
-    const size_t expanded = _file.commit(start, remaining);
+    const uintptr_t start = file->size();
+    const size_t expanded = file->commit(start, remaining);
     if (expanded > 0) {
       // Successful or partialy successful
-      _committed.free(start, expanded);
+      _zeroed.free(base + start, expanded);
       committed += expanded;
     }
   }
@@ -176,6 +242,22 @@ size_t ZPhysicalMemoryBacking::commit(size_t size) {
   return committed;
 }
 
+size_t ZPhysicalMemoryBacking::commit(size_t size) {
+  // Commit from the primary backing file first
+  size_t committed = commit_file(&_file, &_uncommitted, 0 /* base */, size);
+
+  if (committed < size && _fallback_file != NULL) {
+    // The huge page pool is exhausted, commit the rest from the fallback file
+    const size_t fallback_committed = commit_file(_fallback_file, &_fallback_uncommitted, fallback_base(), size - committed);
+    if (fallback_committed > 0) {
+      log_debug(gc, heap)("Committed " SIZE_FORMAT "M from huge page fallback file", fallback_committed / M);
+      committed += fallback_committed;
+    }
+  }
+
+  return committed;
+}
+
 size_t ZPhysicalMemoryBacking::uncommit(size_t size) {
   size_t uncommitted = 0;
 
@@ -183,19 +265,26 @@ size_t ZPhysicalMemoryBacking::uncommit(size_t size) {
   while (uncommitted < size) {
     size_t allocated = 0;
     const size_t remaining = size - uncommitted;
-    const uintptr_t start = _committed.alloc_from_back_at_most(remaining, &allocated);
+    ZMemoryManager* from = &_committed;
+    uintptr_t start = from->alloc_from_back_at_most(remaining, &allocated);
+    if (start == UINTPTR_MAX) {
+      // Punch holes in zeroed memory last
+      from = &_zeroed;
+      start = from->alloc_from_back_at_most(remaining, &allocated);
+    }
     assert(start != UINTPTR_MAX, "Allocation should never fail");
 
-    // Try punch hole
-    const size_t punched = _file.uncommit(start, allocated);
+    // Try punch hole. Memory from the fallback file has the highest
+    // offsets, and is therefore uncommitted first.
+    const size_t punched = file(start)->uncommit(file_offset(start), allocated);
     if (punched > 0) {
       // Successful or partialy successful
-      _uncommitted.free(start, punched);
+      uncommitted_for(start)->free(start, punched);
       uncommitted += punched;
     }
     if (punched < allocated) {
       // Failed or partialy failed
-      _committed.free(start + punched, allocated - punched);
+      from->free(start + punched, allocated - punched);
       return uncommitted;
     }
   }
@@ -203,16 +292,43 @@ size_t ZPhysicalMemoryBacking::uncommit(size_t size) {
   return uncommitted;
 }
 
-ZPhysicalMemory ZPhysicalMemoryBacking::alloc(size_t size) {
+ZPhysicalMemory ZPhysicalMemoryBacking::alloc(size_t size, bool* zeroed) {
   assert(is_aligned(size, ZGranuleSize), "Invalid size");
 
   ZPhysicalMemory pmem;
 
-  // Allocate segments
-  for (size_t allocated = 0; allocated < size; allocated += ZGranuleSize) {
-    const uintptr_t start = _committed.alloc_from_front(ZGranuleSize);
+  // Prefer a single contiguous range, which is mapped with one mapping
+  // per heap view. Prefer memory that has been used before, to keep
+  // zeroed memory around.
+  uintptr_t start = _committed.alloc_from_front(size);
+  if (start != UINTPTR_MAX) {
+    pmem.add_segment(ZPhysicalMemorySegment(start, size));
+    *zeroed = false;
+    return pmem;
+  }
+
+  start = _zeroed.alloc_from_front(size);
+  if (start != UINTPTR_MAX) {
+    pmem.add_segment(ZPhysicalMemorySegment(start, size));
+    *zeroed = true;
+    return pmem;
+  }
+
+  // Allocate segments, as large as possible, and track if all
+  // segments are zeroed memory
+  *zeroed = true;
+
+  for (size_t allocated = 0; allocated < size;) {
+    size_t segment_size = 0;
+    start = _committed.alloc_from_front_at_most(size - allocated, &segment_size);
+    if (start == UINTPTR_MAX) {
+      start = _zeroed.alloc_from_front_at_most(size - allocated, &segment_size);
+    } else {
+      *zeroed = false;
+    }
     assert(start != UINTPTR_MAX, "Allocation should never fail");
-    pmem.add_segment(ZPhysicalMemorySegment(start, ZGranuleSize));
+    pmem.add_segment(ZPhysicalMemorySegment(start, segment_size));
+    allocated += segment_size;
   }
 
   return pmem;
@@ -249,30 +365,62 @@ void ZPhysicalMemoryBacking::pretouch_view(uintptr_t addr, size_t size) const {
   os::pretouch_memory((void*)addr, (void*)(addr + size), page_size);
 }
 
-void ZPhysicalMemoryBacking::map_view(const ZPhysicalMemory& pmem, uintptr_t addr) const {
+void ZPhysicalMemoryBacking::map_views(const ZPhysicalMemory& pmem, const uintptr_t* addrs, size_t naddrs) const {
   const size_t nsegments = pmem.nsegments();
-  size_t size = 0;
+  const size_t size = pmem.size();
+  size_t nsyscalls = 0;
 
-  // Map segments
+  // Map each segment into all views in one pass
+  size_t segment_offset = 0;
   for (size_t i = 0; i < nsegments; i++) {
     const ZPhysicalMemorySegment& segment = pmem.segment(i);
-    const uintptr_t segment_addr = addr + size;
-    const void* const res = mmap((void*)segment_addr, segment.size(), PROT_READ|PROT_WRITE, MAP_FIXED|MAP_SHARED, _file.fd(), segment.start());
-    if (res == MAP_FAILED) {
-      ZErrno err;
-      map_failed(err);
+    for (size_t j = 0; j < naddrs; j++) {
+      const uintptr_t segment_addr = addrs[j] + segment_offset;
+      const void* const res = mmap((void*)segment_addr, segment.size(), PROT_READ|PROT_WRITE, MAP_FIXED|MAP_SHARED,
+                                   file(segment.start())->fd(), file_offset(segment.start()));
+      if (res == MAP_FAILED) {
+        ZErrno err;
+        map_failed(err);
+      }
     }
 
-    size += segment.size();
+    // Memory from the fallback file is not backed by explicit huge
+    // pages, but can still use transparent huge pages, if supported.
+    if (is_fallback(segment.start())) {
+      for (size_t j = 0; j < naddrs; j++) {
+        advise_view(addrs[j] + segment_offset, segment.size(), MADV_HUGEPAGE);
+      }
+
+      nsyscalls += naddrs;
+    }
+
+    segment_offset += segment.size();
+    nsyscalls += naddrs;
   }
 
-  // Advise on use of transparent huge pages before touching it
+  // Advise on use of transparent huge pages before touching it. This is
+  // a property of the mapping, so it needs to be applied to each view.
   if (ZLargePages::is_transparent()) {
-    advise_view(addr, size, MADV_HUGEPAGE);
+    for (size_t j = 0; j < naddrs; j++) {
+      advise_view(addrs[j], size, MADV_HUGEPAGE);
+    }
+
+    nsyscalls += naddrs;
+  }
+
+  // NUMA interleave memory before touching it. The memory policy of a
+  // shared mapping is set on the backing file range, and is shared by
+  // all views, so it's enough to set it through one of them.
+  if (ZNUMA::is_enabled()) {
+    ZNUMA::memory_interleave(addrs[0], size);
+    nsyscalls++;
   }
 
-  // NUMA interleave memory before touching it
-  ZNUMA::memory_interleave(addr, size);
+  ZStatInc(ZCounterMapSyscalls, nsyscalls);
+}
+
+void ZPhysicalMemoryBacking::map_view(const ZPhysicalMemory& pmem, uintptr_t addr) const {
+  map_views(pmem, &addr, 1);
 }
 
 void ZPhysicalMemoryBacking::unmap_view(const ZPhysicalMemory& pmem, uintptr_t addr) const {
@@ -284,6 +432,8 @@ void ZPhysicalMemoryBacking::unmap_view(const ZPhysicalMemory& pmem, uintptr_t a
     ZErrno err;
     map_failed(err);
   }
+
+  ZStatInc(ZCounterMapSyscalls);
 }
 
 uintptr_t ZPhysicalMemoryBacking::nmt_address(uintptr_t offset) const {
@@ -303,15 +453,119 @@ void ZPhysicalMemoryBacking::pretouch(uintptr_t offset, size_t size) const {
   }
 }
 
+bool ZPhysicalMemoryBacking::collapse(uintptr_t offset, size_t size) const {
+  if (!z_collapse_supported) {
+    return false;
+  }
+
+  // Synchronously collapse the memory into transparent huge pages. For
+  // shared memory the collapse happens in the page cache, and the other
+  // heap views pick up the huge pages from there, so it's enough to
+  // collapse the memory through one of the views.
+  if (madvise((void*)ZAddress::good(offset), size, MADV_COLLAPSE) == -1) {
+    ZErrno err;
+    if (err == EINVAL) {
+      // Advice not supported by the kernel
+      log_info(gc, init)("Transparent huge page collapse not supported by the kernel, disabled");
+      z_collapse_supported = false;
+    } else {
+      // Not enough huge pages available, or other transient failure
+      log_debug(gc, heap)("Failed to collapse memory (%s)", err.to_string());
+    }
+    return false;
+  }
+
+  ZStatInc(ZCounterCollapse, size);
+  return true;
+}
+
+size_t ZPhysicalMemoryBacking::huge_page_coverage() const {
+  // Read the amount of shared memory mapped with huge pages, summed
+  // over all mappings, i.e. counted once per heap view.
+  const char* const filename = ZFILENAME_PROC_SMAPS_ROLLUP;
+  FILE* const file = fopen(filename, "r");
+  if (file == NULL) {
+    return 0;
+  }
+
+  size_t pmd_mapped = 0;
+  char* line = NULL;
+  size_t length = 0;
+
+  while (getline(&line, &length, file) != -1) {
+    size_t value;
+    if (sscanf(line, "ShmemPmdMapped: " SIZE_FORMAT " kB", &value) == 1) {
+      pmd_mapped = value * K;
+      break;
+    }
+  }
+
+  ::free(line);
+  fclose(file);
+
+  const size_t nviews = ZVerifyViews ? 1 : 3;
+  return pmd_mapped / nviews;
+}
+
+bool ZPhysicalMemoryBacking::recommit(const ZPhysicalMemory& pmem) {
+  // Replace the memory backing each segment, by punching a hole in the
+  // backing file and filling it again. The new memory is allocated
+  // according to the memory policy currently set for the file range,
+  // and any existing mappings of the range fault in the new memory.
+  for (size_t i = 0; i < pmem.nsegments(); i++) {
+    const ZPhysicalMemorySegment& segment = pmem.segment(i);
+    ZBackingFile* const segment_file = file(segment.start());
+    const size_t offset = file_offset(segment.start());
+
+    const size_t punched = segment_file->uncommit(offset, segment.size());
+    if (punched < segment.size()) {
+      // Failed or partialy failed, fill what was punched
+      segment_file->commit(offset, punched);
+      return false;
+    }
+
+    const size_t filled = segment_file->commit(offset, segment.size());
+    if (filled < segment.size()) {
+      // Failed or partially failed, typically with ENOMEM when the memory
+      // policy binds the range to a node that is full. This is an ordinary
+      // allocation failure, which the caller handles.
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool ZPhysicalMemoryBacking::refill(const ZPhysicalMemory& pmem) {
+  // Fill any part of each segment that was given up by a failed recommit,
+  // according to the memory policy currently set for the file range.
+  // Parts that are still filled are left as they are.
+  for (size_t i = 0; i < pmem.nsegments(); i++) {
+    const ZPhysicalMemorySegment& segment = pmem.segment(i);
+    ZBackingFile* const segment_file = file(segment.start());
+    const size_t offset = file_offset(segment.start());
+
+    if (segment_file->commit(offset, segment.size()) < segment.size()) {
+      // Failed or partially failed
+      return false;
+    }
+  }
+
+  return true;
+}
+
 void ZPhysicalMemoryBacking::map(const ZPhysicalMemory& pmem, uintptr_t offset) const {
   if (ZVerifyViews) {
     // Map good view
     map_view(pmem, ZAddress::good(offset));
   } else {
     // Map all views
-    map_view(pmem, ZAddress::marked0(offset));
-    map_view(pmem, ZAddress::marked1(offset));
-    map_view(pmem, ZAddress::remapped(offset));
+    const uintptr_t addrs[] = {
+      ZAddress::marked0(offset),
+      ZAddress::marked1(offset),
+      ZAddress::remapped(offset)
+    };
+    map_views(pmem, addrs, ARRAY_SIZE(addrs));
   }
 }
 
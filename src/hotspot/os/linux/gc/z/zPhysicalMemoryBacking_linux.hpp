@@ -32,9 +32,22 @@ class ZPhysicalMemory;
 
 class ZPhysicalMemoryBacking {
 private:
-  ZBackingFile   _file;
-  ZMemoryManager _committed;
-  ZMemoryManager _uncommitted;
+  ZBackingFile         _file;
+  ZBackingFile* const  _fallback_file;
+  ZMemoryManager       _committed;
+  ZMemoryManager       _uncommitted;
+  ZMemoryManager       _fallback_uncommitted;
+  ZMemoryManager       _zeroed;
+
+  static ZBackingFile* create_fallback_file();
+
+  bool is_fallback(uintptr_t offset) const;
+  ZBackingFile* file(uintptr_t offset);
+  const ZBackingFile* file(uintptr_t offset) const;
+  size_t file_offset(uintptr_t offset) const;
+  ZMemoryManager* uncommitted_for(uintptr_t offset);
+
+  size_t commit_file(ZBackingFile* file, ZMemoryManager* uncommitted, uintptr_t base, size_t size);
 
   void warn_available_space(size_t max) const;
   void warn_max_map_count(size_t max) const;
@@ -43,10 +56,13 @@ private:
 
   void advise_view(uintptr_t addr, size_t size, int advice) const;
   void pretouch_view(uintptr_t addr, size_t size) const;
+  void map_views(const ZPhysicalMemory& pmem, const uintptr_t* addrs, size_t naddrs) const;
   void map_view(const ZPhysicalMemory& pmem, uintptr_t addr) const;
   void unmap_view(const ZPhysicalMemory& pmem, uintptr_t addr) const;
 
 public:
+  ZPhysicalMemoryBacking();
+
   bool is_initialized() const;
 
   void warn_commit_limits(size_t max) const;
@@ -55,13 +71,19 @@ public:
   size_t commit(size_t size);
   size_t uncommit(size_t size);
 
-  ZPhysicalMemory alloc(size_t size);
+  ZPhysicalMemory alloc(size_t size, bool* zeroed);
   void free(const ZPhysicalMemory& pmem);
 
   uintptr_t nmt_address(uintptr_t offset) const;
 
   void pretouch(uintptr_t offset, size_t size) const;
 
+  bool collapse(uintptr_t offset, size_t size) const;
+  size_t huge_page_coverage() const;
+
+  bool recommit(const ZPhysicalMemory& pmem);
+  bool refill(const ZPhysicalMemory& pmem);
+
   void map(const ZPhysicalMemory& pmem, uintptr_t offset) const;
   void unmap(const ZPhysicalMemory& pmem, uintptr_t offset) const;
 
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zErrno.hpp"
+#include "gc/z/zThreadPolicy.hpp"
+#include "logging/log.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/java.hpp"
+#include "utilities/formatBuffer.hpp"
+
+#include <sched.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+static cpu_set_t z_cpus;
+static bool      z_bind = false;
+static bool      z_low_priority = false;
+
+static bool parse_cpus(const char* str, cpu_set_t* cpus) {
+  // Parse a list of CPUs and CPU ranges, such as "0-3,8"
+  CPU_ZERO(cpus);
+
+  const char* p = str;
+  for (;;) {
+    char* end;
+    const unsigned long first = strtoul(p, &end, 10);
+    if (end == p) {
+      return false;
+    }
+
+    unsigned long last = first;
+    p = end;
+    if (*p == '-') {
+      p++;
+      last = strtoul(p, &end, 10);
+      if (end == p || last < first) {
+        return false;
+      }
+      p = end;
+    }
+
+    if (last >= CPU_SETSIZE) {
+      return false;
+    }
+
+    for (unsigned long cpu = first; cpu <= last; cpu++) {
+      CPU_SET(cpu, cpus);
+    }
+
+    if (*p == '\0') {
+      // End of list
+      return true;
+    }
+
+    if (*p != ',') {
+      return false;
+    }
+
+    p++;
+  }
+}
+
+static bool can_restore_priority() {
+  // Leaving SCHED_IDLE requires that RLIMIT_NICE permits the
+  // current nice value, unless the process is privileged
+  if (geteuid() == 0) {
+    return true;
+  }
+
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NICE, &limit) == -1) {
+    return false;
+  }
+
+  errno = 0;
+  const int nice = getpriority(PRIO_PROCESS, 0);
+  if (nice == -1 && errno != 0) {
+    return false;
+  }
+
+  return limit.rlim_cur == RLIM_INFINITY || (rlim_t)(20 - nice) <= limit.rlim_cur;
+}
+
+bool ZThreadPolicy::initialize_platform() {
+  if (ZThreadCPUs != NULL) {
+    if (!parse_cpus(ZThreadCPUs, &z_cpus)) {
+      vm_exit_during_initialization(err_msg("Invalid CPU list specified (ZThreadCPUs=%s)", ZThreadCPUs));
+    }
+
+    z_bind = true;
+    log_info(gc, init)("Thread CPUs: %s (%d CPUs)", ZThreadCPUs, CPU_COUNT(&z_cpus));
+  }
+
+  if (ZConcurrentLowPriority) {
+    z_low_priority = can_restore_priority();
+    if (z_low_priority) {
+      log_info(gc, init)("Concurrent Priority: Low (SCHED_IDLE)");
+    } else {
+      log_warning(gc)("ZConcurrentLowPriority disabled, RLIMIT_NICE does not allow restoring the normal priority");
+    }
+  }
+
+  return true;
+}
+
+void ZThreadPolicy::bind_platform() {
+  if (z_bind && sched_setaffinity(0 /* current thread */, sizeof(z_cpus), &z_cpus) == -1) {
+    ZErrno err;
+    log_warning(gc)("Failed to bind thread to GC thread CPUs (%s)", err.to_string());
+  }
+}
+
+bool ZThreadPolicy::set_low_priority_platform(bool low_priority) {
+  if (!z_low_priority) {
+    // Disabled
+    return false;
+  }
+
+  struct sched_param param;
+  param.sched_priority = 0;
+
+  if (sched_setscheduler(0 /* current thread */, low_priority ? SCHED_IDLE : SCHED_OTHER, &param) == -1) {
+    ZErrno err;
+    log_warning(gc)("Failed to set %s thread priority (%s)", low_priority ? "low" : "normal", err.to_string());
+    return false;
+  }
+
+  return true;
+}
@@ -630,6 +630,7 @@ bool os::create_thread(Thread* thread, ThreadType thr_type,
     case os::pgc_thread:
     case os::cgc_thread:
     case os::watcher_thread:
+    case os::asynclog_thread:
       if (VMThreadStackSize > 0) stack_size = (size_t)(VMThreadStackSize * K);
       break;
     }
@@ -561,23 +561,55 @@ void ClassLoaderDataGraph::clean_module_and_package_info() {
 }
 
 void ClassLoaderDataGraph::purge() {
-  ClassLoaderData* list = _unloading;
-  _unloading = NULL;
-  ClassLoaderData* next = list;
-  bool classes_unloaded = false;
-  while (next != NULL) {
-    ClassLoaderData* purge_me = next;
-    next = purge_me->next();
-    delete purge_me;
-    classes_unloaded = true;
-  }
-  if (classes_unloaded) {
+  ClassLoaderDataGraphParPurge purge;
+  purge.work();
+}
+
+ClassLoaderDataGraphParPurge::ClassLoaderDataGraphParPurge() :
+    _list(NULL),
+    _length(0),
+    _claimed(0) {
+  ClassLoaderData* const list = ClassLoaderDataGraph::_unloading;
+  ClassLoaderDataGraph::_unloading = NULL;
+
+  for (ClassLoaderData* cld = list; cld != NULL; cld = cld->next()) {
+    _length++;
+  }
+
+  if (_length > 0) {
+    // Snapshot the list, since an entry's next pointer can not be
+    // read once another thread has claimed and deleted that entry.
+    _list = NEW_C_HEAP_ARRAY(ClassLoaderData*, _length, mtClass);
+    size_t i = 0;
+    for (ClassLoaderData* cld = list; cld != NULL; cld = cld->next()) {
+      _list[i++] = cld;
+    }
+  }
+}
+
+ClassLoaderDataGraphParPurge::~ClassLoaderDataGraphParPurge() {
+  assert(_claimed >= _length, "Purge not completed");
+
+  if (_list != NULL) {
+    FREE_C_HEAP_ARRAY(ClassLoaderData*, _list);
+    // All metaspaces of the deleted class loader data have returned
+    // their chunks, purge the virtual space once for all of them.
     Metaspace::purge();
-    set_metaspace_oom(false);
+    ClassLoaderDataGraph::set_metaspace_oom(false);
   }
   DependencyContext::purge_dependency_contexts();
 }
 
+void ClassLoaderDataGraphParPurge::work() {
+  for (;;) {
+    const size_t index = Atomic::add(&_claimed, (size_t)1) - 1;
+    if (index >= _length) {
+      return;
+    }
+    delete _list[index];
+  }
+}
+
 int ClassLoaderDataGraph::resize_dictionaries() {
   assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint!");
   int resized = 0;
@@ -38,6 +38,7 @@ class ClassLoaderDataGraph : public AllStatic {
   friend class ClassLoaderDataGraphKlassIteratorAtomic;
   friend class ClassLoaderDataGraphKlassIteratorStatic;
   friend class ClassLoaderDataGraphIterator;
+  friend class ClassLoaderDataGraphParPurge;
   friend class VMStructs;
  private:
   // All CLDs (except the null CLD) can be reached by walking _head->_next->...
@@ -151,6 +152,25 @@ public:
   }
 };
 
+// Deletes the class loader data on the unloading list, optionally from
+// several threads. The list is detached and snapshotted when constructed,
+// each thread calling work() then claims entries until none are left. The
+// serial part of the purge (metaspace and dependency contexts) is done when
+// the purge object is destroyed, after all threads have finished.
+class ClassLoaderDataGraphParPurge : public StackObj {
+ private:
+  ClassLoaderData** _list;
+  size_t            _length;
+  volatile size_t   _claimed;
+
+ public:
+  ClassLoaderDataGraphParPurge();
+  ~ClassLoaderDataGraphParPurge();
+
+  size_t length() const { return _length; }
+  void work();
+};
+
 // An iterator that distributes Klasses to parallel worker threads.
 class ClassLoaderDataGraphKlassIteratorAtomic : public StackObj {
  Klass* volatile _next_klass;
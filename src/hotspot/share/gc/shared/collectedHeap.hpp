@@ -59,6 +59,15 @@ class VirtualSpaceSummary;
 class WorkGang;
 class nmethod;
 
+class ParallelObjectIterator : public CHeapObj<mtGC> {
+public:
+  // Called by each of the workers the iterator was created for, with
+  // worker_id in [0, thread_num). The closure is called concurrently
+  // from all workers, for disjoint sets of objects.
+  virtual void object_iterate(ObjectClosure* cl, uint worker_id) = 0;
+  virtual ~ParallelObjectIterator() {}
+};
+
 class GCMessage : public FormatBuffer<1024> {
  public:
   bool is_before;
@@ -387,6 +396,13 @@ class CollectedHeap : public CHeapObj<mtInternal> {
   // Iterate over all objects, calling "cl.do_object" on each.
   virtual void object_iterate(ObjectClosure* cl) = 0;
 
+  // Returns an iterator for iterating over all objects in parallel, using
+  // exactly thread_num workers of the safepoint workers, or NULL if the
+  // heap does not support parallel object iteration.
+  virtual ParallelObjectIterator* parallel_object_iterator(uint thread_num) {
+    return NULL;
+  }
+
   // Keep alive an object that was loaded with AS_NO_KEEPALIVE.
   virtual void keep_alive(oop obj) {}
 
@@ -132,6 +132,12 @@ const char* GCCause::to_string(GCCause::Cause cause) {
     case _z_high_usage:
       return "High Usage";
 
+    case _z_idle:
+      return "Idle";
+
+    case _z_metaspace:
+      return "Metaspace";
+
     case _last_gc_cause:
       return "ILLEGAL VALUE - last gc cause - ILLEGAL VALUE";
 
@@ -87,6 +87,8 @@ class GCCause : public AllStatic {
     _z_allocation_stall,
     _z_proactive,
     _z_high_usage,
+    _z_idle,
+    _z_metaspace,
 
     _last_gc_cause
   };
@@ -102,11 +102,19 @@ void GCTracer::report_object_count_after_gc(BoolObjectClosure* is_alive_cl) {
     if (!cit.allocation_failed()) {
       HeapInspection hi(false, false, false, NULL);
       hi.populate_table(&cit, is_alive_cl);
-      ObjectCountEventSenderClosure event_sender(cit.size_of_instances_in_words(), Ticks::now());
-      cit.iterate(&event_sender);
+      report_object_count_after_gc(&cit);
     }
   }
 }
+
+void GCTracer::report_object_count_after_gc(KlassInfoTable* cit) {
+  assert(!cit->allocation_failed(), "Must supply a populated table");
+
+  if (ObjectCountEventSender::should_send_event()) {
+    ObjectCountEventSenderClosure event_sender(cit->size_of_instances_in_words(), Ticks::now());
+    cit->iterate(&event_sender);
+  }
+}
 #endif // INCLUDE_SERVICES
 
 void GCTracer::report_gc_heap_summary(GCWhen::Type when, const GCHeapSummary& heap_summary) const {
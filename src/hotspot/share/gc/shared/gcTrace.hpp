@@ -42,6 +42,7 @@ class PSHeapSummary;
 class ReferenceProcessorStats;
 class TimePartitions;
 class BoolObjectClosure;
+class KlassInfoTable;
 
 class SharedGCInfo {
  private:
@@ -102,6 +103,7 @@ class GCTracer : public ResourceObj {
   void report_metaspace_summary(GCWhen::Type when, const MetaspaceSummary& metaspace_summary) const;
   void report_gc_reference_stats(const ReferenceProcessorStats& rp) const;
   void report_object_count_after_gc(BoolObjectClosure* object_filter) NOT_SERVICES_RETURN;
+  void report_object_count_after_gc(KlassInfoTable* cit) NOT_SERVICES_RETURN;
 
  protected:
   GCTracer(GCName name) : _shared_gc_info(name) {}
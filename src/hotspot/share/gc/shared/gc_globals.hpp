@@ -189,6 +189,13 @@
             "Use semaphore synchronization for the GC Threads, "            \
             "instead of synchronization based on mutexes")                  \
                                                                             \
+  diagnostic(uint, GCWorkerSpinIterations, 0,                               \
+             "Number of iterations the GC worker threads, and the thread "  \
+             "dispatching tasks to them, spin waiting while at or reaching "\
+             "a safepoint, before blocking. Only used with semaphore "      \
+             "synchronization (0 means always block)")                      \
+             range(0, max_jint)                                             \
+                                                                            \
   product(bool, UseDynamicNumberOfGCThreads, true,                          \
           "Dynamically choose the number of threads up to a maximum of "    \
           "ParallelGCThreads parallel collectors will use for garbage "     \
@@ -315,6 +315,29 @@ oop* OopStorage::Block::allocate() {
   }
 }
 
+// Allocate an entry without holding the _allocation_mutex.  This only
+// succeeds if the block is neither empty before nor full after the
+// allocation, so the block's _allocation_list state is unaffected and
+// an empty block being deleted can't be allocated from.
+oop* OopStorage::Block::allocate_if_partial() {
+  uintx allocated = allocated_bitmask();
+  while (true) {
+    if (is_empty_bitmask(allocated)) {
+      return NULL;
+    }
+    unsigned index = count_trailing_zeros(~allocated);
+    uintx new_value = allocated | bitmask_for_index(index);
+    if (is_full_bitmask(new_value)) {
+      return NULL;
+    }
+    uintx fetched = Atomic::cmpxchg(&_allocated_bitmask, allocated, new_value);
+    if (fetched == allocated) {
+      return get_pointer(index); // CAS succeeded; return entry for index.
+    }
+    allocated = fetched;       // CAS failed; retry with latest value.
+  }
+}
+
 OopStorage::Block* OopStorage::Block::new_block(const OopStorage* owner) {
   // _data must be first member: aligning block => aligning _data.
   STATIC_ASSERT(_data_pos == 0);
@@ -409,8 +432,30 @@ OopStorage::Block::block_for_ptr(const OopStorage* owner, const oop* ptr) {
 // added to the _allocation_list if not already present and the bitmask is not
 // full.  The block is moved to the end of the _allocation_list if the bitmask
 // is empty, for ease of empty block deletion processing.
+//
+// allocate() first tries to allocate without locking from the
+// _allocation_block, the block most recently allocated from under the lock.
+// Such an allocation may neither make the block full nor allocate from an
+// empty block, so it never requires an _allocation_list update, and never
+// races with the deletion of an empty block.  Access to the _allocation_block
+// is protected by _protect_allocation, which deletion synchronizes with
+// before a block is deleted.
+
+oop* OopStorage::allocate_lock_free() {
+  SingleWriterSynchronizer::CriticalSection cs(&_protect_allocation);
+  Block* block = Atomic::load_acquire(&_allocation_block);
+  if (block == NULL) return NULL;
+  oop* result = block->allocate_if_partial();
+  if (result == NULL) return NULL;
+  Atomic::inc(&_allocation_count);
+  log_trace(oopstorage, ref)("%s: allocated " PTR_FORMAT, name(), p2i(result));
+  return result;
+}
 
 oop* OopStorage::allocate() {
+  oop* result = allocate_lock_free();
+  if (result != NULL) return result;
+
   MutexLocker ml(_allocation_mutex, Mutex::_no_safepoint_check_flag);
 
   Block* block = block_for_allocation();
@@ -420,7 +465,7 @@ oop* OopStorage::allocate() {
     // Transitioning from empty to not empty.
     log_trace(oopstorage, blocks)("%s: block not empty " PTR_FORMAT, name(), p2i(block));
   }
-  oop* result = block->allocate();
+  result = block->allocate();
   assert(result != NULL, "allocation failed");
   assert(!block->is_empty(), "postcondition");
   Atomic::inc(&_allocation_count); // release updates outside lock.
@@ -429,6 +474,10 @@ oop* OopStorage::allocate() {
     // Remove full blocks from consideration by future allocates.
     log_trace(oopstorage, blocks)("%s: block full " PTR_FORMAT, name(), p2i(block));
     _allocation_list.unlink(*block);
+    Atomic::release_store(&_allocation_block, (Block*)NULL);
+  } else {
+    // Use block for following lock-free allocations.
+    Atomic::release_store(&_allocation_block, block);
   }
   log_trace(oopstorage, ref)("%s: allocated " PTR_FORMAT, name(), p2i(result));
   return result;
@@ -740,6 +789,8 @@ OopStorage::OopStorage(const char* name,
   _allocation_mutex(allocation_mutex),
   _active_mutex(active_mutex),
   _allocation_count(0),
+  _allocation_block(NULL),
+  _protect_allocation(),
   _concurrent_iteration_count(0),
   _needs_cleanup(false)
 {
@@ -892,6 +943,12 @@ bool OopStorage::delete_empty_blocks() {
       }
       // Remove block from _allocation_list and delete it.
       _allocation_list.unlink(*block);
+      // Wait for any lock-free allocation that could still be accessing
+      // the block, which is empty and so can't be allocated from.
+      if (Atomic::load(&_allocation_block) == block) {
+        Atomic::release_store(&_allocation_block, (Block*)NULL);
+      }
+      _protect_allocation.synchronize();
       // Be safepoint-polite while deleting and looping.
       MutexUnlocker ul(_allocation_mutex, Mutex::_no_safepoint_check_flag);
       delete_empty_block(*block);
@@ -1002,9 +1059,12 @@ bool OopStorage::BasicParState::claim_next_segment(IterationData* data) {
   // quantity, get delayed, and then end up claiming most or all of
   // the remaining largish amount of work, leaving nothing for other
   // threads to do.  But too small a step can lead to contention
-  // over _next_block, esp. when the work per block is small.
-  size_t max_step = 10;
+  // over _next_block, esp. when the work per block is small.  The
+  // maximum step adapts to the remaining work, so that a storage with
+  // very many blocks is claimed in larger segments while there is
+  // plenty left, and in small segments towards the end.
   size_t remaining = _block_count - start;
+  size_t max_step = MAX2((size_t)10, remaining / (_estimated_thread_count * 64));
   size_t step = MIN2(max_step, 1 + (remaining / _estimated_thread_count));
   // Atomic::add with possible overshoot.  This can perform better
   // than a CAS loop on some platforms when there is contention.
@@ -229,6 +229,10 @@ private:
   // Protection for _active_array.
   mutable SingleWriterSynchronizer _protect_active;
 
+  // Block for lock-free allocation, and protection for accessing it.
+  Block* volatile _allocation_block;
+  mutable SingleWriterSynchronizer _protect_allocation;
+
   // mutable because this gets set even for const iteration.
   mutable int _concurrent_iteration_count;
 
@@ -236,6 +240,7 @@ private:
 
   bool try_add_block();
   Block* block_for_allocation();
+  oop* allocate_lock_free();
 
   Block* find_block_or_null(const oop* ptr) const;
   void delete_empty_block(const Block& block);
@@ -29,6 +29,7 @@
 #include "metaprogramming/conditional.hpp"
 #include "metaprogramming/isConst.hpp"
 #include "oops/oop.hpp"
+#include "runtime/prefetch.inline.hpp"
 #include "runtime/safepoint.hpp"
 #include "utilities/align.hpp"
 #include "utilities/count_trailing_zeros.hpp"
@@ -168,6 +169,10 @@ public:
   bool is_empty() const;
   uintx allocated_bitmask() const;
 
+  // Prefetch the allocation bitmask and the first entries, ahead of
+  // iteration over the block.
+  void prefetch() const;
+
   bool is_safe_to_delete() const;
 
   Block* deferred_updates_next() const;
@@ -183,6 +188,7 @@ public:
   static Block* block_for_ptr(const OopStorage* owner, const oop* ptr);
 
   oop* allocate();
+  oop* allocate_if_partial();
   static Block* new_block(const OopStorage* owner);
   static void delete_block(const Block& block);
 
@@ -315,6 +321,11 @@ inline uintx OopStorage::Block::allocated_bitmask() const {
   return _allocated_bitmask;
 }
 
+inline void OopStorage::Block::prefetch() const {
+  Prefetch::read((void*)&_allocated_bitmask, 0);
+  Prefetch::read((void*)_data, 0);
+}
+
 inline uintx OopStorage::Block::bitmask_for_index(unsigned index) const {
   check_index(index);
   return uintx(1) << index;
@@ -31,6 +31,7 @@
 #include "memory/iterator.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/os.hpp"
+#include "runtime/safepoint.hpp"
 #include "runtime/semaphore.hpp"
 #include "runtime/thread.inline.hpp"
 
@@ -106,6 +107,10 @@ void AbstractWorkGang::threads_do(ThreadClosure* tc) const {
 //
 // Semaphores don't require the worker threads to re-claim the lock when they wake up.
 // This helps lowering the latency when starting and stopping the worker threads.
+//
+// With GCWorkerSpinIterations, the workers and the coordinator spin for a while
+// before blocking, when at or reaching a safepoint. Pauses often run several short
+// tasks back to back, and the wake-up latency is then a large part of each task.
 class SemaphoreGangTaskDispatcher : public GangTaskDispatcher {
   // The task currently being dispatched to the GangWorkers.
   AbstractGangTask* _task;
@@ -132,6 +137,24 @@ public:
     delete _end_semaphore;
   }
 
+  static bool should_spin() {
+    return GCWorkerSpinIterations > 0 &&
+           (SafepointSynchronize::is_at_safepoint() || SafepointSynchronize::is_synchronizing());
+  }
+
+  // Spin until the semaphore can be decremented, or until the spin limit
+  // is reached. Returns true if the semaphore was decremented.
+  static bool spin_wait(Semaphore* semaphore) {
+    for (uint i = 0; i < GCWorkerSpinIterations && should_spin(); i++) {
+      if (semaphore->trywait()) {
+        return true;
+      }
+      SpinPause();
+    }
+
+    return false;
+  }
+
   void coordinator_execute_on_workers(AbstractGangTask* task, uint num_workers) {
     // No workers are allowed to read the state variables until they have been signaled.
     _task         = task;
@@ -141,7 +164,9 @@ public:
     _start_semaphore->signal(num_workers);
 
     // Wait for the last worker to signal the coordinator.
-    _end_semaphore->wait();
+    if (!spin_wait(_end_semaphore)) {
+      _end_semaphore->wait();
+    }
 
     // No workers are allowed to read the state variables after the coordinator has been signaled.
     assert(_not_finished == 0, "%d not finished workers?", _not_finished);
@@ -152,7 +177,9 @@ public:
 
   WorkData worker_wait_for_task() {
     // Wait for the coordinator to dispatch a task.
-    _start_semaphore->wait();
+    if (!spin_wait(_start_semaphore)) {
+      _start_semaphore->wait();
+    }
 
     uint num_started = Atomic::add(&_started, 1u);
 
@@ -22,6 +22,7 @@
  */
 
 #include "precompiled.hpp"
+#include "ci/ciInstanceKlass.hpp"
 #include "classfile/javaClasses.hpp"
 #include "gc/z/c2/zBarrierSetC2.hpp"
 #include "gc/z/zBarrierSet.hpp"
@@ -83,8 +84,10 @@ static ZBarrierSetC2State* barrier_set_state() {
   return reinterpret_cast<ZBarrierSetC2State*>(Compile::current()->barrier_set_state());
 }
 
-ZLoadBarrierStubC2* ZLoadBarrierStubC2::create(const MachNode* node, Address ref_addr, Register ref, Register tmp, bool weak) {
-  ZLoadBarrierStubC2* const stub = new (Compile::current()->comp_arena()) ZLoadBarrierStubC2(node, ref_addr, ref, tmp, weak);
+ZLoadBarrierStubC2* ZLoadBarrierStubC2::create(const MachNode* node, Address ref_addr, Register ref, Register tmp, bool weak,
+                                               Register cas_oldval, Register cas_newval, bool cas_acquire) {
+  ZLoadBarrierStubC2* const stub = new (Compile::current()->comp_arena())
+      ZLoadBarrierStubC2(node, ref_addr, ref, tmp, weak, cas_oldval, cas_newval, cas_acquire);
   if (!Compile::current()->in_scratch_emit_size()) {
     barrier_set_state()->stubs()->append(stub);
   }
@@ -92,12 +95,26 @@ ZLoadBarrierStubC2* ZLoadBarrierStubC2::create(const MachNode* node, Address ref
   return stub;
 }
 
-ZLoadBarrierStubC2::ZLoadBarrierStubC2(const MachNode* node, Address ref_addr, Register ref, Register tmp, bool weak) :
+ZLoadBarrierStubC2* ZLoadBarrierStubC2::create(const MachNode* node, Address ref_addr, Register ref, Register tmp, bool weak) {
+  return create(node, ref_addr, ref, tmp, weak, noreg /* cas_oldval */, noreg /* cas_newval */, false /* cas_acquire */);
+}
+
+ZLoadBarrierStubC2* ZLoadBarrierStubC2::create_cas(const MachNode* node, Address ref_addr, Register ref, Register tmp,
+                                                   Register oldval, Register newval, bool acquire) {
+  assert(ref_addr.base() != noreg, "CAS retry requires self healing");
+  return create(node, ref_addr, ref, tmp, false /* weak */, oldval, newval, acquire);
+}
+
+ZLoadBarrierStubC2::ZLoadBarrierStubC2(const MachNode* node, Address ref_addr, Register ref, Register tmp, bool weak,
+                                       Register cas_oldval, Register cas_newval, bool cas_acquire) :
     _node(node),
     _ref_addr(ref_addr),
     _ref(ref),
     _tmp(tmp),
     _weak(weak),
+    _cas_oldval(cas_oldval),
+    _cas_newval(cas_newval),
+    _cas_acquire(cas_acquire),
     _entry(),
     _continuation() {
   assert_different_registers(ref, ref_addr.base());
@@ -116,6 +133,22 @@ Register ZLoadBarrierStubC2::tmp() const {
   return _tmp;
 }
 
+bool ZLoadBarrierStubC2::is_cas() const {
+  return _cas_newval != noreg;
+}
+
+Register ZLoadBarrierStubC2::cas_oldval() const {
+  return _cas_oldval;
+}
+
+Register ZLoadBarrierStubC2::cas_newval() const {
+  return _cas_newval;
+}
+
+bool ZLoadBarrierStubC2::cas_acquire() const {
+  return _cas_acquire;
+}
+
 address ZLoadBarrierStubC2::slow_path() const {
   const DecoratorSet decorators = _weak ? ON_WEAK_OOP_REF : ON_STRONG_OOP_REF;
   return ZBarrierSetRuntime::load_barrier_on_oop_field_preloaded_addr(decorators);
@@ -249,6 +282,21 @@ static Node* get_base_for_arracycopy_clone(PhaseMacroExpand* phase, Node* n) {
   }
 }
 
+static bool clone_inst_has_oops(PhaseMacroExpand* phase, Node* src) {
+  if (!src->is_AddP()) {
+    // Unknown type
+    return true;
+  }
+
+  const TypeInstPtr* const src_type = phase->igvn().type(src->in(AddPNode::Base))->isa_instptr();
+  if (src_type == NULL || !src_type->klass_is_exact() || !src_type->klass()->is_loaded()) {
+    // Subclasses could have oop fields
+    return true;
+  }
+
+  return src_type->klass()->as_instance_klass()->has_object_fields();
+}
+
 void ZBarrierSetC2::clone_at_expansion(PhaseMacroExpand* phase, ArrayCopyNode* ac) const {
   Node* const src = ac->in(ArrayCopyNode::Src);
   if (ac->is_clone_array()) {
@@ -257,6 +305,12 @@ void ZBarrierSetC2::clone_at_expansion(PhaseMacroExpand* phase, ArrayCopyNode* a
     return;
   }
 
+  if (ac->is_clone_inst() && !clone_inst_has_oops(phase, src)) {
+    // Clone instance without oop fields, no barriers needed
+    BarrierSetC2::clone_at_expansion(phase, ac);
+    return;
+  }
+
   // Clone instance
   assert(ac->is_clone_inst(), "Sanity check");
 
@@ -321,6 +375,36 @@ static uint block_index(const Block* block, const Node* node) {
   return 0;
 }
 
+static bool is_same_indexed_address(const MachNode* mach1, const MachNode* mach2) {
+  // Array element accesses with a variable index, such as those in
+  // loops, have no constant offset. Such accesses use the same address
+  // if they share base, index, scale and displacement.
+  Node* base1 = NULL;
+  Node* index1 = NULL;
+  const MachOper* const oper1 = mach1->memory_inputs(base1, index1);
+  if (oper1 == NULL || oper1 == (MachOper*)-1 || base1 == NULL || index1 == NULL) {
+    return false;
+  }
+
+  Node* base2 = NULL;
+  Node* index2 = NULL;
+  const MachOper* const oper2 = mach2->memory_inputs(base2, index2);
+  if (oper2 == NULL || oper2 == (MachOper*)-1 || base1 != base2 || index1 != index2) {
+    return false;
+  }
+
+  const Type* const t_index = index1->bottom_type();
+  if (t_index->isa_narrowoop() || t_index->isa_narrowklass()) {
+    // Index is a narrow oop, not an array index
+    return false;
+  }
+
+  const intptr_t disp = oper1->constant_disp();
+  return disp != Type::OffsetBot && disp >= 0 &&
+         disp == oper2->constant_disp() &&
+         oper1->scale() == oper2->scale();
+}
+
 void ZBarrierSetC2::analyze_dominating_barriers() const {
   ResourceMark rm;
   Compile* const C = Compile::current();
@@ -341,6 +425,15 @@ void ZBarrierSetC2::analyze_dominating_barriers() const {
       MachNode* const mach = node->as_Mach();
       switch (mach->ideal_Opcode()) {
       case Op_LoadP:
+        if (mach->barrier_data() == ZLoadBarrierWeak) {
+          // A dominating strong access heals the field to a good pointer
+          // (or null), which also passes the weak barrier fast path. A weak
+          // load never dominates other accesses, since the weak barrier
+          // doesn't mark and heals the field with a remapped pointer, which
+          // doesn't pass the strong barrier fast path.
+          barrier_loads.push(mach);
+          break;
+        }
       case Op_CompareAndExchangeP:
       case Op_CompareAndSwapP:
       case Op_GetAndSetP:
@@ -375,12 +468,16 @@ void ZBarrierSetC2::analyze_dominating_barriers() const {
       uint mem_index = block_index(mem_block, mem);
 
       if (load_obj == NodeSentinel || mem_obj == NodeSentinel ||
-          load_obj == NULL || mem_obj == NULL ||
-          load_offset < 0 || mem_offset < 0) {
+          load_obj == NULL || mem_obj == NULL) {
         continue;
       }
 
-      if (mem_obj != load_obj || mem_offset != load_offset) {
+      if (load_offset < 0 || mem_offset < 0) {
+        if (!is_same_indexed_address(load, mem)) {
+          // Not the same addresses, not a candidate
+          continue;
+        }
+      } else if (mem_obj != load_obj || mem_offset != load_offset) {
         // Not the same addresses, not a candidate
         continue;
       }
@@ -461,10 +558,10 @@ void ZBarrierSetC2::compute_liveness_at_stubs() const {
       const OptoReg::Name first = bs->refine_register(node, regalloc->get_reg_first(node));
       const OptoReg::Name second = bs->refine_register(node, regalloc->get_reg_second(node));
       if (first != OptoReg::Bad) {
-        new_live.Remove(first);
+        bs->remove_register(new_live, first);
       }
       if (second != OptoReg::Bad) {
-        new_live.Remove(second);
+        bs->remove_register(new_live, second);
       }
 
       // Add use bits
@@ -40,17 +40,33 @@ private:
   const Register  _ref;
   const Register  _tmp;
   const bool      _weak;
+  const Register  _cas_oldval;
+  const Register  _cas_newval;
+  const bool      _cas_acquire;
   Label           _entry;
   Label           _continuation;
 
-  ZLoadBarrierStubC2(const MachNode* node, Address ref_addr, Register ref, Register tmp, bool weak);
+  ZLoadBarrierStubC2(const MachNode* node, Address ref_addr, Register ref, Register tmp, bool weak,
+                     Register cas_oldval, Register cas_newval, bool cas_acquire);
+
+  static ZLoadBarrierStubC2* create(const MachNode* node, Address ref_addr, Register ref, Register tmp, bool weak,
+                                    Register cas_oldval, Register cas_newval, bool cas_acquire);
 
 public:
   static ZLoadBarrierStubC2* create(const MachNode* node, Address ref_addr, Register ref, Register tmp, bool weak);
 
+  // Creates a stub which, after healing the field, retries the CAS that
+  // loaded the bad value, so that the whole sequence is out-of-line
+  static ZLoadBarrierStubC2* create_cas(const MachNode* node, Address ref_addr, Register ref, Register tmp,
+                                        Register oldval, Register newval, bool acquire);
+
   Address ref_addr() const;
   Register ref() const;
   Register tmp() const;
+  bool is_cas() const;
+  Register cas_oldval() const;
+  Register cas_newval() const;
+  bool cas_acquire() const;
   address slow_path() const;
   RegMask& live() const;
   Label* entry();
@@ -29,6 +29,7 @@
 #include "gc/z/zForwarding.hpp"
 #include "gc/z/zGranuleMap.hpp"
 #include "gc/z/zHeap.hpp"
+#include "gc/z/zLiveMap.hpp"
 #include "gc/z/zPageAllocator.hpp"
 #include "utilities/macros.hpp"
 
@@ -53,6 +54,13 @@ public:
   const int* _ZObjectAlignmentSmall;
 };
 
+// Tools walking the heap, such as core file analyzers, can enumerate the
+// pages without reading the page table entry by entry. The page table
+// map is split into chunks of entries, and only chunks flagged as used
+// in _chunks have ever been written, so each used chunk can be read in
+// a single bulk read. A page spanning several granules has one entry per
+// granule. The live map summary of a page (number of live objects and
+// bytes) is valid if its sequence number equals ZGlobalSeqNum.
 typedef ZGranuleMap<ZPage*> ZGranuleMapForPageTable;
 typedef ZAttachedArray<ZForwarding, ZForwardingEntry> ZAttachedArrayForForwarding;
 
@@ -72,9 +80,16 @@ typedef ZAttachedArray<ZForwarding, ZForwardingEntry> ZAttachedArrayForForwardin
   nonstatic_field(ZHeap,                        _page_table,          ZPageTable)                    \
                                                                                                      \
   nonstatic_field(ZPage,                        _type,                const uint8_t)                 \
+  nonstatic_field(ZPage,                        _numa_id,             uint8_t)                       \
+  nonstatic_field(ZPage,                        _object_age,          uint8_t)                       \
   nonstatic_field(ZPage,                        _seqnum,              uint32_t)                      \
   nonstatic_field(ZPage,                        _virtual,             const ZVirtualMemory)          \
   volatile_nonstatic_field(ZPage,               _top,                 uintptr_t)                     \
+  nonstatic_field(ZPage,                        _livemap,             ZLiveMap)                      \
+                                                                                                     \
+  volatile_nonstatic_field(ZLiveMap,            _seqnum,              uint32_t)                      \
+  volatile_nonstatic_field(ZLiveMap,            _live_objects,        uint32_t)                      \
+  volatile_nonstatic_field(ZLiveMap,            _live_bytes,          size_t)                        \
                                                                                                      \
   nonstatic_field(ZPageAllocator,               _max_capacity,        const size_t)                  \
   nonstatic_field(ZPageAllocator,               _capacity,            size_t)                        \
@@ -82,7 +97,10 @@ typedef ZAttachedArray<ZForwarding, ZForwardingEntry> ZAttachedArrayForForwardin
                                                                                                      \
   nonstatic_field(ZPageTable,                   _map,                 ZGranuleMapForPageTable)       \
                                                                                                      \
+  nonstatic_field(ZGranuleMapForPageTable,      _size,                const size_t)                  \
   nonstatic_field(ZGranuleMapForPageTable,      _map,                 ZPage** const)                 \
+  nonstatic_field(ZGranuleMapForPageTable,      _nchunks,             const size_t)                  \
+  nonstatic_field(ZGranuleMapForPageTable,      _chunks,              bool* const)                   \
                                                                                                      \
   nonstatic_field(ZVirtualMemory,               _start,               const uintptr_t)               \
   nonstatic_field(ZVirtualMemory,               _end,                 const uintptr_t)               \
@@ -99,6 +117,7 @@ typedef ZAttachedArray<ZForwarding, ZForwardingEntry> ZAttachedArrayForForwardin
 
 #define VM_LONG_CONSTANTS_ZGC(declare_constant)                                                      \
   declare_constant(ZGranuleSizeShift)                                                                \
+  declare_constant(ZGranuleMapForPageTable::ChunkShift)                                              \
   declare_constant(ZPageSizeSmallShift)                                                              \
   declare_constant(ZPageSizeMediumShift)                                                             \
   declare_constant(ZAddressOffsetShift)                                                              \
@@ -111,6 +130,7 @@ typedef ZAttachedArray<ZForwarding, ZForwardingEntry> ZAttachedArrayForForwardin
   declare_type(ZCollectedHeap, CollectedHeap)                                                        \
   declare_toplevel_type(ZHeap)                                                                       \
   declare_toplevel_type(ZPage)                                                                       \
+  declare_toplevel_type(ZLiveMap)                                                                    \
   declare_toplevel_type(ZPageAllocator)                                                              \
   declare_toplevel_type(ZPageTable)                                                                  \
   declare_toplevel_type(ZAttachedArrayForForwarding)                                                 \
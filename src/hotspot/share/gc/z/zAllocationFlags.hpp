@@ -31,30 +31,39 @@
 // Allocation flags layout
 // -----------------------
 //
-//   7    3 2 1 0
-//  +----+-+-+-+-+
-//  |0000|1|1|1|1|
-//  +----+-+-+-+-+
-//  |    | | | |
-//  |    | | | * 0-0 Worker Thread Flag (1-bit)
-//  |    | | |
-//  |    | | * 1-1 Non-Blocking Flag (1-bit)
-//  |    | |
-//  |    | * 2-2 Relocation Flag (1-bit)
-//  |    |
-//  |    * 3-3 No Reserve Flag (1-bit)
+//  15      9 8 6 5 4 3 2 1 0
+//  +-------+---+-+-+-+-+-+-+
+//  |0000000|111|1|1|1|1|1|1|
+//  +-------+---+-+-+-+-+-+-+
+//  |       |   | | | | | |
+//  |       |   | | | | | * 0-0 Worker Thread Flag (1-bit)
+//  |       |   | | | | |
+//  |       |   | | | | * 1-1 Non-Blocking Flag (1-bit)
+//  |       |   | | | |
+//  |       |   | | | * 2-2 Relocation Flag (1-bit)
+//  |       |   | | |
+//  |       |   | | * 3-3 No Reserve Flag (1-bit)
+//  |       |   | |
+//  |       |   | * 4-4 Tenured Flag (1-bit)
+//  |       |   |
+//  |       |   * 5-5 Zeroed Flag (1-bit)
+//  |       |
+//  |       * 8-6 Partition (3-bits)
 //  |
-//  * 7-4 Unused (4-bits)
+//  * 15-9 Unused (7-bits)
 //
 
 class ZAllocationFlags {
 private:
-  typedef ZBitField<uint8_t, bool, 0, 1> field_worker_thread;
-  typedef ZBitField<uint8_t, bool, 1, 1> field_non_blocking;
-  typedef ZBitField<uint8_t, bool, 2, 1> field_relocation;
-  typedef ZBitField<uint8_t, bool, 3, 1> field_no_reserve;
+  typedef ZBitField<uint16_t, bool, 0, 1> field_worker_thread;
+  typedef ZBitField<uint16_t, bool, 1, 1> field_non_blocking;
+  typedef ZBitField<uint16_t, bool, 2, 1> field_relocation;
+  typedef ZBitField<uint16_t, bool, 3, 1> field_no_reserve;
+  typedef ZBitField<uint16_t, bool, 4, 1> field_tenured;
+  typedef ZBitField<uint16_t, bool, 5, 1> field_zeroed;
+  typedef ZBitField<uint16_t, uint8_t, 6, 3> field_partition;
 
-  uint8_t _flags;
+  uint16_t _flags;
 
 public:
   ZAllocationFlags() :
@@ -76,6 +85,18 @@ public:
     _flags |= field_no_reserve::encode(true);
   }
 
+  void set_tenured() {
+    _flags |= field_tenured::encode(true);
+  }
+
+  void set_zeroed() {
+    _flags |= field_zeroed::encode(true);
+  }
+
+  void set_partition(uint8_t partition) {
+    _flags |= field_partition::encode(partition);
+  }
+
   bool worker_thread() const {
     return field_worker_thread::decode(_flags);
   }
@@ -91,6 +112,18 @@ public:
   bool no_reserve() const {
     return field_no_reserve::decode(_flags);
   }
+
+  bool tenured() const {
+    return field_tenured::decode(_flags);
+  }
+
+  bool zeroed() const {
+    return field_zeroed::decode(_flags);
+  }
+
+  uint8_t partition() const {
+    return field_partition::decode(_flags);
+  }
 };
 
 #endif // SHARE_GC_Z_ZALLOCATIONFLAGS_HPP
@@ -25,6 +25,7 @@
 #include "gc/z/zAddressSpaceLimit.hpp"
 #include "gc/z/zArguments.hpp"
 #include "gc/z/zCollectedHeap.hpp"
+#include "gc/z/zCPUQuota.hpp"
 #include "gc/z/zHeuristics.hpp"
 #include "gc/shared/gcArguments.hpp"
 #include "runtime/globals.hpp"
@@ -47,6 +48,19 @@ void ZArguments::initialize() {
     FLAG_SET_DEFAULT(ZMarkStackSpaceLimit, mark_stack_space_limit);
   }
 
+  // Check allocation stall policy
+  if (strcmp(ZAllocationStallPolicy, "fifo") != 0 &&
+      strcmp(ZAllocationStallPolicy, "bypass") != 0 &&
+      strcmp(ZAllocationStallPolicy, "smallest") != 0) {
+    vm_exit_during_initialization("Unknown ZAllocationStallPolicy", ZAllocationStallPolicy);
+  }
+
+  // Check memory tiering. Moving memory between tiers punches holes in,
+  // and refills, the backing file, which the huge page pool can't back.
+  if (ZColdMemoryNode >= 0 && UseLargePages && !UseTransparentHugePages) {
+    vm_exit_during_initialization("ZColdMemoryNode is not supported with explicit large pages");
+  }
+
   // Enable NUMA by default
   if (FLAG_IS_DEFAULT(UseNUMA)) {
     FLAG_SET_DEFAULT(UseNUMA, true);
@@ -57,6 +71,9 @@ void ZArguments::initialize() {
     FLAG_SET_DEFAULT(UseBiasedLocking, false);
   }
 
+  // Read the CPU quota, used when selecting the number of threads
+  ZCPUQuota::initialize();
+
   // Select number of parallel threads
   if (FLAG_IS_DEFAULT(ParallelGCThreads)) {
     FLAG_SET_DEFAULT(ParallelGCThreads, ZHeuristics::nparallel_workers());
@@ -75,6 +92,17 @@ void ZArguments::initialize() {
     vm_exit_during_initialization("The flag -XX:+UseZGC can not be combined with -XX:ConcGCThreads=0");
   }
 
+  // Select number of concurrent threads per GC cycle, unless a fixed
+  // number of concurrent threads was requested
+  if (FLAG_IS_DEFAULT(UseDynamicNumberOfGCThreads)) {
+    FLAG_SET_ERGO(UseDynamicNumberOfGCThreads, FLAG_IS_DEFAULT(ConcGCThreads));
+  }
+
+  // Spin before blocking when dispatching tasks in pauses
+  if (FLAG_IS_DEFAULT(GCWorkerSpinIterations)) {
+    FLAG_SET_DEFAULT(GCWorkerSpinIterations, 1000);
+  }
+
 #ifdef COMPILER2
   // Enable loop strip mining by default
   if (FLAG_IS_DEFAULT(UseCountedLoopSafepoints)) {
@@ -48,6 +48,7 @@ public:
   bool is_empty() const;
 
   T at(size_t index) const;
+  T* addr(size_t index) const;
 
   void add(T value);
   void transfer(ZArray<T>* from);
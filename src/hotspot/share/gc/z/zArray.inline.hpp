@@ -55,6 +55,12 @@ inline T ZArray<T>::at(size_t index) const {
   return _array[index];
 }
 
+template <typename T>
+inline T* ZArray<T>::addr(size_t index) const {
+  assert(index < _size, "Index out of bounds");
+  return &_array[index];
+}
+
 template <typename T>
 inline void ZArray<T>::expand(size_t new_capacity) {
   T* new_array = NEW_C_HEAP_ARRAY(T, new_capacity, mtGC);
@@ -34,7 +34,9 @@ private:
   static size_t object_size();
 
 public:
+  static size_t size(size_t length);
   static void* alloc(size_t length);
+  static void* alloc(void* placement, size_t length);
   static void free(ObjectT* obj);
 
   ZAttachedArray(size_t length);
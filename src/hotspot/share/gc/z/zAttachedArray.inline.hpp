@@ -33,10 +33,19 @@ inline size_t ZAttachedArray<ObjectT, ArrayT>::object_size() {
   return align_up(sizeof(ObjectT), sizeof(ArrayT));
 }
 
+template <typename ObjectT, typename ArrayT>
+inline size_t ZAttachedArray<ObjectT, ArrayT>::size(size_t length) {
+  return object_size() + sizeof(ArrayT) * length;
+}
+
 template <typename ObjectT, typename ArrayT>
 inline void* ZAttachedArray<ObjectT, ArrayT>::alloc(size_t length) {
-  const size_t array_size = sizeof(ArrayT) * length;
-  char* const addr = AllocateHeap(object_size() + array_size, mtGC);
+  return alloc(AllocateHeap(size(length), mtGC), length);
+}
+
+template <typename ObjectT, typename ArrayT>
+inline void* ZAttachedArray<ObjectT, ArrayT>::alloc(void* placement, size_t length) {
+  char* const addr = (char*)placement;
   ::new (addr + object_size()) ArrayT[length];
   return addr;
 }
@@ -41,6 +41,8 @@ private:
   static const bool Publish     = true;
   static const bool Overflow    = false;
 
+  static const size_t array_block_length = 16;
+
   template <ZBarrierFastPath fast_path> static void self_heal(volatile oop* p, uintptr_t addr, uintptr_t heal_addr);
 
   template <ZBarrierFastPath fast_path, ZBarrierSlowPath slow_path> static oop barrier(volatile oop* p, oop o);
@@ -50,6 +52,8 @@ private:
   static bool is_good_or_null_fast_path(uintptr_t addr);
   static bool is_weak_good_or_null_fast_path(uintptr_t addr);
   static bool is_marked_or_null_fast_path(uintptr_t addr);
+  static bool is_good_or_null_block_fast_path(volatile oop* p);
+  static void load_barrier_on_oop_array_block(volatile oop* p);
 
   static bool during_mark();
   static bool during_relocate();
@@ -236,8 +236,60 @@ inline oop ZBarrier::load_barrier_on_oop_field_preloaded(volatile oop* p, oop o)
   return barrier<is_good_or_null_fast_path, load_barrier_on_oop_slow_path>(p, o);
 }
 
+inline bool ZBarrier::is_good_or_null_block_fast_path(volatile oop* p) {
+  // Combine all elements in the block and check them in one go. This loop
+  // has no dependencies between iterations, which allows the compiler to
+  // vectorize it.
+  const uintptr_t* const addrs = (const uintptr_t*)p;
+  uintptr_t bits = 0;
+  for (size_t i = 0; i < array_block_length; i++) {
+    bits |= addrs[i];
+  }
+
+  return (bits & ZAddressBadMask) == 0;
+}
+
+inline void ZBarrier::load_barrier_on_oop_array_block(volatile oop* p) {
+  // Heal all bad elements in the block. Adjacent elements often hold the
+  // same bad address, e.g. when an array is filled with references to the
+  // same object, in which case the slow path result is reused. Before
+  // healing, the element is re-read with a plain load, since the slow path
+  // can take a while and another thread may already have healed it, which
+  // would otherwise cost a failing locked compare-and-exchange.
+  uintptr_t last_addr = 0;
+  uintptr_t last_good_addr = 0;
+
+  for (size_t i = 0; i < array_block_length; i++) {
+    const oop o = p[i];
+    const uintptr_t addr = ZOop::to_address(o);
+    if (is_good_or_null_fast_path(addr)) {
+      continue;
+    }
+
+    if (addr != last_addr) {
+      last_good_addr = load_barrier_on_oop_slow_path(addr);
+      last_addr = addr;
+    }
+
+    const oop current = p[i];
+    if (ZOop::to_address(current) == addr) {
+      self_heal<is_good_or_null_fast_path>(p + i, addr, last_good_addr);
+    }
+  }
+}
+
 inline void ZBarrier::load_barrier_on_oop_array(volatile oop* p, size_t length) {
-  for (volatile const oop* const end = p + length; p < end; p++) {
+  volatile const oop* const end = p + length;
+
+  // Skip blocks where all elements are already good or null
+  for (; p + array_block_length <= end; p += array_block_length) {
+    if (!is_good_or_null_block_fast_path(p)) {
+      load_barrier_on_oop_array_block(p);
+    }
+  }
+
+  // Remaining elements
+  for (; p < end; p++) {
     load_barrier_on_oop_field(p);
   }
 }
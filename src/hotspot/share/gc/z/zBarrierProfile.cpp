@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zBarrierProfile.hpp"
+#include "gc/z/zHash.inline.hpp"
+#include "logging/log.hpp"
+#include "logging/logStream.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/klass.hpp"
+#include "oops/oop.inline.hpp"
+#include "runtime/atomic.hpp"
+#include "utilities/debug.hpp"
+
+ZBarrierProfileEntry ZBarrierProfile::_entries[ZBarrierProfile::_nentries];
+volatile uint64_t    ZBarrierProfile::_noverflow = 0;
+
+void ZBarrierProfile::record(oop o) {
+  if (o == NULL) {
+    return;
+  }
+
+  Klass* const klass = o->klass();
+  const size_t mask = _nentries - 1;
+  size_t index = ZHash::address_to_uint32((uintptr_t)klass) & mask;
+
+  for (size_t i = 0; i < _nentries; i++) {
+    ZBarrierProfileEntry* const entry = &_entries[index];
+    Klass* entry_klass = Atomic::load(&entry->_klass);
+    if (entry_klass == NULL) {
+      // Try claim entry
+      entry_klass = Atomic::cmpxchg(&entry->_klass, (Klass*)NULL, klass);
+      if (entry_klass == NULL) {
+        // Claimed
+        entry_klass = klass;
+      }
+    }
+
+    if (entry_klass == klass) {
+      Atomic::inc(&entry->_count);
+      return;
+    }
+
+    index = (index + 1) & mask;
+  }
+
+  // Table full
+  Atomic::inc(&_noverflow);
+}
+
+void ZBarrierProfile::reset() {
+  for (size_t i = 0; i < _nentries; i++) {
+    _entries[i]._klass = NULL;
+    _entries[i]._count = 0;
+  }
+
+  _noverflow = 0;
+}
+
+void ZBarrierProfile::print() {
+  LogTarget(Info, gc, barrier) lt;
+  if (!lt.is_enabled()) {
+    return;
+  }
+
+  // Find the classes with the most slow paths
+  ZBarrierProfileEntry* top[_nprinted] = {};
+  uint64_t total = Atomic::load(&_noverflow);
+
+  for (size_t i = 0; i < _nentries; i++) {
+    ZBarrierProfileEntry* entry = &_entries[i];
+    if (Atomic::load(&entry->_klass) == NULL) {
+      continue;
+    }
+
+    total += Atomic::load(&entry->_count);
+
+    for (size_t j = 0; j < _nprinted && entry != NULL; j++) {
+      if (top[j] == NULL || top[j]->_count < entry->_count) {
+        ZBarrierProfileEntry* const displaced = top[j];
+        top[j] = entry;
+        entry = displaced;
+      }
+    }
+  }
+
+  ResourceMark rm;
+  LogStream ls(lt);
+
+  ls.print_cr("Barrier Slow Paths: " UINT64_FORMAT " total, " UINT64_FORMAT " unrecorded",
+              total, Atomic::load(&_noverflow));
+
+  for (size_t i = 0; i < _nprinted && top[i] != NULL; i++) {
+    const uint64_t count = Atomic::load(&top[i]->_count);
+    ls.print_cr("  %8.1f%% " UINT64_FORMAT_W(12) " %s",
+                percent_of(count, total), count, top[i]->_klass->external_name());
+  }
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZBARRIERPROFILE_HPP
+#define SHARE_GC_Z_ZBARRIERPROFILE_HPP
+
+#include "memory/allocation.hpp"
+#include "oops/oopsHierarchy.hpp"
+
+class Klass;
+
+class ZBarrierProfileEntry {
+  friend class ZBarrierProfile;
+
+private:
+  Klass* volatile   _klass;
+  volatile uint64_t _count;
+};
+
+//
+// Counts load barrier slow paths taken by mutators, grouped by the
+// class of the healed object. The profile is reset at mark start and
+// printed at the end of each GC cycle. Objects healed during a cycle
+// are reachable, so their classes can not be unloaded before the
+// profile is printed.
+//
+class ZBarrierProfile : public AllStatic {
+private:
+  static const size_t  _nentries = 1024;
+  static const size_t  _nprinted = 10;
+
+  static ZBarrierProfileEntry _entries[_nentries];
+  static volatile uint64_t    _noverflow;
+
+public:
+  static void record(oop o);
+  static void reset();
+  static void print();
+};
+
+#endif // SHARE_GC_Z_ZBARRIERPROFILE_HPP
@@ -32,6 +32,13 @@
 #include "logging/log.hpp"
 
 bool ZBarrierSetNMethod::nmethod_entry_barrier(nmethod* nm) {
+  if (!is_armed(nm)) {
+    // Another thread already healed the oops and disarmed the
+    // nmethod since this thread took the entry barrier slow path.
+    // No need to take the lock.
+    return true;
+  }
+
   ZLocker<ZReentrantLock> locker(ZNMethod::lock_for_nmethod(nm));
   log_trace(nmethod, barrier)("Entered critical zone for %p", nm);
 
@@ -41,6 +48,10 @@ bool ZBarrierSetNMethod::nmethod_entry_barrier(nmethod* nm) {
     return true;
   }
 
+  // Record that the nmethod was called during this GC cycle, before
+  // checking if it is unloading, since that check ages cold nmethods
+  ZNMethod::record_entry(nm);
+
   if (nm->is_unloading()) {
     // We don't need to take the lock when unlinking nmethods from
     // the Method, because it is only concurrently unlinked by
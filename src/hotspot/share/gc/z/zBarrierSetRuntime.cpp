@@ -23,11 +23,16 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zBarrier.inline.hpp"
+#include "gc/z/zBarrierProfile.hpp"
 #include "gc/z/zBarrierSetRuntime.hpp"
 #include "runtime/interfaceSupport.inline.hpp"
 
 JRT_LEAF(oopDesc*, ZBarrierSetRuntime::load_barrier_on_oop_field_preloaded(oopDesc* o, oop* p))
-  return ZBarrier::load_barrier_on_oop_field_preloaded(p, o);
+  const oop result = ZBarrier::load_barrier_on_oop_field_preloaded(p, o);
+  if (ZProfileBarrierSlowPaths) {
+    ZBarrierProfile::record(result);
+  }
+  return result;
 JRT_END
 
 JRT_LEAF(oopDesc*, ZBarrierSetRuntime::load_barrier_on_weak_oop_field_preloaded(oopDesc* o, oop* p))
@@ -34,9 +34,19 @@ private:
   bool par_set_bit_pair_strong(idx_t bit, bool& inc_live);
 
 public:
+  ZBitMap();
   ZBitMap(idx_t size_in_bits);
 
+  // Use external storage. Detached storage is owned by the caller.
+  bool is_attached() const;
+  void attach(bm_word_t* map, idx_t size_in_bits);
+  bm_word_t* detach();
+
   bool par_set_bit_pair(idx_t bit, bool finalizable, bool& inc_live);
+
+  bm_word_t word(idx_t bit) const;
+
+  void prefetch(idx_t bit) const;
 };
 
 #endif // SHARE_GC_Z_ZBITMAP_HPP
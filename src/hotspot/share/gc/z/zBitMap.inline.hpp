@@ -26,19 +26,43 @@
 
 #include "gc/z/zBitMap.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/prefetch.inline.hpp"
 #include "utilities/bitMap.inline.hpp"
 #include "utilities/debug.hpp"
 
+inline ZBitMap::ZBitMap() :
+    CHeapBitMap(mtGC) {}
+
 inline ZBitMap::ZBitMap(idx_t size_in_bits) :
     CHeapBitMap(size_in_bits, mtGC, false /* clear */) {}
 
+inline bool ZBitMap::is_attached() const {
+  return map() != NULL;
+}
+
+inline void ZBitMap::attach(bm_word_t* map, idx_t size_in_bits) {
+  assert(!is_attached(), "Already attached");
+  update(map, size_in_bits);
+}
+
+inline BitMap::bm_word_t* ZBitMap::detach() {
+  bm_word_t* const map = this->map();
+  update(NULL, 0);
+  return map;
+}
+
 inline BitMap::bm_word_t ZBitMap::bit_mask_pair(idx_t bit) {
   assert(bit_in_word(bit) < BitsPerWord - 1, "Invalid bit index");
   return (bm_word_t)3 << bit_in_word(bit);
 }
 
+// Mark bits are set with relaxed ordering. Marking publishes nothing that
+// other threads read through the mark bits, and the segment a bit belongs
+// to has already been observed as live, with acquire ordering, before the
+// bit is set. The mark end safepoint orders the bits with all later readers.
+
 inline bool ZBitMap::par_set_bit_pair_finalizable(idx_t bit, bool& inc_live) {
-  inc_live = par_set_bit(bit);
+  inc_live = par_set_bit(bit, memory_order_relaxed);
   return inc_live;
 }
 
@@ -55,7 +79,7 @@ inline bool ZBitMap::par_set_bit_pair_strong(idx_t bit, bool& inc_live) {
       inc_live = false;
       return false;
     }
-    const bm_word_t cur_val = Atomic::cmpxchg(addr, old_val, new_val);
+    const bm_word_t cur_val = Atomic::cmpxchg(addr, old_val, new_val, memory_order_relaxed);
     if (cur_val == old_val) {
       // Success
       const bm_word_t marked_mask = bit_mask(bit);
@@ -76,4 +100,13 @@ inline bool ZBitMap::par_set_bit_pair(idx_t bit, bool finalizable, bool& inc_liv
   }
 }
 
+inline BitMap::bm_word_t ZBitMap::word(idx_t bit) const {
+  verify_index(bit);
+  return *word_addr(bit);
+}
+
+inline void ZBitMap::prefetch(idx_t bit) const {
+  Prefetch::write((void*)word_addr(bit), 0);
+}
+
 #endif // SHARE_GC_Z_ZBITMAP_INLINE_HPP
@@ -35,6 +35,7 @@
 PaddedEnd<ZCPU::ZCPUAffinity>* ZCPU::_affinity = NULL;
 THREAD_LOCAL Thread*           ZCPU::_self     = ZCPU_UNKNOWN_SELF;
 THREAD_LOCAL uint32_t          ZCPU::_cpu      = 0;
+THREAD_LOCAL const volatile uint32_t* ZCPU::_cpu_id = NULL;
 
 void ZCPU::initialize() {
   assert(_affinity == NULL, "Already initialized");
@@ -46,6 +47,8 @@ void ZCPU::initialize() {
     _affinity[i]._thread = ZCPU_UNKNOWN_AFFINITY;
   }
 
+  initialize_platform();
+
   log_info(gc, init)("CPUs: %u total, %u available",
                      os::processor_count(),
                      os::initial_active_processor_count());
@@ -55,6 +58,13 @@ uint32_t ZCPU::id_slow() {
   // Set current thread
   if (_self == ZCPU_UNKNOWN_SELF) {
     _self = Thread::current();
+
+    // Use a CPU id kept up to date by the kernel, if available
+    const volatile uint32_t* const cpu_id = id_address_platform();
+    if (cpu_id != NULL && *cpu_id < count()) {
+      _cpu_id = cpu_id;
+      return *cpu_id;
+    }
   }
 
   // Set current CPU
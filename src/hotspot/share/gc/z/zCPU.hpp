@@ -39,6 +39,10 @@ private:
   static PaddedEnd<ZCPUAffinity>* _affinity;
   static THREAD_LOCAL Thread*     _self;
   static THREAD_LOCAL uint32_t    _cpu;
+  static THREAD_LOCAL const volatile uint32_t* _cpu_id;
+
+  static void initialize_platform();
+  static const volatile uint32_t* id_address_platform();
 
   static uint32_t id_slow();
 
@@ -35,6 +35,12 @@ inline uint32_t ZCPU::count() {
 inline uint32_t ZCPU::id() {
   assert(_affinity != NULL, "Not initialized");
 
+  // Fast path, CPU id kept up to date by the kernel
+  const volatile uint32_t* const cpu_id = _cpu_id;
+  if (cpu_id != NULL) {
+    return *cpu_id;
+  }
+
   // Fast path
   if (_affinity[_cpu]._thread == _self) {
     return _cpu;
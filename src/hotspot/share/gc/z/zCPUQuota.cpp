@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zCPUQuota.hpp"
+#include "logging/log.hpp"
+#include "runtime/os.hpp"
+
+#include <math.h>
+
+bool     ZCPUQuota::_initialized = false;
+double   ZCPUQuota::_quota = 0.0;
+uint64_t ZCPUQuota::_nr_throttled = 0;
+bool     ZCPUQuota::_throttled = false;
+
+void ZCPUQuota::initialize() {
+  if (_initialized) {
+    // Already initialized
+    return;
+  }
+
+  _quota = initialize_platform();
+  _initialized = true;
+
+  if (_quota > 0.0) {
+    log_info(gc, init)("CPU Quota: %.2f CPUs", _quota);
+    nr_throttled(&_nr_throttled);
+  } else {
+    log_info(gc, init)("CPU Quota: None");
+  }
+}
+
+double ZCPUQuota::quota() {
+  assert(_initialized, "Not initialized");
+  return _quota;
+}
+
+uint ZCPUQuota::ncpus() {
+  const uint ncpus = os::initial_active_processor_count();
+  if (quota() == 0.0) {
+    return ncpus;
+  }
+
+  return clamp((uint)ceil(quota()), 1u, ncpus);
+}
+
+void ZCPUQuota::sample() {
+  uint64_t value;
+  if (quota() == 0.0 || !nr_throttled(&value)) {
+    // No quota, or statistics not available
+    _throttled = false;
+    return;
+  }
+
+  _throttled = value > _nr_throttled;
+  _nr_throttled = value;
+
+  log_debug(gc, director)("CPU Quota: %.2f CPUs, Throttled: %s, Throttled Periods: " UINT64_FORMAT,
+                          _quota, _throttled ? "Yes" : "No", value);
+}
+
+bool ZCPUQuota::is_throttled() {
+  return _throttled;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZCPUQUOTA_HPP
+#define SHARE_GC_Z_ZCPUQUOTA_HPP
+
+#include "memory/allocation.hpp"
+
+class ZCPUQuota : public AllStatic {
+private:
+  static bool     _initialized;
+  static double   _quota;
+  static uint64_t _nr_throttled;
+  static bool     _throttled;
+
+  static double initialize_platform();
+  static bool nr_throttled(uint64_t* value);
+
+public:
+  static void initialize();
+
+  // Number of CPUs the process may use per scheduling period, or
+  // zero if there is no quota
+  static double quota();
+
+  // Number of CPUs available to the GC, given the quota
+  static uint ncpus();
+
+  // Sample the throttling statistics, and check if the process was
+  // throttled since the previous sample
+  static void sample();
+  static bool is_throttled();
+};
+
+#endif // SHARE_GC_Z_ZCPUQUOTA_HPP
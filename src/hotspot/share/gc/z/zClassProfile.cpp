@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zClassProfile.hpp"
+#include "gc/z/zGlobals.hpp"
+#include "gc/z/zHash.inline.hpp"
+#include "gc/z/zLock.inline.hpp"
+#include "gc/z/zThread.inline.hpp"
+#include "gc/z/zTracer.inline.hpp"
+#include "gc/z/zValue.inline.hpp"
+#include "logging/log.hpp"
+#include "logging/logStream.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/klass.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
+#include "utilities/debug.hpp"
+#include "utilities/ostream.hpp"
+
+uint64_t ZClassProfileEntry::cost() const {
+  return _marked_bytes + _relocated_bytes;
+}
+
+ZClassProfileTable::ZClassProfileTable() {
+  reset();
+}
+
+ZClassProfileEntry* ZClassProfileTable::find(Klass* klass, bool atomic) {
+  const size_t mask = _nentries - 1;
+  size_t index = ZHash::address_to_uint32((uintptr_t)klass) & mask;
+
+  // Entries are only claimed within a bounded number of probes from the
+  // hashed index, so a lookup never needs to probe further. A class that
+  // finds no free entry within the bound is counted as an overflow, which
+  // keeps lookups cheap also when the table is full.
+  for (size_t i = 0; i < _nprobes; i++) {
+    ZClassProfileEntry* const entry = &_entries[index];
+    Klass* entry_klass = Atomic::load(&entry->_klass);
+    if (entry_klass == NULL) {
+      if (atomic) {
+        // Try claim entry
+        entry_klass = Atomic::cmpxchg(&entry->_klass, (Klass*)NULL, klass);
+        if (entry_klass == NULL) {
+          // Claimed
+          entry_klass = klass;
+        }
+      } else {
+        // Claim entry
+        entry->_klass = klass;
+        entry_klass = klass;
+      }
+    }
+
+    if (entry_klass == klass) {
+      return entry;
+    }
+
+    index = (index + 1) & mask;
+  }
+
+  // No entry within the probe bound
+  return NULL;
+}
+
+void ZClassProfileTable::record(Klass* klass, uint64_t marked_bytes, uint64_t relocated_bytes, uint64_t relocated_objects, bool atomic) {
+  ZClassProfileEntry* const entry = find(klass, atomic);
+  if (entry == NULL) {
+    // Overflow
+    if (atomic) {
+      Atomic::inc(&_noverflow);
+    } else {
+      _noverflow++;
+    }
+    return;
+  }
+
+  if (atomic) {
+    if (marked_bytes > 0) {
+      Atomic::add(&entry->_marked_bytes, marked_bytes);
+    }
+    if (relocated_objects > 0) {
+      Atomic::add(&entry->_relocated_bytes, relocated_bytes);
+      Atomic::add(&entry->_relocated_objects, relocated_objects);
+    }
+  } else {
+    entry->_marked_bytes += marked_bytes;
+    entry->_relocated_bytes += relocated_bytes;
+    entry->_relocated_objects += relocated_objects;
+  }
+}
+
+void ZClassProfileTable::merge(const ZClassProfileTable* other) {
+  for (size_t i = 0; i < _nentries; i++) {
+    const ZClassProfileEntry* const entry = &other->_entries[i];
+    if (entry->_klass != NULL) {
+      record(entry->_klass, entry->_marked_bytes, entry->_relocated_bytes, entry->_relocated_objects, false /* atomic */);
+    }
+  }
+
+  _noverflow += other->_noverflow;
+}
+
+void ZClassProfileTable::reset() {
+  for (size_t i = 0; i < _nentries; i++) {
+    _entries[i]._klass = NULL;
+    _entries[i]._marked_bytes = 0;
+    _entries[i]._relocated_bytes = 0;
+    _entries[i]._relocated_objects = 0;
+  }
+
+  _noverflow = 0;
+}
+
+ZPerWorker<ZClassProfileTable*>* ZClassProfile::_worker_tables = NULL;
+ZClassProfileTable*              ZClassProfile::_shared_table = NULL;
+ZLock                            ZClassProfile::_summary_lock;
+ZClassProfileSummary             ZClassProfile::_summary[ZClassProfile::_nsummary];
+size_t                           ZClassProfile::_nsummarized = 0;
+uint64_t                         ZClassProfile::_summary_total = 0;
+
+void ZClassProfile::initialize() {
+  if (!ZProfileClasses) {
+    // Disabled
+    return;
+  }
+
+  // Worker tables are allocated on first use
+  _worker_tables = new ZPerWorker<ZClassProfileTable*>(NULL);
+  _shared_table = new ZClassProfileTable();
+}
+
+void ZClassProfile::record(Klass* klass, uint64_t marked_bytes, uint64_t relocated_bytes, uint64_t relocated_objects) {
+  if (ZThread::is_worker()) {
+    // Worker-local table, updated without synchronization
+    ZClassProfileTable* table = _worker_tables->get();
+    if (table == NULL) {
+      table = new ZClassProfileTable();
+      _worker_tables->set(table);
+    }
+
+    table->record(klass, marked_bytes, relocated_bytes, relocated_objects, false /* atomic */);
+  } else {
+    // Shared table, for Java and other threads relocating objects
+    _shared_table->record(klass, marked_bytes, relocated_bytes, relocated_objects, true /* atomic */);
+  }
+}
+
+void ZClassProfile::record_marked(Klass* klass, size_t size) {
+  record(klass, size, 0 /* relocated_bytes */, 0 /* relocated_objects */);
+}
+
+void ZClassProfile::record_relocated(Klass* klass, size_t size) {
+  record(klass, 0 /* marked_bytes */, size, 1 /* relocated_objects */);
+}
+
+void ZClassProfile::reset() {
+  // Called in the mark start pause, when no thread is recording
+  ZPerWorkerIterator<ZClassProfileTable*> iter(_worker_tables);
+  for (ZClassProfileTable** table; iter.next(&table);) {
+    if (*table != NULL) {
+      (*table)->reset();
+    }
+  }
+
+  _shared_table->reset();
+}
+
+void ZClassProfile::summarize(ZClassProfileEntry** top, size_t ntop, uint64_t total) {
+  ResourceMark rm;
+  ZLocker<ZLock> locker(&_summary_lock);
+
+  for (size_t i = 0; i < _nsummarized; i++) {
+    os::free(_summary[i]._name);
+    _summary[i]._name = NULL;
+  }
+
+  _nsummarized = 0;
+  _summary_total = total;
+
+  for (size_t i = 0; i < ntop && top[i] != NULL; i++) {
+    ZClassProfileSummary* const summary = &_summary[_nsummarized++];
+    summary->_name = os::strdup(top[i]->_klass->external_name(), mtGC);
+    summary->_marked_bytes = top[i]->_marked_bytes;
+    summary->_relocated_bytes = top[i]->_relocated_bytes;
+    summary->_relocated_objects = top[i]->_relocated_objects;
+  }
+}
+
+void ZClassProfile::report() {
+  // Called at the end of the GC cycle, when no thread is recording.
+  // Merge the worker tables into the shared table.
+  ZPerWorkerIterator<ZClassProfileTable*> iter(_worker_tables);
+  for (ZClassProfileTable** table; iter.next(&table);) {
+    if (*table != NULL) {
+      _shared_table->merge(*table);
+    }
+  }
+
+  // Find the classes with the highest GC cost
+  ZClassProfileEntry* top[_nsummary] = {};
+  uint64_t total = 0;
+
+  for (size_t i = 0; i < ZClassProfileTable::_nentries; i++) {
+    ZClassProfileEntry* entry = &_shared_table->_entries[i];
+    if (entry->_klass == NULL) {
+      continue;
+    }
+
+    total += entry->cost();
+
+    for (size_t j = 0; j < _nsummary && entry != NULL; j++) {
+      if (top[j] == NULL || top[j]->cost() < entry->cost()) {
+        ZClassProfileEntry* const displaced = top[j];
+        top[j] = entry;
+        entry = displaced;
+      }
+    }
+  }
+
+  // Report to JFR while the classes are known to be loaded
+  for (size_t i = 0; i < _nsummary && top[i] != NULL; i++) {
+    ZTracer::tracer()->report_class_profile(top[i]->_klass,
+                                            top[i]->_marked_bytes,
+                                            top[i]->_relocated_bytes,
+                                            top[i]->_relocated_objects);
+  }
+
+  summarize(top, _nsummary, total);
+
+  if (_shared_table->_noverflow > 0) {
+    log_debug(gc, classhisto)("Class Profile: " UINT64_FORMAT " unrecorded samples", _shared_table->_noverflow);
+  }
+
+  LogTarget(Info, gc, classhisto) lt;
+  if (lt.is_enabled()) {
+    LogStream ls(lt);
+    print_on(&ls);
+  }
+}
+
+void ZClassProfile::print_on(outputStream* st) {
+  if (!ZProfileClasses) {
+    st->print_cr("Class profile not enabled (use -XX:+UnlockDiagnosticVMOptions -XX:+ZProfileClasses)");
+    return;
+  }
+
+  ZLocker<ZLock> locker(&_summary_lock);
+
+  st->print_cr("Class Profile: " UINT64_FORMAT "M marked and relocated in the last GC cycle", _summary_total / M);
+  st->print_cr("  %8s %12s %12s %12s %s", "Cost", "Marked", "Relocated", "Objects", "Class");
+
+  for (size_t i = 0; i < _nsummarized; i++) {
+    const ZClassProfileSummary* const summary = &_summary[i];
+    st->print_cr("  %7.1f%% " UINT64_FORMAT_W(11) "M " UINT64_FORMAT_W(11) "M " UINT64_FORMAT_W(12) " %s",
+                 percent_of(summary->_marked_bytes + summary->_relocated_bytes, _summary_total),
+                 summary->_marked_bytes / M,
+                 summary->_relocated_bytes / M,
+                 summary->_relocated_objects,
+                 summary->_name);
+  }
+}
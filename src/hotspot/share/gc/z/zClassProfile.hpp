@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZCLASSPROFILE_HPP
+#define SHARE_GC_Z_ZCLASSPROFILE_HPP
+
+#include "gc/z/zLock.hpp"
+#include "gc/z/zValue.hpp"
+#include "memory/allocation.hpp"
+
+class Klass;
+class outputStream;
+
+class ZClassProfileEntry {
+  friend class ZClassProfile;
+  friend class ZClassProfileTable;
+  friend class ZClassProfileTest;
+
+private:
+  Klass* volatile   _klass;
+  volatile uint64_t _marked_bytes;
+  volatile uint64_t _relocated_bytes;
+  volatile uint64_t _relocated_objects;
+
+public:
+  uint64_t cost() const;
+};
+
+class ZClassProfileTable : public CHeapObj<mtGC> {
+  friend class ZClassProfile;
+  friend class ZClassProfileTest;
+
+private:
+  static const size_t _nentries = 1024;
+  static const size_t _nprobes = 16;
+
+  ZClassProfileEntry _entries[_nentries];
+  volatile uint64_t  _noverflow;
+
+  ZClassProfileEntry* find(Klass* klass, bool atomic);
+
+public:
+  ZClassProfileTable();
+
+  void record(Klass* klass, uint64_t marked_bytes, uint64_t relocated_bytes, uint64_t relocated_objects, bool atomic);
+  void merge(const ZClassProfileTable* other);
+  void reset();
+};
+
+class ZClassProfileSummary {
+  friend class ZClassProfile;
+
+private:
+  char*    _name;
+  uint64_t _marked_bytes;
+  uint64_t _relocated_bytes;
+  uint64_t _relocated_objects;
+};
+
+//
+// Accumulates the marked bytes, relocated bytes and relocated objects of
+// each GC cycle per class. GC workers record into tables of their own,
+// other threads relocating objects record atomically into a shared table.
+// The tables are reset at mark start and merged at the end of each GC
+// cycle, when the classes with the highest GC cost are logged, reported
+// to JFR, and kept as a summary for GC.z_class_profile. Marked and
+// relocated objects are reachable, so their classes can not be unloaded
+// before the tables are merged. The summary keeps class names only.
+//
+class ZClassProfile : public AllStatic {
+private:
+  static const size_t _nsummary = 20;
+
+  static ZPerWorker<ZClassProfileTable*>* _worker_tables;
+  static ZClassProfileTable*              _shared_table;
+  static ZLock                            _summary_lock;
+  static ZClassProfileSummary             _summary[_nsummary];
+  static size_t                           _nsummarized;
+  static uint64_t                         _summary_total;
+
+  static void record(Klass* klass, uint64_t marked_bytes, uint64_t relocated_bytes, uint64_t relocated_objects);
+  static void summarize(ZClassProfileEntry** top, size_t ntop, uint64_t total);
+
+public:
+  static void initialize();
+
+  static void record_marked(Klass* klass, size_t size);
+  static void record_relocated(Klass* klass, size_t size);
+
+  static void reset();
+  static void report();
+
+  static void print_on(outputStream* st);
+};
+
+#endif // SHARE_GC_Z_ZCLASSPROFILE_HPP
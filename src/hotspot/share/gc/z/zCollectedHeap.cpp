@@ -22,16 +22,22 @@
  */
 
 #include "precompiled.hpp"
+#include "classfile/javaClasses.hpp"
+#include "gc/shared/gcLocker.inline.hpp"
 #include "gc/shared/gcHeapSummary.hpp"
 #include "gc/shared/suspendibleThreadSet.hpp"
 #include "gc/z/zCollectedHeap.hpp"
+#include "gc/z/zDirectorState.hpp"
 #include "gc/z/zGlobals.hpp"
 #include "gc/z/zHeap.inline.hpp"
 #include "gc/z/zNMethod.hpp"
 #include "gc/z/zObjArrayAllocator.hpp"
 #include "gc/z/zOop.inline.hpp"
+#include "gc/z/zPacer.hpp"
+#include "gc/z/zPageHotness.hpp"
 #include "gc/z/zServiceability.hpp"
 #include "gc/z/zStat.hpp"
+#include "gc/z/zStringDedup.hpp"
 #include "gc/z/zUtils.inline.hpp"
 #include "memory/iterator.hpp"
 #include "memory/universe.hpp"
@@ -52,7 +58,10 @@ ZCollectedHeap::ZCollectedHeap() :
     _heap(),
     _director(new ZDirector()),
     _driver(new ZDriver()),
+    _committer(new ZCommitter()),
     _uncommitter(new ZUncommitter()),
+    _hotness_sampler(ZPageHotness::is_enabled() ? new ZPageHotnessSampler() : NULL),
+    _zeroer(ZZeroedPageCacheSize > 0 ? new ZZeroer() : NULL),
     _stat(new ZStat()),
     _runtime_workers() {}
 
@@ -71,6 +80,8 @@ jint ZCollectedHeap::initialize() {
 
   Universe::calculate_verify_data((HeapWord*)0, (HeapWord*)UINTPTR_MAX);
 
+  ZStringDedup::initialize();
+
   return JNI_OK;
 }
 
@@ -79,10 +90,23 @@ void ZCollectedHeap::initialize_serviceability() {
 }
 
 void ZCollectedHeap::stop() {
+  ZDirectorState::save();
+
   _director->stop();
   _driver->stop();
+  _committer->stop();
   _uncommitter->stop();
+  if (_hotness_sampler != NULL) {
+    _hotness_sampler->stop();
+  }
+  if (_zeroer != NULL) {
+    _zeroer->stop();
+  }
   _stat->stop();
+
+  if (ZStringDedup::is_enabled()) {
+    ZStringDedup::stop();
+  }
 }
 
 SoftRefPolicy* ZCollectedHeap::soft_ref_policy() {
@@ -120,6 +144,8 @@ uint32_t ZCollectedHeap::hash_oop(oop obj) const {
 }
 
 HeapWord* ZCollectedHeap::allocate_new_tlab(size_t min_size, size_t requested_size, size_t* actual_size) {
+  ZPacer::pace(Thread::current());
+
   const size_t size_in_bytes = ZUtils::words_to_bytes(align_object_size(requested_size));
   const uintptr_t addr = _heap.alloc_tlab(size_in_bytes);
 
@@ -140,6 +166,8 @@ oop ZCollectedHeap::array_allocate(Klass* klass, int size, int length, bool do_z
 }
 
 HeapWord* ZCollectedHeap::mem_allocate(size_t size, bool* gc_overhead_limit_was_exceeded) {
+  ZPacer::pace(Thread::current());
+
   const size_t size_in_bytes = ZUtils::words_to_bytes(align_object_size(size));
   return (HeapWord*)_heap.alloc_object(size_in_bytes);
 }
@@ -181,6 +209,14 @@ void ZCollectedHeap::collect(GCCause::Cause cause) {
   _driver->collect(cause);
 }
 
+void ZCollectedHeap::request_uncommit() {
+  _uncommitter->request();
+}
+
+void ZCollectedHeap::wakeup_director() {
+  _director->wakeup();
+}
+
 void ZCollectedHeap::collect_as_vm_thread(GCCause::Cause cause) {
   // These collection requests are ignored since ZGC can't run a synchronous
   // GC cycle from within the VM thread. This is considered benign, since the
@@ -247,10 +283,40 @@ void ZCollectedHeap::object_iterate(ObjectClosure* cl) {
   _heap.object_iterate(cl, true /* visit_weaks */);
 }
 
+ParallelObjectIterator* ZCollectedHeap::parallel_object_iterator(uint nworkers) {
+  return _heap.parallel_object_iterator(nworkers, true /* visit_weaks */);
+}
+
 void ZCollectedHeap::keep_alive(oop obj) {
   _heap.keep_alive(obj);
 }
 
+bool ZCollectedHeap::supports_object_pinning() const {
+  // Pinned objects are accessed through raw addresses, which are
+  // only valid across bad mask flips when all views are mapped
+  return !ZVerifyViews;
+}
+
+oop ZCollectedHeap::pin_object(JavaThread* thread, oop obj) {
+  if (java_lang_String::is_instance(obj)) {
+    // Critical regions on strings access the value array, which
+    // string deduplication can replace, so block GC instead
+    GCLocker::lock_critical(thread);
+  } else {
+    _heap.pin_object(ZOop::to_address(obj));
+  }
+
+  return obj;
+}
+
+void ZCollectedHeap::unpin_object(JavaThread* thread, oop obj) {
+  if (java_lang_String::is_instance(obj)) {
+    GCLocker::unlock_critical(thread);
+  } else {
+    _heap.unpin_object(ZOop::to_address(obj));
+  }
+}
+
 void ZCollectedHeap::register_nmethod(nmethod* nm) {
   ZNMethod::register_nmethod(nm);
 }
@@ -271,6 +337,14 @@ WorkGang* ZCollectedHeap::get_safepoint_workers() {
   return _runtime_workers.workers();
 }
 
+bool ZCollectedHeap::supports_concurrent_phase_control() const {
+  return true;
+}
+
+bool ZCollectedHeap::request_concurrent_phase(const char* phase) {
+  return _driver->request_concurrent_phase(phase);
+}
+
 jlong ZCollectedHeap::millis_since_last_gc() {
   return ZStatCycle::time_since_last() / MILLIUNITS;
 }
@@ -278,8 +352,18 @@ jlong ZCollectedHeap::millis_since_last_gc() {
 void ZCollectedHeap::gc_threads_do(ThreadClosure* tc) const {
   tc->do_thread(_director);
   tc->do_thread(_driver);
+  tc->do_thread(_committer);
   tc->do_thread(_uncommitter);
+  if (_hotness_sampler != NULL) {
+    tc->do_thread(_hotness_sampler);
+  }
+  if (_zeroer != NULL) {
+    tc->do_thread(_zeroer);
+  }
   tc->do_thread(_stat);
+  if (ZStringDedup::is_enabled()) {
+    ZStringDedup::threads_do(tc);
+  }
   _heap.worker_threads_do(tc);
   _runtime_workers.threads_do(tc);
 }
@@ -330,10 +414,23 @@ void ZCollectedHeap::print_gc_threads_on(outputStream* st) const {
   st->cr();
   _driver->print_on(st);
   st->cr();
+  _committer->print_on(st);
+  st->cr();
   _uncommitter->print_on(st);
   st->cr();
+  if (_hotness_sampler != NULL) {
+    _hotness_sampler->print_on(st);
+    st->cr();
+  }
+  if (_zeroer != NULL) {
+    _zeroer->print_on(st);
+    st->cr();
+  }
   _stat->print_on(st);
   st->cr();
+  if (ZStringDedup::is_enabled()) {
+    ZStringDedup::print_worker_threads_on(st);
+  }
   _heap.print_worker_threads_on(st);
   _runtime_workers.print_threads_on(st);
 }
@@ -27,27 +27,33 @@
 #include "gc/shared/collectedHeap.hpp"
 #include "gc/shared/softRefPolicy.hpp"
 #include "gc/z/zBarrierSet.hpp"
+#include "gc/z/zCommitter.hpp"
 #include "gc/z/zDirector.hpp"
 #include "gc/z/zDriver.hpp"
 #include "gc/z/zHeap.hpp"
 #include "gc/z/zInitialize.hpp"
+#include "gc/z/zPageHotnessSampler.hpp"
 #include "gc/z/zRuntimeWorkers.hpp"
 #include "gc/z/zStat.hpp"
 #include "gc/z/zUncommitter.hpp"
+#include "gc/z/zZeroer.hpp"
 
 class ZCollectedHeap : public CollectedHeap {
   friend class VMStructs;
 
 private:
-  SoftRefPolicy     _soft_ref_policy;
-  ZBarrierSet       _barrier_set;
-  ZInitialize       _initialize;
-  ZHeap             _heap;
-  ZDirector*        _director;
-  ZDriver*          _driver;
-  ZUncommitter*     _uncommitter;
-  ZStat*            _stat;
-  ZRuntimeWorkers   _runtime_workers;
+  SoftRefPolicy        _soft_ref_policy;
+  ZBarrierSet          _barrier_set;
+  ZInitialize          _initialize;
+  ZHeap                _heap;
+  ZDirector*           _director;
+  ZDriver*             _driver;
+  ZCommitter*          _committer;
+  ZUncommitter*        _uncommitter;
+  ZPageHotnessSampler* _hotness_sampler;
+  ZZeroer*             _zeroer;
+  ZStat*               _stat;
+  ZRuntimeWorkers      _runtime_workers;
 
   virtual HeapWord* allocate_new_tlab(size_t min_size,
                                       size_t requested_size,
@@ -84,6 +90,9 @@ public:
   virtual void collect_as_vm_thread(GCCause::Cause cause);
   virtual void do_full_collection(bool clear_all_soft_refs);
 
+  void request_uncommit();
+  void wakeup_director();
+
   virtual bool supports_tlab_allocation() const;
   virtual size_t tlab_capacity(Thread* thr) const;
   virtual size_t tlab_used(Thread* thr) const;
@@ -98,9 +107,14 @@ public:
   virtual GrowableArray<MemoryPool*> memory_pools();
 
   virtual void object_iterate(ObjectClosure* cl);
+  virtual ParallelObjectIterator* parallel_object_iterator(uint nworkers);
 
   virtual void keep_alive(oop obj);
 
+  virtual bool supports_object_pinning() const;
+  virtual oop pin_object(JavaThread* thread, oop obj);
+  virtual void unpin_object(JavaThread* thread, oop obj);
+
   virtual void register_nmethod(nmethod* nm);
   virtual void unregister_nmethod(nmethod* nm);
   virtual void flush_nmethod(nmethod* nm);
@@ -108,6 +122,9 @@ public:
 
   virtual WorkGang* get_safepoint_workers();
 
+  virtual bool supports_concurrent_phase_control() const;
+  virtual bool request_concurrent_phase(const char* phase);
+
   virtual jlong millis_since_last_gc();
 
   virtual void gc_threads_do(ThreadClosure* tc) const;
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zCommitter.hpp"
+#include "gc/z/zGlobals.hpp"
+#include "gc/z/zHeap.inline.hpp"
+#include "gc/z/zStat.hpp"
+#include "utilities/align.hpp"
+
+ZCommitter::ZCommitter() :
+    _metronome(ZStatAllocRate::sample_hz) {
+  set_name("ZCommitter");
+  create_and_start();
+}
+
+size_t ZCommitter::headroom() const {
+  // Keep enough committed but unused memory to cover the
+  // allocation rate for the configured amount of time.
+  const double alloc_rate = MAX2(ZStatAllocRate::avg(), ZStatAllocRate::predict(ZCommitAheadTime));
+  const size_t headroom = alloc_rate * ZCommitAheadTime;
+  return align_up(headroom, ZGranuleSize);
+}
+
+void ZCommitter::run_service() {
+  while (_metronome.wait_for_tick()) {
+    if (ZCommitAheadTime > 0.0 || ZDeferInitialCommit) {
+      // Try commit memory ahead of allocation, including
+      // any deferred part of the initial capacity
+      ZHeap::heap()->commit_ahead(headroom());
+    }
+  }
+}
+
+void ZCommitter::stop_service() {
+  _metronome.stop();
+}
@@ -23,16 +23,29 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zCollectedHeap.hpp"
+#include "gc/z/zCPUQuota.hpp"
 #include "gc/z/zDirector.hpp"
 #include "gc/z/zHeap.inline.hpp"
+#include "gc/z/zMemoryPressure.hpp"
+#include "gc/z/zPacer.hpp"
 #include "gc/z/zStat.hpp"
+#include "gc/z/zThreadPolicy.hpp"
+#include "gc/z/zTracer.inline.hpp"
 #include "gc/z/zUtils.hpp"
 #include "logging/log.hpp"
+#include "memory/metaspace.hpp"
+#include "runtime/globals_extension.hpp"
+#include "runtime/os.hpp"
 
 const double ZDirector::one_in_1000 = 3.290527;
 
 ZDirector::ZDirector() :
-    _metronome(ZStatAllocRate::sample_hz) {
+    _metronome(ZStatAllocRate::sample_hz),
+    _nticks(0),
+    _soft_max_limit(SIZE_MAX),
+    _cpu_soft_max_limit(SIZE_MAX),
+    _cpu_overhead_nsamples(0),
+    _idle_start(0.0) {
   set_name("ZDirector");
   create_and_start();
 }
@@ -42,21 +55,193 @@ void ZDirector::sample_allocation_rate() const {
   // below to estimate the time we have until we run out of memory.
   const double bytes_per_second = ZStatAllocRate::sample_and_reset();
 
-  log_debug(gc, alloc)("Allocation Rate: %.3fMB/s, Avg: %.3f(+/-%.3f)MB/s",
+  log_debug(gc, alloc)("Allocation Rate: %.3fMB/s, Avg: %.3f(+/-%.3f)MB/s, Trend: %+.3fMB/s/s",
                        bytes_per_second / M,
                        ZStatAllocRate::avg() / M,
-                       ZStatAllocRate::avg_sd() / M);
+                       ZStatAllocRate::avg_sd() / M,
+                       ZStatAllocRate::trend() / M);
 }
 
-bool ZDirector::rule_timer() const {
+void ZDirector::sample_cpu_quota() const {
+  if (_nticks % ZStatAllocRate::sample_hz != 0) {
+    // Sample once per second
+    return;
+  }
+
+  ZCPUQuota::sample();
+}
+
+void ZDirector::sample_page_demand() const {
+  if (_nticks % ZStatAllocRate::sample_hz != 0) {
+    // Sample once per second
+    return;
+  }
+
+  ZHeap::heap()->sample_page_demand();
+}
+
+void ZDirector::sample_metaspace_rate() const {
+  // Sample metaspace growth rate. This is needed by rule_metaspace()
+  // below to estimate the time we have until metaspace reaches the
+  // capacity that would trigger a synchronous metadata GC.
+  const double bytes_per_second = ZStatMetaspaceRate::sample(MetaspaceUtils::committed_bytes());
+
+  log_trace(gc, director)("Metaspace Rate: %.3fKB/s, Avg: %.3f(+/-%.3f)KB/s",
+                          bytes_per_second / K,
+                          ZStatMetaspaceRate::avg() / K,
+                          ZStatMetaspaceRate::avg_sd() / K);
+}
+
+size_t ZDirector::memory_pressure_soft_max_limit() {
+  // Lower the soft max capacity by 10% per second while the memory
+  // pressure is above the limit, and raise it again by 10% per second
+  // once the pressure has dropped below half the limit. The soft max
+  // capacity is also kept below what fits under memory.high, given
+  // the memory used outside of the heap.
+  ZHeap* const heap = ZHeap::heap();
+  const size_t max_capacity = MIN2(SoftMaxHeapSize, heap->max_capacity());
+  const size_t capacity = heap->capacity();
+  const double pressure = ZMemoryPressure::pressure();
+
+  if (pressure > ZMemoryPressureLimit) {
+    _soft_max_limit = heap->soft_max_capacity() * 0.9;
+  } else if (pressure < ZMemoryPressureLimit / 2 && _soft_max_limit < max_capacity) {
+    _soft_max_limit = MIN2((size_t)(_soft_max_limit * 1.1), max_capacity);
+  }
+
+  size_t soft_max_limit = _soft_max_limit;
+
+  const size_t limit = ZMemoryPressure::limit();
+  if (limit != SIZE_MAX) {
+    const size_t usage = ZMemoryPressure::usage();
+    const size_t non_heap_usage = usage - MIN2(usage, capacity);
+    soft_max_limit = MIN2(soft_max_limit, limit - MIN2(limit, non_heap_usage));
+  }
+
+  log_debug(gc, director)("Memory Pressure: %.2f%%, Soft Max Limit: " SIZE_FORMAT "M",
+                          pressure, MIN2(soft_max_limit, max_capacity) / M);
+
+  return soft_max_limit;
+}
+
+size_t ZDirector::cpu_overhead_soft_max_limit() {
+  const AbsSeq& cpu_overhead = ZStatCycle::cpu_overhead();
+  if (cpu_overhead.num() == _cpu_overhead_nsamples) {
+    // No new sample since the last adjustment
+    return _cpu_soft_max_limit;
+  }
+
+  _cpu_overhead_nsamples = cpu_overhead.num();
+
+  // Grow the soft max capacity by 10% per GC cycle while the GC CPU overhead
+  // is above the target, so that GC runs less often, and shrink it again by
+  // 10% per GC cycle once the overhead is below half the target, to give
+  // back memory the GC does not need to hold the target. The soft max
+  // capacity is never shrunk below one and a half times the heap used after
+  // the last GC, to leave room for allocations between GC cycles.
+  ZHeap* const heap = ZHeap::heap();
+  const size_t max_capacity = MIN2(SoftMaxHeapSize, heap->max_capacity());
+  const size_t current_limit = MIN2(_cpu_soft_max_limit, max_capacity);
+  const double overhead = cpu_overhead.davg();
+  const double target = ZCPUOverheadTarget;
+
+  if (overhead > target) {
+    _cpu_soft_max_limit = MIN2((size_t)(current_limit * 1.1), max_capacity);
+  } else if (overhead < target / 2) {
+    const size_t min_limit = MAX2((size_t)(ZStatHeap::used_at_relocate_end() * 1.5), heap->min_capacity());
+    _cpu_soft_max_limit = MAX2((size_t)(current_limit * 0.9), MIN2(min_limit, current_limit));
+  }
+
+  log_debug(gc, director)("CPU Overhead: %.2f%%, Target: %u%%, Soft Max Limit: " SIZE_FORMAT "M",
+                          overhead, ZCPUOverheadTarget, MIN2(_cpu_soft_max_limit, max_capacity) / M);
+
+  return _cpu_soft_max_limit;
+}
+
+void ZDirector::adjust_soft_max_capacity() {
+  if (!ZMemoryPressure::is_enabled() && ZCPUOverheadTarget == 0) {
+    // Disabled
+    return;
+  }
+
+  if (_nticks % ZStatAllocRate::sample_hz != 0) {
+    // Adjust once per second
+    return;
+  }
+
+  size_t soft_max_limit = SIZE_MAX;
+
+  if (ZMemoryPressure::is_enabled()) {
+    soft_max_limit = MIN2(soft_max_limit, memory_pressure_soft_max_limit());
+  }
+
+  if (ZCPUOverheadTarget > 0) {
+    soft_max_limit = MIN2(soft_max_limit, cpu_overhead_soft_max_limit());
+  }
+
+  ZHeap::heap()->set_soft_max_limit(soft_max_limit);
+}
+
+double ZDirector::sample_idle_time(const ZDirectorInputs& inputs) {
+  // The application is considered idle while both the allocation rate
+  // and the system load are low. The load average is ignored if it's
+  // not available.
+  const double now = os::elapsedTime();
+  double loadavg = 0.0;
+  if (os::loadavg(&loadavg, 1) != 1) {
+    loadavg = 0.0;
+  }
+
+  const double load = loadavg / os::active_processor_count();
+  const double alloc_rate = inputs._alloc_rate_avg;
+  if (alloc_rate > ZIdleAllocationRate * M || load > ZIdleCPULoad) {
+    // Not idle
+    _idle_start = now;
+  }
+
+  const double idle_time = now - _idle_start;
+
+  log_trace(gc, director)("Idle Time: %.3fs, Allocation Rate: %.3fMB/s, Load: %.2f",
+                          idle_time, alloc_rate / M, load);
+
+  return idle_time;
+}
+
+ZDirectorInputs ZDirector::sample_inputs() {
+  ZHeap* const heap = ZHeap::heap();
+  const AbsSeq& duration_of_gc = ZStatCycle::normalized_duration();
+
+  ZDirectorInputs inputs;
+  inputs._time_since_last_gc = ZStatCycle::time_since_last();
+  inputs._nwarmup_cycles = ZStatCycle::nwarmup_cycles();
+  inputs._is_warm = ZStatCycle::is_warm();
+  inputs._is_duration_trustable = ZStatCycle::is_normalized_duration_trustable();
+  inputs._duration_avg = duration_of_gc.davg();
+  inputs._duration_sd = duration_of_gc.dsd();
+  inputs._alloc_rate_avg = ZStatAllocRate::avg();
+  inputs._alloc_rate_avg_sd = ZStatAllocRate::avg_sd();
+  inputs._alloc_rate_trend = ZStatAllocRate::trend_data();
+  inputs._soft_max_capacity = heap->soft_max_capacity();
+  inputs._max_reserve = heap->max_reserve();
+  inputs._used = heap->used();
+  inputs._used_at_relocate_end = ZStatHeap::used_at_relocate_end();
+  inputs._is_alloc_stalled = heap->is_alloc_stalled();
+  inputs._metaspace_committed = MetaspaceUtils::committed_bytes();
+  inputs._metaspace_capacity_until_gc = MetaspaceGC::capacity_until_GC();
+  inputs._metaspace_rate_avg = ZStatMetaspaceRate::avg();
+  inputs._metaspace_rate_avg_sd = ZStatMetaspaceRate::avg_sd();
+  inputs._idle_time = 0.0;
+  return inputs;
+}
+
+bool ZDirector::rule_timer(const ZDirectorInputs& inputs) {
   if (ZCollectionInterval == 0) {
     // Rule disabled
     return false;
   }
 
   // Perform GC if timer has expired.
-  const double time_since_last_gc = ZStatCycle::time_since_last();
-  const double time_until_gc = ZCollectionInterval - time_since_last_gc;
+  const double time_until_gc = ZCollectionInterval - inputs._time_since_last_gc;
 
   log_debug(gc, director)("Rule: Timer, Interval: %us, TimeUntilGC: %.3fs",
                           ZCollectionInterval, time_until_gc);
@@ -64,8 +249,8 @@ bool ZDirector::rule_timer() const {
   return time_until_gc <= 0;
 }
 
-bool ZDirector::rule_warmup() const {
-  if (ZStatCycle::is_warm()) {
+bool ZDirector::rule_warmup(const ZDirectorInputs& inputs) {
+  if (inputs._is_warm) {
     // Rule disabled
     return false;
   }
@@ -73,9 +258,9 @@ bool ZDirector::rule_warmup() const {
   // Perform GC if heap usage passes 10/20/30% and no other GC has been
   // performed yet. This allows us to get some early samples of the GC
   // duration, which is needed by the other rules.
-  const size_t max_capacity = ZHeap::heap()->soft_max_capacity();
-  const size_t used = ZHeap::heap()->used();
-  const double used_threshold_percent = (ZStatCycle::nwarmup_cycles() + 1) * 0.1;
+  const size_t max_capacity = inputs._soft_max_capacity;
+  const size_t used = inputs._used;
+  const double used_threshold_percent = (inputs._nwarmup_cycles + 1) * 0.1;
   const size_t used_threshold = max_capacity * used_threshold_percent;
 
   log_debug(gc, director)("Rule: Warmup %.0f%%, Used: " SIZE_FORMAT "MB, UsedThreshold: " SIZE_FORMAT "MB",
@@ -84,8 +269,154 @@ bool ZDirector::rule_warmup() const {
   return used >= used_threshold;
 }
 
-bool ZDirector::rule_allocation_rate() const {
-  if (!ZStatCycle::is_normalized_duration_trustable()) {
+size_t ZDirector::free_for_java_threads(const ZDirectorInputs& inputs) {
+  // Calculate amount of free memory available to Java threads. Note that
+  // the heap reserve is not available to Java threads and is therefore not
+  // considered part of the free memory.
+  const size_t max_capacity = inputs._soft_max_capacity;
+  const size_t max_reserve = inputs._max_reserve;
+  const size_t used = inputs._used;
+  const size_t free_with_reserve = max_capacity - MIN2(max_capacity, used);
+  return free_with_reserve - MIN2(free_with_reserve, max_reserve);
+}
+
+double ZDirector::max_duration_of_gc(const ZDirectorInputs& inputs) {
+  // Calculate max duration of a GC cycle. The duration of GC is a moving
+  // average, we add ~3.3 sigma to account for the GC duration variance.
+  // The duration is normalized to the default number of concurrent
+  // worker threads.
+  return inputs._duration_avg + (inputs._duration_sd * one_in_1000);
+}
+
+double ZDirector::max_alloc_rate(const ZDirectorInputs& inputs, double duration_of_gc, double* forecast_alloc_rate) {
+  // Calculate max allocation rate. The allocation rate is a moving average and
+  // we multiply that with an allocation spike tolerance factor to guard against
+  // unforeseen phase changes in the allocate rate. We then add ~3.3 sigma to
+  // account for the allocation rate variance, which means the probability is
+  // 1 in 1000 that a sample is outside of the confidence interval.
+  const double max_alloc_rate_avg = (inputs._alloc_rate_avg * ZAllocationSpikeTolerance) + (inputs._alloc_rate_avg_sd * one_in_1000);
+
+  // Forecast the allocation rate at the end of a GC cycle started now, given
+  // the current allocation rate trend. During a steady ramp-up this can exceed
+  // the moving average based estimate above, in which case we use the forecast
+  // to avoid starting the GC cycle too late.
+  *forecast_alloc_rate = ZAllocationRateTrend ? inputs._alloc_rate_trend.predict(duration_of_gc) : 0.0;
+  const double max_alloc_rate_forecast = *forecast_alloc_rate + (inputs._alloc_rate_avg_sd * one_in_1000);
+
+  return MAX2(max_alloc_rate_avg, max_alloc_rate_forecast);
+}
+
+void ZDirector::adjust_pacing(const ZDirectorInputs& inputs) const {
+  if (!ZPacing) {
+    // Pacing disabled
+    return;
+  }
+
+  double stretch = 0.0;
+
+  if (inputs._is_duration_trustable) {
+    // Pace allocations if the average allocation rate indicates that we will
+    // run out of memory before a GC cycle can complete. The allocations are
+    // slowed down so that the free memory lasts for the max duration of GC.
+    // The average rather than the max allocation rate is used, since pacing
+    // delays the application, while starting a GC early does not.
+    const size_t free = free_for_java_threads(inputs);
+    const double max_duration = max_duration_of_gc(inputs);
+    const double time_until_oom = free / (inputs._alloc_rate_avg + 1.0); // Plus 1.0B/s to avoid division by zero
+    if (time_until_oom < max_duration) {
+      stretch = max_duration / MAX2(time_until_oom, 0.001) - 1.0;
+
+      log_debug(gc, director)("Pacing: AvgAllocRate: %.3fMB/s, Free: " SIZE_FORMAT "MB, MaxDurationOfGC: %.3fs, TimeUntilOOM: %.3fs, Stretch: %.3f",
+                              inputs._alloc_rate_avg / M, free / M, max_duration, time_until_oom, stretch);
+    }
+  }
+
+  ZPacer::set_stretch(stretch);
+}
+
+uint ZDirector::nconcurrent_workers_max() {
+  // Never use more concurrent worker threads than the CPU quota allows, and
+  // only half of that while the process is being throttled, to leave the
+  // rest of the quota to the application threads. An explicitly set number
+  // of concurrent worker threads is respected as is.
+  const uint nworkers = ZHeap::heap()->nworker_threads();
+  if (FLAG_IS_CMDLINE(ConcGCThreads) || ZConcGCThreads != 0) {
+    // Explicitly set
+    return nworkers;
+  }
+
+  const double quota = ZCPUQuota::quota();
+  if (quota == 0.0) {
+    // No quota
+    return nworkers;
+  }
+
+  const double quota_share = ZCPUQuota::is_throttled() ? quota / 2 : quota;
+  return clamp((uint)ceil(quota_share), 1u, nworkers);
+}
+
+uint ZDirector::select_nconcurrent_workers() {
+  const uint nconcurrent = ZHeap::heap()->nconcurrent_no_boost_worker_threads();
+  const ZDirectorInputs inputs = sample_inputs();
+  if (!UseDynamicNumberOfGCThreads || !inputs._is_duration_trustable) {
+    // Use default number of concurrent worker threads
+    return MIN2(nconcurrent, nconcurrent_workers_max());
+  }
+
+  // Select the number of concurrent worker threads needed to complete the
+  // GC cycle before we run out of memory. The max duration of GC is
+  // normalized to the non-boosted number of concurrent worker threads, and
+  // we assume that the duration scales linearly with the number of worker
+  // threads. When there is plenty of headroom this selects fewer worker
+  // threads, to steal less CPU time from the application, and as the
+  // headroom shrinks the number of worker threads is gradually increased.
+  const size_t free = free_for_java_threads(inputs);
+  const double max_duration = max_duration_of_gc(inputs);
+  double forecast_alloc_rate;
+  const double alloc_rate = max_alloc_rate(inputs, max_duration, &forecast_alloc_rate);
+  const double time_until_oom = free / (alloc_rate + 1.0); // Plus 1.0B/s to avoid division by zero
+
+  // Deduct the sample interval, to leave some margin before we run out of memory
+  const double sample_interval = 1.0 / ZStatAllocRate::sample_hz;
+  const double time_available = MAX2(time_until_oom - sample_interval, sample_interval);
+  const double nworkers = ceil(nconcurrent * max_duration / time_available);
+  const uint nworkers_max = nconcurrent_workers_max();
+  const uint nworkers_selected = (uint)clamp(nworkers, 1.0, (double)nworkers_max);
+
+  log_debug(gc, director)("Select Concurrent Workers: %u, MaxDurationOfGC: %.3fs, TimeUntilOOM: %.3fs",
+                          nworkers_selected, max_duration, time_until_oom);
+
+  return nworkers_selected;
+}
+
+bool ZDirector::should_remap() {
+  const ZDirectorInputs inputs = sample_inputs();
+  if (!ZRemapAfterRelocation || !inputs._is_duration_trustable || inputs._is_alloc_stalled) {
+    // Remapping disabled
+    return false;
+  }
+
+  // Remap after relocation if the next GC is expected to start far enough
+  // into the future. Otherwise the next mark will soon remap the stale
+  // pointers anyway, and the remapping would only compete with it for CPU
+  // time. The remapping visits at most the objects visited by marking, so
+  // its duration is bounded by the duration of a GC cycle.
+  const size_t free = free_for_java_threads(inputs);
+  const double max_duration = max_duration_of_gc(inputs);
+  double forecast_alloc_rate;
+  const double alloc_rate = max_alloc_rate(inputs, max_duration, &forecast_alloc_rate);
+  const double time_until_oom = free / (alloc_rate + 1.0); // Plus 1.0B/s to avoid division by zero
+  const double time_until_gc = time_until_oom - max_duration;
+  const double min_time_until_gc = max_duration * 10.0;
+
+  log_debug(gc, director)("Remap: TimeUntilGC: %.3fs, MinTimeUntilGC: %.3fs",
+                          time_until_gc, min_time_until_gc);
+
+  return time_until_gc >= min_time_until_gc;
+}
+
+bool ZDirector::rule_allocation_rate(const ZDirectorInputs& inputs) {
+  if (!inputs._is_duration_trustable) {
     // Rule disabled
     return false;
   }
@@ -94,45 +425,31 @@ bool ZDirector::rule_allocation_rate() const {
   // will run out of memory. The estimated max allocation rate is based
   // on the moving average of the sampled allocation rate plus a safety
   // margin based on variations in the allocation rate and unforeseen
-  // allocation spikes.
-
-  // Calculate amount of free memory available to Java threads. Note that
-  // the heap reserve is not available to Java threads and is therefore not
-  // considered part of the free memory.
-  const size_t max_capacity = ZHeap::heap()->soft_max_capacity();
-  const size_t max_reserve = ZHeap::heap()->max_reserve();
-  const size_t used = ZHeap::heap()->used();
-  const size_t free_with_reserve = max_capacity - MIN2(max_capacity, used);
-  const size_t free = free_with_reserve - MIN2(free_with_reserve, max_reserve);
+  // allocation spikes, or on the forecasted allocation rate if that is
+  // higher, to account for a steadily increasing allocation rate.
+  const size_t free = free_for_java_threads(inputs);
+  const double max_duration = max_duration_of_gc(inputs);
+  double forecast_alloc_rate;
+  const double alloc_rate = max_alloc_rate(inputs, max_duration, &forecast_alloc_rate);
 
   // Calculate time until OOM given the max allocation rate and the amount
-  // of free memory. The allocation rate is a moving average and we multiply
-  // that with an allocation spike tolerance factor to guard against unforeseen
-  // phase changes in the allocate rate. We then add ~3.3 sigma to account for
-  // the allocation rate variance, which means the probability is 1 in 1000
-  // that a sample is outside of the confidence interval.
-  const double max_alloc_rate = (ZStatAllocRate::avg() * ZAllocationSpikeTolerance) + (ZStatAllocRate::avg_sd() * one_in_1000);
-  const double time_until_oom = free / (max_alloc_rate + 1.0); // Plus 1.0B/s to avoid division by zero
-
-  // Calculate max duration of a GC cycle. The duration of GC is a moving
-  // average, we add ~3.3 sigma to account for the GC duration variance.
-  const AbsSeq& duration_of_gc = ZStatCycle::normalized_duration();
-  const double max_duration_of_gc = duration_of_gc.davg() + (duration_of_gc.dsd() * one_in_1000);
+  // of free memory.
+  const double time_until_oom = free / (alloc_rate + 1.0); // Plus 1.0B/s to avoid division by zero
 
   // Calculate time until GC given the time until OOM and max duration of GC.
   // We also deduct the sample interval, so that we don't overshoot the target
   // time and end up starting the GC too late in the next interval.
   const double sample_interval = 1.0 / ZStatAllocRate::sample_hz;
-  const double time_until_gc = time_until_oom - max_duration_of_gc - sample_interval;
+  const double time_until_gc = time_until_oom - max_duration - sample_interval;
 
-  log_debug(gc, director)("Rule: Allocation Rate, MaxAllocRate: %.3fMB/s, Free: " SIZE_FORMAT "MB, MaxDurationOfGC: %.3fs, TimeUntilGC: %.3fs",
-                          max_alloc_rate / M, free / M, max_duration_of_gc, time_until_gc);
+  log_debug(gc, director)("Rule: Allocation Rate, MaxAllocRate: %.3fMB/s, ForecastAllocRate: %.3fMB/s, Free: " SIZE_FORMAT "MB, MaxDurationOfGC: %.3fs, TimeUntilGC: %.3fs",
+                          alloc_rate / M, forecast_alloc_rate / M, free / M, max_duration, time_until_gc);
 
   return time_until_gc <= 0;
 }
 
-bool ZDirector::rule_proactive() const {
-  if (!ZProactive || !ZStatCycle::is_warm()) {
+bool ZDirector::rule_proactive(const ZDirectorInputs& inputs) {
+  if (!ZProactive || !inputs._is_warm) {
     // Rule disabled
     return false;
   }
@@ -146,11 +463,11 @@ bool ZDirector::rule_proactive() const {
   // 10% of the max capacity since the previous GC, or more than 5 minutes has
   // passed since the previous GC. This helps avoid superfluous GCs when running
   // applications with very low allocation rate.
-  const size_t used_after_last_gc = ZStatHeap::used_at_relocate_end();
-  const size_t used_increase_threshold = ZHeap::heap()->soft_max_capacity() * 0.10; // 10%
+  const size_t used_after_last_gc = inputs._used_at_relocate_end;
+  const size_t used_increase_threshold = inputs._soft_max_capacity * 0.10; // 10%
   const size_t used_threshold = used_after_last_gc + used_increase_threshold;
-  const size_t used = ZHeap::heap()->used();
-  const double time_since_last_gc = ZStatCycle::time_since_last();
+  const size_t used = inputs._used;
+  const double time_since_last_gc = inputs._time_since_last_gc;
   const double time_since_last_gc_threshold = 5 * 60; // 5 minutes
   if (used < used_threshold && time_since_last_gc < time_since_last_gc_threshold) {
     // Don't even consider doing a proactive GC
@@ -160,11 +477,13 @@ bool ZDirector::rule_proactive() const {
     return false;
   }
 
+  // The acceptable throughput drop is the GC CPU overhead target, if set.
+  // It is capped at half the assumed throughput drop during GC, so that
+  // the acceptable interval is never shorter than the GC duration itself.
   const double assumed_throughput_drop_during_gc = 0.50; // 50%
-  const double acceptable_throughput_drop = 0.01;        // 1%
-  const AbsSeq& duration_of_gc = ZStatCycle::normalized_duration();
-  const double max_duration_of_gc = duration_of_gc.davg() + (duration_of_gc.dsd() * one_in_1000);
-  const double acceptable_gc_interval = max_duration_of_gc * ((assumed_throughput_drop_during_gc / acceptable_throughput_drop) - 1.0);
+  const double target_throughput_drop = (ZCPUOverheadTarget > 0) ? ZCPUOverheadTarget / 100.0 : 0.01; // 1%
+  const double acceptable_throughput_drop = MIN2(target_throughput_drop, assumed_throughput_drop_during_gc / 2);
+  const double acceptable_gc_interval = max_duration_of_gc(inputs) * ((assumed_throughput_drop_during_gc / acceptable_throughput_drop) - 1.0);
   const double time_until_gc = acceptable_gc_interval - time_since_last_gc;
 
   log_debug(gc, director)("Rule: Proactive, AcceptableGCInterval: %.3fs, TimeSinceLastGC: %.3fs, TimeUntilGC: %.3fs",
@@ -173,7 +492,7 @@ bool ZDirector::rule_proactive() const {
   return time_until_gc <= 0;
 }
 
-bool ZDirector::rule_high_usage() const {
+bool ZDirector::rule_high_usage(const ZDirectorInputs& inputs) {
   // Perform GC if the amount of free memory is 5% or less. This is a preventive
   // meassure in the case where the application has a very low allocation rate,
   // such that the allocation rate rule doesn't trigger, but the amount of free
@@ -183,10 +502,10 @@ bool ZDirector::rule_high_usage() const {
   // Calculate amount of free memory available to Java threads. Note that
   // the heap reserve is not available to Java threads and is therefore not
   // considered part of the free memory.
-  const size_t max_capacity = ZHeap::heap()->soft_max_capacity();
-  const size_t max_reserve = ZHeap::heap()->max_reserve();
-  const size_t used = ZHeap::heap()->used();
-  const size_t free_with_reserve = max_capacity - used;
+  const size_t max_capacity = inputs._soft_max_capacity;
+  const size_t max_reserve = inputs._max_reserve;
+  const size_t used = inputs._used;
+  const size_t free_with_reserve = max_capacity - MIN2(max_capacity, used);
   const size_t free = free_with_reserve - MIN2(free_with_reserve, max_reserve);
   const double free_percent = percent_of(free, max_capacity);
 
@@ -196,29 +515,91 @@ bool ZDirector::rule_high_usage() const {
   return free_percent <= 5.0;
 }
 
-GCCause::Cause ZDirector::make_gc_decision() const {
+bool ZDirector::rule_idle(const ZDirectorInputs& inputs) {
+  if (ZIdleGCDelay == 0 || !inputs._is_warm) {
+    // Rule disabled
+    return false;
+  }
+
+  // Perform a compacting GC, followed by uncommit of the freed memory,
+  // once the application has been idle for a while. This shrinks the
+  // heap back down while it's not needed, and leaves it tightly packed
+  // for when the load picks up again. Only one GC is performed per idle
+  // period, i.e. not if a GC has already been performed since the
+  // application became idle.
+  const double idle_time = inputs._idle_time;
+  const double time_until_gc = ZIdleGCDelay - idle_time;
+  const bool collected_while_idle = inputs._time_since_last_gc < idle_time;
+
+  log_debug(gc, director)("Rule: Idle, IdleTime: %.3fs, TimeUntilGC: %.3fs%s",
+                          idle_time, time_until_gc, collected_while_idle ? ", Collected" : "");
+
+  return time_until_gc <= 0 && !collected_while_idle;
+}
+
+bool ZDirector::rule_metaspace(const ZDirectorInputs& inputs) {
+  if (!ClassUnloading || !inputs._is_duration_trustable || inputs._metaspace_rate_avg == 0.0) {
+    // Rule disabled
+    return false;
+  }
+
+  // Perform GC if the estimated max metaspace growth rate indicates that
+  // metaspace will reach the capacity until GC before a GC cycle started
+  // now would complete. Reaching that capacity forces the class loading
+  // thread to request a GC and then wait for a synchronous one if
+  // metaspace could not be expanded. Starting the GC ahead of time lets
+  // class unloading free up metaspace before anyone has to wait for it.
+  const size_t committed = inputs._metaspace_committed;
+  const size_t capacity_until_gc = inputs._metaspace_capacity_until_gc;
+  const size_t headroom = capacity_until_gc - MIN2(capacity_until_gc, committed);
+  const double max_rate = (inputs._metaspace_rate_avg * ZAllocationSpikeTolerance) + (inputs._metaspace_rate_avg_sd * one_in_1000);
+  const double max_duration = max_duration_of_gc(inputs);
+  const double time_until_threshold = headroom / (max_rate + 1.0); // Plus 1.0B/s to avoid division by zero
+
+  // Deduct the sample interval, so that we don't start the GC too late
+  // in the next interval.
+  const double sample_interval = 1.0 / ZStatAllocRate::sample_hz;
+  const double time_until_gc = time_until_threshold - max_duration - sample_interval;
+
+  log_debug(gc, director)("Rule: Metaspace, MaxRate: %.3fKB/s, Headroom: " SIZE_FORMAT "KB, MaxDurationOfGC: %.3fs, TimeUntilGC: %.3fs",
+                          max_rate / K, headroom / K, max_duration, time_until_gc);
+
+  return time_until_gc <= 0;
+}
+
+GCCause::Cause ZDirector::make_gc_decision(const ZDirectorInputs& inputs) {
   // Rule 0: Timer
-  if (rule_timer()) {
+  if (rule_timer(inputs)) {
     return GCCause::_z_timer;
   }
 
   // Rule 1: Warmup
-  if (rule_warmup()) {
+  if (rule_warmup(inputs)) {
     return GCCause::_z_warmup;
   }
 
   // Rule 2: Allocation rate
-  if (rule_allocation_rate()) {
+  if (rule_allocation_rate(inputs)) {
     return GCCause::_z_allocation_rate;
   }
 
-  // Rule 3: Proactive
-  if (rule_proactive()) {
+  // Rule 3: Metaspace
+  if (rule_metaspace(inputs)) {
+    return GCCause::_z_metaspace;
+  }
+
+  // Rule 4: Idle
+  if (rule_idle(inputs)) {
+    return GCCause::_z_idle;
+  }
+
+  // Rule 5: Proactive
+  if (rule_proactive(inputs)) {
     return GCCause::_z_proactive;
   }
 
-  // Rule 4: High usage
-  if (rule_high_usage()) {
+  // Rule 6: High usage
+  if (rule_high_usage(inputs)) {
     return GCCause::_z_high_usage;
   }
 
@@ -226,14 +607,119 @@ GCCause::Cause ZDirector::make_gc_decision() const {
   return GCCause::_no_gc;
 }
 
+void ZDirector::report_gc_decision(const ZDirectorInputs& inputs, GCCause::Cause cause) const {
+  // Report the inputs used by the rules above, regardless of which
+  // rule (if any) decided to start a GC cycle.
+  const size_t free = free_for_java_threads(inputs);
+  const double max_duration = max_duration_of_gc(inputs);
+  double forecast_alloc_rate;
+  const double alloc_rate = max_alloc_rate(inputs, max_duration, &forecast_alloc_rate);
+  const double time_until_oom = free / (alloc_rate + 1.0); // Plus 1.0B/s to avoid division by zero
+
+  ZTracer::tracer()->report_director_decision(cause,
+                                              inputs._alloc_rate_avg,
+                                              inputs._alloc_rate_avg_sd,
+                                              forecast_alloc_rate,
+                                              alloc_rate,
+                                              free,
+                                              max_duration,
+                                              time_until_oom,
+                                              inputs._is_alloc_stalled);
+}
+
+size_t ZDirector::forecast_free() {
+  // Forecast the amount of memory free for Java threads at the end of a
+  // GC cycle started now, given the current heap usage and the max
+  // allocation rate during the max duration of GC.
+  const ZDirectorInputs inputs = sample_inputs();
+  const size_t free = free_for_java_threads(inputs);
+
+  if (!inputs._is_duration_trustable) {
+    // Duration of GC not yet known
+    return free;
+  }
+
+  const double max_duration = max_duration_of_gc(inputs);
+  double forecast_alloc_rate;
+  const double alloc_rate = max_alloc_rate(inputs, max_duration, &forecast_alloc_rate);
+  const size_t needed = (size_t)MIN2(alloc_rate * max_duration, (double)free);
+  return free - needed;
+}
+
+size_t ZDirector::used_threshold(const ZDirectorInputs& inputs) {
+  // Calculate the heap usage at which the usage based rules would decide
+  // to start a GC cycle, given the inputs sampled at this tick. Crossing
+  // this threshold between two ticks wakes up the director early, which
+  // bounds the reaction time to a sudden allocation burst.
+  const size_t max_capacity = inputs._soft_max_capacity;
+  const size_t max_reserve = inputs._max_reserve;
+  size_t threshold = SIZE_MAX;
+
+  if (inputs._is_duration_trustable) {
+    // Inverse of the allocation rate rule
+    const double max_duration = max_duration_of_gc(inputs);
+    double forecast_alloc_rate;
+    const double alloc_rate = max_alloc_rate(inputs, max_duration, &forecast_alloc_rate);
+    const double sample_interval = 1.0 / ZStatAllocRate::sample_hz;
+    const double needed = (alloc_rate + 1.0) * (max_duration + sample_interval);
+    const size_t needed_with_reserve = (size_t)MIN2(needed, (double)max_capacity) + max_reserve;
+    threshold = MIN2(threshold, max_capacity - MIN2(max_capacity, needed_with_reserve));
+  }
+
+  // Inverse of the high usage rule
+  const size_t min_free_with_reserve = (size_t)(max_capacity * 0.05) + max_reserve;
+  threshold = MIN2(threshold, max_capacity - MIN2(max_capacity, min_free_with_reserve));
+
+  if (!inputs._is_warm) {
+    // Inverse of the warmup rule
+    threshold = MIN2(threshold, (size_t)(max_capacity * ((inputs._nwarmup_cycles + 1) * 0.1)));
+  }
+
+  return threshold;
+}
+
+void ZDirector::wakeup() {
+  _metronome.wakeup();
+}
+
 void ZDirector::run_service() {
+  ZThreadPolicy::bind_current_thread();
+
   // Main loop
-  while (_metronome.wait_for_tick()) {
-    sample_allocation_rate();
-    const GCCause::Cause cause = make_gc_decision();
+  bool woken = false;
+  while (_metronome.wait_for_tick_or_wakeup(&woken)) {
+    ZDirectorInputs inputs;
+    if (!woken) {
+      // Regular tick. The samplers assume a fixed sample interval, so
+      // they are only driven from here.
+      _nticks++;
+      sample_allocation_rate();
+      sample_cpu_quota();
+      sample_page_demand();
+      sample_metaspace_rate();
+      adjust_soft_max_capacity();
+      inputs = sample_inputs();
+      inputs._idle_time = sample_idle_time(inputs);
+      adjust_pacing(inputs);
+    } else {
+      // Woken up by an allocation crossing the usage threshold
+      log_debug(gc, director)("Woken up, Used: " SIZE_FORMAT "MB", ZHeap::heap()->used() / M);
+      inputs = sample_inputs();
+      inputs._idle_time = 0.0;
+    }
+
+    const GCCause::Cause cause = make_gc_decision(inputs);
+    report_gc_decision(inputs, cause);
     if (cause != GCCause::_no_gc) {
       ZCollectedHeap::heap()->collect(cause);
     }
+
+    if (ZDirectorWakeup) {
+      // Re-arm the usage threshold. If usage is already past it, the
+      // regular ticks handle it, to avoid waking up on every allocation.
+      const size_t threshold = used_threshold(inputs);
+      ZHeap::heap()->set_director_threshold(threshold > inputs._used ? threshold : SIZE_MAX);
+    }
   }
 }
 
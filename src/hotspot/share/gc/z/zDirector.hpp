@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, 2017, Oracle and/or its affiliates. All rights reserved.
+ * Copyright (c) 2015, 2019, Oracle and/or its affiliates. All rights reserved.
  * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
  *
  * This code is free software; you can redistribute it and/or modify it
@@ -27,21 +27,81 @@
 #include "gc/shared/concurrentGCThread.hpp"
 #include "gc/shared/gcCause.hpp"
 #include "gc/z/zMetronome.hpp"
+#include "gc/z/zStat.hpp"
+
+// Inputs to the GC decision rules. These are sampled from the heap and
+// the GC statistics once per tick, but can also be derived from recorded
+// traces, to replay the decisions offline.
+struct ZDirectorInputs {
+  // Cycle statistics
+  double     _time_since_last_gc;    // Seconds
+  uint64_t   _nwarmup_cycles;
+  bool       _is_warm;
+  bool       _is_duration_trustable;
+  double     _duration_avg;          // Seconds, normalized
+  double     _duration_sd;           // Seconds, normalized
+
+  // Allocation rate statistics
+  double     _alloc_rate_avg;        // B/s
+  double     _alloc_rate_avg_sd;     // B/s
+  ZStatTrend _alloc_rate_trend;      // B/s
+
+  // Heap usage
+  size_t     _soft_max_capacity;
+  size_t     _max_reserve;
+  size_t     _used;
+  size_t     _used_at_relocate_end;
+  bool       _is_alloc_stalled;
+
+  // Metaspace statistics
+  size_t     _metaspace_committed;
+  size_t     _metaspace_capacity_until_gc;
+  double     _metaspace_rate_avg;    // B/s
+  double     _metaspace_rate_avg_sd; // B/s
+
+  // Idle statistics
+  double     _idle_time;             // Seconds
+};
 
 class ZDirector : public ConcurrentGCThread {
 private:
   static const double one_in_1000;
 
   ZMetronome _metronome;
+  uint64_t   _nticks;
+  size_t     _soft_max_limit;
+  size_t     _cpu_soft_max_limit;
+  int        _cpu_overhead_nsamples;
+  double     _idle_start;
+
+  static ZDirectorInputs sample_inputs();
+
+  static size_t free_for_java_threads(const ZDirectorInputs& inputs);
+  static double max_duration_of_gc(const ZDirectorInputs& inputs);
+  static double max_alloc_rate(const ZDirectorInputs& inputs, double duration_of_gc, double* forecast_alloc_rate);
+
+  static uint nconcurrent_workers_max();
 
   void sample_allocation_rate() const;
+  void sample_cpu_quota() const;
+  void sample_page_demand() const;
+  void sample_metaspace_rate() const;
+  size_t memory_pressure_soft_max_limit();
+  size_t cpu_overhead_soft_max_limit();
+  void adjust_soft_max_capacity();
+  void adjust_pacing(const ZDirectorInputs& inputs) const;
+  double sample_idle_time(const ZDirectorInputs& inputs);
+
+  static bool rule_timer(const ZDirectorInputs& inputs);
+  static bool rule_warmup(const ZDirectorInputs& inputs);
+  static bool rule_allocation_rate(const ZDirectorInputs& inputs);
+  static bool rule_proactive(const ZDirectorInputs& inputs);
+  static bool rule_high_usage(const ZDirectorInputs& inputs);
+  static bool rule_idle(const ZDirectorInputs& inputs);
+  static bool rule_metaspace(const ZDirectorInputs& inputs);
+  void report_gc_decision(const ZDirectorInputs& inputs, GCCause::Cause cause) const;
 
-  bool rule_timer() const;
-  bool rule_warmup() const;
-  bool rule_allocation_rate() const;
-  bool rule_proactive() const;
-  bool rule_high_usage() const;
-  GCCause::Cause make_gc_decision() const;
+  static size_t used_threshold(const ZDirectorInputs& inputs);
 
 protected:
   virtual void run_service();
@@ -49,6 +109,14 @@ protected:
 
 public:
   ZDirector();
+
+  void wakeup();
+
+  static GCCause::Cause make_gc_decision(const ZDirectorInputs& inputs);
+
+  static size_t forecast_free();
+  static uint select_nconcurrent_workers();
+  static bool should_remap();
 };
 
 #endif // SHARE_GC_Z_ZDIRECTOR_HPP
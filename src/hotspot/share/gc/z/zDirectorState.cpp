@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zDirectorState.hpp"
+#include "gc/z/zHeap.inline.hpp"
+#include "gc/z/zStat.hpp"
+#include "logging/log.hpp"
+#include "runtime/globals.hpp"
+#include "utilities/globalDefinitions.hpp"
+#include "utilities/ostream.hpp"
+
+#include <stdio.h>
+
+// Version of the file format, bumped on incompatible changes
+static const uint ZDirectorStateVersion = 2;
+
+// The values are stored as integers, in nanoseconds and bytes per second,
+// since the formatting and parsing of floating point numbers depends on
+// the locale of the process
+static const double ZDirectorStateValueMax = (double)(SIZE_MAX / 2);
+
+static bool is_valid_value(double value) {
+  return !g_isnan(value) && g_isfinite(value) && value >= 0.0 && value <= ZDirectorStateValueMax;
+}
+
+bool ZDirectorState::is_valid(const ZData& data) {
+  return is_valid_value(data._duration_avg * NANOSECS_PER_SEC) &&
+         is_valid_value(data._duration_sd * NANOSECS_PER_SEC) &&
+         is_valid_value(data._alloc_rate_avg) &&
+         is_valid_value(data._alloc_rate_avg_sd) &&
+         data._duration_avg > 0.0;
+}
+
+bool ZDirectorState::read(const char* path, ZData* data) {
+  FILE* const file = fopen(path, "r");
+  if (file == NULL) {
+    return false;
+  }
+
+  uint version = 0;
+  size_t duration_avg = 0;
+  size_t duration_sd = 0;
+  size_t alloc_rate_avg = 0;
+  size_t alloc_rate_avg_sd = 0;
+
+  const int nfields = fscanf(file,
+                             "version=%u\n"
+                             "max_capacity=" SIZE_FORMAT "\n"
+                             "duration_avg_ns=" SIZE_FORMAT "\n"
+                             "duration_sd_ns=" SIZE_FORMAT "\n"
+                             "alloc_rate_avg=" SIZE_FORMAT "\n"
+                             "alloc_rate_avg_sd=" SIZE_FORMAT "\n",
+                             &version,
+                             &data->_max_capacity,
+                             &duration_avg,
+                             &duration_sd,
+                             &alloc_rate_avg,
+                             &alloc_rate_avg_sd);
+  fclose(file);
+
+  if (nfields != 6 || version != ZDirectorStateVersion) {
+    // Not a file of this version
+    return false;
+  }
+
+  data->_duration_avg = (double)duration_avg / NANOSECS_PER_SEC;
+  data->_duration_sd = (double)duration_sd / NANOSECS_PER_SEC;
+  data->_alloc_rate_avg = (double)alloc_rate_avg;
+  data->_alloc_rate_avg_sd = (double)alloc_rate_avg_sd;
+
+  return is_valid(*data);
+}
+
+bool ZDirectorState::write(const char* path, const ZData& data) {
+  if (!is_valid(data)) {
+    // Don't persist values that can't be loaded
+    return false;
+  }
+
+  fileStream file(path, "w");
+  if (!file.is_open()) {
+    return false;
+  }
+
+  file.print_cr("version=%u", ZDirectorStateVersion);
+  file.print_cr("max_capacity=" SIZE_FORMAT, data._max_capacity);
+  file.print_cr("duration_avg_ns=" SIZE_FORMAT, (size_t)(data._duration_avg * NANOSECS_PER_SEC));
+  file.print_cr("duration_sd_ns=" SIZE_FORMAT, (size_t)(data._duration_sd * NANOSECS_PER_SEC));
+  file.print_cr("alloc_rate_avg=" SIZE_FORMAT, (size_t)data._alloc_rate_avg);
+  file.print_cr("alloc_rate_avg_sd=" SIZE_FORMAT, (size_t)data._alloc_rate_avg_sd);
+
+  return true;
+}
+
+void ZDirectorState::load() {
+  if (ZDirectorStateFile == NULL) {
+    // Disabled
+    return;
+  }
+
+  ZData data;
+  if (!read(ZDirectorStateFile, &data)) {
+    log_info(gc, init)("Director State: Not loaded (%s not readable or invalid)", ZDirectorStateFile);
+    return;
+  }
+
+  // The statistics depend on the heap size, so they
+  // are only reused if the max capacity is the same
+  if (data._max_capacity != ZHeap::heap()->max_capacity()) {
+    log_info(gc, init)("Director State: Not loaded (%s is incompatible)", ZDirectorStateFile);
+    return;
+  }
+
+  ZStatCycle::seed(data._duration_avg, data._duration_sd);
+  ZStatAllocRate::seed(data._alloc_rate_avg, data._alloc_rate_avg_sd);
+
+  log_info(gc, init)("Director State: Loaded from %s (Duration: %.3f / %.3f s, Allocation Rate: %.3f / %.3f MB/s)",
+                     ZDirectorStateFile,
+                     data._duration_avg, data._duration_sd,
+                     data._alloc_rate_avg / M, data._alloc_rate_avg_sd / M);
+}
+
+void ZDirectorState::save() {
+  if (ZDirectorStateFile == NULL) {
+    // Disabled
+    return;
+  }
+
+  if (!ZStatCycle::is_normalized_duration_trustable()) {
+    // Nothing learned yet, keep any previous state
+    return;
+  }
+
+  const AbsSeq& duration = ZStatCycle::normalized_duration();
+
+  ZData data;
+  data._max_capacity = ZHeap::heap()->max_capacity();
+  data._duration_avg = duration.davg();
+  data._duration_sd = duration.dsd();
+  data._alloc_rate_avg = ZStatAllocRate::avg();
+  data._alloc_rate_avg_sd = ZStatAllocRate::avg_sd();
+
+  if (!write(ZDirectorStateFile, data)) {
+    log_warning(gc)("Director State: Failed to save to %s", ZDirectorStateFile);
+    return;
+  }
+
+  log_info(gc)("Director State: Saved to %s", ZDirectorStateFile);
+}
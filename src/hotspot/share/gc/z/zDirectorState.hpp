@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZDIRECTORSTATE_HPP
+#define SHARE_GC_Z_ZDIRECTORSTATE_HPP
+
+#include "memory/allocation.hpp"
+
+// Persists the statistics the director has learned, such as the
+// allocation rate and GC duration, in ZDirectorStateFile, so that
+// a restarted VM running the same workload can start out warm.
+class ZDirectorState : public AllStatic {
+  friend class ZDirectorStateTest;
+
+private:
+  struct ZData {
+    size_t _max_capacity;
+    double _duration_avg;
+    double _duration_sd;
+    double _alloc_rate_avg;
+    double _alloc_rate_avg_sd;
+  };
+
+  static bool is_valid(const ZData& data);
+  static bool read(const char* path, ZData* data);
+  static bool write(const char* path, const ZData& data);
+
+public:
+  static void load();
+  static void save();
+};
+
+#endif // SHARE_GC_Z_ZDIRECTORSTATE_HPP
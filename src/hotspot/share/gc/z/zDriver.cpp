@@ -22,18 +22,22 @@
  */
 
 #include "precompiled.hpp"
+#include "gc/shared/concurrentGCPhaseManager.hpp"
 #include "gc/shared/gcId.hpp"
 #include "gc/shared/gcLocker.hpp"
 #include "gc/shared/isGCActiveMark.hpp"
 #include "gc/z/zCollectedHeap.hpp"
+#include "gc/z/zDirector.hpp"
 #include "gc/z/zDriver.hpp"
 #include "gc/z/zHeap.inline.hpp"
 #include "gc/z/zMessagePort.inline.hpp"
 #include "gc/z/zServiceability.hpp"
 #include "gc/z/zStat.hpp"
+#include "gc/z/zThreadPolicy.hpp"
 #include "gc/z/zVerify.hpp"
 #include "logging/log.hpp"
 #include "memory/universe.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/vmOperations.hpp"
 #include "runtime/vmThread.hpp"
 
@@ -47,36 +51,108 @@ static const ZStatPhaseConcurrent ZPhaseConcurrentResetRelocationSet("Concurrent
 static const ZStatPhaseConcurrent ZPhaseConcurrentSelectRelocationSet("Concurrent Select Relocation Set");
 static const ZStatPhasePause      ZPhasePauseRelocateStart("Pause Relocate Start");
 static const ZStatPhaseConcurrent ZPhaseConcurrentRelocated("Concurrent Relocate");
+static const ZStatPhaseConcurrent ZPhaseConcurrentRemap("Concurrent Remap");
 static const ZStatCriticalPhase   ZCriticalPhaseGCLockerStall("GC Locker Stall", false /* verbose */);
 static const ZStatSampler         ZSamplerJavaThreads("System", "Java Threads", ZStatUnitThreads);
+static const ZStatHistogram       ZHistogramTimeToSafepoint("Latency", "Time To Safepoint");
+
+// Concurrent phases that can be requested through WhiteBox, to hold the
+// driver at a specific point of the GC cycle. The driver blocks when
+// leaving a requested phase, until a different phase is requested.
+//
+//   CONCURRENT_CYCLE      - Blocks before the end of the GC cycle
+//   CONCURRENT_MARK       - Blocks before Pause Mark End
+//   MARK_COMPLETED        - Blocks after Pause Mark End, before processing
+//                           non-strong references
+//   BEFORE_RELOCATE_START - Blocks after the relocation set has been
+//                           selected, before Pause Relocate Start
+//   CONCURRENT_RELOCATE   - Blocks after relocation has completed
+//   CONCURRENT_REMAP      - Blocks after the optional remap has completed,
+//                           or has been skipped
+//
+class ZDriverPhase : public AllStatic {
+public:
+  enum {
+    ANY = ConcurrentGCPhaseManager::UNCONSTRAINED_PHASE,
+    IDLE = ConcurrentGCPhaseManager::IDLE_PHASE,
+    CONCURRENT_CYCLE,
+    CONCURRENT_MARK,
+    MARK_COMPLETED,
+    BEFORE_RELOCATE_START,
+    CONCURRENT_RELOCATE,
+    CONCURRENT_REMAP,
+    PHASE_ID_LIMIT
+  };
+};
+
+static const char* const ZDriverPhaseNames[] = {
+  "ANY",
+  "IDLE",
+  "CONCURRENT_CYCLE",
+  "CONCURRENT_MARK",
+  "MARK_COMPLETED",
+  "BEFORE_RELOCATE_START",
+  "CONCURRENT_RELOCATE",
+  "CONCURRENT_REMAP"
+};
+
+STATIC_ASSERT(ZDriverPhase::PHASE_ID_LIMIT == ARRAY_SIZE(ZDriverPhaseNames));
+
+static int lookup_phase(const char* name) {
+  for (int i = 0; i < ZDriverPhase::PHASE_ID_LIMIT; i++) {
+    if (strcmp(name, ZDriverPhaseNames[i]) == 0) {
+      return i;
+    }
+  }
+
+  // Unknown phase
+  return -1;
+}
 
 class VM_ZOperation : public VM_Operation {
 private:
-  const uint _gc_id;
-  bool       _gc_locked;
-  bool       _success;
+  const ZStatPhasePause& _phase;
+  const uint             _gc_id;
+  bool                   _gc_locked;
+  bool                   _success;
+  Ticks                  _requested;
 
 public:
-  VM_ZOperation() :
+  VM_ZOperation(const ZStatPhasePause& phase) :
+      _phase(phase),
       _gc_id(GCId::current()),
       _gc_locked(false),
-      _success(false) {}
+      _success(false),
+      _requested() {}
 
   virtual bool needs_inactive_gc_locker() const {
     // An inactive GC locker is needed in operations where we change the bad
     // mask or move objects. Changing the bad mask will invalidate all oops,
     // which makes it conceptually the same thing as moving all objects.
+    // Objects in most JNI critical regions are pinned instead, see
+    // ZCollectedHeap::pin_object(), and don't enter the GC locker.
     return false;
   }
 
   virtual bool do_operation() = 0;
 
+  virtual bool defer_optional_safepoint_cleanup() const {
+    // Keep the pauses short, the optional cleanup tasks
+    // are done by the next safepoint not started by ZGC.
+    return true;
+  }
+
   virtual bool doit_prologue() {
     Heap_lock->lock();
+    _requested = Ticks::now();
     return true;
   }
 
   virtual void doit() {
+    // Time from the operation being requested until the safepoint is
+    // reached, which includes the time spent queued on the VM thread
+    ZStatSample(ZHistogramTimeToSafepoint, (Ticks::now() - _requested).value());
+
     // Abort if GC locker state is incompatible
     if (needs_inactive_gc_locker() && GCLocker::check_active_before_gc()) {
       _gc_locked = true;
@@ -87,6 +163,9 @@ public:
     GCIdMark gc_id_mark(_gc_id);
     IsGCActiveMark gc_active_mark;
 
+    // Time from the safepoint being started until all threads had stopped
+    _phase.register_time_to_safepoint();
+
     // Verify before operation
     ZVerify::before_zoperation();
 
@@ -111,9 +190,13 @@ public:
 };
 
 static bool should_clear_soft_references() {
-  // Clear if one or more allocations have stalled
+  // Clear if one or more allocations have stalled. With graduated clearing,
+  // the first cycle of a stall uses the forecast policy, and all
+  // SoftReferences are cleared only once an allocation has stayed stalled
+  // through a completed GC cycle. The stalled allocation is not failed
+  // before such a clearing cycle has completed.
   const bool stalled = ZHeap::heap()->is_alloc_stalled();
-  if (stalled) {
+  if (stalled && (!ZGraduatedSoftReferenceClearing || ZHeap::heap()->is_alloc_stalled_through_gc())) {
     // Clear
     return true;
   }
@@ -130,6 +213,25 @@ static bool should_clear_soft_references() {
   return false;
 }
 
+static bool is_explicit_gc(GCCause::Cause cause) {
+  return cause == GCCause::_java_lang_system_gc ||
+         cause == GCCause::_dcmd_gc_run ||
+         cause == GCCause::_wb_full_gc;
+}
+
+static bool should_compact_aggressively(GCCause::Cause cause) {
+  // Explicit and idle GCs compact aggressively, and uncommit the freed
+  // memory without delay, to leave the smallest possible heap behind
+  return is_explicit_gc(cause) || cause == GCCause::_z_idle;
+}
+
+static bool should_skip_relocation(GCCause::Cause cause) {
+  // Proactive and timer GCs mainly process references and unload classes,
+  // so they may skip relocation when it would reclaim little memory
+  return ZRelocationSkipLimit > 0.0 &&
+         (cause == GCCause::_z_proactive || cause == GCCause::_z_timer);
+}
+
 static bool should_boost_worker_threads() {
   // Boost worker threads if one or more allocations have stalled
   const bool stalled = ZHeap::heap()->is_alloc_stalled();
@@ -140,8 +242,7 @@ static bool should_boost_worker_threads() {
 
   // Boost worker threads if implied by the GC cause
   const GCCause::Cause cause = ZCollectedHeap::heap()->gc_cause();
-  if (cause == GCCause::_wb_full_gc ||
-      cause == GCCause::_java_lang_system_gc ||
+  if (is_explicit_gc(cause) ||
       cause == GCCause::_metadata_GC_clear_soft_refs) {
     // Boost
     return true;
@@ -153,6 +254,9 @@ static bool should_boost_worker_threads() {
 
 class VM_ZMarkStart : public VM_ZOperation {
 public:
+  VM_ZMarkStart() :
+      VM_ZOperation(ZPhasePauseMarkStart) {}
+
   virtual VMOp_Type type() const {
     return VMOp_ZMarkStart;
   }
@@ -169,10 +273,19 @@ public:
     const bool clear = should_clear_soft_references();
     ZHeap::heap()->set_soft_reference_policy(clear);
 
+    // Set up number of worker threads, which can be changed at run time
+    const uint nparallel = (ZParallelGCThreads != 0) ? ZParallelGCThreads : ParallelGCThreads;
+    const uint nconcurrent_no_boost = (ZConcGCThreads != 0) ? ZConcGCThreads : ConcGCThreads;
+    ZHeap::heap()->set_nworker_threads(nparallel, nconcurrent_no_boost);
+
     // Set up boost mode
     const bool boost = should_boost_worker_threads();
     ZHeap::heap()->set_boost_worker_threads(boost);
 
+    // Set up number of concurrent worker threads
+    const uint nconcurrent = ZDirector::select_nconcurrent_workers();
+    ZHeap::heap()->set_nconcurrent_worker_threads(nconcurrent);
+
     ZCollectedHeap::heap()->increment_total_collections(true /* full */);
 
     ZHeap::heap()->mark_start();
@@ -182,6 +295,9 @@ public:
 
 class VM_ZMarkEnd : public VM_ZOperation {
 public:
+  VM_ZMarkEnd() :
+      VM_ZOperation(ZPhasePauseMarkEnd) {}
+
   virtual VMOp_Type type() const {
     return VMOp_ZMarkEnd;
   }
@@ -195,6 +311,9 @@ public:
 
 class VM_ZRelocateStart : public VM_ZOperation {
 public:
+  VM_ZRelocateStart() :
+      VM_ZOperation(ZPhasePauseRelocateStart) {}
+
   virtual VMOp_Type type() const {
     return VMOp_ZRelocateStart;
   }
@@ -224,15 +343,19 @@ public:
 
 ZDriver::ZDriver() :
     _gc_cycle_port(),
-    _gc_locker_port() {
+    _gc_locker_port(),
+    _phase_manager_stack(),
+    _gc_active(false) {
   set_name("ZDriver");
   create_and_start();
 }
 
 void ZDriver::collect(GCCause::Cause cause) {
+  // Don't let an optional remap delay the requested GC cycle
+  ZHeap::heap()->abort_remap();
+
   switch (cause) {
   case GCCause::_wb_young_gc:
-  case GCCause::_wb_conc_mark:
   case GCCause::_wb_full_gc:
   case GCCause::_dcmd_gc_run:
   case GCCause::_java_lang_system_gc:
@@ -250,8 +373,13 @@ void ZDriver::collect(GCCause::Cause cause) {
   case GCCause::_z_allocation_stall:
   case GCCause::_z_proactive:
   case GCCause::_z_high_usage:
+  case GCCause::_z_idle:
+  case GCCause::_z_metaspace:
   case GCCause::_metadata_GC_threshold:
-    // Start asynchronous GC
+  case GCCause::_wb_conc_mark:
+    // Start asynchronous GC. A GC started to reach a requested
+    // concurrent phase must not wait, since the requesting thread
+    // waits for the phase to be reached instead.
     _gc_cycle_port.send_async(cause);
     break;
 
@@ -267,6 +395,24 @@ void ZDriver::collect(GCCause::Cause cause) {
   }
 }
 
+bool ZDriver::request_concurrent_phase(const char* phase_name) {
+  const int phase = lookup_phase(phase_name);
+  if (phase < 0) {
+    // Unknown phase
+    return false;
+  }
+
+  while (!ConcurrentGCPhaseManager::wait_for_phase(phase, &_phase_manager_stack)) {
+    assert(phase != ZDriverPhase::ANY, "Wait for ANY phase must succeed");
+    if (phase != ZDriverPhase::IDLE && !Atomic::load(&_gc_active)) {
+      // Idle and the requested phase is not, start a GC cycle
+      collect(GCCause::_wb_conc_mark);
+    }
+  }
+
+  return true;
+}
+
 template <typename T>
 bool ZDriver::pause() {
   for (;;) {
@@ -326,9 +472,11 @@ void ZDriver::pause_verify() {
   }
 }
 
-void ZDriver::concurrent_select_relocation_set() {
+bool ZDriver::concurrent_select_relocation_set() {
   ZStatTimer timer(ZPhaseConcurrentSelectRelocationSet);
-  ZHeap::heap()->select_relocation_set();
+  const GCCause::Cause cause = ZCollectedHeap::heap()->gc_cause();
+  return ZHeap::heap()->select_relocation_set(should_compact_aggressively(cause),
+                                              should_skip_relocation(cause));
 }
 
 void ZDriver::pause_relocate_start() {
@@ -340,6 +488,24 @@ void ZDriver::concurrent_relocate() {
   ZHeap::heap()->relocate();
 }
 
+void ZDriver::concurrent_remap() {
+  if (!ZDirector::should_remap()) {
+    // Leave stale pointers to be remapped by the next mark
+    return;
+  }
+
+  const Ticks start = Ticks::now();
+
+  {
+    ZStatTimer timer(ZPhaseConcurrentRemap);
+    ZHeap::heap()->remap();
+  }
+
+  // Don't let the remap inflate the cycle duration used by the
+  // director, since it only runs when the next GC is far away
+  ZStatCycle::exclude_from_duration(Ticks::now() - start);
+}
+
 void ZDriver::check_out_of_memory() {
   ZHeap::heap()->check_out_of_memory();
 }
@@ -381,14 +547,19 @@ void ZDriver::gc(GCCause::Cause cause) {
   pause_mark_start();
 
   // Phase 2: Concurrent Mark
+  ConcurrentGCPhaseManager phase_manager(ZDriverPhase::CONCURRENT_MARK, &_phase_manager_stack);
   concurrent_mark();
 
   // Phase 3: Pause Mark End
+  phase_manager.wait_when_requested();
   while (!pause_mark_end()) {
     // Phase 3.5: Concurrent Mark Continue
     concurrent_mark_continue();
   }
 
+  phase_manager.set_phase(ZDriverPhase::MARK_COMPLETED, false /* force */);
+  phase_manager.wait_when_requested();
+
   // Phase 4: Concurrent Process Non-Strong References
   concurrent_process_non_strong_references();
 
@@ -399,16 +570,31 @@ void ZDriver::gc(GCCause::Cause cause) {
   pause_verify();
 
   // Phase 7: Concurrent Select Relocation Set
-  concurrent_select_relocation_set();
+  if (!concurrent_select_relocation_set()) {
+    // Relocation skipped
+    ZHeap::heap()->skip_relocation();
+    return;
+  }
 
   // Phase 8: Pause Relocate Start
+  phase_manager.set_phase(ZDriverPhase::BEFORE_RELOCATE_START, false /* force */);
+  phase_manager.wait_when_requested();
   pause_relocate_start();
 
   // Phase 9: Concurrent Relocate
+  phase_manager.set_phase(ZDriverPhase::CONCURRENT_RELOCATE, false /* force */);
   concurrent_relocate();
+
+  // Phase 10: Concurrent Remap (optional)
+  phase_manager.set_phase(ZDriverPhase::CONCURRENT_REMAP, false /* force */);
+  concurrent_remap();
 }
 
 void ZDriver::run_service() {
+  ZThreadPolicy::bind_current_thread();
+
+  ConcurrentGCPhaseManager phase_manager(ZDriverPhase::IDLE, &_phase_manager_stack);
+
   // Main loop
   while (!should_terminate()) {
     // Wait for GC request
@@ -417,15 +603,29 @@ void ZDriver::run_service() {
       continue;
     }
 
+    Atomic::store(&_gc_active, true);
+    phase_manager.set_phase(ZDriverPhase::CONCURRENT_CYCLE, false /* force */);
+
     // Run GC
     gc(cause);
 
+    if (ZExplicitGCUncommit && should_compact_aggressively(cause)) {
+      // Uncommit the freed memory without delay
+      ZCollectedHeap::heap()->request_uncommit();
+    }
+
     // Notify GC completed
     _gc_cycle_port.ack();
 
     // Check for out of memory condition
     check_out_of_memory();
+
+    phase_manager.set_phase(ZDriverPhase::IDLE, false /* force */);
+    Atomic::store(&_gc_active, false);
   }
+
+  // Don't block termination on a requested phase
+  phase_manager.deactivate();
 }
 
 void ZDriver::stop_service() {
@@ -24,6 +24,7 @@
 #ifndef SHARE_GC_Z_ZDRIVER_HPP
 #define SHARE_GC_Z_ZDRIVER_HPP
 
+#include "gc/shared/concurrentGCPhaseManager.hpp"
 #include "gc/shared/concurrentGCThread.hpp"
 #include "gc/shared/gcCause.hpp"
 #include "gc/z/zMessagePort.hpp"
@@ -32,8 +33,10 @@ class VM_ZOperation;
 
 class ZDriver : public ConcurrentGCThread {
 private:
-  ZMessagePort<GCCause::Cause> _gc_cycle_port;
-  ZRendezvousPort              _gc_locker_port;
+  ZMessagePort<GCCause::Cause>    _gc_cycle_port;
+  ZRendezvousPort                 _gc_locker_port;
+  ConcurrentGCPhaseManager::Stack _phase_manager_stack;
+  volatile bool                   _gc_active;
 
   template <typename T> bool pause();
 
@@ -44,9 +47,10 @@ private:
   void concurrent_process_non_strong_references();
   void concurrent_reset_relocation_set();
   void pause_verify();
-  void concurrent_select_relocation_set();
+  bool concurrent_select_relocation_set();
   void pause_relocate_start();
   void concurrent_relocate();
+  void concurrent_remap();
 
   void check_out_of_memory();
 
@@ -60,6 +64,8 @@ public:
   ZDriver();
 
   void collect(GCCause::Cause cause);
+
+  bool request_concurrent_phase(const char* phase);
 };
 
 #endif // SHARE_GC_Z_ZDRIVER_HPP
@@ -23,39 +23,138 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zForwarding.inline.hpp"
+#include "gc/z/zForwardingCompact.hpp"
+#include "gc/z/zForwardingSpace.hpp"
 #include "gc/z/zPage.inline.hpp"
 #include "memory/allocation.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/globals.hpp"
 #include "utilities/debug.hpp"
 #include "utilities/powerOfTwo.hpp"
 
-ZForwarding* ZForwarding::create(ZPage* page) {
-  // Allocate table for linear probing. The size of the table must be
-  // a power of two to allow for quick and inexpensive indexing/masking.
-  // The table is sized to have a load factor of 50%, i.e. sized to have
-  // double the number of entries actually inserted.
+static size_t table_nentries(const ZPage* page) {
+  // The size of the table must be a power of two to allow for quick and
+  // inexpensive indexing/masking. The table is sized to have a load factor
+  // of 50%, i.e. sized to have double the number of entries actually inserted.
   assert(page->live_objects() > 0, "Invalid value");
-  const size_t nentries = round_up_power_of_2(page->live_objects() * 2);
-  return ::new (AttachedArray::alloc(nentries)) ZForwarding(page, nentries);
+  return round_up_power_of_2(page->live_objects() * 2);
+}
+
+static bool should_use_compact(const ZPage* page) {
+  // Use a compact forwarding table if it's expected to be smaller
+  // than a regular table. This is the case for small pages with a
+  // large number of live objects.
+  return ZCompactForwarding &&
+         page->has_object_ends() &&
+         ZForwardingCompact::estimated_size(page) < table_nentries(page) * sizeof(ZForwardingEntry);
+}
+
+void* ZForwarding::alloc(size_t nentries) {
+  // Allocate from the forwarding space if possible, which is freed in
+  // bulk when the relocation set is reset
+  void* const placement = ZForwardingSpace::alloc(AttachedArray::size(nentries));
+  if (placement != NULL) {
+    return AttachedArray::alloc(placement, nentries);
+  }
+
+  return AttachedArray::alloc(nentries);
+}
+
+ZForwarding* ZForwarding::create(ZPage* page) {
+  if (should_use_compact(page)) {
+    // Allocate compact table, with no attached entries
+    ZForwardingCompact* const compact = new ZForwardingCompact(page);
+    return ::new (alloc(0)) ZForwarding(page, 0, compact);
+  }
+
+  return create_table(page);
+}
+
+ZForwarding* ZForwarding::create_table(ZPage* page) {
+  // Allocate table for linear probing
+  const size_t nentries = table_nentries(page);
+  return ::new (alloc(nentries)) ZForwarding(page, nentries, NULL);
 }
 
 void ZForwarding::destroy(ZForwarding* forwarding) {
-  AttachedArray::free(forwarding);
+  if (forwarding->_fallback != NULL) {
+    destroy(forwarding->_fallback);
+  }
+
+  if (forwarding->_compact != NULL) {
+    delete forwarding->_compact;
+  }
+
+  forwarding->~ZForwarding();
+
+  if (!ZForwardingSpace::is_in(forwarding)) {
+    AttachedArray::free(forwarding);
+  }
 }
 
-ZForwarding::ZForwarding(ZPage* page, size_t nentries) :
+ZForwarding::ZForwarding(ZPage* page, size_t nentries, ZForwardingCompact* compact) :
     _virtual(page->virtual_memory()),
     _object_alignment_shift(page->object_alignment_shift()),
+    _page_type(page->type()),
     _entries(nentries),
     _page(page),
     _refcount(1),
-    _pinned(false) {}
+    _refcount_lock(),
+    _pinned(false),
+    _in_place(false),
+    _segment_next(0),
+    _segment_completed(0),
+    _compact(compact),
+    _fallback(NULL) {}
+
+ZForwarding::~ZForwarding() {}
+
+ZForwarding* ZForwarding::fallback() {
+  // Objects that are not relocated into a block of a compact table are
+  // recorded in a regular forwarding table, which is allocated on first
+  // use. This only happens if a block allocation fails, or if the page
+  // is relocated in-place, and the page is then always retained or
+  // claimed by the calling thread.
+  assert(_compact != NULL, "Should be compact");
+
+  ZForwarding* const fallback = Atomic::load_acquire(&_fallback);
+  if (fallback != NULL) {
+    return fallback;
+  }
+
+  ZForwarding* const new_fallback = create_table(_page);
+  ZForwarding* const prev_fallback = Atomic::cmpxchg(&_fallback, (ZForwarding*)NULL, new_fallback);
+  if (prev_fallback != NULL) {
+    // Another thread installed a table first
+    destroy(new_fallback);
+    return prev_fallback;
+  }
+
+  return new_fallback;
+}
 
 void ZForwarding::verify() const {
-  guarantee(_refcount > 0, "Invalid refcount");
+  guarantee(_refcount != 0, "Invalid refcount");
   guarantee(_page != NULL, "Invalid page");
 
   size_t live_objects = 0;
 
+  if (_compact != NULL) {
+    live_objects += _compact->verify();
+    if (_fallback != NULL) {
+      live_objects += _fallback->verify_entries();
+    }
+  } else {
+    live_objects += verify_entries();
+  }
+
+  // Check number of relocated objects
+  guarantee(live_objects == _page->live_objects(), "Invalid number of entries");
+}
+
+size_t ZForwarding::verify_entries() const {
+  size_t live_objects = 0;
+
   for (ZForwardingCursor i = 0; i < _entries.length(); i++) {
     const ZForwardingEntry entry = at(&i);
     if (!entry.populated()) {
@@ -81,6 +180,5 @@ void ZForwarding::verify() const {
     live_objects++;
   }
 
-  // Check number of non-empty entries
-  guarantee(live_objects == _page->live_objects(), "Invalid number of entries");
+  return live_objects;
 }
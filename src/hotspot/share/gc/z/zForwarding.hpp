@@ -24,10 +24,13 @@
 #ifndef SHARE_GC_Z_ZFORWARDING_HPP
 #define SHARE_GC_Z_ZFORWARDING_HPP
 
+#include "gc/z/zArray.hpp"
 #include "gc/z/zAttachedArray.hpp"
 #include "gc/z/zForwardingEntry.hpp"
+#include "gc/z/zLock.hpp"
 #include "gc/z/zVirtualMemory.hpp"
 
+class ZForwardingCompact;
 class ZPage;
 
 typedef size_t ZForwardingCursor;
@@ -41,20 +44,35 @@ private:
 
   const ZVirtualMemory _virtual;
   const size_t         _object_alignment_shift;
+  const uint8_t        _page_type;
   const AttachedArray  _entries;
   ZPage*               _page;
-  volatile uint32_t    _refcount;
+  volatile int32_t     _refcount;
+  ZConditionLock       _refcount_lock;
   volatile bool        _pinned;
+  bool                 _in_place;
+  volatile uint32_t    _segment_next;
+  volatile uint32_t    _segment_completed;
+  ZForwardingCompact* const _compact;
+  ZForwarding* volatile     _fallback;
 
-  bool inc_refcount();
-  bool dec_refcount();
+  static void* alloc(size_t nentries);
+  static ZForwarding* create_table(ZPage* page);
+
+  void notify_refcount();
+
+  ZForwarding* fallback();
+  ZForwardingEntry find_compact(uintptr_t from_index, ZForwardingCursor* cursor) const;
+  size_t verify_entries() const;
 
   ZForwardingEntry* entries() const;
   ZForwardingEntry at(ZForwardingCursor* cursor) const;
   ZForwardingEntry first(uintptr_t from_index, ZForwardingCursor* cursor) const;
   ZForwardingEntry next(ZForwardingCursor* cursor) const;
+  ZForwardingEntry find_probe(uintptr_t from_index, ZForwardingCursor* cursor) const;
 
-  ZForwarding(ZPage* page, size_t nentries);
+  ZForwarding(ZPage* page, size_t nentries, ZForwardingCompact* compact);
+  ~ZForwarding();
 
 public:
   static ZForwarding* create(ZPage* page);
@@ -64,12 +82,23 @@ public:
   size_t size() const;
   size_t object_alignment_shift() const;
   ZPage* page() const;
+  bool is_large() const;
+
+  bool is_compact() const;
+  ZForwardingCompact* compact() const;
 
   bool is_pinned() const;
-  void set_pinned();
+  bool set_pinned();
+
+  bool is_in_place() const;
+  void set_in_place();
+
+  bool claim_segment(size_t* segment);
+  bool complete_segment();
 
   bool retain_page();
-  void release_page();
+  ZPage* claim_page();
+  void release_page(ZArray<ZPage*>* freed = NULL);
 
   ZForwardingEntry find(uintptr_t from_index) const;
   ZForwardingEntry find(uintptr_t from_index, ZForwardingCursor* cursor) const;
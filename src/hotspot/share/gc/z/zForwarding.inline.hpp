@@ -24,14 +24,20 @@
 #ifndef SHARE_GC_Z_ZFORWARDING_INLINE_HPP
 #define SHARE_GC_Z_ZFORWARDING_INLINE_HPP
 
+#include "gc/z/zArray.inline.hpp"
 #include "gc/z/zAttachedArray.inline.hpp"
 #include "gc/z/zForwarding.hpp"
+#include "gc/z/zForwardingCompact.inline.hpp"
 #include "gc/z/zGlobals.hpp"
 #include "gc/z/zHash.inline.hpp"
 #include "gc/z/zHeap.hpp"
+#include "gc/z/zLock.inline.hpp"
 #include "gc/z/zVirtualMemory.inline.hpp"
 #include "runtime/atomic.hpp"
+#include "utilities/align.hpp"
 #include "utilities/debug.hpp"
+#include "utilities/macros.hpp"
+#include CPU_HEADER_INLINE(gc/z/zForwarding)
 
 inline uintptr_t ZForwarding::start() const {
   return _virtual.start();
@@ -45,48 +51,168 @@ inline size_t ZForwarding::object_alignment_shift() const {
   return _object_alignment_shift;
 }
 
+inline bool ZForwarding::is_large() const {
+  return _page_type == ZPageTypeLarge;
+}
+
 inline ZPage* ZForwarding::page() const {
   return _page;
 }
 
+inline bool ZForwarding::is_compact() const {
+  return _compact != NULL;
+}
+
+inline ZForwardingCompact* ZForwarding::compact() const {
+  return _compact;
+}
+
 inline bool ZForwarding::is_pinned() const {
   return Atomic::load(&_pinned);
 }
 
-inline void ZForwarding::set_pinned() {
-  Atomic::store(&_pinned, true);
+inline bool ZForwarding::set_pinned() {
+  // Returns true if this call pinned the page
+  return !is_pinned() && !Atomic::cmpxchg(&_pinned, false, true);
 }
 
-inline bool ZForwarding::inc_refcount() {
-  uint32_t refcount = Atomic::load(&_refcount);
+inline bool ZForwarding::is_in_place() const {
+  return _in_place;
+}
 
-  while (refcount > 0) {
-    const uint32_t old_refcount = refcount;
-    const uint32_t new_refcount = old_refcount + 1;
-    const uint32_t prev_refcount = Atomic::cmpxchg(&_refcount, old_refcount, new_refcount);
-    if (prev_refcount == old_refcount) {
-      return true;
-    }
+inline void ZForwarding::set_in_place() {
+  _in_place = true;
+}
 
-    refcount = prev_refcount;
+inline bool ZForwarding::claim_segment(size_t* segment) {
+  if (Atomic::load(&_segment_next) >= ZLiveMap::nsegments) {
+    // All segments claimed
+    return false;
   }
 
-  return false;
+  const uint32_t next = Atomic::add(&_segment_next, 1u) - 1u;
+  if (next >= ZLiveMap::nsegments) {
+    // All segments claimed
+    return false;
+  }
+
+  *segment = next;
+  return true;
 }
 
-inline bool ZForwarding::dec_refcount() {
-  assert(_refcount > 0, "Invalid state");
-  return Atomic::sub(&_refcount, 1u) == 0u;
+inline bool ZForwarding::complete_segment() {
+  // Returns true if this was the last segment to be completed
+  return Atomic::add(&_segment_completed, 1u) == ZLiveMap::nsegments;
 }
 
+//
+// The page reference count has the following states:
+//
+//   > 0 : Page is retained. The relocation set holds one reference, and each
+//         thread currently relocating objects on the page holds one reference.
+//   = 0 : Page is released. All live objects on the page have been relocated.
+//   < 0 : Page is claimed for in-place relocation. The count is the negated
+//         number of references, and reaches -1 when the claiming thread holds
+//         the only remaining reference.
+//
+
 inline bool ZForwarding::retain_page() {
-  return inc_refcount();
+  for (;;) {
+    const int32_t refcount = Atomic::load_acquire(&_refcount);
+
+    if (refcount == 0) {
+      // Released
+      return false;
+    }
+
+    if (refcount < 0) {
+      // Claimed, wait for in-place relocation to complete
+      ZLocker<ZConditionLock> locker(&_refcount_lock);
+      while (Atomic::load_acquire(&_refcount) < 0) {
+        _refcount_lock.wait();
+      }
+
+      continue;
+    }
+
+    if (Atomic::cmpxchg(&_refcount, refcount, refcount + 1) == refcount) {
+      // Retained
+      return true;
+    }
+  }
+}
+
+inline ZPage* ZForwarding::claim_page() {
+  for (;;) {
+    const int32_t refcount = Atomic::load(&_refcount);
+    assert(refcount > 0, "Invalid state");
+
+    // Invert reference count
+    if (Atomic::cmpxchg(&_refcount, refcount, -refcount) != refcount) {
+      continue;
+    }
+
+    // If the previous reference count was 1, then we just inverted it to -1
+    // and are the only holder. Otherwise, wait for the other holders to
+    // release their references.
+    if (refcount != 1) {
+      ZLocker<ZConditionLock> locker(&_refcount_lock);
+      while (Atomic::load_acquire(&_refcount) != -1) {
+        _refcount_lock.wait();
+      }
+    }
+
+    return _page;
+  }
+}
+
+inline void ZForwarding::notify_refcount() {
+  ZLocker<ZConditionLock> locker(&_refcount_lock);
+  _refcount_lock.notify_all();
 }
 
-inline void ZForwarding::release_page() {
-  if (dec_refcount()) {
-    ZHeap::heap()->free_page(_page, true /* reclaimed */);
-    _page = NULL;
+inline void ZForwarding::release_page(ZArray<ZPage*>* freed) {
+  for (;;) {
+    const int32_t refcount = Atomic::load(&_refcount);
+    assert(refcount != 0, "Invalid state");
+
+    if (refcount > 0) {
+      // Decrement reference count
+      if (Atomic::cmpxchg(&_refcount, refcount, refcount - 1) != refcount) {
+        continue;
+      }
+
+      if (refcount == 1) {
+        // Last reference released, free page. A large page is only
+        // released this way after having been remapped, in which case
+        // its physical memory is still in use at the new address. If
+        // the caller collects freed pages, they are freed in a batch
+        // by the caller instead.
+        if (is_large()) {
+          ZHeap::heap()->free_remapped_page(_page);
+        } else if (freed != NULL) {
+          freed->add(_page);
+        } else {
+          ZHeap::heap()->free_page(_page, true /* reclaimed */);
+        }
+        _page = NULL;
+      }
+    } else {
+      // Increment reference count
+      if (Atomic::cmpxchg(&_refcount, refcount, refcount + 1) != refcount) {
+        continue;
+      }
+
+      // If the previous reference count was -2 or -1, then it is now -1 or 0,
+      // and the claiming thread, or the threads waiting for the in-place
+      // relocation to complete, must be notified. An in-place relocated page
+      // still holds live objects and is never freed.
+      if (refcount == -2 || refcount == -1) {
+        notify_refcount();
+      }
+    }
+
+    return;
   }
 }
 
@@ -116,7 +242,80 @@ inline ZForwardingEntry ZForwarding::find(uintptr_t from_index) const {
   return find(from_index, &dummy);
 }
 
+inline ZForwardingEntry ZForwarding::find_compact(uintptr_t from_index, ZForwardingCursor* cursor) const {
+  if (_compact->is_relocated(from_index)) {
+    // Relocated into a block, return computed entry
+    return ZForwardingEntry(from_index, _compact->to_offset(from_index));
+  }
+
+  const ZForwarding* const fallback = Atomic::load_acquire(&_fallback);
+  if (fallback != NULL) {
+    // Lookup in fallback table
+    return fallback->find(from_index, cursor);
+  }
+
+  // Match not found, return empty entry
+  return ZForwardingEntry();
+}
+
+inline ZForwardingEntry ZForwarding::find_probe(uintptr_t from_index, ZForwardingCursor* cursor) const {
+  // Probing starts at the same entry, and visits the entries in the same
+  // order, as the linear probing in find(). Entries are always inserted at
+  // the first empty entry in probe order, so the first entry that is either
+  // empty or matching ends the probing. The entries up to the first group
+  // boundary are compared one at a time, and then a group of entries, one
+  // cache line, in each step.
+  const size_t mask = _entries.length() - 1;
+  const uint64_t probe_key = ZForwardingEntry::probe_key(from_index);
+  const uint64_t probe_mask = ZForwardingEntry::probe_mask();
+  const volatile uint64_t* const raw_entries = (const volatile uint64_t*)entries();
+  size_t index = ZHash::uint32_to_uint32((uint32_t)from_index) & mask;
+
+  for (; !is_aligned(index, ZForwardingProbeLength); index++) {
+    const uint64_t entry = Atomic::load(raw_entries + index);
+    if (entry == 0 || (entry & probe_mask) == probe_key) {
+      break;
+    }
+  }
+
+  if (is_aligned(index, ZForwardingProbeLength)) {
+    for (index &= mask;; index = (index + ZForwardingProbeLength) & mask) {
+      const size_t group_index = ZPlatformForwardingProbe(raw_entries + index, probe_key, probe_mask);
+      if (group_index < ZForwardingProbeLength) {
+        index += group_index;
+        break;
+      }
+    }
+  }
+
+  *cursor = index;
+
+  // The entry is read again, since it might have been populated after it
+  // was compared. If populated with a different object, then the probing
+  // continues one entry at a time.
+  ZForwardingEntry entry = at(cursor);
+  while (entry.populated()) {
+    if (entry.from_index() == from_index) {
+      // Match found, return matching entry
+      return entry;
+    }
+
+    entry = next(cursor);
+  }
+
+  // Match not found, return empty entry
+  return entry;
+}
+
 inline ZForwardingEntry ZForwarding::find(uintptr_t from_index, ZForwardingCursor* cursor) const {
+  if (_compact != NULL) {
+    return find_compact(from_index, cursor);
+  }
+
+  if (_entries.length() >= ZForwardingProbeLength) {
+    return find_probe(from_index, cursor);
+  }
+
   // Reading entries in the table races with the atomic CAS done for
   // insertion into the table. This is safe because each entry is at
   // most updated once (from zero to something else).
@@ -135,6 +334,14 @@ inline ZForwardingEntry ZForwarding::find(uintptr_t from_index, ZForwardingCurso
 }
 
 inline uintptr_t ZForwarding::insert(uintptr_t from_index, uintptr_t to_offset, ZForwardingCursor* cursor) {
+  if (_compact != NULL) {
+    // Insert into fallback table. The cursor is looked up again, since
+    // the table might have been allocated after the cursor was returned.
+    ZForwarding* const fallback = this->fallback();
+    fallback->find(from_index, cursor);
+    return fallback->insert(from_index, to_offset, cursor);
+  }
+
   const ZForwardingEntry new_entry(from_index, to_offset);
   const ZForwardingEntry old_entry; // Empty
 
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZFORWARDINGCACHE_HPP
+#define SHARE_GC_Z_ZFORWARDINGCACHE_HPP
+
+#include "memory/allocation.hpp"
+
+class ZForwarding;
+
+//
+// Per-thread cache of the most recently used forwardings, used by the
+// relocate barrier slow path to avoid the forwarding table lookup when
+// the same pages are hit repeatedly. The cache is only filled during
+// the relocate phase, and is implicitly invalidated when the next GC
+// cycle starts, since forwardings are not deleted before then.
+//
+class ZForwardingCache {
+private:
+  static const size_t nentries = 2;
+
+  uint32_t     _seqnum;
+  size_t       _next;
+  ZForwarding* _entries[nentries];
+
+public:
+  ZForwardingCache();
+
+  ZForwarding* get(uintptr_t offset) const;
+  void put(ZForwarding* forwarding);
+};
+
+#endif // SHARE_GC_Z_ZFORWARDINGCACHE_HPP
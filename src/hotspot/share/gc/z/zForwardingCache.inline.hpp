@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZFORWARDINGCACHE_INLINE_HPP
+#define SHARE_GC_Z_ZFORWARDINGCACHE_INLINE_HPP
+
+#include "gc/z/zForwarding.inline.hpp"
+#include "gc/z/zForwardingCache.hpp"
+#include "gc/z/zGlobals.hpp"
+
+inline ZForwarding* ZForwardingCache::get(uintptr_t offset) const {
+  if (_seqnum != ZGlobalSeqNum) {
+    // Filled in a previous GC cycle
+    return NULL;
+  }
+
+  for (size_t i = 0; i < nentries; i++) {
+    ZForwarding* const forwarding = _entries[i];
+    if (forwarding != NULL && offset - forwarding->start() < forwarding->size()) {
+      return forwarding;
+    }
+  }
+
+  // Not found
+  return NULL;
+}
+
+inline void ZForwardingCache::put(ZForwarding* forwarding) {
+  if (_seqnum != ZGlobalSeqNum) {
+    // Discard entries from a previous GC cycle
+    for (size_t i = 0; i < nentries; i++) {
+      _entries[i] = NULL;
+    }
+    _seqnum = ZGlobalSeqNum;
+  }
+
+  _entries[_next] = forwarding;
+  _next = (_next + 1) % nentries;
+}
+
+#endif // SHARE_GC_Z_ZFORWARDINGCACHE_INLINE_HPP
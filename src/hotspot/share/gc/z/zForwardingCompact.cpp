@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zAddress.inline.hpp"
+#include "gc/z/zForwardingCompact.inline.hpp"
+#include "gc/z/zForwardingSpace.inline.hpp"
+#include "gc/z/zGlobals.hpp"
+#include "gc/z/zOop.inline.hpp"
+#include "gc/z/zPage.inline.hpp"
+#include "memory/allocation.hpp"
+#include "memory/iterator.hpp"
+#include "utilities/align.hpp"
+#include "utilities/debug.hpp"
+#include "utilities/powerOfTwo.hpp"
+
+class ZForwardingCompactRegisterClosure : public ObjectClosure {
+private:
+  ZForwardingCompact* const _compact;
+  const ZPage* const        _page;
+
+public:
+  ZForwardingCompactRegisterClosure(ZForwardingCompact* compact, const ZPage* page) :
+      _compact(compact),
+      _page(page) {}
+
+  virtual void do_object(oop o) {
+    // The object size is looked up in the live map, the object
+    // itself is never touched.
+    const uintptr_t addr = ZOop::to_address(o);
+    const uintptr_t from_index = (ZAddress::offset(addr) - _page->start()) >> _page->object_alignment_shift();
+    const size_t nunits = _page->live_object_size(addr) >> _page->object_alignment_shift();
+    _compact->register_object(from_index, nunits);
+  }
+};
+
+size_t ZForwardingCompact::ncovered_words(const ZPage* page) {
+  return align_up(page->object_max_count(), BitsPerWord) / BitsPerWord;
+}
+
+size_t ZForwardingCompact::nrank_blocks(size_t ncovered_words) {
+  return align_up(ncovered_words, (size_t)1 << rank_block_shift) >> rank_block_shift;
+}
+
+size_t ZForwardingCompact::nstate_words(size_t nlive_units) {
+  return align_up(nlive_units, BitsPerWord) / BitsPerWord;
+}
+
+size_t ZForwardingCompact::estimated_size(const ZPage* page) {
+  const size_t nwords = ncovered_words(page);
+  const size_t nlive_units = page->live_bytes() >> page->object_alignment_shift();
+  return sizeof(ZForwardingCompact) +
+         nwords * sizeof(uint64_t) +
+         nrank_blocks(nwords) * sizeof(uint32_t) +
+         nstate_words(nlive_units) * sizeof(uint64_t);
+}
+
+void* ZForwardingCompact::operator new(size_t size) {
+  return ZForwardingSpace::alloc_heap(size);
+}
+
+void ZForwardingCompact::operator delete(void* addr) {
+  ZForwardingSpace::free_heap(addr);
+}
+
+ZForwardingCompact::ZForwardingCompact(ZPage* page) :
+    _object_alignment_shift(page->object_alignment_shift()),
+    _segment_shift(log2_intptr(page->object_max_count() / ZLiveMap::nsegments)),
+    _ncovered_words(ncovered_words(page)),
+    _covered(ZForwardingSpace::alloc_array<uint64_t>(_ncovered_words)),
+    _ranks(ZForwardingSpace::alloc_array<uint32_t>(nrank_blocks(_ncovered_words))),
+    _nlive_units(0),
+    _states(NULL) {
+  assert(page->has_object_ends(), "Invalid page");
+
+  memset(_covered, 0, _ncovered_words * sizeof(uint64_t));
+  memset(_segment_rank, 0, sizeof(_segment_rank));
+  memset(_segment_units, 0, sizeof(_segment_units));
+
+  // Register live objects
+  ZForwardingCompactRegisterClosure cl(this, page);
+  page->object_iterate(&cl);
+  assert(_nlive_units == page->live_bytes() >> _object_alignment_shift, "Invalid live units");
+
+  // Precompute ranks
+  uint32_t rank = 0;
+  for (size_t i = 0; i < _ncovered_words; i++) {
+    if ((i & (((size_t)1 << rank_block_shift) - 1)) == 0) {
+      _ranks[i >> rank_block_shift] = rank;
+    }
+
+    rank += population_count(_covered[i]);
+  }
+
+  // Allocate state bits
+  const size_t nwords = nstate_words(_nlive_units);
+  uint64_t* const states = ZForwardingSpace::alloc_array<uint64_t>(nwords);
+  memset(states, 0, nwords * sizeof(uint64_t));
+  _states = states;
+
+  // Setup blocks. Blocks are allocated as small objects. A segment with
+  // more live bytes than that, which can only happen if a large object
+  // starts in it, relocates its objects individually.
+  for (size_t i = 0; i < ZLiveMap::nsegments; i++) {
+    _segment_block[i] = (block_size(i) <= ZObjectSizeLimitSmall) ? block_unassigned : block_failed;
+  }
+}
+
+ZForwardingCompact::~ZForwardingCompact() {
+  ZForwardingSpace::free_array(_covered);
+  ZForwardingSpace::free_array(_ranks);
+  ZForwardingSpace::free_array((uint64_t*)_states);
+}
+
+void ZForwardingCompact::register_object(uintptr_t from_index, size_t nunits) {
+  assert(nunits >= 2, "Invalid size");
+
+  // Objects are registered in address order. The first object
+  // starting in a segment determines the rank of the segment.
+  const size_t segment = this->segment(from_index);
+  if (_segment_units[segment] == 0) {
+    _segment_rank[segment] = (uint32_t)_nlive_units;
+  }
+
+  _segment_units[segment] += (uint32_t)nunits;
+  _nlive_units += nunits;
+
+  // Set covered bits
+  const uintptr_t end_index = from_index + nunits;
+  for (uintptr_t index = from_index; index < end_index;) {
+    const size_t bit = index & (BitsPerWord - 1);
+    const size_t nbits = MIN2((size_t)(end_index - index), BitsPerWord - bit);
+    const uint64_t mask = (nbits == BitsPerWord) ? ~(uint64_t)0 : (((uint64_t)1 << nbits) - 1) << bit;
+    _covered[index >> LogBitsPerWord] |= mask;
+    index += nbits;
+  }
+}
+
+size_t ZForwardingCompact::verify() const {
+  // Returns the number of objects relocated into blocks. Every claimed
+  // object must also have been relocated, i.e. have both state bits set.
+  size_t nbits = 0;
+
+  for (size_t i = 0; i < nstate_words(_nlive_units); i++) {
+    nbits += population_count((uint64_t)_states[i]);
+  }
+
+  guarantee((nbits & 1) == 0, "Object claimed but not relocated");
+  return nbits / 2;
+}
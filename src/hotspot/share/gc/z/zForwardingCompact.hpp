@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZFORWARDINGCOMPACT_HPP
+#define SHARE_GC_Z_ZFORWARDINGCOMPACT_HPP
+
+#include "gc/z/zLiveMap.hpp"
+#include "memory/allocation.hpp"
+
+class ZPage;
+
+//
+// A compact forwarding table is used for densely populated small pages,
+// where a regular forwarding table, with one entry per live object and a
+// load factor of 50%, would need more memory. Instead of recording the new
+// address of each object, the live objects starting in a live map segment
+// are relocated contiguously, in address order, into a single block that
+// is allocated for the segment. The new address of an object is then the
+// start of its block, plus the number of live bytes between the first
+// object in the segment and the object itself.
+//
+// The live bytes are counted (ranked) using a bitmap with one bit per
+// alignment unit covered by a live object, together with a table of
+// precomputed counts for every four bitmap words. Unlike the live map of
+// the page, the bitmap is kept until the forwarding table is destroyed.
+//
+// Since the new address of an object is known in advance, each object must
+// be copied by exactly one thread. A thread claims an object by setting its
+// claimed state bit, and publishes the copy by setting its relocated state
+// bit. Threads losing the claim wait for the copy to be published.
+//
+// If the block for a segment can't be allocated, the segment is marked as
+// failed, and its objects are relocated individually and recorded in a
+// regular forwarding table instead.
+//
+
+class ZForwardingCompact {
+  friend class ZForwardingTest;
+
+public:
+  static const uintptr_t block_unassigned = (uintptr_t)-1;
+  static const uintptr_t block_failed     = (uintptr_t)-2;
+
+private:
+  static const size_t rank_block_shift = 2;
+
+  const size_t       _object_alignment_shift;
+  const size_t       _segment_shift;
+  const size_t       _ncovered_words;
+  uint64_t* const    _covered;
+  uint32_t* const    _ranks;
+  size_t             _nlive_units;
+  volatile uint64_t* _states;
+  uint32_t           _segment_rank[ZLiveMap::nsegments];
+  uint32_t           _segment_units[ZLiveMap::nsegments];
+  volatile uintptr_t _segment_block[ZLiveMap::nsegments];
+
+  static size_t ncovered_words(const ZPage* page);
+  static size_t nrank_blocks(size_t ncovered_words);
+  static size_t nstate_words(size_t nlive_units);
+
+  size_t rank(uintptr_t from_index) const;
+
+  bool par_set_state(size_t bit);
+  bool get_state(size_t bit) const;
+
+public:
+  static size_t estimated_size(const ZPage* page);
+
+  void* operator new(size_t size);
+  void operator delete(void* addr);
+
+  ZForwardingCompact(ZPage* page);
+  ~ZForwardingCompact();
+
+  void register_object(uintptr_t from_index, size_t nunits);
+
+  size_t segment(uintptr_t from_index) const;
+  size_t block_size(size_t segment) const;
+  uintptr_t block(size_t segment) const;
+  uintptr_t install_block(size_t segment, uintptr_t block);
+
+  uintptr_t to_offset(uintptr_t from_index) const;
+
+  bool claim(uintptr_t from_index);
+  bool is_relocated(uintptr_t from_index) const;
+  void set_relocated(uintptr_t from_index);
+  void wait_relocated(uintptr_t from_index) const;
+
+  size_t verify() const;
+};
+
+#endif // SHARE_GC_Z_ZFORWARDINGCOMPACT_HPP
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZFORWARDINGCOMPACT_INLINE_HPP
+#define SHARE_GC_Z_ZFORWARDINGCOMPACT_INLINE_HPP
+
+#include "gc/z/zForwardingCompact.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
+#include "utilities/debug.hpp"
+#include "utilities/globalDefinitions.hpp"
+#include "utilities/population_count.hpp"
+
+inline size_t ZForwardingCompact::rank(uintptr_t from_index) const {
+  // Number of alignment units covered by live objects below from_index
+  const size_t word = from_index >> LogBitsPerWord;
+  const size_t rank_block = word >> rank_block_shift;
+  size_t rank = _ranks[rank_block];
+
+  for (size_t i = rank_block << rank_block_shift; i < word; i++) {
+    rank += population_count(_covered[i]);
+  }
+
+  const uint64_t mask = ((uint64_t)1 << (from_index & (BitsPerWord - 1))) - 1;
+  return rank + population_count(_covered[word] & mask);
+}
+
+inline bool ZForwardingCompact::par_set_state(size_t bit) {
+  volatile uint64_t* const addr = _states + (bit >> LogBitsPerWord);
+  const uint64_t mask = (uint64_t)1 << (bit & (BitsPerWord - 1));
+  uint64_t old_val = Atomic::load(addr);
+
+  for (;;) {
+    if ((old_val & mask) != 0) {
+      // Already set
+      return false;
+    }
+
+    const uint64_t new_val = old_val | mask;
+    const uint64_t prev_val = Atomic::cmpxchg(addr, old_val, new_val);
+    if (prev_val == old_val) {
+      // Success
+      return true;
+    }
+
+    // Retry
+    old_val = prev_val;
+  }
+}
+
+inline bool ZForwardingCompact::get_state(size_t bit) const {
+  const uint64_t mask = (uint64_t)1 << (bit & (BitsPerWord - 1));
+  return (Atomic::load_acquire(_states + (bit >> LogBitsPerWord)) & mask) != 0;
+}
+
+inline size_t ZForwardingCompact::segment(uintptr_t from_index) const {
+  return from_index >> _segment_shift;
+}
+
+inline size_t ZForwardingCompact::block_size(size_t segment) const {
+  return (size_t)_segment_units[segment] << _object_alignment_shift;
+}
+
+inline uintptr_t ZForwardingCompact::block(size_t segment) const {
+  return Atomic::load_acquire(_segment_block + segment);
+}
+
+inline uintptr_t ZForwardingCompact::install_block(size_t segment, uintptr_t block) {
+  // Returns the installed block, which is either the given
+  // block or a block already installed by another thread.
+  const uintptr_t prev_block = Atomic::cmpxchg(_segment_block + segment, block_unassigned, block);
+  return (prev_block == block_unassigned) ? block : prev_block;
+}
+
+inline uintptr_t ZForwardingCompact::to_offset(uintptr_t from_index) const {
+  const size_t segment = this->segment(from_index);
+  const uintptr_t block = this->block(segment);
+  assert(block != block_unassigned && block != block_failed, "Invalid block");
+
+  return block + ((rank(from_index) - _segment_rank[segment]) << _object_alignment_shift);
+}
+
+//
+// Each live object has two state bits, indexed by the rank of the object.
+// Since every live object covers at least two alignment units, the ranks of
+// two objects are always at least two apart.
+//
+//   Bit 0: Claimed, the object is being copied by a thread
+//   Bit 1: Relocated, the object has been copied
+//
+
+inline bool ZForwardingCompact::claim(uintptr_t from_index) {
+  return par_set_state(rank(from_index));
+}
+
+inline bool ZForwardingCompact::is_relocated(uintptr_t from_index) const {
+  const uintptr_t block = this->block(segment(from_index));
+  if (block == block_unassigned || block == block_failed) {
+    // Block not installed
+    return false;
+  }
+
+  return get_state(rank(from_index) + 1);
+}
+
+inline void ZForwardingCompact::set_relocated(uintptr_t from_index) {
+  // Publish the copy of the object
+  const bool success = par_set_state(rank(from_index) + 1);
+  assert(success, "Should always succeed");
+}
+
+inline void ZForwardingCompact::wait_relocated(uintptr_t from_index) const {
+  const size_t bit = rank(from_index) + 1;
+  while (!get_state(bit)) {
+    SpinPause();
+  }
+}
+
+#endif // SHARE_GC_Z_ZFORWARDINGCOMPACT_INLINE_HPP
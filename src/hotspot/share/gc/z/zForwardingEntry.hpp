@@ -75,6 +75,20 @@ public:
   size_t from_index() const {
     return field_from_index::decode(_entry);
   }
+
+  // An entry matches an object index if the entry masked with the
+  // probe mask equals the probe key for that index
+  static uint64_t probe_key(size_t from_index) {
+    return field_populated::encode(true) |
+           field_from_index::encode(from_index);
+  }
+
+  static uint64_t probe_mask() {
+    // Decoding a container with all bits set yields the largest index
+    // the field can hold, i.e. all bits of the field set
+    return field_populated::encode(true) |
+           field_from_index::encode(field_from_index::decode((uint64_t)-1));
+  }
 };
 
 // Needed to allow atomic operations on ZForwardingEntry
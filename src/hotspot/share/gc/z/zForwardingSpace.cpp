@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zForwardingSpace.hpp"
+#include "gc/z/zGlobals.hpp"
+#include "gc/z/zLargePages.inline.hpp"
+#include "gc/z/zLock.inline.hpp"
+#include "logging/log.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/os.hpp"
+#include "utilities/align.hpp"
+#include "utilities/debug.hpp"
+
+ZForwardingSpace* ZForwardingSpace::_space;
+
+size_t ZForwardingSpace::alignment() {
+  // Forwarding tables are accessed randomly, so use huge pages if possible
+  return ZLargePages::is_enabled_for_metadata() ? os::large_page_size() : ZGranuleSize;
+}
+
+void ZForwardingSpace::initialize() {
+  // Reserve address space. The forwarding tables of a relocation set
+  // are normally much smaller than the heap, and allocations that
+  // don't fit are made in the C heap.
+  const size_t size = align_up(MaxHeapSize, alignment());
+  const uintptr_t addr = (uintptr_t)os::reserve_memory(size, NULL, alignment(), mtGC);
+  if (addr == 0) {
+    log_info(gc, init)("Forwarding Space: Disabled (Failed to reserve address space)");
+    return;
+  }
+
+  _space = new ZForwardingSpace(addr, size);
+
+  log_info(gc, init)("Forwarding Space: " SIZE_FORMAT "M%s", size / M,
+                     ZLargePages::is_enabled_for_metadata() ? " (Large Pages)" : "");
+}
+
+ZForwardingSpace::ZForwardingSpace(uintptr_t start, size_t size) :
+    _expand_lock(),
+    _start(start),
+    _limit(start + size),
+    _top(start),
+    _end(start),
+    _retain(0) {}
+
+uintptr_t ZForwardingSpace::alloc_space(size_t size) {
+  uintptr_t top = Atomic::load(&_top);
+
+  for (;;) {
+    const uintptr_t end = Atomic::load(&_end);
+    const uintptr_t new_top = top + size;
+    if (new_top > end) {
+      // Not enough space left
+      return 0;
+    }
+
+    const uintptr_t prev_top = Atomic::cmpxchg(&_top, top, new_top);
+    if (prev_top == top) {
+      // Success
+      return top;
+    }
+
+    // Retry
+    top = prev_top;
+  }
+}
+
+uintptr_t ZForwardingSpace::expand_and_alloc_space(size_t size) {
+  ZLocker<ZLock> locker(&_expand_lock);
+
+  // Retry allocation before expanding
+  uintptr_t addr = alloc_space(size);
+  if (addr != 0) {
+    return addr;
+  }
+
+  // Check expansion limit
+  const size_t expand_size = align_up(size, alignment());
+  if (_end + expand_size > _limit) {
+    // Exhausted
+    return 0;
+  }
+
+  // Expand. The alignment hint makes the commit advise the kernel to use
+  // transparent huge pages, which is only wanted when enabled for metadata.
+  const size_t alignment_hint = ZLargePages::is_enabled_for_metadata() ? os::large_page_size() : os::vm_page_size();
+  if (!os::commit_memory((char*)_end, expand_size, alignment_hint, false /* executable */)) {
+    // Out of memory
+    return 0;
+  }
+
+  // Increment top before end to make sure another
+  // thread can't steal our newly expanded space.
+  addr = Atomic::add(&_top, size) - size;
+  Atomic::add(&_end, expand_size);
+
+  return addr;
+}
+
+void ZForwardingSpace::reset_space() {
+  ZLocker<ZLock> locker(&_expand_lock);
+
+  // Keep the memory used by the last two relocation sets committed,
+  // since it's likely to be needed again by the next relocation set
+  const size_t used = _top - _start;
+  const size_t retain_size = align_up(MAX2(used, _retain), alignment());
+  const size_t committed = _end - _start;
+  _retain = used;
+
+  if (committed > retain_size) {
+    log_debug(gc, reloc)("Shrinking forwarding space: " SIZE_FORMAT "M->" SIZE_FORMAT "M",
+                         committed / M, retain_size / M);
+
+    if (os::uncommit_memory((char*)(_start + retain_size), committed - retain_size)) {
+      Atomic::store(&_end, _start + retain_size);
+    } else {
+      log_error(gc, reloc)("Failed to uncommit forwarding space");
+    }
+  }
+
+  // Make all space available again
+  Atomic::store(&_top, _start);
+}
+
+void* ZForwardingSpace::alloc(size_t size) {
+  if (_space == NULL) {
+    // Not initialized
+    return NULL;
+  }
+
+  const size_t aligned_size = align_up(size, BytesPerLong);
+  uintptr_t addr = _space->alloc_space(aligned_size);
+  if (addr == 0) {
+    addr = _space->expand_and_alloc_space(aligned_size);
+  }
+
+  return (void*)addr;
+}
+
+bool ZForwardingSpace::is_in(const void* addr) {
+  return _space != NULL && (uintptr_t)addr >= _space->_start && (uintptr_t)addr < _space->_limit;
+}
+
+void* ZForwardingSpace::alloc_heap(size_t size) {
+  void* const addr = alloc(size);
+  if (addr != NULL) {
+    return addr;
+  }
+
+  return AllocateHeap(size, mtGC);
+}
+
+void ZForwardingSpace::free_heap(void* addr) {
+  if (!is_in(addr)) {
+    FreeHeap(addr);
+  }
+}
+
+void ZForwardingSpace::reset() {
+  if (_space != NULL) {
+    _space->reset_space();
+  }
+}
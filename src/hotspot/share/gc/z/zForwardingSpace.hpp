@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZFORWARDINGSPACE_HPP
+#define SHARE_GC_Z_ZFORWARDINGSPACE_HPP
+
+#include "gc/z/zLock.hpp"
+#include "memory/allocation.hpp"
+
+// Space for forwardings, their entries and compact tables, which is bump
+// pointer allocated while the relocation set is populated and relocated,
+// and freed in bulk when the relocation set is reset. Allocations fall back
+// to the C heap if the space couldn't be reserved, or is exhausted. The
+// space is reserved and committed as mtGC, to keep NMT accounting intact.
+class ZForwardingSpace : public CHeapObj<mtGC> {
+private:
+  static ZForwardingSpace* _space;
+
+  ZLock              _expand_lock;
+  const uintptr_t    _start;
+  const uintptr_t    _limit;
+  volatile uintptr_t _top;
+  volatile uintptr_t _end;
+  size_t             _retain;
+
+  static size_t alignment();
+
+  ZForwardingSpace(uintptr_t start, size_t size);
+
+  uintptr_t alloc_space(size_t size);
+  uintptr_t expand_and_alloc_space(size_t size);
+  void reset_space();
+
+public:
+  static void initialize();
+
+  static void* alloc(size_t size);
+  static bool is_in(const void* addr);
+  static void reset();
+
+  static void* alloc_heap(size_t size);
+  static void free_heap(void* addr);
+
+  template <typename T> static T* alloc_array(size_t length);
+  template <typename T> static void free_array(T* array);
+};
+
+#endif // SHARE_GC_Z_ZFORWARDINGSPACE_HPP
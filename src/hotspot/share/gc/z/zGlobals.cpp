@@ -30,6 +30,7 @@ uint32_t   ZGlobalSeqNum               = 1;
 size_t     ZPageSizeMediumShift;
 size_t     ZPageSizeMedium;
 
+size_t     ZObjectSizeLimitSmall       = ZPageSizeSmall / 8; // 12.5% max waste
 size_t     ZObjectSizeLimitMedium;
 
 const int& ZObjectAlignmentSmallShift  = LogMinObjAlignmentInBytes;
@@ -55,6 +55,9 @@ const uint8_t     ZPageTypeSmall                = 0;
 const uint8_t     ZPageTypeMedium               = 1;
 const uint8_t     ZPageTypeLarge                = 2;
 
+// Page hotness, not yet sampled
+const uint8_t     ZPageHotnessUnknown           = UINT8_MAX;
+
 // Page size shifts
 const size_t      ZPageSizeSmallShift           = ZGranuleSizeShift;
 extern size_t     ZPageSizeMediumShift;
@@ -64,7 +67,7 @@ const size_t      ZPageSizeSmall                = (size_t)1 << ZPageSizeSmallShi
 extern size_t     ZPageSizeMedium;
 
 // Object size limits
-const size_t      ZObjectSizeLimitSmall         = ZPageSizeSmall / 8; // 12.5% max waste
+extern size_t     ZObjectSizeLimitSmall;
 extern size_t     ZObjectSizeLimitMedium;
 
 // Object alignment shifts
@@ -99,6 +102,11 @@ const  size_t     ZAddressOffsetShift           = 0;
 extern uintptr_t  ZAddressOffsetMask;
 extern size_t     ZAddressOffsetMax;
 
+// Max number of offset bits, limited by the narrowest packed encoding of
+// an offset, the partial array offset in mark stack entries. The to-offset
+// in forwarding entries has 45 bits.
+const size_t      ZAddressOffsetBitsMax         = 44; // 16TB
+
 // Metadata part of address
 const size_t      ZAddressMetadataBits          = 4;
 extern size_t     ZAddressMetadataShift;
@@ -120,13 +128,16 @@ const size_t      ZCacheLineSize                = ZPlatformCacheLineSize;
 
 // Mark stack space
 extern uintptr_t  ZMarkStackSpaceStart;
+extern uintptr_t  ZMarkStackCompactOffsetLimit;
 const size_t      ZMarkStackSpaceExpandSize     = (size_t)1 << 25; // 32M
+const size_t      ZMarkStackSpaceRetainCycles   = 3; // Cycles unused space stays committed
 
 // Mark stack and magazine sizes
 const size_t      ZMarkStackSizeShift           = 11; // 2K
 const size_t      ZMarkStackSize                = (size_t)1 << ZMarkStackSizeShift;
 const size_t      ZMarkStackHeaderSize          = (size_t)1 << 4; // 16B
 const size_t      ZMarkStackSlots               = (ZMarkStackSize - ZMarkStackHeaderSize) / sizeof(uintptr_t);
+const size_t      ZMarkStackCompactOffsetMax    = (size_t)1 << 33; // 8G
 const size_t      ZMarkStackMagazineSize        = (size_t)1 << 15; // 32K
 const size_t      ZMarkStackMagazineSlots       = (ZMarkStackMagazineSize / ZMarkStackSize) - 1;
 
@@ -134,18 +145,44 @@ const size_t      ZMarkStackMagazineSlots       = (ZMarkStackMagazineSize / ZMar
 const size_t      ZMarkStripeShift              = ZGranuleSizeShift;
 
 // Max number of mark stripes
-const size_t      ZMarkStripesMax               = 16; // Must be a power of two
+const size_t      ZMarkStripesMax               = 64; // Must be a power of two
 
-// Mark cache size
+// Mark cache max size and associativity
 const size_t      ZMarkCacheSize                = 1024; // Must be a power of two
+const size_t      ZMarkCacheWays                = 4; // Must be a power of two
+
+// Mark prefetch queue size
+const size_t      ZMarkPrefetchQueueSize        = 8; // Must be a power of two
 
 // Partial array minimum size
 const size_t      ZMarkPartialArrayMinSizeShift = 12; // 4K
 const size_t      ZMarkPartialArrayMinSize      = (size_t)1 << ZMarkPartialArrayMinSizeShift;
 
-// Max number of proactive/terminate flush attempts
+// Number of partial array chunks to split a large array into per worker
+const size_t      ZMarkPartialArrayChunksPerWorker = 8;
+
+// Max number of proactive/terminate/end flush attempts
 const size_t      ZMarkProactiveFlushMax        = 10;
 const size_t      ZMarkTerminateFlushMax        = 3;
+const size_t      ZMarkEndFlushMax              = 3;
+
+// Max number of spin iterations before an idle mark worker parks
+const size_t      ZMarkIdleSpinMax              = 1000;
+
+// Number of drained entries between checks for idle mark workers to wake up
+const size_t      ZMarkIdleWakeUpInterval       = 64; // Must be a power of two
+
+// Max time an idle mark worker stays parked without being woken up
+const uint64_t    ZMarkIdleParkTimeout          = 1; // ms
+
+// Max depth of objects followed when relocating in reference order
+const size_t      ZRelocateReferenceOrderDepthMax = 8;
+
+// Number of forwarding entries compared in one probe step, one cache line
+const size_t      ZForwardingProbeLength        = 8; // Must be a power of two
+
+// Number of entries in object age tables, the last one includes all older objects
+const size_t      ZObjectAgeTableSize           = 16;
 
 // Try complete mark timeout
 const uint64_t    ZMarkCompleteTimeout          = 1; // ms
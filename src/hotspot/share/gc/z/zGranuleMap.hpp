@@ -29,16 +29,32 @@
 template<typename T>
 class ZGranuleMapIterator;
 
+template<typename T>
+class ZGranuleMapParallelIterator;
+
+// The map is a flat array, so that a lookup is a single load. The array
+// is sized for the whole address offset range rather than for the heap,
+// and its memory is only populated by the OS when written. Chunks of
+// entries that have been written are tracked, so that iteration only
+// visits, and never populates, the parts of the map that are in use.
 template <typename T>
 class ZGranuleMap {
   friend class VMStructs;
   friend class ZGranuleMapIterator<T>;
+  friend class ZGranuleMapParallelIterator<T>;
 
 private:
+  static const size_t ChunkShift = 9;
+  static const size_t ChunkSize  = (size_t)1 << ChunkShift;
+
   const size_t _size;
   T* const     _map;
+  const size_t _nchunks;
+  bool* const  _chunks;
 
   size_t index_for_offset(uintptr_t offset) const;
+  bool is_chunk_used(size_t index) const;
+  void set_chunk_used(size_t index);
 
 public:
   ZGranuleMap(size_t max_offset);
@@ -47,6 +63,9 @@ public:
   T get(uintptr_t offset) const;
   void put(uintptr_t offset, T value);
   void put(uintptr_t offset, size_t size, T value);
+
+  T get_acquire(uintptr_t offset) const;
+  void release_put(uintptr_t offset, T value);
 };
 
 template <typename T>
@@ -55,6 +74,8 @@ public:
   const ZGranuleMap<T>* const _map;
   size_t                      _next;
 
+  bool skip_unused();
+
 public:
   ZGranuleMapIterator(const ZGranuleMap<T>* map);
 
@@ -62,4 +83,19 @@ public:
   bool next(T** value);
 };
 
+// Lets multiple threads iterate over the map, by claiming one chunk
+// of entries at a time. Chunks that have never been written are skipped.
+template <typename T>
+class ZGranuleMapParallelIterator : public StackObj {
+private:
+  const ZGranuleMap<T>* const _map;
+  volatile size_t             _next_chunk;
+
+public:
+  ZGranuleMapParallelIterator(const ZGranuleMap<T>* map);
+
+  bool next_chunk(size_t* start, size_t* end);
+  T at(size_t index) const;
+};
+
 #endif // SHARE_GC_Z_ZGRANULEMAP_HPP
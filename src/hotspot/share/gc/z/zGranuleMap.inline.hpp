@@ -27,19 +27,23 @@
 #include "gc/z/zGlobals.hpp"
 #include "gc/z/zGranuleMap.hpp"
 #include "memory/allocation.inline.hpp"
+#include "runtime/atomic.hpp"
 #include "utilities/align.hpp"
 #include "utilities/debug.hpp"
 
 template <typename T>
 inline ZGranuleMap<T>::ZGranuleMap(size_t max_offset) :
     _size(max_offset >> ZGranuleSizeShift),
-    _map(MmapArrayAllocator<T>::allocate(_size, mtGC)) {
+    _map(MmapArrayAllocator<T>::allocate(_size, mtGC)),
+    _nchunks(align_up(_size, ChunkSize) >> ChunkShift),
+    _chunks(MmapArrayAllocator<bool>::allocate(_nchunks, mtGC)) {
   assert(is_aligned(max_offset, ZGranuleSize), "Misaligned");
 }
 
 template <typename T>
 inline ZGranuleMap<T>::~ZGranuleMap() {
   MmapArrayAllocator<T>::free(_map, _size);
+  MmapArrayAllocator<bool>::free(_chunks, _nchunks);
 }
 
 template <typename T>
@@ -50,6 +54,19 @@ inline size_t ZGranuleMap<T>::index_for_offset(uintptr_t offset) const {
   return index;
 }
 
+template <typename T>
+inline bool ZGranuleMap<T>::is_chunk_used(size_t index) const {
+  return _chunks[index >> ChunkShift];
+}
+
+template <typename T>
+inline void ZGranuleMap<T>::set_chunk_used(size_t index) {
+  const size_t chunk = index >> ChunkShift;
+  if (!_chunks[chunk]) {
+    _chunks[chunk] = true;
+  }
+}
+
 template <typename T>
 inline T ZGranuleMap<T>::get(uintptr_t offset) const {
   const size_t index = index_for_offset(offset);
@@ -59,6 +76,7 @@ inline T ZGranuleMap<T>::get(uintptr_t offset) const {
 template <typename T>
 inline void ZGranuleMap<T>::put(uintptr_t offset, T value) {
   const size_t index = index_for_offset(offset);
+  set_chunk_used(index);
   _map[index] = value;
 }
 
@@ -69,18 +87,42 @@ inline void ZGranuleMap<T>::put(uintptr_t offset, size_t size, T value) {
   const size_t start_index = index_for_offset(offset);
   const size_t end_index = start_index + (size >> ZGranuleSizeShift);
   for (size_t index = start_index; index < end_index; index++) {
+    set_chunk_used(index);
     _map[index] = value;
   }
 }
 
+template <typename T>
+inline T ZGranuleMap<T>::get_acquire(uintptr_t offset) const {
+  const size_t index = index_for_offset(offset);
+  return Atomic::load_acquire(_map + index);
+}
+
+template <typename T>
+inline void ZGranuleMap<T>::release_put(uintptr_t offset, T value) {
+  const size_t index = index_for_offset(offset);
+  set_chunk_used(index);
+  Atomic::release_store(_map + index, value);
+}
+
 template <typename T>
 inline ZGranuleMapIterator<T>::ZGranuleMapIterator(const ZGranuleMap<T>* map) :
     _map(map),
     _next(0) {}
 
+template <typename T>
+inline bool ZGranuleMapIterator<T>::skip_unused() {
+  // Skip chunks that have never been written
+  while (_next < _map->_size && !_map->is_chunk_used(_next)) {
+    _next = align_up(_next + 1, ZGranuleMap<T>::ChunkSize);
+  }
+
+  return _next < _map->_size;
+}
+
 template <typename T>
 inline bool ZGranuleMapIterator<T>::next(T* value) {
-  if (_next < _map->_size) {
+  if (skip_unused()) {
     *value = _map->_map[_next++];
     return true;
   }
@@ -91,7 +133,7 @@ inline bool ZGranuleMapIterator<T>::next(T* value) {
 
 template <typename T>
 inline bool ZGranuleMapIterator<T>::next(T** value) {
-  if (_next < _map->_size) {
+  if (skip_unused()) {
     *value = _map->_map + _next++;
     return true;
   }
@@ -100,4 +142,33 @@ inline bool ZGranuleMapIterator<T>::next(T** value) {
   return false;
 }
 
+template <typename T>
+inline ZGranuleMapParallelIterator<T>::ZGranuleMapParallelIterator(const ZGranuleMap<T>* map) :
+    _map(map),
+    _next_chunk(0) {}
+
+template <typename T>
+inline bool ZGranuleMapParallelIterator<T>::next_chunk(size_t* start, size_t* end) {
+  for (;;) {
+    const size_t chunk = Atomic::add(&_next_chunk, (size_t)1) - 1;
+    if (chunk >= _map->_nchunks) {
+      // End of map
+      return false;
+    }
+
+    if (_map->_chunks[chunk]) {
+      // Chunk claimed
+      *start = chunk << ZGranuleMap<T>::ChunkShift;
+      *end = MIN2(*start + ZGranuleMap<T>::ChunkSize, _map->_size);
+      return true;
+    }
+  }
+}
+
+template <typename T>
+inline T ZGranuleMapParallelIterator<T>::at(size_t index) const {
+  assert(index < _map->_size, "Invalid index");
+  return _map->_map[index];
+}
+
 #endif // SHARE_GC_Z_ZGRANULEMAP_INLINE_HPP
@@ -24,25 +24,39 @@
 #include "precompiled.hpp"
 #include "gc/shared/locationPrinter.hpp"
 #include "gc/z/zAddress.inline.hpp"
+#include "gc/z/zArray.inline.hpp"
+#include "gc/z/zBarrierProfile.hpp"
+#include "gc/z/zCPU.inline.hpp"
+#include "gc/z/zClassProfile.hpp"
+#include "gc/z/zDirectorState.hpp"
 #include "gc/z/zGlobals.hpp"
 #include "gc/z/zHeap.inline.hpp"
 #include "gc/z/zHeapIterator.hpp"
+#include "gc/z/zHeapMap.hpp"
+#include "gc/z/zHeuristics.hpp"
+#include "gc/z/zLiveMapPool.hpp"
 #include "gc/z/zMark.inline.hpp"
+#include "gc/z/zNUMA.hpp"
+#include "gc/z/zPacer.hpp"
 #include "gc/z/zPage.inline.hpp"
+#include "gc/z/zPageHotness.hpp"
 #include "gc/z/zPageTable.inline.hpp"
 #include "gc/z/zRelocationSet.inline.hpp"
 #include "gc/z/zRelocationSetSelector.hpp"
 #include "gc/z/zResurrection.hpp"
 #include "gc/z/zStat.hpp"
+#include "gc/z/zTask.hpp"
 #include "gc/z/zThread.inline.hpp"
 #include "gc/z/zVerify.hpp"
 #include "gc/z/zWorkers.inline.hpp"
 #include "logging/log.hpp"
 #include "memory/iterator.hpp"
 #include "memory/resourceArea.hpp"
+#include "runtime/globals.hpp"
 #include "runtime/handshake.hpp"
 #include "runtime/safepoint.hpp"
 #include "runtime/thread.hpp"
+#include "utilities/align.hpp"
 #include "utilities/debug.hpp"
 
 static const ZStatSampler ZSamplerHeapUsedBeforeMark("Memory", "Heap Used Before Mark", ZStatUnitBytes);
@@ -56,23 +70,36 @@ ZHeap* ZHeap::_heap = NULL;
 
 ZHeap::ZHeap() :
     _workers(),
-    _object_allocator(),
+    _object_allocator(ZPartitionDefault),
     _page_allocator(&_workers, heap_min_size(), heap_initial_size(), heap_max_size(), heap_max_reserve_size()),
     _page_table(),
     _forwarding_table(),
     _mark(&_workers, &_page_table),
-    _reference_processor(&_workers),
+    _reference_processor(),
     _weak_roots_processor(&_workers),
     _relocate(&_workers),
     _relocation_set(),
+    _forced_relocation_lock(),
+    _forced_relocation(),
+    _remap(&_workers),
     _unload(&_workers),
     _serviceability(heap_min_size(), heap_max_size()) {
   // Install global heap instance
   assert(_heap == NULL, "Already initialized");
   _heap = this;
 
+  // Each allocation partition allocates from its own pages
+  _object_allocators[ZPartitionDefault] = &_object_allocator;
+  for (uint8_t id = ZPartitionDefault + 1; id < ZPartitions::count(); id++) {
+    _object_allocators[id] = new ZObjectAllocator(id);
+  }
+
   // Update statistics
   ZStatHeap::set_at_initialize(heap_min_size(), heap_max_size(), heap_max_reserve_size());
+
+  // Seed the director statistics, before the director
+  // and driver threads are started and start sampling them
+  ZDirectorState::load();
 }
 
 size_t ZHeap::heap_min_size() const {
@@ -94,6 +121,36 @@ size_t ZHeap::heap_max_reserve_size() const {
   return MIN2(max_reserve_size, heap_max_size());
 }
 
+size_t ZHeap::relocation_reserve_size(const ZRelocationSetSelector* selector) const {
+  // Size the reserve from what the relocation set needs in flight. Each
+  // worker fills one small target page per age class at a time. Mutators
+  // relocating small objects use the shared small pages, which never take
+  // from the reserve. Medium objects relocated by mutators, and by workers
+  // unless they have per-worker medium pages, go to the per-CPU or per-NUMA
+  // shared medium pages. The to-space need never exceeds the number of
+  // bytes being relocated. The reserve may grow beyond the default size,
+  // up to 5% of the max heap size, to avoid relocating pages in-place when
+  // the relocation set needs it.
+  const size_t nworkers = _workers.nconcurrent();
+  const size_t nclasses = (selector->live_tenured() > 0 && selector->live_tenured() < selector->live()) ? 2 : 1;
+
+  const size_t small_relocating = selector->small().relocating();
+  const size_t small_pages = nworkers * nclasses * ZPageSizeSmall;
+  const size_t small_reserve = MIN2(small_pages, align_up(small_relocating, ZPageSizeSmall));
+
+  const size_t medium_relocating = selector->medium().relocating();
+  const size_t shared_medium_npages = ZHeuristics::use_per_cpu_shared_medium_pages() ? ZCPU::count() : ZNUMA::count();
+  const size_t worker_medium_npages = ZHeuristics::use_per_worker_medium_pages() ? nworkers * nclasses
+                                                                                 : (nclasses - 1) * ZNUMA::count();
+  const size_t medium_npages = shared_medium_npages + worker_medium_npages;
+  const size_t medium_pages = medium_npages * ZPageSizeMedium;
+  const size_t medium_reserve = (ZPageSizeMedium > 0) ? MIN2(medium_pages, align_up(medium_relocating, ZPageSizeMedium)) : 0;
+
+  const size_t limit = MIN2(MAX2(heap_max_reserve_size(), (size_t)(heap_max_size() * 0.05)), heap_max_size());
+  const size_t reserve = MAX2(small_reserve + medium_reserve, ZPageSizeSmall);
+  return MIN2(reserve, limit);
+}
+
 bool ZHeap::is_initialized() const {
   return _page_allocator.is_initialized() && _mark.is_initialized();
 }
@@ -110,6 +167,18 @@ size_t ZHeap::soft_max_capacity() const {
   return _page_allocator.soft_max_capacity();
 }
 
+bool ZHeap::is_soft_max_limited() const {
+  return _page_allocator.is_soft_max_limited();
+}
+
+void ZHeap::set_soft_max_limit(size_t limit) {
+  _page_allocator.set_soft_max_limit(limit);
+}
+
+void ZHeap::set_director_threshold(size_t threshold) {
+  _page_allocator.set_director_threshold(threshold);
+}
+
 size_t ZHeap::capacity() const {
   return _page_allocator.capacity();
 }
@@ -118,6 +187,10 @@ size_t ZHeap::max_reserve() const {
   return _page_allocator.max_reserve();
 }
 
+size_t ZHeap::max_reserve_used() const {
+  return _page_allocator.max_reserve_used();
+}
+
 size_t ZHeap::used_high() const {
   return _page_allocator.used_high();
 }
@@ -147,15 +220,26 @@ size_t ZHeap::tlab_capacity() const {
 }
 
 size_t ZHeap::tlab_used() const {
-  return _object_allocator.used();
+  size_t used = 0;
+  for (uint8_t id = ZPartitionDefault; id < ZPartitions::count(); id++) {
+    used += object_allocator(id)->used();
+  }
+  return used;
 }
 
 size_t ZHeap::max_tlab_size() const {
-  return ZObjectSizeLimitSmall;
+  // TLABs larger than the small object size limit get a dedicated small page
+  return ZDedicatedTLABPages ? ZPageSizeSmall : ZObjectSizeLimitSmall;
 }
 
 size_t ZHeap::unsafe_max_tlab_alloc() const {
-  size_t size = _object_allocator.remaining();
+  if (ZDedicatedTLABPages) {
+    // A dedicated page can always be allocated, regardless
+    // of the space remaining in the shared small page.
+    return max_tlab_size();
+  }
+
+  size_t size = object_allocator()->remaining();
 
   if (size < MinTLABSize) {
     // The remaining space in the allocator is not enough to
@@ -186,6 +270,10 @@ bool ZHeap::is_in(uintptr_t addr) const {
   return false;
 }
 
+uint ZHeap::nworker_threads() const {
+  return _workers.nworkers();
+}
+
 uint ZHeap::nconcurrent_worker_threads() const {
   return _workers.nconcurrent();
 }
@@ -198,6 +286,14 @@ void ZHeap::set_boost_worker_threads(bool boost) {
   _workers.set_boost(boost);
 }
 
+void ZHeap::set_nconcurrent_worker_threads(uint nworkers) {
+  _workers.set_nconcurrent(nworkers);
+}
+
+void ZHeap::set_nworker_threads(uint nparallel, uint nconcurrent) {
+  _workers.set_nworkers(nparallel, nconcurrent);
+}
+
 void ZHeap::worker_threads_do(ThreadClosure* tc) const {
   _workers.threads_do(tc);
 }
@@ -241,8 +337,73 @@ void ZHeap::free_page(ZPage* page, bool reclaimed) {
   _page_allocator.free_page(page, reclaimed);
 }
 
-uint64_t ZHeap::uncommit(uint64_t delay) {
-  return _page_allocator.uncommit(delay);
+void ZHeap::free_pages(ZArray<ZPage*>* pages, bool reclaimed) {
+  // Remove page table entries
+  ZArrayIterator<ZPage*> iter(pages);
+  for (ZPage* page; iter.next(&page);) {
+    _page_table.remove(page);
+  }
+
+  // Free pages
+  _page_allocator.free_pages(pages, reclaimed);
+}
+
+ZPage* ZHeap::remap_page(const ZPage* page) {
+  ZPage* const new_page = _page_allocator.remap_page(page);
+  if (new_page != NULL) {
+    // Insert page table entry
+    _page_table.insert(new_page);
+  }
+
+  return new_page;
+}
+
+void ZHeap::free_remapped_page(ZPage* page) {
+  // Remove page table entry
+  _page_table.remove(page);
+
+  // Free page
+  _page_allocator.free_remapped_page(page);
+}
+
+void ZHeap::sample_page_demand() {
+  _page_allocator.sample_demand();
+}
+
+size_t ZHeap::commit_ahead(size_t headroom) {
+  return _page_allocator.commit_ahead(headroom);
+}
+
+uint64_t ZHeap::uncommit(uint64_t delay, size_t limit) {
+  return _page_allocator.uncommit(delay, limit);
+}
+
+size_t ZHeap::defragment() {
+  return _page_allocator.defragment();
+}
+
+size_t ZHeap::zero_pages(size_t target) {
+  return _page_allocator.zero_pages(target);
+}
+
+bool ZHeap::is_zeroed(uintptr_t addr) const {
+  // Only medium and large pages are considered. Small pages are used
+  // for TLABs, which are filled with a bad value in debug builds.
+  const ZPage* const page = _page_table.get(addr);
+  return page->type() != ZPageTypeSmall && page->is_zeroed();
+}
+
+void ZHeap::sample_page_hotness() {
+  // Do not allow pages to be deleted
+  _page_allocator.enable_deferred_delete();
+
+  ZPageTableIterator iter(&_page_table);
+  for (ZPage* page; iter.next(&page);) {
+    ZPageHotness::sample(page);
+  }
+
+  // Allow pages to be deleted
+  _page_allocator.disable_deferred_delete();
 }
 
 void ZHeap::flip_to_marked() {
@@ -258,6 +419,11 @@ void ZHeap::flip_to_remapped() {
 void ZHeap::mark_start() {
   assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
 
+  if (ZGlobalPhase == ZPhaseMarkCompleted) {
+    // Relocation was skipped in the last cycle, finish unloading
+    _unload.finish();
+  }
+
   // Update statistics
   ZStatSample(ZSamplerHeapUsedBeforeMark, used());
 
@@ -265,7 +431,9 @@ void ZHeap::mark_start() {
   flip_to_marked();
 
   // Retire allocating pages
-  _object_allocator.retire_pages();
+  for (uint8_t id = ZPartitionDefault; id < ZPartitions::count(); id++) {
+    object_allocator(id)->retire_pages();
+  }
 
   // Reset allocated/reclaimed/used statistics
   _page_allocator.reset_statistics();
@@ -273,6 +441,19 @@ void ZHeap::mark_start() {
   // Reset encountered/dropped/enqueued statistics
   _reference_processor.reset_statistics();
 
+  // Reset barrier profile
+  if (ZProfileBarrierSlowPaths) {
+    ZBarrierProfile::reset();
+  }
+
+  // Reset class profile
+  if (ZProfileClasses) {
+    ZClassProfile::reset();
+  }
+
+  // Reset remap abort request
+  _remap.reset();
+
   // Enter mark phase
   ZGlobalPhase = ZPhaseMark;
 
@@ -326,6 +507,22 @@ void ZHeap::keep_alive(oop obj) {
   ZBarrier::keep_alive_barrier_on_oop(obj);
 }
 
+void ZHeap::pin_object(uintptr_t addr) {
+  // Objects on a pinned page are not relocated. The pin count is checked
+  // when selecting the relocation set, and again in the relocate start
+  // pause, which can't run while a thread is pinning. An object pinned
+  // during relocation has already been relocated or in-place forwarded
+  // by the load barrier, so it stays where it is.
+  ZPage* const page = _page_table.get(addr);
+  assert(page != NULL, "Invalid address");
+  page->pin();
+}
+
+void ZHeap::unpin_object(uintptr_t addr) {
+  ZPage* const page = _page_table.get(addr);
+  page->unpin();
+}
+
 void ZHeap::set_soft_reference_policy(bool clear) {
   _reference_processor.set_soft_reference_policy(clear);
 }
@@ -339,11 +536,11 @@ public:
 };
 
 void ZHeap::process_non_strong_references() {
-  // Process Soft/Weak/Final/PhantomReferences
-  _reference_processor.process_references();
-
-  // Process concurrent weak roots
-  _weak_roots_processor.process_concurrent_weak_roots();
+  // Process Soft/Weak/Final/PhantomReferences and concurrent weak roots.
+  // Everything up until resurrection is unblocked forces weak and phantom
+  // loads into their slow paths, so only work that needs to be done while
+  // resurrection is blocked is done here.
+  _weak_roots_processor.process_concurrent_weak_roots_and_references(&_reference_processor);
 
   // Unlink stale metadata and nmethods
   _unload.unlink();
@@ -362,6 +559,10 @@ void ZHeap::process_non_strong_references() {
   // Unblock resurrection of weak/phantom references
   ZResurrection::unblock();
 
+  // Report class histogram collected during marking. This must be
+  // done before the classes of dead objects are purged.
+  _mark.report_class_histogram();
+
   // Purge stale metadata and nmethods that were unlinked
   _unload.purge();
 
@@ -372,38 +573,179 @@ void ZHeap::process_non_strong_references() {
   // during the resurrection block window, since such referents
   // are only Finalizable marked.
   _reference_processor.enqueue_references();
+
+  // Free mark stack space
+  _mark.free();
 }
 
-void ZHeap::select_relocation_set() {
-  // Do not allow pages to be deleted
-  _page_allocator.enable_deferred_delete();
+static bool is_forced_relocation(const ZPage* page, ZArray<uintptr_t>* forced) {
+  ZArrayIterator<uintptr_t> iter(forced);
+  for (uintptr_t addr; iter.next(&addr);) {
+    if (page->is_in(addr)) {
+      return true;
+    }
+  }
 
-  // Register relocatable pages with selector
-  ZRelocationSetSelector selector;
-  ZPageTableIterator pt_iter(&_page_table);
-  for (ZPage* page; pt_iter.next(&page);) {
-    if (!page->is_relocatable()) {
-      // Not relocatable, don't register
-      continue;
+  return false;
+}
+
+void ZHeap::force_relocation(uintptr_t addr) {
+  // Make the page containing the given address, at the time of the
+  // next relocation set selection, be part of the relocation set.
+  ZLocker<ZLock> locker(&_forced_relocation_lock);
+  _forced_relocation.add(addr);
+}
+
+void ZHeap::register_relocation_set_page(ZPage* page,
+                                         ZRelocationSetSelector* selector,
+                                         ZArray<ZPage*>* garbage,
+                                         ZArray<uintptr_t>* forced) {
+  if (!page->is_relocatable()) {
+    // Not relocatable, don't register
+    return;
+  }
+
+  if (page->has_kept_tlab()) {
+    // Objects allocated in a TLAB kept across mark start are not in
+    // the live map, so the page can't be relocated or reclaimed
+    return;
+  }
+
+  if (page->is_marked()) {
+    if (page->is_pinned()) {
+      // Register page with objects used in JNI critical regions,
+      // which can't be moved
+      selector->register_pinned_page(page);
+      return;
+    }
+
+    // Register live page
+    selector->register_live_page(page);
+
+    if (!forced->is_empty() && is_forced_relocation(page, forced)) {
+      // Register page requested to be relocated
+      selector->register_forced_page(page);
     }
 
-    if (page->is_marked()) {
-      // Register live page
-      selector.register_live_page(page);
-    } else {
-      // Register garbage page
-      selector.register_garbage_page(page);
+    if (ZRelocateLargePages &&
+        page->type() == ZPageTypeLarge &&
+        _page_allocator.should_remap_page(page)) {
+      // Register large page to be relocated by remapping
+      selector->register_remap_page(page);
+    }
+  } else {
+    // Register garbage page
+    selector->register_garbage_page(page);
+
+    // Reclaim page, together with the other garbage pages
+    garbage->add(page);
+  }
+}
+
+class ZSelectRelocationSetClosure : public StackObj {
+private:
+  ZHeap* const                  _heap;
+  ZRelocationSetSelector* const _selector;
+  ZArray<ZPage*>* const         _garbage;
+  ZArray<uintptr_t>* const      _forced;
 
-      // Reclaim page immediately
-      free_page(page, true /* reclaimed */);
+public:
+  ZSelectRelocationSetClosure(ZHeap* heap,
+                              ZRelocationSetSelector* selector,
+                              ZArray<ZPage*>* garbage,
+                              ZArray<uintptr_t>* forced) :
+      _heap(heap),
+      _selector(selector),
+      _garbage(garbage),
+      _forced(forced) {}
+
+  void do_page(ZPage* page);
+};
+
+class ZSelectRelocationSetTask : public ZTask {
+private:
+  ZHeap* const                  _heap;
+  ZRelocationSetSelector* const _selector;
+  ZArray<ZPage*>* const         _garbage;
+  ZArray<uintptr_t>* const      _forced;
+  ZPageTableParallelIterator    _iter;
+  ZLock                         _lock;
+
+public:
+  ZSelectRelocationSetTask(ZHeap* heap, ZRelocationSetSelector* selector, ZArray<ZPage*>* garbage, ZArray<uintptr_t>* forced) :
+      ZTask("ZSelectRelocationSetTask"),
+      _heap(heap),
+      _selector(selector),
+      _garbage(garbage),
+      _forced(forced),
+      _iter(&heap->_page_table),
+      _lock() {}
+
+  virtual void work() {
+    // Register pages with a worker local selector, which is merged
+    // into the shared selector once all pages have been visited
+    ZRelocationSetSelector selector(_selector->is_aggressive());
+    ZArray<ZPage*> garbage;
+    ZSelectRelocationSetClosure cl(_heap, &selector, &garbage, _forced);
+    _iter.pages_do(&cl);
+
+    // Garbage pages are freed once all workers are done iterating
+    // over the page table, since freeing a page removes it from it
+    ZLocker<ZLock> locker(&_lock);
+    _selector->merge(&selector);
+    ZArrayIterator<ZPage*> iter(&garbage);
+    for (ZPage* page; iter.next(&page);) {
+      _garbage->add(page);
     }
   }
+};
+
+void ZSelectRelocationSetClosure::do_page(ZPage* page) {
+  _heap->register_relocation_set_page(page, _selector, _garbage, _forced);
+}
+
+bool ZHeap::select_relocation_set(bool aggressive, bool skippable) {
+  // Take the addresses of pages requested to be relocated
+  ZArray<uintptr_t> forced;
+  {
+    ZLocker<ZLock> locker(&_forced_relocation_lock);
+    forced.transfer(&_forced_relocation);
+  }
+
+  // Do not allow pages to be deleted
+  _page_allocator.enable_deferred_delete();
+
+  // Register relocatable pages with selector
+  ZRelocationSetSelector selector(aggressive);
+  ZArray<ZPage*> garbage;
+  {
+    ZSelectRelocationSetTask task(this, &selector, &garbage, &forced);
+    _workers.run_concurrent(&task);
+  }
+
+  // Reclaim garbage pages
+  if (!garbage.is_empty()) {
+    free_pages(&garbage, true /* reclaimed */);
+  }
 
   // Allow pages to be deleted
   _page_allocator.disable_deferred_delete();
 
+  // Trim live map storage to what this cycle marked
+  ZLiveMapPool::trim();
+
   // Select pages to relocate
-  selector.select(&_relocation_set);
+  selector.select(&_workers, &_relocation_set);
+
+  // Skip relocation if it would reclaim too little memory to be worth
+  // a pause. The garbage pages have already been freed, and the other
+  // pages stay where they are until the next cycle.
+  const double reclaimable_percent = percent_of(MIN2(selector.reclaimable(), max_capacity()), max_capacity());
+  const bool skip = skippable && reclaimable_percent < ZRelocationSkipLimit;
+  if (skip) {
+    log_info(gc, reloc)("Relocation Skipped: %.1f%% reclaimable", reclaimable_percent);
+    _relocation_set.reset();
+  }
 
   // Setup forwarding table
   ZRelocationSetIterator rs_iter(&_relocation_set);
@@ -411,11 +753,24 @@ void ZHeap::select_relocation_set() {
     _forwarding_table.insert(forwarding);
   }
 
+  if (ZAdaptiveRelocationReserve) {
+    // Size the reserve for relocating the selected relocation set. When
+    // relocation is skipped nothing is relocated, so the reserve is kept
+    // at its minimum of one small page instead of being sized from the
+    // dropped selection.
+    _page_allocator.set_max_reserve(skip ? ZPageSizeSmall : relocation_reserve_size(&selector));
+  }
+
   // Update statistics
-  ZStatRelocation::set_at_select_relocation_set(selector.relocating());
+  ZStatRelocation::set_at_select_relocation_set(skip ? 0 : selector.relocating(),
+                                                selector.live(),
+                                                selector.live_tenured());
   ZStatHeap::set_at_select_relocation_set(selector.live(),
+                                          selector.live_by_age(),
                                           selector.garbage(),
                                           reclaimed());
+
+  return !skip;
 }
 
 void ZHeap::reset_relocation_set() {
@@ -429,9 +784,27 @@ void ZHeap::reset_relocation_set() {
   _relocation_set.reset();
 }
 
+void ZHeap::remove_pinned_relocation_set_pages() {
+  // Pages pinned after the relocation set was selected can't be relocated.
+  // Once removed from the forwarding table, pointers to their objects are
+  // remapped in place, like pointers to any page not being relocated.
+  ZArray<ZForwarding*> removed;
+  _relocation_set.remove_pinned(&removed);
+
+  ZArrayIterator<ZForwarding*> iter(&removed);
+  for (ZForwarding* forwarding; iter.next(&forwarding);) {
+    log_debug(gc, reloc)("Pinned page removed from relocation set: " PTR_FORMAT, forwarding->start());
+    _forwarding_table.remove(forwarding);
+    ZForwarding::destroy(forwarding);
+  }
+}
+
 void ZHeap::relocate_start() {
   assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
 
+  // Remove pages pinned since the relocation set was selected
+  remove_pinned_relocation_set_pages();
+
   // Finish unloading stale metadata and nmethods
   _unload.finish();
 
@@ -446,25 +819,89 @@ void ZHeap::relocate_start() {
   ZStatHeap::set_at_relocate_start(capacity(), allocated(), used());
 
   // Remap/Relocate roots
-  _relocate.start();
+  _relocate.start(&_relocation_set);
+}
+
+bool ZHeap::relocate_assist() {
+  return _relocate.assist();
+}
+
+void ZHeap::notify_relocation_assist() {
+  _page_allocator.notify_relocation_assist();
+}
+
+void ZHeap::skip_relocation() {
+  // Stay in the mark completed phase, where all oops are good, until the
+  // next mark start. Finishing unloading is then also left to that pause.
+  assert(ZGlobalPhase == ZPhaseMarkCompleted, "Invalid phase");
+  assert(_relocation_set.is_empty(), "Should be empty");
+
+  // Update statistics
+  ZStatHeap::set_at_relocate_start(capacity(), allocated(), used());
+  ZStatHeap::set_at_relocate_end(capacity(), allocated(), reclaimed(),
+                                 used(), used_high(), used_low());
+  ZStatRelocation::set_at_relocate_end_reserve(max_reserve(), max_reserve_used());
+
+  // Stop pacing allocations until the director has seen
+  // the memory reclaimed by this GC cycle
+  ZPacer::reset();
 }
 
 void ZHeap::relocate() {
   // Relocate relocation set
-  const bool success = _relocate.relocate(&_relocation_set);
+  _relocate.relocate(&_relocation_set);
 
   // Update statistics
   ZStatSample(ZSamplerHeapUsedAfterRelocation, used());
-  ZStatRelocation::set_at_relocate_end(success);
   ZStatHeap::set_at_relocate_end(capacity(), allocated(), reclaimed(),
                                  used(), used_high(), used_low());
+  ZStatRelocation::set_at_relocate_end_reserve(max_reserve(), max_reserve_used());
+
+  // Stop pacing allocations until the director has seen
+  // the memory reclaimed by this GC cycle
+  ZPacer::reset();
+}
+
+void ZHeap::remap() {
+  // Do not allow pages to be deleted
+  _page_allocator.enable_deferred_delete();
+
+  // Remap pointers in live objects
+  _remap.remap(&_page_table);
+
+  // Allow pages to be deleted
+  _page_allocator.disable_deferred_delete();
+}
+
+void ZHeap::abort_remap() {
+  _remap.abort();
 }
 
 void ZHeap::object_iterate(ObjectClosure* cl, bool visit_weaks) {
   assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
 
-  ZHeapIterator iter;
-  iter.objects_do(cl, visit_weaks);
+  ZHeapIterator iter(1 /* nworkers */, visit_weaks);
+  iter.object_iterate(cl, 0 /* worker_id */);
+}
+
+bool ZHeap::is_live_map_current() const {
+  // The live maps describe all objects that were live at the last mark
+  // start, from mark end until objects start to move at relocate start.
+  // If the relocation set is empty, nothing moves until the next cycle.
+  return ZGlobalSeqNum > 1 &&
+         (ZGlobalPhase == ZPhaseMarkCompleted ||
+          (ZGlobalPhase == ZPhaseRelocate && _relocation_set.is_empty()));
+}
+
+ParallelObjectIterator* ZHeap::parallel_object_iterator(uint nworkers, bool visit_weaks) {
+  assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
+
+  if (ZLiveMapHeapInspection && is_live_map_current()) {
+    // Walk the live maps instead of tracing the object graph
+    return new ZHeapLiveMapIterator(&_page_table);
+  }
+
+  return new ZHeapIterator(nworkers, visit_weaks);
 }
 
 void ZHeap::pages_do(ZPageClosure* cl) {
@@ -513,11 +950,16 @@ void ZHeap::print_extended_on(outputStream* st) const {
   }
 
   // Allow pages to be deleted
-  _page_allocator.enable_deferred_delete();
+  _page_allocator.disable_deferred_delete();
 
   st->cr();
 }
 
+void ZHeap::print_heap_map_on(outputStream* st) {
+  ZHeapMap map(&_page_table, &_page_allocator);
+  map.print_on(st);
+}
+
 bool ZHeap::print_location(outputStream* st, uintptr_t addr) const {
   if (LocationPrinter::is_valid_obj((void*)addr)) {
     st->print(PTR_FORMAT " is a %s oop: ", addr, ZAddress::is_good(addr) ? "good" : "bad");
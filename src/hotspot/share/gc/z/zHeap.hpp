@@ -25,30 +25,40 @@
 #define SHARE_GC_Z_ZHEAP_HPP
 
 #include "gc/z/zAllocationFlags.hpp"
+#include "gc/z/zArray.hpp"
 #include "gc/z/zForwardingTable.hpp"
+#include "gc/z/zLock.hpp"
 #include "gc/z/zMark.hpp"
 #include "gc/z/zObjectAllocator.hpp"
 #include "gc/z/zPage.hpp"
 #include "gc/z/zPageAllocator.hpp"
 #include "gc/z/zPageTable.hpp"
+#include "gc/z/zPartition.hpp"
 #include "gc/z/zReferenceProcessor.hpp"
 #include "gc/z/zRelocate.hpp"
 #include "gc/z/zRelocationSet.hpp"
+#include "gc/z/zRemap.hpp"
 #include "gc/z/zWeakRootsProcessor.hpp"
 #include "gc/z/zServiceability.hpp"
 #include "gc/z/zUnload.hpp"
 #include "gc/z/zWorkers.hpp"
 
+class ParallelObjectIterator;
 class ThreadClosure;
+class ZRelocationSetSelector;
 
 class ZHeap {
   friend class VMStructs;
+  friend class ZSelectRelocationSetClosure;
+  friend class ZSelectRelocationSetTask;
+  friend class ZVerify;
 
 private:
   static ZHeap*       _heap;
 
   ZWorkers            _workers;
   ZObjectAllocator    _object_allocator;
+  ZObjectAllocator*   _object_allocators[ZPartitionsMax];
   ZPageAllocator      _page_allocator;
   ZPageTable          _page_table;
   ZForwardingTable    _forwarding_table;
@@ -57,6 +67,9 @@ private:
   ZWeakRootsProcessor _weak_roots_processor;
   ZRelocate           _relocate;
   ZRelocationSet      _relocation_set;
+  ZLock               _forced_relocation_lock;
+  ZArray<uintptr_t>   _forced_relocation;
+  ZRemap              _remap;
   ZUnload             _unload;
   ZServiceability     _serviceability;
 
@@ -64,13 +77,25 @@ private:
   size_t heap_initial_size() const;
   size_t heap_max_size() const;
   size_t heap_max_reserve_size() const;
+  size_t relocation_reserve_size(const ZRelocationSetSelector* selector) const;
+
+  ZObjectAllocator* object_allocator() const;
+  ZObjectAllocator* object_allocator(uint8_t partition) const;
 
   void flip_to_marked();
   void flip_to_remapped();
 
+  bool is_live_map_current() const;
+
   void out_of_memory();
   void fixup_partial_loads();
 
+  void register_relocation_set_page(ZPage* page,
+                                    ZRelocationSetSelector* selector,
+                                    ZArray<ZPage*>* garbage,
+                                    ZArray<uintptr_t>* forced);
+  void remove_pinned_relocation_set_pages();
+
 public:
   static ZHeap* heap();
 
@@ -82,8 +107,12 @@ public:
   size_t min_capacity() const;
   size_t max_capacity() const;
   size_t soft_max_capacity() const;
+  bool is_soft_max_limited() const;
+  void set_soft_max_limit(size_t limit);
+  void set_director_threshold(size_t threshold);
   size_t capacity() const;
   size_t max_reserve() const;
+  size_t max_reserve_used() const;
   size_t used_high() const;
   size_t used_low() const;
   size_t used() const;
@@ -100,9 +129,12 @@ public:
   uint32_t hash_oop(uintptr_t addr) const;
 
   // Workers
+  uint nworker_threads() const;
   uint nconcurrent_worker_threads() const;
   uint nconcurrent_no_boost_worker_threads() const;
   void set_boost_worker_threads(bool boost);
+  void set_nconcurrent_worker_threads(uint nworkers);
+  void set_nworker_threads(uint nparallel, uint nconcurrent);
   void worker_threads_do(ThreadClosure* tc) const;
   void print_worker_threads_on(outputStream* st) const;
 
@@ -117,16 +149,37 @@ public:
   ZPage* alloc_page(uint8_t type, size_t size, ZAllocationFlags flags);
   void undo_alloc_page(ZPage* page);
   void free_page(ZPage* page, bool reclaimed);
+  void free_pages(ZArray<ZPage*>* pages, bool reclaimed);
+  ZPage* remap_page(const ZPage* page);
+  void free_remapped_page(ZPage* page);
+
+  // Sample page demand, used to size the page cache
+  void sample_page_demand();
+
+  // Commit memory ahead of allocation
+  size_t commit_ahead(size_t headroom);
 
   // Uncommit memory
-  uint64_t uncommit(uint64_t delay);
+  uint64_t uncommit(uint64_t delay, size_t limit);
+
+  // Defragment physical memory
+  size_t defragment();
+
+  // Zero memory ahead of allocation
+  size_t zero_pages(size_t target);
+  bool is_zeroed(uintptr_t addr) const;
+
+  // Sample how recently the memory of each page was accessed
+  void sample_page_hotness();
 
   // Object allocation
   uintptr_t alloc_tlab(size_t size);
   uintptr_t alloc_object(size_t size);
-  uintptr_t alloc_object_for_relocation(size_t size);
+  uintptr_t alloc_object_for_relocation(size_t size, bool tenured, uint8_t partition);
   void undo_alloc_object_for_relocation(uintptr_t addr, size_t size);
+  void reuse_page_for_relocation(ZPage* page);
   bool is_alloc_stalled() const;
+  bool is_alloc_stalled_through_gc() const;
   void check_out_of_memory();
 
   // Marking
@@ -139,18 +192,32 @@ public:
   bool mark_end();
   void keep_alive(oop obj);
 
+  // Pinning
+  void pin_object(uintptr_t addr);
+  void unpin_object(uintptr_t addr);
+
   // Relocation set
-  void select_relocation_set();
+  bool select_relocation_set(bool aggressive, bool skippable);
   void reset_relocation_set();
+  void force_relocation(uintptr_t addr);
 
   // Relocation
   void relocate_start();
+  void skip_relocation();
+  ZForwarding* forwarding(uintptr_t addr) const;
   uintptr_t relocate_object(uintptr_t addr);
   uintptr_t remap_object(uintptr_t addr);
+  bool relocate_assist();
+  void notify_relocation_assist();
   void relocate();
 
+  // Remapping
+  void remap();
+  void abort_remap();
+
   // Iteration
   void object_iterate(ObjectClosure* cl, bool visit_weaks);
+  ParallelObjectIterator* parallel_object_iterator(uint nworkers, bool visit_weaks);
   void pages_do(ZPageClosure* cl);
 
   // Serviceability
@@ -162,6 +229,7 @@ public:
   // Printing
   void print_on(outputStream* st) const;
   void print_extended_on(outputStream* st) const;
+  void print_heap_map_on(outputStream* st);
   bool print_location(outputStream* st, uintptr_t addr) const;
 
   // Verification
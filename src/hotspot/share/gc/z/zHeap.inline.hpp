@@ -26,9 +26,11 @@
 
 #include "gc/z/zAddress.inline.hpp"
 #include "gc/z/zForwarding.inline.hpp"
+#include "gc/z/zForwardingCache.inline.hpp"
 #include "gc/z/zForwardingTable.inline.hpp"
 #include "gc/z/zHash.inline.hpp"
 #include "gc/z/zHeap.hpp"
+#include "gc/z/zThreadLocalData.hpp"
 #include "gc/z/zMark.inline.hpp"
 #include "gc/z/zOop.inline.hpp"
 #include "gc/z/zPage.inline.hpp"
@@ -40,6 +42,14 @@ inline ZHeap* ZHeap::heap() {
   return _heap;
 }
 
+inline ZObjectAllocator* ZHeap::object_allocator() const {
+  return object_allocator(ZPartitions::current());
+}
+
+inline ZObjectAllocator* ZHeap::object_allocator(uint8_t partition) const {
+  return _object_allocators[partition];
+}
+
 inline ReferenceDiscoverer* ZHeap::reference_discoverer() {
   return &_reference_processor;
 }
@@ -67,11 +77,17 @@ inline void ZHeap::mark_object(uintptr_t addr) {
 
 inline uintptr_t ZHeap::alloc_tlab(size_t size) {
   guarantee(size <= max_tlab_size(), "TLAB too large");
-  return _object_allocator.alloc_object(size);
+
+  if (size > ZObjectSizeLimitSmall) {
+    // Too large for a shared small page
+    return object_allocator()->alloc_tlab_page(size);
+  }
+
+  return object_allocator()->alloc_object(size);
 }
 
 inline uintptr_t ZHeap::alloc_object(size_t size) {
-  uintptr_t addr = _object_allocator.alloc_object(size);
+  uintptr_t addr = object_allocator()->alloc_object(size);
   assert(ZAddress::is_good_or_null(addr), "Bad address");
 
   if (addr == 0) {
@@ -81,24 +97,50 @@ inline uintptr_t ZHeap::alloc_object(size_t size) {
   return addr;
 }
 
-inline uintptr_t ZHeap::alloc_object_for_relocation(size_t size) {
-  uintptr_t addr = _object_allocator.alloc_object_for_relocation(size);
+inline uintptr_t ZHeap::alloc_object_for_relocation(size_t size, bool tenured, uint8_t partition) {
+  // Relocated objects stay in the allocation partition of their page
+  uintptr_t addr = object_allocator(partition)->alloc_object_for_relocation(size, tenured);
   assert(ZAddress::is_good_or_null(addr), "Bad address");
   return addr;
 }
 
 inline void ZHeap::undo_alloc_object_for_relocation(uintptr_t addr, size_t size) {
   ZPage* const page = _page_table.get(addr);
-  _object_allocator.undo_alloc_object_for_relocation(page, addr, size);
+  object_allocator(page->partition())->undo_alloc_object_for_relocation(page, addr, size);
+}
+
+inline void ZHeap::reuse_page_for_relocation(ZPage* page) {
+  object_allocator(page->partition())->reuse_page_for_relocation(page);
+}
+
+inline ZForwarding* ZHeap::forwarding(uintptr_t addr) const {
+  return _forwarding_table.get(addr);
 }
 
 inline uintptr_t ZHeap::relocate_object(uintptr_t addr) {
   assert(ZGlobalPhase == ZPhaseRelocate, "Relocate not allowed");
 
-  ZForwarding* const forwarding = _forwarding_table.get(addr);
+  const uintptr_t offset = ZAddress::offset(addr);
+  ZForwardingCache* const cache = ZThreadLocalData::forwarding_cache(Thread::current());
+  ZForwarding* forwarding = cache->get(offset);
   if (forwarding == NULL) {
-    // Not forwarding
-    return ZAddress::good(addr);
+    forwarding = _forwarding_table.get(addr);
+    if (forwarding == NULL) {
+      // Not forwarding
+      return ZAddress::good(addr);
+    }
+
+    cache->put(forwarding);
+  }
+
+  // Lookup forwarding entry. The forwarding outlives the relocate phase,
+  // so an object which has already been relocated can be forwarded without
+  // retaining the page.
+  const uintptr_t from_index = (offset - forwarding->start()) >> forwarding->object_alignment_shift();
+  const ZForwardingEntry entry = forwarding->find(from_index);
+  if (entry.populated() && entry.from_index() == from_index) {
+    // Already relocated
+    return ZAddress::good(entry.to_offset());
   }
 
   // Relocate object
@@ -129,6 +171,10 @@ inline bool ZHeap::is_alloc_stalled() const {
   return _page_allocator.is_alloc_stalled();
 }
 
+inline bool ZHeap::is_alloc_stalled_through_gc() const {
+  return _page_allocator.is_alloc_stalled_through_gc();
+}
+
 inline void ZHeap::check_out_of_memory() {
   _page_allocator.check_out_of_memory();
 }
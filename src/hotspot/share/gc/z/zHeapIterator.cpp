@@ -24,14 +24,18 @@
 #include "precompiled.hpp"
 #include "classfile/classLoaderData.hpp"
 #include "classfile/classLoaderDataGraph.hpp"
+#include "gc/shared/taskqueue.inline.hpp"
 #include "gc/z/zAddress.inline.hpp"
+#include "gc/z/zArray.inline.hpp"
 #include "gc/z/zBarrier.inline.hpp"
 #include "gc/z/zGlobals.hpp"
 #include "gc/z/zGranuleMap.inline.hpp"
 #include "gc/z/zHeapIterator.hpp"
 #include "gc/z/zOop.inline.hpp"
-#include "gc/z/zRootsIterator.hpp"
-#include "gc/z/zStat.hpp"
+#include "gc/z/zPage.inline.hpp"
+#include "gc/z/zPageTable.inline.hpp"
+#include "gc/z/zLock.inline.hpp"
+#include "gc/z/zThreadLocalAllocBuffer.hpp"
 #include "memory/iterator.inline.hpp"
 #include "utilities/bitMap.inline.hpp"
 #include "utilities/stack.inline.hpp"
@@ -45,19 +49,15 @@ public:
       _map(size_in_bits) {}
 
   bool try_set_bit(size_t index) {
-    if (_map.at(index)) {
-      return false;
-    }
-
-    _map.set_bit(index);
-    return true;
+    return _map.par_set_bit(index);
   }
 };
 
 template <bool Concurrent, bool Weak>
 class ZHeapIteratorRootOopClosure : public ZRootsIteratorClosure {
 private:
-  ZHeapIterator* const _iter;
+  ZHeapIterator* const      _iter;
+  ZHeapIteratorQueue* const _queue;
 
   oop load_oop(oop* p) {
     if (Weak) {
@@ -72,12 +72,13 @@ private:
   }
 
 public:
-  ZHeapIteratorRootOopClosure(ZHeapIterator* iter) :
-      _iter(iter) {}
+  ZHeapIteratorRootOopClosure(ZHeapIterator* iter, ZHeapIteratorQueue* queue) :
+      _iter(iter),
+      _queue(queue) {}
 
   virtual void do_oop(oop* p) {
     const oop obj = load_oop(p);
-    _iter->push(obj);
+    _iter->push(_queue, obj);
   }
 
   virtual void do_oop(narrowOop* p) {
@@ -88,8 +89,9 @@ public:
 template <bool VisitReferents>
 class ZHeapIteratorOopClosure : public ClaimMetadataVisitingOopIterateClosure {
 private:
-  ZHeapIterator* const _iter;
-  const oop            _base;
+  ZHeapIterator* const      _iter;
+  ZHeapIteratorQueue* const _queue;
+  const oop                 _base;
 
   oop load_oop(oop* p) {
     if (VisitReferents) {
@@ -100,9 +102,10 @@ private:
   }
 
 public:
-  ZHeapIteratorOopClosure(ZHeapIterator* iter, oop base) :
+  ZHeapIteratorOopClosure(ZHeapIterator* iter, ZHeapIteratorQueue* queue, oop base) :
       ClaimMetadataVisitingOopIterateClosure(ClassLoaderData::_claim_other),
       _iter(iter),
+      _queue(queue),
       _base(base) {}
 
   virtual ReferenceIterationMode reference_iteration_mode() {
@@ -111,7 +114,7 @@ public:
 
   virtual void do_oop(oop* p) {
     const oop obj = load_oop(p);
-    _iter->push(obj);
+    _iter->push(_queue, obj);
   }
 
   virtual void do_oop(narrowOop* p) {
@@ -125,15 +128,34 @@ public:
 #endif
 };
 
-ZHeapIterator::ZHeapIterator() :
-    _visit_stack(),
-    _visit_map(ZAddressOffsetMax) {}
+ZHeapIterator::ZHeapIterator(uint nworkers, bool visit_weaks) :
+    _timer_disable(),
+    _visit_weaks(visit_weaks),
+    _visit_map(ZAddressOffsetMax),
+    _visit_map_lock(),
+    _queues(nworkers),
+    _terminator(nworkers, &_queues),
+    _roots(),
+    _concurrent_roots(),
+    _weak_roots(),
+    _concurrent_weak_roots() {
+  for (uint i = 0; i < _queues.size(); i++) {
+    ZHeapIteratorQueue* const queue = new ZHeapIteratorQueue();
+    queue->initialize();
+    _queues.register_queue(i, queue);
+  }
+}
 
 ZHeapIterator::~ZHeapIterator() {
   ZVisitMapIterator iter(&_visit_map);
   for (ZHeapIteratorBitMap* map; iter.next(&map);) {
     delete map;
   }
+
+  for (uint i = 0; i < _queues.size(); i++) {
+    delete _queues.queue(i);
+  }
+
   ClassLoaderDataGraph::clear_claimed_marks(ClassLoaderData::_claim_other);
 }
 
@@ -150,16 +172,20 @@ static size_t object_index(oop obj) {
 
 ZHeapIteratorBitMap* ZHeapIterator::object_map(oop obj) {
   const uintptr_t offset = ZAddress::offset(ZOop::to_address(obj));
-  ZHeapIteratorBitMap* map = _visit_map.get(offset);
+  ZHeapIteratorBitMap* map = _visit_map.get_acquire(offset);
   if (map == NULL) {
-    map = new ZHeapIteratorBitMap(object_index_max());
-    _visit_map.put(offset, map);
+    ZLocker<ZLock> locker(&_visit_map_lock);
+    map = _visit_map.get(offset);
+    if (map == NULL) {
+      map = new ZHeapIteratorBitMap(object_index_max());
+      _visit_map.release_put(offset, map);
+    }
   }
 
   return map;
 }
 
-void ZHeapIterator::push(oop obj) {
+void ZHeapIterator::push(ZHeapIteratorQueue* queue, oop obj) {
   if (obj == NULL) {
     // Ignore
     return;
@@ -173,50 +199,112 @@ void ZHeapIterator::push(oop obj) {
   }
 
   // Push
-  _visit_stack.push(obj);
+  queue->push(obj);
 }
 
 template <typename RootsIterator, bool Concurrent, bool Weak>
-void ZHeapIterator::push_roots() {
-  ZHeapIteratorRootOopClosure<Concurrent, Weak> cl(this);
-  RootsIterator roots;
-  roots.oops_do(&cl);
+void ZHeapIterator::push_roots(RootsIterator* roots, ZHeapIteratorQueue* queue) {
+  ZHeapIteratorRootOopClosure<Concurrent, Weak> cl(this, queue);
+  roots->oops_do(&cl);
 }
 
 template <bool VisitReferents>
-void ZHeapIterator::push_fields(oop obj) {
-  ZHeapIteratorOopClosure<VisitReferents> cl(this, obj);
+void ZHeapIterator::push_fields(ZHeapIteratorQueue* queue, oop obj) {
+  ZHeapIteratorOopClosure<VisitReferents> cl(this, queue, obj);
   obj->oop_iterate(&cl);
 }
 
+template <bool VisitReferents>
+void ZHeapIterator::visit(ObjectClosure* cl, ZHeapIteratorQueue* queue, oop obj) {
+  // Visit object
+  cl->do_object(obj);
+
+  // Push fields to visit
+  push_fields<VisitReferents>(queue, obj);
+}
+
+template <bool VisitReferents>
+void ZHeapIterator::drain(ObjectClosure* cl, ZHeapIteratorQueue* queue) {
+  oop obj;
+
+  do {
+    // Drain overflow stack first, so that other workers can steal
+    // from the task queue in the meantime
+    while (queue->pop_overflow(obj)) {
+      visit<VisitReferents>(cl, queue, obj);
+    }
+
+    while (queue->pop_local(obj)) {
+      visit<VisitReferents>(cl, queue, obj);
+    }
+  } while (!queue->is_empty());
+}
+
+template <bool VisitReferents>
+bool ZHeapIterator::steal(ObjectClosure* cl, ZHeapIteratorQueue* queue, uint worker_id) {
+  oop obj;
+  if (_queues.steal(worker_id, obj)) {
+    visit<VisitReferents>(cl, queue, obj);
+    return true;
+  }
+
+  return false;
+}
+
 template <bool VisitWeaks>
-void ZHeapIterator::objects_do(ObjectClosure* cl) {
-  ZStatTimerDisable disable;
+void ZHeapIterator::object_iterate(ObjectClosure* cl, uint worker_id) {
+  ZHeapIteratorQueue* const queue = _queues.queue(worker_id);
 
   // Push roots to visit
-  push_roots<ZRootsIterator,                     false /* Concurrent */, false /* Weak */>();
-  push_roots<ZConcurrentRootsIteratorClaimOther, true  /* Concurrent */, false /* Weak */>();
+  push_roots<ZRootsIterator,                     false /* Concurrent */, false /* Weak */>(&_roots, queue);
+  push_roots<ZConcurrentRootsIteratorClaimOther, true  /* Concurrent */, false /* Weak */>(&_concurrent_roots, queue);
   if (VisitWeaks) {
-    push_roots<ZWeakRootsIterator,           false /* Concurrent */, true  /* Weak */>();
-    push_roots<ZConcurrentWeakRootsIterator, true  /* Concurrent */, true  /* Weak */>();
+    push_roots<ZWeakRootsIterator,           false /* Concurrent */, true  /* Weak */>(&_weak_roots, queue);
+    push_roots<ZConcurrentWeakRootsIterator, true  /* Concurrent */, true  /* Weak */>(&_concurrent_weak_roots, queue);
   }
 
-  // Drain stack
-  while (!_visit_stack.is_empty()) {
-    const oop obj = _visit_stack.pop();
+  // Drain own queue, steal from other queues, and terminate when
+  // all queues are empty
+  do {
+    drain<VisitWeaks>(cl, queue);
+  } while (steal<VisitWeaks>(cl, queue, worker_id) ||
+           !_terminator.terminator()->offer_termination());
+}
 
-    // Visit object
-    cl->do_object(obj);
+void ZHeapIterator::object_iterate(ObjectClosure* cl, uint worker_id) {
+  ZStatTimerDisable disable;
 
-    // Push fields to visit
-    push_fields<VisitWeaks>(obj);
+  if (_visit_weaks) {
+    object_iterate<true /* VisitWeaks */>(cl, worker_id);
+  } else {
+    object_iterate<false /* VisitWeaks */>(cl, worker_id);
   }
 }
 
-void ZHeapIterator::objects_do(ObjectClosure* cl, bool visit_weaks) {
-  if (visit_weaks) {
-    objects_do<true /* VisitWeaks */>(cl);
-  } else {
-    objects_do<false /* VisitWeaks */>(cl);
+ZHeapLiveMapIterator::ZHeapLiveMapIterator(const ZPageTable* page_table) :
+    _pages(),
+    _iter(&_pages) {
+  // Collect pages marked by the last marking, and pages with TLABs kept
+  // across the last mark start. Pages allocated since the last mark start
+  // have no live map.
+  ZPageTableIterator iter(page_table);
+  for (ZPage* page; iter.next(&page);) {
+    if (!page->is_allocating() && (page->is_marked() || page->has_kept_tlab())) {
+      _pages.add(page);
+    }
+  }
+}
+
+void ZHeapLiveMapIterator::object_iterate(ObjectClosure* cl, uint worker_id) {
+  for (ZPage* page; _iter.next(&page);) {
+    if (page->is_marked()) {
+      page->object_iterate(cl);
+    }
+
+    if (page->has_kept_tlab()) {
+      // Objects allocated in a TLAB kept across mark start
+      // are implicitly live, and not in the live map
+      ZThreadLocalAllocBuffer::kept_object_iterate(page, cl);
+    }
   }
 }
@@ -24,37 +24,71 @@
 #ifndef SHARE_GC_Z_ZHEAPITERATOR_HPP
 #define SHARE_GC_Z_ZHEAPITERATOR_HPP
 
+#include "gc/shared/collectedHeap.hpp"
+#include "gc/shared/taskqueue.hpp"
+#include "gc/z/zArray.hpp"
 #include "gc/z/zGranuleMap.hpp"
-#include "memory/allocation.hpp"
-#include "utilities/stack.hpp"
+#include "gc/z/zLock.hpp"
+#include "gc/z/zRootsIterator.hpp"
+#include "gc/z/zStat.hpp"
 
 class ObjectClosure;
 class ZHeapIteratorBitMap;
+class ZPage;
+class ZPageTable;
 
-class ZHeapIterator : public StackObj {
+typedef OverflowTaskQueue<oop, mtGC>                  ZHeapIteratorQueue;
+typedef GenericTaskQueueSet<ZHeapIteratorQueue, mtGC> ZHeapIteratorQueues;
+
+class ZHeapIterator : public ParallelObjectIterator {
   template<bool Concurrent, bool Weak> friend class ZHeapIteratorRootOopClosure;
   template<bool VisitReferents> friend class ZHeapIteratorOopClosure;
 
 private:
   typedef ZGranuleMap<ZHeapIteratorBitMap*>         ZVisitMap;
   typedef ZGranuleMapIterator<ZHeapIteratorBitMap*> ZVisitMapIterator;
-  typedef Stack<oop, mtGC>                          ZVisitStack;
 
-  ZVisitStack _visit_stack;
-  ZVisitMap   _visit_map;
+  ZStatTimerDisable                  _timer_disable;
+  const bool                         _visit_weaks;
+  ZVisitMap                          _visit_map;
+  ZLock                              _visit_map_lock;
+  ZHeapIteratorQueues                _queues;
+  TaskTerminator                     _terminator;
+  ZRootsIterator                     _roots;
+  ZConcurrentRootsIteratorClaimOther _concurrent_roots;
+  ZWeakRootsIterator                 _weak_roots;
+  ZConcurrentWeakRootsIterator       _concurrent_weak_roots;
 
   ZHeapIteratorBitMap* object_map(oop obj);
-  void push(oop obj);
+  void push(ZHeapIteratorQueue* queue, oop obj);
+
+  template <typename RootsIterator, bool Concurrent, bool Weak> void push_roots(RootsIterator* roots, ZHeapIteratorQueue* queue);
+  template <bool VisitReferents> void push_fields(ZHeapIteratorQueue* queue, oop obj);
+  template <bool VisitReferents> void visit(ObjectClosure* cl, ZHeapIteratorQueue* queue, oop obj);
+  template <bool VisitReferents> void drain(ObjectClosure* cl, ZHeapIteratorQueue* queue);
+  template <bool VisitReferents> bool steal(ObjectClosure* cl, ZHeapIteratorQueue* queue, uint worker_id);
+  template <bool VisitWeaks> void object_iterate(ObjectClosure* cl, uint worker_id);
+
+public:
+  ZHeapIterator(uint nworkers, bool visit_weaks);
+  virtual ~ZHeapIterator();
 
-  template <typename RootsIterator, bool Concurrent, bool Weak> void push_roots();
-  template <bool VisitReferents> void push_fields(oop obj);
-  template <bool VisitReferents> void objects_do(ObjectClosure* cl);
+  virtual void object_iterate(ObjectClosure* cl, uint worker_id);
+};
+
+// Visits the objects found live by the last marking, by walking the live
+// maps of the pages marked, without tracing the object graph. Objects
+// allocated in TLABs kept across the last mark start are also visited.
+// Other objects allocated since the last mark start are not visited.
+class ZHeapLiveMapIterator : public ParallelObjectIterator {
+private:
+  ZArray<ZPage*>                 _pages;
+  ZArrayParallelIterator<ZPage*> _iter;
 
 public:
-  ZHeapIterator();
-  ~ZHeapIterator();
+  ZHeapLiveMapIterator(const ZPageTable* page_table);
 
-  void objects_do(ObjectClosure* cl, bool visit_weaks);
+  virtual void object_iterate(ObjectClosure* cl, uint worker_id);
 };
 
 #endif // SHARE_GC_Z_ZHEAPITERATOR_HPP
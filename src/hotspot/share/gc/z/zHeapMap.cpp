@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zGlobals.hpp"
+#include "gc/z/zHeapMap.hpp"
+#include "gc/z/zNUMA.hpp"
+#include "gc/z/zPage.inline.hpp"
+#include "gc/z/zPageAllocator.hpp"
+#include "gc/z/zPageTable.inline.hpp"
+#include "memory/resourceArea.hpp"
+#include "utilities/globalDefinitions.hpp"
+#include "utilities/ostream.hpp"
+
+static const size_t ZHeapMapOccupancyBuckets = 10;
+static const size_t ZHeapMapAgeBuckets       = 8;
+
+class ZHeapMapPageStats {
+private:
+  size_t  _npages;
+  size_t  _size;
+  size_t  _nallocating;
+  size_t  _nunmarked;
+  size_t  _live;
+  size_t  _occupancy[ZHeapMapOccupancyBuckets];
+  size_t  _age[ZHeapMapAgeBuckets];
+  size_t* _numa;
+
+public:
+  ZHeapMapPageStats() :
+      _npages(0),
+      _size(0),
+      _nallocating(0),
+      _nunmarked(0),
+      _live(0),
+      _numa(NEW_RESOURCE_ARRAY(size_t, ZNUMA::count())) {
+    for (size_t i = 0; i < ZHeapMapOccupancyBuckets; i++) {
+      _occupancy[i] = 0;
+    }
+
+    for (size_t i = 0; i < ZHeapMapAgeBuckets; i++) {
+      _age[i] = 0;
+    }
+
+    for (uint32_t i = 0; i < ZNUMA::count(); i++) {
+      _numa[i] = 0;
+    }
+  }
+
+  void add(ZPage* page) {
+    _npages++;
+    _size += page->size();
+    _numa[page->numa_id()]++;
+
+    if (page->is_allocating()) {
+      // Allocated after the last mark started
+      _nallocating++;
+      _age[0]++;
+      return;
+    }
+
+    _age[MIN2((size_t)page->age(), ZHeapMapAgeBuckets - 1)]++;
+
+    if (!page->is_marked()) {
+      // Not marked in the last mark
+      _nunmarked++;
+      return;
+    }
+
+    const size_t live = page->live_bytes();
+    const size_t bucket = live * ZHeapMapOccupancyBuckets / page->size();
+    _live += live;
+    _occupancy[MIN2(bucket, ZHeapMapOccupancyBuckets - 1)]++;
+  }
+
+  void print_on(outputStream* st, const char* type) const {
+    st->print_cr(" %s Pages: " SIZE_FORMAT " (" SIZE_FORMAT "M), Live " SIZE_FORMAT "M, "
+                 "Allocating " SIZE_FORMAT ", Not Marked " SIZE_FORMAT,
+                 type, _npages, _size / M, _live / M, _nallocating, _nunmarked);
+    if (_npages == 0) {
+      return;
+    }
+
+    st->print("   Occupancy:");
+    for (size_t i = 0; i < ZHeapMapOccupancyBuckets; i++) {
+      st->print(" " SIZE_FORMAT "-" SIZE_FORMAT "%%: " SIZE_FORMAT, i * 10, i * 10 + 9, _occupancy[i]);
+    }
+    st->cr();
+
+    st->print("   Age:");
+    for (size_t i = 0; i < ZHeapMapAgeBuckets; i++) {
+      st->print(" " SIZE_FORMAT "%s: " SIZE_FORMAT, i, (i == ZHeapMapAgeBuckets - 1) ? "+" : "", _age[i]);
+    }
+    st->cr();
+
+    st->print("   NUMA:");
+    for (uint32_t i = 0; i < ZNUMA::count(); i++) {
+      st->print(" %u: " SIZE_FORMAT, i, _numa[i]);
+    }
+    st->cr();
+  }
+};
+
+class ZHeapMapCacheClosure : public ZPageClosure {
+private:
+  size_t _npages[3];
+  size_t _size[3];
+  size_t _nzeroed;
+  size_t _zeroed;
+
+public:
+  ZHeapMapCacheClosure() :
+      _nzeroed(0),
+      _zeroed(0) {
+    for (size_t i = 0; i < ARRAY_SIZE(_npages); i++) {
+      _npages[i] = 0;
+      _size[i] = 0;
+    }
+  }
+
+  virtual void do_page(const ZPage* page) {
+    if (page->is_zeroed()) {
+      _nzeroed++;
+      _zeroed += page->size();
+    } else {
+      _npages[page->type()]++;
+      _size[page->type()] += page->size();
+    }
+  }
+
+  void print_on(outputStream* st) const {
+    st->print_cr(" Page Cache: Small " SIZE_FORMAT " (" SIZE_FORMAT "M), Medium " SIZE_FORMAT " (" SIZE_FORMAT "M), "
+                 "Large " SIZE_FORMAT " (" SIZE_FORMAT "M), Zeroed " SIZE_FORMAT " (" SIZE_FORMAT "M)",
+                 _npages[ZPageTypeSmall], _size[ZPageTypeSmall] / M,
+                 _npages[ZPageTypeMedium], _size[ZPageTypeMedium] / M,
+                 _npages[ZPageTypeLarge], _size[ZPageTypeLarge] / M,
+                 _nzeroed, _zeroed / M);
+  }
+};
+
+ZHeapMap::ZHeapMap(ZPageTable* page_table, ZPageAllocator* page_allocator) :
+    _page_table(page_table),
+    _page_allocator(page_allocator) {}
+
+void ZHeapMap::print_pages_on(outputStream* st) {
+  ZHeapMapPageStats small;
+  ZHeapMapPageStats medium;
+  ZHeapMapPageStats large;
+
+  // Do not allow pages to be deleted
+  _page_allocator->enable_deferred_delete();
+
+  ZPageTableIterator iter(_page_table);
+  for (ZPage* page; iter.next(&page);) {
+    if (page->type() == ZPageTypeSmall) {
+      small.add(page);
+    } else if (page->type() == ZPageTypeMedium) {
+      medium.add(page);
+    } else {
+      large.add(page);
+    }
+  }
+
+  // Allow pages to be deleted
+  _page_allocator->disable_deferred_delete();
+
+  small.print_on(st, "Small");
+  medium.print_on(st, "Medium");
+  large.print_on(st, "Large");
+}
+
+void ZHeapMap::print_cache_on(outputStream* st) {
+  ZHeapMapCacheClosure cl;
+  _page_allocator->cache_pages_do(&cl);
+  cl.print_on(st);
+}
+
+void ZHeapMap::print_address_space_on(outputStream* st) {
+  size_t nareas = 0;
+  size_t size = 0;
+  size_t largest = 0;
+  _page_allocator->virtual_free_stats(&nareas, &size, &largest);
+
+  st->print_cr(" Address Space: Free " SIZE_FORMAT "M in " SIZE_FORMAT " areas, Largest " SIZE_FORMAT "M",
+               size / M, nareas, largest / M);
+}
+
+void ZHeapMap::print_on(outputStream* st) {
+  ResourceMark rm;
+
+  st->print_cr("ZGC Heap Map");
+  print_pages_on(st);
+  print_cache_on(st);
+  print_address_space_on(st);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZHEAPMAP_HPP
+#define SHARE_GC_Z_ZHEAPMAP_HPP
+
+#include "memory/allocation.hpp"
+
+class outputStream;
+class ZPage;
+class ZPageAllocator;
+class ZPageTable;
+
+// Summary of the heap layout, meant to help understand heap and
+// address space fragmentation. The summary is collected without a
+// safepoint, so it's only an approximation of the current state.
+class ZHeapMap : public StackObj {
+private:
+  ZPageTable* const     _page_table;
+  ZPageAllocator* const _page_allocator;
+
+  void print_pages_on(outputStream* st);
+  void print_cache_on(outputStream* st);
+  void print_address_space_on(outputStream* st);
+
+public:
+  ZHeapMap(ZPageTable* page_table, ZPageAllocator* page_allocator);
+
+  void print_on(outputStream* st);
+};
+
+#endif // SHARE_GC_Z_ZHEAPMAP_HPP
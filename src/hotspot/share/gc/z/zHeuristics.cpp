@@ -23,21 +23,34 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zCPU.inline.hpp"
+#include "gc/z/zCPUQuota.hpp"
 #include "gc/z/zGlobals.hpp"
 #include "gc/z/zHeuristics.hpp"
+#include "gc/z/zWorkers.hpp"
 #include "logging/log.hpp"
 #include "runtime/globals.hpp"
-#include "runtime/os.hpp"
+#include "utilities/align.hpp"
 #include "utilities/powerOfTwo.hpp"
 
+void ZHeuristics::set_small_object_size_limit() {
+  // ZObjectSizeLimitSmall is by default 12.5% of the small page size, which
+  // bounds the space wasted at the end of a small page. A higher limit keeps
+  // more objects on small pages, at the cost of more waste per page.
+  if (ZSmallObjectSizeLimit != 0) {
+    ZObjectSizeLimitSmall = align_up(ZSmallObjectSizeLimit, ZObjectAlignmentSmall);
+  }
+
+  log_info(gc, init)("Small Object Size Limit: " SIZE_FORMAT "K", ZObjectSizeLimitSmall / K);
+}
+
 void ZHeuristics::set_medium_page_size() {
   // Set ZPageSizeMedium so that a medium page occupies at most 3.125% of the
-  // max heap size. ZPageSizeMedium is initially set to 0, which means medium
-  // pages are effectively disabled. It is adjusted only if ZPageSizeMedium
-  // becomes larger than ZPageSizeSmall.
+  // max heap size, or to ZMediumPageSize if set. ZPageSizeMedium is initially
+  // set to 0, which means medium pages are effectively disabled. It is
+  // adjusted only if ZPageSizeMedium becomes larger than ZPageSizeSmall.
   const size_t min = ZGranuleSize;
   const size_t max = ZGranuleSize * 16;
-  const size_t unclamped = MaxHeapSize * 0.03125;
+  const size_t unclamped = ZMediumPageSize != 0 ? ZMediumPageSize : MaxHeapSize * 0.03125;
   const size_t clamped = MIN2(MAX2(min, unclamped), max);
   const size_t size = round_down_power_of_2(clamped);
 
@@ -63,8 +76,40 @@ bool ZHeuristics::use_per_cpu_shared_small_pages() {
   return per_cpu_share >= ZPageSizeSmall;
 }
 
+bool ZHeuristics::use_per_cpu_shared_medium_pages() {
+  // Use per-CPU shared medium pages only if these pages occupy at most
+  // 3.125% of the max heap size, like per-CPU shared small pages. Since
+  // a medium page is itself up to 3.125% of the max heap size, this only
+  // happens with large heaps. Otherwise fall back to using per-NUMA node
+  // shared medium pages.
+  if (ZPageSizeMedium == 0) {
+    // Medium pages disabled
+    return false;
+  }
+
+  const size_t per_cpu_share = (MaxHeapSize * 0.03125) / ZCPU::count();
+  return per_cpu_share >= ZPageSizeMedium;
+}
+
+bool ZHeuristics::use_per_worker_medium_pages() {
+  // Use per-worker medium pages for relocation only if these pages occupy
+  // at most 3.125% of the max heap size, like per-CPU shared medium pages.
+  // Otherwise fall back to relocating medium objects to the shared medium
+  // pages.
+  if (ZPageSizeMedium == 0) {
+    // Medium pages disabled
+    return false;
+  }
+
+  const size_t per_worker_share = (MaxHeapSize * 0.03125) / ZWorkers::nworkers_max();
+  return per_worker_share >= ZPageSizeMedium;
+}
+
 static uint nworkers_based_on_ncpus(double cpu_share_in_percent) {
-  return ceil(os::initial_active_processor_count() * cpu_share_in_percent / 100.0);
+  // Base the number of workers on the CPU quota, if any, rather than on the
+  // number of processors, since workers sized for the whole machine would
+  // quickly exhaust the quota and get the whole process throttled.
+  return ceil(ZCPUQuota::ncpus() * cpu_share_in_percent / 100.0);
 }
 
 static uint nworkers_based_on_heap_size(double reserve_share_in_percent) {
@@ -28,9 +28,12 @@
 
 class ZHeuristics : public AllStatic {
 public:
+  static void set_small_object_size_limit();
   static void set_medium_page_size();
 
   static bool use_per_cpu_shared_small_pages();
+  static bool use_per_cpu_shared_medium_pages();
+  static bool use_per_worker_medium_pages();
 
   static uint nparallel_workers();
   static uint nconcurrent_workers();
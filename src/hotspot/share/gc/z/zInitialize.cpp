@@ -24,14 +24,21 @@
 #include "precompiled.hpp"
 #include "gc/z/zAddress.hpp"
 #include "gc/z/zBarrierSet.hpp"
+#include "gc/z/zClassProfile.hpp"
 #include "gc/z/zCPU.hpp"
+#include "gc/z/zForwardingSpace.hpp"
 #include "gc/z/zGlobals.hpp"
 #include "gc/z/zHeuristics.hpp"
 #include "gc/z/zInitialize.hpp"
 #include "gc/z/zLargePages.hpp"
+#include "gc/z/zLiveMapPool.hpp"
+#include "gc/z/zMemoryPressure.hpp"
 #include "gc/z/zNUMA.hpp"
+#include "gc/z/zPageHotness.hpp"
+#include "gc/z/zPartition.hpp"
 #include "gc/z/zStat.hpp"
 #include "gc/z/zThreadLocalAllocBuffer.hpp"
+#include "gc/z/zThreadPolicy.hpp"
 #include "gc/z/zTracer.hpp"
 #include "logging/log.hpp"
 #include "runtime/vm_version.hpp"
@@ -50,6 +57,14 @@ ZInitialize::ZInitialize(ZBarrierSet* barrier_set) {
   ZThreadLocalAllocBuffer::initialize();
   ZTracer::initialize();
   ZLargePages::initialize();
+  ZForwardingSpace::initialize();
+  ZLiveMapPool::initialize();
+  ZMemoryPressure::initialize();
+  ZPageHotness::initialize();
+  ZThreadPolicy::initialize();
+  ZPartitions::initialize();
+  ZClassProfile::initialize();
+  ZHeuristics::set_small_object_size_limit();
   ZHeuristics::set_medium_page_size();
   ZBarrierSet::set_barrier_set(barrier_set);
 
@@ -44,6 +44,7 @@ public:
   static bool is_enabled();
   static bool is_explicit();
   static bool is_transparent();
+  static bool is_enabled_for_metadata();
 
   static const char* to_string();
 };
@@ -25,6 +25,7 @@
 #define SHARE_GC_Z_ZLARGEPAGES_INLINE_HPP
 
 #include "gc/z/zLargePages.hpp"
+#include "runtime/globals.hpp"
 
 inline bool ZLargePages::is_enabled() {
   return _state != Disabled;
@@ -38,4 +39,10 @@ inline bool ZLargePages::is_transparent() {
   return _state == Transparent;
 }
 
+inline bool ZLargePages::is_enabled_for_metadata() {
+  // Metadata is committed incrementally, which only transparent
+  // huge pages support
+  return ZLargePagesForMetadata && is_transparent();
+}
+
 #endif // SHARE_GC_Z_ZLARGEPAGES_INLINE_HPP
@@ -24,6 +24,7 @@
 #include "precompiled.hpp"
 #include "gc/z/zHeap.inline.hpp"
 #include "gc/z/zLiveMap.inline.hpp"
+#include "gc/z/zLiveMapPool.hpp"
 #include "gc/z/zStat.hpp"
 #include "gc/z/zThread.inline.hpp"
 #include "logging/log.hpp"
@@ -44,9 +45,27 @@ ZLiveMap::ZLiveMap(uint32_t size) :
     _live_bytes(0),
     _segment_live_bits(0),
     _segment_claim_bits(0),
-    _bitmap(bitmap_size(size, nsegments)),
+    _bitmap(),
+    _bitmap_size(bitmap_size(size, nsegments)),
     _segment_shift(exact_log2(segment_size())) {}
 
+ZLiveMap::~ZLiveMap() {
+  free_bitmap();
+}
+
+void ZLiveMap::alloc_bitmap() {
+  // The bitmap is not cleared, segments are cleared when first marked
+  const size_t nwords = BitMap::calc_size_in_words(_bitmap_size);
+  _bitmap.attach(ZLiveMapPool::alloc(nwords), _bitmap_size);
+}
+
+void ZLiveMap::free_bitmap() {
+  if (_bitmap.is_attached()) {
+    const size_t nwords = BitMap::calc_size_in_words(_bitmap.size());
+    ZLiveMapPool::free(_bitmap.detach(), nwords);
+  }
+}
+
 void ZLiveMap::reset(size_t index) {
   const uint32_t seqnum_initializing = (uint32_t)-1;
   bool contention = false;
@@ -58,6 +77,12 @@ void ZLiveMap::reset(size_t index) {
        seqnum = Atomic::load_acquire(&_seqnum)) {
     if ((seqnum != seqnum_initializing) &&
         (Atomic::cmpxchg(&_seqnum, seqnum, seqnum_initializing) == seqnum)) {
+      // Allocate bitmap storage on first mark, since pages that
+      // are never marked, such as allocating pages, don't need it
+      if (!_bitmap.is_attached()) {
+        alloc_bitmap();
+      }
+
       // Reset marking information
       _live_bytes = 0;
       _live_objects = 0;
@@ -125,8 +150,19 @@ void ZLiveMap::reset_segment(BitMap::idx_t segment) {
 
 void ZLiveMap::resize(uint32_t size) {
   const size_t new_bitmap_size = bitmap_size(size, nsegments);
-  if (_bitmap.size() != new_bitmap_size) {
-    _bitmap.reinitialize(new_bitmap_size, false /* clear */);
+  if (_bitmap_size != new_bitmap_size) {
+    // Storage of the old size is given back, and new
+    // storage is allocated when the page is next marked
+    free_bitmap();
+    _seqnum = 0;
+    _bitmap_size = new_bitmap_size;
     _segment_shift = exact_log2(segment_size());
   }
 }
+
+void ZLiveMap::release() {
+  // Give the bitmap storage back to the pool. The page is no longer
+  // marked, so the storage is not accessed again until it's reallocated.
+  free_bitmap();
+  _seqnum = 0;
+}
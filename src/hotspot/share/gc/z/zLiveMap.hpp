@@ -30,17 +30,20 @@
 class ObjectClosure;
 
 class ZLiveMap {
+  friend class VMStructs;
   friend class ZLiveMapTest;
 
-private:
+public:
   static const size_t nsegments = 64;
 
+private:
   volatile uint32_t _seqnum;
   volatile uint32_t _live_objects;
   volatile size_t   _live_bytes;
   BitMap::bm_word_t _segment_live_bits;
   BitMap::bm_word_t _segment_claim_bits;
   ZBitMap           _bitmap;
+  size_t            _bitmap_size;
   size_t            _segment_shift;
 
   const BitMapView segment_live_bits() const;
@@ -63,16 +66,23 @@ private:
 
   bool claim_segment(BitMap::idx_t segment);
 
+  void alloc_bitmap();
+  void free_bitmap();
+
   void reset(size_t index);
   void reset_segment(BitMap::idx_t segment);
 
+  BitMap::idx_t object_end(BitMap::idx_t index) const;
+
   void iterate_segment(ObjectClosure* cl, BitMap::idx_t segment, uintptr_t page_start, size_t page_object_alignment_shift);
 
 public:
   ZLiveMap(uint32_t size);
+  ~ZLiveMap();
 
   void reset();
   void resize(uint32_t size);
+  void release();
 
   bool is_marked() const;
 
@@ -81,10 +91,15 @@ public:
 
   bool get(size_t index) const;
   bool set(size_t index, bool finalizable, bool& inc_live);
+  void set_end(size_t index, size_t end_index);
+  void prefetch(size_t index) const;
+
+  size_t object_size(size_t index, size_t page_object_alignment_shift) const;
 
   void inc_live(uint32_t objects, size_t bytes);
 
   void iterate(ObjectClosure* cl, uintptr_t page_start, size_t page_object_alignment_shift);
+  void iterate(ObjectClosure* cl, BitMap::idx_t segment, uintptr_t page_start, size_t page_object_alignment_shift);
 };
 
 #endif // SHARE_GC_Z_ZLIVEMAP_HPP
@@ -28,9 +28,11 @@
 #include "gc/z/zLiveMap.hpp"
 #include "gc/z/zMark.hpp"
 #include "gc/z/zOop.inline.hpp"
-#include "gc/z/zUtils.inline.hpp"
+#include "memory/iterator.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/prefetch.inline.hpp"
 #include "utilities/bitMap.inline.hpp"
+#include "utilities/count_trailing_zeros.hpp"
 #include "utilities/debug.hpp"
 
 inline void ZLiveMap::reset() {
@@ -88,7 +90,7 @@ inline BitMap::idx_t ZLiveMap::next_live_segment(BitMap::idx_t segment) const {
 }
 
 inline BitMap::idx_t ZLiveMap::segment_size() const {
-  return _bitmap.size() / nsegments;
+  return _bitmap_size / nsegments;
 }
 
 inline BitMap::idx_t ZLiveMap::index_to_segment(BitMap::idx_t index) const {
@@ -119,6 +121,46 @@ inline bool ZLiveMap::set(size_t index, bool finalizable, bool& inc_live) {
   return _bitmap.par_set_bit_pair(index, finalizable, inc_live);
 }
 
+inline void ZLiveMap::set_end(size_t index, size_t end_index) {
+  assert(is_marked(), "Should be marked");
+  assert((index & 1) == 0 && (end_index & 1) == 1, "Invalid index");
+  assert(end_index > index + 1, "Invalid index");
+
+  // The object can span several segments. Reset all segments covered by
+  // the object, so that looking up the object end never sees stale bits.
+  const BitMap::idx_t end_segment = index_to_segment(end_index);
+  for (BitMap::idx_t segment = index_to_segment(index) + 1; segment <= end_segment; segment++) {
+    if (!is_segment_live(segment)) {
+      reset_segment(segment);
+    }
+  }
+
+  // An object end is recorded by setting the strong bit, but not the
+  // final bit, of the last alignment unit covered by the object. Since
+  // marking an object always sets the final bit, this can never be
+  // confused with the start of an object. Like the mark bits, the end bit
+  // is set with relaxed ordering.
+  _bitmap.par_set_bit(end_index, memory_order_relaxed);
+}
+
+inline BitMap::idx_t ZLiveMap::object_end(BitMap::idx_t index) const {
+  const BitMap::idx_t end_index = _bitmap.get_next_one_offset(index + 2, _bitmap.size());
+  assert((end_index & 1) == 1, "Invalid object end");
+  return end_index;
+}
+
+inline size_t ZLiveMap::object_size(size_t index, size_t page_object_alignment_shift) const {
+  const size_t nunits = (object_end(index) + 1 - index) / 2;
+  return nunits << page_object_alignment_shift;
+}
+
+inline void ZLiveMap::prefetch(size_t index) const {
+  // The bitmap storage is only guaranteed to be allocated once marked
+  if (is_marked()) {
+    _bitmap.prefetch(index);
+  }
+}
+
 inline void ZLiveMap::inc_live(uint32_t objects, size_t bytes) {
   Atomic::add(&_live_objects, objects);
   Atomic::add(&_live_bytes, bytes);
@@ -135,27 +177,42 @@ inline BitMap::idx_t ZLiveMap::segment_end(BitMap::idx_t segment) const {
 inline void ZLiveMap::iterate_segment(ObjectClosure* cl, BitMap::idx_t segment, uintptr_t page_start, size_t page_object_alignment_shift) {
   assert(is_segment_live(segment), "Must be");
 
+  // Every marked object has its first bit set. The second bits, which
+  // are strong marks or recorded object ends, are masked out. This finds
+  // all objects in a bitmap word without looking up any object sizes.
+  const BitMap::bm_word_t object_bits = (BitMap::bm_word_t)UCONST64(0x5555555555555555);
   const BitMap::idx_t start_index = segment_start(segment);
   const BitMap::idx_t end_index   = segment_end(segment);
-  BitMap::idx_t index = _bitmap.get_next_one_offset(start_index, end_index);
-
-  while (index < end_index) {
-    // Calculate object address
-    const uintptr_t addr = page_start + ((index / 2) << page_object_alignment_shift);
-
-    // Apply closure
-    cl->do_object(ZOop::from_address(addr));
-
-    // Find next bit after this object
-    const size_t size = ZUtils::object_size(addr);
-    const uintptr_t next_addr = align_up(addr + size, 1 << page_object_alignment_shift);
-    const BitMap::idx_t next_index = ((next_addr - page_start) >> page_object_alignment_shift) * 2;
-    if (next_index >= end_index) {
-      // End of live map
-      break;
+
+  for (BitMap::idx_t index = align_down(start_index, BitsPerWord); index < end_index; index += BitsPerWord) {
+    BitMap::bm_word_t word = _bitmap.word(index) & object_bits;
+
+    // Segments can be smaller than a word
+    if (index < start_index) {
+      word &= ~right_n_bits(start_index - index);
+    }
+    if (end_index - index < (BitMap::idx_t)BitsPerWord) {
+      word &= right_n_bits(end_index - index);
+    }
+
+    // Collect the addresses of the objects in this word
+    uintptr_t addrs[BitsPerWord / 2];
+    size_t naddrs = 0;
+    while (word != 0) {
+      const BitMap::idx_t bit = index + count_trailing_zeros(word);
+      addrs[naddrs++] = page_start + ((bit / 2) << page_object_alignment_shift);
+      word &= word - 1;
     }
 
-    index = _bitmap.get_next_one_offset(next_index, end_index);
+    // Apply closure, prefetching the next object. The closure might
+    // overwrite the object if it's being relocated in-place, but never
+    // an object that comes later in the live map.
+    for (size_t i = 0; i < naddrs; i++) {
+      if (i + 1 < naddrs) {
+        Prefetch::read((void*)addrs[i + 1], 0);
+      }
+      cl->do_object(ZOop::from_address(addrs[i]));
+    }
   }
 }
 
@@ -168,4 +225,12 @@ inline void ZLiveMap::iterate(ObjectClosure* cl, uintptr_t page_start, size_t pa
   }
 }
 
+inline void ZLiveMap::iterate(ObjectClosure* cl, BitMap::idx_t segment, uintptr_t page_start, size_t page_object_alignment_shift) {
+  assert(segment < nsegments, "Invalid segment");
+
+  if (is_marked() && is_segment_live(segment)) {
+    iterate_segment(cl, segment, page_start, page_object_alignment_shift);
+  }
+}
+
 #endif // SHARE_GC_Z_ZLIVEMAP_INLINE_HPP
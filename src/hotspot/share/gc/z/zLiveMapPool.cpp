@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zLiveMapPool.hpp"
+#include "gc/z/zLock.inline.hpp"
+#include "gc/z/zStat.hpp"
+#include "logging/log.hpp"
+#include "memory/allocation.inline.hpp"
+#include "utilities/debug.hpp"
+
+static const ZStatCounter ZCounterLiveMapPoolHit("Memory", "Live Map Pool Hit", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterLiveMapPoolMiss("Memory", "Live Map Pool Miss", ZStatUnitOpsPerSecond);
+
+ZLock*                  ZLiveMapPool::_lock    = NULL;
+ZLiveMapPool::ZBucket*  ZLiveMapPool::_buckets = NULL;
+
+void ZLiveMapPool::initialize() {
+  assert(_lock == NULL, "Already initialized");
+  _lock = new ZLock();
+  _buckets = NEW_C_HEAP_ARRAY(ZBucket, nbuckets, mtGC);
+  for (size_t i = 0; i < nbuckets; i++) {
+    _buckets[i]._nwords = 0;
+    _buckets[i]._first = NULL;
+    _buckets[i]._cached = 0;
+    _buckets[i]._demand = 0;
+  }
+}
+
+ZLiveMapPool::ZBucket* ZLiveMapPool::bucket(size_t nwords) {
+  // There is one live map size per page type, so a few buckets are
+  // enough. Buckets are claimed by the first size that needs one.
+  for (size_t i = 0; i < nbuckets; i++) {
+    ZBucket* const bucket = &_buckets[i];
+    if (bucket->_nwords == nwords) {
+      return bucket;
+    }
+
+    if (bucket->_nwords == 0) {
+      bucket->_nwords = nwords;
+      return bucket;
+    }
+  }
+
+  // Not pooled
+  return NULL;
+}
+
+BitMap::bm_word_t* ZLiveMapPool::alloc(size_t nwords) {
+  assert(nwords * sizeof(BitMap::bm_word_t) >= sizeof(ZEntry), "Too small");
+
+  if (_lock != NULL) {
+    ZLocker<ZLock> locker(_lock);
+    ZBucket* const bucket = ZLiveMapPool::bucket(nwords);
+    if (bucket != NULL) {
+      bucket->_demand++;
+
+      ZEntry* const entry = bucket->_first;
+      if (entry != NULL) {
+        bucket->_first = entry->_next;
+        bucket->_cached--;
+        ZStatInc(ZCounterLiveMapPoolHit);
+        return (BitMap::bm_word_t*)entry;
+      }
+    }
+  }
+
+  ZStatInc(ZCounterLiveMapPoolMiss);
+  return NEW_C_HEAP_ARRAY(BitMap::bm_word_t, nwords, mtGC);
+}
+
+void ZLiveMapPool::free(BitMap::bm_word_t* map, size_t nwords) {
+  if (_lock != NULL) {
+    ZLocker<ZLock> locker(_lock);
+    ZBucket* const bucket = ZLiveMapPool::bucket(nwords);
+    if (bucket != NULL) {
+      ZEntry* const entry = (ZEntry*)map;
+      entry->_next = bucket->_first;
+      bucket->_first = entry;
+      bucket->_cached++;
+      return;
+    }
+  }
+
+  FREE_C_HEAP_ARRAY(BitMap::bm_word_t, map);
+}
+
+void ZLiveMapPool::trim() {
+  ZEntry* excess = NULL;
+  size_t nexcess = 0;
+
+  {
+    // Keep as much storage as marking used during this cycle,
+    // and detach the rest, to be freed outside of the lock.
+    ZLocker<ZLock> locker(_lock);
+    for (size_t i = 0; i < nbuckets; i++) {
+      ZBucket* const bucket = &_buckets[i];
+      while (bucket->_cached > bucket->_demand) {
+        ZEntry* const entry = bucket->_first;
+        bucket->_first = entry->_next;
+        bucket->_cached--;
+        entry->_next = excess;
+        excess = entry;
+        nexcess++;
+      }
+
+      bucket->_demand = 0;
+    }
+  }
+
+  while (excess != NULL) {
+    ZEntry* const entry = excess;
+    excess = entry->_next;
+    FREE_C_HEAP_ARRAY(BitMap::bm_word_t, entry);
+  }
+
+  log_debug(gc, heap)("Live Map Pool Trimmed: " SIZE_FORMAT " maps", nexcess);
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZLIVEMAPPOOL_HPP
+#define SHARE_GC_Z_ZLIVEMAPPOOL_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/bitMap.hpp"
+
+class ZLock;
+
+// Pool of live map bitmap storage. Live maps take their storage from the
+// pool when a page is first marked, and give it back when the page is
+// freed. Storage is pooled per size, and the pool is trimmed once per
+// cycle to what marking used during that cycle.
+class ZLiveMapPool : public AllStatic {
+private:
+  struct ZEntry {
+    ZEntry* _next;
+  };
+
+  struct ZBucket {
+    size_t  _nwords;
+    ZEntry* _first;
+    size_t  _cached;
+    size_t  _demand;
+  };
+
+  static const size_t nbuckets = 4;
+
+  static ZLock*   _lock;
+  static ZBucket* _buckets;
+
+  static ZBucket* bucket(size_t nwords);
+
+public:
+  static void initialize();
+
+  static BitMap::bm_word_t* alloc(size_t nwords);
+  static void free(BitMap::bm_word_t* map, size_t nwords);
+
+  static void trim();
+};
+
+#endif // SHARE_GC_Z_ZLIVEMAPPOOL_HPP
@@ -37,6 +37,20 @@ public:
   void unlock();
 };
 
+class ZConditionLock {
+private:
+  os::PlatformMonitor _lock;
+
+public:
+  void lock();
+  bool try_lock();
+  void unlock();
+
+  bool wait(uint64_t millis = 0);
+  void notify();
+  void notify_all();
+};
+
 class ZReentrantLock {
 private:
   ZLock            _lock;
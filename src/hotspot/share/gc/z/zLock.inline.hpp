@@ -42,6 +42,30 @@ inline void ZLock::unlock() {
   _lock.unlock();
 }
 
+inline void ZConditionLock::lock() {
+  _lock.lock();
+}
+
+inline bool ZConditionLock::try_lock() {
+  return _lock.try_lock();
+}
+
+inline void ZConditionLock::unlock() {
+  _lock.unlock();
+}
+
+inline bool ZConditionLock::wait(uint64_t millis) {
+  return _lock.wait(millis) == OS_OK;
+}
+
+inline void ZConditionLock::notify() {
+  _lock.notify();
+}
+
+inline void ZConditionLock::notify_all() {
+  _lock.notify_all();
+}
+
 inline ZReentrantLock::ZReentrantLock() :
     _lock(),
     _owner(NULL),
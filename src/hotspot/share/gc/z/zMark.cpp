@@ -24,6 +24,8 @@
 #include "precompiled.hpp"
 #include "classfile/classLoaderDataGraph.hpp"
 #include "gc/z/zBarrier.inline.hpp"
+#include "gc/z/zClassProfile.hpp"
+#include "gc/z/zHeap.inline.hpp"
 #include "gc/z/zMark.inline.hpp"
 #include "gc/z/zMarkCache.inline.hpp"
 #include "gc/z/zMarkStack.inline.hpp"
@@ -33,6 +35,7 @@
 #include "gc/z/zPageTable.inline.hpp"
 #include "gc/z/zRootsIterator.hpp"
 #include "gc/z/zStat.hpp"
+#include "gc/z/zStringDedup.hpp"
 #include "gc/z/zTask.hpp"
 #include "gc/z/zThread.inline.hpp"
 #include "gc/z/zThreadLocalAllocBuffer.hpp"
@@ -47,6 +50,7 @@
 #include "runtime/prefetch.inline.hpp"
 #include "runtime/safepointMechanism.hpp"
 #include "runtime/thread.hpp"
+#include "runtime/threadSMR.hpp"
 #include "utilities/align.hpp"
 #include "utilities/globalDefinitions.hpp"
 #include "utilities/powerOfTwo.hpp"
@@ -57,6 +61,7 @@ static const ZStatSubPhase ZSubPhaseConcurrentMarkTryFlush("Concurrent Mark Try
 static const ZStatSubPhase ZSubPhaseConcurrentMarkIdle("Concurrent Mark Idle");
 static const ZStatSubPhase ZSubPhaseConcurrentMarkTryTerminate("Concurrent Mark Try Terminate");
 static const ZStatSubPhase ZSubPhaseMarkTryComplete("Pause Mark Try Complete");
+static const ZStatSampler  ZSamplerSuspendibleConcurrentMarkRoots("Suspendible", "Concurrent Mark Roots", ZStatUnitTime);
 
 ZMark::ZMark(ZWorkers* workers, ZPageTable* page_table) :
     _workers(workers),
@@ -64,13 +69,34 @@ ZMark::ZMark(ZWorkers* workers, ZPageTable* page_table) :
     _allocator(),
     _stripes(),
     _terminate(),
+    _class_histogram(),
     _work_terminateflush(true),
     _work_nproactiveflush(0),
     _work_nterminateflush(0),
+    _work_ndrained(0),
+    _work_npartialarrays(0),
+    _work_nsteals(0),
+    _work_nobjects(0),
+    _work_nbytes(0),
+    _work_ncacheevictions(0),
+    _work_nfinalizable_objects(0),
+    _work_nfinalizable_bytes(0),
+    _work_terminate_time(0),
     _nproactiveflush(0),
     _nterminateflush(0),
     _ntrycomplete(0),
     _ncontinue(0),
+    _ndrained(0),
+    _npartialarrays(0),
+    _nsteals(0),
+    _nobjects(0),
+    _nbytes(0),
+    _ncachesets(0),
+    _ncacheevictions(0),
+    _nfinalizable_objects(0),
+    _nfinalizable_bytes(0),
+    _terminate_time(0),
+    _mark_time(0),
     _nworkers(0) {}
 
 bool ZMark::is_initialized() const {
@@ -95,6 +121,18 @@ void ZMark::prepare_mark() {
   _nterminateflush = 0;
   _ntrycomplete = 0;
   _ncontinue = 0;
+  _ndrained = 0;
+  _npartialarrays = 0;
+  _nsteals = 0;
+
+  // Reset throughput counters
+  _nobjects = 0;
+  _nbytes = 0;
+  _ncacheevictions = 0;
+  _nfinalizable_objects = 0;
+  _nfinalizable_bytes = 0;
+  _terminate_time = 0;
+  _mark_time = 0;
 
   // Set number of workers to use
   _nworkers = _workers->nconcurrent();
@@ -104,6 +142,10 @@ void ZMark::prepare_mark() {
   const size_t nstripes = calculate_nstripes(_nworkers);
   _stripes.set_nstripes(nstripes);
 
+  // Set mark cache size, based on the number of pages that can be marked,
+  // where a used medium page is counted as many small pages
+  _ncachesets = ZMarkCache::calculate_nsets(nstripes, ZHeap::heap()->used() / ZPageSizeSmall);
+
   // Update statistics
   ZStatMark::set_at_mark_start(nstripes);
 
@@ -137,8 +179,8 @@ public:
     // Mark invisible root
     ZThreadLocalData::do_invisible_root(thread, ZBarrier::mark_barrier_on_invisible_root_oop_field);
 
-    // Retire TLAB
-    ZThreadLocalAllocBuffer::retire(thread);
+    // Retire or keep TLAB
+    ZThreadLocalAllocBuffer::retire_or_keep(thread);
   }
 
   virtual bool should_disarm_nmethods() const {
@@ -186,9 +228,15 @@ void ZMark::start() {
   // Prepare for concurrent mark
   prepare_mark();
 
+  // Start collecting class histogram, if enabled
+  _class_histogram.start();
+
   // Mark roots
   ZMarkRootsTask task(this);
   _workers->run_parallel(&task);
+
+  // Register TLABs kept across mark start with their pages
+  ZThreadLocalAllocBuffer::register_kept(_page_table);
 }
 
 void ZMark::prepare_work() {
@@ -200,22 +248,63 @@ void ZMark::prepare_work() {
   // Reset flush counters
   _work_nproactiveflush = _work_nterminateflush = 0;
   _work_terminateflush = true;
+
+  // Reset drain/partial array/steal counters
+  _work_ndrained = 0;
+  _work_npartialarrays = 0;
+  _work_nsteals = 0;
+
+  // Reset throughput counters
+  _work_nobjects = 0;
+  _work_nbytes = 0;
+  _work_ncacheevictions = 0;
+  _work_nfinalizable_objects = 0;
+  _work_nfinalizable_bytes = 0;
+  _work_terminate_time = 0;
 }
 
 void ZMark::finish_work() {
   // Accumulate proactive/terminate flush counters
   _nproactiveflush += _work_nproactiveflush;
   _nterminateflush += _work_nterminateflush;
+
+  // Accumulate drain/partial array/steal counters
+  _ndrained += _work_ndrained;
+  _npartialarrays += _work_npartialarrays;
+  _nsteals += _work_nsteals;
+
+  // Accumulate throughput counters
+  _nobjects += _work_nobjects;
+  _nbytes += _work_nbytes;
+  _ncacheevictions += _work_ncacheevictions;
+  _nfinalizable_objects += _work_nfinalizable_objects;
+  _nfinalizable_bytes += _work_nfinalizable_bytes;
+  _terminate_time += _work_terminate_time;
 }
 
 bool ZMark::is_array(uintptr_t addr) const {
   return ZOop::from_address(addr)->is_objArray();
 }
 
+size_t ZMark::partial_array_chunk_size(size_t size) const {
+  // Split large arrays into a number of chunks proportional to the number
+  // of workers, so that very large arrays don't generate an excessive
+  // number of partial array entries, while there are still enough chunks
+  // for all workers to share the work.
+  const size_t nchunks = MAX2(_nworkers, 1u) * ZMarkPartialArrayChunksPerWorker;
+  return align_up(MAX2(size / nchunks, ZMarkPartialArrayMinSize), ZMarkPartialArrayMinSize);
+}
+
 void ZMark::push_partial_array(uintptr_t addr, size_t size, bool finalizable) {
   assert(is_aligned(addr, ZMarkPartialArrayMinSize), "Address misaligned");
   ZMarkThreadLocalStacks* const stacks = ZThreadLocalData::stacks(Thread::current());
-  ZMarkStripe* const stripe = _stripes.stripe_for_addr(addr);
+
+  // Push the chunk to the stripe of the first object it references, rather
+  // than the stripe of the array itself. All chunks of an array would
+  // otherwise end up on the same stripe. Fall back to the stripe of the
+  // array if the first element is null.
+  const uintptr_t element = Atomic::load((volatile uintptr_t*)addr);
+  ZMarkStripe* const stripe = _stripes.stripe_for_addr(element != 0 ? element : addr);
   const uintptr_t offset = ZAddress::offset(addr) >> ZMarkPartialArrayMinSizeShift;
   const uintptr_t length = size / oopSize;
   const ZMarkStackEntry entry(offset, length, finalizable);
@@ -240,6 +329,7 @@ void ZMark::follow_large_array(uintptr_t addr, size_t size, bool finalizable) {
   assert(size > ZMarkPartialArrayMinSize, "Too small, should not be split");
   const uintptr_t start = addr;
   const uintptr_t end = start + size;
+  const size_t chunk_size = partial_array_chunk_size(size);
 
   // Calculate the aligned middle start/end/size, where the middle start
   // should always be greater than the start (hence the +1 below) to make
@@ -249,25 +339,32 @@ void ZMark::follow_large_array(uintptr_t addr, size_t size, bool finalizable) {
   const uintptr_t middle_end = middle_start + middle_size;
 
   log_develop_trace(gc, marking)("Array follow large: " PTR_FORMAT "-" PTR_FORMAT" (" SIZE_FORMAT "), "
-                                 "middle: " PTR_FORMAT "-" PTR_FORMAT " (" SIZE_FORMAT ")",
-                                 start, end, size, middle_start, middle_end, middle_size);
+                                 "middle: " PTR_FORMAT "-" PTR_FORMAT " (" SIZE_FORMAT "), chunk: " SIZE_FORMAT,
+                                 start, end, size, middle_start, middle_end, middle_size, chunk_size);
+
+  size_t npartialarrays = 0;
 
   // Push unaligned trailing part
   if (end > middle_end) {
     const uintptr_t trailing_addr = middle_end;
     const size_t trailing_size = end - middle_end;
     push_partial_array(trailing_addr, trailing_size, finalizable);
+    npartialarrays++;
   }
 
-  // Push aligned middle part(s)
+  // Push aligned middle part(s). The chunk size is a multiple of the
+  // minimum partial array size, so all chunks stay aligned.
   uintptr_t partial_addr = middle_end;
   while (partial_addr > middle_start) {
-    const size_t parts = 2;
-    const size_t partial_size = align_up((partial_addr - middle_start) / parts, ZMarkPartialArrayMinSize);
+    const size_t partial_size = MIN2(chunk_size, (size_t)(partial_addr - middle_start));
     partial_addr -= partial_size;
     push_partial_array(partial_addr, partial_size, finalizable);
+    npartialarrays++;
   }
 
+  // Update statistics
+  Atomic::add(&_work_npartialarrays, npartialarrays);
+
   // Follow leading part
   assert(start < middle_start, "Miscalculated middle start");
   const uintptr_t leading_addr = start;
@@ -286,8 +383,13 @@ void ZMark::follow_array(uintptr_t addr, size_t size, bool finalizable) {
 void ZMark::follow_partial_array(ZMarkStackEntry entry, bool finalizable) {
   const uintptr_t addr = ZAddress::good(entry.partial_array_offset() << ZMarkPartialArrayMinSizeShift);
   const size_t size = entry.partial_array_length() * oopSize;
+  const size_t length = size / oopSize;
 
-  follow_array(addr, size, finalizable);
+  log_develop_trace(gc, marking)("Array follow partial: " PTR_FORMAT " (" SIZE_FORMAT ")", addr, size);
+
+  // The array was split into suitably sized chunks when
+  // it was first followed, don't split the chunk further.
+  ZBarrier::mark_barrier_on_oop_array((oop*)addr, length, finalizable);
 }
 
 void ZMark::follow_array_object(objArrayOop obj, bool finalizable) {
@@ -312,6 +414,10 @@ void ZMark::follow_object(oop obj, bool finalizable) {
   } else {
     ZMarkBarrierOopClosure<false /* finalizable */> cl;
     obj->oop_iterate(&cl);
+
+    if (ZStringDedup::is_enabled()) {
+      ZStringDedup::enqueue_candidate(obj);
+    }
   }
 }
 
@@ -332,6 +438,20 @@ bool ZMark::try_mark_object(ZMarkCache* cache, uintptr_t addr, bool finalizable)
     const size_t size = ZUtils::object_size(addr);
     const size_t aligned_size = align_up(size, page->object_alignment());
     cache->inc_live(page, aligned_size);
+    if (finalizable) {
+      cache->inc_finalizable(aligned_size);
+    }
+    if (ZProfileClasses) {
+      ZClassProfile::record_marked(ZOop::from_address(addr)->klass(), aligned_size);
+    }
+
+    // Record where the object ends, so that relocation
+    // can find its size without touching the object.
+    page->mark_object_end(addr, size);
+
+    if (_class_histogram.is_enabled()) {
+      _class_histogram.add(ZOop::from_address(addr)->klass(), size);
+    }
   }
 
   return success;
@@ -368,22 +488,98 @@ void ZMark::mark_and_follow(ZMarkCache* cache, ZMarkStackEntry entry) {
   }
 }
 
+void ZMark::prefetch(ZMarkStackEntry entry) const {
+  if (entry.partial_array()) {
+    // Prefetch first array element
+    const uintptr_t addr = ZAddress::good(entry.partial_array_offset() << ZMarkPartialArrayMinSizeShift);
+    Prefetch::read((void*)addr, 0);
+    return;
+  }
+
+  // Prefetch object header and mark bit
+  const uintptr_t addr = entry.object_address();
+  Prefetch::read((void*)addr, 0);
+
+  const ZPage* const page = _page_table->get(addr);
+  if (!page->is_allocating()) {
+    page->prefetch_mark(addr);
+  }
+}
+
+void ZMark::wake_up_idle_workers(size_t ndrained) {
+  // Stacks that overflow while draining are published on the stripes.
+  // Periodically check if there are idle workers that could help out.
+  if ((ndrained & (ZMarkIdleWakeUpInterval - 1)) == 0 &&
+      _terminate.has_idle() &&
+      !_stripes.is_empty()) {
+    _terminate.wake_up();
+  }
+}
+
 template <typename T>
 bool ZMark::drain(ZMarkStripe* stripe, ZMarkThreadLocalStacks* stacks, ZMarkCache* cache, T* timeout) {
   ZMarkStackEntry entry;
+  size_t ndrained = 0;
+
+  if (!ZMarkPrefetch) {
+    // Drain stripe stacks
+    while (stacks->pop(&_allocator, &_stripes, stripe, entry)) {
+      mark_and_follow(cache, entry);
+      wake_up_idle_workers(++ndrained);
+
+      // Check timeout
+      if (timeout->has_expired()) {
+        // Timeout
+        Atomic::add(&_work_ndrained, ndrained);
+        return false;
+      }
+    }
+
+    // Success
+    Atomic::add(&_work_ndrained, ndrained);
+    return true;
+  }
+
+  // Drain stripe stacks through a small FIFO queue. Entries are prefetched
+  // when they enter the queue and processed when they leave it, which gives
+  // the memory system time to bring in the object and its mark bit while
+  // older entries are being processed.
+  const size_t mask = ZMarkPrefetchQueueSize - 1;
+  ZMarkStackEntry queue[ZMarkPrefetchQueueSize];
+  size_t head = 0;
+  size_t tail = 0;
+
+  for (;;) {
+    // Fill queue
+    while (tail - head < ZMarkPrefetchQueueSize &&
+           stacks->pop(&_allocator, &_stripes, stripe, entry)) {
+      prefetch(entry);
+      queue[tail++ & mask] = entry;
+    }
+
+    if (head == tail) {
+      // Queue and stacks empty
+      break;
+    }
 
-  // Drain stripe stacks
-  while (stacks->pop(&_allocator, &_stripes, stripe, entry)) {
-    mark_and_follow(cache, entry);
+    // Process oldest entry
+    mark_and_follow(cache, queue[head++ & mask]);
+    wake_up_idle_workers(++ndrained);
 
     // Check timeout
     if (timeout->has_expired()) {
-      // Timeout
+      // Timeout, push back entries still in the queue
+      while (head != tail) {
+        stacks->push(&_allocator, &_stripes, stripe, queue[head++ & mask], false /* publish */);
+      }
+
+      Atomic::add(&_work_ndrained, ndrained);
       return false;
     }
   }
 
   // Success
+  Atomic::add(&_work_ndrained, ndrained);
   return true;
 }
 
@@ -392,20 +588,24 @@ bool ZMark::drain_and_flush(ZMarkStripe* stripe, ZMarkThreadLocalStacks* stacks,
   const bool success = drain(stripe, stacks, cache, timeout);
 
   // Flush and publish worker stacks
-  stacks->flush(&_allocator, &_stripes);
+  if (stacks->flush(&_allocator, &_stripes)) {
+    // Wake up idle workers
+    _terminate.wake_up();
+  }
 
   return success;
 }
 
 bool ZMark::try_steal(ZMarkStripe* stripe, ZMarkThreadLocalStacks* stacks) {
-  // Try to steal a stack from another stripe
-  for (ZMarkStripe* victim_stripe = _stripes.stripe_next(stripe);
-       victim_stripe != stripe;
-       victim_stripe = _stripes.stripe_next(victim_stripe)) {
+  // Try to steal a stack from another stripe, starting with
+  // neighboring stripes before trying stripes further away.
+  for (size_t distance = 1; distance < _stripes.nstripes(); distance++) {
+    ZMarkStripe* const victim_stripe = _stripes.stripe_at_distance(stripe, distance);
     ZMarkStack* const stack = victim_stripe->steal_stack();
     if (stack != NULL) {
       // Success, install the stolen stack
       stacks->install(&_stripes, stripe, stack);
+      Atomic::inc(&_work_nsteals);
       return true;
     }
   }
@@ -414,22 +614,32 @@ bool ZMark::try_steal(ZMarkStripe* stripe, ZMarkThreadLocalStacks* stacks) {
   return false;
 }
 
-void ZMark::idle() const {
+void ZMark::idle() {
   ZStatTimer timer(ZSubPhaseConcurrentMarkIdle);
-  os::naked_short_sleep(1);
+  _terminate.idle(&_stripes);
 }
 
 class ZMarkFlushAndFreeStacksClosure : public HandshakeClosure {
 private:
-  ZMark* const _mark;
-  bool         _flushed;
+  ZMark* const                _mark;
+  const ZMarkStripeSet* const _stripes;
+  bool                        _flushed;
 
 public:
-  ZMarkFlushAndFreeStacksClosure(ZMark* mark) :
+  ZMarkFlushAndFreeStacksClosure(ZMark* mark, const ZMarkStripeSet* stripes) :
       HandshakeClosure("ZMarkFlushAndFreeStacks"),
       _mark(mark),
+      _stripes(stripes),
       _flushed(false) {}
 
+  virtual bool is_target(JavaThread* thread) {
+    // Only threads holding thread-local mark stacks need to be
+    // handshaked. This check is racy, but a thread that installs
+    // a stack after this point will be flushed by a later flush,
+    // or at the latest by the flush in mark end.
+    return !ZThreadLocalData::stacks(thread)->is_empty(_stripes);
+  }
+
   void do_thread(Thread* thread) {
     if (_mark->flush_and_free(thread)) {
       _flushed = true;
@@ -441,16 +651,33 @@ public:
   }
 };
 
+bool ZMark::has_thread_local_stacks(ZMarkFlushAndFreeStacksClosure* cl) const {
+  for (JavaThreadIteratorWithHandle jtiwh; JavaThread* const thread = jtiwh.next(); ) {
+    if (cl->is_target(thread)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 bool ZMark::flush(bool at_safepoint) {
-  ZMarkFlushAndFreeStacksClosure cl(this);
+  ZMarkFlushAndFreeStacksClosure cl(this, &_stripes);
   if (at_safepoint) {
     Threads::threads_do(&cl);
-  } else {
+  } else if (has_thread_local_stacks(&cl)) {
+    // Only handshake threads holding thread-local mark stacks
     Handshake::execute(&cl);
   }
 
   // Returns true if more work is available
-  return cl.flushed() || !_stripes.is_empty();
+  if (cl.flushed() || !_stripes.is_empty()) {
+    // Wake up idle workers
+    _terminate.wake_up();
+    return true;
+  }
+
+  return false;
 }
 
 bool ZMark::try_flush(volatile size_t* nflush) {
@@ -480,8 +707,24 @@ bool ZMark::try_proactive_flush() {
   return try_flush(&_work_nproactiveflush);
 }
 
+class ZMarkTerminateTimer : public StackObj {
+private:
+  volatile uint64_t* const _time;
+  const Ticks              _start;
+
+public:
+  ZMarkTerminateTimer(volatile uint64_t* time) :
+      _time(time),
+      _start(Ticks::now()) {}
+
+  ~ZMarkTerminateTimer() {
+    Atomic::add(_time, (uint64_t)(Ticks::now() - _start).nanoseconds());
+  }
+};
+
 bool ZMark::try_terminate() {
   ZStatTimer timer(ZSubPhaseConcurrentMarkTryTerminate);
+  ZMarkTerminateTimer terminate_timer(&_work_terminate_time);
 
   if (_terminate.enter_stage0()) {
     // Last thread entered stage 0, flush
@@ -507,7 +750,8 @@ bool ZMark::try_terminate() {
 
   for (;;) {
     if (_terminate.enter_stage1()) {
-      // Last thread entered stage 1, terminate
+      // Last thread entered stage 1, wake up idle workers and terminate
+      _terminate.wake_up();
       return true;
     }
 
@@ -617,7 +861,7 @@ void ZMark::work_with_timeout(ZMarkCache* cache, ZMarkStripe* stripe, ZMarkThrea
 }
 
 void ZMark::work(uint64_t timeout_in_millis) {
-  ZMarkCache cache(_stripes.nstripes());
+  ZMarkCache cache(_stripes.nstripes(), _ncachesets);
   ZMarkStripe* const stripe = _stripes.stripe_for_worker(_nworkers, ZThread::worker_id());
   ZMarkThreadLocalStacks* const stacks = ZThreadLocalData::stacks(Thread::current());
 
@@ -630,6 +874,14 @@ void ZMark::work(uint64_t timeout_in_millis) {
   // Make sure stacks have been flushed
   assert(stacks->is_empty(&_stripes), "Should be empty");
 
+  // Write out cached live data, and update throughput counters
+  cache.flush();
+  Atomic::add(&_work_nobjects, cache.nobjects());
+  Atomic::add(&_work_nbytes, cache.nbytes());
+  Atomic::add(&_work_ncacheevictions, cache.nevictions());
+  Atomic::add(&_work_nfinalizable_objects, cache.nfinalizable_objects());
+  Atomic::add(&_work_nfinalizable_bytes, cache.nfinalizable_bytes());
+
   // Free remaining stacks
   stacks->free(&_allocator);
 }
@@ -649,6 +901,7 @@ public:
 class ZMarkConcurrentRootsTask : public ZTask {
 private:
   SuspendibleThreadSetJoiner          _sts_joiner;
+  ZStatSuspendibleTimer               _sts_timer;
   ZConcurrentRootsIteratorClaimStrong _roots;
   ZMarkConcurrentRootsIteratorClosure _cl;
 
@@ -656,6 +909,7 @@ public:
   ZMarkConcurrentRootsTask(ZMark* mark) :
       ZTask("ZMarkConcurrentRootsTask"),
       _sts_joiner(),
+      _sts_timer(ZSamplerSuspendibleConcurrentMarkRoots),
       _roots(),
       _cl() {
     ClassLoaderDataGraph_lock->lock();
@@ -693,13 +947,41 @@ public:
 };
 
 void ZMark::mark(bool initial) {
+  const Ticks start = Ticks::now();
+
   if (initial) {
     ZMarkConcurrentRootsTask task(this);
     _workers->run_concurrent(&task);
   }
 
-  ZMarkTask task(this);
-  _workers->run_concurrent(&task);
+  {
+    // The task is destroyed, and its statistics recorded, before the
+    // tasks below prepare the work statistics again
+    ZMarkTask task(this);
+    _workers->run_concurrent(&task);
+  }
+
+  // Mutators may have pushed more work on their thread-local stacks after
+  // the workers terminated. Flush it out using handshakes, and mark it
+  // here, to keep that work out of the mark end pause, where it would
+  // otherwise be marked by the threads flush and try complete, or make
+  // mark end fail and require another pause.
+  for (size_t i = 0; i < ZMarkEndFlushMax && try_flush_before_end(); i++) {
+    ZMarkTask flush_task(this);
+    _workers->run_concurrent(&flush_task);
+  }
+
+  _mark_time += (Ticks::now() - start).nanoseconds();
+}
+
+bool ZMark::try_flush_before_end() {
+  // Only flush if handshakes are enabled
+  if (!SafepointMechanism::uses_thread_local_poll()) {
+    return false;
+  }
+
+  ZStatTimer timer(ZSubPhaseConcurrentMarkTryFlush);
+  return flush(false /* at_safepoint */);
 }
 
 bool ZMark::try_complete() {
@@ -707,8 +989,10 @@ bool ZMark::try_complete() {
 
   // Use nconcurrent number of worker threads to maintain the
   // worker/stripe distribution used during concurrent mark.
+  const Ticks start = Ticks::now();
   ZMarkTask task(this, ZMarkCompleteTimeout);
   _workers->run_concurrent(&task);
+  _mark_time += (Ticks::now() - start).nanoseconds();
 
   // Successful if all stripes are empty
   return _stripes.is_empty();
@@ -740,12 +1024,31 @@ bool ZMark::end() {
   }
 
   // Update statistics
-  ZStatMark::set_at_mark_end(_nproactiveflush, _nterminateflush, _ntrycomplete, _ncontinue);
+  ZStatMark::set_at_mark_end(_nproactiveflush, _nterminateflush, _ntrycomplete, _ncontinue, _ndrained, _npartialarrays, _nsteals);
+  ZStatMark::set_at_mark_end_throughput(_nworkers, _nobjects, _nbytes, _mark_time, _terminate_time);
+  ZStatMark::set_at_mark_end_cache(_ncachesets * ZMarkCacheWays, _ncacheevictions);
+  ZStatMark::set_at_mark_end_finalizable(_nfinalizable_objects, _nfinalizable_bytes);
 
   // Mark completed
   return true;
 }
 
+void ZMark::free() {
+  // Marking is completed and all mark stacks have been returned to
+  // the allocator. Return mark stack space not recently needed.
+  const size_t used = _allocator.used();
+  const size_t committed_before = _allocator.committed();
+  _allocator.reset();
+  const size_t committed_after = _allocator.committed();
+
+  // Update statistics
+  ZStatMark::set_at_mark_free(used, committed_before, committed_after);
+}
+
+void ZMark::report_class_histogram() {
+  _class_histogram.report();
+}
+
 void ZMark::flush_and_free() {
   Thread* const thread = Thread::current();
   flush_and_free(thread);
@@ -24,6 +24,7 @@
 #ifndef SHARE_GC_Z_ZMARK_HPP
 #define SHARE_GC_Z_ZMARK_HPP
 
+#include "gc/z/zMarkClassHistogram.hpp"
 #include "gc/z/zMarkStack.hpp"
 #include "gc/z/zMarkStackAllocator.hpp"
 #include "gc/z/zMarkTerminate.hpp"
@@ -32,6 +33,7 @@
 
 class Thread;
 class ZMarkCache;
+class ZMarkFlushAndFreeStacksClosure;
 class ZPageTable;
 class ZWorkers;
 
@@ -46,19 +48,41 @@ private:
   ZMarkStackAllocator _allocator;
   ZMarkStripeSet      _stripes;
   ZMarkTerminate      _terminate;
-  volatile bool       _work_terminateflush;
+  ZMarkClassHistogram _class_histogram;
+  ZCACHE_ALIGNED volatile bool _work_terminateflush;
   volatile size_t     _work_nproactiveflush;
   volatile size_t     _work_nterminateflush;
-  size_t              _nproactiveflush;
+  volatile size_t     _work_ndrained;
+  volatile size_t     _work_npartialarrays;
+  volatile size_t     _work_nsteals;
+  volatile size_t     _work_nobjects;
+  volatile size_t     _work_nbytes;
+  volatile size_t     _work_ncacheevictions;
+  volatile size_t     _work_nfinalizable_objects;
+  volatile size_t     _work_nfinalizable_bytes;
+  volatile uint64_t   _work_terminate_time;
+  ZCACHE_ALIGNED size_t _nproactiveflush;
   size_t              _nterminateflush;
   size_t              _ntrycomplete;
   size_t              _ncontinue;
+  size_t              _ndrained;
+  size_t              _npartialarrays;
+  size_t              _nsteals;
+  size_t              _nobjects;
+  size_t              _nbytes;
+  size_t              _ncachesets;
+  size_t              _ncacheevictions;
+  size_t              _nfinalizable_objects;
+  size_t              _nfinalizable_bytes;
+  uint64_t            _terminate_time;
+  uint64_t            _mark_time;
   uint                _nworkers;
 
   size_t calculate_nstripes(uint nworkers) const;
   void prepare_mark();
 
   bool is_array(uintptr_t addr) const;
+  size_t partial_array_chunk_size(size_t size) const;
   void push_partial_array(uintptr_t addr, size_t size, bool finalizable);
   void follow_small_array(uintptr_t addr, size_t size, bool finalizable);
   void follow_large_array(uintptr_t addr, size_t size, bool finalizable);
@@ -68,6 +92,8 @@ private:
   void follow_object(oop obj, bool finalizable);
   bool try_mark_object(ZMarkCache* cache, uintptr_t addr, bool finalizable);
   void mark_and_follow(ZMarkCache* cache, ZMarkStackEntry entry);
+  void prefetch(ZMarkStackEntry entry) const;
+  void wake_up_idle_workers(size_t ndrained);
 
   template <typename T> bool drain(ZMarkStripe* stripe,
                                    ZMarkThreadLocalStacks* stacks,
@@ -78,11 +104,13 @@ private:
                                              ZMarkCache* cache,
                                              T* timeout);
   bool try_steal(ZMarkStripe* stripe, ZMarkThreadLocalStacks* stacks);
-  void idle() const;
+  void idle();
+  bool has_thread_local_stacks(ZMarkFlushAndFreeStacksClosure* cl) const;
   bool flush(bool at_safepoint);
   bool try_proactive_flush();
   bool try_flush(volatile size_t* nflush);
   bool try_terminate();
+  bool try_flush_before_end();
   bool try_complete();
   bool try_end();
 
@@ -113,6 +141,10 @@ public:
 
   void flush_and_free();
   bool flush_and_free(Thread* thread);
+
+  void report_class_histogram();
+
+  void free();
 };
 
 #endif // SHARE_GC_Z_ZMARK_HPP
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, 2017, Oracle and/or its affiliates. All rights reserved.
+ * Copyright (c) 2016, 2019, Oracle and/or its affiliates. All rights reserved.
  * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
  *
  * This code is free software; you can redistribute it and/or modify it
@@ -23,19 +23,44 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zMarkCache.inline.hpp"
+#include "utilities/align.hpp"
 #include "utilities/globalDefinitions.hpp"
+#include "utilities/powerOfTwo.hpp"
 
 ZMarkCacheEntry::ZMarkCacheEntry() :
     _page(NULL),
     _objects(0),
     _bytes(0) {}
 
-ZMarkCache::ZMarkCache(size_t nstripes) :
-    _shift(ZMarkStripeShift + exact_log2(nstripes)) {}
+size_t ZMarkCache::calculate_nsets(size_t nstripes, size_t npages) {
+  // A mark worker mostly marks objects on the pages of its own stripe.
+  // Size the cache to hold all pages of a stripe, so that entries are
+  // only evicted on conflicts when the cache is at its max size. A
+  // smaller cache is also cheaper to flush when a worker is done.
+  const size_t npages_per_stripe = MAX2(npages / nstripes, (size_t)1);
+  const size_t nsets = round_up_power_of_2(align_up(npages_per_stripe, ZMarkCacheWays) / ZMarkCacheWays);
+  return MIN2(nsets, ZMarkCacheSize / ZMarkCacheWays);
+}
+
+ZMarkCache::ZMarkCache(size_t nstripes, size_t nsets) :
+    _shift(ZMarkStripeShift + exact_log2(nstripes)),
+    _nsets(nsets),
+    _nobjects(0),
+    _nbytes(0),
+    _nevictions(0),
+    _nfinalizable_objects(0),
+    _nfinalizable_bytes(0) {
+  assert(is_power_of_2(nsets), "Must be a power of two");
+  assert(nsets * ZMarkCacheWays <= ZMarkCacheSize, "Too many sets");
+}
 
 ZMarkCache::~ZMarkCache() {
-  // Evict all entries
-  for (size_t i = 0; i < ZMarkCacheSize; i++) {
-    _cache[i].evict();
+  flush();
+}
+
+void ZMarkCache::flush() {
+  // Evict all entries in use
+  for (size_t i = 0; i < _nsets * ZMarkCacheWays; i++) {
+    _cache[i].evict(&_nobjects, &_nbytes);
   }
 }
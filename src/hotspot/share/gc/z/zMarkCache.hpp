@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, 2017, Oracle and/or its affiliates. All rights reserved.
+ * Copyright (c) 2016, 2019, Oracle and/or its affiliates. All rights reserved.
  * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
  *
  * This code is free software; you can redistribute it and/or modify it
@@ -38,20 +38,48 @@ private:
 public:
   ZMarkCacheEntry();
 
-  void inc_live(ZPage* page, size_t bytes);
-  void evict();
+  bool inc_live(ZPage* page, size_t bytes);
+  void set(ZPage* page, size_t bytes);
+  bool evict(size_t* nobjects, size_t* nbytes);
 };
 
 class ZMarkCache : public StackObj {
 private:
   const size_t    _shift;
+  const size_t    _nsets;
   ZMarkCacheEntry _cache[ZMarkCacheSize];
+  size_t          _nobjects;
+  size_t          _nbytes;
+  size_t          _nevictions;
+  size_t          _nfinalizable_objects;
+  size_t          _nfinalizable_bytes;
+
+  void inc_live_slow(ZMarkCacheEntry* set, ZPage* page, size_t bytes);
 
 public:
-  ZMarkCache(size_t nstripes);
+  static size_t calculate_nsets(size_t nstripes, size_t npages);
+
+  ZMarkCache(size_t nstripes, size_t nsets);
   ~ZMarkCache();
 
   void inc_live(ZPage* page, size_t bytes);
+  void inc_finalizable(size_t bytes);
+
+  // Write all entries out to their pages
+  void flush();
+
+  // Number of objects, and their size, marked through this cache. These
+  // are accumulated when entries are written out to pages, so they are
+  // only complete after the cache has been flushed.
+  size_t nobjects() const;
+  size_t nbytes() const;
+
+  // Number of objects, and their size, first marked as finalizable
+  size_t nfinalizable_objects() const;
+  size_t nfinalizable_bytes() const;
+
+  // Number of entries written out to pages to make room for other pages
+  size_t nevictions() const;
 };
 
 #endif // SHARE_GC_Z_ZMARKCACHE_HPP
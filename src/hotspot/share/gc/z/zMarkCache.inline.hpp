@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, 2017, Oracle and/or its affiliates. All rights reserved.
+ * Copyright (c) 2016, 2019, Oracle and/or its affiliates. All rights reserved.
  * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
  *
  * This code is free software; you can redistribute it and/or modify it
@@ -27,32 +27,96 @@
 #include "gc/z/zMarkCache.hpp"
 #include "gc/z/zPage.inline.hpp"
 
-inline void ZMarkCacheEntry::inc_live(ZPage* page, size_t bytes) {
-  if (_page == page) {
-    // Cache hit
-    _objects++;
-    _bytes += bytes;
-  } else {
+inline bool ZMarkCacheEntry::inc_live(ZPage* page, size_t bytes) {
+  if (_page != page) {
     // Cache miss
-    evict();
-    _page = page;
-    _objects = 1;
-    _bytes = bytes;
+    return false;
   }
+
+  // Cache hit
+  _objects++;
+  _bytes += bytes;
+  return true;
+}
+
+inline void ZMarkCacheEntry::set(ZPage* page, size_t bytes) {
+  assert(_page == NULL, "Entry not evicted");
+  _page = page;
+  _objects = 1;
+  _bytes = bytes;
+}
+
+inline bool ZMarkCacheEntry::evict(size_t* nobjects, size_t* nbytes) {
+  if (_page == NULL) {
+    // Empty entry
+    return false;
+  }
+
+  // Write cached data out to page, and account for it
+  _page->inc_live(_objects, _bytes);
+  *nobjects += _objects;
+  *nbytes += _bytes;
+  _page = NULL;
+  return true;
 }
 
-inline void ZMarkCacheEntry::evict() {
-  if (_page != NULL) {
-    // Write cached data out to page
-    _page->inc_live(_objects, _bytes);
-    _page = NULL;
+inline void ZMarkCache::inc_live_slow(ZMarkCacheEntry* set, ZPage* page, size_t bytes) {
+  // The entries of a set are kept in most recently used order
+  for (size_t i = 1; i < ZMarkCacheWays; i++) {
+    if (set[i].inc_live(page, bytes)) {
+      // Hit, move entry to the front
+      const ZMarkCacheEntry entry = set[i];
+      for (size_t j = i; j > 0; j--) {
+        set[j] = set[j - 1];
+      }
+      set[0] = entry;
+      return;
+    }
+  }
+
+  // Miss, evict the least recently used entry
+  if (set[ZMarkCacheWays - 1].evict(&_nobjects, &_nbytes)) {
+    _nevictions++;
   }
+
+  for (size_t j = ZMarkCacheWays - 1; j > 0; j--) {
+    set[j] = set[j - 1];
+  }
+  set[0] = ZMarkCacheEntry();
+  set[0].set(page, bytes);
 }
 
 inline void ZMarkCache::inc_live(ZPage* page, size_t bytes) {
-  const size_t mask = ZMarkCacheSize - 1;
-  const size_t index = (page->start() >> _shift) & mask;
-  _cache[index].inc_live(page, bytes);
+  const size_t index = (page->start() >> _shift) & (_nsets - 1);
+  ZMarkCacheEntry* const set = &_cache[index * ZMarkCacheWays];
+  if (!set[0].inc_live(page, bytes)) {
+    inc_live_slow(set, page, bytes);
+  }
+}
+
+inline void ZMarkCache::inc_finalizable(size_t bytes) {
+  _nfinalizable_objects++;
+  _nfinalizable_bytes += bytes;
+}
+
+inline size_t ZMarkCache::nobjects() const {
+  return _nobjects;
+}
+
+inline size_t ZMarkCache::nbytes() const {
+  return _nbytes;
+}
+
+inline size_t ZMarkCache::nevictions() const {
+  return _nevictions;
+}
+
+inline size_t ZMarkCache::nfinalizable_objects() const {
+  return _nfinalizable_objects;
+}
+
+inline size_t ZMarkCache::nfinalizable_bytes() const {
+  return _nfinalizable_bytes;
 }
 
 #endif // SHARE_GC_Z_ZMARKCACHE_INLINE_HPP
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/shared/objectCountEventSender.hpp"
+#include "gc/z/zHash.inline.hpp"
+#include "gc/z/zMarkClassHistogram.hpp"
+#include "gc/z/zTracer.hpp"
+#include "gc/z/zValue.inline.hpp"
+#include "logging/log.hpp"
+#include "logging/logStream.hpp"
+#include "memory/heapInspection.hpp"
+#include "memory/resourceArea.hpp"
+#include "runtime/globals.hpp"
+#include "utilities/debug.hpp"
+#include "utilities/macros.hpp"
+
+static const size_t ZMarkClassHistogramInitialSize = 1024;
+
+ZMarkClassHistogramTable::ZMarkClassHistogramTable() :
+    _entries(NULL),
+    _size(0),
+    _nentries(0) {}
+
+ZMarkClassHistogramEntry* ZMarkClassHistogramTable::find(Klass* klass) const {
+  // Open addressing with linear probing. The table is never
+  // more than half full, so an empty slot is always found.
+  const size_t mask = _size - 1;
+  size_t index = ZHash::address_to_uint32((uintptr_t)klass) & mask;
+
+  for (;;) {
+    ZMarkClassHistogramEntry* const entry = _entries + index;
+    if (entry->_klass == klass || entry->_klass == NULL) {
+      return entry;
+    }
+
+    index = (index + 1) & mask;
+  }
+}
+
+void ZMarkClassHistogramTable::grow() {
+  ZMarkClassHistogramEntry* const old_entries = _entries;
+  const size_t old_size = _size;
+
+  _size = (old_size == 0) ? ZMarkClassHistogramInitialSize : old_size * 2;
+  _entries = NEW_C_HEAP_ARRAY(ZMarkClassHistogramEntry, _size, mtGC);
+  memset(_entries, 0, _size * sizeof(ZMarkClassHistogramEntry));
+
+  // Rehash entries
+  for (size_t i = 0; i < old_size; i++) {
+    const ZMarkClassHistogramEntry& old_entry = old_entries[i];
+    if (old_entry._klass != NULL) {
+      *find(old_entry._klass) = old_entry;
+    }
+  }
+
+  FREE_C_HEAP_ARRAY(ZMarkClassHistogramEntry, old_entries);
+}
+
+void ZMarkClassHistogramTable::add(Klass* klass, size_t words) {
+  if (_nentries >= _size / 2) {
+    grow();
+  }
+
+  ZMarkClassHistogramEntry* const entry = find(klass);
+  if (entry->_klass == NULL) {
+    entry->_klass = klass;
+    _nentries++;
+  }
+
+  entry->_count++;
+  entry->_words += words;
+}
+
+bool ZMarkClassHistogramTable::merge_into(KlassInfoTable* cit) const {
+#if INCLUDE_SERVICES
+  for (size_t i = 0; i < _size; i++) {
+    const ZMarkClassHistogramEntry& entry = _entries[i];
+    if (entry._klass != NULL &&
+        !cit->record_instances(entry._klass, (long)entry._count, entry._words)) {
+      return false;
+    }
+  }
+#endif
+
+  return true;
+}
+
+void ZMarkClassHistogramTable::clear() {
+  FREE_C_HEAP_ARRAY(ZMarkClassHistogramEntry, _entries);
+  _entries = NULL;
+  _size = 0;
+  _nentries = 0;
+}
+
+ZMarkClassHistogram::ZMarkClassHistogram() :
+    _tables(),
+    _enabled(false) {}
+
+bool ZMarkClassHistogram::is_enabled() const {
+  return _enabled;
+}
+
+void ZMarkClassHistogram::start() {
+  _enabled = ZCollectClassHistogram;
+
+#if INCLUDE_SERVICES
+  // Also collect the histogram if the ObjectCount event is enabled,
+  // since it then comes without an extra heap iteration.
+  _enabled |= ObjectCountEventSender::should_send_event();
+#endif
+}
+
+void ZMarkClassHistogram::add(Klass* klass, size_t size) {
+  _tables.addr()->add(klass, size >> LogHeapWordSize);
+}
+
+void ZMarkClassHistogram::clear() {
+  ZPerWorkerIterator<ZMarkClassHistogramTable> iter(&_tables);
+  for (ZMarkClassHistogramTable* table; iter.next(&table);) {
+    table->clear();
+  }
+}
+
+#if INCLUDE_SERVICES
+
+class ZMarkClassHistogramClosure : public KlassInfoClosure {
+private:
+  KlassInfoHisto* const _histo;
+
+public:
+  ZMarkClassHistogramClosure(KlassInfoHisto* histo) :
+      _histo(histo) {}
+
+  virtual void do_cinfo(KlassInfoEntry* cie) {
+    _histo->add(cie);
+  }
+};
+
+void ZMarkClassHistogram::report() {
+  if (!_enabled) {
+    return;
+  }
+
+  _enabled = false;
+
+  ResourceMark rm;
+  KlassInfoTable cit(false /* add_all_classes */);
+  if (cit.allocation_failed()) {
+    log_debug(gc, classhisto)("Class Histogram: Ran out of C-heap");
+    clear();
+    return;
+  }
+
+  // Merge per-worker tables
+  ZPerWorkerConstIterator<ZMarkClassHistogramTable> iter(&_tables);
+  for (const ZMarkClassHistogramTable* table; iter.next(&table);) {
+    if (!table->merge_into(&cit)) {
+      log_debug(gc, classhisto)("Class Histogram: Ran out of C-heap");
+      clear();
+      return;
+    }
+  }
+
+  clear();
+
+  // Send events
+  ZTracer::tracer()->report_object_count_after_gc(&cit);
+
+  // Print histogram
+  LogTarget(Trace, gc, classhisto) log;
+  if (log.is_enabled()) {
+    LogStream stream(log);
+    KlassInfoHisto histo(&cit);
+    ZMarkClassHistogramClosure cl(&histo);
+    cit.iterate(&cl);
+    histo.sort();
+    histo.print_histo_on(&stream, false /* print_stats */, false /* csv_format */, NULL /* columns */);
+  }
+}
+
+#else // INCLUDE_SERVICES
+
+void ZMarkClassHistogram::report() {
+  _enabled = false;
+  clear();
+}
+
+#endif // INCLUDE_SERVICES
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZMARKCLASSHISTOGRAM_HPP
+#define SHARE_GC_Z_ZMARKCLASSHISTOGRAM_HPP
+
+#include "gc/z/zValue.hpp"
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class Klass;
+class KlassInfoTable;
+
+struct ZMarkClassHistogramEntry {
+  Klass* _klass;
+  size_t _count;
+  size_t _words;
+};
+
+class ZMarkClassHistogramTable {
+private:
+  ZMarkClassHistogramEntry* _entries;
+  size_t                    _size;
+  size_t                    _nentries;
+
+  ZMarkClassHistogramEntry* find(Klass* klass) const;
+  void grow();
+
+public:
+  ZMarkClassHistogramTable();
+
+  void add(Klass* klass, size_t words);
+  bool merge_into(KlassInfoTable* cit) const;
+  void clear();
+};
+
+class ZMarkClassHistogram {
+private:
+  ZPerWorker<ZMarkClassHistogramTable> _tables;
+  bool                                 _enabled;
+
+  void clear();
+
+public:
+  ZMarkClassHistogram();
+
+  bool is_enabled() const;
+
+  void start();
+  void add(Klass* klass, size_t size);
+  void report();
+};
+
+#endif // SHARE_GC_Z_ZMARKCLASSHISTOGRAM_HPP
@@ -25,6 +25,7 @@
 #include "gc/z/zMarkStack.inline.hpp"
 #include "gc/z/zMarkStackAllocator.hpp"
 #include "logging/log.hpp"
+#include "memory/allocation.hpp"
 #include "utilities/debug.hpp"
 
 ZMarkStripe::ZMarkStripe() :
@@ -78,12 +79,17 @@ ZMarkStripe* ZMarkStripeSet::stripe_for_worker(uint nworkers, uint worker_id) {
 }
 
 ZMarkThreadLocalStacks::ZMarkThreadLocalStacks() :
-    _magazine(NULL) {
+    _magazine(NULL),
+    _stacks(NEW_C_HEAP_ARRAY(ZMarkStack*, ZMarkStripesMax, mtGC)) {
   for (size_t i = 0; i < ZMarkStripesMax; i++) {
     _stacks[i] = NULL;
   }
 }
 
+ZMarkThreadLocalStacks::~ZMarkThreadLocalStacks() {
+  FREE_C_HEAP_ARRAY(ZMarkStack*, _stacks);
+}
+
 bool ZMarkThreadLocalStacks::is_empty(const ZMarkStripeSet* stripes) const {
   for (size_t i = 0; i < stripes->nstripes(); i++) {
     ZMarkStack* const stack = _stacks[i];
@@ -61,6 +61,7 @@ public:
   ZStackList();
 
   bool is_empty() const;
+  void clear();
 
   void push(T* stack);
   T* pop();
@@ -102,6 +103,7 @@ public:
   size_t stripe_id(const ZMarkStripe* stripe) const;
   ZMarkStripe* stripe_at(size_t index);
   ZMarkStripe* stripe_next(ZMarkStripe* stripe);
+  ZMarkStripe* stripe_at_distance(ZMarkStripe* stripe, size_t distance);
   ZMarkStripe* stripe_for_worker(uint nworkers, uint worker_id);
   ZMarkStripe* stripe_for_addr(uintptr_t addr);
 };
@@ -111,7 +113,7 @@ class ZMarkStackAllocator;
 class ZMarkThreadLocalStacks {
 private:
   ZMarkStackMagazine* _magazine;
-  ZMarkStack*         _stacks[ZMarkStripesMax];
+  ZMarkStack** const  _stacks;
 
   ZMarkStack* allocate_stack(ZMarkStackAllocator* allocator);
   void free_stack(ZMarkStackAllocator* allocator, ZMarkStack* stack);
@@ -129,6 +131,7 @@ private:
 
 public:
   ZMarkThreadLocalStacks();
+  ~ZMarkThreadLocalStacks();
 
   bool is_empty(const ZMarkStripeSet* stripes) const;
 
@@ -24,6 +24,7 @@
 #ifndef SHARE_GC_Z_ZMARKSTACK_INLINE_HPP
 #define SHARE_GC_Z_ZMARKSTACK_INLINE_HPP
 
+#include "gc/z/zAddress.inline.hpp"
 #include "gc/z/zMarkStack.hpp"
 #include "utilities/debug.hpp"
 #include "runtime/atomic.hpp"
@@ -63,6 +64,94 @@ inline bool ZStack<T, S>::pop(T& value) {
   return true;
 }
 
+//
+// Mark stacks store entries in 32-bit slots. An entry for an object that
+// should be followed, and whose offset is below ZMarkStackCompactOffsetLimit,
+// is stored in a single compact slot. All other entries are stored in two
+// slots, holding the low and high halves of the full 64-bit entry. Compact
+// entries are only used when bit 63 of a full entry can never be set, see
+// ZMarkStackSpace, so the high half, which is pushed last, can then be
+// told apart from a compact slot by looking at bit 31. When compact entries
+// are not used, all slots are pairs of halves and bit 31 is not inspected.
+//
+//  Compact slot
+//  ------------
+//
+//   3 3
+//   1 0                                    0
+//  +-+------------------------------------+-+
+//  |1|111111 11111111 11111111 11111111 11|1|
+//  +-+------------------------------------+-+
+//  | |                                     |
+//  | |              0-0 Final Flag (1-bit) *
+//  | |
+//  | * 30-1 Object Offset >> 3 (30-bits)
+//  |
+//  * 31-31 Compact Flag (1-bit)
+//
+
+const uint32_t ZMarkStackCompactFlag = (uint32_t)1 << 31;
+
+template <>
+inline bool ZMarkStack::is_full() const {
+  return _top == ZMarkStackSlots * 2;
+}
+
+template <>
+inline bool ZMarkStack::push(ZMarkStackEntry value) {
+  uint32_t* const slots = (uint32_t*)_slots;
+
+  if (ZMarkStackCompactOffsetLimit != 0 && !value.partial_array() && value.follow()) {
+    const uintptr_t offset = ZAddress::offset(value.object_address());
+    if (offset < ZMarkStackCompactOffsetLimit) {
+      // Compact entry
+      if (is_full()) {
+        return false;
+      }
+
+      slots[_top++] = ZMarkStackCompactFlag |
+                      (uint32_t)((offset >> LogHeapWordSize) << 1) |
+                      (uint32_t)value.finalizable();
+      return true;
+    }
+  }
+
+  // Full entry
+  if (_top + 2 > ZMarkStackSlots * 2) {
+    return false;
+  }
+
+  const uint64_t raw = value.encode();
+  assert(ZMarkStackCompactOffsetLimit == 0 || (raw >> 63) == 0, "Invalid entry");
+  slots[_top++] = (uint32_t)raw;
+  slots[_top++] = (uint32_t)(raw >> 32);
+  return true;
+}
+
+template <>
+inline bool ZMarkStack::pop(ZMarkStackEntry& value) {
+  const uint32_t* const slots = (const uint32_t*)_slots;
+
+  if (is_empty()) {
+    return false;
+  }
+
+  const uint32_t slot = slots[--_top];
+  if (ZMarkStackCompactOffsetLimit != 0 && (slot & ZMarkStackCompactFlag) != 0) {
+    // Compact entry
+    const uintptr_t offset = (uintptr_t)((slot & ~ZMarkStackCompactFlag) >> 1) << LogHeapWordSize;
+    const bool finalizable = (slot & 1) != 0;
+    value = ZMarkStackEntry(ZAddress::good(offset), true /* follow */, finalizable);
+    return true;
+  }
+
+  // Full entry
+  assert(_top > 0, "Invalid stack");
+  const uint32_t low = slots[--_top];
+  value = ZMarkStackEntry::decode(((uint64_t)slot << 32) | low);
+  return true;
+}
+
 template <typename T, size_t S>
 inline ZStack<T, S>* ZStack<T, S>::next() const {
   return _next;
@@ -113,6 +202,11 @@ inline bool ZStackList<T>::is_empty() const {
   return stack == NULL;
 }
 
+template <typename T>
+inline void ZStackList<T>::clear() {
+  _head = encode_versioned_pointer(NULL, 0);
+}
+
 template <typename T>
 inline void ZStackList<T>::push(T* stack) {
   T* vstack = _head;
@@ -205,6 +299,17 @@ inline ZMarkStripe* ZMarkStripeSet::stripe_next(ZMarkStripe* stripe) {
   return &_stripes[index];
 }
 
+inline ZMarkStripe* ZMarkStripeSet::stripe_at_distance(ZMarkStripe* stripe, size_t distance) {
+  // Stripes are grouped in power of two sized blocks, where stripes in
+  // the same block are considered neighbors. Flipping the low bits of the
+  // stripe id walks the smallest enclosing block first, so a stripe
+  // reaches its closest neighbors before stripes further away.
+  assert(distance > 0 && distance < _nstripes, "Invalid distance");
+  const size_t index = stripe_id(stripe) ^ distance;
+  assert(index < _nstripes, "Invalid index");
+  return &_stripes[index];
+}
+
 inline ZMarkStripe* ZMarkStripeSet::stripe_for_addr(uintptr_t addr) {
   const size_t index = (addr >> ZMarkStripeShift) & _nstripes_mask;
   assert(index < _nstripes, "Invalid index");
@@ -22,15 +22,23 @@
  */
 
 #include "precompiled.hpp"
+#include "gc/z/zLargePages.inline.hpp"
 #include "gc/z/zLock.inline.hpp"
 #include "gc/z/zMarkStack.inline.hpp"
 #include "gc/z/zMarkStackAllocator.hpp"
 #include "logging/log.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/os.hpp"
+#include "utilities/align.hpp"
 #include "utilities/debug.hpp"
 
 uintptr_t ZMarkStackSpaceStart;
+uintptr_t ZMarkStackCompactOffsetLimit;
+
+static size_t mark_stack_space_alignment() {
+  // Mark stacks are accessed randomly, so use huge pages if possible
+  return ZLargePages::is_enabled_for_metadata() ? os::large_page_size() : (size_t)os::vm_allocation_granularity();
+}
 
 ZMarkStackSpace::ZMarkStackSpace() :
     _expand_lock(),
@@ -41,7 +49,7 @@ ZMarkStackSpace::ZMarkStackSpace() :
 
   // Reserve address space
   const size_t size = ZMarkStackSpaceLimit;
-  const size_t alignment = (size_t)os::vm_allocation_granularity();
+  const size_t alignment = mark_stack_space_alignment();
   const uintptr_t addr = (uintptr_t)os::reserve_memory(size, NULL, alignment, mtGC);
   if (addr == 0) {
     log_error(gc, marking)("Failed to reserve address space for mark stacks");
@@ -53,12 +61,31 @@ ZMarkStackSpace::ZMarkStackSpace() :
 
   // Register mark stack space start
   ZMarkStackSpaceStart = _start;
+
+  // Use compact mark stack entries if the heap is small enough for
+  // most object offsets to fit in a compact entry. The high half of a
+  // full entry is then told apart from a compact entry by bit 31, which
+  // requires that the partial array offset field never has its top bit
+  // set, i.e. that all shifted address offsets fit in 31 bits.
+  const bool compact = ZMarkStackCompactEntries &&
+                       MaxHeapSize <= ZMarkStackCompactOffsetMax &&
+                       (ZAddressOffsetMax >> ZMarkPartialArrayMinSizeShift) <= ((size_t)1 << 31);
+  ZMarkStackCompactOffsetLimit = compact ? ZMarkStackCompactOffsetMax : 0;
+  log_info(gc, init)("Mark Stack Entries: %s", compact ? "Compact" : "Full");
 }
 
 bool ZMarkStackSpace::is_initialized() const {
   return _start != 0;
 }
 
+size_t ZMarkStackSpace::used() const {
+  return Atomic::load(&_top) - _start;
+}
+
+size_t ZMarkStackSpace::committed() const {
+  return Atomic::load(&_end) - _start;
+}
+
 uintptr_t ZMarkStackSpace::alloc_space(size_t size) {
   uintptr_t top = Atomic::load(&_top);
 
@@ -106,7 +133,7 @@ uintptr_t ZMarkStackSpace::expand_and_alloc_space(size_t size) {
                          old_size / M, new_size / M);
 
   // Expand
-  os::commit_memory_or_exit((char*)_end, expand_size, false /* executable */, "Mark stack space");
+  os::commit_memory_or_exit((char*)_end, expand_size, mark_stack_space_alignment(), false /* executable */, "Mark stack space");
 
   // Increment top before end to make sure another
   // thread can't steal out newly expanded space.
@@ -125,9 +152,36 @@ uintptr_t ZMarkStackSpace::alloc(size_t size) {
   return expand_and_alloc_space(size);
 }
 
+void ZMarkStackSpace::reset(size_t retain) {
+  ZLocker<ZLock> locker(&_expand_lock);
+
+  // Keep at least the initial expansion committed
+  const size_t retain_size = align_up(MAX2(retain, ZMarkStackSpaceExpandSize), ZMarkStackSpaceExpandSize);
+  const size_t old_size = _end - _start;
+
+  if (old_size > retain_size) {
+    const size_t uncommit_size = old_size - retain_size;
+
+    log_debug(gc, marking)("Shrinking mark stack space: " SIZE_FORMAT "M->" SIZE_FORMAT "M",
+                           old_size / M, retain_size / M);
+
+    // Shrink
+    if (os::uncommit_memory((char*)(_start + retain_size), uncommit_size)) {
+      Atomic::store(&_end, _start + retain_size);
+    } else {
+      log_error(gc, marking)("Failed to uncommit mark stack space");
+    }
+  }
+
+  // Make all space available again
+  Atomic::store(&_top, _start);
+}
+
 ZMarkStackAllocator::ZMarkStackAllocator() :
     _freelist(),
-    _space() {
+    _space(),
+    _used_history(),
+    _used_history_index(0) {
   guarantee(sizeof(ZMarkStack) == ZMarkStackSize, "Size mismatch");
   guarantee(sizeof(ZMarkStackMagazine) <= ZMarkStackSize, "Size mismatch");
 
@@ -142,6 +196,34 @@ bool ZMarkStackAllocator::is_initialized() const {
   return _space.is_initialized();
 }
 
+size_t ZMarkStackAllocator::used() const {
+  return _space.used();
+}
+
+size_t ZMarkStackAllocator::committed() const {
+  return _space.committed();
+}
+
+void ZMarkStackAllocator::reset() {
+  // Record how much space was used during this cycle
+  _used_history[_used_history_index] = _space.used();
+  _used_history_index = (_used_history_index + 1) % ZMarkStackSpaceRetainCycles;
+
+  // Retain enough space to cover the largest usage seen in the last
+  // few cycles. Space beyond that has been unused for a while and is
+  // returned to the operating system.
+  size_t retain = 0;
+  for (size_t i = 0; i < ZMarkStackSpaceRetainCycles; i++) {
+    retain = MAX2(retain, _used_history[i]);
+  }
+
+  // All magazines are unused at this point. Forget them, reset
+  // the space and prime the free list from the start again.
+  _freelist.clear();
+  _space.reset(retain);
+  prime_freelist();
+}
+
 void ZMarkStackAllocator::prime_freelist() {
   for (size_t size = 0; size < ZMarkStackSpaceExpandSize; size += ZMarkStackMagazineSize) {
     const uintptr_t addr = _space.alloc(ZMarkStackMagazineSize);
@@ -45,13 +45,19 @@ public:
 
   bool is_initialized() const;
 
+  size_t used() const;
+  size_t committed() const;
+
   uintptr_t alloc(size_t size);
+  void reset(size_t retain);
 };
 
 class ZMarkStackAllocator {
 private:
   ZCACHE_ALIGNED ZMarkStackMagazineList _freelist;
   ZCACHE_ALIGNED ZMarkStackSpace        _space;
+  size_t                                _used_history[ZMarkStackSpaceRetainCycles];
+  size_t                                _used_history_index;
 
   void prime_freelist();
   ZMarkStackMagazine* create_magazine_from_space(uintptr_t addr, size_t size);
@@ -61,6 +67,11 @@ public:
 
   bool is_initialized() const;
 
+  size_t used() const;
+  size_t committed() const;
+
+  void reset();
+
   ZMarkStackMagazine* alloc_magazine();
   void free_magazine(ZMarkStackMagazine* magazine);
 };
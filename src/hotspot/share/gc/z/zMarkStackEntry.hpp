@@ -98,6 +98,16 @@ public:
              field_partial_array::encode(true) |
              field_finalizable::encode(finalizable)) {}
 
+  static ZMarkStackEntry decode(uint64_t value) {
+    ZMarkStackEntry entry;
+    entry._entry = value;
+    return entry;
+  }
+
+  uint64_t encode() const {
+    return _entry;
+  }
+
   bool finalizable() const {
     return field_finalizable::decode(_entry);
   }
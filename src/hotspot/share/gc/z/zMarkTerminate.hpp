@@ -25,19 +25,27 @@
 #define SHARE_GC_Z_ZMARKTERMINATE_HPP
 
 #include "gc/z/zGlobals.hpp"
+#include "gc/z/zLock.hpp"
 #include "memory/allocation.hpp"
 #include "utilities/globalDefinitions.hpp"
 
+class ZMarkStripeSet;
+
 class ZMarkTerminate {
 private:
   uint                         _nworkers;
   ZCACHE_ALIGNED volatile uint _nworking_stage0;
   volatile uint                _nworking_stage1;
+  ZCACHE_ALIGNED volatile uint _nidle;
+  ZConditionLock               _lock;
 
   bool enter_stage(volatile uint* nworking_stage);
   void exit_stage(volatile uint* nworking_stage);
   bool try_exit_stage(volatile uint* nworking_stage);
 
+  bool should_wake_up(const ZMarkStripeSet* stripes) const;
+  void park(const ZMarkStripeSet* stripes);
+
 public:
   ZMarkTerminate();
 
@@ -49,6 +57,10 @@ public:
 
   bool enter_stage1();
   bool try_exit_stage1();
+
+  bool has_idle() const;
+  void idle(const ZMarkStripeSet* stripes);
+  void wake_up();
 };
 
 #endif // SHARE_GC_Z_ZMARKTERMINATE_HPP
@@ -24,12 +24,18 @@
 #ifndef SHARE_GC_Z_ZMARKTERMINATE_INLINE_HPP
 #define SHARE_GC_Z_ZMARKTERMINATE_INLINE_HPP
 
+#include "gc/z/zLock.inline.hpp"
+#include "gc/z/zMarkStack.inline.hpp"
+#include "gc/z/zMarkTerminate.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
 
 inline ZMarkTerminate::ZMarkTerminate() :
     _nworkers(0),
     _nworking_stage0(0),
-    _nworking_stage1(0) {}
+    _nworking_stage1(0),
+    _nidle(0),
+    _lock() {}
 
 inline bool ZMarkTerminate::enter_stage(volatile uint* nworking_stage) {
   return Atomic::sub(nworking_stage, 1u) == 0;
@@ -83,4 +89,59 @@ inline bool ZMarkTerminate::try_exit_stage1() {
   return try_exit_stage(&_nworking_stage1);
 }
 
+inline bool ZMarkTerminate::should_wake_up(const ZMarkStripeSet* stripes) const {
+  // Wake up if more work has been published, or if
+  // all workers have entered termination stage 1.
+  return !stripes->is_empty() || Atomic::load(&_nworking_stage1) == 0;
+}
+
+inline void ZMarkTerminate::park(const ZMarkStripeSet* stripes) {
+  // Announce that we are about to park before checking the wake up
+  // condition, so that a worker publishing work after our check is
+  // guaranteed to see us and notify us.
+  Atomic::inc(&_nidle);
+
+  {
+    ZLocker<ZConditionLock> locker(&_lock);
+    while (!should_wake_up(stripes)) {
+      // Work published by mutators does not notify parked workers,
+      // so bound the wait to make sure such work is picked up.
+      if (!_lock.wait(ZMarkIdleParkTimeout)) {
+        // Timeout
+        break;
+      }
+    }
+  }
+
+  Atomic::dec(&_nidle);
+}
+
+inline bool ZMarkTerminate::has_idle() const {
+  return Atomic::load(&_nidle) != 0;
+}
+
+inline void ZMarkTerminate::idle(const ZMarkStripeSet* stripes) {
+  // Spin for a while, since new work or termination
+  // often follows shortly, then park.
+  for (size_t i = 0; i < ZMarkIdleSpinMax; i++) {
+    if (should_wake_up(stripes)) {
+      return;
+    }
+
+    SpinPause();
+  }
+
+  park(stripes);
+}
+
+inline void ZMarkTerminate::wake_up() {
+  if (!has_idle()) {
+    // No parked workers
+    return;
+  }
+
+  ZLocker<ZConditionLock> locker(&_lock);
+  _lock.notify_all();
+}
+
 #endif // SHARE_GC_Z_ZMARKTERMINATE_INLINE_HPP
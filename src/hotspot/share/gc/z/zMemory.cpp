@@ -23,6 +23,7 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zList.inline.hpp"
+#include "gc/z/zLock.inline.hpp"
 #include "gc/z/zMemory.inline.hpp"
 #include "memory/allocation.inline.hpp"
 
@@ -78,6 +79,7 @@ ZMemoryManager::Callbacks::Callbacks() :
     _grow_from_back(NULL) {}
 
 ZMemoryManager::ZMemoryManager() :
+    _lock(),
     _freelist(),
     _callbacks() {}
 
@@ -86,6 +88,8 @@ void ZMemoryManager::register_callbacks(const Callbacks& callbacks) {
 }
 
 uintptr_t ZMemoryManager::alloc_from_front(size_t size) {
+  ZLocker<ZLock> locker(&_lock);
+
   ZListIterator<ZMemory> iter(&_freelist);
   for (ZMemory* area; iter.next(&area);) {
     if (area->size() >= size) {
@@ -109,6 +113,8 @@ uintptr_t ZMemoryManager::alloc_from_front(size_t size) {
 }
 
 uintptr_t ZMemoryManager::alloc_from_front_at_most(size_t size, size_t* allocated) {
+  ZLocker<ZLock> locker(&_lock);
+
   ZMemory* area = _freelist.first();
   if (area != NULL) {
     if (area->size() <= size) {
@@ -133,6 +139,8 @@ uintptr_t ZMemoryManager::alloc_from_front_at_most(size_t size, size_t* allocate
 }
 
 uintptr_t ZMemoryManager::alloc_from_back(size_t size) {
+  ZLocker<ZLock> locker(&_lock);
+
   ZListReverseIterator<ZMemory> iter(&_freelist);
   for (ZMemory* area; iter.next(&area);) {
     if (area->size() >= size) {
@@ -154,7 +162,40 @@ uintptr_t ZMemoryManager::alloc_from_back(size_t size) {
   return UINTPTR_MAX;
 }
 
+uintptr_t ZMemoryManager::peek_from_back(size_t size) {
+  ZLocker<ZLock> locker(&_lock);
+
+  // Returns the start of the area that would be allocated
+  // by alloc_from_back(), without allocating it
+  ZListReverseIterator<ZMemory> iter(&_freelist);
+  for (ZMemory* area; iter.next(&area);) {
+    if (area->size() >= size) {
+      return area->end() - size;
+    }
+  }
+
+  // Out of memory
+  return UINTPTR_MAX;
+}
+
+void ZMemoryManager::free_stats(size_t* nareas, size_t* size, size_t* largest) {
+  ZLocker<ZLock> locker(&_lock);
+
+  *nareas = 0;
+  *size = 0;
+  *largest = 0;
+
+  ZListIterator<ZMemory> iter(&_freelist);
+  for (ZMemory* area; iter.next(&area);) {
+    (*nareas)++;
+    *size += area->size();
+    *largest = MAX2(*largest, area->size());
+  }
+}
+
 uintptr_t ZMemoryManager::alloc_from_back_at_most(size_t size, size_t* allocated) {
+  ZLocker<ZLock> locker(&_lock);
+
   ZMemory* area = _freelist.last();
   if (area != NULL) {
     if (area->size() <= size) {
@@ -181,6 +222,8 @@ void ZMemoryManager::free(uintptr_t start, size_t size) {
   assert(start != UINTPTR_MAX, "Invalid address");
   const uintptr_t end = start + size;
 
+  ZLocker<ZLock> locker(&_lock);
+
   ZListIterator<ZMemory> iter(&_freelist);
   for (ZMemory* area; iter.next(&area);) {
     if (start < area->start()) {
@@ -25,6 +25,7 @@
 #define SHARE_GC_Z_ZMEMORY_HPP
 
 #include "gc/z/zList.hpp"
+#include "gc/z/zLock.hpp"
 #include "memory/allocation.hpp"
 
 class ZMemory : public CHeapObj<mtGC> {
@@ -65,6 +66,7 @@ public:
   };
 
 private:
+  ZLock          _lock;
   ZList<ZMemory> _freelist;
   Callbacks      _callbacks;
 
@@ -84,8 +86,11 @@ public:
   uintptr_t alloc_from_front_at_most(size_t size, size_t* allocated);
   uintptr_t alloc_from_back(size_t size);
   uintptr_t alloc_from_back_at_most(size_t size, size_t* allocated);
+  uintptr_t peek_from_back(size_t size);
 
   void free(uintptr_t start, size_t size);
+
+  void free_stats(size_t* nareas, size_t* size, size_t* largest);
 };
 
 #endif // SHARE_GC_Z_ZMEMORY_HPP
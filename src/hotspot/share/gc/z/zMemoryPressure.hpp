@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZMEMORYPRESSURE_HPP
+#define SHARE_GC_Z_ZMEMORYPRESSURE_HPP
+
+#include "memory/allocation.hpp"
+
+class ZMemoryPressure : public AllStatic {
+private:
+  static bool _enabled;
+
+  static bool initialize_platform();
+
+public:
+  static void initialize();
+  static bool is_enabled();
+
+  // Percentage of time some threads were stalled waiting for memory
+  static double pressure();
+
+  // Memory limit above which the memory usage is throttled (SIZE_MAX
+  // if there is no limit), and the current memory usage, excluding the
+  // reclaimable page cache
+  static size_t limit();
+  static size_t usage();
+};
+
+#endif // SHARE_GC_Z_ZMEMORYPRESSURE_HPP
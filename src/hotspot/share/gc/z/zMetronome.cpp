@@ -32,9 +32,10 @@ ZMetronome::ZMetronome(uint64_t hz) :
     _interval_ms(MILLIUNITS / hz),
     _start_ms(0),
     _nticks(0),
-    _stopped(false) {}
+    _stopped(false),
+    _woken(false) {}
 
-bool ZMetronome::wait_for_tick() {
+bool ZMetronome::wait(bool* woken) {
   if (_nticks++ == 0) {
     // First tick, set start time
     const Ticks now = Ticks::now();
@@ -44,6 +45,15 @@ bool ZMetronome::wait_for_tick() {
   MonitorLocker ml(&_monitor, Monitor::_no_safepoint_check_flag);
 
   while (!_stopped) {
+    if (woken != NULL && _woken) {
+      // Woken up before the next tick. The tick is still
+      // pending, so don't count this as one.
+      _woken = false;
+      _nticks--;
+      *woken = true;
+      return true;
+    }
+
     // We might wake up spuriously from wait, so always recalculate
     // the timeout after a wakeup to see if we need to wait again.
     const Ticks now = Ticks::now();
@@ -66,6 +76,12 @@ bool ZMetronome::wait_for_tick() {
         }
       }
 
+      if (woken != NULL) {
+        // A wakeup that raced with the tick is subsumed by it
+        _woken = false;
+        *woken = false;
+      }
+
       return true;
     }
   }
@@ -74,6 +90,20 @@ bool ZMetronome::wait_for_tick() {
   return false;
 }
 
+bool ZMetronome::wait_for_tick() {
+  return wait(NULL /* woken */);
+}
+
+bool ZMetronome::wait_for_tick_or_wakeup(bool* woken) {
+  return wait(woken);
+}
+
+void ZMetronome::wakeup() {
+  MonitorLocker ml(&_monitor, Monitor::_no_safepoint_check_flag);
+  _woken = true;
+  ml.notify();
+}
+
 void ZMetronome::stop() {
   MonitorLocker ml(&_monitor, Monitor::_no_safepoint_check_flag);
   _stopped = true;
@@ -34,11 +34,16 @@ private:
   uint64_t       _start_ms;
   uint64_t       _nticks;
   bool           _stopped;
+  bool           _woken;
+
+  bool wait(bool* woken);
 
 public:
   ZMetronome(uint64_t hz);
 
   bool wait_for_tick();
+  bool wait_for_tick_or_wakeup(bool* woken);
+  void wakeup();
   void stop();
 };
 
@@ -22,6 +22,7 @@
  */
 
 #include "precompiled.hpp"
+#include "code/codeCache.hpp"
 #include "code/relocInfo.hpp"
 #include "code/nmethod.hpp"
 #include "code/icBuffer.hpp"
@@ -33,6 +34,7 @@
 #include "gc/z/zNMethodData.hpp"
 #include "gc/z/zNMethodTable.hpp"
 #include "gc/z/zOopClosures.inline.hpp"
+#include "gc/z/zStat.hpp"
 #include "gc/z/zTask.hpp"
 #include "gc/z/zWorkers.hpp"
 #include "logging/log.hpp"
@@ -43,6 +45,8 @@
 #include "runtime/atomic.hpp"
 #include "utilities/debug.hpp"
 
+static const ZStatCounter ZCounterColdNMethods("Memory", "Cold NMethod Unload", ZStatUnitOpsPerSecond);
+
 static ZNMethodData* gc_data(const nmethod* nm) {
   return nm->gc_data<ZNMethodData>();
 }
@@ -212,6 +216,36 @@ void ZNMethod::disarm(nmethod* nm) {
   }
 }
 
+void ZNMethod::record_entry(nmethod* nm) {
+  gc_data(nm)->set_entered_seqnum(ZGlobalSeqNum);
+}
+
+bool ZNMethod::is_cold(nmethod* nm) {
+  assert(lock_for_nmethod(nm)->is_owned(), "Should be owned");
+
+  if (ZNMethodColdCycles == 0 ||
+      !supports_entry_barrier(nm) ||
+      nm->is_osr_method() ||
+      nm->is_native_method() ||
+      nm->method()->is_method_handle_intrinsic()) {
+    return false;
+  }
+
+  // All nmethods are armed at mark start. An nmethod that is still
+  // armed, and that has not taken the entry barrier during this GC
+  // cycle, has not been called since the previous GC cycle.
+  ZNMethodData* const data = gc_data(nm);
+  const bool entered = !is_armed(nm) || data->entered_seqnum() == ZGlobalSeqNum;
+  const uint8_t cold_cycles = data->update_cold_cycles(entered);
+  if (cold_cycles < ZNMethodColdCycles) {
+    return false;
+  }
+
+  log_debug(gc, nmethod)("Cold nmethod: " PTR_FORMAT " (cycles: %u)", p2i(nm), cold_cycles);
+  ZStatInc(ZCounterColdNMethods);
+  return true;
+}
+
 void ZNMethod::nmethod_oops_do(nmethod* nm, OopClosure* cl) {
   // Process oops table
   {
@@ -243,15 +277,33 @@ void ZNMethod::nmethod_oops_do(nmethod* nm, OopClosure* cl) {
   }
 }
 
-class ZNMethodToOopsDoClosure : public NMethodClosure {
+class ZNMethodOopsDoConcurrentClosure : public NMethodClosure {
 private:
-  OopClosure* _cl;
+  OopClosure* const _cl;
 
 public:
-  ZNMethodToOopsDoClosure(OopClosure* cl) :
+  ZNMethodOopsDoConcurrentClosure(OopClosure* cl) :
       _cl(cl) {}
 
   virtual void do_nmethod(nmethod* nm) {
+    if (!nm->is_alive()) {
+      return;
+    }
+
+    ZLocker<ZReentrantLock> locker(ZNMethod::lock_for_nmethod(nm));
+
+    if (!ZNMethod::supports_entry_barrier(nm)) {
+      // Heal oops
+      ZNMethodOopClosure cl;
+      ZNMethod::nmethod_oops_do(nm, &cl);
+    } else if (ZNMethod::is_armed(nm)) {
+      // Heal oops and disarm, unless the entry barrier already did
+      ZNMethodOopClosure cl;
+      ZNMethod::nmethod_oops_do(nm, &cl);
+      ZNMethod::disarm(nm);
+    }
+
+    // Apply the closure to the healed oops
     ZNMethod::nmethod_oops_do(nm, _cl);
   }
 };
@@ -264,8 +316,8 @@ void ZNMethod::oops_do_end() {
   ZNMethodTable::nmethods_do_end();
 }
 
-void ZNMethod::oops_do(OopClosure* cl) {
-  ZNMethodToOopsDoClosure nmethod_cl(cl);
+void ZNMethod::oops_do_concurrent(OopClosure* cl) {
+  ZNMethodOopsDoConcurrentClosure nmethod_cl(cl);
   ZNMethodTable::nmethods_do(&nmethod_cl);
 }
 
@@ -273,11 +325,18 @@ class ZNMethodUnlinkClosure : public NMethodClosure {
 private:
   bool          _unloading_occurred;
   volatile bool _failed;
+  volatile bool _unlinked;
 
   void set_failed() {
     Atomic::store(&_failed, true);
   }
 
+  void set_unlinked() {
+    if (!Atomic::load(&_unlinked)) {
+      Atomic::store(&_unlinked, true);
+    }
+  }
+
   void unlink(nmethod* nm) {
     // Unlinking of the dependencies must happen before the
     // handshake separating unlink and purge.
@@ -300,7 +359,8 @@ private:
 public:
   ZNMethodUnlinkClosure(bool unloading_occurred) :
       _unloading_occurred(unloading_occurred),
-      _failed(false) {}
+      _failed(false),
+      _unlinked(false) {}
 
   virtual void do_nmethod(nmethod* nm) {
     if (failed()) {
@@ -314,10 +374,18 @@ public:
     if (nm->is_unloading()) {
       ZLocker<ZReentrantLock> locker(ZNMethod::lock_for_nmethod(nm));
       unlink(nm);
+      set_unlinked();
       return;
     }
 
-    ZLocker<ZReentrantLock> locker(ZNMethod::lock_for_nmethod(nm));
+    ZNMethodData* const data = gc_data(nm);
+    ZLocker<ZReentrantLock> locker(data->lock());
+
+    if (data->unlinked_cycle() == CodeCache::unloading_cycle()) {
+      // Already cleaned by an earlier attempt in this unloading
+      // cycle, which was restarted after refilling IC stubs.
+      return;
+    }
 
     if (ZNMethod::is_armed(nm)) {
       // Heal oops and disarm
@@ -329,12 +397,19 @@ public:
     // Clear compiled ICs and exception caches
     if (!nm->unload_nmethod_caches(_unloading_occurred)) {
       set_failed();
+      return;
     }
+
+    data->set_unlinked_cycle(CodeCache::unloading_cycle());
   }
 
   bool failed() const {
     return Atomic::load(&_failed);
   }
+
+  bool unlinked() const {
+    return Atomic::load(&_unlinked);
+  }
 };
 
 class ZNMethodUnlinkTask : public ZTask {
@@ -362,17 +437,24 @@ public:
   bool success() const {
     return !_cl.failed();
   }
+
+  bool unlinked() const {
+    return _cl.unlinked();
+  }
 };
 
-void ZNMethod::unlink(ZWorkers* workers, bool unloading_occurred) {
+bool ZNMethod::unlink(ZWorkers* workers, bool unloading_occurred) {
+  bool unlinked = false;
+
   for (;;) {
     ICRefillVerifier verifier;
 
     {
       ZNMethodUnlinkTask task(unloading_occurred, &verifier);
       workers->run_concurrent(&task);
+      unlinked |= task.unlinked();
       if (task.success()) {
-        return;
+        return unlinked;
       }
     }
 
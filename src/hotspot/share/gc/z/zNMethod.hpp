@@ -48,15 +48,18 @@ public:
   static bool is_armed(nmethod* nm);
   static void disarm(nmethod* nm);
 
+  static void record_entry(nmethod* nm);
+  static bool is_cold(nmethod* nm);
+
   static void nmethod_oops_do(nmethod* nm, OopClosure* cl);
 
   static void oops_do_begin();
   static void oops_do_end();
-  static void oops_do(OopClosure* cl);
+  static void oops_do_concurrent(OopClosure* cl);
 
   static ZReentrantLock* lock_for_nmethod(nmethod* nm);
 
-  static void unlink(ZWorkers* workers, bool unloading_occurred);
+  static bool unlink(ZWorkers* workers, bool unloading_occurred);
   static void purge(ZWorkers* workers);
 };
 
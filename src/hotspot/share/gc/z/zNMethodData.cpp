@@ -66,7 +66,10 @@ bool ZNMethodDataOops::has_non_immediates() const {
 
 ZNMethodData::ZNMethodData() :
     _lock(),
-    _oops(NULL) {}
+    _oops(NULL),
+    _unlinked_cycle(0),
+    _entered_seqnum(0),
+    _cold_cycles(0) {}
 
 ZNMethodData::~ZNMethodData() {
   ZNMethodDataOops::destroy(_oops);
@@ -86,3 +89,35 @@ ZNMethodDataOops* ZNMethodData::swap_oops(ZNMethodDataOops* new_oops) {
   _oops = new_oops;
   return old_oops;
 }
+
+uint8_t ZNMethodData::unlinked_cycle() const {
+  return _unlinked_cycle;
+}
+
+void ZNMethodData::set_unlinked_cycle(uint8_t cycle) {
+  assert(_lock.is_owned(), "Should be owned");
+  _unlinked_cycle = cycle;
+}
+
+uint32_t ZNMethodData::entered_seqnum() const {
+  return Atomic::load(&_entered_seqnum);
+}
+
+void ZNMethodData::set_entered_seqnum(uint32_t seqnum) {
+  Atomic::store(&_entered_seqnum, seqnum);
+}
+
+uint8_t ZNMethodData::cold_cycles() const {
+  return _cold_cycles;
+}
+
+uint8_t ZNMethodData::update_cold_cycles(bool entered) {
+  assert(_lock.is_owned(), "Should be owned");
+  if (entered) {
+    _cold_cycles = 0;
+  } else if (_cold_cycles < max_jubyte) {
+    _cold_cycles++;
+  }
+
+  return _cold_cycles;
+}
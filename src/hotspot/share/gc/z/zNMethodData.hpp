@@ -57,6 +57,9 @@ class ZNMethodData : public CHeapObj<mtGC> {
 private:
   ZReentrantLock             _lock;
   ZNMethodDataOops* volatile _oops;
+  uint8_t                    _unlinked_cycle;
+  volatile uint32_t          _entered_seqnum;
+  uint8_t                    _cold_cycles;
 
 public:
   ZNMethodData();
@@ -66,6 +69,15 @@ public:
 
   ZNMethodDataOops* oops() const;
   ZNMethodDataOops* swap_oops(ZNMethodDataOops* oops);
+
+  uint8_t unlinked_cycle() const;
+  void set_unlinked_cycle(uint8_t cycle);
+
+  uint32_t entered_seqnum() const;
+  void set_entered_seqnum(uint32_t seqnum);
+
+  uint8_t cold_cycles() const;
+  uint8_t update_cold_cycles(bool entered);
 };
 
 #endif // SHARE_GC_Z_ZNMETHODDATA_HPP
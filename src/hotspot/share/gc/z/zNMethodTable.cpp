@@ -48,6 +48,10 @@ ZNMethodTableEntry* ZNMethodTable::_table = NULL;
 size_t ZNMethodTable::_size = 0;
 size_t ZNMethodTable::_nregistered = 0;
 size_t ZNMethodTable::_nunregistered = 0;
+ZNMethodTableEntry* ZNMethodTable::_old_table = NULL;
+size_t ZNMethodTable::_old_size = 0;
+size_t ZNMethodTable::_old_nregistered = 0;
+size_t ZNMethodTable::_old_transferred = 0;
 ZNMethodTableIteration ZNMethodTable::_iteration;
 ZSafeDeleteNoLock<ZNMethodTableEntry[]> ZNMethodTable::_safe_delete;
 
@@ -87,23 +91,81 @@ bool ZNMethodTable::register_entry(ZNMethodTableEntry* table, size_t size, nmeth
   }
 }
 
-void ZNMethodTable::unregister_entry(ZNMethodTableEntry* table, size_t size, nmethod* nm) {
+bool ZNMethodTable::unregister_entry(ZNMethodTableEntry* table, size_t size, nmethod* nm) {
   size_t index = first_index(nm, size);
 
   for (;;) {
     const ZNMethodTableEntry table_entry = table[index];
-    assert(table_entry.registered() || table_entry.unregistered(), "Entry not found");
+
+    if (!table_entry.registered() && !table_entry.unregistered()) {
+      // Entry not found
+      return false;
+    }
 
     if (table_entry.registered() && table_entry.method() == nm) {
       // Remove entry
       table[index] = ZNMethodTableEntry(true /* unregistered */);
-      return;
+      return true;
+    }
+
+    index = next_index(index, size);
+  }
+}
+
+bool ZNMethodTable::contains_entry(const ZNMethodTableEntry* table, size_t size, nmethod* nm) {
+  size_t index = first_index(nm, size);
+
+  for (;;) {
+    const ZNMethodTableEntry table_entry = table[index];
+
+    if (!table_entry.registered() && !table_entry.unregistered()) {
+      // Entry not found
+      return false;
+    }
+
+    if (table_entry.registered() && table_entry.method() == nm) {
+      // Entry found
+      return true;
     }
 
     index = next_index(index, size);
   }
 }
 
+bool ZNMethodTable::is_transferring() {
+  return _old_table != NULL;
+}
+
+void ZNMethodTable::transfer(size_t nentries) {
+  assert(CodeCache_lock->owned_by_self(), "Lock must be held");
+  assert(is_transferring(), "Should be transferring");
+  assert(!_iteration.in_progress(), "Should not be iterating");
+
+  // Move registered entries from the old table to the current table. The
+  // old slot is replaced with an unregistered entry, which keeps the probe
+  // sequences of the remaining old entries intact.
+  const size_t end = MIN2(_old_transferred + nentries, _old_size);
+  for (size_t i = _old_transferred; i < end; i++) {
+    const ZNMethodTableEntry entry = _old_table[i];
+    if (entry.registered()) {
+      register_entry(_table, _size, entry.method());
+      _old_table[i] = ZNMethodTableEntry(true /* unregistered */);
+      _old_nregistered--;
+    }
+  }
+
+  _old_transferred = end;
+
+  if (_old_transferred == _old_size) {
+    assert(_old_nregistered == 0, "Entries left in old table");
+
+    // Free old table
+    _safe_delete(_old_table);
+    _old_table = NULL;
+    _old_size = 0;
+  }
+}
+
 void ZNMethodTable::rebuild(size_t new_size) {
   assert(CodeCache_lock->owned_by_self(), "Lock must be held");
 
@@ -120,16 +182,41 @@ void ZNMethodTable::rebuild(size_t new_size) {
   // Allocate new table
   ZNMethodTableEntry* const new_table = new ZNMethodTableEntry[new_size];
 
-  // Transfer all registered entries
-  for (size_t i = 0; i < _size; i++) {
-    const ZNMethodTableEntry entry = _table[i];
-    if (entry.registered()) {
-      register_entry(new_table, new_size, entry.method());
+  if (_size != 0 && !is_transferring()) {
+    // Transfer registered entries incrementally, a bounded number
+    // of entries for each registration, instead of all at once
+    _old_table = _table;
+    _old_size = _size;
+    _old_nregistered = _nregistered;
+    _old_transferred = 0;
+  } else {
+    // Transfer all registered entries, including those left in
+    // the old table. Neither table is modified, since they might
+    // be in use by an ongoing iteration.
+    for (size_t i = 0; i < _old_size; i++) {
+      const ZNMethodTableEntry entry = _old_table[i];
+      if (entry.registered()) {
+        register_entry(new_table, new_size, entry.method());
+      }
+    }
+
+    for (size_t i = 0; i < _size; i++) {
+      const ZNMethodTableEntry entry = _table[i];
+      if (entry.registered()) {
+        register_entry(new_table, new_size, entry.method());
+      }
     }
-  }
 
-  // Free old table
-  _safe_delete(_table);
+    // Free old tables
+    if (is_transferring()) {
+      _safe_delete(_old_table);
+      _old_table = NULL;
+      _old_size = 0;
+      _old_nregistered = 0;
+    }
+
+    _safe_delete(_table);
+  }
 
   // Install new table
   _table = new_table;
@@ -148,6 +235,26 @@ void ZNMethodTable::rebuild_if_needed() {
   const size_t prune_threshold = _size * 0.65;
   const size_t grow_threshold = _size * 0.70;
 
+  if (is_transferring()) {
+    // Continue transfer from the old table, unless an iteration is in
+    // progress, since the iteration must still find the old entries.
+    // The current table is sized to hold all entries, so the transfer
+    // normally completes long before the current table fills up.
+    const size_t transfer_nentries = 256;
+    if (!_iteration.in_progress()) {
+      transfer(transfer_nentries);
+    }
+
+    if (_nregistered - _old_nregistered + _nunregistered <= grow_threshold) {
+      return;
+    }
+
+    // Current table filled up before the transfer completed, rebuild
+    // from both tables at once.
+    rebuild(_size * 2);
+    return;
+  }
+
   if (_size == 0) {
     // Initialize table
     rebuild(min_size);
@@ -180,6 +287,24 @@ void ZNMethodTable::register_nmethod(nmethod* nm) {
   // Grow/Shrink/Prune table if needed
   rebuild_if_needed();
 
+  if (is_transferring()) {
+    if (_iteration.in_progress()) {
+      if (contains_entry(_old_table, _old_size, nm)) {
+        // Entry was not yet transferred from the old table. Leave it
+        // there, since moving it while iterating could make an ongoing
+        // iteration miss or revisit it.
+        return;
+      }
+    } else if (unregister_entry(_old_table, _old_size, nm)) {
+      // Entry was not yet transferred from the old table. Re-register it
+      // in the current table, without changing the number of registered
+      // entries.
+      _old_nregistered--;
+      register_entry(_table, _size, nm);
+      return;
+    }
+  }
+
   // Insert new entry
   if (register_entry(_table, _size, nm)) {
     // New entry registered. When register_entry() instead returns
@@ -200,8 +325,16 @@ void ZNMethodTable::wait_until_iteration_done() {
 void ZNMethodTable::unregister_nmethod(nmethod* nm) {
   assert(CodeCache_lock->owned_by_self(), "Lock must be held");
 
+  if (is_transferring() && unregister_entry(_old_table, _old_size, nm)) {
+    // Remove entry not yet transferred from the old table
+    _old_nregistered--;
+    _nregistered--;
+    return;
+  }
+
   // Remove entry
-  unregister_entry(_table, _size, nm);
+  const bool found = unregister_entry(_table, _size, nm);
+  assert(found, "Entry not found");
   _nunregistered++;
   _nregistered--;
 }
@@ -213,7 +346,7 @@ void ZNMethodTable::nmethods_do_begin() {
   _safe_delete.enable_deferred_delete();
 
   // Prepare iteration
-  _iteration.nmethods_do_begin(_table, _size);
+  _iteration.nmethods_do_begin(_table, _size, _old_table, _old_size);
 }
 
 void ZNMethodTable::nmethods_do_end() {
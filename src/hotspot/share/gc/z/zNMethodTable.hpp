@@ -39,6 +39,10 @@ private:
   static size_t                                  _size;
   static size_t                                  _nregistered;
   static size_t                                  _nunregistered;
+  static ZNMethodTableEntry*                     _old_table;
+  static size_t                                  _old_size;
+  static size_t                                  _old_nregistered;
+  static size_t                                  _old_transferred;
   static ZNMethodTableIteration                  _iteration;
   static ZSafeDeleteNoLock<ZNMethodTableEntry[]> _safe_delete;
 
@@ -49,8 +53,11 @@ private:
   static size_t next_index(size_t prev_index, size_t size);
 
   static bool register_entry(ZNMethodTableEntry* table, size_t size, nmethod* nm);
-  static void unregister_entry(ZNMethodTableEntry* table, size_t size, nmethod* nm);
+  static bool unregister_entry(ZNMethodTableEntry* table, size_t size, nmethod* nm);
+  static bool contains_entry(const ZNMethodTableEntry* table, size_t size, nmethod* nm);
 
+  static bool is_transferring();
+  static void transfer(size_t nentries);
   static void rebuild(size_t new_size);
   static void rebuild_if_needed();
 
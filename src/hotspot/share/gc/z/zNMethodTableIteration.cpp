@@ -24,50 +24,62 @@
 #include "precompiled.hpp"
 #include "gc/z/zNMethodTableEntry.hpp"
 #include "gc/z/zNMethodTableIteration.hpp"
+#include "gc/z/zTaskRange.inline.hpp"
 #include "memory/iterator.hpp"
-#include "runtime/atomic.hpp"
 #include "utilities/debug.hpp"
 #include "utilities/globalDefinitions.hpp"
 
 ZNMethodTableIteration::ZNMethodTableIteration() :
     _table(NULL),
     _size(0),
-    _claimed(0) {}
+    _old_table(NULL),
+    _old_size(0),
+    _range(NULL) {}
 
 bool ZNMethodTableIteration::in_progress() const {
   return _table != NULL;
 }
 
-void ZNMethodTableIteration::nmethods_do_begin(ZNMethodTableEntry* table, size_t size) {
+void ZNMethodTableIteration::nmethods_do_begin(ZNMethodTableEntry* table, size_t size, ZNMethodTableEntry* old_table, size_t old_size) {
   assert(!in_progress(), "precondition");
 
   _table = table;
   _size = size;
-  _claimed = 0;
+  _old_table = old_table;
+  _old_size = old_size;
+
+  // Claim table partitions with work stealing. Each partition is currently
+  // sized to span two cache lines. This number is just a guess, but seems
+  // to work well.
+  if (_range == NULL) {
+    _range = new ZTaskRange();
+  }
+
+  const size_t partition_size = (ZCacheLineSize * 2) / sizeof(ZNMethodTableEntry);
+  _range->reset(_old_size + _size, partition_size);
 }
 
 void ZNMethodTableIteration::nmethods_do_end() {
-  assert(_claimed >= _size, "Failed to claim all table entries");
+  assert(_range->is_claimed(), "Failed to claim all table entries");
 
   // Finish iteration
   _table = NULL;
+  _old_table = NULL;
+}
+
+ZNMethodTableEntry ZNMethodTableIteration::entry_at(size_t index) const {
+  // The old table, if any, is iterated first, followed by the current table
+  return (index < _old_size) ? _old_table[index] : _table[index - _old_size];
 }
 
 void ZNMethodTableIteration::nmethods_do(NMethodClosure* cl) {
-  for (;;) {
-    // Claim table partition. Each partition is currently sized to span
-    // two cache lines. This number is just a guess, but seems to work well.
-    const size_t partition_size = (ZCacheLineSize * 2) / sizeof(ZNMethodTableEntry);
-    const size_t partition_start = MIN2(Atomic::add(&_claimed, partition_size) - partition_size, _size);
-    const size_t partition_end = MIN2(partition_start + partition_size, _size);
-    if (partition_start == partition_end) {
-      // End of table
-      break;
-    }
+  size_t partition_start;
+  size_t partition_end;
 
+  while (_range->next(&partition_start, &partition_end)) {
     // Process table partition
     for (size_t i = partition_start; i < partition_end; i++) {
-      const ZNMethodTableEntry entry = _table[i];
+      const ZNMethodTableEntry entry = entry_at(i);
       if (entry.registered()) {
         cl->do_nmethod(entry.method());
       }
@@ -28,19 +28,24 @@
 
 class NMethodClosure;
 class ZNMethodTableEntry;
+class ZTaskRange;
 
 class ZNMethodTableIteration {
 private:
-  ZNMethodTableEntry*            _table;
-  size_t                         _size;
-  ZCACHE_ALIGNED volatile size_t _claimed;
+  ZNMethodTableEntry* _table;
+  size_t              _size;
+  ZNMethodTableEntry* _old_table;
+  size_t              _old_size;
+  ZTaskRange*         _range;
+
+  ZNMethodTableEntry entry_at(size_t index) const;
 
 public:
   ZNMethodTableIteration();
 
   bool in_progress() const;
 
-  void nmethods_do_begin(ZNMethodTableEntry* table, size_t size);
+  void nmethods_do_begin(ZNMethodTableEntry* table, size_t size, ZNMethodTableEntry* old_table, size_t old_size);
   void nmethods_do_end();
   void nmethods_do(NMethodClosure* cl);
 };
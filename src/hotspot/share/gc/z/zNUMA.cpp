@@ -24,16 +24,33 @@
 #include "precompiled.hpp"
 #include "gc/z/zNUMA.hpp"
 #include "logging/log.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/java.hpp"
 #include "runtime/os.hpp"
 
 bool ZNUMA::_enabled;
+bool ZNUMA::_cold_memory;
 
 void ZNUMA::initialize() {
   initialize_platform();
 
+  if (ZColdMemoryNode >= 0) {
+    if (!_enabled) {
+      log_warning(gc, init)("ZColdMemoryNode ignored, NUMA support not enabled");
+    } else if ((uint32_t)ZColdMemoryNode >= count()) {
+      vm_exit_during_initialization("ZColdMemoryNode is not a valid NUMA node");
+    } else {
+      _cold_memory = true;
+    }
+  }
+
   log_info(gc, init)("NUMA Support: %s", to_string());
   if (is_enabled()) {
     log_info(gc, init)("NUMA Nodes: %u", count());
+    log_info(gc, init)("NUMA Small Pages: %s", ZNUMABindSmallPages ? "Local" : "Interleaved");
+    if (_cold_memory) {
+      log_info(gc, init)("NUMA Cold Memory Node: %u", cold_memory_id());
+    }
   }
 }
 
@@ -41,6 +58,15 @@ bool ZNUMA::is_enabled() {
   return _enabled;
 }
 
+bool ZNUMA::has_cold_memory() {
+  return _cold_memory;
+}
+
+uint32_t ZNUMA::cold_memory_id() {
+  assert(_cold_memory, "Cold memory not enabled");
+  return (uint32_t)ZColdMemoryNode;
+}
+
 void ZNUMA::memory_interleave(uintptr_t addr, size_t size) {
   if (!_enabled) {
     // NUMA support not enabled
@@ -50,6 +76,24 @@ void ZNUMA::memory_interleave(uintptr_t addr, size_t size) {
   os::numa_make_global((char*)addr, size);
 }
 
+void ZNUMA::memory_bind_local(uintptr_t addr, size_t size) {
+  if (!_enabled) {
+    // NUMA support not enabled
+    return;
+  }
+
+  os::numa_make_local((char*)addr, size, id());
+}
+
+void ZNUMA::memory_bind_cold(uintptr_t addr, size_t size) {
+  if (!_cold_memory) {
+    // Cold memory not enabled
+    return;
+  }
+
+  os::numa_make_local((char*)addr, size, cold_memory_id());
+}
+
 const char* ZNUMA::to_string() {
   return _enabled ? "Enabled" : "Disabled";
 }
@@ -29,6 +29,7 @@
 class ZNUMA : public AllStatic {
 private:
   static bool _enabled;
+  static bool _cold_memory;
 
   static void initialize_platform();
 
@@ -39,8 +40,13 @@ public:
   static uint32_t count();
   static uint32_t id();
 
+  static bool has_cold_memory();
+  static uint32_t cold_memory_id();
+
   static uint32_t memory_id(uintptr_t addr);
   static void memory_interleave(uintptr_t addr, size_t size);
+  static void memory_bind_local(uintptr_t addr, size_t size);
+  static void memory_bind_cold(uintptr_t addr, size_t size);
 
   static const char* to_string();
 };
@@ -22,6 +22,7 @@
  */
 
 #include "precompiled.hpp"
+#include "gc/z/zHeap.inline.hpp"
 #include "gc/z/zThreadLocalData.hpp"
 #include "gc/z/zObjArrayAllocator.hpp"
 #include "gc/z/zUtils.inline.hpp"
@@ -35,6 +36,15 @@ oop ZObjArrayAllocator::finish(HeapWord* mem) const {
   // Initialize object header and length field
   ObjArrayAllocator::finish(mem);
 
+#ifndef ASSERT
+  // Always clear the elements in debug builds, so that arrays are
+  // verified to be cleared however the page was allocated
+  if (ZHeap::heap()->is_zeroed((uintptr_t)mem)) {
+    // Allocated in a zeroed page, the elements are already cleared
+    return oop(mem);
+  }
+#endif
+
   // Keep the array alive across safepoints through an invisible
   // root. Invisible roots are not visited by the heap itarator
   // and the marking logic will not attempt to follow its elements.
@@ -47,10 +57,20 @@ oop ZObjArrayAllocator::finish(HeapWord* mem) const {
   const size_t skip = arrayOopDesc::header_size(ArrayKlass::cast(_klass)->element_type());
   size_t remaining = _word_size - skip;
 
+  // Clear big arrays using non-temporal stores, to not evict the
+  // working set of the allocating thread from its caches
+  const bool non_temporal = ZNonTemporalZeroLimit > 0 &&
+                            ZUtils::words_to_bytes(_word_size) >= ZNonTemporalZeroLimit;
+
   while (remaining > 0) {
     // Clear segment
     const size_t segment = MIN2(remaining, segment_max);
-    Copy::zero_to_words(mem + (_word_size - remaining), segment);
+    HeapWord* const start = mem + (_word_size - remaining);
+    if (non_temporal) {
+      ZUtils::object_zero_non_temporal((uintptr_t)start, ZUtils::words_to_bytes(segment));
+    } else {
+      Copy::zero_to_words(start, segment);
+    }
     remaining -= segment;
 
     if (remaining > 0) {
@@ -30,6 +30,7 @@
 #include "gc/z/zPage.inline.hpp"
 #include "gc/z/zStat.hpp"
 #include "gc/z/zThread.inline.hpp"
+#include "gc/z/zTracer.inline.hpp"
 #include "gc/z/zUtils.inline.hpp"
 #include "gc/z/zValue.inline.hpp"
 #include "logging/log.hpp"
@@ -42,28 +43,106 @@
 
 static const ZStatCounter ZCounterUndoObjectAllocationSucceeded("Memory", "Undo Object Allocation Succeeded", ZStatUnitOpsPerSecond);
 static const ZStatCounter ZCounterUndoObjectAllocationFailed("Memory", "Undo Object Allocation Failed", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterTLABPageAllocation("Memory", "TLAB Page Allocation", ZStatUnitOpsPerSecond);
 
-ZObjectAllocator::ZObjectAllocator() :
+ZObjectAllocator::ZObjectAllocator(uint8_t partition) :
+    _partition(partition),
     _use_per_cpu_shared_small_pages(ZHeuristics::use_per_cpu_shared_small_pages()),
+    _use_per_cpu_shared_medium_pages(ZHeuristics::use_per_cpu_shared_medium_pages()),
+    _use_per_worker_medium_pages(ZHeuristics::use_per_worker_medium_pages()),
     _used(0),
     _undone(0),
     _shared_medium_page(NULL),
+    _shared_medium_page_tenured(NULL),
+    _shared_medium_page_cpu(NULL),
     _shared_small_page(NULL),
-    _worker_small_page(NULL) {}
+    _shared_small_page_numa(NULL),
+    _worker_small_page(NULL),
+    _worker_small_page_tenured(NULL),
+    _worker_medium_page(NULL),
+    _worker_medium_page_tenured(NULL) {}
+
+// If per-CPU shared small pages can't be used, we fall back to using
+// per-NUMA node shared small pages. This keeps the small pages node-local
+// and avoids having all threads contend on a single shared small page.
 
 ZPage** ZObjectAllocator::shared_small_page_addr() {
-  return _use_per_cpu_shared_small_pages ? _shared_small_page.addr() : _shared_small_page.addr(0);
+  return _use_per_cpu_shared_small_pages ? _shared_small_page.addr() : _shared_small_page_numa.addr();
 }
 
 ZPage* const* ZObjectAllocator::shared_small_page_addr() const {
-  return _use_per_cpu_shared_small_pages ? _shared_small_page.addr() : _shared_small_page.addr(0);
+  return _use_per_cpu_shared_small_pages ? _shared_small_page.addr() : _shared_small_page_numa.addr();
+}
+
+// Objects relocated by GC workers are segregated by age. Objects that have
+// survived fewer than ZTenuringThreshold GC cycles are relocated to survivor
+// pages, and older objects are relocated to tenured pages. This keeps
+// long-lived objects densely packed, away from short-lived objects that
+// would otherwise fragment them again. Survivor and Java allocation pages
+// share the same medium pages, and relocation by non-worker threads always
+// uses the pages shared with Java allocations.
+//
+// With large enough heaps, the medium pages shared with Java allocations
+// are per-CPU instead of per-NUMA node, so that medium allocations from
+// many threads don't contend on the same page. Likewise, GC workers then
+// relocate medium objects to worker-local medium pages, which are not
+// shared with Java allocations, so that relocation of medium pages scales
+// with the number of workers.
+
+ZPerNUMA<ZPage*>* ZObjectAllocator::shared_medium_page(bool tenured) {
+  return tenured ? &_shared_medium_page_tenured : &_shared_medium_page;
+}
+
+ZPage** ZObjectAllocator::shared_medium_page_addr(bool tenured) {
+  if (!tenured && _use_per_cpu_shared_medium_pages) {
+    return _shared_medium_page_cpu.addr();
+  }
+
+  return shared_medium_page(tenured)->addr();
+}
+
+ZPerWorker<ZPage*>* ZObjectAllocator::worker_small_page(bool tenured) {
+  return tenured ? &_worker_small_page_tenured : &_worker_small_page;
+}
+
+ZPerWorker<ZPage*>* ZObjectAllocator::worker_medium_page(bool tenured) {
+  return tenured ? &_worker_medium_page_tenured : &_worker_medium_page;
 }
 
 ZPage* ZObjectAllocator::alloc_page(uint8_t type, size_t size, ZAllocationFlags flags) {
+  // Pages are accounted to the allocation partition of this allocator
+  flags.set_partition(_partition);
+
   ZPage* const page = ZHeap::heap()->alloc_page(type, size, flags);
   if (page != NULL) {
     // Increment used bytes
     Atomic::add(_used.addr(), size);
+
+    // Objects on tenured pages are at least ZTenuringThreshold GC cycles
+    // old. Objects on other relocation pages have survived at least one GC
+    // cycle. All other pages start at age zero, since they can contain newly
+    // allocated objects.
+    if (flags.tenured()) {
+      page->set_object_age(ZTenuringThreshold);
+    } else if (flags.relocation()) {
+      page->set_object_age(1);
+    }
+  }
+
+  return page;
+}
+
+ZPage* ZObjectAllocator::alloc_page_for_object(uint8_t path, uint8_t type, size_t page_size, size_t size, ZAllocationFlags flags) {
+  if (flags.relocation()) {
+    // Relocations are not sampled
+    return alloc_page(type, page_size, flags);
+  }
+
+  // The event duration includes any time spent stalled
+  const Ticks start = Ticks::now();
+  ZPage* const page = alloc_page(type, page_size, flags);
+  if (page != NULL) {
+    ZTracer::tracer()->report_object_allocation_sample(path, size, page, start, Ticks::now());
   }
 
   return page;
@@ -77,6 +156,7 @@ void ZObjectAllocator::undo_alloc_page(ZPage* page) {
 }
 
 uintptr_t ZObjectAllocator::alloc_object_in_shared_page(ZPage** shared_page,
+                                                        uint8_t path,
                                                         uint8_t page_type,
                                                         size_t page_size,
                                                         size_t size,
@@ -90,7 +170,7 @@ uintptr_t ZObjectAllocator::alloc_object_in_shared_page(ZPage** shared_page,
 
   if (addr == 0) {
     // Allocate new page
-    ZPage* const new_page = alloc_page(page_type, page_size, flags);
+    ZPage* const new_page = alloc_page_for_object(path, page_type, page_size, size, flags);
     if (new_page != NULL) {
       // Allocate object before installing the new page
       addr = new_page->alloc_object(size);
@@ -125,14 +205,43 @@ uintptr_t ZObjectAllocator::alloc_object_in_shared_page(ZPage** shared_page,
   return addr;
 }
 
+uintptr_t ZObjectAllocator::alloc_object_in_worker_page(ZPerWorker<ZPage*>* worker_page,
+                                                        uint8_t page_type,
+                                                        size_t page_size,
+                                                        size_t size,
+                                                        ZAllocationFlags flags) {
+  assert(ZThread::is_worker(), "Should be a worker thread");
+
+  ZPage* page = worker_page->get();
+  uintptr_t addr = 0;
+
+  if (page != NULL) {
+    addr = page->alloc_object(size);
+  }
+
+  if (addr == 0) {
+    // Allocate new page
+    page = alloc_page(page_type, page_size, flags);
+    if (page != NULL) {
+      addr = page->alloc_object(size);
+    }
+    worker_page->set(page);
+  }
+
+  return addr;
+}
+
 uintptr_t ZObjectAllocator::alloc_large_object(size_t size, ZAllocationFlags flags) {
   assert(ZThread::is_java(), "Should be a Java thread");
 
   uintptr_t addr = 0;
 
+  // Prefer a zeroed page, which lets the object skip clearing
+  flags.set_zeroed();
+
   // Allocate new large page
   const size_t page_size = align_up(size, ZGranuleSize);
-  ZPage* const page = alloc_page(ZPageTypeLarge, page_size, flags);
+  ZPage* const page = alloc_page_for_object(ZAllocationPathLarge, ZPageTypeLarge, page_size, size, flags);
   if (page != NULL) {
     // Allocate the object
     addr = page->alloc_object(size);
@@ -141,8 +250,23 @@ uintptr_t ZObjectAllocator::alloc_large_object(size_t size, ZAllocationFlags fla
   return addr;
 }
 
+uintptr_t ZObjectAllocator::alloc_medium_object_from_worker(size_t size, ZAllocationFlags flags) {
+  return alloc_object_in_worker_page(worker_medium_page(flags.tenured()), ZPageTypeMedium, ZPageSizeMedium, size, flags);
+}
+
 uintptr_t ZObjectAllocator::alloc_medium_object(size_t size, ZAllocationFlags flags) {
-  return alloc_object_in_shared_page(_shared_medium_page.addr(), ZPageTypeMedium, ZPageSizeMedium, size, flags);
+  if (flags.worker_thread() && _use_per_worker_medium_pages) {
+    return alloc_medium_object_from_worker(size, flags);
+  }
+
+  if (!flags.relocation()) {
+    // Prefer a zeroed page, which lets objects skip clearing
+    flags.set_zeroed();
+  }
+
+  const uint8_t path = (!flags.tenured() && _use_per_cpu_shared_medium_pages) ? ZAllocationPathPerCPUMedium
+                                                                              : ZAllocationPathSharedMedium;
+  return alloc_object_in_shared_page(shared_medium_page_addr(flags.tenured()), path, ZPageTypeMedium, ZPageSizeMedium, size, flags);
 }
 
 uintptr_t ZObjectAllocator::alloc_small_object_from_nonworker(size_t size, ZAllocationFlags flags) {
@@ -151,30 +275,12 @@ uintptr_t ZObjectAllocator::alloc_small_object_from_nonworker(size_t size, ZAllo
 
   // Non-worker small page allocation can never use the reserve
   flags.set_no_reserve();
-
-  return alloc_object_in_shared_page(shared_small_page_addr(), ZPageTypeSmall, ZPageSizeSmall, size, flags);
+  const uint8_t path = _use_per_cpu_shared_small_pages ? ZAllocationPathPerCPUSmall : ZAllocationPathSharedSmall;
+  return alloc_object_in_shared_page(shared_small_page_addr(), path, ZPageTypeSmall, ZPageSizeSmall, size, flags);
 }
 
 uintptr_t ZObjectAllocator::alloc_small_object_from_worker(size_t size, ZAllocationFlags flags) {
-  assert(ZThread::is_worker(), "Should be a worker thread");
-
-  ZPage* page = _worker_small_page.get();
-  uintptr_t addr = 0;
-
-  if (page != NULL) {
-    addr = page->alloc_object(size);
-  }
-
-  if (addr == 0) {
-    // Allocate new page
-    page = alloc_page(ZPageTypeSmall, ZPageSizeSmall, flags);
-    if (page != NULL) {
-      addr = page->alloc_object(size);
-    }
-    _worker_small_page.set(page);
-  }
-
-  return addr;
+  return alloc_object_in_worker_page(worker_small_page(flags.tenured()), ZPageTypeSmall, ZPageSizeSmall, size, flags);
 }
 
 uintptr_t ZObjectAllocator::alloc_small_object(size_t size, ZAllocationFlags flags) {
@@ -207,7 +313,28 @@ uintptr_t ZObjectAllocator::alloc_object(size_t size) {
   return alloc_object(size, flags);
 }
 
-uintptr_t ZObjectAllocator::alloc_object_for_relocation(size_t size) {
+uintptr_t ZObjectAllocator::alloc_tlab_page(size_t size) {
+  assert(ZThread::is_java(), "Must be a Java thread");
+  assert(size <= ZPageSizeSmall, "Invalid size");
+
+  ZAllocationFlags flags;
+  flags.set_no_reserve();
+
+  uintptr_t addr = 0;
+
+  // Allocate new small page, used only by a single TLAB. The TLAB
+  // gets the requested size, which is what the shared TLAB code
+  // expects, and the rest of the page is left unused.
+  ZPage* const page = alloc_page_for_object(ZAllocationPathTLAB, ZPageTypeSmall, ZPageSizeSmall, size, flags);
+  if (page != NULL) {
+    ZStatInc(ZCounterTLABPageAllocation);
+    addr = page->alloc_object(size);
+  }
+
+  return addr;
+}
+
+uintptr_t ZObjectAllocator::alloc_object_for_relocation(size_t size, bool tenured) {
   assert(ZThread::is_java() || ZThread::is_vm() || ZThread::is_worker() || ZThread::is_runtime_worker(),
          "Unknown thread");
 
@@ -217,6 +344,10 @@ uintptr_t ZObjectAllocator::alloc_object_for_relocation(size_t size) {
 
   if (ZThread::is_worker()) {
     flags.set_worker_thread();
+
+    if (tenured) {
+      flags.set_tenured();
+    }
   }
 
   return alloc_object(size, flags);
@@ -230,9 +361,23 @@ bool ZObjectAllocator::undo_alloc_large_object(ZPage* page) {
   return true;
 }
 
+bool ZObjectAllocator::undo_alloc_medium_object_from_worker(ZPage* page, uintptr_t addr, size_t size) {
+  assert(page->type() == ZPageTypeMedium, "Invalid page type");
+  assert(page == _worker_medium_page.get() || page == _worker_medium_page_tenured.get(), "Invalid page");
+
+  // Non-atomic undo on worker-local page
+  const bool success = page->undo_alloc_object(addr, size);
+  assert(success, "Should always succeed");
+  return success;
+}
+
 bool ZObjectAllocator::undo_alloc_medium_object(ZPage* page, uintptr_t addr, size_t size) {
   assert(page->type() == ZPageTypeMedium, "Invalid page type");
 
+  if (ZThread::is_worker() && _use_per_worker_medium_pages) {
+    return undo_alloc_medium_object_from_worker(page, addr, size);
+  }
+
   // Try atomic undo on shared page
   return page->undo_alloc_object_atomic(addr, size);
 }
@@ -246,7 +391,7 @@ bool ZObjectAllocator::undo_alloc_small_object_from_nonworker(ZPage* page, uintp
 
 bool ZObjectAllocator::undo_alloc_small_object_from_worker(ZPage* page, uintptr_t addr, size_t size) {
   assert(page->type() == ZPageTypeSmall, "Invalid page type");
-  assert(page == _worker_small_page.get(), "Invalid page");
+  assert(page == _worker_small_page.get() || page == _worker_small_page_tenured.get(), "Invalid page");
 
   // Non-atomic undo on worker-local page
   const bool success = page->undo_alloc_object(addr, size);
@@ -284,6 +429,49 @@ void ZObjectAllocator::undo_alloc_object_for_relocation(ZPage* page, uintptr_t a
   }
 }
 
+void ZObjectAllocator::reuse_page_for_relocation(ZPage* page) {
+  assert(ZThread::is_worker(), "Should be a worker thread");
+  assert(page->is_allocating(), "Invalid page state");
+
+  // Make the space left in an in-place relocated page available for
+  // relocation of other objects, if it has more space left than the
+  // page currently used for relocation. The page is reused for objects
+  // of the same age class as the objects already on the page.
+  const bool tenured = page->is_tenured();
+
+  if (page->type() == ZPageTypeSmall) {
+    ZPerWorker<ZPage*>* const worker_page = worker_small_page(tenured);
+    const ZPage* const prev_page = worker_page->get();
+    if (prev_page == NULL || prev_page->remaining() < page->remaining()) {
+      worker_page->set(page);
+    }
+  } else if (page->type() == ZPageTypeMedium && _use_per_worker_medium_pages) {
+    ZPerWorker<ZPage*>* const worker_page = worker_medium_page(tenured);
+    const ZPage* const prev_page = worker_page->get();
+    if (prev_page == NULL || prev_page->remaining() < page->remaining()) {
+      worker_page->set(page);
+    }
+  } else if (page->type() == ZPageTypeMedium) {
+    // Use the shared medium page of the current CPU, or of the
+    // NUMA node the page belongs to
+    ZPage** const shared_page = (!tenured && _use_per_cpu_shared_medium_pages)
+                                ? _shared_medium_page_cpu.addr()
+                                : shared_medium_page(tenured)->addr(page->numa_id());
+    ZPage* prev_page = Atomic::load_acquire(shared_page);
+
+    while (prev_page == NULL || prev_page->remaining() < page->remaining()) {
+      ZPage* const result = Atomic::cmpxchg(shared_page, prev_page, page);
+      if (result == prev_page) {
+        // Success
+        break;
+      }
+
+      // Retry
+      prev_page = result;
+    }
+  }
+}
+
 size_t ZObjectAllocator::used() const {
   size_t total_used = 0;
   size_t total_undone = 0;
@@ -320,7 +508,13 @@ void ZObjectAllocator::retire_pages() {
   _undone.set_all(0);
 
   // Reset allocation pages
-  _shared_medium_page.set(NULL);
+  _shared_medium_page.set_all(NULL);
+  _shared_medium_page_tenured.set_all(NULL);
+  _shared_medium_page_cpu.set_all(NULL);
   _shared_small_page.set_all(NULL);
+  _shared_small_page_numa.set_all(NULL);
   _worker_small_page.set_all(NULL);
+  _worker_small_page_tenured.set_all(NULL);
+  _worker_medium_page.set_all(NULL);
+  _worker_medium_page_tenured.set_all(NULL);
 }
@@ -29,30 +29,66 @@
 #include "gc/z/zValue.hpp"
 #include "memory/allocation.hpp"
 
-class ZObjectAllocator {
+// Object allocation paths, as reported by sampled allocation events
+const uint8_t ZAllocationPathTLAB         = 0;
+const uint8_t ZAllocationPathSharedSmall  = 1;
+const uint8_t ZAllocationPathPerCPUSmall  = 2;
+const uint8_t ZAllocationPathSharedMedium = 3;
+const uint8_t ZAllocationPathPerCPUMedium = 4;
+const uint8_t ZAllocationPathLarge        = 5;
+const uint8_t ZAllocationPathCount        = 6;
+
+class ZObjectAllocator : public CHeapObj<mtGC> {
 private:
+  const uint8_t      _partition;
   const bool         _use_per_cpu_shared_small_pages;
+  const bool         _use_per_cpu_shared_medium_pages;
+  const bool         _use_per_worker_medium_pages;
   ZPerCPU<size_t>    _used;
   ZPerCPU<size_t>    _undone;
-  ZContended<ZPage*> _shared_medium_page;
+  ZPerNUMA<ZPage*>   _shared_medium_page;
+  ZPerNUMA<ZPage*>   _shared_medium_page_tenured;
+  ZPerCPU<ZPage*>    _shared_medium_page_cpu;
   ZPerCPU<ZPage*>    _shared_small_page;
+  ZPerNUMA<ZPage*>   _shared_small_page_numa;
   ZPerWorker<ZPage*> _worker_small_page;
+  ZPerWorker<ZPage*> _worker_small_page_tenured;
+  ZPerWorker<ZPage*> _worker_medium_page;
+  ZPerWorker<ZPage*> _worker_medium_page_tenured;
 
   ZPage** shared_small_page_addr();
   ZPage* const* shared_small_page_addr() const;
+  ZPerNUMA<ZPage*>* shared_medium_page(bool tenured);
+  ZPage** shared_medium_page_addr(bool tenured);
+  ZPerWorker<ZPage*>* worker_small_page(bool tenured);
+  ZPerWorker<ZPage*>* worker_medium_page(bool tenured);
 
   ZPage* alloc_page(uint8_t type, size_t size, ZAllocationFlags flags);
   void undo_alloc_page(ZPage* page);
 
+  // Allocate a page for an object allocation, and report a sampled
+  // allocation event for allocations by Java threads
+  ZPage* alloc_page_for_object(uint8_t path, uint8_t type, size_t page_size, size_t size, ZAllocationFlags flags);
+
   // Allocate an object in a shared page. Allocate and
   // atomically install a new page if necessary.
   uintptr_t alloc_object_in_shared_page(ZPage** shared_page,
+                                        uint8_t path,
+                                        uint8_t page_type,
+                                        size_t page_size,
+                                        size_t size,
+                                        ZAllocationFlags flags);
+
+  // Allocate an object in a worker-local page. Allocate
+  // a new page if necessary.
+  uintptr_t alloc_object_in_worker_page(ZPerWorker<ZPage*>* worker_page,
                                         uint8_t page_type,
                                         size_t page_size,
                                         size_t size,
                                         ZAllocationFlags flags);
 
   uintptr_t alloc_large_object(size_t size, ZAllocationFlags flags);
+  uintptr_t alloc_medium_object_from_worker(size_t size, ZAllocationFlags flags);
   uintptr_t alloc_medium_object(size_t size, ZAllocationFlags flags);
   uintptr_t alloc_small_object_from_nonworker(size_t size, ZAllocationFlags flags);
   uintptr_t alloc_small_object_from_worker(size_t size, ZAllocationFlags flags);
@@ -60,6 +96,7 @@ private:
   uintptr_t alloc_object(size_t size, ZAllocationFlags flags);
 
   bool undo_alloc_large_object(ZPage* page);
+  bool undo_alloc_medium_object_from_worker(ZPage* page, uintptr_t addr, size_t size);
   bool undo_alloc_medium_object(ZPage* page, uintptr_t addr, size_t size);
   bool undo_alloc_small_object_from_nonworker(ZPage* page, uintptr_t addr, size_t size);
   bool undo_alloc_small_object_from_worker(ZPage* page, uintptr_t addr, size_t size);
@@ -67,12 +104,14 @@ private:
   bool undo_alloc_object(ZPage* page, uintptr_t addr, size_t size);
 
 public:
-  ZObjectAllocator();
+  ZObjectAllocator(uint8_t partition);
 
   uintptr_t alloc_object(size_t size);
+  uintptr_t alloc_tlab_page(size_t size);
 
-  uintptr_t alloc_object_for_relocation(size_t size);
+  uintptr_t alloc_object_for_relocation(size_t size, bool tenured);
   void undo_alloc_object_for_relocation(ZPage* page, uintptr_t addr, size_t size);
+  void reuse_page_for_relocation(ZPage* page);
 
   size_t used() const;
   size_t remaining() const;
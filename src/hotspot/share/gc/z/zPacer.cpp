@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zLock.inline.hpp"
+#include "gc/z/zPacer.hpp"
+#include "gc/z/zStat.hpp"
+#include "gc/z/zThreadLocalData.hpp"
+#include "runtime/interfaceSupport.inline.hpp"
+#include "runtime/thread.hpp"
+#include "utilities/ticks.hpp"
+
+static const ZStatCriticalPhase ZCriticalPhaseAllocationPacing("Allocation Pacing", false /* verbose */);
+
+ZConditionLock  ZPacer::_lock;
+volatile double ZPacer::_stretch = 0.0;
+
+void ZPacer::set_stretch(double stretch) {
+  _stretch = stretch;
+}
+
+void ZPacer::reset() {
+  _stretch = 0.0;
+
+  // Wake up paced threads
+  ZLocker<ZConditionLock> locker(&_lock);
+  _lock.notify_all();
+}
+
+void ZPacer::wait(Thread* thread, uint64_t delay) {
+  ZStatTimer timer(ZCriticalPhaseAllocationPacing);
+
+  // Allow safepoints while waiting
+  ThreadBlockInVM tbivm((JavaThread*)thread);
+  ZLocker<ZConditionLock> locker(&_lock);
+  _lock.wait(delay);
+}
+
+void ZPacer::pace(Thread* thread) {
+  if (!ZPacing || !thread->is_Java_thread()) {
+    // Pacing disabled
+    return;
+  }
+
+  const double stretch = _stretch;
+  if (stretch == 0.0) {
+    // Not pacing, restart the pacing interval once pacing starts
+    ZThreadLocalData::set_pacing_start(thread, Ticks());
+    return;
+  }
+
+  const Ticks now = Ticks::now();
+  const Ticks start = ZThreadLocalData::pacing_start(thread);
+  if (start.value() != 0) {
+    // Delay the thread by a share of the time it spent allocating since the
+    // last time it was delayed. Delays too short to wait for are carried
+    // over, by not restarting the interval until the thread has waited.
+    const double elapsed = TimeHelper::counter_to_millis((now - start).value());
+    const uint64_t delay = MIN2((uint64_t)(elapsed * stretch), (uint64_t)ZPacingMaxDelay);
+    if (delay == 0) {
+      // Too short
+      return;
+    }
+
+    wait(thread, delay);
+  }
+
+  // Restart the pacing interval
+  ZThreadLocalData::set_pacing_start(thread, Ticks::now());
+}
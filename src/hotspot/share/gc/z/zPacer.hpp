@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZPACER_HPP
+#define SHARE_GC_Z_ZPACER_HPP
+
+#include "gc/z/zLock.hpp"
+#include "memory/allocation.hpp"
+
+class Thread;
+
+// Soft backpressure on allocation. When GC is not expected to complete
+// before the heap runs out of memory, the time each allocating thread
+// spends between pacing points is stretched by a factor, which slows
+// every thread down in proportion to its own allocation rate. This
+// spreads small delays over all allocating threads, instead of letting
+// them run into a long allocation stall once memory is exhausted.
+class ZPacer : public AllStatic {
+private:
+  static ZConditionLock  _lock;
+  static volatile double _stretch;
+
+  static void wait(Thread* thread, uint64_t delay);
+
+public:
+  static void set_stretch(double stretch);
+  static void reset();
+
+  static void pace(Thread* thread);
+};
+
+#endif // SHARE_GC_Z_ZPACER_HPP
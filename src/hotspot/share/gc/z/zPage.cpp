@@ -32,11 +32,17 @@
 ZPage::ZPage(const ZVirtualMemory& vmem, const ZPhysicalMemory& pmem) :
     _type(type_from_size(vmem.size())),
     _numa_id((uint8_t)-1),
+    _object_age(0),
+    _partition(0),
     _seqnum(0),
+    _kept_tlab_seqnum(0),
+    _npinned(0),
     _virtual(vmem),
     _top(start()),
     _livemap(object_max_count()),
     _last_used(0),
+    _zeroed(false),
+    _hotness(ZPageHotnessUnknown),
     _physical(pmem) {
   assert_initialized();
 }
@@ -44,11 +50,17 @@ ZPage::ZPage(const ZVirtualMemory& vmem, const ZPhysicalMemory& pmem) :
 ZPage::ZPage(uint8_t type, const ZVirtualMemory& vmem, const ZPhysicalMemory& pmem) :
     _type(type),
     _numa_id((uint8_t)-1),
+    _object_age(0),
+    _partition(0),
     _seqnum(0),
+    _kept_tlab_seqnum(0),
+    _npinned(0),
     _virtual(vmem),
     _top(start()),
     _livemap(object_max_count()),
     _last_used(0),
+    _zeroed(false),
+    _hotness(ZPageHotnessUnknown),
     _physical(pmem) {
   assert_initialized();
 }
@@ -65,10 +77,34 @@ void ZPage::assert_initialized() const {
 }
 
 void ZPage::reset() {
+  assert(!is_pinned(), "Should not be pinned");
   _seqnum = ZGlobalSeqNum;
+  _kept_tlab_seqnum = 0;
+  _object_age = 0;
   _top = start();
   _livemap.reset();
   _last_used = 0;
+  _hotness = ZPageHotnessUnknown;
+}
+
+void ZPage::reset_for_in_place_relocation(uintptr_t top) {
+  assert(top >= start() && top <= end(), "Invalid top");
+
+  // Turn the page into an allocating page, where everything below the new
+  // top is live. The live map is left untouched, since it's still needed
+  // to look up forwarding entries for the objects that were compacted.
+  // The objects stay on the page, so they keep their age. The memory above
+  // the new top held objects before the compaction, so it's not zeroed.
+  _object_age = object_age();
+  _seqnum = ZGlobalSeqNum;
+  _zeroed = false;
+  _top = top;
+}
+
+void ZPage::release_live_map() {
+  // Free pages are never marked, so their live map storage can be
+  // given back until the page is allocated and marked again.
+  _livemap.release();
 }
 
 ZPage* ZPage::retype(uint8_t type) {
@@ -85,20 +121,69 @@ ZPage* ZPage::split(size_t size) {
 ZPage* ZPage::split(uint8_t type, size_t size) {
   assert(_virtual.size() > size, "Invalid split");
 
-  // Resize this page, keep _numa_id, _seqnum, and _last_used
+  // Resize this page, keep _numa_id, _seqnum, _object_age, and _last_used
   const ZVirtualMemory vmem = _virtual.split(size);
   const ZPhysicalMemory pmem = _physical.split(size);
   _type = type_from_size(_virtual.size());
   _top = start();
   _livemap.resize(object_max_count());
 
-  // Create new page, inherit _seqnum and _last_used
+  // Create new page, inherit _seqnum, _object_age, _last_used, and _zeroed
   ZPage* const page = new ZPage(type, vmem, pmem);
   page->_seqnum = _seqnum;
+  page->_object_age = _object_age;
   page->_last_used = _last_used;
+  page->_zeroed = _zeroed;
+  return page;
+}
+
+ZPage* ZPage::remap(const ZVirtualMemory& vmem) const {
+  assert(_type == ZPageTypeLarge, "Invalid page type");
+  assert(vmem.size() == size(), "Invalid size");
+
+  // Create new page, sharing the physical memory of this page, which holds
+  // the same object at the same offset. The new page is allocating, so its
+  // object is kept live without being marked, and it inherits _numa_id,
+  // _partition and the age of the object.
+  ZPage* const page = new ZPage(_type, vmem, _physical);
+  page->reset();
+  page->_numa_id = _numa_id;
+  page->_partition = _partition;
+  page->_object_age = object_age();
+  page->_top = page->start() + (top() - start());
   return page;
 }
 
+bool ZPage::is_mergeable(const ZPage* next) const {
+  // A page that directly follows this page in virtual memory can be merged
+  // into it without being remapped, if its physical memory also follows
+  // the physical memory of this page. The physical memory segments are
+  // kept sorted, and mapped in that order, so they must stay in order.
+  // Zeroed pages are never merged, to not lose their zeroed state.
+  return end() == next->start() &&
+         is_mapped() && next->is_mapped() &&
+         !is_zeroed() && !next->is_zeroed() &&
+         _physical.segment(_physical.nsegments() - 1).end() <= next->_physical.segment(0).start();
+}
+
+void ZPage::merge(const ZPage* next) {
+  assert(is_mergeable(next), "Invalid merge");
+
+  // Extend this page to also cover the memory of the next page, which
+  // is already mapped at the right place. The merged page is last used
+  // when the most recently used of the two pages was.
+  _virtual = ZVirtualMemory(start(), size() + next->size());
+  for (size_t i = 0; i < next->_physical.nsegments(); i++) {
+    _physical.add_segment(next->_physical.segment(i));
+  }
+
+  _type = type_from_size(size());
+  _numa_id = (uint8_t)-1;
+  _top = start();
+  _last_used = MAX2(_last_used, next->_last_used);
+  _livemap.resize(object_max_count());
+}
+
 void ZPage::print_on(outputStream* out) const {
   out->print_cr(" %-6s  " PTR_FORMAT " " PTR_FORMAT " " PTR_FORMAT " %s%s",
                 type_to_string(), start(), top(), end(),
@@ -37,11 +37,17 @@ class ZPage : public CHeapObj<mtGC> {
 private:
   uint8_t            _type;
   uint8_t            _numa_id;
+  uint8_t            _object_age;
+  uint8_t            _partition;
   uint32_t           _seqnum;
+  volatile uint32_t  _kept_tlab_seqnum;
+  volatile uint32_t  _npinned;
   ZVirtualMemory     _virtual;
   volatile uintptr_t _top;
   ZLiveMap           _livemap;
   uint64_t           _last_used;
+  volatile bool      _zeroed;
+  volatile uint8_t   _hotness;
   ZPhysicalMemory    _physical;
   ZListNode<ZPage>   _node;
 
@@ -52,6 +58,7 @@ private:
 
   bool is_object_marked(uintptr_t addr) const;
   bool is_object_strongly_marked(uintptr_t addr) const;
+  bool is_object_in_kept_tlab(uintptr_t addr) const;
 
 public:
   ZPage(const ZVirtualMemory& vmem, const ZPhysicalMemory& pmem);
@@ -73,9 +80,25 @@ public:
   const ZVirtualMemory& virtual_memory() const;
 
   uint8_t numa_id();
+  void clear_numa_id();
+
+  uint8_t partition() const;
+  void set_partition(uint8_t partition);
 
   bool is_allocating() const;
   bool is_relocatable() const;
+  uint32_t age() const;
+
+  bool has_kept_tlab() const;
+  void set_kept_tlab();
+
+  bool is_pinned() const;
+  void pin();
+  void unpin();
+
+  uint8_t object_age() const;
+  void set_object_age(uint8_t age);
+  bool is_tenured() const;
 
   bool is_mapped() const;
   void set_pre_mapped();
@@ -83,11 +106,24 @@ public:
   uint64_t last_used() const;
   void set_last_used();
 
+  bool is_zeroed() const;
+  void set_zeroed();
+  void clear_zeroed();
+
+  bool has_hotness() const;
+  uint8_t hotness() const;
+  void set_hotness(uint8_t hotness);
+
   void reset();
+  void reset_for_in_place_relocation(uintptr_t top);
+  void release_live_map();
 
   ZPage* retype(uint8_t type);
   ZPage* split(size_t size);
   ZPage* split(uint8_t type, size_t size);
+  ZPage* remap(const ZVirtualMemory& vmem) const;
+  bool is_mergeable(const ZPage* next) const;
+  void merge(const ZPage* next);
 
   bool is_in(uintptr_t addr) const;
 
@@ -95,12 +131,18 @@ public:
   bool is_object_live(uintptr_t addr) const;
   bool is_object_strongly_live(uintptr_t addr) const;
   bool mark_object(uintptr_t addr, bool finalizable, bool& inc_live);
+  void mark_object_end(uintptr_t addr, size_t size);
+  void prefetch_mark(uintptr_t addr) const;
+
+  bool has_object_ends() const;
+  size_t live_object_size(uintptr_t addr) const;
 
   void inc_live(uint32_t objects, size_t bytes);
   uint32_t live_objects() const;
   size_t live_bytes() const;
 
   void object_iterate(ObjectClosure* cl);
+  void object_iterate(ObjectClosure* cl, size_t segment);
 
   uintptr_t alloc_object(size_t size);
   uintptr_t alloc_object_atomic(size_t size);
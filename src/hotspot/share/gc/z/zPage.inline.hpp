@@ -31,9 +31,12 @@
 #include "gc/z/zNUMA.hpp"
 #include "gc/z/zPage.hpp"
 #include "gc/z/zPhysicalMemory.inline.hpp"
+#include "gc/z/zThreadLocalAllocBuffer.hpp"
+#include "gc/z/zUtils.inline.hpp"
 #include "gc/z/zVirtualMemory.inline.hpp"
 #include "oops/oop.inline.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/globals.hpp"
 #include "runtime/os.hpp"
 #include "utilities/align.hpp"
 #include "utilities/debug.hpp"
@@ -142,6 +145,18 @@ inline uint8_t ZPage::numa_id() {
   return _numa_id;
 }
 
+inline void ZPage::clear_numa_id() {
+  _numa_id = (uint8_t)-1;
+}
+
+inline uint8_t ZPage::partition() const {
+  return _partition;
+}
+
+inline void ZPage::set_partition(uint8_t partition) {
+  _partition = partition;
+}
+
 inline bool ZPage::is_allocating() const {
   return _seqnum == ZGlobalSeqNum;
 }
@@ -150,6 +165,55 @@ inline bool ZPage::is_relocatable() const {
   return _seqnum < ZGlobalSeqNum;
 }
 
+inline bool ZPage::has_kept_tlab() const {
+  // A TLAB in this page was kept across the last mark start
+  return Atomic::load(&_kept_tlab_seqnum) == ZGlobalSeqNum;
+}
+
+inline void ZPage::set_kept_tlab() {
+  assert(is_relocatable(), "Invalid page state");
+  Atomic::store(&_kept_tlab_seqnum, ZGlobalSeqNum);
+}
+
+inline bool ZPage::is_pinned() const {
+  // An object in this page is used in a JNI critical region
+  return Atomic::load(&_npinned) > 0;
+}
+
+inline void ZPage::pin() {
+  // Any page in use can be pinned, including a page that is still
+  // allocating in the current cycle
+  Atomic::inc(&_npinned);
+}
+
+inline void ZPage::unpin() {
+  assert(is_pinned(), "Not pinned");
+  Atomic::dec(&_npinned);
+}
+
+inline uint32_t ZPage::age() const {
+  // Number of GC cycles since the page was allocated
+  assert(is_relocatable(), "Invalid page state");
+  return ZGlobalSeqNum - _seqnum;
+}
+
+inline uint8_t ZPage::object_age() const {
+  // Number of GC cycles the objects on the page have survived. This is
+  // the age the objects had when the page was allocated, plus the number
+  // of GC cycles since then, saturated at the max value.
+  const uint32_t age = (uint32_t)_object_age + (ZGlobalSeqNum - _seqnum);
+  return (uint8_t)MIN2(age, (uint32_t)max_jubyte);
+}
+
+inline void ZPage::set_object_age(uint8_t age) {
+  assert(is_allocating(), "Invalid page state");
+  _object_age = age;
+}
+
+inline bool ZPage::is_tenured() const {
+  return ZTenuringThreshold > 0 && object_age() >= ZTenuringThreshold;
+}
+
 inline bool ZPage::is_mapped() const {
   return _seqnum > 0;
 }
@@ -169,6 +233,34 @@ inline void ZPage::set_last_used() {
   _last_used = os::elapsedTime();
 }
 
+inline bool ZPage::is_zeroed() const {
+  // A zeroed page has not been written to above its top since its memory
+  // was zeroed, so objects allocated in it don't need to be cleared.
+  return Atomic::load(&_zeroed);
+}
+
+inline void ZPage::set_zeroed() {
+  Atomic::store(&_zeroed, true);
+}
+
+inline void ZPage::clear_zeroed() {
+  Atomic::store(&_zeroed, false);
+}
+
+inline bool ZPage::has_hotness() const {
+  return Atomic::load(&_hotness) != ZPageHotnessUnknown;
+}
+
+inline uint8_t ZPage::hotness() const {
+  // Percentage of the sampled memory on the page that was
+  // accessed during the last page hotness sampling interval
+  return Atomic::load(&_hotness);
+}
+
+inline void ZPage::set_hotness(uint8_t hotness) {
+  Atomic::store(&_hotness, hotness);
+}
+
 inline bool ZPage::is_in(uintptr_t addr) const {
   const uintptr_t offset = ZAddress::offset(addr);
   return offset >= start() && offset < top();
@@ -189,12 +281,18 @@ inline bool ZPage::is_object_strongly_marked(uintptr_t addr) const {
   return _livemap.get(index + 1);
 }
 
+inline bool ZPage::is_object_in_kept_tlab(uintptr_t addr) const {
+  // Objects allocated in a TLAB kept across mark start are implicitly
+  // live, like objects in pages allocated since mark start
+  return has_kept_tlab() && ZThreadLocalAllocBuffer::is_kept(ZAddress::offset(addr));
+}
+
 inline bool ZPage::is_object_live(uintptr_t addr) const {
-  return is_allocating() || is_object_marked(addr);
+  return is_allocating() || is_object_marked(addr) || is_object_in_kept_tlab(addr);
 }
 
 inline bool ZPage::is_object_strongly_live(uintptr_t addr) const {
-  return is_allocating() || is_object_strongly_marked(addr);
+  return is_allocating() || is_object_strongly_marked(addr) || is_object_in_kept_tlab(addr);
 }
 
 inline bool ZPage::mark_object(uintptr_t addr, bool finalizable, bool& inc_live) {
@@ -207,6 +305,45 @@ inline bool ZPage::mark_object(uintptr_t addr, bool finalizable, bool& inc_live)
   return _livemap.set(index, finalizable, inc_live);
 }
 
+inline bool ZPage::has_object_ends() const {
+  // Object ends are recorded on small pages, where every object covers
+  // at least two alignment units. This keeps the end of an object apart
+  // from its start in the live map.
+  return type() == ZPageTypeSmall && object_alignment_shift() == LogHeapWordSize;
+}
+
+inline void ZPage::mark_object_end(uintptr_t addr, size_t size) {
+  assert(is_in(addr), "Invalid address");
+
+  if (has_object_ends()) {
+    // Set end bit
+    const size_t index = ((ZAddress::offset(addr) - start()) >> object_alignment_shift()) * 2;
+    const size_t end_index = index + (size >> object_alignment_shift()) * 2 - 1;
+    _livemap.set_end(index, end_index);
+  }
+}
+
+inline size_t ZPage::live_object_size(uintptr_t addr) const {
+  assert(is_marked(), "Should be marked");
+  assert(is_object_marked(addr), "Should be marked");
+
+  if (has_object_ends()) {
+    // Look up the recorded object end instead of touching the object
+    const size_t index = ((ZAddress::offset(addr) - start()) >> object_alignment_shift()) * 2;
+    return _livemap.object_size(index, object_alignment_shift());
+  }
+
+  return ZUtils::object_size(addr);
+}
+
+inline void ZPage::prefetch_mark(uintptr_t addr) const {
+  assert(is_in(addr), "Invalid address");
+
+  // Prefetch mark bit
+  const size_t index = ((ZAddress::offset(addr) - start()) >> object_alignment_shift()) * 2;
+  _livemap.prefetch(index);
+}
+
 inline void ZPage::inc_live(uint32_t objects, size_t bytes) {
   _livemap.inc_live(objects, bytes);
 }
@@ -225,6 +362,10 @@ inline void ZPage::object_iterate(ObjectClosure* cl) {
   _livemap.iterate(cl, ZAddress::good(start()), object_alignment_shift());
 }
 
+inline void ZPage::object_iterate(ObjectClosure* cl, size_t segment) {
+  _livemap.iterate(cl, segment, ZAddress::good(start()), object_alignment_shift());
+}
+
 inline uintptr_t ZPage::alloc_object(size_t size) {
   assert(is_allocating(), "Invalid state");
 
@@ -279,6 +420,9 @@ inline bool ZPage::undo_alloc_object(uintptr_t addr, size_t size) {
     return false;
   }
 
+  // The memory of the undone object might have been written to
+  clear_zeroed();
+
   _top = new_top;
 
   // Success
@@ -299,6 +443,10 @@ inline bool ZPage::undo_alloc_object_atomic(uintptr_t addr, size_t size) {
       return false;
     }
 
+    // The memory of the undone object might have been written to.
+    // This must be done before the memory is handed out again.
+    clear_zeroed();
+
     const uintptr_t prev_top = Atomic::cmpxchg(&_top, old_top, new_top);
     if (prev_top == old_top) {
       // Success
@@ -24,27 +24,99 @@
 #include "precompiled.hpp"
 #include "gc/shared/suspendibleThreadSet.hpp"
 #include "gc/z/zAddress.inline.hpp"
+#include "gc/z/zArray.inline.hpp"
 #include "gc/z/zCollectedHeap.hpp"
-#include "gc/z/zFuture.inline.hpp"
 #include "gc/z/zGlobals.hpp"
+#include "gc/z/zHeap.hpp"
+#include "gc/z/zLargePages.inline.hpp"
 #include "gc/z/zLock.inline.hpp"
+#include "gc/z/zNUMA.hpp"
 #include "gc/z/zPage.inline.hpp"
 #include "gc/z/zPageAllocator.hpp"
 #include "gc/z/zPageCache.inline.hpp"
+#include "gc/z/zPageMagazine.inline.hpp"
+#include "gc/z/zPartition.hpp"
+#include "gc/z/zProbes.hpp"
 #include "gc/z/zSafeDelete.inline.hpp"
 #include "gc/z/zStat.hpp"
 #include "gc/z/zTask.hpp"
 #include "gc/z/zTracer.inline.hpp"
+#include "gc/z/zValue.inline.hpp"
 #include "gc/z/zWorkers.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/globals.hpp"
 #include "runtime/init.hpp"
+#include "runtime/interfaceSupport.inline.hpp"
 #include "runtime/java.hpp"
+#include "runtime/orderAccess.hpp"
+#include "runtime/os.hpp"
+#include "runtime/safepoint.hpp"
+#include "runtime/semaphore.inline.hpp"
+#include "runtime/thread.hpp"
+#include "utilities/align.hpp"
+#include "utilities/copy.hpp"
 #include "utilities/debug.hpp"
 
 static const ZStatCounter       ZCounterAllocationRate("Memory", "Allocation Rate", ZStatUnitBytesPerSecond);
 static const ZStatCounter       ZCounterPageCacheFlush("Memory", "Page Cache Flush", ZStatUnitBytesPerSecond);
+static const ZStatCounter       ZCounterPageCacheDefragment("Memory", "Page Cache Defragment", ZStatUnitBytesPerSecond);
+static const ZStatCounter       ZCounterCommitAhead("Memory", "Commit Ahead", ZStatUnitBytesPerSecond);
+static const ZStatCounter       ZCounterPageZeroed("Memory", "Page Zeroed", ZStatUnitBytesPerSecond);
 static const ZStatCounter       ZCounterUncommit("Memory", "Uncommit", ZStatUnitBytesPerSecond);
+static const ZStatCounter       ZCounterColdMemoryPlaced("Memory", "Cold Memory Placed", ZStatUnitBytesPerSecond);
+static const ZStatCounter       ZCounterColdMemoryReclaimed("Memory", "Cold Memory Reclaimed", ZStatUnitBytesPerSecond);
+static const ZStatSampler       ZSamplerPageAgeSmall("Memory", "Page Age Small", ZStatUnitCycles);
+static const ZStatSampler       ZSamplerPageAgeMedium("Memory", "Page Age Medium", ZStatUnitCycles);
+static const ZStatSampler       ZSamplerPageAgeLarge("Memory", "Page Age Large", ZStatUnitCycles);
 static const ZStatCriticalPhase ZCriticalPhaseAllocationStall("Allocation Stall");
+static const ZStatHistogram     ZHistogramPageAllocation("Latency", "Page Allocation");
+static const ZStatHistogram     ZHistogramPageAllocatorLockWait("Latency", "Page Allocator Lock Wait");
+static const ZStatCounter       ZCounterPageAllocatorLockContention("Contention", "Page Allocator Lock Contention", ZStatUnitOpsPerSecond);
+
+// Records how often, and for how long, threads wait for the page allocator
+// lock. The uncontended case only costs a try_lock().
+static void lock_and_record_contention(ZLock* lock) {
+  if (lock->try_lock()) {
+    // Not contended
+    return;
+  }
+
+  const Ticks start = Ticks::now();
+  lock->lock();
+  ZStatInc(ZCounterPageAllocatorLockContention);
+  ZStatSample(ZHistogramPageAllocatorLockWait, (Ticks::now() - start).value());
+}
+
+class ZPageAllocatorLocker : public StackObj {
+private:
+  ZPageAllocator* const _allocator;
+
+public:
+  ZPageAllocatorLocker(ZPageAllocator* allocator) :
+      _allocator(allocator) {
+    _allocator->lock();
+  }
+
+  ~ZPageAllocatorLocker() {
+    _allocator->unlock();
+  }
+};
+
+// Allocation stall policies
+static const uint8_t ZStallPolicyFIFO     = 0;
+static const uint8_t ZStallPolicyBypass   = 1;
+static const uint8_t ZStallPolicySmallest = 2;
+
+static uint8_t stall_policy() {
+  if (strcmp(ZAllocationStallPolicy, "bypass") == 0) {
+    return ZStallPolicyBypass;
+  } else if (strcmp(ZAllocationStallPolicy, "smallest") == 0) {
+    return ZStallPolicySmallest;
+  }
+
+  assert(strcmp(ZAllocationStallPolicy, "fifo") == 0, "Invalid policy");
+  return ZStallPolicyFIFO;
+}
 
 class ZPageAllocRequest : public StackObj {
   friend class ZList<ZPageAllocRequest>;
@@ -55,7 +127,12 @@ private:
   const ZAllocationFlags       _flags;
   const unsigned int           _total_collections;
   ZListNode<ZPageAllocRequest> _node;
-  ZFuture<ZPage*>              _result;
+  Semaphore                    _sema;
+  ZPage*                       _page;
+  volatile uint32_t            _nsignaled;
+  uint32_t                     _nwaited;
+  bool                         _signal_pending;
+  ZPageAllocRequest*           _wakeup[2];
 
 public:
   ZPageAllocRequest(uint8_t type, size_t size, ZAllocationFlags flags, unsigned int total_collections) :
@@ -64,7 +141,23 @@ public:
       _flags(flags),
       _total_collections(total_collections),
       _node(),
-      _result() {}
+      _sema(),
+      _page(NULL),
+      _nsignaled(0),
+      _nwaited(0),
+      _signal_pending(false),
+      _wakeup() {}
+
+  ~ZPageAllocRequest() {
+    // The thread that signaled the semaphore can still be touching it
+    // after the waiting thread has returned from sem_wait(), due to a
+    // bug in sem_post() in glibc < 2.21. Wait for all signals to have
+    // completed before the semaphore is destroyed.
+    // https://sourceware.org/bugzilla/show_bug.cgi?id=12674
+    while (Atomic::load_acquire(&_nsignaled) != _nwaited) {
+      SpinPause();
+    }
+  }
 
   uint8_t type() const {
     return _type;
@@ -83,19 +176,76 @@ public:
   }
 
   ZPage* peek() {
-    return _result.peek();
+    return _page;
   }
 
-  ZPage* wait() {
-    return _result.get();
+  void wait() {
+    Thread* const thread = Thread::current();
+    if (thread->is_Java_thread()) {
+      _sema.wait_with_safepoint_check((JavaThread*)thread);
+    } else {
+      _sema.wait();
+    }
+
+    _nwaited++;
+
+    // Pass the wakeup on to the requests below this one in the batch
+    for (size_t i = 0; i < ARRAY_SIZE(_wakeup); i++) {
+      if (_wakeup[i] != NULL) {
+        _wakeup[i]->signal();
+        _wakeup[i] = NULL;
+      }
+    }
+  }
+
+  // A request is signaled at most once until the waiting thread has
+  // consumed the signal. A request can be satisfied more than once, e.g.
+  // with a marker and then with a page, which then only updates the page
+  // returned by the pending signal. Otherwise surplus signals would be
+  // left behind when the waiting thread returns. Both the following are
+  // only called with the allocator lock held.
+  bool set_and_claim_signal(ZPage* page) {
+    if (_signal_pending && _page == ZPageAllocator::gc_marker && page == ZPageAllocator::relocate_marker) {
+      // Never replace a pending request to start a new GC cycle. The
+      // waiting thread also helps relocate pages after starting it.
+      return false;
+    }
+
+    _page = page;
+
+    if (_signal_pending) {
+      // Already signaled
+      return false;
+    }
+
+    _signal_pending = true;
+    return true;
+  }
+
+  ZPage* consume_signal() {
+    _signal_pending = false;
+    return _page;
+  }
+
+  void set_wakeup(ZPageAllocRequest* left, ZPageAllocRequest* right) {
+    _wakeup[0] = left;
+    _wakeup[1] = right;
+  }
+
+  void signal() {
+    _sema.signal();
+    Atomic::inc(&_nsignaled, memory_order_release);
   }
 
   void satisfy(ZPage* page) {
-    _result.set(page);
+    if (set_and_claim_signal(page)) {
+      signal();
+    }
   }
 };
 
 ZPage* const ZPageAllocator::gc_marker = (ZPage*)-1;
+ZPage* const ZPageAllocator::relocate_marker = (ZPage*)-2;
 
 ZPageAllocator::ZPageAllocator(ZWorkers* workers,
                                size_t min_capacity,
@@ -106,18 +256,29 @@ ZPageAllocator::ZPageAllocator(ZWorkers* workers,
     _virtual(max_capacity),
     _physical(),
     _cache(),
+    _demand(),
+    _magazines(),
     _min_capacity(min_capacity),
     _max_capacity(max_capacity),
     _max_reserve(max_reserve),
+    _max_reserve_used(0),
     _current_max_capacity(max_capacity),
+    _soft_max_limit(SIZE_MAX),
+    _director_threshold(SIZE_MAX),
     _capacity(0),
     _used_high(0),
     _used_low(0),
     _used(0),
+    _commit_headroom(0),
+    _commit_deferred(0),
     _allocated(0),
     _reclaimed(0),
+    _magazine_used(0),
     _queue(),
     _satisfied(),
+    _wakeups(),
+    _zeroing(NULL),
+    _stall_policy(stall_policy()),
     _safe_delete(),
     _uncommit(false),
     _initialized(false) {
@@ -136,12 +297,20 @@ ZPageAllocator::ZPageAllocator(ZWorkers* workers,
   _physical.warn_commit_limits(max_capacity);
 
   // Commit initial capacity
-  _capacity = _physical.commit(initial_capacity);
-  if (_capacity != initial_capacity) {
+  const size_t commit = initial_commit(initial_capacity);
+  _capacity = _physical.commit(commit);
+  if (_capacity != commit) {
     log_error(gc)("Failed to allocate initial Java heap (" SIZE_FORMAT "M)", initial_capacity / M);
     return;
   }
 
+  // The rest of the initial capacity, if any, is committed
+  // in the background, after initialization has completed.
+  if (commit < initial_capacity) {
+    _commit_deferred = initial_capacity;
+    log_info(gc, init)("Initial Capacity Deferred: " SIZE_FORMAT "M", (initial_capacity - commit) / M);
+  }
+
   // If uncommit is not explicitly disabled, max capacity is greater than
   // min capacity, and uncommit is supported by the platform, then we will
   // try to uncommit unused memory.
@@ -153,7 +322,7 @@ ZPageAllocator::ZPageAllocator(ZWorkers* workers,
   }
 
   // Pre-map initial capacity
-  prime_cache(workers, initial_capacity);
+  prime_cache(workers, commit);
 
   // Successfully initialized
   _initialized = true;
@@ -188,9 +357,23 @@ public:
   }
 };
 
+size_t ZPageAllocator::initial_commit(size_t initial_capacity) const {
+  if (!ZDeferInitialCommit || AlwaysPreTouch) {
+    // Commit all of the initial capacity
+    return initial_capacity;
+  }
+
+  // Commit enough memory for the first allocations, and leave the
+  // rest to the committer thread. This keeps the commit, which is
+  // serialized by the kernel, off the critical path of startup.
+  const size_t commit = MAX3(align_up(initial_capacity / 16, ZGranuleSize), ZPageSizeMedium, ZGranuleSize);
+  return MIN2(commit, initial_capacity);
+}
+
 void ZPageAllocator::prime_cache(ZWorkers* workers, size_t size) {
   // Allocate physical memory
-  const ZPhysicalMemory pmem = _physical.alloc(size);
+  bool zeroed;
+  const ZPhysicalMemory pmem = _physical.alloc(size, &zeroed);
   guarantee(!pmem.is_null(), "Invalid size");
 
   // Allocate virtual memory
@@ -210,11 +393,47 @@ void ZPageAllocator::prime_cache(ZWorkers* workers, size_t size) {
     workers->run_parallel(&task);
   }
 
-  // Add page to cache
+  // Add page to cache. Pre-touching writes zeroes, so the memory
+  // is still zeroed if it was freshly committed.
   page->set_last_used();
+  if (zeroed) {
+    page->set_zeroed();
+  }
   _cache.free_page(page);
 }
 
+void ZPageAllocator::lock() {
+  lock_and_record_contention(&_lock);
+}
+
+void ZPageAllocator::unlock() {
+  // Requests satisfied while holding the lock are woken up after the lock
+  // has been released, so that the woken threads don't immediately block
+  // on it. The requests form a binary tree, where each woken thread wakes
+  // up the two requests below it, so that a large batch of stalled
+  // threads is woken up in logarithmic time, instead of one at a time.
+  ZPageAllocRequest* root = NULL;
+
+  const size_t nwakeups = _wakeups.size();
+  if (nwakeups > 0) {
+    for (size_t i = 0; i < nwakeups; i++) {
+      const size_t left = 2 * i + 1;
+      const size_t right = 2 * i + 2;
+      _wakeups.at(i)->set_wakeup((left < nwakeups) ? _wakeups.at(left) : NULL,
+                                 (right < nwakeups) ? _wakeups.at(right) : NULL);
+    }
+
+    root = _wakeups.at(0);
+    _wakeups.clear();
+  }
+
+  _lock.unlock();
+
+  if (root != NULL) {
+    root->signal();
+  }
+}
+
 bool ZPageAllocator::is_initialized() const {
   return _initialized;
 }
@@ -228,8 +447,21 @@ size_t ZPageAllocator::max_capacity() const {
 }
 
 size_t ZPageAllocator::soft_max_capacity() const {
-  // Note that SoftMaxHeapSize is a manageable flag
-  return MIN2(SoftMaxHeapSize, _current_max_capacity);
+  // Note that SoftMaxHeapSize is a manageable flag, and that the soft
+  // max limit is lowered by the director under memory pressure
+  return MIN3(SoftMaxHeapSize, _current_max_capacity, Atomic::load(&_soft_max_limit));
+}
+
+bool ZPageAllocator::is_soft_max_limited() const {
+  return Atomic::load(&_soft_max_limit) < MIN2(SoftMaxHeapSize, _current_max_capacity);
+}
+
+void ZPageAllocator::set_soft_max_limit(size_t limit) {
+  Atomic::store(&_soft_max_limit, MAX2(limit, _min_capacity));
+}
+
+void ZPageAllocator::set_director_threshold(size_t threshold) {
+  Atomic::store(&_director_threshold, threshold);
 }
 
 size_t ZPageAllocator::capacity() const {
@@ -240,6 +472,16 @@ size_t ZPageAllocator::max_reserve() const {
   return _max_reserve;
 }
 
+void ZPageAllocator::set_max_reserve(size_t size) {
+  ZPageAllocatorLocker locker(this);
+  _max_reserve = size;
+  _max_reserve_used = 0;
+}
+
+size_t ZPageAllocator::max_reserve_used() const {
+  return _max_reserve_used;
+}
+
 size_t ZPageAllocator::used_high() const {
   return _used_high;
 }
@@ -249,56 +491,135 @@ size_t ZPageAllocator::used_low() const {
 }
 
 size_t ZPageAllocator::used() const {
-  return _used;
+  // Free pages parked in the page magazines are accounted as used by the
+  // allocator, so that they can be handed out without taking the lock,
+  // but they are not reported as used heap
+  const size_t used = Atomic::load(&_used);
+  return used - MIN2(used, magazine_used());
 }
 
 size_t ZPageAllocator::unused() const {
-  const ssize_t unused = (ssize_t)_capacity - (ssize_t)_used - (ssize_t)_max_reserve;
+  const ssize_t unused = (ssize_t)_capacity - (ssize_t)used() - (ssize_t)_max_reserve;
   return unused > 0 ? (size_t)unused : 0;
 }
 
 size_t ZPageAllocator::allocated() const {
-  return _allocated;
+  size_t total_allocated = 0;
+
+  ZPerCPUConstIterator<size_t> iter(&_allocated);
+  for (const size_t* cpu_allocated; iter.next(&cpu_allocated);) {
+    total_allocated += *cpu_allocated;
+  }
+
+  return total_allocated;
 }
 
 size_t ZPageAllocator::reclaimed() const {
-  return _reclaimed > 0 ? (size_t)_reclaimed : 0;
+  ssize_t total_reclaimed = 0;
+
+  ZPerCPUConstIterator<ssize_t> iter(&_reclaimed);
+  for (const ssize_t* cpu_reclaimed; iter.next(&cpu_reclaimed);) {
+    total_reclaimed += *cpu_reclaimed;
+  }
+
+  return total_reclaimed > 0 ? (size_t)total_reclaimed : 0;
 }
 
 void ZPageAllocator::reset_statistics() {
   assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
-  _allocated = 0;
-  _reclaimed = 0;
+  _allocated.set_all(0);
+  _reclaimed.set_all(0);
   _used_high = _used_low = _used;
 }
 
-void ZPageAllocator::increase_used(size_t size, bool relocation) {
+void ZPageAllocator::increase_allocated(size_t size, bool relocation) {
+  // The allocated and reclaimed counters are also updated by the
+  // page magazine paths, which don't hold the lock, so they are
+  // always updated atomically. They are kept per CPU, so that
+  // concurrent updates don't contend on a single cache line.
   if (relocation) {
     // Allocating a page for the purpose of relocation has a
     // negative contribution to the number of reclaimed bytes.
-    _reclaimed -= size;
-  }
-  _allocated += size;
-  _used += size;
-  if (_used > _used_high) {
-    _used_high = _used;
+    Atomic::sub(_reclaimed.addr(), (ssize_t)size);
   }
+  Atomic::add(_allocated.addr(), size);
 }
 
-void ZPageAllocator::decrease_used(size_t size, bool reclaimed) {
+void ZPageAllocator::increase_reclaimed(size_t size, bool reclaimed) {
   if (reclaimed) {
     // Only pages explicitly released with the reclaimed flag set
     // counts as reclaimed bytes. This flag is typically true when
     // a worker releases a page after relocation, and is typically
     // false when we release a page to undo an allocation.
-    _reclaimed += size;
+    Atomic::add(_reclaimed.addr(), (ssize_t)size);
+  }
+}
+
+void ZPageAllocator::increase_used_inner(size_t size) {
+  _used += size;
+  if (_used > _used_high) {
+    _used_high = _used;
   }
+}
+
+void ZPageAllocator::decrease_used_inner(size_t size) {
   _used -= size;
   if (_used < _used_low) {
     _used_low = _used;
   }
 }
 
+void ZPageAllocator::increase_used(size_t size, bool relocation) {
+  increase_allocated(size, relocation);
+  increase_used_inner(size);
+
+  // Track how much of the reserve has been used since it was last sized
+  const size_t limit = _current_max_capacity - MIN2(_current_max_capacity, _max_reserve);
+  if (_used > limit) {
+    _max_reserve_used = MAX2(_max_reserve_used, MIN2(_used - limit, _max_reserve));
+  }
+
+  if (_used >= Atomic::load(&_director_threshold)) {
+    // Heap usage crossed the level at which the director would start
+    // a GC cycle, wake it up instead of waiting for its next tick. The
+    // threshold is one-shot and is re-armed by the director.
+    Atomic::store(&_director_threshold, SIZE_MAX);
+    ZCollectedHeap::heap()->wakeup_director();
+  }
+}
+
+void ZPageAllocator::decrease_used(size_t size, bool reclaimed) {
+  increase_reclaimed(size, reclaimed);
+  decrease_used_inner(size);
+}
+
+void ZPageAllocator::increase_magazine_used(size_t size) {
+  // Updated by the page magazine paths, which don't hold the lock. The
+  // per CPU counters can be negative, if a page is put in a magazine and
+  // taken out of it on different CPUs, but their sum never is.
+  Atomic::add(_magazine_used.addr(), (ssize_t)size);
+}
+
+void ZPageAllocator::decrease_magazine_used(size_t size) {
+  Atomic::sub(_magazine_used.addr(), (ssize_t)size);
+}
+
+size_t ZPageAllocator::magazine_used() const {
+  if (ZSmallPageMagazineSize == 0) {
+    // Not enabled
+    return 0;
+  }
+
+  ssize_t total_magazine_used = 0;
+
+  ZPerCPUConstIterator<ssize_t> iter(&_magazine_used);
+  for (const ssize_t* cpu_magazine_used; iter.next(&cpu_magazine_used);) {
+    total_magazine_used += Atomic::load(cpu_magazine_used);
+  }
+
+  return total_magazine_used > 0 ? (size_t)total_magazine_used : 0;
+}
+
 ZPage* ZPageAllocator::create_page(uint8_t type, size_t size) {
   // Allocate virtual memory
   const ZVirtualMemory vmem = _virtual.alloc(size);
@@ -308,11 +629,18 @@ ZPage* ZPageAllocator::create_page(uint8_t type, size_t size) {
   }
 
   // Allocate physical memory
-  const ZPhysicalMemory pmem = _physical.alloc(size);
+  bool zeroed;
+  const ZPhysicalMemory pmem = _physical.alloc(size, &zeroed);
   assert(!pmem.is_null(), "Invalid size");
 
   // Allocate page
-  return new ZPage(type, vmem, pmem);
+  ZPage* const page = new ZPage(type, vmem, pmem);
+  if (zeroed) {
+    // Freshly committed memory is known to be zero
+    page->set_zeroed();
+  }
+
+  return page;
 }
 
 void ZPageAllocator::destroy_page(ZPage* page) {
@@ -335,6 +663,71 @@ void ZPageAllocator::destroy_page(ZPage* page) {
 void ZPageAllocator::map_page(const ZPage* page) const {
   // Map physical memory
   _physical.map(page->physical_memory(), page->start());
+
+  if (ZNUMABindSmallPages && page->type() == ZPageTypeSmall) {
+    // Bind memory to the NUMA node of the allocating thread. This replaces
+    // the interleave policy set up when mapping, and must be done before the
+    // memory is touched. The memory policy is shared by all heap views, so
+    // it's enough to bind the memory through the good view.
+    ZNUMA::memory_bind_local(ZAddress::good(page->start()), page->size());
+  }
+}
+
+static void bind_page(const ZPage* page, bool cold) {
+  const uintptr_t addr = ZAddress::good(page->start());
+  if (cold) {
+    ZNUMA::memory_bind_cold(addr, page->size());
+  } else {
+    ZNUMA::memory_bind_local(addr, page->size());
+  }
+}
+
+bool ZPageAllocator::place_page(ZPage* page, bool cold) {
+  if (!ZNUMA::has_cold_memory()) {
+    // Memory tiering not enabled
+    return true;
+  }
+
+  const bool is_cold = page->numa_id() == ZNUMA::cold_memory_id();
+  if (is_cold == cold) {
+    // Already on the right memory tier
+    return true;
+  }
+
+  // Tenured pages are placed on the cold memory node, and all other pages
+  // on the NUMA node of the allocating thread. The page has no live objects
+  // yet, so instead of migrating its contents, the memory is rebound and
+  // then replaced with new memory allocated according to the new policy.
+  // Pages in the page cache keep their memory tier, so a cold page is only
+  // moved again if it's reused for a page of the other tier.
+  bind_page(page, cold);
+
+  if (!_physical.recommit(page->physical_memory())) {
+    // Failed, typically because the node is full. Rebind the page to its
+    // current memory tier, and fill any memory that was given up. Part
+    // of the memory might already have been replaced on the other node,
+    // so let the node id be looked up again when needed.
+    bind_page(page, is_cold);
+    page->clear_numa_id();
+    if (!_physical.refill(page->physical_memory())) {
+      // Out of memory on both memory tiers
+      return false;
+    }
+
+    return true;
+  }
+
+  // The preferred node might have been full, so let
+  // the node id be looked up again when needed
+  page->clear_numa_id();
+
+  if (cold) {
+    ZStatInc(ZCounterColdMemoryPlaced, page->size());
+  } else {
+    ZStatInc(ZCounterColdMemoryReclaimed, page->size());
+  }
+
+  return true;
 }
 
 size_t ZPageAllocator::max_available(bool no_reserve) const {
@@ -402,18 +795,96 @@ void ZPageAllocator::ensure_uncached_available(size_t size) {
   }
 }
 
-ZPage* ZPageAllocator::alloc_page_common_inner(uint8_t type, size_t size, bool no_reserve) {
+bool ZPageAllocator::is_partition_limited(size_t size, ZAllocationFlags flags) const {
+  if (flags.relocation() || flags.partition() == ZPartitionDefault) {
+    // Relocation and the default partition are never limited
+    return false;
+  }
+
+  if (used() + size <= soft_max_capacity()) {
+    // Heap is below its soft max capacity
+    return false;
+  }
+
+  // Heap is over its soft max capacity, stall the partition
+  // if the allocation would also exceed its own soft max
+  return ZPartitions::get(flags.partition())->would_exceed_soft_max_capacity(size);
+}
+
+void ZPageAllocator::increase_partition_used(ZPage* page, ZAllocationFlags flags) {
+  // Account the page to its allocation partition when it's allocated,
+  // so that concurrent allocations of the partition are accounted for
+  // when checking its soft max capacity
+  if (ZPartitions::is_enabled()) {
+    page->set_partition(flags.partition());
+    ZPartitions::get(flags.partition())->increase_used(page->size());
+  }
+}
+
+void ZPageAllocator::decrease_partition_used(const ZPage* page) {
+  if (ZPartitions::is_enabled()) {
+    ZPartitions::get(page->partition())->decrease_used(page->size());
+  }
+}
+
+ZPage* ZPageAllocator::alloc_merged_page(uint8_t type, size_t size, const ZPageCacheMerge* merge) {
+  ZList<ZPage> pages;
+  if (!_cache.remove_mergeable_pages(merge, &pages)) {
+    // No mergeable pages
+    return NULL;
+  }
+
+  // Merge the pages in place. Their memory is already mapped at adjacent
+  // addresses, so only the page objects of the merged pages are deleted.
+  ZPage* page = pages.remove_first();
+  for (ZPage* next = pages.remove_first(); next != NULL; next = pages.remove_first()) {
+    page->merge(next);
+    _safe_delete(next);
+  }
+
+  if (size < page->size()) {
+    // Split merged page, cache remainder
+    ZPage* const remainder = page;
+    page = remainder->split(type, size);
+    _cache.free_page(remainder);
+  } else if (page->type() != type) {
+    // Re-type correctly sized page
+    page = page->retype(type);
+  }
+
+  return page;
+}
+
+ZPage* ZPageAllocator::alloc_page_common_inner(uint8_t type, size_t size, bool no_reserve, bool zeroed, ZPageCacheMerge* merge) {
   if (!ensure_available(size, no_reserve)) {
     // Not enough free memory
     return NULL;
   }
 
   // Try allocate page from the cache
-  ZPage* const page = _cache.alloc_page(type, size);
+  ZPage* page = _cache.alloc_page(type, size, zeroed);
   if (page != NULL) {
     return page;
   }
 
+  // Try merge cached pages, if the page otherwise
+  // can't be created without flushing the cache
+  const size_t uncached_available = _capacity - _used - _cache.available();
+  if (merge != NULL && size > uncached_available) {
+    if (!merge->is_collected()) {
+      if (_cache.collect_mergeable_pages(size, merge)) {
+        // Let the caller search the collected pages
+        // with the lock released, and then retry
+        return NULL;
+      }
+    } else {
+      page = alloc_merged_page(type, size, merge);
+      if (page != NULL) {
+        return page;
+      }
+    }
+  }
+
   // Try flush pages from the cache
   ensure_uncached_available(size);
 
@@ -421,15 +892,41 @@ ZPage* ZPageAllocator::alloc_page_common_inner(uint8_t type, size_t size, bool n
   return create_page(type, size);
 }
 
-ZPage* ZPageAllocator::alloc_page_common(uint8_t type, size_t size, ZAllocationFlags flags) {
-  ZPage* const page = alloc_page_common_inner(type, size, flags.no_reserve());
-  if (page == NULL) {
-    // Out of memory
+ZPage* ZPageAllocator::alloc_page_common(uint8_t type, size_t size, ZAllocationFlags flags, bool partition_limit, ZPageCacheMerge* merge) {
+  if (partition_limit && is_partition_limited(size, flags)) {
+    // Partition over soft max capacity
     return NULL;
   }
 
+  ZPage* page = alloc_page_common_inner(type, size, flags.no_reserve(), flags.zeroed(), merge);
+  if (page == NULL) {
+    if (merge != NULL && merge->is_pending()) {
+      // Cached pages to search for pages to merge
+      return NULL;
+    }
+
+    if (flush_magazines() == 0) {
+      // Out of memory
+      return NULL;
+    }
+
+    // Retry with the pages flushed from the magazines available
+    page = alloc_page_common_inner(type, size, flags.no_reserve(), flags.zeroed(), merge);
+    if (page == NULL) {
+      // Out of memory
+      return NULL;
+    }
+  }
+
   // Update used statistics
   increase_used(size, flags.relocation());
+  increase_partition_used(page, flags);
+
+  if (is_magazine_enabled(type) && _queue.is_empty()) {
+    // Refill magazine, unless there are stalled allocations
+    // waiting for memory to become available
+    refill_magazine();
+  }
 
   // Send trace event
   ZTracer::tracer()->report_page_alloc(size, _used, max_available(flags.no_reserve()), _cache.available(), flags);
@@ -443,77 +940,263 @@ void ZPageAllocator::check_out_of_memory_during_initialization() {
   }
 }
 
+void ZPageAllocator::assist_relocation(ZPageAllocRequest* request) const {
+  if (!ZAllocationStallAssist || !Thread::current()->is_Java_thread()) {
+    // Not assisting
+    return;
+  }
+
+  JavaThread* const thread = JavaThread::current();
+  ZPage* const value = request->peek();
+
+  // Relocate pages until the request has been satisfied, i.e. a new value
+  // has been set, or until there are no pages left to relocate. Relocated
+  // pages are freed, so helping with the relocation shortens the stall for
+  // all stalled threads.
+  while (request->peek() == value && ZHeap::heap()->relocate_assist()) {
+    // Allow safepoints between pages
+    ThreadBlockInVM tbivm(thread);
+  }
+}
+
+ZPage* ZPageAllocator::alloc_page_merge(uint8_t type, size_t size, ZAllocationFlags flags) {
+  ZPageCacheMerge merge;
+  ZPage* const page = alloc_page_common(type, size, flags, true /* partition_limit */, &merge);
+  if (page != NULL || !merge.is_pending()) {
+    return page;
+  }
+
+  // Search the collected cached pages for pages to merge with the lock
+  // released, since that involves sorting them, and then retry. Stalled
+  // allocation requests never merge cached pages, since the lock can't
+  // be released while satisfying them.
+  unlock();
+  merge.search();
+  lock();
+
+  return alloc_page_common(type, size, flags, true /* partition_limit */, &merge);
+}
+
 ZPage* ZPageAllocator::alloc_page_blocking(uint8_t type, size_t size, ZAllocationFlags flags) {
   // Prepare to block
   ZPageAllocRequest request(type, size, flags, ZCollectedHeap::heap()->total_collections());
 
-  _lock.lock();
+  lock();
 
   // Try non-blocking allocation
-  ZPage* page = alloc_page_common(type, size, flags);
+  ZPage* page = alloc_page_merge(type, size, flags);
   if (page == NULL) {
     // Allocation failed, enqueue request
     _queue.insert_last(&request);
+
+    // Pages can have been freed to the magazines after they were
+    // flushed, by threads that saw an empty queue. Flush them again
+    // now that the request is visible. This pairs with the queue
+    // check in free_page_to_magazine().
+    OrderAccess::fence();
+    if (flush_magazines() > 0) {
+      satisfy_alloc_queue();
+    }
   }
 
-  _lock.unlock();
+  unlock();
 
   if (page == NULL) {
     // Allocation failed
     ZStatTimer timer(ZCriticalPhaseAllocationStall);
+    const Ticks start = Ticks::now();
 
     // We can only block if VM is fully initialized
     check_out_of_memory_during_initialization();
 
+    HOTSPOT_ZGC_ALLOC_STALL_START(type, size);
+
     do {
       // Start asynchronous GC
       ZCollectedHeap::heap()->collect(GCCause::_z_allocation_stall);
 
-      // Wait for allocation to complete or fail
-      page = request.wait();
+      // Help relocate pages, if relocation is in progress
+      assist_relocation(&request);
+
+      // Wait for allocation to complete or fail, and help
+      // relocate pages when woken up by relocation starting
+      for (page = wait_alloc_request(&request); page == relocate_marker; page = wait_alloc_request(&request)) {
+        assist_relocation(&request);
+      }
     } while (page == gc_marker);
 
-    {
-      //
-      // We grab the lock here for two different reasons:
-      //
-      // 1) Guard deletion of underlying semaphore. This is a workaround for
-      // a bug in sem_post() in glibc < 2.21, where it's not safe to destroy
-      // the semaphore immediately after returning from sem_wait(). The
-      // reason is that sem_post() can touch the semaphore after a waiting
-      // thread have returned from sem_wait(). To avoid this race we are
-      // forcing the waiting thread to acquire/release the lock held by the
-      // posting thread. https://sourceware.org/bugzilla/show_bug.cgi?id=12674
-      //
-      // 2) Guard the list of satisfied pages.
-      //
-      ZLocker<ZLock> locker(&_lock);
-      _satisfied.remove(&request);
-    }
+    // Track allocation stall latency distribution
+    const Ticks end = Ticks::now();
+    ZStatLatency::register_allocation_stall(end - start);
+
+    HOTSPOT_ZGC_ALLOC_STALL_END(type, size, (end - start).nanoseconds());
+
+    // Send event
+    ZTracer::tracer()->report_allocation_stall(type, size, start, end);
+  }
+
+  return page;
+}
+
+ZPage* ZPageAllocator::wait_alloc_request(ZPageAllocRequest* request) {
+  request->wait();
+
+  // Consume the signal with the lock held, since the request can be
+  // satisfied again concurrently
+  ZPageAllocatorLocker locker(this);
+  ZPage* const page = request->consume_signal();
+  if (page != gc_marker && page != relocate_marker) {
+    // Satisfied with a page, or failed. Remove the request from the
+    // list of satisfied requests, used by pages_do(), while still
+    // holding the lock, so that the lock is only taken once.
+    _satisfied.remove(request);
   }
 
   return page;
 }
 
 ZPage* ZPageAllocator::alloc_page_nonblocking(uint8_t type, size_t size, ZAllocationFlags flags) {
-  ZLocker<ZLock> locker(&_lock);
-  return alloc_page_common(type, size, flags);
+  ZPageAllocatorLocker locker(this);
+  return alloc_page_merge(type, size, flags);
 }
 
-ZPage* ZPageAllocator::alloc_page(uint8_t type, size_t size, ZAllocationFlags flags) {
-  ZPage* const page = flags.non_blocking()
-                      ? alloc_page_nonblocking(type, size, flags)
-                      : alloc_page_blocking(type, size, flags);
+bool ZPageAllocator::is_magazine_enabled(uint8_t type) const {
+  return ZSmallPageMagazineSize > 0 && type == ZPageTypeSmall;
+}
+
+ZPage* ZPageAllocator::alloc_page_from_magazine(uint8_t type, size_t size, ZAllocationFlags flags) {
+  if (!is_magazine_enabled(type) || is_partition_limited(size, flags)) {
+    // Not enabled, or partition over soft max capacity
+    return NULL;
+  }
+
+  ZPage* const page = _magazines.addr()->alloc(ZSmallPageMagazineSize);
   if (page == NULL) {
-    // Out of memory
+    // Magazine empty
     return NULL;
   }
 
+  // The page was already accounted as used by the allocator when it
+  // was put in the magazine, so only the allocated statistics and the
+  // magazine usage are updated.
+  increase_allocated(size, flags.relocation());
+  decrease_magazine_used(page->size());
+  increase_partition_used(page, flags);
+
+  return page;
+}
+
+bool ZPageAllocator::free_page_to_magazine(ZPage* page, bool reclaimed) {
+  if (!is_magazine_enabled(page->type()) || !_queue.is_empty()) {
+    // Not enabled, or stalled allocations are waiting for memory
+    return false;
+  }
+
+  if (!_magazines.addr()->free(page, ZSmallPageMagazineSize)) {
+    // Magazine full
+    return false;
+  }
+
+  // The page stays accounted as used by the allocator while in the
+  // magazine, but is no longer reported as used heap
+  increase_reclaimed(page->size(), reclaimed);
+  increase_magazine_used(page->size());
+
+  // An allocation can have stalled after the queue was checked above,
+  // in which case it might have missed this page. Re-check the queue,
+  // after the page was published, and hand the page over if needed.
+  // This pairs with the fence in alloc_page_blocking().
+  if (!_queue.is_empty()) {
+    ZPageAllocatorLocker locker(this);
+    if (flush_magazines() > 0) {
+      satisfy_alloc_queue();
+    }
+  }
+
+  return true;
+}
+
+void ZPageAllocator::refill_magazine() {
+  ZPageMagazine* const magazine = _magazines.addr();
+
+  // Fill the magazine of the current CPU with pages from the NUMA
+  // local page cache. The pages are accounted as used up front, which
+  // lets them be handed out without taking the lock. Memory is never
+  // committed for, and the reserve is never used by, magazine pages.
+  while (!magazine->is_full(ZSmallPageMagazineSize) && max_available(true /* no_reserve */) >= ZPageSizeSmall) {
+    ZPage* const page = _cache.alloc_local_small_page();
+    if (page == NULL) {
+      // Cache empty
+      return;
+    }
+
+    if (!magazine->free(page, ZSmallPageMagazineSize)) {
+      // Filled concurrently
+      _cache.free_page(page);
+      return;
+    }
+
+    increase_used_inner(page->size());
+    increase_magazine_used(page->size());
+  }
+}
+
+size_t ZPageAllocator::flush_magazines() {
+  if (ZSmallPageMagazineSize == 0) {
+    // Not enabled
+    return 0;
+  }
+
+  size_t flushed = 0;
+
+  // Return all magazine pages to the page cache
+  ZPerCPUIterator<ZPageMagazine> iter(&_magazines);
+  for (ZPageMagazine* magazine; iter.next(&magazine);) {
+    for (ZPage* page = magazine->alloc(ZSmallPageMagazineSize); page != NULL; page = magazine->alloc(ZSmallPageMagazineSize)) {
+      const size_t size = page->size();
+      decrease_used_inner(size);
+      decrease_magazine_used(size);
+      _cache.free_page(page);
+      flushed += size;
+    }
+  }
+
+  return flushed;
+}
+
+ZPage* ZPageAllocator::alloc_page(uint8_t type, size_t size, ZAllocationFlags flags) {
+  const Ticks start = Ticks::now();
+
+  ZPage* page = alloc_page_from_magazine(type, size, flags);
+  if (page == NULL) {
+    page = flags.non_blocking()
+           ? alloc_page_nonblocking(type, size, flags)
+           : alloc_page_blocking(type, size, flags);
+    if (page == NULL) {
+      // Out of memory
+      return NULL;
+    }
+  }
+
   // Map page if needed
   if (!page->is_mapped()) {
     map_page(page);
   }
 
+  // Place page on the memory tier matching the age of its objects
+  if (!place_page(page, flags.tenured())) {
+    // Out of memory, give the page back and fail the allocation. The
+    // memory that could not be replaced is backed again when touched.
+    ZPageAllocatorLocker locker(this);
+    decrease_used(page->size(), false /* reclaimed */);
+    decrease_partition_used(page);
+    _cache.free_page(page);
+    return NULL;
+  }
+
+  // Update page demand statistics
+  _demand.increase(page->type(), page->size());
+
   // Reset page. This updates the page's sequence number and must
   // be done after page allocation, which potentially blocked in
   // a safepoint where the global sequence number was updated.
@@ -529,41 +1212,128 @@ ZPage* ZPageAllocator::alloc_page(uint8_t type, size_t size, ZAllocationFlags fl
     ZStatInc(ZStatAllocRate::counter(), bytes);
   }
 
+  // Update latency statistics, including any time spent stalled
+  ZStatSample(ZHistogramPageAllocation, (Ticks::now() - start).value());
+
   return page;
 }
 
+// Requests from allocation partitions that are over their soft max
+// capacity are skipped, so that they don't hold up other partitions.
+
+ZPageAllocRequest* ZPageAllocator::first_alloc_request() const {
+  ZListIterator<ZPageAllocRequest> iter(&_queue);
+  for (ZPageAllocRequest* request; iter.next(&request);) {
+    if (!is_partition_limited(request->size(), request->flags())) {
+      return request;
+    }
+  }
+
+  return NULL;
+}
+
+ZPageAllocRequest* ZPageAllocator::smallest_alloc_request() const {
+  ZPageAllocRequest* smallest = NULL;
+
+  ZListIterator<ZPageAllocRequest> iter(&_queue);
+  for (ZPageAllocRequest* request; iter.next(&request);) {
+    if (is_partition_limited(request->size(), request->flags())) {
+      continue;
+    }
+
+    if (smallest == NULL || request->size() < smallest->size()) {
+      smallest = request;
+    }
+  }
+
+  return smallest;
+}
+
+bool ZPageAllocator::satisfy_alloc_request(ZPageAllocRequest* request, bool partition_limit) {
+  ZPage* const page = alloc_page_common(request->type(), request->size(), request->flags(), partition_limit, NULL /* merge */);
+  if (page == NULL) {
+    // Allocation could not be satisfied
+    return false;
+  }
+
+  // Allocation succeeded, dequeue and satisfy request. The waiting
+  // thread is woken up once the lock has been released.
+  _queue.remove(request);
+  _satisfied.insert_first(request);
+  if (request->set_and_claim_signal(page)) {
+    _wakeups.add(request);
+  }
+  return true;
+}
+
 void ZPageAllocator::satisfy_alloc_queue() {
+  if (_stall_policy == ZStallPolicyBypass) {
+    // Satisfy requests in order, but let requests that can be satisfied
+    // bypass requests that can't, such as a large page request at the
+    // head of the queue. The head is still tried first every time.
+    for (ZPageAllocRequest* request = _queue.first(); request != NULL;) {
+      // Look up the next request first, since the
+      // request is deallocated once satisfied
+      ZPageAllocRequest* const next = _queue.next(request);
+      satisfy_alloc_request(request, true /* partition_limit */);
+      request = next;
+    }
+
+    return;
+  }
+
   for (;;) {
-    ZPageAllocRequest* const request = _queue.first();
+    // Satisfy requests in order, or smallest request first
+    ZPageAllocRequest* const request = (_stall_policy == ZStallPolicySmallest)
+                                       ? smallest_alloc_request()
+                                       : first_alloc_request();
     if (request == NULL) {
-      // Allocation queue is empty
+      // Allocation queue is empty, or all partitions limited
       return;
     }
 
-    ZPage* const page = alloc_page_common(request->type(), request->size(), request->flags());
-    if (page == NULL) {
+    if (!satisfy_alloc_request(request, true /* partition_limit */)) {
       // Allocation could not be satisfied, give up
       return;
     }
+  }
+}
 
-    // Allocation succeeded, dequeue and satisfy request. Note that
-    // the dequeue operation must happen first, since the request
-    // will immediately be deallocated once it has been satisfied.
-    _queue.remove(request);
-    _satisfied.insert_first(request);
-    request->satisfy(page);
+static void sample_page_age(const ZPage* page) {
+  // Number of GC cycles from allocation until reclamation
+  const uint8_t type = page->type();
+  if (type == ZPageTypeSmall) {
+    ZStatSample(ZSamplerPageAgeSmall, page->age());
+  } else if (type == ZPageTypeMedium) {
+    ZStatSample(ZSamplerPageAgeMedium, page->age());
+  } else {
+    ZStatSample(ZSamplerPageAgeLarge, page->age());
   }
 }
 
 void ZPageAllocator::free_page(ZPage* page, bool reclaimed) {
-  ZLocker<ZLock> locker(&_lock);
+  decrease_partition_used(page);
 
-  // Update used statistics
-  decrease_used(page->size(), reclaimed);
+  if (reclaimed) {
+    sample_page_age(page);
+  }
 
   // Set time when last used
   page->set_last_used();
 
+  // The page has been used, its memory is no longer zeroed
+  page->clear_zeroed();
+
+  // Try free page to the magazine
+  if (free_page_to_magazine(page, reclaimed)) {
+    return;
+  }
+
+  ZPageAllocatorLocker locker(this);
+
+  // Update used statistics
+  decrease_used(page->size(), reclaimed);
+
   // Cache page
   _cache.free_page(page);
 
@@ -571,29 +1341,120 @@ void ZPageAllocator::free_page(ZPage* page, bool reclaimed) {
   satisfy_alloc_queue();
 }
 
-size_t ZPageAllocator::flush_cache(ZPageCacheFlushClosure* cl) {
-  ZList<ZPage> list;
+void ZPageAllocator::free_pages(ZArray<ZPage*>* pages, bool reclaimed) {
+  size_t size = 0;
+
+  ZArrayIterator<ZPage*> iter1(pages);
+  for (ZPage* page; iter1.next(&page);) {
+    size += page->size();
+
+    decrease_partition_used(page);
+
+    if (reclaimed) {
+      sample_page_age(page);
+    }
+
+    // Set time when last used
+    page->set_last_used();
+
+    // The page has been used, its memory is no longer zeroed
+    page->clear_zeroed();
+  }
+
+  // Free all pages under a single lock acquisition. The pages bypass
+  // the page magazines, which only hold a few pages per CPU anyway.
+  ZPageAllocatorLocker locker(this);
+
+  // Update used statistics
+  decrease_used(size, reclaimed);
+
+  // Cache pages
+  ZArrayIterator<ZPage*> iter2(pages);
+  for (ZPage* page; iter2.next(&page);) {
+    _cache.free_page(page);
+  }
+
+  // Try satisfy blocked allocations
+  satisfy_alloc_queue();
+}
+
+void ZPageAllocator::notify_relocation_assist() {
+  ZPageAllocatorLocker locker(this);
+
+  // Wake up threads with enqueued allocation requests, to let them help
+  // relocate pages while waiting. The requests are kept enqueued.
+  ZListIterator<ZPageAllocRequest> iter(&_queue);
+  for (ZPageAllocRequest* request; iter.next(&request);) {
+    request->satisfy(relocate_marker);
+  }
+}
+
+bool ZPageAllocator::should_remap_page(const ZPage* page) {
+  // Large pages are allocated from the back of the address space. Moving
+  // a large page to a higher address, if there is room for it, leaves the
+  // free address space below it less fragmented.
+  return _virtual.has_free_above(page->virtual_memory());
+}
+
+ZPage* ZPageAllocator::remap_page(const ZPage* page) {
+  // Allocate virtual memory
+  const ZVirtualMemory vmem = _virtual.alloc_above(page->virtual_memory());
+  if (vmem.is_null()) {
+    // No room above the page
+    return NULL;
+  }
+
+  // Map the physical memory of the page at the new address. The memory
+  // is then accessible through both the old and the new address, and no
+  // physical memory is allocated, so the used statistics are unaffected.
+  _physical.map(page->physical_memory(), vmem.start());
+
+  // Allocate page
+  return page->remap(vmem);
+}
+
+void ZPageAllocator::free_remapped_page(ZPage* page) {
+  // The physical memory of the page is still mapped by the page it was
+  // remapped to, or from, so only the virtual memory is freed here.
+  const ZVirtualMemory& vmem = page->virtual_memory();
 
+  // Unmap memory
+  _physical.unmap(page->physical_memory(), vmem.start());
+
+  // Free virtual memory
+  _virtual.free(vmem);
+
+  // Delete page safely
+  _safe_delete(page);
+}
+
+size_t ZPageAllocator::flush_cache(ZPageCacheFlushClosure* cl, ZList<ZPage>* pages) {
   // Flush pages
-  _cache.flush(cl, &list);
+  _cache.flush(cl, pages, &_demand);
 
   const size_t overflushed = cl->overflushed();
   if (overflushed > 0) {
     // Overflushed, keep part of last page
-    ZPage* const page = list.last()->split(overflushed);
+    ZPage* const page = pages->last()->split(overflushed);
     _cache.free_page(page);
   }
 
-  // Destroy pages
+  // Calculate flushed size
   size_t flushed = 0;
-  for (ZPage* page = list.remove_first(); page != NULL; page = list.remove_first()) {
+  ZListIterator<ZPage> iter(pages);
+  for (ZPage* page; iter.next(&page);) {
     flushed += page->size();
-    destroy_page(page);
   }
 
   return flushed;
 }
 
+void ZPageAllocator::destroy_pages(ZList<ZPage>* pages) {
+  for (ZPage* page = pages->remove_first(); page != NULL; page = pages->remove_first()) {
+    destroy_page(page);
+  }
+}
+
 class ZPageCacheFlushForAllocationClosure : public ZPageCacheFlushClosure {
 public:
   ZPageCacheFlushForAllocationClosure(size_t requested) :
@@ -615,8 +1476,10 @@ void ZPageAllocator::flush_cache_for_allocation(size_t requested) {
   assert(requested <= _cache.available(), "Invalid request");
 
   // Flush pages
+  ZList<ZPage> pages;
   ZPageCacheFlushForAllocationClosure cl(requested);
-  const size_t flushed = flush_cache(&cl);
+  const size_t flushed = flush_cache(&cl, &pages);
+  destroy_pages(&pages);
 
   assert(requested == flushed, "Failed to flush");
 
@@ -668,7 +1531,141 @@ public:
   }
 };
 
-uint64_t ZPageAllocator::uncommit(uint64_t delay) {
+static bool should_collapse() {
+  return ZCollapseTransparentHugePages && ZLargePages::is_transparent();
+}
+
+ZPage* ZPageAllocator::alloc_committed(size_t size) {
+  // The page is typed large, since small pages might get bound to
+  // the NUMA node of the current thread. The page cache splits it
+  // as needed.
+  ZPage* const page = create_page(ZPageTypeLarge, size);
+  if (page == NULL) {
+    // Out of address space, leave the memory to the allocation path
+    return NULL;
+  }
+
+  // The memory is accounted as used until the page has been added to
+  // the cache, so that it isn't handed out to someone else meanwhile
+  increase_used_inner(size);
+
+  return page;
+}
+
+bool ZPageAllocator::map_committed(ZPage* page) {
+  // Map, and optionally collapse into huge pages and pre-touch, the newly
+  // committed memory here, in the background, instead of having the first
+  // allocating Java thread take the page faults. This is done without
+  // holding the lock, and outside of the suspendible thread set, since
+  // it can take a long time and would otherwise block both concurrent
+  // page allocations and safepoints.
+  map_page(page);
+  page->set_pre_mapped();
+
+  const bool collapsed = should_collapse() && _physical.collapse(page->start(), page->size());
+
+  if (ZCommitAheadPreTouch) {
+    _physical.pretouch(page->start(), page->size());
+  }
+
+  SuspendibleThreadSetJoiner joiner;
+  ZPageAllocatorLocker locker(this);
+
+  // Add page to cache. Pre-touching writes zeroes, so the memory
+  // is still zeroed if it was freshly committed.
+  decrease_used_inner(page->size());
+  page->set_last_used();
+  _cache.free_page(page);
+
+  // Memory is available again, satisfy stalled allocations
+  satisfy_alloc_queue();
+
+  return collapsed;
+}
+
+size_t ZPageAllocator::commit_ahead(size_t headroom) {
+  if (!_initialized) {
+    // Not initialized
+    return 0;
+  }
+
+  size_t committed = 0;
+  size_t collapsed = 0;
+
+  // Commit one granule at a time, to keep the lock hold time
+  // short and avoid delaying concurrent page allocations.
+  for (;;) {
+    ZPage* page = NULL;
+    bool done = false;
+
+    {
+      SuspendibleThreadSetJoiner joiner;
+      ZPageAllocatorLocker locker(this);
+
+      // Remember the headroom, to avoid having it uncommitted
+      _commit_headroom = headroom;
+
+      // Never commit the reserve ahead of allocation, since the
+      // allocation path always makes room for it, and never commit
+      // beyond current max capacity. The deferred part of the initial
+      // capacity is committed regardless of the headroom.
+      const size_t needed = MIN2(MAX2(_used + _max_reserve + headroom, _commit_deferred), _current_max_capacity);
+      if (_capacity >= needed) {
+        // Enough committed memory available
+        _commit_deferred = 0;
+        break;
+      }
+
+      const size_t commit = MIN2(needed - _capacity, ZGranuleSize);
+      const size_t granule_committed = _physical.commit(commit);
+      _capacity += granule_committed;
+      committed += granule_committed;
+
+      if ((ZCommitAheadPreTouch || should_collapse()) && granule_committed > 0) {
+        page = alloc_committed(granule_committed);
+      }
+
+      // Stop if we failed, or partly failed, to increase capacity. Leave
+      // it to the allocation path to adjust current max capacity.
+      done = (granule_committed != commit);
+    }
+
+    if (page != NULL) {
+      // Read the size first, since the page is in the
+      // cache, and can be split, once it has been mapped
+      const size_t size = page->size();
+      if (map_committed(page)) {
+        collapsed += size;
+      }
+    }
+
+    if (done) {
+      break;
+    }
+  }
+
+  if (committed > 0) {
+    log_debug(gc, heap)("Commit Ahead: " SIZE_FORMAT "M, Headroom: " SIZE_FORMAT "M, Capacity: " SIZE_FORMAT "M",
+                        committed / M, headroom / M, _capacity / M);
+
+    // Update statistics
+    ZStatInc(ZCounterCommitAhead, committed);
+  }
+
+  if (collapsed > 0) {
+    const size_t coverage = _physical.huge_page_coverage();
+    log_info(gc, heap)("Transparent Huge Pages: " SIZE_FORMAT "M(%.0f%%), Collapsed: " SIZE_FORMAT "M",
+                       coverage / M, percent_of(coverage, _capacity), collapsed / M);
+  }
+
+  return committed;
+}
+
+void ZPageAllocator::sample_demand() {
+  _demand.sample();
+}
+
+uint64_t ZPageAllocator::uncommit(uint64_t delay, size_t limit) {
   // Set the default timeout, when no pages are found in the
   // cache or when uncommit is disabled, equal to the delay.
   uint64_t timeout = delay;
@@ -678,39 +1675,74 @@ uint64_t ZPageAllocator::uncommit(uint64_t delay) {
     return timeout;
   }
 
-  size_t capacity_before;
-  size_t capacity_after;
-  size_t uncommitted;
+  // Uncommit memory in chunks, until the limit has been reached or
+  // no more memory can be uncommitted. The lock is only held while
+  // selecting the memory to uncommit, and not while the memory is
+  // unmapped and uncommitted, to avoid stalling page allocations.
+  const size_t chunk_size = 16 * ZGranuleSize;
+  size_t uncommitted = 0;
 
-  {
-    SuspendibleThreadSetJoiner joiner;
-    ZLocker<ZLock> locker(&_lock);
+  while (uncommitted < limit) {
+    ZList<ZPage> pages;
+    size_t uncommit;
 
-    // Don't flush more than we will uncommit. Never uncommit
-    // the reserve, and never uncommit below min capacity.
-    const size_t needed = MIN2(_used + _max_reserve, _current_max_capacity);
-    const size_t guarded = MAX2(needed, _min_capacity);
-    const size_t uncommittable = _capacity - guarded;
-    const size_t uncached_available = _capacity - _used - _cache.available();
-    size_t uncommit = MIN2(uncommittable, uncached_available);
-    const size_t flush = uncommittable - uncommit;
+    {
+      SuspendibleThreadSetJoiner joiner;
+      ZPageAllocatorLocker locker(this);
+
+      // Don't flush more than we will uncommit. Never uncommit
+      // the reserve or the commit ahead headroom, and never
+      // uncommit below min capacity. Unless uncommitting without
+      // delay, or the soft max capacity is lowered due to memory
+      // pressure, also keep enough memory for the forecasted page
+      // demand during the retention time.
+      const size_t retained = (delay > 0 && !is_soft_max_limited()) ? MIN2(_demand.forecast_total(ZPageCacheRetentionTime), _current_max_capacity) : 0;
+      const size_t needed = MIN2(_used + _max_reserve + _commit_headroom + retained, _current_max_capacity);
+      const size_t guarded = MAX2(needed, _min_capacity);
+      const size_t uncommittable = MIN2(_capacity - MIN2(_capacity, guarded), MIN2(limit - uncommitted, chunk_size));
+      const size_t uncached_available = _capacity - _used - _cache.available();
+      uncommit = MIN2(uncommittable, uncached_available);
+      const size_t flush = uncommittable - uncommit;
+
+      if (flush > 0) {
+        // Flush pages to uncommit
+        ZPageCacheFlushForUncommitClosure cl(flush, delay);
+        uncommit += flush_cache(&cl, &pages);
+        timeout = cl.timeout();
+      }
 
-    if (flush > 0) {
-      // Flush pages to uncommit
-      ZPageCacheFlushForUncommitClosure cl(flush, delay);
-      uncommit += flush_cache(&cl);
-      timeout = cl.timeout();
+      if (uncommit == 0) {
+        // Nothing to uncommit
+        break;
+      }
+
+      // Deduct the memory to uncommit from the capacity up front,
+      // to make sure it's not handed out to page allocations while
+      // we're uncommitting it without holding the lock.
+      _capacity -= uncommit;
     }
 
-    // Uncommit
-    uncommitted = _physical.uncommit(uncommit);
-    _capacity -= uncommitted;
+    // Destroy flushed pages, which unmaps and frees their memory
+    destroy_pages(&pages);
 
-    capacity_after = _capacity;
-    capacity_before = capacity_after + uncommitted;
+    // Uncommit
+    const size_t chunk_uncommitted = _physical.uncommit(uncommit);
+    uncommitted += chunk_uncommitted;
+
+    if (chunk_uncommitted != uncommit) {
+      // Failed, or partly failed, to uncommit. Give back the
+      // memory that is still committed, and stop uncommitting.
+      SuspendibleThreadSetJoiner joiner;
+      ZPageAllocatorLocker locker(this);
+      _capacity += uncommit - chunk_uncommitted;
+      break;
+    }
   }
 
   if (uncommitted > 0) {
+    const size_t capacity_after = capacity();
+    const size_t capacity_before = capacity_after + uncommitted;
+
     log_info(gc, heap)("Capacity: " SIZE_FORMAT "M(%.0f%%)->" SIZE_FORMAT "M(%.0f%%), "
                        "Uncommitted: " SIZE_FORMAT "M",
                        capacity_before / M, percent_of(capacity_before, max_capacity()),
@@ -721,9 +1753,132 @@ uint64_t ZPageAllocator::uncommit(uint64_t delay) {
     ZStatInc(ZCounterUncommit, uncommitted);
   }
 
+  if (uncommitted >= limit) {
+    // Limit reached, continue in the next interval
+    return 0;
+  }
+
   return timeout;
 }
 
+size_t ZPageAllocator::defragment() {
+  if (!_initialized || !ZDefragmentPageCache) {
+    // Not initialized or disabled
+    return 0;
+  }
+
+  // Destroy cached pages whose physical memory is fragmented, in chunks
+  // to keep the lock hold time short. The physical memory is coalesced
+  // with adjacent free memory when freed, so pages created later can be
+  // backed by fewer segments, which need fewer mappings.
+  const size_t chunk_size = 16 * ZGranuleSize;
+  size_t defragmented = 0;
+
+  for (;;) {
+    SuspendibleThreadSetJoiner joiner;
+    ZPageAllocatorLocker locker(this);
+
+    ZList<ZPage> pages;
+    const size_t flushed = _cache.flush_fragmented(&pages, chunk_size);
+    if (flushed == 0) {
+      // Nothing to defragment
+      break;
+    }
+
+    destroy_pages(&pages);
+    defragmented += flushed;
+  }
+
+  if (defragmented > 0) {
+    log_debug(gc, heap)("Defragmented: " SIZE_FORMAT "M", defragmented / M);
+
+    // Update statistics
+    ZStatInc(ZCounterPageCacheDefragment, defragmented);
+  }
+
+  return defragmented;
+}
+
+void ZPageAllocator::zero_page(const ZPage* page) const {
+  // Zero one granule at a time, and only while joined to the suspendible
+  // thread set, to keep the good address of the memory stable without
+  // delaying safepoints for too long.
+  for (uintptr_t offset = page->start(); offset < page->end(); offset += ZGranuleSize) {
+    SuspendibleThreadSetJoiner joiner;
+    Copy::zero_to_bytes((void*)ZAddress::good(offset), ZGranuleSize);
+  }
+}
+
+size_t ZPageAllocator::zero_pages(size_t target) {
+  if (!_initialized) {
+    // Not initialized
+    return 0;
+  }
+
+  size_t zeroed = 0;
+
+  // Zero one page at a time, until the target has been reached or there
+  // are no more pages to zero. The lock is not held while zeroing, so the
+  // page is accounted as used in the meantime, like an allocated page.
+  for (;;) {
+    ZPage* page;
+
+    {
+      SuspendibleThreadSetJoiner joiner;
+      ZPageAllocatorLocker locker(this);
+
+      const size_t zeroed_available = _cache.zeroed_available();
+      if (zeroed_available >= target || !_queue.is_empty()) {
+        // Target reached, or stalled allocations are waiting for memory
+        break;
+      }
+
+      page = _cache.alloc_page_for_zeroing(align_up(target - zeroed_available, ZGranuleSize));
+      if (page == NULL) {
+        // Nothing to zero
+        break;
+      }
+
+      increase_used_inner(page->size());
+      _zeroing = page;
+    }
+
+    if (!page->is_mapped()) {
+      // Map page
+      map_page(page);
+    }
+
+    // Zero page
+    zero_page(page);
+
+    {
+      SuspendibleThreadSetJoiner joiner;
+      ZPageAllocatorLocker locker(this);
+
+      const size_t size = page->size();
+      _zeroing = NULL;
+      decrease_used_inner(size);
+      zeroed += size;
+
+      // Cache page
+      page->set_zeroed();
+      _cache.free_page(page);
+
+      // Try satisfy blocked allocations
+      satisfy_alloc_queue();
+    }
+  }
+
+  if (zeroed > 0) {
+    log_debug(gc, heap)("Zeroed: " SIZE_FORMAT "M, Target: " SIZE_FORMAT "M", zeroed / M, target / M);
+
+    // Update statistics
+    ZStatInc(ZCounterPageZeroed, zeroed);
+  }
+
+  return zeroed;
+}
+
 void ZPageAllocator::enable_deferred_delete() const {
   _safe_delete.enable_deferred_delete();
 }
@@ -751,16 +1906,46 @@ void ZPageAllocator::pages_do(ZPageClosure* cl) const {
     }
   }
 
+  if (_zeroing != NULL) {
+    cl->do_page(_zeroing);
+  }
+
+  ZPerCPUConstIterator<ZPageMagazine> iter_magazines(&_magazines);
+  for (const ZPageMagazine* magazine; iter_magazines.next(&magazine);) {
+    magazine->pages_do(cl);
+  }
+
+  _cache.pages_do(cl);
+}
+
+void ZPageAllocator::cache_pages_do(ZPageClosure* cl) {
+  ZPageAllocatorLocker locker(this);
   _cache.pages_do(cl);
 }
 
+void ZPageAllocator::virtual_free_stats(size_t* nareas, size_t* size, size_t* largest) {
+  _virtual.free_stats(nareas, size, largest);
+}
+
 bool ZPageAllocator::is_alloc_stalled() const {
-  assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
+  // Only exact at a safepoint. Outside of a safepoint this is a racy read
+  // of the queue, which is only used as a hint, by the director and by the
+  // relocation workers.
   return !_queue.is_empty();
 }
 
+bool ZPageAllocator::is_alloc_stalled_through_gc() const {
+  assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
+
+  // Requests are enqueued in order, so the first request is the one that
+  // has been stalled the longest. It has stayed unsatisfied through a
+  // completed GC cycle if it was enqueued before the last cycle started.
+  const ZPageAllocRequest* const request = _queue.first();
+  return request != NULL && request->total_collections() != ZCollectedHeap::heap()->total_collections();
+}
+
 void ZPageAllocator::check_out_of_memory() {
-  ZLocker<ZLock> locker(&_lock);
+  ZPageAllocatorLocker locker(this);
 
   // Fail allocation requests that were enqueued before the
   // last GC cycle started, otherwise start a new GC cycle.
@@ -771,6 +1956,23 @@ void ZPageAllocator::check_out_of_memory() {
       return;
     }
 
+    if (ZGraduatedSoftReferenceClearing &&
+        request->total_collections() + 1 == ZCollectedHeap::heap()->total_collections()) {
+      // The request has stalled through one GC cycle, which used the
+      // forecast soft reference policy. Start a new GC cycle, which clears
+      // all SoftReferences, before failing the request.
+      request->satisfy(gc_marker);
+      return;
+    }
+
+    if (is_partition_limited(request->size(), request->flags()) &&
+        satisfy_alloc_request(request, false /* partition_limit */)) {
+      // A GC cycle has completed and the partition is still over its
+      // soft max capacity. The limit is soft, so allocate beyond it while
+      // the heap still has memory available, instead of failing.
+      continue;
+    }
+
     // Out of memory, fail allocation request
     _queue.remove(request);
     _satisfied.insert_first(request);
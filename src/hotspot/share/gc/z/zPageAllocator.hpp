@@ -25,11 +25,15 @@
 #define SHARE_GC_Z_ZPAGEALLOCATOR_HPP
 
 #include "gc/z/zAllocationFlags.hpp"
+#include "gc/z/zArray.hpp"
 #include "gc/z/zList.hpp"
 #include "gc/z/zLock.hpp"
 #include "gc/z/zPageCache.hpp"
+#include "gc/z/zPageDemand.hpp"
+#include "gc/z/zPageMagazine.hpp"
 #include "gc/z/zPhysicalMemory.hpp"
 #include "gc/z/zSafeDelete.hpp"
+#include "gc/z/zValue.hpp"
 #include "gc/z/zVirtualMemory.hpp"
 #include "memory/allocation.hpp"
 
@@ -38,37 +42,65 @@ class ZWorkers;
 
 class ZPageAllocator {
   friend class VMStructs;
+  friend class ZPageAllocatorLocker;
+  friend class ZPageAllocRequest;
 
 private:
   ZLock                      _lock;
   ZVirtualMemoryManager      _virtual;
   ZPhysicalMemoryManager     _physical;
   ZPageCache                 _cache;
+  ZPageDemand                _demand;
+  ZPerCPU<ZPageMagazine>     _magazines;
   const size_t               _min_capacity;
   const size_t               _max_capacity;
-  const size_t               _max_reserve;
+  size_t                     _max_reserve;
+  size_t                     _max_reserve_used;
   size_t                     _current_max_capacity;
+  volatile size_t            _soft_max_limit;
+  volatile size_t            _director_threshold;
   size_t                     _capacity;
   size_t                     _used_high;
   size_t                     _used_low;
   size_t                     _used;
-  size_t                     _allocated;
-  ssize_t                    _reclaimed;
+  size_t                     _commit_headroom;
+  size_t                     _commit_deferred;
+  ZPerCPU<size_t>            _allocated;
+  ZPerCPU<ssize_t>           _reclaimed;
+  ZPerCPU<ssize_t>           _magazine_used;
   ZList<ZPageAllocRequest>   _queue;
   ZList<ZPageAllocRequest>   _satisfied;
+  ZArray<ZPageAllocRequest*> _wakeups;
+  ZPage*                     _zeroing;
+  const uint8_t              _stall_policy;
   mutable ZSafeDelete<ZPage> _safe_delete;
   bool                       _uncommit;
   bool                       _initialized;
 
   static ZPage* const gc_marker;
+  static ZPage* const relocate_marker;
 
+  void lock();
+  void unlock();
+
+  size_t initial_commit(size_t initial_capacity) const;
   void prime_cache(ZWorkers* workers, size_t size);
 
+  void increase_allocated(size_t size, bool relocation);
+  void increase_reclaimed(size_t size, bool reclaimed);
+  void increase_used_inner(size_t size);
+  void decrease_used_inner(size_t size);
   void increase_used(size_t size, bool relocation);
   void decrease_used(size_t size, bool reclaimed);
+  void increase_magazine_used(size_t size);
+  void decrease_magazine_used(size_t size);
+  size_t magazine_used() const;
 
   ZPage* create_page(uint8_t type, size_t size);
   void destroy_page(ZPage* page);
+  ZPage* alloc_committed(size_t size);
+  bool map_committed(ZPage* page);
+  bool place_page(ZPage* page, bool cold);
 
   size_t max_available(bool no_reserve) const;
   bool ensure_available(size_t size, bool no_reserve);
@@ -76,14 +108,34 @@ private:
 
   void check_out_of_memory_during_initialization();
 
-  ZPage* alloc_page_common_inner(uint8_t type, size_t size, bool no_reserve);
-  ZPage* alloc_page_common(uint8_t type, size_t size, ZAllocationFlags flags);
+  bool is_partition_limited(size_t size, ZAllocationFlags flags) const;
+  void increase_partition_used(ZPage* page, ZAllocationFlags flags);
+  void decrease_partition_used(const ZPage* page);
+
+  ZPage* alloc_merged_page(uint8_t type, size_t size, const ZPageCacheMerge* merge);
+  ZPage* alloc_page_common_inner(uint8_t type, size_t size, bool no_reserve, bool zeroed, ZPageCacheMerge* merge);
+  ZPage* alloc_page_common(uint8_t type, size_t size, ZAllocationFlags flags, bool partition_limit, ZPageCacheMerge* merge);
+  ZPage* alloc_page_merge(uint8_t type, size_t size, ZAllocationFlags flags);
+  void assist_relocation(ZPageAllocRequest* request) const;
+  ZPage* wait_alloc_request(ZPageAllocRequest* request);
   ZPage* alloc_page_blocking(uint8_t type, size_t size, ZAllocationFlags flags);
   ZPage* alloc_page_nonblocking(uint8_t type, size_t size, ZAllocationFlags flags);
 
-  size_t flush_cache(ZPageCacheFlushClosure* cl);
+  bool is_magazine_enabled(uint8_t type) const;
+  ZPage* alloc_page_from_magazine(uint8_t type, size_t size, ZAllocationFlags flags);
+  bool free_page_to_magazine(ZPage* page, bool reclaimed);
+  void refill_magazine();
+  size_t flush_magazines();
+
+  size_t flush_cache(ZPageCacheFlushClosure* cl, ZList<ZPage>* pages);
+  void destroy_pages(ZList<ZPage>* pages);
   void flush_cache_for_allocation(size_t requested);
 
+  void zero_page(const ZPage* page) const;
+
+  ZPageAllocRequest* first_alloc_request() const;
+  ZPageAllocRequest* smallest_alloc_request() const;
+  bool satisfy_alloc_request(ZPageAllocRequest* request, bool partition_limit);
   void satisfy_alloc_queue();
 
 public:
@@ -98,8 +150,13 @@ public:
   size_t min_capacity() const;
   size_t max_capacity() const;
   size_t soft_max_capacity() const;
+  bool is_soft_max_limited() const;
+  void set_soft_max_limit(size_t limit);
+  void set_director_threshold(size_t threshold);
   size_t capacity() const;
   size_t max_reserve() const;
+  void set_max_reserve(size_t size);
+  size_t max_reserve_used() const;
   size_t used_high() const;
   size_t used_low() const;
   size_t used() const;
@@ -111,8 +168,20 @@ public:
 
   ZPage* alloc_page(uint8_t type, size_t size, ZAllocationFlags flags);
   void free_page(ZPage* page, bool reclaimed);
+  void free_pages(ZArray<ZPage*>* pages, bool reclaimed);
 
-  uint64_t uncommit(uint64_t delay);
+  void notify_relocation_assist();
+
+  bool should_remap_page(const ZPage* page);
+  ZPage* remap_page(const ZPage* page);
+  void free_remapped_page(ZPage* page);
+
+  void sample_demand();
+
+  size_t commit_ahead(size_t headroom);
+  uint64_t uncommit(uint64_t delay, size_t limit);
+  size_t defragment();
+  size_t zero_pages(size_t target);
 
   void enable_deferred_delete() const;
   void disable_deferred_delete() const;
@@ -123,9 +192,13 @@ public:
   void debug_unmap_page(const ZPage* page) const;
 
   bool is_alloc_stalled() const;
+  bool is_alloc_stalled_through_gc() const;
   void check_out_of_memory();
 
   void pages_do(ZPageClosure* cl) const;
+
+  void cache_pages_do(ZPageClosure* cl);
+  void virtual_free_stats(size_t* nareas, size_t* size, size_t* largest);
 };
 
 #endif // SHARE_GC_Z_ZPAGEALLOCATOR_HPP
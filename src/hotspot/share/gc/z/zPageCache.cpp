@@ -27,13 +27,25 @@
 #include "gc/z/zPage.inline.hpp"
 #include "gc/z/zPageCache.hpp"
 #include "gc/z/zStat.hpp"
+#include "gc/z/zArray.inline.hpp"
 #include "gc/z/zValue.inline.hpp"
 #include "logging/log.hpp"
+#include "utilities/align.hpp"
+#include "utilities/quickSort.hpp"
 
 static const ZStatCounter ZCounterPageCacheHitL1("Memory", "Page Cache Hit L1", ZStatUnitOpsPerSecond);
 static const ZStatCounter ZCounterPageCacheHitL2("Memory", "Page Cache Hit L2", ZStatUnitOpsPerSecond);
 static const ZStatCounter ZCounterPageCacheHitL3("Memory", "Page Cache Hit L3", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterPageCacheHitZeroed("Memory", "Page Cache Hit Zeroed", ZStatUnitOpsPerSecond);
 static const ZStatCounter ZCounterPageCacheMiss("Memory", "Page Cache Miss", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterPageCacheHitSmall("Memory", "Page Cache Hit Small", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterPageCacheHitMedium("Memory", "Page Cache Hit Medium", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterPageCacheHitLarge("Memory", "Page Cache Hit Large", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterPageCacheMissSmall("Memory", "Page Cache Miss Small", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterPageCacheMissMedium("Memory", "Page Cache Miss Medium", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterPageCacheMissLarge("Memory", "Page Cache Miss Large", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterPageCacheSplit("Memory", "Page Cache Split", ZStatUnitOpsPerSecond);
+static const ZStatCounter ZCounterPageCacheMerge("Memory", "Page Cache Merge", ZStatUnitOpsPerSecond);
 
 ZPageCacheFlushClosure::ZPageCacheFlushClosure(size_t requested) :
     _requested(requested),
@@ -47,7 +59,8 @@ ZPageCache::ZPageCache() :
     _available(0),
     _small(),
     _medium(),
-    _large() {}
+    _large(),
+    _zeroed() {}
 
 ZPage* ZPageCache::alloc_small_page() {
   const uint32_t numa_id = ZNUMA::id();
@@ -80,6 +93,42 @@ ZPage* ZPageCache::alloc_small_page() {
   return NULL;
 }
 
+ZPage* ZPageCache::alloc_local_small_page() {
+  const uint32_t numa_id = ZNUMA::id();
+
+  // Only try NUMA local page cache, never split larger pages
+  ZPage* const page = _small.get(numa_id).remove_first();
+  if (page != NULL) {
+    ZStatInc(ZCounterPageCacheHitL1);
+    _available -= page->size();
+  }
+
+  return page;
+}
+
+ZPage* ZPageCache::alloc_page_for_zeroing(size_t max_size) {
+  assert(is_aligned(max_size, ZGranuleSize), "Invalid size");
+
+  // Prefer large pages, since they are the most expensive to clear
+  ZPage* page = _large.remove_first();
+  if (page == NULL) {
+    page = _medium.remove_first();
+    if (page == NULL) {
+      return NULL;
+    }
+  }
+
+  if (page->size() > max_size) {
+    // Split page, cache remainder
+    ZPage* const remainder = page;
+    page = remainder->split(max_size);
+    free_page_inner(remainder);
+  }
+
+  _available -= page->size();
+  return page;
+}
+
 ZPage* ZPageCache::alloc_medium_page() {
   ZPage* const page = _medium.remove_first();
   if (page != NULL) {
@@ -140,8 +189,50 @@ ZPage* ZPageCache::alloc_oversized_page(size_t size) {
   return page;
 }
 
-ZPage* ZPageCache::alloc_page(uint8_t type, size_t size) {
-  ZPage* page;
+ZPage* ZPageCache::alloc_zeroed_page(uint8_t type, size_t size) {
+  // Find a zeroed page that is large enough
+  ZListIterator<ZPage> iter(&_zeroed);
+  for (ZPage* page; iter.next(&page);) {
+    if (size < page->size()) {
+      // Split page, the remainder stays zeroed
+      ZStatInc(ZCounterPageCacheHitZeroed);
+      ZStatInc(ZCounterPageCacheSplit);
+      return page->split(type, size);
+    }
+
+    if (size == page->size()) {
+      // Page found
+      _zeroed.remove(page);
+      ZStatInc(ZCounterPageCacheHitZeroed);
+      return page->type() == type ? page : page->retype(type);
+    }
+  }
+
+  return NULL;
+}
+
+static void inc_hit_or_miss(uint8_t type, bool hit) {
+  if (type == ZPageTypeSmall) {
+    ZStatInc(hit ? ZCounterPageCacheHitSmall : ZCounterPageCacheMissSmall);
+  } else if (type == ZPageTypeMedium) {
+    ZStatInc(hit ? ZCounterPageCacheHitMedium : ZCounterPageCacheMissMedium);
+  } else {
+    ZStatInc(hit ? ZCounterPageCacheHitLarge : ZCounterPageCacheMissLarge);
+  }
+}
+
+ZPage* ZPageCache::alloc_page(uint8_t type, size_t size, bool zeroed) {
+  ZPage* page = NULL;
+
+  if (zeroed) {
+    // Try allocate zeroed page
+    page = alloc_zeroed_page(type, size);
+    if (page != NULL) {
+      _available -= page->size();
+      inc_hit_or_miss(type, true /* hit */);
+      return page;
+    }
+  }
 
   // Try allocate exact page
   if (type == ZPageTypeSmall) {
@@ -159,6 +250,7 @@ ZPage* ZPageCache::alloc_page(uint8_t type, size_t size) {
       if (size < oversized->size()) {
         // Split oversized page
         page = oversized->split(type, size);
+        ZStatInc(ZCounterPageCacheSplit);
 
         // Cache remainder
         free_page_inner(oversized);
@@ -169,18 +261,27 @@ ZPage* ZPageCache::alloc_page(uint8_t type, size_t size) {
     }
   }
 
+  if (page == NULL && !zeroed) {
+    // Try allocate zeroed page, as a last resort
+    page = alloc_zeroed_page(type, size);
+  }
+
   if (page != NULL) {
     _available -= page->size();
   } else {
     ZStatInc(ZCounterPageCacheMiss);
   }
 
+  inc_hit_or_miss(type, page != NULL);
+
   return page;
 }
 
 void ZPageCache::free_page_inner(ZPage* page) {
   const uint8_t type = page->type();
-  if (type == ZPageTypeSmall) {
+  if (page->is_zeroed()) {
+    _zeroed.insert_first(page);
+  } else if (type == ZPageTypeSmall) {
     _small.get(page->numa_id()).insert_first(page);
   } else if (type == ZPageTypeMedium) {
     _medium.insert_first(page);
@@ -189,7 +290,19 @@ void ZPageCache::free_page_inner(ZPage* page) {
   }
 }
 
+void ZPageCache::remove_page_inner(ZPage* page) {
+  const uint8_t type = page->type();
+  if (type == ZPageTypeSmall) {
+    _small.get(page->numa_id()).remove(page);
+  } else if (type == ZPageTypeMedium) {
+    _medium.remove(page);
+  } else {
+    _large.remove(page);
+  }
+}
+
 void ZPageCache::free_page(ZPage* page) {
+  page->release_live_map();
   free_page_inner(page);
   _available += page->size();
 }
@@ -234,11 +347,59 @@ void ZPageCache::flush_per_numa_lists(ZPageCacheFlushClosure* cl, ZPerNUMA<ZList
   }
 }
 
-void ZPageCache::flush(ZPageCacheFlushClosure* cl, ZList<ZPage>* to) {
-  // Prefer flushing large, then medium and last small pages
-  flush_list(cl, &_large, to);
-  flush_list(cl, &_medium, to);
-  flush_per_numa_lists(cl, &_small, to);
+void ZPageCache::flush_type(ZPageCacheFlushClosure* cl, uint8_t type, ZList<ZPage>* to) {
+  if (type == ZPageTypeSmall) {
+    flush_per_numa_lists(cl, &_small, to);
+  } else if (type == ZPageTypeMedium) {
+    flush_list(cl, &_medium, to);
+  } else {
+    flush_list(cl, &_large, to);
+  }
+}
+
+void ZPageCache::flush(ZPageCacheFlushClosure* cl, ZList<ZPage>* to, const ZPageDemand* demand) {
+  // Prefer flushing pages of the types with the lowest forecasted demand,
+  // since they are the least likely to be needed again soon. Types with
+  // the same demand are flushed large, then medium, then small. Zeroed
+  // pages are always flushed last.
+  uint8_t types[] = { ZPageTypeLarge, ZPageTypeMedium, ZPageTypeSmall };
+  for (size_t i = 1; i < ARRAY_SIZE(types); i++) {
+    for (size_t j = i; j > 0 && demand->forecast(types[j]) < demand->forecast(types[j - 1]); j--) {
+      swap(types[j], types[j - 1]);
+    }
+  }
+
+  for (size_t i = 0; i < ARRAY_SIZE(types); i++) {
+    flush_type(cl, types[i], to);
+  }
+
+  flush_list(cl, &_zeroed, to);
+}
+
+size_t ZPageCache::flush_fragmented_list(ZList<ZPage>* from, ZList<ZPage>* to, size_t limit) {
+  size_t flushed = 0;
+
+  ZListIterator<ZPage> iter(from);
+  for (ZPage* page; flushed < limit && iter.next(&page);) {
+    if (page->physical_memory().nsegments() > 1) {
+      // Flush page
+      flushed += page->size();
+      from->remove(page);
+      to->insert_last(page);
+    }
+  }
+
+  return flushed;
+}
+
+size_t ZPageCache::flush_fragmented(ZList<ZPage>* to, size_t limit) {
+  // Flush pages whose physical memory consists of more than one segment.
+  // Small pages always consist of a single segment, and zeroed pages are
+  // never flushed, since they would then lose their zeroed state.
+  size_t flushed = flush_fragmented_list(&_large, to, limit);
+  flushed += flush_fragmented_list(&_medium, to, limit - MIN2(flushed, limit));
+  _available -= flushed;
+  return flushed;
 }
 
 void ZPageCache::pages_do(ZPageClosure* cl) const {
@@ -262,4 +423,214 @@ void ZPageCache::pages_do(ZPageClosure* cl) const {
   for (ZPage* page; iter_large.next(&page);) {
     cl->do_page(page);
   }
+
+  // Zeroed
+  ZListIterator<ZPage> iter_zeroed(&_zeroed);
+  for (ZPage* page; iter_zeroed.next(&page);) {
+    cl->do_page(page);
+  }
+}
+
+ZPageCacheMerge::ZPageCacheMerge() :
+    _candidates(),
+    _size(0),
+    _collected(false),
+    _searched(false),
+    _first(0),
+    _end(0) {}
+
+int ZPageCacheMerge::compare_candidate_start(const ZCandidate& a, const ZCandidate& b) {
+  if (a._start < b._start) {
+    return -1;
+  } else if (a._start > b._start) {
+    return 1;
+  }
+
+  return 0;
+}
+
+bool ZPageCacheMerge::is_mergeable(const ZCandidate& a, const ZCandidate& b) {
+  // Same as ZPage::is_mergeable(), using the collected address ranges
+  return a._start + a._size == b._start &&
+         a._physical_end <= b._physical_start;
+}
+
+void ZPageCacheMerge::collect(size_t size) {
+  assert(!_collected, "Already collected");
+  _size = size;
+  _collected = true;
+}
+
+void ZPageCacheMerge::add(ZPage* page) {
+  const ZPhysicalMemory& pmem = page->physical_memory();
+
+  ZCandidate candidate;
+  candidate._page = page;
+  candidate._start = page->start();
+  candidate._size = page->size();
+  candidate._physical_start = pmem.segment(0).start();
+  candidate._physical_end = pmem.segment(pmem.nsegments() - 1).end();
+  _candidates.add(candidate);
+}
+
+bool ZPageCacheMerge::contains(const ZPage* page) const {
+  // Binary search the run, which is sorted by address
+  size_t low = _first;
+  size_t high = _end;
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    const ZCandidate* const candidate = _candidates.addr(mid);
+    if (candidate->_start < page->start()) {
+      low = mid + 1;
+    } else if (candidate->_start > page->start()) {
+      high = mid;
+    } else {
+      return candidate->_page == page && candidate->_size == page->size();
+    }
+  }
+
+  return false;
+}
+
+bool ZPageCacheMerge::is_collected() const {
+  return _collected;
+}
+
+bool ZPageCacheMerge::is_pending() const {
+  return _collected && !_searched;
+}
+
+void ZPageCacheMerge::search() {
+  assert(is_pending(), "Invalid state");
+  _searched = true;
+
+  if (_candidates.size() < 2) {
+    // Nothing to merge
+    return;
+  }
+
+  QuickSort::sort(_candidates.addr(0), _candidates.size(), compare_candidate_start, false /* idempotent */);
+
+  // Find the first run of mergeable pages that is large enough
+  size_t first = 0;
+  size_t run_size = _candidates.at(0)._size;
+  size_t end = 1;
+  for (; end < _candidates.size() && run_size < _size; end++) {
+    if (is_mergeable(_candidates.at(end - 1), _candidates.at(end))) {
+      run_size += _candidates.at(end)._size;
+    } else {
+      first = end;
+      run_size = _candidates.at(end)._size;
+    }
+  }
+
+  if (run_size < _size) {
+    // No run large enough
+    return;
+  }
+
+  _first = first;
+  _end = end;
+}
+
+size_t ZPageCacheMerge::run_length() const {
+  return _end - _first;
+}
+
+size_t ZPageCacheMerge::run_size() const {
+  size_t size = 0;
+  for (size_t i = _first; i < _end; i++) {
+    size += _candidates.at(i)._size;
+  }
+
+  return size;
+}
+
+bool ZPageCache::collect_mergeable_pages(size_t size, ZPageCacheMerge* merge) const {
+  merge->collect(size);
+
+  // Collect all mapped cached pages, except zeroed pages
+  for (uint32_t i = 0; i < ZNUMA::count(); i++) {
+    ZListIterator<ZPage> iter(_small.addr(i));
+    for (ZPage* page; iter.next(&page);) {
+      if (page->is_mapped()) {
+        merge->add(page);
+      }
+    }
+  }
+
+  ZListIterator<ZPage> iter_medium(&_medium);
+  for (ZPage* page; iter_medium.next(&page);) {
+    if (page->is_mapped()) {
+      merge->add(page);
+    }
+  }
+
+  ZListIterator<ZPage> iter_large(&_large);
+  for (ZPage* page; iter_large.next(&page);) {
+    if (page->is_mapped()) {
+      merge->add(page);
+    }
+  }
+
+  return merge->_candidates.size() >= 2;
+}
+
+bool ZPageCache::remove_mergeable_pages(const ZPageCacheMerge* merge, ZList<ZPage>* to) {
+  const size_t length = merge->run_length();
+  if (length == 0) {
+    // No run found
+    return false;
+  }
+
+  // The cache can have changed while the lock was released. Pages are
+  // only dereferenced once found in the cache, since pages that have
+  // left the cache can have been deleted.
+  ZArray<ZPage*> pages;
+  for (uint32_t i = 0; i < ZNUMA::count(); i++) {
+    ZListIterator<ZPage> iter(_small.addr(i));
+    for (ZPage* page; iter.next(&page);) {
+      if (merge->contains(page)) {
+        pages.add(page);
+      }
+    }
+  }
+
+  ZListIterator<ZPage> iter_medium(&_medium);
+  for (ZPage* page; iter_medium.next(&page);) {
+    if (merge->contains(page)) {
+      pages.add(page);
+    }
+  }
+
+  ZListIterator<ZPage> iter_large(&_large);
+  for (ZPage* page; iter_large.next(&page);) {
+    if (merge->contains(page)) {
+      pages.add(page);
+    }
+  }
+
+  if (pages.size() != length) {
+    // Some pages of the run are no longer cached
+    return false;
+  }
+
+  for (size_t i = merge->_first + 1; i < merge->_end; i++) {
+    if (!merge->_candidates.at(i - 1)._page->is_mergeable(merge->_candidates.at(i)._page)) {
+      // No longer mergeable
+      return false;
+    }
+  }
+
+  // Remove the pages of the run, in address order
+  for (size_t i = merge->_first; i < merge->_end; i++) {
+    ZPage* const page = merge->_candidates.at(i)._page;
+    remove_page_inner(page);
+    to->insert_last(page);
+    _available -= page->size();
+  }
+
+  ZStatInc(ZCounterPageCacheMerge);
+
+  return true;
 }
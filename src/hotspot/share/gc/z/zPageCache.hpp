@@ -24,8 +24,10 @@
 #ifndef SHARE_GC_Z_ZPAGECACHE_HPP
 #define SHARE_GC_Z_ZPAGECACHE_HPP
 
+#include "gc/z/zArray.hpp"
 #include "gc/z/zList.hpp"
 #include "gc/z/zPage.hpp"
+#include "gc/z/zPageDemand.hpp"
 #include "gc/z/zValue.hpp"
 #include "memory/allocation.hpp"
 
@@ -40,12 +42,61 @@ public:
   virtual bool do_page(const ZPage* page) = 0;
 };
 
+// Merging cached pages into a larger page needs the cached pages in
+// address order, and sorting them can take a while when many pages are
+// cached. The address ranges of the cached pages are therefore collected
+// with the page allocator lock held, but sorted and searched for a run
+// of mergeable pages with the lock released. The run is only removed
+// from the cache, once the lock has been taken again, if all its pages
+// are still cached with the same address ranges.
+class ZPageCacheMerge : public StackObj {
+  friend class ZPageCache;
+  friend class ZPageCacheMergeTest;
+
+private:
+  struct ZCandidate {
+    ZPage*    _page;
+    uintptr_t _start;
+    size_t    _size;
+    uintptr_t _physical_start;
+    uintptr_t _physical_end;
+  };
+
+  ZArray<ZCandidate> _candidates;
+  size_t             _size;
+  bool               _collected;
+  bool               _searched;
+  size_t             _first;
+  size_t             _end;
+
+  static int compare_candidate_start(const ZCandidate& a, const ZCandidate& b);
+  static bool is_mergeable(const ZCandidate& a, const ZCandidate& b);
+
+  void collect(size_t size);
+  void add(ZPage* page);
+  bool contains(const ZPage* page) const;
+
+public:
+  ZPageCacheMerge();
+
+  bool is_collected() const;
+  bool is_pending() const;
+
+  // Sort the collected pages and find the first run of
+  // mergeable pages of at least the requested size
+  void search();
+
+  size_t run_length() const;
+  size_t run_size() const;
+};
+
 class ZPageCache {
 private:
   size_t                  _available;
   ZPerNUMA<ZList<ZPage> > _small;
   ZList<ZPage>            _medium;
   ZList<ZPage>            _large;
+  ZList<ZPage>            _zeroed;
 
   ZPage* alloc_small_page();
   ZPage* alloc_medium_page();
@@ -54,22 +105,36 @@ private:
   ZPage* alloc_oversized_medium_page(size_t size);
   ZPage* alloc_oversized_large_page(size_t size);
   ZPage* alloc_oversized_page(size_t size);
+  ZPage* alloc_zeroed_page(uint8_t type, size_t size);
 
   void free_page_inner(ZPage* page);
+  void remove_page_inner(ZPage* page);
 
   bool flush_list_inner(ZPageCacheFlushClosure* cl, ZList<ZPage>* from, ZList<ZPage>* to);
   void flush_list(ZPageCacheFlushClosure* cl, ZList<ZPage>* from, ZList<ZPage>* to);
   void flush_per_numa_lists(ZPageCacheFlushClosure* cl, ZPerNUMA<ZList<ZPage> >* from, ZList<ZPage>* to);
+  void flush_type(ZPageCacheFlushClosure* cl, uint8_t type, ZList<ZPage>* to);
+  size_t flush_fragmented_list(ZList<ZPage>* from, ZList<ZPage>* to, size_t limit);
 
 public:
   ZPageCache();
 
   size_t available() const;
+  size_t zeroed_available() const;
 
-  ZPage* alloc_page(uint8_t type, size_t size);
+  ZPage* alloc_page(uint8_t type, size_t size, bool zeroed);
+  ZPage* alloc_local_small_page();
+  ZPage* alloc_page_for_zeroing(size_t max_size);
   void free_page(ZPage* page);
 
-  void flush(ZPageCacheFlushClosure* cl, ZList<ZPage>* to);
+  void flush(ZPageCacheFlushClosure* cl, ZList<ZPage>* to, const ZPageDemand* demand);
+  size_t flush_fragmented(ZList<ZPage>* to, size_t limit);
+
+  // Collect the cached pages that could be merged into a page of the
+  // given size, and remove the run of pages found by searching them,
+  // in address order
+  bool collect_mergeable_pages(size_t size, ZPageCacheMerge* merge) const;
+  bool remove_mergeable_pages(const ZPageCacheMerge* merge, ZList<ZPage>* to);
 
   void pages_do(ZPageClosure* cl) const;
 };
@@ -25,6 +25,7 @@
 #define SHARE_GC_Z_ZPAGECACHE_INLINE_HPP
 
 #include "gc/z/zList.inline.hpp"
+#include "gc/z/zPage.inline.hpp"
 #include "gc/z/zPageCache.hpp"
 #include "gc/z/zValue.inline.hpp"
 
@@ -32,4 +33,15 @@ inline size_t ZPageCache::available() const {
   return _available;
 }
 
+inline size_t ZPageCache::zeroed_available() const {
+  size_t available = 0;
+
+  ZListIterator<ZPage> iter(&_zeroed);
+  for (ZPage* page; iter.next(&page);) {
+    available += page->size();
+  }
+
+  return available;
+}
+
 #endif // SHARE_GC_Z_ZPAGECACHE_INLINE_HPP
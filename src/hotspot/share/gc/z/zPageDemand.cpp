@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zPageDemand.hpp"
+#include "gc/z/zValue.inline.hpp"
+#include "logging/log.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
+
+ZPageDemand::ZPageDemand() :
+    _last_sample(os::elapsedTime()) {
+  for (uint8_t type = 0; type < ntypes; type++) {
+    _allocated[type].set_all(0);
+    _sampled[type] = 0;
+    _forecast[type] = 0;
+  }
+}
+
+size_t ZPageDemand::allocated(uint8_t type) const {
+  size_t allocated = 0;
+  ZPerCPUConstIterator<size_t> iter(&_allocated[type]);
+  for (const size_t* cpu_allocated; iter.next(&cpu_allocated);) {
+    allocated += Atomic::load(cpu_allocated);
+  }
+  return allocated;
+}
+
+void ZPageDemand::increase(uint8_t type, size_t size) {
+  Atomic::add(_allocated[type].addr(), size);
+}
+
+void ZPageDemand::sample() {
+  const double now = os::elapsedTime();
+  const double elapsed = now - _last_sample;
+  if (elapsed <= 0.0) {
+    return;
+  }
+
+  _last_sample = now;
+
+  for (uint8_t type = 0; type < ntypes; type++) {
+    const size_t allocated = this->allocated(type);
+    _rate[type].add((allocated - _sampled[type]) / elapsed);
+    _sampled[type] = allocated;
+
+    // Forecast one standard deviation above the decaying average,
+    // to keep enough pages cached for bursts of allocations.
+    const double forecast = _rate[type].davg() + _rate[type].dsd();
+    Atomic::store(&_forecast[type], (size_t)forecast);
+  }
+
+  log_trace(gc, heap)("Page Demand: Small: " SIZE_FORMAT "M/s, Medium: " SIZE_FORMAT "M/s, Large: " SIZE_FORMAT "M/s",
+                      forecast(ZPageTypeSmall) / M, forecast(ZPageTypeMedium) / M, forecast(ZPageTypeLarge) / M);
+}
+
+size_t ZPageDemand::forecast(uint8_t type) const {
+  return Atomic::load(&_forecast[type]);
+}
+
+size_t ZPageDemand::forecast_total(double seconds) const {
+  size_t total = 0;
+  for (uint8_t type = 0; type < ntypes; type++) {
+    total += forecast(type);
+  }
+  return total * seconds;
+}
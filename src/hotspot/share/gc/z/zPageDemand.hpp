@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZPAGEDEMAND_HPP
+#define SHARE_GC_Z_ZPAGEDEMAND_HPP
+
+#include "gc/z/zGlobals.hpp"
+#include "gc/z/zValue.hpp"
+#include "utilities/numberSeq.hpp"
+
+//
+// Tracks the rate at which pages of each type are allocated, to forecast
+// the near-term demand for cached pages. Allocations are counted per CPU,
+// and the rates are sampled periodically by the director.
+//
+class ZPageDemand {
+private:
+  static const uint8_t ntypes = ZPageTypeLarge + 1;
+
+  ZPerCPU<size_t> _allocated[ntypes];
+  size_t          _sampled[ntypes];
+  TruncatedSeq    _rate[ntypes];      // B/s
+  volatile size_t _forecast[ntypes];  // B/s
+  double          _last_sample;
+
+  size_t allocated(uint8_t type) const;
+
+public:
+  ZPageDemand();
+
+  void increase(uint8_t type, size_t size);
+  void sample();
+
+  // Forecasted bytes per second allocated in pages of the given type
+  size_t forecast(uint8_t type) const;
+
+  // Forecasted bytes allocated in pages of any type during the given time
+  size_t forecast_total(double seconds) const;
+};
+
+#endif // SHARE_GC_Z_ZPAGEDEMAND_HPP
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zAddress.inline.hpp"
+#include "gc/z/zPage.inline.hpp"
+#include "gc/z/zPageHotness.hpp"
+#include "logging/log.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/os.hpp"
+#include "utilities/align.hpp"
+
+// Maximum number of frames sampled per page
+static const size_t ZPageHotnessSamples = 8;
+
+bool ZPageHotness::_enabled;
+
+void ZPageHotness::initialize() {
+  if (ZPageHotnessInterval == 0) {
+    // Disabled
+    return;
+  }
+
+  _enabled = initialize_platform();
+
+  log_info(gc, init)("Page Hotness Sampling: %s", _enabled ? "Enabled" : "Disabled (Idle page tracking not available)");
+}
+
+bool ZPageHotness::is_enabled() {
+  return _enabled;
+}
+
+void ZPageHotness::sample(ZPage* page) {
+  // Sample a few frames, evenly spread over the allocated part of the
+  // page. The frames are marked idle again when sampled, so the next
+  // sample tells if they have been accessed since. Any view will do,
+  // since all views map the same physical memory.
+  const size_t frame_size = os::vm_page_size();
+  const size_t size = align_up(page->top() - page->start(), frame_size);
+  if (size == 0) {
+    // Nothing allocated
+    return;
+  }
+
+  const uintptr_t start = ZAddress::good(page->start());
+  const size_t nframes = size / frame_size;
+  const size_t nsamples = MIN2(nframes, ZPageHotnessSamples);
+  const size_t stride = (nframes / nsamples) * frame_size;
+
+  size_t nsampled = 0;
+  size_t naccessed = 0;
+
+  for (size_t i = 0; i < nsamples; i++) {
+    bool accessed;
+    if (test_and_clear_accessed(start + i * stride, &accessed)) {
+      nsampled++;
+      if (accessed) {
+        naccessed++;
+      }
+    }
+  }
+
+  if (nsampled > 0) {
+    page->set_hotness((uint8_t)percent_of(naccessed, nsampled));
+  }
+}
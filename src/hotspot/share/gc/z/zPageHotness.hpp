@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZPAGEHOTNESS_HPP
+#define SHARE_GC_Z_ZPAGEHOTNESS_HPP
+
+#include "memory/allocation.hpp"
+
+class ZPage;
+
+class ZPageHotness : public AllStatic {
+private:
+  static bool _enabled;
+
+  static bool initialize_platform();
+
+  // Tells if the small frame mapped at the given address was accessed
+  // since it was last marked idle, and marks it idle again. Returns
+  // false if the frame is not backed by memory, or not trackable.
+  static bool test_and_clear_accessed(uintptr_t addr, bool* accessed);
+
+public:
+  static void initialize();
+  static bool is_enabled();
+
+  static void sample(ZPage* page);
+};
+
+#endif // SHARE_GC_Z_ZPAGEHOTNESS_HPP
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZPAGEMAGAZINE_HPP
+#define SHARE_GC_Z_ZPAGEMAGAZINE_HPP
+
+#include "memory/allocation.hpp"
+
+class ZPage;
+class ZPageClosure;
+
+//
+// A page magazine holds a small number of free pages, which can be
+// claimed and returned without taking the page allocator lock. Claiming
+// or returning a page is a single CAS on one of the slots, which transfers
+// ownership of the page.
+//
+class ZPageMagazine {
+public:
+  static const size_t max_size = 16;
+
+private:
+  ZPage* volatile _pages[max_size];
+
+public:
+  ZPageMagazine();
+
+  bool is_full(size_t size) const;
+
+  ZPage* alloc(size_t size);
+  bool free(ZPage* page, size_t size);
+
+  void pages_do(ZPageClosure* cl) const;
+};
+
+#endif // SHARE_GC_Z_ZPAGEMAGAZINE_HPP
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZPAGEMAGAZINE_INLINE_HPP
+#define SHARE_GC_Z_ZPAGEMAGAZINE_INLINE_HPP
+
+#include "gc/z/zPage.hpp"
+#include "gc/z/zPageMagazine.hpp"
+#include "runtime/atomic.hpp"
+#include "utilities/debug.hpp"
+
+inline ZPageMagazine::ZPageMagazine() {
+  for (size_t i = 0; i < max_size; i++) {
+    _pages[i] = NULL;
+  }
+}
+
+inline bool ZPageMagazine::is_full(size_t size) const {
+  assert(size <= max_size, "Invalid size");
+
+  for (size_t i = 0; i < size; i++) {
+    if (Atomic::load(_pages + i) == NULL) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+inline ZPage* ZPageMagazine::alloc(size_t size) {
+  assert(size <= max_size, "Invalid size");
+
+  for (size_t i = 0; i < size; i++) {
+    ZPage* const page = Atomic::load(_pages + i);
+    if (page != NULL && Atomic::cmpxchg(_pages + i, page, (ZPage*)NULL) == page) {
+      // Claimed page
+      return page;
+    }
+  }
+
+  // Empty
+  return NULL;
+}
+
+inline bool ZPageMagazine::free(ZPage* page, size_t size) {
+  assert(size <= max_size, "Invalid size");
+
+  for (size_t i = 0; i < size; i++) {
+    if (Atomic::load(_pages + i) == NULL && Atomic::cmpxchg(_pages + i, (ZPage*)NULL, page) == NULL) {
+      // Returned page
+      return true;
+    }
+  }
+
+  // Full
+  return false;
+}
+
+inline void ZPageMagazine::pages_do(ZPageClosure* cl) const {
+  for (size_t i = 0; i < max_size; i++) {
+    const ZPage* const page = Atomic::load(_pages + i);
+    if (page != NULL) {
+      cl->do_page(page);
+    }
+  }
+}
+
+#endif // SHARE_GC_Z_ZPAGEMAGAZINE_INLINE_HPP
@@ -32,6 +32,7 @@ class ZPage;
 class ZPageTable {
   friend class VMStructs;
   friend class ZPageTableIterator;
+  friend class ZPageTableParallelIterator;
 
 private:
   ZGranuleMap<ZPage*> _map;
@@ -56,4 +57,14 @@ public:
   bool next(ZPage** page);
 };
 
+class ZPageTableParallelIterator : public StackObj {
+private:
+  ZGranuleMapParallelIterator<ZPage*> _iter;
+
+public:
+  ZPageTableParallelIterator(const ZPageTable* page_table);
+
+  template <typename Closure> void pages_do(Closure* cl);
+};
+
 #endif // SHARE_GC_Z_ZPAGETABLE_HPP
@@ -26,6 +26,7 @@
 
 #include "gc/z/zAddress.inline.hpp"
 #include "gc/z/zGranuleMap.inline.hpp"
+#include "gc/z/zPage.inline.hpp"
 #include "gc/z/zPageTable.hpp"
 
 inline ZPage* ZPageTable::get(uintptr_t addr) const {
@@ -50,4 +51,21 @@ inline bool ZPageTableIterator::next(ZPage** page) {
   return false;
 }
 
+inline ZPageTableParallelIterator::ZPageTableParallelIterator(const ZPageTable* page_table) :
+    _iter(&page_table->_map) {}
+
+template <typename Closure>
+inline void ZPageTableParallelIterator::pages_do(Closure* cl) {
+  for (size_t start, end; _iter.next_chunk(&start, &end);) {
+    for (size_t index = start; index < end; index++) {
+      ZPage* const page = _iter.at(index);
+      // A page spanning multiple granules, and therefore possibly multiple
+      // chunks, is only visited through the entry for its first granule
+      if (page != NULL && (page->start() >> ZGranuleSizeShift) == index) {
+        cl->do_page(page);
+      }
+    }
+  }
+}
+
 #endif // SHARE_GC_Z_ZPAGETABLE_INLINE_HPP
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zPartition.hpp"
+#include "gc/z/zThreadLocalData.hpp"
+#include "logging/log.hpp"
+#include "memory/resourceArea.hpp"
+#include "runtime/arguments.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/java.hpp"
+#include "runtime/thread.hpp"
+#include "utilities/formatBuffer.hpp"
+
+ZPartition::ZPartition() :
+    _prefix(NULL),
+    _soft_max_capacity(SIZE_MAX),
+    _used(0) {}
+
+const char* ZPartition::prefix() const {
+  return _prefix;
+}
+
+size_t ZPartition::soft_max_capacity() const {
+  return _soft_max_capacity;
+}
+
+size_t ZPartition::used() const {
+  return Atomic::load(&_used);
+}
+
+void ZPartition::increase_used(size_t size) {
+  Atomic::add(&_used, size);
+}
+
+void ZPartition::decrease_used(size_t size) {
+  Atomic::sub(&_used, size);
+}
+
+bool ZPartition::would_exceed_soft_max_capacity(size_t size) const {
+  return used() + size > _soft_max_capacity;
+}
+
+ZPartition ZPartitions::_partitions[ZPartitionsMax];
+uint8_t    ZPartitions::_count = 1;
+
+bool ZPartitions::parse(const char* str) {
+  // Parse a list of thread name prefixes and soft max
+  // capacities, such as "tenant-a-:1G,tenant-b-:512M"
+  for (const char* p = str;;) {
+    const char* const colon = strchr(p, ':');
+    if (colon == NULL || colon == p || _count == ZPartitionsMax) {
+      return false;
+    }
+
+    const char* end = strchr(colon, ',');
+    if (end == NULL) {
+      end = colon + strlen(colon);
+    }
+
+    char size_str[32];
+    const size_t size_len = end - colon - 1;
+    if (size_len == 0 || size_len >= sizeof(size_str)) {
+      return false;
+    }
+
+    strncpy(size_str, colon + 1, size_len);
+    size_str[size_len] = '\0';
+
+    julong size;
+    if (!Arguments::atojulong(size_str, &size) || size == 0) {
+      return false;
+    }
+
+    const size_t prefix_len = colon - p;
+    ZPartition* const partition = &_partitions[_count++];
+    partition->_prefix = NEW_C_HEAP_ARRAY(char, prefix_len + 1, mtGC);
+    strncpy(partition->_prefix, p, prefix_len);
+    partition->_prefix[prefix_len] = '\0';
+    partition->_soft_max_capacity = (size_t)size;
+
+    if (*end == '\0') {
+      // End of list
+      return true;
+    }
+
+    p = end + 1;
+  }
+}
+
+void ZPartitions::initialize() {
+  if (ZAllocationPartitions == NULL) {
+    // Not configured
+    return;
+  }
+
+  if (!parse(ZAllocationPartitions)) {
+    vm_exit_during_initialization(err_msg("Invalid allocation partitions specified (ZAllocationPartitions=%s)",
+                                          ZAllocationPartitions));
+  }
+
+  for (uint8_t id = ZPartitionDefault + 1; id < _count; id++) {
+    log_info(gc, init)("Allocation Partition: %s* (Soft Max Capacity: " SIZE_FORMAT "M)",
+                       _partitions[id].prefix(), _partitions[id].soft_max_capacity() / M);
+  }
+}
+
+bool ZPartitions::is_enabled() {
+  return _count > 1;
+}
+
+uint8_t ZPartitions::count() {
+  return _count;
+}
+
+ZPartition* ZPartitions::get(uint8_t id) {
+  assert(id < _count, "Invalid partition");
+  return &_partitions[id];
+}
+
+bool ZPartitions::resolve(Thread* thread, uint8_t* id) {
+  *id = ZPartitionDefault;
+
+  if (!thread->is_Java_thread()) {
+    // GC and other VM threads use the default partition
+    return true;
+  }
+
+  JavaThread* const jt = (JavaThread*)thread;
+  if (jt->threadObj() == NULL) {
+    // Attaching thread without a name yet, resolve again later
+    return false;
+  }
+
+  ResourceMark rm(thread);
+  const char* const name = jt->get_thread_name();
+
+  // The first matching prefix wins
+  for (uint8_t i = ZPartitionDefault + 1; i < _count; i++) {
+    const char* const prefix = _partitions[i].prefix();
+    if (strncmp(name, prefix, strlen(prefix)) == 0) {
+      *id = i;
+      break;
+    }
+  }
+
+  return true;
+}
+
+uint8_t ZPartitions::current() {
+  if (!is_enabled()) {
+    return ZPartitionDefault;
+  }
+
+  Thread* const thread = Thread::current();
+  uint8_t id = ZThreadLocalData::partition(thread);
+  if (id == ZPartitionUnresolved && resolve(thread, &id)) {
+    ZThreadLocalData::set_partition(thread, id);
+  }
+
+  return id;
+}
+
+void ZPartitions::print() {
+  if (!is_enabled()) {
+    return;
+  }
+
+  for (uint8_t id = ZPartitionDefault; id < _count; id++) {
+    const ZPartition* const partition = &_partitions[id];
+    if (id == ZPartitionDefault) {
+      log_info(gc, heap)("Allocation Partition: (default) Used: " SIZE_FORMAT "M",
+                         partition->used() / M);
+    } else {
+      log_info(gc, heap)("Allocation Partition: %s* Used: " SIZE_FORMAT "M, Soft Max Capacity: " SIZE_FORMAT "M",
+                         partition->prefix(), partition->used() / M, partition->soft_max_capacity() / M);
+    }
+  }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZPARTITION_HPP
+#define SHARE_GC_Z_ZPARTITION_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class Thread;
+
+const uint8_t ZPartitionDefault    = 0;
+const uint8_t ZPartitionsMax       = 8;
+const uint8_t ZPartitionUnresolved = (uint8_t)-1;
+
+class ZPartition {
+  friend class ZPartitions;
+
+private:
+  char*           _prefix;
+  size_t          _soft_max_capacity;
+  volatile size_t _used;
+
+public:
+  ZPartition();
+
+  const char* prefix() const;
+  size_t soft_max_capacity() const;
+  size_t used() const;
+
+  void increase_used(size_t size);
+  void decrease_used(size_t size);
+
+  bool would_exceed_soft_max_capacity(size_t size) const;
+};
+
+//
+// Allocation partitions divide the heap between groups of Java threads,
+// such as the threads of different tenants, selected by thread name
+// prefix. Each partition has its own soft max capacity. Once the heap
+// as a whole is over its soft max capacity, page allocations that would
+// take a partition over its own soft max capacity stall, while other
+// partitions can continue to allocate. If the partition is still over
+// its soft max capacity after a GC cycle, the stalled allocations are
+// allowed beyond it, and only fail once the heap itself is out of memory.
+// Threads that match no prefix belong to the default partition, which is
+// not limited.
+//
+class ZPartitions : public AllStatic {
+private:
+  static ZPartition _partitions[ZPartitionsMax];
+  static uint8_t    _count;
+
+  static bool parse(const char* str);
+  static bool resolve(Thread* thread, uint8_t* id);
+
+public:
+  static void initialize();
+  static bool is_enabled();
+
+  static uint8_t count();
+  static ZPartition* get(uint8_t id);
+
+  // Partition of the current thread. The partition is resolved from the
+  // thread name the first time the thread allocates, so renaming the
+  // thread later does not move it to another partition.
+  static uint8_t current();
+
+  static void print();
+};
+
+#endif // SHARE_GC_Z_ZPARTITION_HPP
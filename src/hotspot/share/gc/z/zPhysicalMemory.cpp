@@ -23,11 +23,21 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zPhysicalMemory.inline.hpp"
+#include "gc/z/zProbes.hpp"
+#include "gc/z/zStat.hpp"
 #include "logging/log.hpp"
 #include "memory/allocation.inline.hpp"
 #include "services/memTracker.hpp"
 #include "utilities/debug.hpp"
 #include "utilities/globalDefinitions.hpp"
+#include "utilities/ticks.hpp"
+
+static const ZStatHistogram ZHistogramCommit("Latency", "Commit");
+static const ZStatHistogram ZHistogramUncommit("Latency", "Uncommit");
+static const ZStatCounter   ZCounterCommitOperation("Memory", "Commit Operation", ZStatUnitOpsPerSecond);
+static const ZStatCounter   ZCounterUncommitOperation("Memory", "Uncommit Operation", ZStatUnitOpsPerSecond);
+static const ZStatCounter   ZCounterMapOperation("Memory", "Map Operation", ZStatUnitOpsPerSecond);
+static const ZStatCounter   ZCounterUnmapOperation("Memory", "Unmap Operation", ZStatUnitOpsPerSecond);
 
 ZPhysicalMemory::ZPhysicalMemory() :
     _nsegments(0),
@@ -80,26 +90,53 @@ size_t ZPhysicalMemory::size() const {
 }
 
 void ZPhysicalMemory::add_segment(const ZPhysicalMemorySegment& segment) {
-  // Try merge with last segment
-  if (_nsegments > 0) {
-    ZPhysicalMemorySegment& last = _segments[_nsegments - 1];
-    assert(last.end() <= segment.start(), "Segments added out of order");
-    if (last.end() == segment.start()) {
-      last = ZPhysicalMemorySegment(last.start(), last.size() + segment.size());
-      return;
+  // Segments are kept sorted by start offset. They are typically added
+  // in order, so search for the insert position from the back.
+  size_t index = _nsegments;
+  while (index > 0 && _segments[index - 1].start() > segment.start()) {
+    index--;
+  }
+
+  assert(index == 0 || _segments[index - 1].end() <= segment.start(), "Overlapping segments");
+  assert(index == _nsegments || segment.end() <= _segments[index].start(), "Overlapping segments");
+
+  // Try merge with previous segment
+  if (index > 0 && _segments[index - 1].end() == segment.start()) {
+    ZPhysicalMemorySegment& prev = _segments[index - 1];
+    prev = ZPhysicalMemorySegment(prev.start(), prev.size() + segment.size());
+
+    // Try merge with next segment
+    if (index < _nsegments && prev.end() == _segments[index].start()) {
+      prev = ZPhysicalMemorySegment(prev.start(), prev.size() + _segments[index].size());
+      for (size_t i = index + 1; i < _nsegments; i++) {
+        _segments[i - 1] = _segments[i];
+      }
+      _nsegments--;
     }
+
+    return;
+  }
+
+  // Try merge with next segment
+  if (index < _nsegments && segment.end() == _segments[index].start()) {
+    ZPhysicalMemorySegment& next = _segments[index];
+    next = ZPhysicalMemorySegment(segment.start(), segment.size() + next.size());
+    return;
   }
 
   // Resize array
   ZPhysicalMemorySegment* const old_segments = _segments;
   _segments = new ZPhysicalMemorySegment[_nsegments + 1];
-  for (size_t i = 0; i < _nsegments; i++) {
+  for (size_t i = 0; i < index; i++) {
     _segments[i] = old_segments[i];
   }
+  for (size_t i = index; i < _nsegments; i++) {
+    _segments[i + 1] = old_segments[i];
+  }
   delete [] old_segments;
 
   // Add new segment
-  _segments[_nsegments] = segment;
+  _segments[index] = segment;
   _nsegments++;
 }
 
@@ -158,15 +195,25 @@ void ZPhysicalMemoryManager::nmt_uncommit(const ZPhysicalMemory& pmem, uintptr_t
 }
 
 size_t ZPhysicalMemoryManager::commit(size_t size) {
-  return _backing.commit(size);
+  const Ticks start = Ticks::now();
+  const size_t committed = _backing.commit(size);
+  ZStatSample(ZHistogramCommit, (Ticks::now() - start).value());
+  ZStatInc(ZCounterCommitOperation);
+  HOTSPOT_ZGC_PAGE_COMMIT(committed);
+  return committed;
 }
 
 size_t ZPhysicalMemoryManager::uncommit(size_t size) {
-  return _backing.uncommit(size);
+  const Ticks start = Ticks::now();
+  const size_t uncommitted = _backing.uncommit(size);
+  ZStatSample(ZHistogramUncommit, (Ticks::now() - start).value());
+  ZStatInc(ZCounterUncommitOperation);
+  HOTSPOT_ZGC_PAGE_UNCOMMIT(uncommitted);
+  return uncommitted;
 }
 
-ZPhysicalMemory ZPhysicalMemoryManager::alloc(size_t size) {
-  return _backing.alloc(size);
+ZPhysicalMemory ZPhysicalMemoryManager::alloc(size_t size, bool* zeroed) {
+  return _backing.alloc(size, zeroed);
 }
 
 void ZPhysicalMemoryManager::free(const ZPhysicalMemory& pmem) {
@@ -177,14 +224,32 @@ void ZPhysicalMemoryManager::pretouch(uintptr_t offset, size_t size) const {
   _backing.pretouch(offset, size);
 }
 
+bool ZPhysicalMemoryManager::collapse(uintptr_t offset, size_t size) const {
+  return _backing.collapse(offset, size);
+}
+
+size_t ZPhysicalMemoryManager::huge_page_coverage() const {
+  return _backing.huge_page_coverage();
+}
+
+bool ZPhysicalMemoryManager::recommit(const ZPhysicalMemory& pmem) {
+  return _backing.recommit(pmem);
+}
+
+bool ZPhysicalMemoryManager::refill(const ZPhysicalMemory& pmem) {
+  return _backing.refill(pmem);
+}
+
 void ZPhysicalMemoryManager::map(const ZPhysicalMemory& pmem, uintptr_t offset) const {
   _backing.map(pmem, offset);
   nmt_commit(pmem, offset);
+  ZStatInc(ZCounterMapOperation);
 }
 
 void ZPhysicalMemoryManager::unmap(const ZPhysicalMemory& pmem, uintptr_t offset) const {
   nmt_uncommit(pmem, offset);
   _backing.unmap(pmem, offset);
+  ZStatInc(ZCounterUnmapOperation);
 }
 
 void ZPhysicalMemoryManager::debug_map(const ZPhysicalMemory& pmem, uintptr_t offset) const {
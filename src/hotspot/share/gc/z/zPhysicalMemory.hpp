@@ -79,11 +79,17 @@ public:
   size_t commit(size_t size);
   size_t uncommit(size_t size);
 
-  ZPhysicalMemory alloc(size_t size);
+  ZPhysicalMemory alloc(size_t size, bool* zeroed);
   void free(const ZPhysicalMemory& pmem);
 
   void pretouch(uintptr_t offset, size_t size) const;
 
+  bool collapse(uintptr_t offset, size_t size) const;
+  size_t huge_page_coverage() const;
+
+  bool recommit(const ZPhysicalMemory& pmem);
+  bool refill(const ZPhysicalMemory& pmem);
+
   void map(const ZPhysicalMemory& pmem, uintptr_t offset) const;
   void unmap(const ZPhysicalMemory& pmem, uintptr_t offset) const;
 
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZPROBES_HPP
+#define SHARE_GC_Z_ZPROBES_HPP
+
+// USDT probes for ZGC, in the hotspot provider. The probes are defined
+// directly with the SystemTap <sys/sdt.h> macros, which don't need to be
+// declared in the provider description, and are therefore only available
+// on Linux. A probe site compiles to a single nop instruction, which is
+// only patched when a tracer attaches to the probe.
+//
+// hotspot:zgc__phase__start(const char* name)
+// hotspot:zgc__phase__end(const char* name, uint64_t duration_ns)
+// hotspot:zgc__alloc__stall__start(uint8_t type, size_t size)
+// hotspot:zgc__alloc__stall__end(uint8_t type, size_t size, uint64_t duration_ns)
+// hotspot:zgc__page__commit(size_t size)
+// hotspot:zgc__page__uncommit(size_t size)
+// hotspot:zgc__relocate__pin(uintptr_t page_start)
+
+#if defined(DTRACE_ENABLED) && defined(LINUX)
+
+#include <sys/sdt.h>
+
+#define HOTSPOT_ZGC_PHASE_START(name)                          DTRACE_PROBE1(hotspot, zgc__phase__start, name)
+#define HOTSPOT_ZGC_PHASE_END(name, duration_ns)               DTRACE_PROBE2(hotspot, zgc__phase__end, name, duration_ns)
+#define HOTSPOT_ZGC_ALLOC_STALL_START(type, size)              DTRACE_PROBE2(hotspot, zgc__alloc__stall__start, type, size)
+#define HOTSPOT_ZGC_ALLOC_STALL_END(type, size, duration_ns)   DTRACE_PROBE3(hotspot, zgc__alloc__stall__end, type, size, duration_ns)
+#define HOTSPOT_ZGC_PAGE_COMMIT(size)                          DTRACE_PROBE1(hotspot, zgc__page__commit, size)
+#define HOTSPOT_ZGC_PAGE_UNCOMMIT(size)                        DTRACE_PROBE1(hotspot, zgc__page__uncommit, size)
+#define HOTSPOT_ZGC_RELOCATE_PIN(page_start)                   DTRACE_PROBE1(hotspot, zgc__relocate__pin, page_start)
+
+#else
+
+#define HOTSPOT_ZGC_PHASE_START(name)
+#define HOTSPOT_ZGC_PHASE_END(name, duration_ns)
+#define HOTSPOT_ZGC_ALLOC_STALL_START(type, size)
+#define HOTSPOT_ZGC_ALLOC_STALL_END(type, size, duration_ns)
+#define HOTSPOT_ZGC_PAGE_COMMIT(size)
+#define HOTSPOT_ZGC_PAGE_UNCOMMIT(size)
+#define HOTSPOT_ZGC_RELOCATE_PIN(page_start)
+
+#endif
+
+#endif // SHARE_GC_Z_ZPROBES_HPP
@@ -25,14 +25,15 @@
 #include "classfile/javaClasses.inline.hpp"
 #include "gc/shared/referencePolicy.hpp"
 #include "gc/shared/referenceProcessorStats.hpp"
+#include "gc/z/zDirector.hpp"
 #include "gc/z/zHeap.inline.hpp"
 #include "gc/z/zOopClosures.inline.hpp"
 #include "gc/z/zReferenceProcessor.hpp"
 #include "gc/z/zStat.hpp"
-#include "gc/z/zTask.hpp"
 #include "gc/z/zTracer.inline.hpp"
 #include "gc/z/zUtils.inline.hpp"
 #include "gc/z/zValue.inline.hpp"
+#include "logging/log.hpp"
 #include "memory/universe.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/mutexLocker.hpp"
@@ -41,6 +42,35 @@
 static const ZStatSubPhase ZSubPhaseConcurrentReferencesProcess("Concurrent References Process");
 static const ZStatSubPhase ZSubPhaseConcurrentReferencesEnqueue("Concurrent References Enqueue");
 
+// A SoftReference policy that clears SoftReferences not accessed within an
+// interval proportional to the amount of memory forecast to be free at the
+// end of the GC cycle. As the forecast shrinks under memory pressure, the
+// interval shrinks with it and SoftReferences are cleared progressively,
+// least recently accessed first.
+class ZForecastSoftReferencePolicy : public ReferencePolicy {
+private:
+  jlong _max_interval;
+
+public:
+  ZForecastSoftReferencePolicy() :
+      _max_interval(0) {}
+
+  virtual void setup() {
+    const size_t free = ZDirector::forecast_free();
+    _max_interval = (jlong)(free / M) * SoftRefLRUPolicyMSPerMB;
+    log_debug(gc, ref)("SoftReference Max Interval: " JLONG_FORMAT "ms (Forecast Free: " SIZE_FORMAT "M)",
+                       _max_interval, free / M);
+  }
+
+  virtual bool should_clear_reference(oop p, jlong timestamp_clock) {
+    const jlong interval = timestamp_clock - java_lang_ref_SoftReference::timestamp(p);
+    assert(interval >= 0, "Sanity check");
+
+    // The interval will be zero if the reference was accessed since the last GC
+    return interval > _max_interval;
+  }
+};
+
 static ReferenceType reference_type(oop reference) {
   return InstanceKlass::cast(reference->klass())->reference_type();
 }
@@ -106,23 +136,26 @@ static void soft_reference_update_clock() {
   java_lang_ref_SoftReference::set_clock(now);
 }
 
-ZReferenceProcessor::ZReferenceProcessor(ZWorkers* workers) :
-    _workers(workers),
+ZReferenceProcessor::ZReferenceProcessor() :
     _soft_reference_policy(NULL),
     _encountered_count(),
     _discovered_count(),
     _enqueued_count(),
     _discovered_list(NULL),
+    _nclaimed_lists(0),
     _pending_list(NULL),
     _pending_list_tail(_pending_list.addr()) {}
 
 void ZReferenceProcessor::set_soft_reference_policy(bool clear) {
   static AlwaysClearPolicy always_clear_policy;
   static LRUMaxHeapPolicy lru_max_heap_policy;
+  static ZForecastSoftReferencePolicy forecast_policy;
 
   if (clear) {
     log_info(gc, ref)("Clearing All SoftReferences");
     _soft_reference_policy = &always_clear_policy;
+  } else if (ZGraduatedSoftReferenceClearing) {
+    _soft_reference_policy = &forecast_policy;
   } else {
     _soft_reference_policy = &lru_max_heap_policy;
   }
@@ -299,32 +332,61 @@ oop* ZReferenceProcessor::keep(oop reference, ReferenceType type) {
   return reference_discovered_addr(reference);
 }
 
+bool ZReferenceProcessor::claim_discovered_list(uint32_t* worker_id) {
+  // Discovered lists are claimed rather than processed by the worker that
+  // discovered them. This spreads the work over whichever workers are
+  // running, even if fewer workers run now than during marking.
+  const uint32_t claimed = Atomic::add(&_nclaimed_lists, 1u) - 1;
+  if (claimed >= ZPerWorkerStorage::count()) {
+    // All lists claimed
+    return false;
+  }
+
+  *worker_id = claimed;
+  return true;
+}
+
 void ZReferenceProcessor::work() {
-  // Process discovered references
-  oop* const list = _discovered_list.addr();
-  oop* p = list;
+  ZStatTimer timer(ZSubPhaseConcurrentReferencesProcess);
+
+  // Worker local list of kept references
+  oop pending = NULL;
+  oop* pending_tail = &pending;
+
+  for (uint32_t worker_id; claim_discovered_list(&worker_id);) {
+    // Process discovered references
+    oop* const list = _discovered_list.addr(worker_id);
+    oop* p = list;
+
+    while (*p != NULL) {
+      const oop reference = *p;
+      const ReferenceType type = reference_type(reference);
 
-  while (*p != NULL) {
-    const oop reference = *p;
-    const ReferenceType type = reference_type(reference);
+      if (should_drop(reference, type)) {
+        *p = drop(reference, type);
+      } else {
+        p = keep(reference, type);
+      }
+    }
+
+    // Append kept references to worker local list
+    if (*list != NULL) {
+      *pending_tail = *list;
+      pending_tail = p;
 
-    if (should_drop(reference, type)) {
-      *p = drop(reference, type);
-    } else {
-      p = keep(reference, type);
+      // Clear discovered list
+      *list = NULL;
     }
   }
 
-  // Prepend discovered references to internal pending list
-  if (*list != NULL) {
-    *p = Atomic::xchg(_pending_list.addr(), *list);
-    if (*p == NULL) {
+  // Prepend worker local list to internal pending list, using a
+  // single exchange per worker rather than one per discovered list.
+  if (pending != NULL) {
+    *pending_tail = Atomic::xchg(_pending_list.addr(), pending);
+    if (*pending_tail == NULL) {
       // First to prepend to list, record tail
-      _pending_list_tail = p;
+      _pending_list_tail = pending_tail;
     }
-
-    // Clear discovered list
-    *list = NULL;
   }
 }
 
@@ -414,27 +476,16 @@ void ZReferenceProcessor::collect_statistics() {
   ZTracer::tracer()->report_gc_reference_stats(stats);
 }
 
-class ZReferenceProcessorTask : public ZTask {
-private:
-  ZReferenceProcessor* const _reference_processor;
-
-public:
-  ZReferenceProcessorTask(ZReferenceProcessor* reference_processor) :
-      ZTask("ZReferenceProcessorTask"),
-      _reference_processor(reference_processor) {}
-
-  virtual void work() {
-    _reference_processor->work();
+void ZReferenceProcessor::prepare_process() {
+  if (is_empty()) {
+    // Nothing discovered, the workers find no lists to claim
+    log_debug(gc, ref)("Concurrent References Process: Skipped, nothing discovered");
   }
-};
-
-void ZReferenceProcessor::process_references() {
-  ZStatTimer timer(ZSubPhaseConcurrentReferencesProcess);
 
-  // Process discovered lists
-  ZReferenceProcessorTask task(this);
-  _workers->run_concurrent(&task);
+  _nclaimed_lists = 0;
+}
 
+void ZReferenceProcessor::complete_process() {
   // Update SoftReference clock
   soft_reference_update_clock();
 
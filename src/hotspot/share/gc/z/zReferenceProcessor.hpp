@@ -28,21 +28,18 @@
 #include "gc/z/zValue.hpp"
 
 class ReferencePolicy;
-class ZWorkers;
 
 class ZReferenceProcessor : public ReferenceDiscoverer {
-  friend class ZReferenceProcessorTask;
-
 private:
   static const size_t reference_type_count = REF_PHANTOM + 1;
   typedef size_t Counters[reference_type_count];
 
-  ZWorkers* const      _workers;
   ReferencePolicy*     _soft_reference_policy;
   ZPerWorker<Counters> _encountered_count;
   ZPerWorker<Counters> _discovered_count;
   ZPerWorker<Counters> _enqueued_count;
   ZPerWorker<oop>      _discovered_list;
+  volatile uint32_t    _nclaimed_lists;
   ZContended<oop>      _pending_list;
   oop*                 _pending_list_tail;
 
@@ -62,17 +59,23 @@ private:
 
   bool is_empty() const;
 
-  void work();
+  bool claim_discovered_list(uint32_t* worker_id);
   void collect_statistics();
 
 public:
-  ZReferenceProcessor(ZWorkers* workers);
+  ZReferenceProcessor();
 
   void set_soft_reference_policy(bool clear);
   void reset_statistics();
 
   virtual bool discover_reference(oop reference, ReferenceType type);
-  void process_references();
+  // References are processed as part of the task that processes the
+  // concurrent weak roots. The workers call work() between
+  // prepare_process() and complete_process().
+  void prepare_process();
+  void work();
+  void complete_process();
+
   void enqueue_references();
 };
 
@@ -24,10 +24,15 @@
 #include "precompiled.hpp"
 #include "gc/z/zAddress.inline.hpp"
 #include "gc/z/zBarrier.inline.hpp"
+#include "gc/z/zClassProfile.hpp"
 #include "gc/z/zForwarding.inline.hpp"
-#include "gc/z/zHeap.hpp"
+#include "gc/z/zForwardingCompact.inline.hpp"
+#include "gc/z/zGlobals.hpp"
+#include "gc/z/zHeap.inline.hpp"
+#include "gc/z/zOop.inline.hpp"
 #include "gc/z/zOopClosures.inline.hpp"
 #include "gc/z/zPage.hpp"
+#include "gc/z/zProbes.hpp"
 #include "gc/z/zRelocate.hpp"
 #include "gc/z/zRelocationSet.inline.hpp"
 #include "gc/z/zRootsIterator.hpp"
@@ -35,13 +40,24 @@
 #include "gc/z/zTask.hpp"
 #include "gc/z/zThread.inline.hpp"
 #include "gc/z/zThreadLocalAllocBuffer.hpp"
+#include "gc/z/zUtils.inline.hpp"
 #include "gc/z/zWorkers.hpp"
 #include "logging/log.hpp"
+#include "memory/iterator.inline.hpp"
+#include "oops/oop.inline.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
+#include "utilities/align.hpp"
+#include "utilities/ticks.hpp"
 
-static const ZStatCounter ZCounterRelocationContention("Contention", "Relocation Contention", ZStatUnitOpsPerSecond);
+static const ZStatCounter   ZCounterRelocationContention("Contention", "Relocation Contention", ZStatUnitOpsPerSecond);
+static const ZStatHistogram ZHistogramRelocationContentionWait("Latency", "Relocation Contention Wait");
+static const ZStatHistogram ZHistogramRelocationInPlaceWait("Latency", "Relocation In-Place Wait");
 
 ZRelocate::ZRelocate(ZWorkers* workers) :
-    _workers(workers) {}
+    _workers(workers),
+    _assist_task(NULL),
+    _nassisting(0) {}
 
 class ZRelocateRootsIteratorClosure : public ZRootsIteratorClosure {
 public:
@@ -75,82 +91,210 @@ private:
   ZRelocateRootsIteratorClosure _cl;
 
 public:
-  ZRelocateRootsTask() :
+  ZRelocateRootsTask(bool visit_jvmti_weak_export) :
       ZTask("ZRelocateRootsTask"),
-      _roots(true /* visit_jvmti_weak_export */) {}
+      _roots(visit_jvmti_weak_export) {}
 
   virtual void work() {
-    // During relocation we need to visit the JVMTI
-    // export weak roots to rehash the JVMTI tag map
     _roots.oops_do(&_cl);
   }
 };
 
-void ZRelocate::start() {
-  ZRelocateRootsTask task;
+void ZRelocate::start(ZRelocationSet* relocation_set) {
+  // The JVMTI tag map hashes objects by address, independent of the
+  // pointer color, so the export weak roots only need to be visited,
+  // to relocate and rehash tagged objects, when objects will move.
+  // Otherwise the tag map entries are lazily healed by their load
+  // barriers, like any other weak root.
+  ZRelocateRootsTask task(!relocation_set->is_empty() /* visit_jvmti_weak_export */);
   _workers->run_parallel(&task);
 }
 
-uintptr_t ZRelocate::relocate_object_inner(ZForwarding* forwarding, uintptr_t from_index, uintptr_t from_offset) const {
-  ZForwardingCursor cursor;
+uintptr_t ZRelocate::alloc_block(ZForwarding* forwarding, size_t segment) const {
+  ZForwardingCompact* const compact = forwarding->compact();
+  const ZPage* const page = forwarding->page();
+  const size_t size = compact->block_size(segment);
+  const uintptr_t addr = ZHeap::heap()->alloc_object_for_relocation(size, page->is_tenured(), page->partition());
+  const uintptr_t block = (addr != 0) ? ZAddress::offset(addr) : ZForwardingCompact::block_failed;
+
+  const uintptr_t installed_block = compact->install_block(segment, block);
+  if (installed_block != block && addr != 0) {
+    // Another thread installed a block first, undo allocation
+    ZHeap::heap()->undo_alloc_object_for_relocation(addr, size);
+  }
+
+  return installed_block;
+}
+
+uintptr_t ZRelocate::relocate_object_compact(ZForwarding* forwarding, uintptr_t from_index, uintptr_t from_offset) const {
+  ZForwardingCompact* const compact = forwarding->compact();
+  const size_t segment = compact->segment(from_index);
+
+  uintptr_t block = compact->block(segment);
+  if (block == ZForwardingCompact::block_unassigned) {
+    // Allocate block for the segment
+    block = alloc_block(forwarding, segment);
+  }
+
+  if (block == ZForwardingCompact::block_failed) {
+    // Block allocation failed, the objects in this
+    // segment are relocated individually instead
+    return 0;
+  }
+
+  const uintptr_t to_good = ZAddress::good(compact->to_offset(from_index));
+
+  if (!compact->claim(from_index)) {
+    // Another thread is copying the object, wait for it to complete
+    const Ticks start = Ticks::now();
+    ZStatInc(ZCounterRelocationContention);
+    compact->wait_relocated(from_index);
+    ZStatSample(ZHistogramRelocationContentionWait, (Ticks::now() - start).value());
+    return to_good;
+  }
+
+  // Copy object
+  const uintptr_t from_good = ZAddress::good(from_offset);
+  const size_t size = forwarding->page()->live_object_size(from_good);
+  ZUtils::object_copy_for_relocation(from_good, to_good, size);
+
+  // Publish copy
+  compact->set_relocated(from_index);
+
+  return to_good;
+}
+
+uintptr_t ZRelocate::relocate_object_remap(ZForwarding* forwarding, uintptr_t from_index, uintptr_t from_offset, ZForwardingCursor* cursor) const {
+  // A large page holds a single object, which is relocated without copying,
+  // by mapping the physical memory of the page at a higher address. The
+  // object is accessible through both addresses until the page is released.
+  ZPage* const page = ZHeap::heap()->remap_page(forwarding->page());
+  if (page == NULL) {
+    // Remapping failed
+    return 0;
+  }
+
+  // Insert forwarding entry
+  const uintptr_t to_offset = page->start() + (from_offset - forwarding->start());
+  const uintptr_t to_offset_final = forwarding->insert(from_index, to_offset, cursor);
+  if (to_offset_final == to_offset) {
+    // Relocation succeeded
+    log_trace(gc, reloc)("Remapped page: " PTR_FORMAT " -> " PTR_FORMAT ", size: " SIZE_FORMAT "M",
+                         forwarding->start(), page->start(), page->size() / M);
+    return ZAddress::good(to_offset);
+  }
 
+  // Relocation contention
+  ZStatInc(ZCounterRelocationContention);
+
+  // Undo remapping
+  ZHeap::heap()->free_remapped_page(page);
+
+  return ZAddress::good(to_offset_final);
+}
+
+static bool is_object_tenured(uintptr_t addr) {
+  if (!ZTrackObjectAge || ZTenuringThreshold == 0) {
+    return false;
+  }
+
+  // The age in the mark word saturates, so thresholds beyond
+  // the max age are capped at the max age
+  const uint threshold = MIN2(ZTenuringThreshold, (uint)markWord::max_age);
+  return ZUtils::object_age(addr) + 1 >= threshold;
+}
+
+uintptr_t ZRelocate::relocate_object_inner(ZForwarding* forwarding, uintptr_t from_index, uintptr_t from_offset, ZForwardingCursor* cursor) const {
   // Lookup forwarding entry
-  const ZForwardingEntry entry = forwarding->find(from_index, &cursor);
+  const ZForwardingEntry entry = forwarding->find(from_index, cursor);
   if (entry.populated() && entry.from_index() == from_index) {
     // Already relocated, return new address
-    return entry.to_offset();
+    return ZAddress::good(entry.to_offset());
   }
 
   assert(ZHeap::heap()->is_object_live(ZAddress::good(from_offset)), "Should be live");
 
+  if (forwarding->is_compact()) {
+    // Relocate object into the block of its segment. This never fails
+    // once a block has been installed, so this is done even if the
+    // page is pinned.
+    const uintptr_t to_good = relocate_object_compact(forwarding, from_index, from_offset);
+    if (to_good != 0) {
+      return to_good;
+    }
+  }
+
   if (forwarding->is_pinned()) {
-    // In-place forward
-    return forwarding->insert(from_index, from_offset, &cursor);
+    // Page is pinned, don't try to allocate
+    return 0;
+  }
+
+  if (forwarding->is_large()) {
+    // Relocate object by remapping its page
+    return relocate_object_remap(forwarding, from_index, from_offset, cursor);
   }
 
   // Allocate object
   const uintptr_t from_good = ZAddress::good(from_offset);
-  const size_t size = ZUtils::object_size(from_good);
-  const uintptr_t to_good = ZHeap::heap()->alloc_object_for_relocation(size);
+  const ZPage* const page = forwarding->page();
+  const size_t size = page->live_object_size(from_good);
+  const bool tenured = page->is_tenured() || is_object_tenured(from_good);
+  const uintptr_t to_good = ZHeap::heap()->alloc_object_for_relocation(size, tenured, page->partition());
   if (to_good == 0) {
-    // Failed, in-place forward
-    return forwarding->insert(from_index, from_offset, &cursor);
+    // Allocation failed
+    return 0;
   }
 
   // Copy object
-  ZUtils::object_copy(from_good, to_good, size);
+  ZUtils::object_copy_for_relocation(from_good, to_good, size);
+
+  if (ZTrackObjectAge) {
+    // The copy is not yet published, so its mark word can be updated
+    // without synchronization. A copy losing the forwarding race below
+    // is discarded together with its age.
+    ZUtils::object_increment_age(to_good);
+  }
 
   // Insert forwarding entry
   const uintptr_t to_offset = ZAddress::offset(to_good);
-  const uintptr_t to_offset_final = forwarding->insert(from_index, to_offset, &cursor);
+  const uintptr_t to_offset_final = forwarding->insert(from_index, to_offset, cursor);
   if (to_offset_final == to_offset) {
     // Relocation succeeded
-    return to_offset;
+    if (ZProfileClasses) {
+      ZClassProfile::record_relocated(ZOop::from_address(to_good)->klass(), size);
+    }
+    return to_good;
   }
 
   // Relocation contention
   ZStatInc(ZCounterRelocationContention);
   log_trace(gc)("Relocation contention, thread: " PTR_FORMAT " (%s), forwarding: " PTR_FORMAT
                 ", entry: " SIZE_FORMAT ", oop: " PTR_FORMAT ", size: " SIZE_FORMAT,
-                ZThread::id(), ZThread::name(), p2i(forwarding), cursor, from_good, size);
+                ZThread::id(), ZThread::name(), p2i(forwarding), *cursor, from_good, size);
 
   // Try undo allocation
   ZHeap::heap()->undo_alloc_object_for_relocation(to_good, size);
 
-  return to_offset_final;
+  return ZAddress::good(to_offset_final);
 }
 
 uintptr_t ZRelocate::relocate_object(ZForwarding* forwarding, uintptr_t from_addr) const {
   const uintptr_t from_offset = ZAddress::offset(from_addr);
   const uintptr_t from_index = (from_offset - forwarding->start()) >> forwarding->object_alignment_shift();
-  const uintptr_t to_offset = relocate_object_inner(forwarding, from_index, from_offset);
+  ZForwardingCursor cursor;
 
-  if (from_offset == to_offset) {
-    // In-place forwarding, pin page
-    forwarding->set_pinned();
+  const uintptr_t to_addr = relocate_object_inner(forwarding, from_index, from_offset, &cursor);
+  if (to_addr != 0) {
+    return to_addr;
   }
 
-  return ZAddress::good(to_offset);
+  // Failed to relocate object, in-place forward and pin page. The object
+  // will be kept in place when the worker thread relocating this page
+  // compacts the remaining objects.
+  if (forwarding->set_pinned()) {
+    HOTSPOT_ZGC_RELOCATE_PIN(forwarding->start());
+  }
+  return ZAddress::good(forwarding->insert(from_index, from_offset, &cursor));
 }
 
 uintptr_t ZRelocate::forward_object(ZForwarding* forwarding, uintptr_t from_addr) const {
@@ -164,72 +308,417 @@ uintptr_t ZRelocate::forward_object(ZForwarding* forwarding, uintptr_t from_addr
   return ZAddress::good(entry.to_offset());
 }
 
+// When relocating in reference order, the objects referenced from a newly
+// relocated object are relocated right after it, depth first and up to a
+// max depth, instead of in address order. Related objects, like the nodes
+// of a tree, are then placed close to each other, even if they were
+// allocated far apart. The fields visited are healed by the load barrier.
+// Objects on pages with compact forwarding tables are not followed, since
+// their new addresses are determined in advance.
+class ZRelocateReferenceOrderClosure : public BasicOopIterateClosure {
+private:
+  size_t _depth;
+  size_t _nfollowed;
+
+  bool should_follow(uintptr_t addr) const {
+    if (addr == 0 || ZAddress::is_good(addr)) {
+      // Null or already healed
+      return false;
+    }
+
+    const ZForwarding* const forwarding = ZHeap::heap()->forwarding(addr);
+    if (forwarding == NULL || forwarding->is_compact()) {
+      // Not relocating, or new address already determined
+      return false;
+    }
+
+    // Follow only if not already relocated
+    const uintptr_t from_index = (ZAddress::offset(addr) - forwarding->start()) >> forwarding->object_alignment_shift();
+    return !forwarding->find(from_index).populated();
+  }
+
+public:
+  ZRelocateReferenceOrderClosure() :
+      _depth(0),
+      _nfollowed(0) {}
+
+  void follow(uintptr_t addr) {
+    if (_depth < ZRelocateReferenceOrderDepthMax) {
+      _depth++;
+      ZOop::from_address(addr)->oop_iterate(this);
+      _depth--;
+    }
+  }
+
+  virtual void do_oop(oop* p) {
+    const uintptr_t addr = ZOop::to_address(Atomic::load(p));
+    if (should_follow(addr)) {
+      // Relocate object, heal field, and follow the new object
+      const uintptr_t to_addr = ZOop::to_address(ZBarrier::load_barrier_on_oop_field(p));
+      _nfollowed++;
+      follow(to_addr);
+    }
+  }
+
+  virtual void do_oop(narrowOop* p) {
+    ShouldNotReachHere();
+  }
+
+#ifdef ASSERT
+  virtual bool should_verify_oops() {
+    return false;
+  }
+#endif
+
+  size_t nfollowed() const {
+    return _nfollowed;
+  }
+};
+
 class ZRelocateObjectClosure : public ObjectClosure {
 private:
-  ZRelocate* const   _relocate;
-  ZForwarding* const _forwarding;
+  ZRelocate* const                      _relocate;
+  ZForwarding* const                    _forwarding;
+  ZRelocateReferenceOrderClosure* const _reference_order;
+  bool                                  _failed;
 
 public:
-  ZRelocateObjectClosure(ZRelocate* relocate, ZForwarding* forwarding) :
+  ZRelocateObjectClosure(ZRelocate* relocate, ZForwarding* forwarding, ZRelocateReferenceOrderClosure* reference_order) :
       _relocate(relocate),
-      _forwarding(forwarding) {}
+      _forwarding(forwarding),
+      _reference_order(forwarding->is_compact() ? NULL : reference_order),
+      _failed(false) {}
+
+  virtual void do_object(oop o) {
+    if (_failed) {
+      // Relocation failed, the remaining
+      // objects will be relocated in-place
+      return;
+    }
+
+    const uintptr_t from_offset = ZAddress::offset(ZOop::to_address(o));
+    const uintptr_t from_index = (from_offset - _forwarding->start()) >> _forwarding->object_alignment_shift();
+    ZForwardingCursor cursor;
+
+    const uintptr_t to_addr = _relocate->relocate_object_inner(_forwarding, from_index, from_offset, &cursor);
+    if (to_addr == 0) {
+      _failed = true;
+      return;
+    }
+
+    if (_reference_order != NULL) {
+      // Relocate referenced objects next to this object
+      _reference_order->follow(to_addr);
+    }
+  }
+
+  bool failed() const {
+    return _failed;
+  }
+};
+
+class ZRelocateInPlaceClosure : public ObjectClosure {
+private:
+  ZForwarding* const _forwarding;
+  const size_t       _object_alignment;
+  uintptr_t          _top;
+
+public:
+  ZRelocateInPlaceClosure(ZForwarding* forwarding) :
+      _forwarding(forwarding),
+      _object_alignment((size_t)1 << forwarding->object_alignment_shift()),
+      _top(forwarding->start()) {}
 
   virtual void do_object(oop o) {
-    _relocate->relocate_object(_forwarding, ZOop::to_address(o));
+    const uintptr_t from_good = ZOop::to_address(o);
+    const uintptr_t from_offset = ZAddress::offset(from_good);
+    const uintptr_t from_index = (from_offset - _forwarding->start()) >> _forwarding->object_alignment_shift();
+    const size_t size = _forwarding->page()->live_object_size(from_good);
+    const size_t aligned_size = align_up(size, _object_alignment);
+    ZForwardingCursor cursor;
+
+    const ZForwardingEntry entry = _forwarding->find(from_index, &cursor);
+    if (entry.populated()) {
+      if (entry.to_offset() == from_offset) {
+        // Forwarded in-place by another thread, keep object where it is
+        _top = from_offset + aligned_size;
+      }
+
+      // Otherwise already relocated to another page
+      return;
+    }
+
+    // Objects are visited in address order, which means the new address
+    // is never above the old address. The copy might therefore overlap with
+    // the object itself, but never with objects that have not been visited.
+    const uintptr_t to_offset = _top;
+    assert(to_offset <= from_offset, "Invalid new address");
+    if (to_offset != from_offset) {
+      ZUtils::object_copy_conjoint(from_good, ZAddress::good(to_offset), size);
+    }
+
+    // Insert forwarding entry
+    _forwarding->insert(from_index, to_offset, &cursor);
+    _top += aligned_size;
+  }
+
+  uintptr_t top() const {
+    return _top;
   }
 };
 
-bool ZRelocate::work(ZRelocationSetParallelIterator* iter) {
-  bool success = true;
+void ZRelocate::relocate_in_place(ZForwarding* forwarding) const {
+  // Claim the page to block other threads from relocating objects
+  // on it, while the remaining live objects are compacted. This
+  // waits for threads currently relocating objects on the page.
+  const Ticks start = Ticks::now();
+  ZPage* const page = forwarding->claim_page();
+  ZStatSample(ZHistogramRelocationInPlaceWait, (Ticks::now() - start).value());
 
-  // Relocate pages in the relocation set
-  for (ZForwarding* forwarding; iter->next(&forwarding);) {
-    // Relocate objects in page
-    ZRelocateObjectClosure cl(this, forwarding);
-    forwarding->page()->object_iterate(&cl);
+  // Compact remaining objects towards the start of the page
+  ZRelocateInPlaceClosure cl(forwarding);
+  page->object_iterate(&cl);
+
+  if (ZVerifyForwarding) {
+    forwarding->verify();
+  }
+
+  log_trace(gc, reloc)("In-place relocated page: " PTR_FORMAT ", compacted: " SIZE_FORMAT "K, freed: " SIZE_FORMAT "K",
+                       page->start(), (cl.top() - page->start()) / K, (page->end() - cl.top()) / K);
+
+  // Make the space after the compacted objects available
+  // for relocation of other objects, and release the page
+  page->reset_for_in_place_relocation(cl.top());
+  forwarding->set_in_place();
+  forwarding->release_page();
+
+  if (ZThread::is_worker()) {
+    // Threads assisting while stalled on allocation
+    // don't have pages of their own for relocation
+    ZHeap::heap()->reuse_page_for_relocation(page);
+  }
+}
+
+size_t ZRelocate::finish_page(ZForwarding* forwarding, bool failed, ZArray<ZPage*>* freed) const {
+  if (failed || forwarding->is_pinned()) {
+    // Relocation failed, relocate remaining objects in-place
+    relocate_in_place(forwarding);
+    return 1;
+  }
+
+  if (ZVerifyForwarding) {
+    forwarding->verify();
+  }
+
+  // Relocation succeeded, release page
+  forwarding->release_page(freed);
+  return 0;
+}
+
+size_t ZRelocate::relocate_page(ZForwarding* forwarding, ZRelocateReferenceOrderClosure* reference_order, ZArray<ZPage*>* freed) {
+  // Relocate objects in page
+  ZRelocateObjectClosure cl(this, forwarding, reference_order);
+  forwarding->page()->object_iterate(&cl);
+
+  return finish_page(forwarding, cl.failed(), freed);
+}
 
-    if (ZVerifyForwarding) {
-      forwarding->verify();
+size_t ZRelocate::relocate_page_segments(ZForwarding* forwarding, ZRelocateReferenceOrderClosure* reference_order, ZArray<ZPage*>* freed) {
+  size_t in_place = 0;
+
+  // Relocate objects in claimed live map segments. Since the page
+  // can be released as soon as the last segment has been completed,
+  // the page must only be accessed after having claimed a segment.
+  for (size_t segment; forwarding->claim_segment(&segment);) {
+    ZRelocateObjectClosure cl(this, forwarding, reference_order);
+    forwarding->page()->object_iterate(&cl, segment);
+
+    if (cl.failed()) {
+      // Pin page to make other threads stop relocating objects
+      // on it, the remaining objects will be relocated in-place
+      if (forwarding->set_pinned()) {
+        HOTSPOT_ZGC_RELOCATE_PIN(forwarding->start());
+      }
     }
 
-    if (forwarding->is_pinned()) {
-      // Relocation failed, page is now pinned
-      success = false;
-    } else {
-      // Relocation succeeded, release page
-      forwarding->release_page();
+    if (forwarding->complete_segment()) {
+      // Last segment completed
+      in_place += finish_page(forwarding, false /* failed */, freed);
+    }
+  }
+
+  return in_place;
+}
+
+static bool should_split_page(const ZForwarding* forwarding) {
+  // Medium pages are split into live map segments, which are
+  // relocated by all workers, to avoid having a single worker
+  // relocating a large page while the other workers are idle.
+  // Large pages hold a single object, and are remapped instead.
+  return forwarding->size() > ZPageSizeSmall && !forwarding->is_large();
+}
+
+size_t ZRelocate::relocate_forwarding(ZForwarding* forwarding, ZRelocateReferenceOrderClosure* reference_order, ZArray<ZPage*>* freed) {
+  if (should_split_page(forwarding)) {
+    return relocate_page_segments(forwarding, reference_order, freed);
+  }
+
+  return relocate_page(forwarding, reference_order, freed);
+}
+
+// Number of relocated pages a worker collects before freeing them in a
+// batch. Kept small, since threads stalled on allocation can only be
+// satisfied once the pages have been freed.
+static const size_t ZRelocateFreeBatchSize = 16;
+
+void ZRelocate::free_pages(ZArray<ZPage*>* freed, size_t min_batch) const {
+  if (freed->is_empty()) {
+    // Nothing to free
+    return;
+  }
+
+  // Free collected pages when the batch is full, or right away if
+  // allocations are stalled, to hand the memory to the stalled threads
+  // as soon as each page has been completely relocated.
+  if (freed->size() >= min_batch || ZHeap::heap()->is_alloc_stalled()) {
+    ZHeap::heap()->free_pages(freed, true /* reclaimed */);
+    freed->clear();
+  }
+}
+
+size_t ZRelocate::work(ZRelocationSetParallelIterator* iter, ZRelocationSet* relocation_set, ZRelocateReferenceOrderClosure* reference_order) {
+  ZArray<ZPage*> freed;
+  size_t in_place = 0;
+
+  // Relocate pages in the relocation set
+  for (ZForwarding* forwarding; iter->next(&forwarding);) {
+    in_place += relocate_forwarding(forwarding, reference_order, &freed);
+    free_pages(&freed, ZRelocateFreeBatchSize);
+  }
+
+  // Help relocate remaining segments of split pages
+  ZRelocationSetIterator split_iter(relocation_set);
+  for (ZForwarding* forwarding; split_iter.next(&forwarding);) {
+    if (should_split_page(forwarding)) {
+      in_place += relocate_page_segments(forwarding, reference_order, &freed);
+      free_pages(&freed, ZRelocateFreeBatchSize);
     }
   }
 
-  return success;
+  // Free remaining pages
+  free_pages(&freed, 0 /* min_batch */);
+
+  return in_place;
 }
 
 class ZRelocateTask : public ZTask {
 private:
   ZRelocate* const               _relocate;
+  ZRelocationSet* const          _relocation_set;
   ZRelocationSetParallelIterator _iter;
-  bool                           _failed;
+  volatile size_t                _in_place;
+  volatile size_t                _followed;
+  volatile bool                  _first_done_claimed;
+  Ticks                          _first_done;
 
 public:
   ZRelocateTask(ZRelocate* relocate, ZRelocationSet* relocation_set) :
       ZTask("ZRelocateTask"),
       _relocate(relocate),
+      _relocation_set(relocation_set),
       _iter(relocation_set),
-      _failed(false) {}
+      _in_place(0),
+      _followed(0),
+      _first_done_claimed(false),
+      _first_done() {}
+
+  bool assist() {
+    // Relocate one page of the relocation set
+    ZForwarding* forwarding;
+    if (!_iter.next(&forwarding)) {
+      // No pages left
+      return false;
+    }
+
+    // Pages are freed immediately, since the assisting threads
+    // are waiting for memory to be freed
+    const size_t in_place = _relocate->relocate_forwarding(forwarding, NULL /* reference_order */, NULL /* freed */);
+    if (in_place > 0) {
+      Atomic::add(&_in_place, in_place);
+    }
+
+    return true;
+  }
 
   virtual void work() {
-    if (!_relocate->work(&_iter)) {
-      _failed = true;
+    ZRelocateReferenceOrderClosure reference_order;
+    const size_t in_place = _relocate->work(&_iter, _relocation_set, ZRelocateInReferenceOrder ? &reference_order : NULL);
+    if (in_place > 0) {
+      Atomic::add(&_in_place, in_place);
+    }
+
+    if (reference_order.nfollowed() > 0) {
+      Atomic::add(&_followed, reference_order.nfollowed());
+    }
+
+    // Record when the first worker ran out of work
+    if (!Atomic::load(&_first_done_claimed) &&
+        !Atomic::cmpxchg(&_first_done_claimed, false, true)) {
+      _first_done = Ticks::now();
     }
   }
 
-  bool failed() const {
-    return _failed;
+  size_t in_place() const {
+    return _in_place;
+  }
+
+  size_t followed() const {
+    return _followed;
+  }
+
+  // Time from when the first worker ran out of work until the
+  // relocation completed, spent waiting for the remaining workers
+  // and for assisting threads to finish the pages they claimed.
+  // Only valid after all workers have completed.
+  Tickspan tail(const Ticks& end) const {
+    if (!_first_done_claimed) {
+      return Tickspan();
+    }
+
+    return end - _first_done;
   }
 };
 
-bool ZRelocate::relocate(ZRelocationSet* relocation_set) {
+bool ZRelocate::assist() {
+  // Register as assisting before loading the task, which keeps the
+  // task alive until this thread has stopped using it.
+  Atomic::inc(&_nassisting);
+  ZRelocateTask* const task = Atomic::load_acquire(&_assist_task);
+  const bool relocated = (task != NULL) && task->assist();
+  Atomic::dec(&_nassisting);
+
+  return relocated;
+}
+
+void ZRelocate::relocate(ZRelocationSet* relocation_set) {
+  const Ticks start = Ticks::now();
+
   ZRelocateTask task(this, relocation_set);
+
+  // Let threads stalled on allocation help relocate pages
+  Atomic::release_store(&_assist_task, &task);
+  ZHeap::heap()->notify_relocation_assist();
+
   _workers->run_concurrent(&task);
-  return !task.failed();
+
+  // Stop assisting, and wait for assisting threads to
+  // complete the relocation of the pages they claimed
+  Atomic::xchg(&_assist_task, (ZRelocateTask*)NULL);
+  while (Atomic::load_acquire(&_nassisting) > 0) {
+    os::naked_yield();
+  }
+
+  // Update statistics
+  const Ticks end = Ticks::now();
+  ZStatRelocation::set_at_relocate_end(task.in_place(), task.followed(), end - start, task.tail(end));
 }
@@ -24,21 +24,35 @@
 #ifndef SHARE_GC_Z_ZRELOCATE_HPP
 #define SHARE_GC_Z_ZRELOCATE_HPP
 
+#include "gc/z/zForwarding.hpp"
 #include "gc/z/zRelocationSet.hpp"
 #include "gc/z/zWorkers.hpp"
 #include "memory/allocation.hpp"
 
-class ZForwarding;
+class ZRelocateReferenceOrderClosure;
+class ZRelocateTask;
 
 class ZRelocate {
+  friend class ZRelocateObjectClosure;
   friend class ZRelocateTask;
 
 private:
-  ZWorkers* const _workers;
+  ZWorkers* const         _workers;
+  ZRelocateTask* volatile _assist_task;
+  volatile uint32_t       _nassisting;
 
   ZForwarding* forwarding_for_page(ZPage* page) const;
-  uintptr_t relocate_object_inner(ZForwarding* forwarding, uintptr_t from_index, uintptr_t from_offset) const;
-  bool work(ZRelocationSetParallelIterator* iter);
+  uintptr_t alloc_block(ZForwarding* forwarding, size_t segment) const;
+  uintptr_t relocate_object_compact(ZForwarding* forwarding, uintptr_t from_index, uintptr_t from_offset) const;
+  uintptr_t relocate_object_remap(ZForwarding* forwarding, uintptr_t from_index, uintptr_t from_offset, ZForwardingCursor* cursor) const;
+  uintptr_t relocate_object_inner(ZForwarding* forwarding, uintptr_t from_index, uintptr_t from_offset, ZForwardingCursor* cursor) const;
+  void relocate_in_place(ZForwarding* forwarding) const;
+  size_t finish_page(ZForwarding* forwarding, bool failed, ZArray<ZPage*>* freed) const;
+  size_t relocate_page(ZForwarding* forwarding, ZRelocateReferenceOrderClosure* reference_order, ZArray<ZPage*>* freed);
+  size_t relocate_page_segments(ZForwarding* forwarding, ZRelocateReferenceOrderClosure* reference_order, ZArray<ZPage*>* freed);
+  size_t relocate_forwarding(ZForwarding* forwarding, ZRelocateReferenceOrderClosure* reference_order, ZArray<ZPage*>* freed);
+  void free_pages(ZArray<ZPage*>* freed, size_t min_batch) const;
+  size_t work(ZRelocationSetParallelIterator* iter, ZRelocationSet* relocation_set, ZRelocateReferenceOrderClosure* reference_order);
 
 public:
   ZRelocate(ZWorkers* workers);
@@ -46,8 +60,9 @@ public:
   uintptr_t relocate_object(ZForwarding* forwarding, uintptr_t from_addr) const;
   uintptr_t forward_object(ZForwarding* forwarding, uintptr_t from_addr) const;
 
-  void start();
-  bool relocate(ZRelocationSet* relocation_set);
+  void start(ZRelocationSet* relocation_set);
+  bool assist();
+  void relocate(ZRelocationSet* relocation_set);
 };
 
 #endif // SHARE_GC_Z_ZRELOCATE_HPP
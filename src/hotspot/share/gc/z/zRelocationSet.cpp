@@ -22,7 +22,10 @@
  */
 
 #include "precompiled.hpp"
-#include "gc/z/zForwarding.hpp"
+#include "gc/z/zArray.inline.hpp"
+#include "gc/z/zForwarding.inline.hpp"
+#include "gc/z/zForwardingSpace.hpp"
+#include "gc/z/zPage.inline.hpp"
 #include "gc/z/zRelocationSet.hpp"
 #include "memory/allocation.hpp"
 
@@ -31,8 +34,9 @@ ZRelocationSet::ZRelocationSet() :
     _nforwardings(0) {}
 
 void ZRelocationSet::populate(ZPage* const* group0, size_t ngroup0,
-                              ZPage* const* group1, size_t ngroup1) {
-  _nforwardings = ngroup0 + ngroup1;
+                              ZPage* const* group1, size_t ngroup1,
+                              const ZArray<ZPage*>* group2) {
+  _nforwardings = ngroup0 + ngroup1 + group2->size();
   _forwardings = REALLOC_C_HEAP_ARRAY(ZForwarding*, _forwardings, _nforwardings, mtGC);
 
   size_t j = 0;
@@ -46,6 +50,30 @@ void ZRelocationSet::populate(ZPage* const* group0, size_t ngroup0,
   for (size_t i = 0; i < ngroup1; i++) {
     _forwardings[j++] = ZForwarding::create(group1[i]);
   }
+
+  // Populate group 2
+  for (size_t i = 0; i < group2->size(); i++) {
+    _forwardings[j++] = ZForwarding::create(group2->at(i));
+  }
+}
+
+bool ZRelocationSet::is_empty() const {
+  return _nforwardings == 0;
+}
+
+void ZRelocationSet::remove_pinned(ZArray<ZForwarding*>* removed) {
+  size_t j = 0;
+
+  for (size_t i = 0; i < _nforwardings; i++) {
+    ZForwarding* const forwarding = _forwardings[i];
+    if (forwarding->page()->is_pinned()) {
+      removed->add(forwarding);
+    } else {
+      _forwardings[j++] = forwarding;
+    }
+  }
+
+  _nforwardings = j;
 }
 
 void ZRelocationSet::reset() {
@@ -53,4 +81,9 @@ void ZRelocationSet::reset() {
     ZForwarding::destroy(_forwardings[i]);
     _forwardings[i] = NULL;
   }
+
+  _nforwardings = 0;
+
+  // Free all forwardings allocated from the forwarding space
+  ZForwardingSpace::reset();
 }
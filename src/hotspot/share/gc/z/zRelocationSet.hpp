@@ -24,6 +24,8 @@
 #ifndef SHARE_GC_Z_ZRELOCATIONSET_HPP
 #define SHARE_GC_Z_ZRELOCATIONSET_HPP
 
+#include "gc/z/zArray.hpp"
+#include "gc/z/zTaskRange.hpp"
 #include "memory/allocation.hpp"
 
 class ZForwarding;
@@ -31,6 +33,7 @@ class ZPage;
 
 class ZRelocationSet {
   template <bool> friend class ZRelocationSetIteratorImpl;
+  friend class ZRelocationSetParallelIterator;
 
 private:
   ZForwarding** _forwardings;
@@ -40,8 +43,12 @@ public:
   ZRelocationSet();
 
   void populate(ZPage* const* group0, size_t ngroup0,
-                ZPage* const* group1, size_t ngroup1);
+                ZPage* const* group1, size_t ngroup1,
+                const ZArray<ZPage*>* group2);
+  void remove_pinned(ZArray<ZForwarding*>* removed);
   void reset();
+
+  bool is_empty() const;
 };
 
 template <bool parallel>
@@ -66,10 +73,17 @@ public:
       ZRelocationSetIteratorImpl<ZRELOCATIONSET_SERIAL>(relocation_set) {}
 };
 
-class ZRelocationSetParallelIterator : public ZRelocationSetIteratorImpl<ZRELOCATIONSET_PARALLEL> {
+// Claims forwardings one at a time with work stealing, so that each worker
+// mostly relocates pages that are next to each other in the relocation set
+class ZRelocationSetParallelIterator : public StackObj {
+private:
+  ZRelocationSet* const _relocation_set;
+  ZTaskRange            _range;
+
 public:
-  ZRelocationSetParallelIterator(ZRelocationSet* relocation_set) :
-      ZRelocationSetIteratorImpl<ZRELOCATIONSET_PARALLEL>(relocation_set) {}
+  ZRelocationSetParallelIterator(ZRelocationSet* relocation_set);
+
+  bool next(ZForwarding** forwarding);
 };
 
 #endif // SHARE_GC_Z_ZRELOCATIONSET_HPP
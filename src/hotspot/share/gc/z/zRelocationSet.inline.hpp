@@ -25,6 +25,7 @@
 #define SHARE_GC_Z_ZRELOCATIONSET_INLINE_HPP
 
 #include "gc/z/zRelocationSet.hpp"
+#include "gc/z/zTaskRange.inline.hpp"
 #include "runtime/atomic.hpp"
 
 template <bool parallel>
@@ -54,4 +55,19 @@ inline bool ZRelocationSetIteratorImpl<parallel>::next(ZForwarding** forwarding)
   return false;
 }
 
+inline ZRelocationSetParallelIterator::ZRelocationSetParallelIterator(ZRelocationSet* relocation_set) :
+    _relocation_set(relocation_set),
+    _range(relocation_set->_nforwardings, 1 /* chunk_size */) {}
+
+inline bool ZRelocationSetParallelIterator::next(ZForwarding** forwarding) {
+  size_t start;
+  size_t end;
+  if (!_range.next(&start, &end)) {
+    return false;
+  }
+
+  *forwarding = _relocation_set->_forwardings[start];
+  return true;
+}
+
 #endif // SHARE_GC_Z_ZRELOCATIONSET_INLINE_HPP
@@ -26,20 +26,35 @@
 #include "gc/z/zPage.inline.hpp"
 #include "gc/z/zRelocationSet.hpp"
 #include "gc/z/zRelocationSetSelector.hpp"
+#include "gc/z/zStat.hpp"
+#include "gc/z/zTask.hpp"
+#include "gc/z/zTracer.inline.hpp"
+#include "gc/z/zWorkers.inline.hpp"
 #include "logging/log.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/globals.hpp"
 #include "utilities/debug.hpp"
+#include "utilities/powerOfTwo.hpp"
+#include "utilities/quickSort.hpp"
+
+// Estimated cost of relocating an object, in addition to copying its
+// contents, expressed as the equivalent number of bytes copied. This
+// covers the forwarding table insertion and the object header accesses.
+static const double ZRelocationCostPerObject = 64.0;
 
 ZRelocationSetSelectorGroup::ZRelocationSetSelectorGroup(const char* name,
                                                          size_t page_size,
-                                                         size_t object_size_limit) :
+                                                         size_t object_size_limit,
+                                                         double fragmentation_limit) :
     _name(name),
     _page_size(page_size),
     _object_size_limit(object_size_limit),
-    _fragmentation_limit(page_size * (ZFragmentationLimit / 100)),
+    _fragmentation_limit_percent(fragmentation_limit),
+    _fragmentation_limit(page_size * (fragmentation_limit / 100)),
     _registered_pages(),
     _sorted_pages(NULL),
     _nselected(0),
+    _ndeferred(0),
     _relocating(0),
     _fragmentation(0) {}
 
@@ -55,48 +70,247 @@ void ZRelocationSetSelectorGroup::register_live_page(ZPage* page, size_t garbage
   }
 }
 
-void ZRelocationSetSelectorGroup::semi_sort() {
+static void merge_pages(ZArray<ZPage*>* to, ZArray<ZPage*>* from) {
+  ZArrayIterator<ZPage*> iter(from);
+  for (ZPage* page; iter.next(&page);) {
+    to->add(page);
+  }
+}
+
+void ZRelocationSetSelectorGroup::merge(ZRelocationSetSelectorGroup* other) {
+  assert(_sorted_pages == NULL && other->_sorted_pages == NULL, "Already selected");
+  merge_pages(&_registered_pages, &other->_registered_pages);
+  _fragmentation += other->_fragmentation;
+}
+
+// Pages are semi-sorted by live bytes using a counting sort. The pages
+// are split into chunks, which are counted and distributed independently,
+// in parallel by the workers when there are enough pages. The partition
+// fingers of each chunk follow those of the preceding chunks, so the result
+// is the same as for a serial sort.
+class ZRelocationSetSemiSort : public StackObj {
+private:
+  static const size_t min_npartitions_shift = 11;
+  static const size_t max_npartitions_shift = 13;
+  static const size_t min_chunk_size        = 1024;
+  static const size_t max_nchunks           = 16;
+
+  const ZArray<ZPage*>* const _pages;
+  ZPage** const               _sorted_pages;
+  size_t                      _npartitions;
+  size_t                      _partition_size_shift;
+  size_t                      _nchunks;
+  size_t                      _chunk_size;
+  size_t*                     _partitions;
+  volatile size_t             _claimed;
+
+  size_t* partitions(size_t chunk) const {
+    return _partitions + chunk * _npartitions;
+  }
+
+  size_t partition_index(const ZPage* page) const {
+    const size_t index = page->live_bytes() >> _partition_size_shift;
+    assert(index < _npartitions, "Invalid partition");
+    return index;
+  }
+
+  size_t chunk_start(size_t chunk) const {
+    return MIN2(chunk * _chunk_size, _pages->size());
+  }
+
+  size_t chunk_end(size_t chunk) const {
+    return chunk_start(chunk + 1);
+  }
+
+public:
+  ZRelocationSetSemiSort(const ZArray<ZPage*>* pages, size_t page_size, ZPage** sorted_pages, uint nworkers) :
+      _pages(pages),
+      _sorted_pages(sorted_pages),
+      _npartitions(0),
+      _partition_size_shift(0),
+      _nchunks(0),
+      _chunk_size(0),
+      _partitions(NULL),
+      _claimed(0) {
+    const size_t npages = pages->size();
+
+    // The number of partitions grows with the number of pages, but each
+    // partition covers at least one object alignment unit. The page size
+    // is rounded up, so that large medium pages keep the same precision.
+    const size_t page_size_shift = log2_intptr(round_up_power_of_2(page_size));
+    const size_t npages_shift = log2_intptr(round_up_power_of_2(MAX2(npages, (size_t)1)));
+    const size_t npartitions_shift = MIN2(clamp(npages_shift + 1, min_npartitions_shift, max_npartitions_shift),
+                                          page_size_shift - LogMinObjAlignmentInBytes);
+    _npartitions = (size_t)1 << npartitions_shift;
+    _partition_size_shift = page_size_shift - npartitions_shift;
+
+    // Use one chunk per worker, unless the chunks would be too small
+    _nchunks = clamp(npages / min_chunk_size, (size_t)1, MIN2((size_t)nworkers, max_nchunks));
+    _chunk_size = (npages + _nchunks - 1) / _nchunks;
+
+    _partitions = NEW_C_HEAP_ARRAY(size_t, _nchunks * _npartitions, mtGC);
+    memset(_partitions, 0, _nchunks * _npartitions * sizeof(size_t));
+  }
+
+  ~ZRelocationSetSemiSort() {
+    FREE_C_HEAP_ARRAY(size_t, _partitions);
+  }
+
+  size_t nchunks() const {
+    return _nchunks;
+  }
+
+  bool claim_chunk(size_t* chunk) {
+    const size_t claimed = Atomic::add(&_claimed, (size_t)1) - 1;
+    if (claimed >= _nchunks) {
+      return false;
+    }
+
+    *chunk = claimed;
+    return true;
+  }
+
+  void reset_claimed() {
+    _claimed = 0;
+  }
+
+  void count(size_t chunk) {
+    // Calculate partition slots
+    size_t* const slots = partitions(chunk);
+    for (size_t i = chunk_start(chunk); i < chunk_end(chunk); i++) {
+      slots[partition_index(_pages->at(i))]++;
+    }
+  }
+
+  void calculate_fingers() {
+    // Calculate partition fingers, ordered by partition and then by chunk
+    size_t finger = 0;
+    for (size_t i = 0; i < _npartitions; i++) {
+      for (size_t chunk = 0; chunk < _nchunks; chunk++) {
+        size_t* const slot = partitions(chunk) + i;
+        const size_t nslots = *slot;
+        *slot = finger;
+        finger += nslots;
+      }
+    }
+
+    assert(finger == _pages->size(), "Invalid fingers");
+  }
+
+  void distribute(size_t chunk) {
+    // Sort pages into partitions
+    size_t* const fingers = partitions(chunk);
+    for (size_t i = chunk_start(chunk); i < chunk_end(chunk); i++) {
+      ZPage* const page = _pages->at(i);
+      const size_t finger = fingers[partition_index(page)]++;
+      assert(_sorted_pages[finger] == NULL, "Invalid finger");
+      _sorted_pages[finger] = page;
+    }
+  }
+};
+
+class ZRelocationSetSemiSortTask : public ZTask {
+private:
+  ZRelocationSetSemiSort* const _sort;
+  const bool                    _distribute;
+
+public:
+  ZRelocationSetSemiSortTask(ZRelocationSetSemiSort* sort, bool distribute) :
+      ZTask("ZRelocationSetSemiSortTask"),
+      _sort(sort),
+      _distribute(distribute) {}
+
+  virtual void work() {
+    for (size_t chunk; _sort->claim_chunk(&chunk);) {
+      if (_distribute) {
+        _sort->distribute(chunk);
+      } else {
+        _sort->count(chunk);
+      }
+    }
+  }
+};
+
+void ZRelocationSetSelectorGroup::semi_sort(ZWorkers* workers) {
   // Semi-sort registered pages by live bytes in ascending order
-  const size_t npartitions_shift = 11;
-  const size_t npartitions = (size_t)1 << npartitions_shift;
-  const size_t partition_size = _page_size >> npartitions_shift;
-  const size_t partition_size_shift = exact_log2(partition_size);
   const size_t npages = _registered_pages.size();
 
-  // Partition slots/fingers
-  size_t partitions[npartitions];
-
   // Allocate destination array
   _sorted_pages = REALLOC_C_HEAP_ARRAY(ZPage*, _sorted_pages, npages, mtGC);
   debug_only(memset(_sorted_pages, 0, npages * sizeof(ZPage*)));
 
-  // Calculate partition slots
-  memset(partitions, 0, sizeof(partitions));
-  ZArrayIterator<ZPage*> iter1(&_registered_pages);
-  for (ZPage* page; iter1.next(&page);) {
-    const size_t index = page->live_bytes() >> partition_size_shift;
-    partitions[index]++;
+  const uint nworkers = (workers != NULL) ? workers->nconcurrent() : 1;
+  ZRelocationSetSemiSort sort(&_registered_pages, _page_size, _sorted_pages, nworkers);
+
+  if (sort.nchunks() == 1) {
+    // Serial sort
+    sort.count(0);
+    sort.calculate_fingers();
+    sort.distribute(0);
+    return;
+  }
+
+  // Parallel sort
+  {
+    ZRelocationSetSemiSortTask task(&sort, false /* distribute */);
+    workers->run_concurrent(&task);
+  }
+
+  sort.calculate_fingers();
+  sort.reset_claimed();
+
+  {
+    ZRelocationSetSemiSortTask task(&sort, true /* distribute */);
+    workers->run_concurrent(&task);
   }
+}
 
-  // Calculate partition fingers
-  size_t finger = 0;
-  for (size_t i = 0; i < npartitions; i++) {
-    const size_t slots = partitions[i];
-    partitions[i] = finger;
-    finger += slots;
+static double relocation_cost_per_reclaimed_byte(ZPage* page) {
+  // The cost of relocating a page is dominated by copying its live bytes
+  // and by the per-object work, such as forwarding table insertions.
+  const double cost = (double)page->live_bytes() + (double)page->live_objects() * ZRelocationCostPerObject;
+
+  // Garbage on young pages tends to keep growing if left alone, since
+  // recently allocated objects are more likely to die soon. Discount
+  // the garbage on such pages, to favor relocating older pages.
+  const double age = (double)page->age();
+  double reclaimed = (double)(page->size() - page->live_bytes()) * (age / (age + 1.0));
+
+  // Objects on hot pages are in active use, so relocating them is more
+  // likely to put mutators on the relocation slow path. When sampled,
+  // discount the garbage on hot pages by up to half, to favor relocating
+  // cold pages.
+  if (page->has_hotness()) {
+    reclaimed *= 1.0 - (double)page->hotness() / 200.0;
   }
 
-  // Sort pages into partitions
-  ZArrayIterator<ZPage*> iter2(&_registered_pages);
-  for (ZPage* page; iter2.next(&page);) {
-    const size_t index = page->live_bytes() >> partition_size_shift;
-    const size_t finger = partitions[index]++;
-    assert(_sorted_pages[finger] == NULL, "Invalid finger");
-    _sorted_pages[finger] = page;
+  return cost / reclaimed;
+}
+
+static int compare_relocation_cost(ZPage* a, ZPage* b) {
+  const double cost_a = relocation_cost_per_reclaimed_byte(a);
+  const double cost_b = relocation_cost_per_reclaimed_byte(b);
+  return (cost_a < cost_b) ? -1 : ((cost_a > cost_b) ? 1 : 0);
+}
+
+void ZRelocationSetSelectorGroup::cost_sort() {
+  // Sort registered pages by relocation cost per reclaimed byte in ascending order
+  const size_t npages = _registered_pages.size();
+
+  // Allocate destination array
+  _sorted_pages = REALLOC_C_HEAP_ARRAY(ZPage*, _sorted_pages, npages, mtGC);
+
+  // Copy and sort pages
+  size_t i = 0;
+  ZArrayIterator<ZPage*> iter(&_registered_pages);
+  for (ZPage* page; iter.next(&page);) {
+    _sorted_pages[i++] = page;
   }
+
+  QuickSort::sort(_sorted_pages, npages, compare_relocation_cost, false /* idempotent */);
 }
 
-void ZRelocationSetSelectorGroup::select() {
+void ZRelocationSetSelectorGroup::select(ZWorkers* workers, size_t* budget) {
   if (_page_size == 0) {
     // Page type disabled
     return;
@@ -111,11 +325,22 @@ void ZRelocationSetSelectorGroup::select() {
   size_t selected_from_size = 0;
   size_t from_size = 0;
 
-  semi_sort();
+  if (ZRelocationCostModel) {
+    cost_sort();
+  } else {
+    semi_sort(workers);
+  }
 
   for (size_t from = 1; from <= npages; from++) {
     // Add page to the candidate relocation set
     from_size += _sorted_pages[from - 1]->live_bytes();
+    if (from_size > *budget) {
+      // Relocation budget exhausted, defer the remaining pages
+      _ndeferred = npages - (from - 1);
+      log_trace(gc, reloc)("Candidate Relocation Set (%s Pages): " SIZE_FORMAT ", budget exhausted",
+                           _name, from);
+      break;
+    }
 
     // Calculate the maximum number of pages needed by the candidate relocation set.
     // By subtracting the object size limit from the pages size we get the maximum
@@ -130,7 +355,7 @@ void ZRelocationSetSelectorGroup::select() {
     const size_t diff_from = from - selected_from;
     const size_t diff_to = to - selected_to;
     const double diff_reclaimable = 100 - percent_of(diff_to, diff_from);
-    if (diff_reclaimable > ZFragmentationLimit) {
+    if (diff_reclaimable > _fragmentation_limit_percent) {
       selected_from = from;
       selected_to = to;
       selected_from_size = from_size;
@@ -144,6 +369,9 @@ void ZRelocationSetSelectorGroup::select() {
   // Finalize selection
   _nselected = selected_from;
 
+  // Update budget
+  *budget -= selected_from_size;
+
   // Update statistics
   _relocating = selected_from_size;
   for (size_t i = _nselected; i < npages; i++) {
@@ -163,20 +391,57 @@ size_t ZRelocationSetSelectorGroup::nselected() const {
   return _nselected;
 }
 
+size_t ZRelocationSetSelectorGroup::ndeferred() const {
+  return _ndeferred;
+}
+
 size_t ZRelocationSetSelectorGroup::relocating() const {
   return _relocating;
 }
 
+size_t ZRelocationSetSelectorGroup::reclaimable() const {
+  // Memory freed by relocating the selected pages
+  return (_nselected * _page_size) - _relocating;
+}
+
 size_t ZRelocationSetSelectorGroup::fragmentation() const {
   return _fragmentation;
 }
 
-ZRelocationSetSelector::ZRelocationSetSelector() :
-    _small("Small", ZPageSizeSmall, ZObjectSizeLimitSmall),
-    _medium("Medium", ZPageSizeMedium, ZObjectSizeLimitMedium),
+// An aggressive selection, used by explicit GCs, accepts a lower fragmentation
+// limit and ignores the relocation budget, to compact the heap as much as
+// possible, at the cost of relocating more objects.
+
+static double fragmentation_limit(bool aggressive) {
+  return aggressive ? MIN2(ZExplicitGCFragmentationLimit, ZFragmentationLimit) : ZFragmentationLimit;
+}
+
+ZRelocationSetSelector::ZRelocationSetSelector(bool aggressive) :
+    _small("Small", ZPageSizeSmall, ZObjectSizeLimitSmall, fragmentation_limit(aggressive)),
+    _medium("Medium", ZPageSizeMedium, ZObjectSizeLimitMedium, fragmentation_limit(aggressive)),
+    _remap(),
+    _forced(),
+    _forced_relocating(0),
     _live(0),
+    _live_tenured(0),
     _garbage(0),
-    _fragmentation(0) {}
+    _fragmentation(0),
+    _aggressive(aggressive) {
+  for (size_t i = 0; i < ZObjectAgeTableSize; i++) {
+    _live_by_age[i] = 0;
+  }
+}
+
+void ZRelocationSetSelector::register_live(ZPage* page, size_t live) {
+  const size_t age = MIN2((size_t)page->object_age(), ZObjectAgeTableSize - 1);
+
+  _live += live;
+  _live_by_age[age] += live;
+
+  if (page->is_tenured()) {
+    _live_tenured += live;
+  }
+}
 
 void ZRelocationSetSelector::register_live_page(ZPage* page) {
   const uint8_t type = page->type();
@@ -191,7 +456,18 @@ void ZRelocationSetSelector::register_live_page(ZPage* page) {
     _fragmentation += garbage;
   }
 
-  _live += live;
+  register_live(page, live);
+  _garbage += garbage;
+}
+
+void ZRelocationSetSelector::register_pinned_page(ZPage* page) {
+  const size_t live = page->live_bytes();
+  const size_t garbage = page->size() - live;
+
+  // Pinned pages are not relocation candidates, so their garbage
+  // is left as fragmentation until they are unpinned
+  _fragmentation += garbage;
+  register_live(page, live);
   _garbage += garbage;
 }
 
@@ -199,34 +475,167 @@ void ZRelocationSetSelector::register_garbage_page(ZPage* page) {
   _garbage += page->size();
 }
 
-void ZRelocationSetSelector::select(ZRelocationSet* relocation_set) {
+void ZRelocationSetSelector::register_remap_page(ZPage* page) {
+  assert(page->type() == ZPageTypeLarge, "Invalid page type");
+
+  // Large pages are relocated by remapping their physical memory at a new
+  // address. This doesn't involve copying, so they don't count as relocating
+  // bytes, and are not part of the relocation budget. The page has already
+  // been registered as a live page.
+  _remap.add(page);
+}
+
+void ZRelocationSetSelector::register_forced_page(ZPage* page) {
+  if (page->type() == ZPageTypeLarge) {
+    // Large pages are only relocated by remapping
+    log_debug(gc, reloc)("Forced relocation of large page ignored: " PTR_FORMAT, page->start());
+    return;
+  }
+
+  // The page has already been registered as a live page
+  _forced.add(page);
+  _forced_relocating += page->live_bytes();
+}
+
+void ZRelocationSetSelector::merge(ZRelocationSetSelector* other) {
+  // Merge pages registered with another selector, used when pages
+  // are registered in parallel by multiple threads
+  assert(_aggressive == other->_aggressive, "Invalid selector");
+  _small.merge(&other->_small);
+  _medium.merge(&other->_medium);
+  merge_pages(&_remap, &other->_remap);
+  merge_pages(&_forced, &other->_forced);
+  _forced_relocating += other->_forced_relocating;
+  _live += other->_live;
+  _live_tenured += other->_live_tenured;
+  for (size_t i = 0; i < ZObjectAgeTableSize; i++) {
+    _live_by_age[i] += other->_live_by_age[i];
+  }
+  _garbage += other->_garbage;
+  _fragmentation += other->_fragmentation;
+}
+
+size_t ZRelocationSetSelector::relocation_budget() const {
+  if (_aggressive) {
+    // Not limited
+    return SIZE_MAX;
+  }
+
+  size_t budget = (ZRelocationLimit > 0) ? ZRelocationLimit : SIZE_MAX;
+
+  if (ZRelocationTimeLimit > 0 && ZStatRelocation::is_throughput_trustable()) {
+    // Limit the number of live bytes to what is expected to be relocated
+    // within the time limit, based on the throughput of previous cycles.
+    // At least a small page worth of live bytes is always allowed, so that
+    // relocation keeps making progress even if the throughput is very low.
+    const double projected = ZStatRelocation::throughput() * ZRelocationTimeLimit;
+    budget = MIN2(budget, MAX2((size_t)projected, ZPageSizeSmall));
+  }
+
+  return budget;
+}
+
+void ZRelocationSetSelector::select(ZWorkers* workers, ZRelocationSet* relocation_set) {
+  if (!_forced.is_empty()) {
+    // Relocate exactly the pages requested through WhiteBox, which
+    // gives benchmarks and tests a fixed relocation set
+    log_info(gc, reloc)("Relocation Set: " SIZE_FORMAT " forced pages", _forced.size());
+
+    const ZArray<ZPage*> none;
+    relocation_set->populate(_forced.addr(0), _forced.size(),
+                             NULL, 0,
+                             &none);
+
+    ZTracer::tracer()->report_relocation_set(*this);
+    return;
+  }
+
   // Select pages to relocate. The resulting relocation set will be
   // sorted such that medium pages comes first, followed by small
-  // pages. Pages within each page group will be semi-sorted by live
-  // bytes in ascending order. Relocating pages in this order allows
-  // us to start reclaiming memory more quickly.
+  // pages, followed by large pages to be remapped. Pages within each
+  // page group will be sorted by relocation cost per reclaimed byte,
+  // or semi-sorted by live bytes, in ascending order. Relocating pages
+  // in this order allows us to start reclaiming memory more quickly.
+
+  // Limit the number of live bytes to relocate, if requested. Since
+  // pages are selected in order of increasing cost, only the pages
+  // that are cheapest to relocate are selected when the limit is hit.
+  const size_t initial_budget = relocation_budget();
+  size_t budget = initial_budget;
 
   // Select pages from each group
-  _medium.select();
-  _small.select();
+  _medium.select(workers, &budget);
+  _small.select(workers, &budget);
+
+  const size_t ndeferred = _medium.ndeferred() + _small.ndeferred();
+  if (ndeferred > 0) {
+    // The deferred pages are registered again in the next cycle, if they
+    // are still live. Their garbage is then discounted less, since they
+    // are older, which makes them more likely to be selected.
+    log_info(gc, reloc)("Relocation Budget: " SIZE_FORMAT "M, " SIZE_FORMAT " pages deferred to next cycle",
+                        initial_budget / M, ndeferred);
+  }
 
   // Populate relocation set
   relocation_set->populate(_medium.selected(), _medium.nselected(),
-                           _small.selected(), _small.nselected());
+                           _small.selected(), _small.nselected(),
+                           &_remap);
+
+  // Send event
+  ZTracer::tracer()->report_relocation_set(*this);
+}
+
+const ZRelocationSetSelectorGroup& ZRelocationSetSelector::small() const {
+  return _small;
+}
+
+const ZRelocationSetSelectorGroup& ZRelocationSetSelector::medium() const {
+  return _medium;
+}
+
+bool ZRelocationSetSelector::is_aggressive() const {
+  return _aggressive;
+}
+
+size_t ZRelocationSetSelector::nremapped() const {
+  return _remap.size();
 }
 
 size_t ZRelocationSetSelector::live() const {
   return _live;
 }
 
+size_t ZRelocationSetSelector::live_tenured() const {
+  return _live_tenured;
+}
+
+const size_t* ZRelocationSetSelector::live_by_age() const {
+  // Live bytes indexed by the object age of their pages, where
+  // the last entry also includes all older pages
+  return _live_by_age;
+}
+
 size_t ZRelocationSetSelector::garbage() const {
   return _garbage;
 }
 
 size_t ZRelocationSetSelector::relocating() const {
+  if (!_forced.is_empty()) {
+    return _forced_relocating;
+  }
+
   return _small.relocating() + _medium.relocating();
 }
 
+size_t ZRelocationSetSelector::reclaimable() const {
+  if (!_forced.is_empty()) {
+    // Unknown, but requested
+    return SIZE_MAX;
+  }
+
+  return _small.reclaimable() + _medium.reclaimable();
+}
+
 size_t ZRelocationSetSelector::fragmentation() const {
   return _fragmentation + _small.fragmentation() + _medium.fragmentation();
 }
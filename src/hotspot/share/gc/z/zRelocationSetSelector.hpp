@@ -25,38 +25,47 @@
 #define SHARE_GC_Z_ZRELOCATIONSETSELECTOR_HPP
 
 #include "gc/z/zArray.hpp"
+#include "gc/z/zGlobals.hpp"
 #include "memory/allocation.hpp"
 
 class ZPage;
 class ZRelocationSet;
+class ZWorkers;
 
 class ZRelocationSetSelectorGroup {
 private:
   const char* const _name;
   const size_t      _page_size;
   const size_t      _object_size_limit;
+  const double      _fragmentation_limit_percent;
   const size_t      _fragmentation_limit;
 
   ZArray<ZPage*>    _registered_pages;
   ZPage**           _sorted_pages;
   size_t            _nselected;
+  size_t            _ndeferred;
   size_t            _relocating;
   size_t            _fragmentation;
 
-  void semi_sort();
+  void semi_sort(ZWorkers* workers);
+  void cost_sort();
 
 public:
   ZRelocationSetSelectorGroup(const char* name,
                               size_t page_size,
-                              size_t object_size_limit);
+                              size_t object_size_limit,
+                              double fragmentation_limit);
   ~ZRelocationSetSelectorGroup();
 
   void register_live_page(ZPage* page, size_t garbage);
-  void select();
+  void merge(ZRelocationSetSelectorGroup* other);
+  void select(ZWorkers* workers, size_t* budget);
 
   ZPage* const* selected() const;
   size_t nselected() const;
+  size_t ndeferred() const;
   size_t relocating() const;
+  size_t reclaimable() const;
   size_t fragmentation() const;
 };
 
@@ -64,20 +73,42 @@ class ZRelocationSetSelector : public StackObj {
 private:
   ZRelocationSetSelectorGroup _small;
   ZRelocationSetSelectorGroup _medium;
+  ZArray<ZPage*>              _remap;
+  ZArray<ZPage*>              _forced;
+  size_t                      _forced_relocating;
   size_t                      _live;
+  size_t                      _live_tenured;
+  size_t                      _live_by_age[ZObjectAgeTableSize];
   size_t                      _garbage;
   size_t                      _fragmentation;
+  const bool                  _aggressive;
+
+  size_t relocation_budget() const;
+  void register_live(ZPage* page, size_t live);
 
 public:
-  ZRelocationSetSelector();
+  ZRelocationSetSelector(bool aggressive);
 
   void register_live_page(ZPage* page);
+  void register_pinned_page(ZPage* page);
   void register_garbage_page(ZPage* page);
-  void select(ZRelocationSet* relocation_set);
+  void register_remap_page(ZPage* page);
+  void register_forced_page(ZPage* page);
+  void merge(ZRelocationSetSelector* other);
+  void select(ZWorkers* workers, ZRelocationSet* relocation_set);
+
+  bool is_aggressive() const;
+
+  const ZRelocationSetSelectorGroup& small() const;
+  const ZRelocationSetSelectorGroup& medium() const;
+  size_t nremapped() const;
 
   size_t live() const;
+  size_t live_tenured() const;
+  const size_t* live_by_age() const;
   size_t garbage() const;
   size_t relocating() const;
+  size_t reclaimable() const;
   size_t fragmentation() const;
 };
 
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zBarrier.inline.hpp"
+#include "gc/z/zPage.inline.hpp"
+#include "gc/z/zPageTable.inline.hpp"
+#include "gc/z/zRemap.hpp"
+#include "gc/z/zTask.hpp"
+#include "gc/z/zWorkers.hpp"
+#include "logging/log.hpp"
+#include "memory/iterator.inline.hpp"
+#include "oops/oop.inline.hpp"
+#include "runtime/atomic.hpp"
+
+class ZRemapOopClosure : public BasicOopIterateClosure {
+public:
+  virtual ReferenceIterationMode reference_iteration_mode() {
+    // Referents of live references can point to objects which were
+    // not marked, and therefore not relocated, so leave them alone
+    return DO_FIELDS_EXCEPT_REFERENT;
+  }
+
+  virtual void do_oop(oop* p) {
+    ZBarrier::load_barrier_on_oop_field(p);
+  }
+
+  virtual void do_oop(narrowOop* p) {
+    ShouldNotReachHere();
+  }
+
+#ifdef ASSERT
+  virtual bool should_verify_oops() {
+    return false;
+  }
+#endif
+};
+
+class ZRemapObjectClosure : public ObjectClosure {
+private:
+  ZRemapOopClosure _cl;
+
+public:
+  virtual void do_object(oop obj) {
+    obj->oop_iterate(&_cl);
+  }
+};
+
+class ZRemapPageClosure : public StackObj {
+private:
+  const volatile bool* const _aborted;
+  ZRemapObjectClosure        _cl;
+  size_t                     _npages;
+
+public:
+  ZRemapPageClosure(const volatile bool* aborted) :
+      _aborted(aborted),
+      _cl(),
+      _npages(0) {}
+
+  void do_page(ZPage* page) {
+    if (Atomic::load(_aborted)) {
+      // Aborted, skip remaining pages
+      return;
+    }
+
+    if (!page->is_relocatable() || !page->is_marked()) {
+      // Only pages marked in the last cycle, and not relocated,
+      // have a live map which can be used to find their objects
+      return;
+    }
+
+    page->object_iterate(&_cl);
+    _npages++;
+  }
+
+  size_t npages() const {
+    return _npages;
+  }
+};
+
+class ZRemapTask : public ZTask {
+private:
+  ZPageTableParallelIterator _iter;
+  const volatile bool* const _aborted;
+  volatile size_t            _npages;
+
+public:
+  ZRemapTask(const ZPageTable* page_table, const volatile bool* aborted) :
+      ZTask("ZRemapTask"),
+      _iter(page_table),
+      _aborted(aborted),
+      _npages(0) {}
+
+  virtual void work() {
+    ZRemapPageClosure cl(_aborted);
+    _iter.pages_do(&cl);
+    Atomic::add(&_npages, cl.npages());
+  }
+
+  size_t npages() const {
+    return _npages;
+  }
+};
+
+ZRemap::ZRemap(ZWorkers* workers) :
+    _workers(workers),
+    _aborted(false) {}
+
+void ZRemap::reset() {
+  // GC cycles requested after this point are started
+  // after the remapping, so they should abort it
+  Atomic::store(&_aborted, false);
+}
+
+void ZRemap::remap(const ZPageTable* page_table) {
+  ZRemapTask task(page_table, &_aborted);
+  _workers->run_concurrent(&task);
+
+  log_debug(gc, reloc)("Remapped " SIZE_FORMAT " pages%s",
+                       task.npages(), Atomic::load(&_aborted) ? " (Aborted)" : "");
+}
+
+void ZRemap::abort() {
+  // The remaining stale pointers are remapped by the next mark
+  Atomic::store(&_aborted, true);
+}
@@ -23,15 +23,20 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zResurrection.hpp"
+#include "gc/z/zStat.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/safepoint.hpp"
 #include "utilities/debug.hpp"
 
+static const ZStatSampler ZSamplerResurrectionBlocked("Resurrection", "Blocked", ZStatUnitTime);
+
 volatile bool ZResurrection::_blocked = false;
+Ticks         ZResurrection::_blocked_start;
 
 void ZResurrection::block() {
   assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
   _blocked = true;
+  _blocked_start = Ticks::now();
 }
 
 void ZResurrection::unblock() {
@@ -39,4 +44,8 @@ void ZResurrection::unblock() {
   // The preceeding handshake makes sure that all non-strong
   // oops have already been healed at this point.
   Atomic::store(&_blocked, false);
+
+  // Weak and phantom loads take their slow paths for as long as
+  // resurrection is blocked, so the length of the window is sampled.
+  ZStatSample(ZSamplerResurrectionBlocked, (Ticks::now() - _blocked_start).value());
 }
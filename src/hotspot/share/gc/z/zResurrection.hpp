@@ -25,10 +25,12 @@
 #define SHARE_GC_Z_ZRESURRECTION_HPP
 
 #include "memory/allocation.hpp"
+#include "utilities/ticks.hpp"
 
 class ZResurrection : public AllStatic {
 private:
   static volatile bool _blocked;
+  static Ticks         _blocked_start;
 
 public:
   static bool is_blocked();
@@ -46,6 +46,8 @@
 #include "prims/resolvedMethodTable.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/thread.hpp"
+#include "runtime/threadSMR.inline.hpp"
+#include "runtime/vmThread.hpp"
 #include "runtime/safepoint.hpp"
 #include "runtime/synchronizer.hpp"
 #include "services/management.hpp"
@@ -64,7 +66,6 @@ static const ZStatSubPhase ZSubPhasePauseRootsJVMTIExport("Pause Roots JVMTIExpo
 static const ZStatSubPhase ZSubPhasePauseRootsJVMTIWeakExport("Pause Roots JVMTIWeakExport");
 static const ZStatSubPhase ZSubPhasePauseRootsSystemDictionary("Pause Roots SystemDictionary");
 static const ZStatSubPhase ZSubPhasePauseRootsThreads("Pause Roots Threads");
-static const ZStatSubPhase ZSubPhasePauseRootsCodeCache("Pause Roots CodeCache");
 
 static const ZStatSubPhase ZSubPhaseConcurrentRootsSetup("Concurrent Roots Setup");
 static const ZStatSubPhase ZSubPhaseConcurrentRoots("Concurrent Roots");
@@ -72,6 +73,7 @@ static const ZStatSubPhase ZSubPhaseConcurrentRootsTeardown("Concurrent Roots Te
 static const ZStatSubPhase ZSubPhaseConcurrentRootsJNIHandles("Concurrent Roots JNIHandles");
 static const ZStatSubPhase ZSubPhaseConcurrentRootsVMHandles("Concurrent Roots VMHandles");
 static const ZStatSubPhase ZSubPhaseConcurrentRootsClassLoaderDataGraph("Concurrent Roots ClassLoaderDataGraph");
+static const ZStatSubPhase ZSubPhaseConcurrentRootsCodeCache("Concurrent Roots CodeCache");
 
 static const ZStatSubPhase ZSubPhasePauseWeakRootsSetup("Pause Weak Roots Setup");
 static const ZStatSubPhase ZSubPhasePauseWeakRoots("Pause Weak Roots");
@@ -172,40 +174,33 @@ public:
 
   virtual void do_thread(Thread* thread) {
     ZRootsIteratorCodeBlobClosure code_cl(_cl);
-    thread->oops_do(_cl, ClassUnloading ? &code_cl : NULL);
+    thread->oops_do(_cl, &code_cl);
     _cl->do_thread(thread);
   }
 };
 
 ZRootsIterator::ZRootsIterator(bool visit_jvmti_weak_export) :
     _visit_jvmti_weak_export(visit_jvmti_weak_export),
+    _java_threads(),
+    _java_threads_claimed(0),
     _universe(this),
     _object_synchronizer(this),
     _management(this),
     _jvmti_export(this),
     _jvmti_weak_export(this),
     _system_dictionary(this),
-    _threads(this),
-    _code_cache(this) {
+    _threads(this) {
   assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
   ZStatTimer timer(ZSubPhasePauseRootsSetup);
   Threads::change_thread_claim_token();
   COMPILER2_PRESENT(DerivedPointerTable::clear());
-  if (ClassUnloading) {
-    nmethod::oops_do_marking_prologue();
-  } else {
-    ZNMethod::oops_do_begin();
-  }
+  nmethod::oops_do_marking_prologue();
 }
 
 ZRootsIterator::~ZRootsIterator() {
   ZStatTimer timer(ZSubPhasePauseRootsTeardown);
   ResourceMark rm;
-  if (ClassUnloading) {
-    nmethod::oops_do_marking_epilogue();
-  } else {
-    ZNMethod::oops_do_end();
-  }
+  nmethod::oops_do_marking_epilogue();
 
   COMPILER2_PRESENT(DerivedPointerTable::update_pointers());
   Threads::assert_all_threads_claimed();
@@ -243,47 +238,72 @@ void ZRootsIterator::do_system_dictionary(ZRootsIteratorClosure* cl) {
   SystemDictionary::oops_do(cl, false /* include_handles */);
 }
 
+bool ZRootsIterator::claim_thread(Thread** thread) {
+  // Threads are claimed by index into the threads list, rather than by
+  // having every worker walk all threads and race to claim each thread.
+  // The VM thread is claimed last, by the index just past the list.
+  const uint length = _java_threads.length();
+  const uint index = Atomic::add(&_java_threads_claimed, 1u) - 1;
+  if (index > length) {
+    // All threads claimed
+    return false;
+  }
+
+  *thread = (index < length) ? (Thread*)_java_threads.list()->thread_at(index) : (Thread*)VMThread::vm_thread();
+
+  // Also set the thread claim token, which is verified after iteration
+  const bool claimed = (*thread)->claim_threads_do(true /* is_par */, Threads::thread_claim_token());
+  assert(claimed, "Should be claimed");
+
+  return true;
+}
+
 void ZRootsIterator::do_threads(ZRootsIteratorClosure* cl) {
   ZStatTimer timer(ZSubPhasePauseRootsThreads);
   ResourceMark rm;
   ZRootsIteratorThreadClosure thread_cl(cl);
-  Threads::possibly_parallel_threads_do(true, &thread_cl);
-}
-
-void ZRootsIterator::do_code_cache(ZRootsIteratorClosure* cl) {
-  ZStatTimer timer(ZSubPhasePauseRootsCodeCache);
-  ZNMethod::oops_do(cl);
+  for (Thread* thread; claim_thread(&thread);) {
+    thread_cl.do_thread(thread);
+  }
 }
 
 void ZRootsIterator::oops_do(ZRootsIteratorClosure* cl) {
   ZStatTimer timer(ZSubPhasePauseRoots);
+  if (_visit_jvmti_weak_export) {
+    // Visited first, since the JVMTI tag map is processed by a single
+    // worker and can be large. This lets the other workers process the
+    // remaining roots in parallel with it, instead of after it.
+    _jvmti_weak_export.oops_do(cl);
+  }
   _universe.oops_do(cl);
   _object_synchronizer.oops_do(cl);
   _management.oops_do(cl);
   _jvmti_export.oops_do(cl);
   _system_dictionary.oops_do(cl);
   _threads.oops_do(cl);
-  if (!ClassUnloading) {
-    _code_cache.oops_do(cl);
-  }
-  if (_visit_jvmti_weak_export) {
-    _jvmti_weak_export.oops_do(cl);
-  }
 }
 
-ZConcurrentRootsIterator::ZConcurrentRootsIterator(int cld_claim) :
+ZConcurrentRootsIterator::ZConcurrentRootsIterator(int cld_claim, bool visit_code_cache) :
     _jni_handles_iter(OopStorageSet::jni_global()),
     _vm_handles_iter(OopStorageSet::vm_global()),
     _cld_claim(cld_claim),
+    _visit_code_cache(visit_code_cache),
     _jni_handles(this),
     _vm_handles(this),
-    _class_loader_data_graph(this) {
+    _class_loader_data_graph(this),
+    _code_cache(this) {
   ZStatTimer timer(ZSubPhaseConcurrentRootsSetup);
   ClassLoaderDataGraph::clear_claimed_marks(cld_claim);
+  if (_visit_code_cache) {
+    ZNMethod::oops_do_begin();
+  }
 }
 
 ZConcurrentRootsIterator::~ZConcurrentRootsIterator() {
   ZStatTimer timer(ZSubPhaseConcurrentRootsTeardown);
+  if (_visit_code_cache) {
+    ZNMethod::oops_do_end();
+  }
 }
 
 void ZConcurrentRootsIterator::do_jni_handles(ZRootsIteratorClosure* cl) {
@@ -302,11 +322,21 @@ void ZConcurrentRootsIterator::do_class_loader_data_graph(ZRootsIteratorClosure*
   ClassLoaderDataGraph::always_strong_cld_do(&cld_cl);
 }
 
+void ZConcurrentRootsIterator::do_code_cache(ZRootsIteratorClosure* cl) {
+  ZStatTimer timer(ZSubPhaseConcurrentRootsCodeCache);
+  // The oops are healed under the per-nmethod lock, in the same way as
+  // the nmethod entry barrier does, before being passed to the closure
+  ZNMethod::oops_do_concurrent(cl);
+}
+
 void ZConcurrentRootsIterator::oops_do(ZRootsIteratorClosure* cl) {
   ZStatTimer timer(ZSubPhaseConcurrentRoots);
   _jni_handles.oops_do(cl);
   _vm_handles.oops_do(cl),
   _class_loader_data_graph.oops_do(cl);
+  if (_visit_code_cache) {
+    _code_cache.oops_do(cl);
+  }
 }
 
 ZWeakRootsIterator::ZWeakRootsIterator() :
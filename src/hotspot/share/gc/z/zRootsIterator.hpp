@@ -29,6 +29,7 @@
 #include "memory/allocation.hpp"
 #include "memory/iterator.hpp"
 #include "runtime/thread.hpp"
+#include "runtime/threadSMR.hpp"
 #include "utilities/globalDefinitions.hpp"
 
 class ZRootsIteratorClosure;
@@ -90,7 +91,11 @@ public:
 
 class ZRootsIterator {
 private:
-  const bool _visit_jvmti_weak_export;
+  const bool        _visit_jvmti_weak_export;
+  ThreadsListHandle _java_threads;
+  volatile uint     _java_threads_claimed;
+
+  bool claim_thread(Thread** thread);
 
   void do_universe(ZRootsIteratorClosure* cl);
   void do_object_synchronizer(ZRootsIteratorClosure* cl);
@@ -99,7 +104,6 @@ private:
   void do_jvmti_weak_export(ZRootsIteratorClosure* cl);
   void do_system_dictionary(ZRootsIteratorClosure* cl);
   void do_threads(ZRootsIteratorClosure* cl);
-  void do_code_cache(ZRootsIteratorClosure* cl);
 
   ZSerialOopsDo<ZRootsIterator, &ZRootsIterator::do_universe>            _universe;
   ZSerialOopsDo<ZRootsIterator, &ZRootsIterator::do_object_synchronizer> _object_synchronizer;
@@ -108,7 +112,6 @@ private:
   ZSerialOopsDo<ZRootsIterator, &ZRootsIterator::do_jvmti_weak_export>   _jvmti_weak_export;
   ZSerialOopsDo<ZRootsIterator, &ZRootsIterator::do_system_dictionary>   _system_dictionary;
   ZParallelOopsDo<ZRootsIterator, &ZRootsIterator::do_threads>           _threads;
-  ZParallelOopsDo<ZRootsIterator, &ZRootsIterator::do_code_cache>        _code_cache;
 
 public:
   ZRootsIterator(bool visit_jvmti_weak_export = false);
@@ -122,17 +125,20 @@ private:
   ZOopStorageIterator _jni_handles_iter;
   ZOopStorageIterator _vm_handles_iter;
   const int           _cld_claim;
+  const bool          _visit_code_cache;
 
   void do_jni_handles(ZRootsIteratorClosure* cl);
   void do_vm_handles(ZRootsIteratorClosure* cl);
   void do_class_loader_data_graph(ZRootsIteratorClosure* cl);
+  void do_code_cache(ZRootsIteratorClosure* cl);
 
   ZParallelOopsDo<ZConcurrentRootsIterator, &ZConcurrentRootsIterator::do_jni_handles>             _jni_handles;
   ZParallelOopsDo<ZConcurrentRootsIterator, &ZConcurrentRootsIterator::do_vm_handles>              _vm_handles;
   ZParallelOopsDo<ZConcurrentRootsIterator, &ZConcurrentRootsIterator::do_class_loader_data_graph> _class_loader_data_graph;
+  ZParallelOopsDo<ZConcurrentRootsIterator, &ZConcurrentRootsIterator::do_code_cache>              _code_cache;
 
 public:
-  ZConcurrentRootsIterator(int cld_claim);
+  ZConcurrentRootsIterator(int cld_claim, bool visit_code_cache = false);
   ~ZConcurrentRootsIterator();
 
   void oops_do(ZRootsIteratorClosure* cl);
@@ -140,20 +146,21 @@ public:
 
 class ZConcurrentRootsIteratorClaimStrong : public ZConcurrentRootsIterator {
 public:
+  // Without class unloading, nmethod oops are strong roots
   ZConcurrentRootsIteratorClaimStrong() :
-      ZConcurrentRootsIterator(ClassLoaderData::_claim_strong) {}
+      ZConcurrentRootsIterator(ClassLoaderData::_claim_strong, !ClassUnloading /* visit_code_cache */) {}
 };
 
 class ZConcurrentRootsIteratorClaimOther : public ZConcurrentRootsIterator {
 public:
   ZConcurrentRootsIteratorClaimOther() :
-      ZConcurrentRootsIterator(ClassLoaderData::_claim_other) {}
+      ZConcurrentRootsIterator(ClassLoaderData::_claim_other, !ClassUnloading /* visit_code_cache */) {}
 };
 
 class ZConcurrentRootsIteratorClaimNone : public ZConcurrentRootsIterator {
 public:
   ZConcurrentRootsIteratorClaimNone() :
-      ZConcurrentRootsIterator(ClassLoaderData::_claim_none) {}
+      ZConcurrentRootsIterator(ClassLoaderData::_claim_none, !ClassUnloading /* visit_code_cache */) {}
 };
 
 class ZWeakRootsIterator {
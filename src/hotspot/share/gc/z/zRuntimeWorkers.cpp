@@ -25,7 +25,11 @@
 #include "gc/shared/workgroup.hpp"
 #include "gc/z/zRuntimeWorkers.hpp"
 #include "gc/z/zThread.hpp"
+#include "logging/log.hpp"
+#include "runtime/globals.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/safepoint.hpp"
+#include "runtime/thread.hpp"
 
 class ZRuntimeWorkersInitializeTask : public AbstractGangTask {
 private:
@@ -64,7 +68,14 @@ ZRuntimeWorkers::ZRuntimeWorkers() :
     _workers("RuntimeWorker",
              nworkers(),
              false /* are_GC_task_threads */,
-             false /* are_ConcurrentGC_threads */) {
+             false /* are_ConcurrentGC_threads */),
+    _nregistered(0) {
+
+  if (ZLazyRuntimeWorkers) {
+    // Worker threads are created on first use
+    log_info(gc, init)("Runtime Workers: %u parallel (lazy)", nworkers());
+    return;
+  }
 
   log_info(gc, init)("Runtime Workers: %u parallel", nworkers());
 
@@ -75,18 +86,40 @@ ZRuntimeWorkers::ZRuntimeWorkers() :
     vm_exit_during_initialization("Failed to create ZRuntimeWorkers");
   }
 
-  // Execute task to register threads as runtime workers. This also
-  // helps reduce latency in early safepoints, which otherwise would
-  // have to take on any warmup costs.
-  ZRuntimeWorkersInitializeTask task(nworkers());
-  _workers.run_task(&task);
+  // Register threads as runtime workers. This also helps reduce latency
+  // in early safepoints, which otherwise would have to take on any
+  // warmup costs.
+  register_workers();
 }
 
 uint ZRuntimeWorkers::nworkers() const {
   return ParallelGCThreads;
 }
 
+void ZRuntimeWorkers::register_workers() {
+  // Execute task to register threads as runtime workers
+  const uint nworkers = _workers.created_workers();
+  ZRuntimeWorkersInitializeTask task(nworkers);
+  _workers.run_task(&task, nworkers);
+  _nregistered = nworkers;
+}
+
 WorkGang* ZRuntimeWorkers::workers() {
+  if (_nregistered == 0) {
+    // Lazily created worker threads. All threads are created and
+    // registered on first use. Threads the work gang would otherwise
+    // create in the middle of a task would never be registered. This is
+    // only done by the VM thread at a safepoint, so there are no
+    // concurrent callers.
+    assert(ZLazyRuntimeWorkers, "Should be lazy");
+    assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
+    assert(Thread::current()->is_VM_thread(), "Should be VM thread");
+
+    _workers.initialize_workers();
+    _workers.update_active_workers(nworkers());
+    register_workers();
+  }
+
   return &_workers;
 }
 
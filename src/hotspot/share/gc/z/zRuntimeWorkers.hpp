@@ -31,8 +31,10 @@ class ThreadClosure;
 class ZRuntimeWorkers {
 private:
   WorkGang _workers;
+  uint     _nregistered;
 
   uint nworkers() const;
+  void register_workers();
 
 public:
   ZRuntimeWorkers();
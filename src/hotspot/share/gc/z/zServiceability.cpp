@@ -27,7 +27,9 @@
 #include "gc/z/zCollectedHeap.hpp"
 #include "gc/z/zHeap.inline.hpp"
 #include "gc/z/zServiceability.hpp"
+#include "gc/z/zStat.hpp"
 #include "memory/metaspaceCounters.hpp"
+#include "memory/resourceArea.hpp"
 #include "runtime/perfData.hpp"
 
 class ZGenerationCounters : public GenerationCounters {
@@ -42,12 +44,103 @@ public:
   }
 };
 
+static PerfVariable* create_perf_variable(const char* name_space, const char* name, PerfData::Units unit, TRAPS) {
+  ResourceMark rm;
+  return PerfDataManager::create_variable(SUN_GC, PerfDataManager::counter_name(name_space, name), unit, THREAD);
+}
+
+// Minimum mutator utilization, in hundredths of a percent
+class ZMMUCounters {
+private:
+  PerfVariable* _mmu_2ms;
+  PerfVariable* _mmu_5ms;
+  PerfVariable* _mmu_10ms;
+  PerfVariable* _mmu_20ms;
+  PerfVariable* _mmu_50ms;
+  PerfVariable* _mmu_100ms;
+
+  static void update(PerfVariable* counter, double mmu) {
+    counter->set_value((jlong)(mmu * 100));
+  }
+
+public:
+  ZMMUCounters() :
+      _mmu_2ms(NULL),
+      _mmu_5ms(NULL),
+      _mmu_10ms(NULL),
+      _mmu_20ms(NULL),
+      _mmu_50ms(NULL),
+      _mmu_100ms(NULL) {
+    if (UsePerfData) {
+      EXCEPTION_MARK;
+      _mmu_2ms   = create_perf_variable("z.mmu", "2ms",   PerfData::U_None, CHECK);
+      _mmu_5ms   = create_perf_variable("z.mmu", "5ms",   PerfData::U_None, CHECK);
+      _mmu_10ms  = create_perf_variable("z.mmu", "10ms",  PerfData::U_None, CHECK);
+      _mmu_20ms  = create_perf_variable("z.mmu", "20ms",  PerfData::U_None, CHECK);
+      _mmu_50ms  = create_perf_variable("z.mmu", "50ms",  PerfData::U_None, CHECK);
+      _mmu_100ms = create_perf_variable("z.mmu", "100ms", PerfData::U_None, CHECK);
+      update_all();
+    }
+  }
+
+  void update_all() {
+    update(_mmu_2ms,   ZStatMMU::mmu_2ms());
+    update(_mmu_5ms,   ZStatMMU::mmu_5ms());
+    update(_mmu_10ms,  ZStatMMU::mmu_10ms());
+    update(_mmu_20ms,  ZStatMMU::mmu_20ms());
+    update(_mmu_50ms,  ZStatMMU::mmu_50ms());
+    update(_mmu_100ms, ZStatMMU::mmu_100ms());
+  }
+};
+
+// Latency distribution, in ticks
+class ZLatencyCounters {
+private:
+  PerfVariable* _count;
+  PerfVariable* _total;
+  PerfVariable* _p50;
+  PerfVariable* _p99;
+  PerfVariable* _p999;
+  PerfVariable* _max;
+
+public:
+  ZLatencyCounters(const char* name_space) :
+      _count(NULL),
+      _total(NULL),
+      _p50(NULL),
+      _p99(NULL),
+      _p999(NULL),
+      _max(NULL) {
+    if (UsePerfData) {
+      EXCEPTION_MARK;
+      _count = create_perf_variable(name_space, "count", PerfData::U_Events, CHECK);
+      _total = create_perf_variable(name_space, "total", PerfData::U_Ticks,  CHECK);
+      _p50   = create_perf_variable(name_space, "p50",   PerfData::U_Ticks,  CHECK);
+      _p99   = create_perf_variable(name_space, "p99",   PerfData::U_Ticks,  CHECK);
+      _p999  = create_perf_variable(name_space, "p999",  PerfData::U_Ticks,  CHECK);
+      _max   = create_perf_variable(name_space, "max",   PerfData::U_Ticks,  CHECK);
+    }
+  }
+
+  void update_all(const ZStatLatencyHistogram& histogram) {
+    _count->set_value((jlong)histogram.count());
+    _total->set_value((jlong)histogram.total());
+    _p50->set_value((jlong)histogram.percentile(50.0));
+    _p99->set_value((jlong)histogram.percentile(99.0));
+    _p999->set_value((jlong)histogram.percentile(99.9));
+    _max->set_value((jlong)histogram.max());
+  }
+};
+
 // Class to expose perf counters used by jstat.
 class ZServiceabilityCounters : public CHeapObj<mtGC> {
 private:
   ZGenerationCounters _generation_counters;
   HSpaceCounters      _space_counters;
   CollectorCounters   _collector_counters;
+  ZMMUCounters        _mmu_counters;
+  ZLatencyCounters    _pause_counters;
+  ZLatencyCounters    _allocation_stall_counters;
 
 public:
   ZServiceabilityCounters(size_t min_capacity, size_t max_capacity);
@@ -55,6 +148,7 @@ public:
   CollectorCounters* collector_counters();
 
   void update_sizes();
+  void update_latencies();
 };
 
 ZServiceabilityCounters::ZServiceabilityCounters(size_t min_capacity, size_t max_capacity) :
@@ -73,7 +167,13 @@ ZServiceabilityCounters::ZServiceabilityCounters(size_t min_capacity, size_t max
                     min_capacity /* init_capacity */),
     // gc.collector.2
     _collector_counters("Z concurrent cycle pauses" /* name */,
-                        2                           /* ordinal */) {}
+                        2                           /* ordinal */),
+    // z.mmu
+    _mmu_counters(),
+    // z.pause
+    _pause_counters("z.pause"),
+    // z.allocationStall
+    _allocation_stall_counters("z.allocationStall") {}
 
 CollectorCounters* ZServiceabilityCounters::collector_counters() {
   return &_collector_counters;
@@ -93,6 +193,16 @@ void ZServiceabilityCounters::update_sizes() {
   }
 }
 
+void ZServiceabilityCounters::update_latencies() {
+  if (UsePerfData) {
+    // Allocation stalls are not tied to pauses, so their
+    // counters are only as recent as the last pause.
+    _mmu_counters.update_all();
+    _pause_counters.update_all(ZStatLatency::pauses());
+    _allocation_stall_counters.update_all(ZStatLatency::allocation_stalls());
+  }
+}
+
 ZServiceabilityMemoryPool::ZServiceabilityMemoryPool(size_t min_capacity, size_t max_capacity) :
     CollectedMemoryPool("ZHeap",
                         min_capacity,
@@ -159,4 +269,5 @@ ZServiceabilityCountersTracer::ZServiceabilityCountersTracer() :
 
 ZServiceabilityCountersTracer::~ZServiceabilityCountersTracer() {
   ZHeap::heap()->serviceability_counters()->update_sizes();
+  ZHeap::heap()->serviceability_counters()->update_latencies();
 }
@@ -22,6 +22,9 @@
  */
 
 #include "precompiled.hpp"
+#include "gc/shared/gcId.hpp"
+#include "gc/z/zBarrierProfile.hpp"
+#include "gc/z/zClassProfile.hpp"
 #include "gc/z/zCollectedHeap.hpp"
 #include "gc/z/zCPU.inline.hpp"
 #include "gc/z/zGlobals.hpp"
@@ -29,12 +32,16 @@
 #include "gc/z/zLargePages.inline.hpp"
 #include "gc/z/zNMethodTable.hpp"
 #include "gc/z/zNUMA.hpp"
+#include "gc/z/zPartition.hpp"
+#include "gc/z/zProbes.hpp"
 #include "gc/z/zStat.hpp"
 #include "gc/z/zTracer.inline.hpp"
 #include "gc/z/zUtils.hpp"
+#include "logging/logStream.hpp"
 #include "memory/resourceArea.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/os.hpp"
+#include "runtime/safepoint.hpp"
 #include "runtime/timer.hpp"
 #include "utilities/align.hpp"
 #include "utilities/compilerWarnings.hpp"
@@ -61,6 +68,11 @@ struct ZStatSamplerData {
     _sum(0),
     _max(0) {}
 
+  ZStatSamplerData(uint64_t nsamples, uint64_t sum, uint64_t max) :
+    _nsamples(nsamples),
+    _sum(sum),
+    _max(max) {}
+
   void add(const ZStatSamplerData& new_sample) {
     _nsamples += new_sample._nsamples;
     _sum += new_sample._sum;
@@ -75,6 +87,93 @@ struct ZStatCounterData {
     _counter(0) {}
 };
 
+//
+// Stat histogram data
+//
+struct ZStatHistogramData {
+  uint64_t _nsamples;
+  uint64_t _max;
+  uint32_t _buckets[ZStatHistogramBuckets::count];
+};
+
+//
+// Stat histogram history
+//
+class ZStatHistogramSample {
+private:
+  uint64_t _nsamples;
+  uint64_t _max;
+  uint64_t _buckets[ZStatHistogramBuckets::count];
+
+public:
+  ZStatHistogramSample() :
+      _nsamples(0),
+      _max(0) {
+    for (size_t i = 0; i < ZStatHistogramBuckets::count; i++) {
+      _buckets[i] = 0;
+    }
+  }
+
+  void add(uint64_t nsamples, uint64_t max, size_t index, uint64_t count) {
+    _nsamples += nsamples;
+    _max = MAX2(_max, max);
+    _buckets[index] += count;
+  }
+
+  void add(const ZStatHistogramSample& sample) {
+    _nsamples += sample._nsamples;
+    _max = MAX2(_max, sample._max);
+    for (size_t i = 0; i < ZStatHistogramBuckets::count; i++) {
+      _buckets[i] += sample._buckets[i];
+    }
+  }
+
+  uint64_t percentile(double percent) const {
+    return ZStatHistogramBuckets::percentile(_buckets, _nsamples, _max, percent);
+  }
+
+  uint64_t max() const {
+    return _max;
+  }
+};
+
+class ZStatHistogramHistory : public CHeapObj<mtGC> {
+private:
+  size_t               _next;
+  ZStatHistogramSample _10seconds[10];
+  ZStatHistogramSample _total;
+
+public:
+  ZStatHistogramHistory() :
+      _next(0),
+      _10seconds(),
+      _total() {}
+
+  ZStatHistogramSample* next() {
+    // Reuse the oldest sample
+    ZStatHistogramSample* const sample = &_10seconds[_next];
+    *sample = ZStatHistogramSample();
+    _next = (_next + 1) % ARRAY_SIZE(_10seconds);
+    return sample;
+  }
+
+  void commit(const ZStatHistogramSample* sample) {
+    _total.add(*sample);
+  }
+
+  ZStatHistogramSample last_10_seconds() const {
+    ZStatHistogramSample all;
+    for (size_t i = 0; i < ARRAY_SIZE(_10seconds); i++) {
+      all.add(_10seconds[i]);
+    }
+    return all;
+  }
+
+  const ZStatHistogramSample& total() const {
+    return _total;
+  }
+};
+
 //
 // Stat sampler history
 //
@@ -290,6 +389,24 @@ void ZStatUnitThreads(LogTargetHandle log, const ZStatSampler& sampler, const ZS
             history.max_total());
 }
 
+void ZStatUnitCycles(LogTargetHandle log, const ZStatSampler& sampler, const ZStatSamplerHistory& history) {
+  log.print(" %10s: %-41s "
+            UINT64_FORMAT_W(9) " / " UINT64_FORMAT_W(-9) " "
+            UINT64_FORMAT_W(9) " / " UINT64_FORMAT_W(-9) " "
+            UINT64_FORMAT_W(9) " / " UINT64_FORMAT_W(-9) " "
+            UINT64_FORMAT_W(9) " / " UINT64_FORMAT_W(-9) "   cycles",
+            sampler.group(),
+            sampler.name(),
+            history.avg_10_seconds(),
+            history.max_10_seconds(),
+            history.avg_10_minutes(),
+            history.max_10_minutes(),
+            history.avg_10_hours(),
+            history.max_10_hours(),
+            history.avg_total(),
+            history.max_total());
+}
+
 void ZStatUnitBytesPerSecond(LogTargetHandle log, const ZStatSampler& sampler, const ZStatSamplerHistory& history) {
   log.print(" %10s: %-41s "
             UINT64_FORMAT_W(9) " / " UINT64_FORMAT_W(-9) " "
@@ -422,22 +539,26 @@ ZStatSamplerData ZStatSampler::collect_and_reset() const {
 
   const uint32_t ncpus = ZCPU::count();
   for (uint32_t i = 0; i < ncpus; i++) {
-    ZStatSamplerData* const cpu_data = get_cpu_local<ZStatSamplerData>(i);
-    if (cpu_data->_nsamples > 0) {
-      const uint64_t nsamples = Atomic::xchg(&cpu_data->_nsamples, (uint64_t)0);
-      const uint64_t sum = Atomic::xchg(&cpu_data->_sum, (uint64_t)0);
-      const uint64_t max = Atomic::xchg(&cpu_data->_max, (uint64_t)0);
-      all._nsamples += nsamples;
-      all._sum += sum;
-      if (all._max < max) {
-        all._max = max;
-      }
-    }
+    collect_and_reset(i, &all);
   }
 
   return all;
 }
 
+void ZStatSampler::collect_and_reset(uint32_t cpu, ZStatSamplerData* all) const {
+  ZStatSamplerData* const cpu_data = get_cpu_local<ZStatSamplerData>(cpu);
+  if (cpu_data->_nsamples > 0) {
+    const uint64_t nsamples = Atomic::xchg(&cpu_data->_nsamples, (uint64_t)0);
+    const uint64_t sum = Atomic::xchg(&cpu_data->_sum, (uint64_t)0);
+    const uint64_t max = Atomic::xchg(&cpu_data->_max, (uint64_t)0);
+    all->_nsamples += nsamples;
+    all->_sum += sum;
+    if (all->_max < max) {
+      all->_max = max;
+    }
+  }
+}
+
 ZStatUnitPrinter ZStatSampler::printer() const {
   return _printer;
 }
@@ -447,22 +568,46 @@ ZStatUnitPrinter ZStatSampler::printer() const {
 //
 ZStatCounter::ZStatCounter(const char* group, const char* name, ZStatUnitPrinter printer) :
     ZStatIterableValue<ZStatCounter>(group, name, sizeof(ZStatCounterData)),
-    _sampler(group, name, printer) {}
+    _sampler(group, name, printer),
+    _total(0) {}
 
 ZStatCounterData* ZStatCounter::get() const {
   return get_cpu_local<ZStatCounterData>(ZCPU::id());
 }
 
-void ZStatCounter::sample_and_reset() const {
-  uint64_t counter = 0;
+uint64_t ZStatCounter::collect_and_reset(uint32_t cpu) const {
+  ZStatCounterData* const cpu_data = get_cpu_local<ZStatCounterData>(cpu);
+  if (Atomic::load(&cpu_data->_counter) == 0) {
+    // Avoid taking the cache line of an idle CPU exclusive
+    return 0;
+  }
+
+  return Atomic::xchg(&cpu_data->_counter, (uint64_t)0);
+}
+
+void ZStatCounter::sample(uint64_t counter, ZStatSamplerData* samples) const {
+  Atomic::add(&_total, counter);
+
+  // Add the sample directly to the samples collected in this interval.
+  // Going through the per-CPU storage of the sampler would delay it to
+  // the next interval, since that storage has already been collected.
+  const ZStatSamplerData sample(1 /* nsamples */, counter /* sum */, counter /* max */);
+  samples[_sampler.id()].add(sample);
+}
+
+uint64_t ZStatCounter::total() const {
+  // Total since VM start, including increments not yet sampled. This
+  // can be off by the increments of one sample period, if the counter
+  // is sampled concurrently.
+  uint64_t total = Atomic::load(&_total);
 
   const uint32_t ncpus = ZCPU::count();
   for (uint32_t i = 0; i < ncpus; i++) {
-    ZStatCounterData* const cpu_data = get_cpu_local<ZStatCounterData>(i);
-    counter += Atomic::xchg(&cpu_data->_counter, (uint64_t)0);
+    const ZStatCounterData* const cpu_data = get_cpu_local<ZStatCounterData>(i);
+    total += Atomic::load(&cpu_data->_counter);
   }
 
-  ZStatSample(_sampler, counter);
+  return total;
 }
 
 //
@@ -487,6 +632,74 @@ ZStatCounterData ZStatUnsampledCounter::collect_and_reset() const {
   return all;
 }
 
+//
+// Stat histogram
+//
+size_t ZStatHistogramBuckets::index(uint64_t value) {
+  if (value < 4) {
+    return value;
+  }
+
+  // Bucket by the two bits following the most significant bit
+  const size_t msb = log2_long(value);
+  const size_t sub = (value >> (msb - 2)) & 3;
+  return MIN2((msb - 1) * 4 + sub, count - 1);
+}
+
+uint64_t ZStatHistogramBuckets::upper(size_t index) {
+  if (index < 4) {
+    return index;
+  }
+
+  const size_t msb = index / 4 + 1;
+  const size_t sub = index % 4;
+  const uint64_t lower = (uint64_t)(4 + sub) << (msb - 2);
+  return lower + ((uint64_t)1 << (msb - 2)) - 1;
+}
+
+uint64_t ZStatHistogramBuckets::percentile(const volatile uint64_t* buckets, uint64_t nsamples, uint64_t max, double percent) {
+  if (nsamples == 0) {
+    return 0;
+  }
+
+  // Find the first bucket where the accumulated count reaches the
+  // requested rank. The upper bound of that bucket is reported, but
+  // never more than the largest value seen.
+  const uint64_t rank = MAX2((uint64_t)ceil(nsamples * percent / 100.0), (uint64_t)1);
+  uint64_t accumulated = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    accumulated += Atomic::load(&buckets[i]);
+    if (accumulated >= rank) {
+      return MIN2(upper(i), max);
+    }
+  }
+
+  // Buckets were updated concurrently
+  return max;
+}
+
+ZStatHistogram::ZStatHistogram(const char* group, const char* name) :
+    ZStatIterableValue<ZStatHistogram>(group, name, sizeof(ZStatHistogramData)) {}
+
+ZStatHistogramData* ZStatHistogram::get() const {
+  return get_cpu_local<ZStatHistogramData>(ZCPU::id());
+}
+
+void ZStatHistogram::collect_and_reset(uint32_t cpu, ZStatHistogramSample* sample) const {
+  ZStatHistogramData* const cpu_data = get_cpu_local<ZStatHistogramData>(cpu);
+  if (cpu_data->_nsamples > 0) {
+    const uint64_t nsamples = Atomic::xchg(&cpu_data->_nsamples, (uint64_t)0);
+    const uint64_t max = Atomic::xchg(&cpu_data->_max, (uint64_t)0);
+    sample->add(nsamples, max, 0, 0);
+    for (size_t j = 0; j < ZStatHistogramBuckets::count; j++) {
+      if (cpu_data->_buckets[j] > 0) {
+        sample->add(0, 0, j, Atomic::xchg(&cpu_data->_buckets[j], (uint32_t)0));
+      }
+    }
+  }
+}
+
 //
 // Stat MMU (Minimum Mutator Utilization)
 //
@@ -565,11 +778,126 @@ void ZStatMMU::register_pause(const Ticks& start, const Ticks& end) {
   _mmu_100ms  = MIN2(_mmu_100ms, calculate_mmu(100));
 }
 
+double ZStatMMU::mmu_2ms() {
+  return _mmu_2ms;
+}
+
+double ZStatMMU::mmu_5ms() {
+  return _mmu_5ms;
+}
+
+double ZStatMMU::mmu_10ms() {
+  return _mmu_10ms;
+}
+
+double ZStatMMU::mmu_20ms() {
+  return _mmu_20ms;
+}
+
+double ZStatMMU::mmu_50ms() {
+  return _mmu_50ms;
+}
+
+double ZStatMMU::mmu_100ms() {
+  return _mmu_100ms;
+}
+
 void ZStatMMU::print() {
   log_info(gc, mmu)("MMU: 2ms/%.1f%%, 5ms/%.1f%%, 10ms/%.1f%%, 20ms/%.1f%%, 50ms/%.1f%%, 100ms/%.1f%%",
                     _mmu_2ms, _mmu_5ms, _mmu_10ms, _mmu_20ms, _mmu_50ms, _mmu_100ms);
 }
 
+//
+// Stat latency histogram
+//
+ZStatLatencyHistogram::ZStatLatencyHistogram() :
+    _count(0),
+    _total(0),
+    _max(0) {
+  for (size_t i = 0; i < ZStatHistogramBuckets::count; i++) {
+    _buckets[i] = 0;
+  }
+}
+
+void ZStatLatencyHistogram::add(const Tickspan& duration) {
+  const uint64_t value = (uint64_t)duration.value();
+  Atomic::inc(&_buckets[ZStatHistogramBuckets::index(value)]);
+  Atomic::inc(&_count);
+  Atomic::add(&_total, value);
+
+  uint64_t max = Atomic::load(&_max);
+  while (value > max) {
+    const uint64_t prev_max = Atomic::cmpxchg(&_max, max, value);
+    if (prev_max == max) {
+      break;
+    }
+
+    max = prev_max;
+  }
+}
+
+uint64_t ZStatLatencyHistogram::count() const {
+  return Atomic::load(&_count);
+}
+
+uint64_t ZStatLatencyHistogram::total() const {
+  return Atomic::load(&_total);
+}
+
+uint64_t ZStatLatencyHistogram::max() const {
+  return Atomic::load(&_max);
+}
+
+uint64_t ZStatLatencyHistogram::percentile(double percent) const {
+  return ZStatHistogramBuckets::percentile(_buckets, count(), max(), percent);
+}
+
+ZStatLatencyHistogram ZStatLatency::_pauses;
+ZStatLatencyHistogram ZStatLatency::_allocation_stalls;
+
+void ZStatLatency::register_pause(const Tickspan& duration) {
+  _pauses.add(duration);
+}
+
+void ZStatLatency::register_allocation_stall(const Tickspan& duration) {
+  _allocation_stalls.add(duration);
+}
+
+const ZStatLatencyHistogram& ZStatLatency::pauses() {
+  return _pauses;
+}
+
+const ZStatLatencyHistogram& ZStatLatency::allocation_stalls() {
+  return _allocation_stalls;
+}
+
+//
+// Stat CPU time
+//
+volatile uint64_t ZStatCPUTime::_workers = 0;
+
+uint64_t ZStatCPUTime::current_thread() {
+  if (!os::is_thread_cpu_time_supported()) {
+    return 0;
+  }
+
+  return (uint64_t)os::current_thread_cpu_time();
+}
+
+void ZStatCPUTime::add_workers(uint64_t cpu_time) {
+  Atomic::add(&_workers, cpu_time);
+}
+
+uint64_t ZStatCPUTime::now() {
+  // CPU time used by all GC workers, plus the CPU time used by
+  // the current thread, which is the thread timing the phase.
+  return Atomic::load(&_workers) + current_thread();
+}
+
+static uint64_t nanos_to_counter(uint64_t nanos) {
+  return (uint64_t)((double)nanos * os::elapsed_frequency() / NANOSECS_PER_SEC);
+}
+
 //
 // Stat phases
 //
@@ -618,6 +946,8 @@ ZStatPhaseCycle::ZStatPhaseCycle(const char* name) :
 void ZStatPhaseCycle::register_start(const Ticks& start) const {
   timer()->register_gc_start(start);
 
+  HOTSPOT_ZGC_PHASE_START(name());
+
   ZTracer::tracer()->report_gc_start(ZCollectedHeap::heap()->gc_cause(), start);
 
   ZCollectedHeap::heap()->print_heap_before_gc();
@@ -638,6 +968,8 @@ void ZStatPhaseCycle::register_end(const Ticks& start, const Ticks& end) const {
   const Tickspan duration = end - start;
   ZStatSample(_sampler, duration.value());
 
+  HOTSPOT_ZGC_PHASE_END(name(), duration.nanoseconds());
+
   ZStatLoad::print();
   ZStatMMU::print();
   ZStatMark::print();
@@ -646,6 +978,15 @@ void ZStatPhaseCycle::register_end(const Ticks& start, const Ticks& end) const {
   ZStatMetaspace::print();
   ZStatReferences::print();
   ZStatHeap::print();
+  ZPartitions::print();
+
+  if (ZProfileBarrierSlowPaths) {
+    ZBarrierProfile::print();
+  }
+
+  if (ZProfileClasses) {
+    ZClassProfile::report();
+  }
 
   log_info(gc)("Garbage Collection (%s) " ZSIZE_FMT "->" ZSIZE_FMT,
                GCCause::to_string(ZCollectedHeap::heap()->gc_cause()),
@@ -656,15 +997,46 @@ void ZStatPhaseCycle::register_end(const Ticks& start, const Ticks& end) const {
 Tickspan ZStatPhasePause::_max;
 
 ZStatPhasePause::ZStatPhasePause(const char* name) :
-    ZStatPhase("Phase", name) {}
+    ZStatPhase("Phase", name),
+    _cpu_sampler("CPU", name, ZStatUnitTime),
+    _ttsp_sampler("Time To Safepoint", name, ZStatUnitTime),
+    _cpu_start(0) {}
 
 const Tickspan& ZStatPhasePause::max() {
   return _max;
 }
 
+void ZStatPhasePause::register_time_to_safepoint() const {
+  const jlong time_to_safepoint = SafepointTracing::time_to_safepoint_ns();
+  ZStatSample(_ttsp_sampler, nanos_to_counter(time_to_safepoint));
+
+  JavaThread* const slowest = SafepointTracing::slowest_thread(0);
+  ZTracer::tracer()->report_time_to_safepoint(name(), time_to_safepoint, slowest);
+
+  LogTarget(Debug, gc, safepoint) log;
+  if (log.is_enabled()) {
+    ResourceMark rm;
+    LogStream stream(log);
+    stream.print("%s Time To Safepoint: %.3fms", name(), (double)time_to_safepoint / NANOSECS_PER_MILLISEC);
+    for (uint i = 0; i < SafepointTracing::nof_slowest_threads; i++) {
+      JavaThread* const thread = SafepointTracing::slowest_thread(i);
+      if (thread == NULL) {
+        break;
+      }
+      stream.print("%s%s", (i == 0) ? ", Slowest Threads: " : ", ", thread->get_thread_name());
+    }
+    stream.cr();
+  }
+}
+
 void ZStatPhasePause::register_start(const Ticks& start) const {
   timer()->register_gc_pause_start(name(), start);
 
+  // A pause is only ever timed by the VM thread
+  _cpu_start = ZStatCPUTime::now();
+
+  HOTSPOT_ZGC_PHASE_START(name());
+
   LogTarget(Debug, gc, phases, start) log;
   log_start(log);
 }
@@ -674,6 +1046,7 @@ void ZStatPhasePause::register_end(const Ticks& start, const Ticks& end) const {
 
   const Tickspan duration = end - start;
   ZStatSample(_sampler, duration.value());
+  ZStatSample(_cpu_sampler, nanos_to_counter(ZStatCPUTime::now() - _cpu_start));
 
   // Track max pause time
   if (_max < duration) {
@@ -683,16 +1056,28 @@ void ZStatPhasePause::register_end(const Ticks& start, const Ticks& end) const {
   // Track minimum mutator utilization
   ZStatMMU::register_pause(start, end);
 
+  // Track pause latency distribution
+  ZStatLatency::register_pause(duration);
+
+  HOTSPOT_ZGC_PHASE_END(name(), duration.nanoseconds());
+
   LogTarget(Info, gc, phases) log;
   log_end(log, duration);
 }
 
 ZStatPhaseConcurrent::ZStatPhaseConcurrent(const char* name) :
-    ZStatPhase("Phase", name) {}
+    ZStatPhase("Phase", name),
+    _cpu_sampler("CPU", name, ZStatUnitTime),
+    _cpu_start(0) {}
 
 void ZStatPhaseConcurrent::register_start(const Ticks& start) const {
   timer()->register_gc_concurrent_start(name(), start);
 
+  // A concurrent phase is only ever timed by the driver thread
+  _cpu_start = ZStatCPUTime::now();
+
+  HOTSPOT_ZGC_PHASE_START(name());
+
   LogTarget(Debug, gc, phases, start) log;
   log_start(log);
 }
@@ -702,6 +1087,9 @@ void ZStatPhaseConcurrent::register_end(const Ticks& start, const Ticks& end) co
 
   const Tickspan duration = end - start;
   ZStatSample(_sampler, duration.value());
+  ZStatSample(_cpu_sampler, nanos_to_counter(ZStatCPUTime::now() - _cpu_start));
+
+  HOTSPOT_ZGC_PHASE_END(name(), duration.nanoseconds());
 
   LogTarget(Info, gc, phases) log;
   log_end(log, duration);
@@ -711,6 +1099,8 @@ ZStatSubPhase::ZStatSubPhase(const char* name) :
     ZStatPhase("Subphase", name) {}
 
 void ZStatSubPhase::register_start(const Ticks& start) const {
+  HOTSPOT_ZGC_PHASE_START(name());
+
   LogTarget(Debug, gc, phases, start) log;
   log_start(log, true /* thread */);
 }
@@ -721,6 +1111,8 @@ void ZStatSubPhase::register_end(const Ticks& start, const Ticks& end) const {
   const Tickspan duration = end - start;
   ZStatSample(_sampler, duration.value());
 
+  HOTSPOT_ZGC_PHASE_END(name(), duration.nanoseconds());
+
   LogTarget(Debug, gc, phases) log;
   log_end(log, duration, true /* thread */);
 }
@@ -756,6 +1148,11 @@ void ZStatCriticalPhase::register_end(const Ticks& start, const Ticks& end) cons
 //
 THREAD_LOCAL uint32_t ZStatTimerDisable::_active = 0;
 
+ZStatSuspendibleTimer::~ZStatSuspendibleTimer() {
+  const Tickspan duration = Ticks::now() - _start;
+  ZStatSample(_sampler, duration.value());
+}
+
 //
 // Stat sample/inc
 //
@@ -785,6 +1182,24 @@ void ZStatSample(const ZStatSampler& sampler, uint64_t value) {
   ZTracer::tracer()->report_stat_sampler(sampler, value);
 }
 
+void ZStatSample(const ZStatHistogram& histogram, uint64_t value) {
+  ZStatHistogramData* const cpu_data = histogram.get();
+  Atomic::inc(&cpu_data->_buckets[ZStatHistogramBuckets::index(value)]);
+  Atomic::inc(&cpu_data->_nsamples);
+
+  uint64_t max = cpu_data->_max;
+  while (max < value) {
+    const uint64_t prev_max = Atomic::cmpxchg(&cpu_data->_max, max, value);
+    if (prev_max == max) {
+      // Success
+      break;
+    }
+
+    // Retry
+    max = prev_max;
+  }
+}
+
 void ZStatInc(const ZStatCounter& counter, uint64_t increment) {
   ZStatCounterData* const cpu_data = counter.get();
   const uint64_t value = Atomic::add(&cpu_data->_counter, increment);
@@ -797,12 +1212,64 @@ void ZStatInc(const ZStatUnsampledCounter& counter, uint64_t increment) {
   Atomic::add(&cpu_data->_counter, increment);
 }
 
+//
+// Stat trend
+//
+ZStatTrend::ZStatTrend() :
+    _initialized(false),
+    _level(0.0),
+    _slope(0.0) {}
+
+void ZStatTrend::add(double value, double sample_interval) {
+  // The trend is tracked using double exponential smoothing (Holt's
+  // linear method), where the level is the smoothed value and the
+  // slope is the smoothed change in value per second. The level reacts
+  // within a few samples, while the slope is smoothed over a longer
+  // period to filter out short spikes.
+  const double level_weight = 0.3;
+  const double slope_weight = 0.05;
+
+  if (!_initialized) {
+    _initialized = true;
+    _level = value;
+    _slope = 0.0;
+    return;
+  }
+
+  const double last_level = _level;
+  _level = (level_weight * value) + ((1.0 - level_weight) * (last_level + (_slope * sample_interval)));
+  _slope = (slope_weight * ((_level - last_level) / sample_interval)) + ((1.0 - slope_weight) * _slope);
+}
+
+double ZStatTrend::level() const {
+  return _level;
+}
+
+double ZStatTrend::slope() const {
+  return _slope;
+}
+
+double ZStatTrend::predict(double seconds) const {
+  // Forecast the value the given number of seconds into
+  // the future, assuming the current trend continues.
+  return MAX2(_level + (_slope * seconds), 0.0);
+}
+
+static void seed_seq(AbsSeq* seq, double avg, double sd, int nsamples) {
+  // Add samples alternating around the average, which gives a
+  // sequence with the given average and standard deviation
+  for (int i = 0; i < nsamples; i++) {
+    seq->add(MAX2(((i % 2) == 0) ? avg + sd : avg - sd, 0.0));
+  }
+}
+
 //
 // Stat allocation rate
 //
 const ZStatUnsampledCounter ZStatAllocRate::_counter("Allocation Rate");
 TruncatedSeq                ZStatAllocRate::_rate(ZStatAllocRate::sample_window_sec * ZStatAllocRate::sample_hz);
 TruncatedSeq                ZStatAllocRate::_rate_avg(ZStatAllocRate::sample_window_sec * ZStatAllocRate::sample_hz);
+ZStatTrend                  ZStatAllocRate::_trend;
 
 const ZStatUnsampledCounter& ZStatAllocRate::counter() {
   return _counter;
@@ -814,6 +1281,7 @@ uint64_t ZStatAllocRate::sample_and_reset() {
 
   _rate.add(bytes_per_second);
   _rate_avg.add(_rate.avg());
+  _trend.add(bytes_per_second, 1.0 / sample_hz);
 
   return bytes_per_second;
 }
@@ -826,26 +1294,127 @@ double ZStatAllocRate::avg_sd() {
   return _rate_avg.sd();
 }
 
+double ZStatAllocRate::trend() {
+  return _trend.slope();
+}
+
+double ZStatAllocRate::predict(double seconds) {
+  return _trend.predict(seconds);
+}
+
+const ZStatTrend& ZStatAllocRate::trend_data() {
+  return _trend;
+}
+
+void ZStatAllocRate::seed(double avg, double avg_sd) {
+  const int nsamples = sample_window_sec * sample_hz;
+  for (int i = 0; i < nsamples; i++) {
+    _rate.add(avg);
+  }
+  seed_seq(&_rate_avg, avg, avg_sd, nsamples);
+}
+
+//
+// Stat metaspace rate
+//
+size_t       ZStatMetaspaceRate::_last_committed = 0;
+TruncatedSeq ZStatMetaspaceRate::_rate(ZStatAllocRate::sample_window_sec * ZStatAllocRate::sample_hz);
+TruncatedSeq ZStatMetaspaceRate::_rate_avg(ZStatAllocRate::sample_window_sec * ZStatAllocRate::sample_hz);
+
+double ZStatMetaspaceRate::sample(size_t committed) {
+  // Metaspace shrinks when class unloading frees memory, which is
+  // not growth and is therefore sampled as a zero rate.
+  const size_t growth = committed - MIN2(committed, _last_committed);
+  const double bytes_per_second = (double)growth * ZStatAllocRate::sample_hz;
+  _last_committed = committed;
+
+  _rate.add(bytes_per_second);
+  _rate_avg.add(_rate.avg());
+
+  return bytes_per_second;
+}
+
+double ZStatMetaspaceRate::avg() {
+  return _rate.avg();
+}
+
+double ZStatMetaspaceRate::avg_sd() {
+  return _rate_avg.sd();
+}
+
 //
 // Stat thread
 //
+static const ZStatSampler ZSamplerStatSampleAndCollect("Statistics", "Sample And Collect", ZStatUnitTime);
+
 ZStat::ZStat() :
     _metronome(sample_hz) {
   set_name("ZStat");
   create_and_start();
 }
 
-void ZStat::sample_and_collect(ZStatSamplerHistory* history) const {
-  // Sample counters
+void ZStat::sample_and_collect(ZStatSamplerData* samples,
+                               uint64_t* counters,
+                               ZStatHistogramSample** histogram_samples,
+                               ZStatSamplerHistory* history,
+                               ZStatHistogramHistory* histogram_history,
+                               bool collect_histograms) const {
+  const Ticks start = Ticks::now();
+
+  // Samples of histograms that are not printed are discarded
+  ZStatHistogramSample discarded;
+
   for (const ZStatCounter* counter = ZStatCounter::first(); counter != NULL; counter = counter->next()) {
-    counter->sample_and_reset();
+    counters[counter->id()] = 0;
   }
 
-  // Collect samples
   for (const ZStatSampler* sampler = ZStatSampler::first(); sampler != NULL; sampler = sampler->next()) {
-    ZStatSamplerHistory& sampler_history = history[sampler->id()];
-    sampler_history.add(sampler->collect_and_reset());
+    samples[sampler->id()] = ZStatSamplerData();
   }
+
+  for (const ZStatHistogram* histogram = ZStatHistogram::first(); histogram != NULL; histogram = histogram->next()) {
+    histogram_samples[histogram->id()] = collect_histograms ? histogram_history[histogram->id()].next() : &discarded;
+  }
+
+  // Collect the values of one CPU at a time. The values of a CPU are
+  // stored together, so walking them CPU by CPU touches each cache line
+  // of the per-CPU storage once, instead of once per value and striding
+  // across all CPUs for every value. Histograms are only kept while they
+  // are printed, since they are large and have no other consumers. Until
+  // then their per-CPU storage is still emptied, only skipping CPUs that
+  // recorded nothing, so that the bucket counts can't grow without bound.
+  const uint32_t ncpus = ZCPU::count();
+  for (uint32_t i = 0; i < ncpus; i++) {
+    for (const ZStatCounter* counter = ZStatCounter::first(); counter != NULL; counter = counter->next()) {
+      counters[counter->id()] += counter->collect_and_reset(i);
+    }
+
+    for (const ZStatSampler* sampler = ZStatSampler::first(); sampler != NULL; sampler = sampler->next()) {
+      sampler->collect_and_reset(i, &samples[sampler->id()]);
+    }
+
+    for (const ZStatHistogram* histogram = ZStatHistogram::first(); histogram != NULL; histogram = histogram->next()) {
+      histogram->collect_and_reset(i, histogram_samples[histogram->id()]);
+    }
+  }
+
+  // Sample counters, into the samples of this interval
+  for (const ZStatCounter* counter = ZStatCounter::first(); counter != NULL; counter = counter->next()) {
+    counter->sample(counters[counter->id()], samples);
+  }
+
+  for (const ZStatSampler* sampler = ZStatSampler::first(); sampler != NULL; sampler = sampler->next()) {
+    history[sampler->id()].add(samples[sampler->id()]);
+  }
+
+  if (collect_histograms) {
+    for (const ZStatHistogram* histogram = ZStatHistogram::first(); histogram != NULL; histogram = histogram->next()) {
+      histogram_history[histogram->id()].commit(histogram_samples[histogram->id()]);
+    }
+  }
+
+  // Account the cost of the statistics thread itself
+  ZStatSample(ZSamplerStatSampleAndCollect, (Ticks::now() - start).value());
 }
 
 bool ZStat::should_print(LogTargetHandle log) const {
@@ -861,7 +1430,47 @@ bool ZStat::should_print(LogTargetHandle log) const {
   return log.is_enabled();
 }
 
-void ZStat::print(LogTargetHandle log, const ZStatSamplerHistory* history) const {
+void ZStat::print_json(LogTargetHandle log, const ZStatSamplerData* samples) const {
+  // One line per sample interval, holding the raw values collected during
+  // that interval. Counters are included, since every counter is backed by
+  // a sampler of the same name.
+  LogStream stream(log);
+  stream.print("{\"type\":\"sample\",\"time\":%.3f,\"samplers\":{", os::elapsedTime());
+
+  for (const ZStatSampler* sampler = ZStatSampler::first(); sampler != NULL; sampler = sampler->next()) {
+    const ZStatSamplerData& sample = samples[sampler->id()];
+    stream.print("%s\"%s: %s\":{\"nsamples\":" UINT64_FORMAT ",\"sum\":" UINT64_FORMAT ",\"max\":" UINT64_FORMAT "}",
+                 (sampler == ZStatSampler::first()) ? "" : ",",
+                 sampler->group(),
+                 sampler->name(),
+                 sample._nsamples,
+                 sample._sum,
+                 sample._max);
+  }
+
+  stream.print_cr("}}");
+}
+
+static void print_histogram(LogTargetHandle log, const ZStatHistogram& histogram, const ZStatHistogramHistory& history) {
+  const ZStatHistogramSample last_10_seconds = history.last_10_seconds();
+  const ZStatHistogramSample& total = history.total();
+
+  log.print(" %10s: %-41s "
+            "%9.3f / %9.3f / %9.3f / %-9.3f   "
+            "%9.3f / %9.3f / %9.3f / %-9.3f   ms",
+            histogram.group(),
+            histogram.name(),
+            TimeHelper::counter_to_millis(last_10_seconds.percentile(50.0)),
+            TimeHelper::counter_to_millis(last_10_seconds.percentile(99.0)),
+            TimeHelper::counter_to_millis(last_10_seconds.percentile(99.9)),
+            TimeHelper::counter_to_millis(last_10_seconds.max()),
+            TimeHelper::counter_to_millis(total.percentile(50.0)),
+            TimeHelper::counter_to_millis(total.percentile(99.0)),
+            TimeHelper::counter_to_millis(total.percentile(99.9)),
+            TimeHelper::counter_to_millis(total.max()));
+}
+
+void ZStat::print(LogTargetHandle log, const ZStatSamplerHistory* history, const ZStatHistogramHistory* histogram_history) const {
   // Print
   log.print("=== Garbage Collection Statistics =======================================================================================================================");
   log.print("                                                             Last 10s              Last 10m              Last 10h                Total");
@@ -873,22 +1482,44 @@ void ZStat::print(LogTargetHandle log, const ZStatSamplerHistory* history) const
     printer(log, *sampler, sampler_history);
   }
 
+  if (ZStatHistogram::count() > 0) {
+    log.print("%s", "");
+    log.print("                                                                          Last 10s                                         Total");
+    log.print("                                                                  P50 / P99 / P99.9 / Max                         P50 / P99 / P99.9 / Max");
+
+    for (const ZStatHistogram* histogram = ZStatHistogram::first(); histogram != NULL; histogram = histogram->next()) {
+      print_histogram(log, *histogram, histogram_history[histogram->id()]);
+    }
+  }
+
   log.print("=========================================================================================================================================================");
 }
 
 void ZStat::run_service() {
+  ZStatSamplerData* const samples = new ZStatSamplerData[ZStatSampler::count()];
+  uint64_t* const counters = new uint64_t[ZStatCounter::count()];
+  ZStatHistogramSample** const histogram_samples = new ZStatHistogramSample*[ZStatHistogram::count()];
   ZStatSamplerHistory* const history = new ZStatSamplerHistory[ZStatSampler::count()];
+  ZStatHistogramHistory* const histogram_history = new ZStatHistogramHistory[ZStatHistogram::count()];
   LogTarget(Info, gc, stats) log;
+  LogTarget(Info, gc, stats, json) json_log;
 
   // Main loop
   while (_metronome.wait_for_tick()) {
-    sample_and_collect(history);
+    sample_and_collect(samples, counters, histogram_samples, history, histogram_history, log.is_enabled());
+    if (json_log.is_enabled()) {
+      print_json(json_log, samples);
+    }
     if (should_print(log)) {
-      print(log, history);
+      print(log, history, histogram_history);
     }
   }
 
+  delete [] histogram_history;
   delete [] history;
+  delete [] histogram_samples;
+  delete [] counters;
+  delete [] samples;
 }
 
 void ZStat::stop_service() {
@@ -1025,12 +1656,44 @@ public:
 // Stat cycle
 //
 uint64_t  ZStatCycle::_nwarmup_cycles = 0;
+bool      ZStatCycle::_seeded = false;
 Ticks     ZStatCycle::_start_of_last;
 Ticks     ZStatCycle::_end_of_last;
+double    ZStatCycle::_excluded_duration = 0.0;
 NumberSeq ZStatCycle::_normalized_duration(0.3 /* alpha */);
+uint64_t  ZStatCycle::_gc_cpu_at_start = 0;
+double    ZStatCycle::_process_cpu_at_start = 0.0;
+NumberSeq ZStatCycle::_cpu_overhead(0.3 /* alpha */);
+
+void ZStatCycle::sample_cpu_overhead() {
+  double process_real_time;
+  double process_user_time;
+  double process_system_time;
+  if (!os::is_thread_cpu_time_supported() ||
+      !os::getTimesSecs(&process_real_time, &process_user_time, &process_system_time)) {
+    // Not supported
+    return;
+  }
+
+  // The GC CPU time is sampled by the driver thread, which
+  // is therefore included in both samples
+  const uint64_t gc_cpu = ZStatCPUTime::now();
+  const double process_cpu = process_user_time + process_system_time;
+
+  if (_process_cpu_at_start > 0.0 && process_cpu > _process_cpu_at_start) {
+    const double gc_cpu_seconds = (double)(gc_cpu - _gc_cpu_at_start) / NANOSECS_PER_SEC;
+    const double overhead = percent_of(gc_cpu_seconds, process_cpu - _process_cpu_at_start);
+    _cpu_overhead.add(MIN2(overhead, 100.0));
+  }
+
+  _gc_cpu_at_start = gc_cpu;
+  _process_cpu_at_start = process_cpu;
+}
 
 void ZStatCycle::at_start() {
   _start_of_last = Ticks::now();
+  _excluded_duration = 0.0;
+  sample_cpu_overhead();
 }
 
 void ZStatCycle::at_end(GCCause::Cause cause, double boost_factor) {
@@ -1042,14 +1705,19 @@ void ZStatCycle::at_end(GCCause::Cause cause, double boost_factor) {
 
   // Calculate normalized cycle duration. The measured duration is
   // normalized using the boost factor to avoid artificial deflation
-  // of the duration when boost mode is enabled.
-  const double duration = (_end_of_last - _start_of_last).seconds();
+  // of the duration when boost mode is enabled. Optional phases are
+  // left out, since they are only run when there is time to spare.
+  const double duration = MAX2((_end_of_last - _start_of_last).seconds() - _excluded_duration, 0.0);
   const double normalized_duration = duration * boost_factor;
   _normalized_duration.add(normalized_duration);
 }
 
+void ZStatCycle::exclude_from_duration(const Tickspan& duration) {
+  _excluded_duration += duration.seconds();
+}
+
 bool ZStatCycle::is_warm() {
-  return _nwarmup_cycles >= 3;
+  return _seeded || _nwarmup_cycles >= 3;
 }
 
 uint64_t ZStatCycle::nwarmup_cycles() {
@@ -1058,14 +1726,23 @@ uint64_t ZStatCycle::nwarmup_cycles() {
 
 bool ZStatCycle::is_normalized_duration_trustable() {
   // The normalized duration is considered trustable if we have
-  // completed at least one warmup cycle
-  return _nwarmup_cycles > 0;
+  // completed at least one warmup cycle, or if it was seeded
+  return _seeded || _nwarmup_cycles > 0;
+}
+
+void ZStatCycle::seed(double duration_avg, double duration_sd) {
+  seed_seq(&_normalized_duration, duration_avg, duration_sd, 10);
+  _seeded = true;
 }
 
 const AbsSeq& ZStatCycle::normalized_duration() {
   return _normalized_duration;
 }
 
+const AbsSeq& ZStatCycle::cpu_overhead() {
+  return _cpu_overhead;
+}
+
 double ZStatCycle::time_since_last() {
   if (_end_of_last.value() == 0) {
     // No end recorded yet, return time since VM start
@@ -1083,7 +1760,8 @@ double ZStatCycle::time_since_last() {
 void ZStatLoad::print() {
   double loadavg[3] = {};
   os::loadavg(loadavg, ARRAY_SIZE(loadavg));
-  log_info(gc, load)("Load: %.2f/%.2f/%.2f", loadavg[0], loadavg[1], loadavg[2]);
+  log_info(gc, load)("Load: %.2f/%.2f/%.2f, Concurrent Workers: %u",
+                     loadavg[0], loadavg[1], loadavg[2], ZHeap::heap()->nconcurrent_worker_threads());
 }
 
 //
@@ -1094,6 +1772,21 @@ size_t ZStatMark::_nproactiveflush;
 size_t ZStatMark::_nterminateflush;
 size_t ZStatMark::_ntrycomplete;
 size_t ZStatMark::_ncontinue;
+size_t ZStatMark::_ndrained;
+size_t ZStatMark::_npartialarrays;
+size_t ZStatMark::_nsteals;
+size_t ZStatMark::_stack_space_used;
+size_t ZStatMark::_stack_space_committed_before;
+size_t ZStatMark::_stack_space_committed_after;
+uint ZStatMark::_nworkers;
+size_t ZStatMark::_nobjects;
+size_t ZStatMark::_nbytes;
+uint64_t ZStatMark::_mark_time;
+uint64_t ZStatMark::_terminate_time;
+size_t ZStatMark::_ncacheentries;
+size_t ZStatMark::_ncacheevictions;
+size_t ZStatMark::_nfinalizable_objects;
+size_t ZStatMark::_nfinalizable_bytes;
 
 void ZStatMark::set_at_mark_start(size_t nstripes) {
   _nstripes = nstripes;
@@ -1102,11 +1795,49 @@ void ZStatMark::set_at_mark_start(size_t nstripes) {
 void ZStatMark::set_at_mark_end(size_t nproactiveflush,
                                 size_t nterminateflush,
                                 size_t ntrycomplete,
-                                size_t ncontinue) {
+                                size_t ncontinue,
+                                size_t ndrained,
+                                size_t npartialarrays,
+                                size_t nsteals) {
   _nproactiveflush = nproactiveflush;
   _nterminateflush = nterminateflush;
   _ntrycomplete = ntrycomplete;
   _ncontinue = ncontinue;
+  _ndrained = ndrained;
+  _npartialarrays = npartialarrays;
+  _nsteals = nsteals;
+}
+
+void ZStatMark::set_at_mark_end_throughput(uint nworkers,
+                                           size_t nobjects,
+                                           size_t nbytes,
+                                           uint64_t mark_time,
+                                           uint64_t terminate_time) {
+  _nworkers = nworkers;
+  _nobjects = nobjects;
+  _nbytes = nbytes;
+  _mark_time = mark_time;
+  _terminate_time = terminate_time;
+}
+
+void ZStatMark::set_at_mark_end_cache(size_t ncacheentries,
+                                      size_t ncacheevictions) {
+  _ncacheentries = ncacheentries;
+  _ncacheevictions = ncacheevictions;
+}
+
+void ZStatMark::set_at_mark_end_finalizable(size_t nfinalizable_objects,
+                                            size_t nfinalizable_bytes) {
+  _nfinalizable_objects = nfinalizable_objects;
+  _nfinalizable_bytes = nfinalizable_bytes;
+}
+
+void ZStatMark::set_at_mark_free(size_t stack_space_used,
+                                 size_t stack_space_committed_before,
+                                 size_t stack_space_committed_after) {
+  _stack_space_used = stack_space_used;
+  _stack_space_committed_before = stack_space_committed_before;
+  _stack_space_committed_after = stack_space_committed_after;
 }
 
 void ZStatMark::print() {
@@ -1115,34 +1846,152 @@ void ZStatMark::print() {
                         SIZE_FORMAT " proactive flush(es), "
                         SIZE_FORMAT " terminate flush(es), "
                         SIZE_FORMAT " completion(s), "
-                        SIZE_FORMAT " continuation(s) ",
+                        SIZE_FORMAT " continuation(s), "
+                        SIZE_FORMAT " drained entries, "
+                        SIZE_FORMAT " partial array(s), "
+                        SIZE_FORMAT " steal(s), "
+                        "prefetch %s",
                         _nstripes,
                         _nproactiveflush,
                         _nterminateflush,
                         _ntrycomplete,
-                        _ncontinue);
+                        _ncontinue,
+                        _ndrained,
+                        _npartialarrays,
+                        _nsteals,
+                        ZMarkPrefetch ? "enabled" : "disabled");
+
+  // Throughput is relative to the time the workers spent marking, and the
+  // termination overhead is relative to the total worker time
+  const double mark_seconds = MAX2((double)_mark_time / NANOSECS_PER_SEC, 1e-9);
+  const double worker_time = MAX2((double)_mark_time * _nworkers, 1.0);
+  log_debug(gc, marking)("Mark Throughput: "
+                         "%u worker(s), "
+                         SIZE_FORMAT " object(s), "
+                         SIZE_FORMAT "M, "
+                         "%.3fms, "
+                         "%.0f objects/s, "
+                         "%.1fMB/s, "
+                         "termination %.3fms (%.1f%%)",
+                         _nworkers,
+                         _nobjects,
+                         _nbytes / M,
+                         (double)_mark_time / NANOSECS_PER_MILLISEC,
+                         _nobjects / mark_seconds,
+                         _nbytes / mark_seconds / M,
+                         (double)_terminate_time / NANOSECS_PER_MILLISEC,
+                         percent_of((double)_terminate_time, worker_time));
+
+  log_debug(gc, marking)("Mark Cache: "
+                         SIZE_FORMAT " entries (" SIZE_FORMAT "-way), "
+                         SIZE_FORMAT " eviction(s) (%.1f%% of objects)",
+                         _ncacheentries,
+                         ZMarkCacheWays,
+                         _ncacheevictions,
+                         percent_of(_ncacheevictions, _nobjects));
+
+  // Objects reached through a FinalReference referent before being reached
+  // strongly are first marked as finalizable. Their share of the marked
+  // objects and bytes approximates the share of the mark time spent on
+  // finalizable marking, which is not timed separately since marking
+  // interleaves both kinds of entries.
+  log_debug(gc, marking)("Mark Finalizable: "
+                         SIZE_FORMAT " object(s) (%.1f%%), "
+                         SIZE_FORMAT "M (%.1f%%)",
+                         _nfinalizable_objects,
+                         percent_of(_nfinalizable_objects, _nobjects),
+                         _nfinalizable_bytes / M,
+                         percent_of(_nfinalizable_bytes, _nbytes));
+
+  log_info(gc, marking)("Mark Stack Space: "
+                        SIZE_FORMAT "M used, "
+                        SIZE_FORMAT "M->" SIZE_FORMAT "M committed",
+                        _stack_space_used / M,
+                        _stack_space_committed_before / M,
+                        _stack_space_committed_after / M);
 }
 
 //
 // Stat relocation
 //
 size_t ZStatRelocation::_relocating;
-bool ZStatRelocation::_success;
-
-void ZStatRelocation::set_at_select_relocation_set(size_t relocating) {
+size_t ZStatRelocation::_in_place;
+size_t ZStatRelocation::_reserve;
+size_t ZStatRelocation::_reserve_used;
+size_t ZStatRelocation::_live;
+size_t ZStatRelocation::_live_tenured;
+size_t ZStatRelocation::_followed;
+Tickspan ZStatRelocation::_duration;
+Tickspan ZStatRelocation::_tail;
+NumberSeq ZStatRelocation::_throughput(0.3 /* alpha */);
+
+void ZStatRelocation::set_at_select_relocation_set(size_t relocating, size_t live, size_t live_tenured) {
   _relocating = relocating;
+  _live = live;
+  _live_tenured = live_tenured;
+}
+
+void ZStatRelocation::set_at_relocate_end(size_t in_place, size_t followed, const Tickspan& duration, const Tickspan& tail) {
+  _in_place = in_place;
+  _followed = followed;
+  _duration = duration;
+  _tail = tail;
+
+  if (_relocating > 0 && duration.seconds() > 0.0) {
+    // Track relocated bytes per second
+    _throughput.add(_relocating / duration.seconds());
+  }
+}
+
+void ZStatRelocation::set_at_relocate_end_reserve(size_t reserve, size_t reserve_used) {
+  _reserve = reserve;
+  _reserve_used = reserve_used;
+}
+
+bool ZStatRelocation::is_throughput_trustable() {
+  // The throughput is considered trustable once
+  // at least one relocation phase has been measured
+  return _throughput.num() > 0;
 }
 
-void ZStatRelocation::set_at_relocate_end(bool success) {
-  _success = success;
+double ZStatRelocation::throughput() {
+  return _throughput.davg();
 }
 
 void ZStatRelocation::print() {
-  if (_success) {
+  if (_in_place == 0) {
     log_info(gc, reloc)("Relocation: Successful, " SIZE_FORMAT "M relocated", _relocating / M);
   } else {
-    log_info(gc, reloc)("Relocation: Incomplete");
+    log_info(gc, reloc)("Relocation: Successful, " SIZE_FORMAT "M relocated, " SIZE_FORMAT " pages relocated in-place",
+                        _relocating / M, _in_place);
+  }
+
+  // Reserve available to relocation, and how much of it was used. Pages
+  // relocated in-place despite an unused reserve point at fragmentation
+  // of the to-space rather than at a too small reserve.
+  log_debug(gc, reloc)("Relocation Reserve: " SIZE_FORMAT "M, " SIZE_FORMAT "M used (%.0f%%)",
+                       _reserve / M, _reserve_used / M, percent_of(_reserve_used, _reserve));
+
+  // Throughput of the relocation workers, measured in bytes copied per
+  // second. Objects relocated by mutators are included, since they are
+  // part of the relocated bytes and shorten the time taken by the workers.
+  const double seconds = _duration.seconds();
+  log_debug(gc, reloc)("Relocation Throughput: %.1fMB/s",
+                       (seconds > 0.0) ? (_relocating / seconds) / M : 0.0);
+
+  // Time the relocation was held up by the slowest workers, or by
+  // threads assisting while stalled on allocation, after the first
+  // worker ran out of pages to relocate
+  log_debug(gc, reloc)("Relocation Tail: %.3fms (%.0f%%)",
+                       TimeHelper::counter_to_millis(_tail.value()),
+                       percent_of(_tail.value(), _duration.value()));
+
+  if (ZRelocateInReferenceOrder) {
+    log_info(gc, reloc)("Relocation Order: " SIZE_FORMAT " objects relocated in reference order", _followed);
   }
+
+  log_debug(gc, reloc)("Live Age: " SIZE_FORMAT "M young, " SIZE_FORMAT "M tenured (%.0f%%)",
+                       (_live - _live_tenured) / M, _live_tenured / M, percent_of(_live_tenured, _live));
 }
 
 //
@@ -1223,6 +2072,7 @@ ZStatHeap::ZAtMarkStart ZStatHeap::_at_mark_start;
 ZStatHeap::ZAtMarkEnd ZStatHeap::_at_mark_end;
 ZStatHeap::ZAtRelocateStart ZStatHeap::_at_relocate_start;
 ZStatHeap::ZAtRelocateEnd ZStatHeap::_at_relocate_end;
+size_t ZStatHeap::_live_by_age[ZObjectAgeTableSize];
 
 size_t ZStatHeap::capacity_high() {
   return MAX4(_at_mark_start.capacity,
@@ -1243,7 +2093,8 @@ size_t ZStatHeap::available(size_t used) {
 }
 
 size_t ZStatHeap::reserve(size_t used) {
-  return MIN2(_at_initialize.max_reserve, available(used));
+  // The reserve is resized each cycle with ZAdaptiveRelocationReserve
+  return MIN2(ZHeap::heap()->max_reserve(), available(used));
 }
 
 size_t ZStatHeap::free(size_t used) {
@@ -1279,9 +2130,13 @@ void ZStatHeap::set_at_mark_end(size_t capacity,
 }
 
 void ZStatHeap::set_at_select_relocation_set(size_t live,
+                                             const size_t* live_by_age,
                                              size_t garbage,
                                              size_t reclaimed) {
   _at_mark_end.live = live;
+  for (size_t i = 0; i < ZObjectAgeTableSize; i++) {
+    _live_by_age[i] = live_by_age[i];
+  }
   _at_mark_end.garbage = garbage;
 
   _at_relocate_start.garbage = garbage - reclaimed;
@@ -1423,4 +2278,51 @@ void ZStatHeap::print() {
                      .left(ZTABLE_ARGS_NA)
                      .left(ZTABLE_ARGS_NA)
                      .end());
+
+  print_age_table();
+  print_json();
+}
+
+void ZStatHeap::print_age_table() {
+  LogTarget(Debug, gc, age) log;
+  if (!log.is_enabled()) {
+    return;
+  }
+
+  log.print("Age Table (Tenuring Threshold: %u):", ZTenuringThreshold);
+  for (size_t i = 0; i < ZObjectAgeTableSize; i++) {
+    if (_live_by_age[i] > 0) {
+      log.print("- Age %2u%s " ZSIZE_FMT,
+                (uint)i, (i == ZObjectAgeTableSize - 1) ? "+:" : ": ",
+                ZSIZE_ARGS(_live_by_age[i]));
+    }
+  }
+}
+
+void ZStatHeap::print_json() {
+  LogTarget(Info, gc, stats, json) log;
+  if (!log.is_enabled()) {
+    return;
+  }
+
+  LogStream stream(log);
+  stream.print("{\"type\":\"cycle\",\"time\":%.3f,\"gcId\":%u,", os::elapsedTime(), GCId::current());
+  stream.print("\"initialize\":{\"minCapacity\":" SIZE_FORMAT ",\"maxCapacity\":" SIZE_FORMAT ",\"maxReserve\":" SIZE_FORMAT "},",
+               _at_initialize.min_capacity, _at_initialize.max_capacity, _at_initialize.max_reserve);
+  stream.print("\"markStart\":{\"softMaxCapacity\":" SIZE_FORMAT ",\"capacity\":" SIZE_FORMAT ",\"reserve\":" SIZE_FORMAT
+               ",\"used\":" SIZE_FORMAT ",\"free\":" SIZE_FORMAT "},",
+               _at_mark_start.soft_max_capacity, _at_mark_start.capacity, _at_mark_start.reserve,
+               _at_mark_start.used, _at_mark_start.free);
+  stream.print("\"markEnd\":{\"capacity\":" SIZE_FORMAT ",\"reserve\":" SIZE_FORMAT ",\"allocated\":" SIZE_FORMAT
+               ",\"used\":" SIZE_FORMAT ",\"free\":" SIZE_FORMAT ",\"live\":" SIZE_FORMAT ",\"garbage\":" SIZE_FORMAT "},",
+               _at_mark_end.capacity, _at_mark_end.reserve, _at_mark_end.allocated,
+               _at_mark_end.used, _at_mark_end.free, _at_mark_end.live, _at_mark_end.garbage);
+  stream.print("\"relocateStart\":{\"capacity\":" SIZE_FORMAT ",\"reserve\":" SIZE_FORMAT ",\"garbage\":" SIZE_FORMAT
+               ",\"allocated\":" SIZE_FORMAT ",\"reclaimed\":" SIZE_FORMAT ",\"used\":" SIZE_FORMAT ",\"free\":" SIZE_FORMAT "},",
+               _at_relocate_start.capacity, _at_relocate_start.reserve, _at_relocate_start.garbage,
+               _at_relocate_start.allocated, _at_relocate_start.reclaimed, _at_relocate_start.used, _at_relocate_start.free);
+  stream.print_cr("\"relocateEnd\":{\"capacity\":" SIZE_FORMAT ",\"reserve\":" SIZE_FORMAT ",\"garbage\":" SIZE_FORMAT
+                  ",\"allocated\":" SIZE_FORMAT ",\"reclaimed\":" SIZE_FORMAT ",\"used\":" SIZE_FORMAT ",\"free\":" SIZE_FORMAT "}}",
+                  _at_relocate_end.capacity, _at_relocate_end.reserve, _at_relocate_end.garbage,
+                  _at_relocate_end.allocated, _at_relocate_end.reclaimed, _at_relocate_end.used, _at_relocate_end.free);
 }
@@ -27,6 +27,7 @@
 #include "gc/shared/concurrentGCThread.hpp"
 #include "gc/shared/gcCause.hpp"
 #include "gc/shared/gcTimer.hpp"
+#include "gc/z/zGlobals.hpp"
 #include "gc/z/zMetronome.hpp"
 #include "logging/logHandle.hpp"
 #include "memory/allocation.hpp"
@@ -35,9 +36,12 @@
 #include "utilities/ticks.hpp"
 
 class ZPage;
+class ZStatHistogramHistory;
+class ZStatHistogramSample;
 class ZStatSampler;
 class ZStatSamplerHistory;
 struct ZStatCounterData;
+struct ZStatHistogramData;
 struct ZStatSamplerData;
 
 //
@@ -48,6 +52,7 @@ typedef void (*ZStatUnitPrinter)(LogTargetHandle log, const ZStatSampler&, const
 void ZStatUnitTime(LogTargetHandle log, const ZStatSampler& sampler, const ZStatSamplerHistory& history);
 void ZStatUnitBytes(LogTargetHandle log, const ZStatSampler& sampler, const ZStatSamplerHistory& history);
 void ZStatUnitThreads(LogTargetHandle log, const ZStatSampler& sampler, const ZStatSamplerHistory& history);
+void ZStatUnitCycles(LogTargetHandle log, const ZStatSampler& sampler, const ZStatSamplerHistory& history);
 void ZStatUnitBytesPerSecond(LogTargetHandle log, const ZStatSampler& sampler, const ZStatSamplerHistory& history);
 void ZStatUnitOpsPerSecond(LogTargetHandle log, const ZStatSampler& sampler, const ZStatSamplerHistory& history);
 
@@ -126,6 +131,7 @@ public:
 
   ZStatSamplerData* get() const;
   ZStatSamplerData collect_and_reset() const;
+  void collect_and_reset(uint32_t cpu, ZStatSamplerData* all) const;
 
   ZStatUnitPrinter printer() const;
 };
@@ -135,7 +141,8 @@ public:
 //
 class ZStatCounter : public ZStatIterableValue<ZStatCounter> {
 private:
-  const ZStatSampler _sampler;
+  const ZStatSampler        _sampler;
+  mutable volatile uint64_t _total;
 
 public:
   ZStatCounter(const char* group,
@@ -143,7 +150,10 @@ public:
                ZStatUnitPrinter printer);
 
   ZStatCounterData* get() const;
-  void sample_and_reset() const;
+  uint64_t collect_and_reset(uint32_t cpu) const;
+  void sample(uint64_t counter, ZStatSamplerData* samples) const;
+
+  uint64_t total() const;
 };
 
 //
@@ -157,6 +167,30 @@ public:
   ZStatCounterData collect_and_reset() const;
 };
 
+//
+// Stat histogram
+//
+class ZStatHistogramBuckets : public AllStatic {
+public:
+  // Each power of two range of values is split into 4 buckets, which
+  // bounds the relative error to 25%. Values of 2^40 and above, which
+  // is more than 18 minutes when measured in nanoseconds, are all
+  // counted in the last bucket.
+  static const size_t count = 4 * 40;
+
+  static size_t index(uint64_t value);
+  static uint64_t upper(size_t index);
+  static uint64_t percentile(const volatile uint64_t* buckets, uint64_t nsamples, uint64_t max, double percent);
+};
+
+class ZStatHistogram : public ZStatIterableValue<ZStatHistogram> {
+public:
+  ZStatHistogram(const char* group, const char* name);
+
+  ZStatHistogramData* get() const;
+  void collect_and_reset(uint32_t cpu, ZStatHistogramSample* sample) const;
+};
+
 //
 // Stat MMU (Minimum Mutator Utilization)
 //
@@ -192,9 +226,64 @@ private:
 public:
   static void register_pause(const Ticks& start, const Ticks& end);
 
+  static double mmu_2ms();
+  static double mmu_5ms();
+  static double mmu_10ms();
+  static double mmu_20ms();
+  static double mmu_50ms();
+  static double mmu_100ms();
+
   static void print();
 };
 
+//
+// Stat latency histogram
+//
+class ZStatLatencyHistogram {
+private:
+  volatile uint64_t _buckets[ZStatHistogramBuckets::count];
+  volatile uint64_t _count;
+  volatile uint64_t _total;
+  volatile uint64_t _max;
+
+public:
+  ZStatLatencyHistogram();
+
+  void add(const Tickspan& duration);
+
+  uint64_t count() const;
+  uint64_t total() const;
+  uint64_t max() const;
+  uint64_t percentile(double percent) const;
+};
+
+class ZStatLatency : public AllStatic {
+private:
+  static ZStatLatencyHistogram _pauses;
+  static ZStatLatencyHistogram _allocation_stalls;
+
+public:
+  static void register_pause(const Tickspan& duration);
+  static void register_allocation_stall(const Tickspan& duration);
+
+  static const ZStatLatencyHistogram& pauses();
+  static const ZStatLatencyHistogram& allocation_stalls();
+};
+
+//
+// Stat CPU time
+//
+class ZStatCPUTime : public AllStatic {
+private:
+  static volatile uint64_t _workers; // Accumulated CPU time of GC workers (ns)
+
+public:
+  static uint64_t current_thread();
+  static void add_workers(uint64_t cpu_time);
+
+  static uint64_t now();
+};
+
 //
 // Stat phases
 //
@@ -231,16 +320,26 @@ class ZStatPhasePause : public ZStatPhase {
 private:
   static Tickspan _max; // Max pause time
 
+  const ZStatSampler _cpu_sampler;
+  const ZStatSampler _ttsp_sampler;
+  mutable uint64_t   _cpu_start;
+
 public:
   ZStatPhasePause(const char* name);
 
   static const Tickspan& max();
 
+  void register_time_to_safepoint() const;
+
   virtual void register_start(const Ticks& start) const;
   virtual void register_end(const Ticks& start, const Ticks& end) const;
 };
 
 class ZStatPhaseConcurrent : public ZStatPhase {
+private:
+  const ZStatSampler _cpu_sampler;
+  mutable uint64_t   _cpu_start;
+
 public:
   ZStatPhaseConcurrent(const char* name);
 
@@ -313,13 +412,50 @@ public:
   }
 };
 
+//
+// Stat time spent joined to the suspendible thread set without
+// yielding, which directly adds to time-to-safepoint
+//
+class ZStatSuspendibleTimer : public StackObj {
+private:
+  const ZStatSampler& _sampler;
+  const Ticks         _start;
+
+public:
+  ZStatSuspendibleTimer(const ZStatSampler& sampler) :
+      _sampler(sampler),
+      _start(Ticks::now()) {}
+
+  ~ZStatSuspendibleTimer();
+};
+
 //
 // Stat sample/increment
 //
 void ZStatSample(const ZStatSampler& sampler, uint64_t value);
+void ZStatSample(const ZStatHistogram& histogram, uint64_t value);
 void ZStatInc(const ZStatCounter& counter, uint64_t increment = 1);
 void ZStatInc(const ZStatUnsampledCounter& counter, uint64_t increment = 1);
 
+//
+// Stat trend
+//
+class ZStatTrend {
+private:
+  bool   _initialized;
+  double _level; // Units
+  double _slope; // Units per second
+
+public:
+  ZStatTrend();
+
+  void add(double value, double sample_interval);
+
+  double level() const;
+  double slope() const;
+  double predict(double seconds) const;
+};
+
 //
 // Stat allocation rate
 //
@@ -328,6 +464,7 @@ private:
   static const ZStatUnsampledCounter _counter;
   static TruncatedSeq                _rate;     // B/s
   static TruncatedSeq                _rate_avg; // B/s
+  static ZStatTrend                  _trend;    // B/s
 
 public:
   static const uint64_t sample_window_sec = 1; // seconds
@@ -336,6 +473,28 @@ public:
   static const ZStatUnsampledCounter& counter();
   static uint64_t sample_and_reset();
 
+  static double avg();
+  static double avg_sd();
+  static double trend();
+  static double predict(double seconds);
+  static const ZStatTrend& trend_data();
+
+  // Seed the allocation rate with that of a previous run
+  static void seed(double avg, double avg_sd);
+};
+
+//
+// Stat metaspace rate
+//
+class ZStatMetaspaceRate : public AllStatic {
+private:
+  static size_t       _last_committed;
+  static TruncatedSeq _rate;     // B/s
+  static TruncatedSeq _rate_avg; // B/s
+
+public:
+  static double sample(size_t committed);
+
   static double avg();
   static double avg_sd();
 };
@@ -349,9 +508,15 @@ private:
 
   ZMetronome _metronome;
 
-  void sample_and_collect(ZStatSamplerHistory* history) const;
+  void sample_and_collect(ZStatSamplerData* samples,
+                          uint64_t* counters,
+                          ZStatHistogramSample** histogram_samples,
+                          ZStatSamplerHistory* history,
+                          ZStatHistogramHistory* histogram_history,
+                          bool collect_histograms) const;
   bool should_print(LogTargetHandle log) const;
-  void print(LogTargetHandle log, const ZStatSamplerHistory* history) const;
+  void print_json(LogTargetHandle log, const ZStatSamplerData* samples) const;
+  void print(LogTargetHandle log, const ZStatSamplerHistory* history, const ZStatHistogramHistory* histogram_history) const;
 
 protected:
   virtual void run_service();
@@ -367,20 +532,39 @@ public:
 class ZStatCycle : public AllStatic {
 private:
   static uint64_t  _nwarmup_cycles;
+  static bool      _seeded;
   static Ticks     _start_of_last;
   static Ticks     _end_of_last;
+  static double    _excluded_duration;
   static NumberSeq _normalized_duration;
+  static uint64_t  _gc_cpu_at_start;
+  static double    _process_cpu_at_start;
+  static NumberSeq _cpu_overhead;
+
+  static void sample_cpu_overhead();
 
 public:
   static void at_start();
   static void at_end(GCCause::Cause cause, double boost_factor);
 
+  // Time spent in optional phases of the current cycle, such as
+  // Concurrent Remap, which is left out of the normalized duration
+  static void exclude_from_duration(const Tickspan& duration);
+
   static bool is_warm();
   static uint64_t nwarmup_cycles();
 
+  // Seed the normalized duration with that of a previous run,
+  // which makes it trustable without any warmup cycles
+  static void seed(double duration_avg, double duration_sd);
+
   static bool is_normalized_duration_trustable();
   static const AbsSeq& normalized_duration();
 
+  // Percentage of the process CPU time used by GC, sampled once per cycle,
+  // from the start of the previous cycle to the start of the current one
+  static const AbsSeq& cpu_overhead();
+
   static double time_since_last();
 };
 
@@ -402,13 +586,43 @@ private:
   static size_t _nterminateflush;
   static size_t _ntrycomplete;
   static size_t _ncontinue;
+  static size_t _ndrained;
+  static size_t _npartialarrays;
+  static size_t _nsteals;
+  static size_t _stack_space_used;
+  static size_t _stack_space_committed_before;
+  static size_t _stack_space_committed_after;
+  static uint _nworkers;
+  static size_t _nobjects;
+  static size_t _nbytes;
+  static uint64_t _mark_time;
+  static uint64_t _terminate_time;
+  static size_t _ncacheentries;
+  static size_t _ncacheevictions;
+  static size_t _nfinalizable_objects;
+  static size_t _nfinalizable_bytes;
 
 public:
   static void set_at_mark_start(size_t nstripes);
   static void set_at_mark_end(size_t nproactiveflush,
                               size_t nterminateflush,
                               size_t ntrycomplete,
-                              size_t ncontinue);
+                              size_t ncontinue,
+                              size_t ndrained,
+                              size_t npartialarrays,
+                              size_t nsteals);
+  static void set_at_mark_end_throughput(uint nworkers,
+                                         size_t nobjects,
+                                         size_t nbytes,
+                                         uint64_t mark_time,
+                                         uint64_t terminate_time);
+  static void set_at_mark_end_cache(size_t ncacheentries,
+                                    size_t ncacheevictions);
+  static void set_at_mark_end_finalizable(size_t nfinalizable_objects,
+                                          size_t nfinalizable_bytes);
+  static void set_at_mark_free(size_t stack_space_used,
+                               size_t stack_space_committed_before,
+                               size_t stack_space_committed_after);
 
   static void print();
 };
@@ -419,11 +633,23 @@ public:
 class ZStatRelocation : public AllStatic {
 private:
   static size_t _relocating;
-  static bool   _success;
+  static size_t _in_place;
+  static size_t _reserve;
+  static size_t _reserve_used;
+  static size_t _live;
+  static size_t _live_tenured;
+  static size_t _followed;
+  static Tickspan _duration;
+  static Tickspan _tail;
+  static NumberSeq _throughput;
 
 public:
-  static void set_at_select_relocation_set(size_t relocating);
-  static void set_at_relocate_end(bool success);
+  static void set_at_select_relocation_set(size_t relocating, size_t live, size_t live_tenured);
+  static void set_at_relocate_end(size_t in_place, size_t followed, const Tickspan& duration, const Tickspan& tail);
+  static void set_at_relocate_end_reserve(size_t reserve, size_t reserve_used);
+
+  static bool is_throughput_trustable();
+  static double throughput();
 
   static void print();
 };
@@ -524,6 +750,8 @@ private:
     size_t free_low;
   } _at_relocate_end;
 
+  static size_t _live_by_age[ZObjectAgeTableSize];
+
   static size_t capacity_high();
   static size_t capacity_low();
   static size_t available(size_t used);
@@ -541,6 +769,7 @@ public:
                               size_t allocated,
                               size_t used);
   static void set_at_select_relocation_set(size_t live,
+                                           const size_t* live_by_age,
                                            size_t garbage,
                                            size_t reclaimed);
   static void set_at_relocate_start(size_t capacity,
@@ -558,6 +787,8 @@ public:
   static size_t used_at_relocate_end();
 
   static void print();
+  static void print_age_table();
+  static void print_json();
 };
 
 #endif // SHARE_GC_Z_ZSTAT_HPP
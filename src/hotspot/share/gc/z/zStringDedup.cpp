@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/javaClasses.inline.hpp"
+#include "gc/shared/stringdedup/stringDedup.inline.hpp"
+#include "gc/shared/stringdedup/stringDedupQueue.inline.hpp"
+#include "gc/shared/stringdedup/stringDedupStat.hpp"
+#include "gc/shared/stringdedup/stringDedupTable.hpp"
+#include "gc/z/zStat.hpp"
+#include "gc/z/zStringDedup.hpp"
+#include "gc/z/zStringDedupQueue.hpp"
+#include "gc/z/zThread.inline.hpp"
+#include "oops/markWord.hpp"
+#include "oops/oop.inline.hpp"
+#include "runtime/safepoint.hpp"
+
+static const ZStatCounter ZCounterStringDedup("Memory", "String Deduplication", ZStatUnitBytesPerSecond);
+static const ZStatSubPhase ZSubPhasePauseWeakRootsStringDedup("Pause Weak Roots StringDedup");
+
+class ZStringDedupStat : public StringDedupStat {
+public:
+  virtual void deduped(oop obj, uintx bytes) {
+    StringDedupStat::deduped(obj, bytes);
+    ZStatInc(ZCounterStringDedup, bytes);
+  }
+};
+
+void ZStringDedup::initialize() {
+  StringDedup::initialize_impl<ZStringDedupQueue, ZStringDedupStat>();
+}
+
+void ZStringDedup::enqueue_candidate(oop obj) {
+  assert(is_enabled(), "String deduplication not enabled");
+  assert(ZThread::is_worker(), "Should be a worker");
+
+  if (!java_lang_String::is_instance_inlined(obj)) {
+    // Not a string
+    return;
+  }
+
+  // ZGC has no generations, so the age of a string is the number of
+  // GC cycles in which it has been strongly marked. The age is kept in
+  // the mark word, in the same way as for non-generational Shenandoah.
+  const markWord mark = obj->mark();
+  if (mark.age() >= StringDeduplicationAgeThreshold) {
+    // Already enqueued
+    return;
+  }
+
+  if (mark == markWord::INFLATING() || mark.has_displaced_mark_helper()) {
+    // Locked or inflated, skip
+    return;
+  }
+
+  const markWord new_mark = mark.incr_age();
+  if (obj->cas_set_mark(new_mark, mark) != mark) {
+    // Mark word changed, skip until next cycle
+    return;
+  }
+
+  if (new_mark.age() == StringDeduplicationAgeThreshold) {
+    // Reached age threshold, enqueue
+    StringDedupQueue::push(ZThread::worker_id(), obj);
+  }
+}
+
+void ZStringDedup::weak_oops_do_begin() {
+  assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
+  StringDedup::gc_prologue(true /* resize_and_rehash_table */);
+}
+
+void ZStringDedup::weak_oops_do(BoolObjectClosure* is_alive, OopClosure* keep_alive) {
+  ZStatTimer timer(ZSubPhasePauseWeakRootsStringDedup);
+  StringDedupUnlinkOrOopsDoClosure cl(is_alive, keep_alive);
+  StringDedup::parallel_unlink(&cl, ZThread::worker_id());
+}
+
+void ZStringDedup::weak_oops_do_end() {
+  assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
+  StringDedup::gc_epilogue();
+
+  // Hand over the candidates found during marking to the deduplication thread
+  ZStringDedupQueue::publish();
+}
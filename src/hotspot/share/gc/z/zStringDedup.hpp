@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZSTRINGDEDUP_HPP
+#define SHARE_GC_Z_ZSTRINGDEDUP_HPP
+
+#include "gc/shared/stringdedup/stringDedup.hpp"
+#include "memory/allocation.hpp"
+#include "oops/oopsHierarchy.hpp"
+
+class BoolObjectClosure;
+class OopClosure;
+
+class ZStringDedup : public StringDedup {
+public:
+  static void initialize();
+
+  // Called by GC workers when strongly marking an object
+  static void enqueue_candidate(oop obj);
+
+  // Called in the mark end pause, to unlink dead and heal live
+  // entries in the deduplication queue and table
+  static void weak_oops_do_begin();
+  static void weak_oops_do(BoolObjectClosure* is_alive, OopClosure* keep_alive);
+  static void weak_oops_do_end();
+};
+
+#endif // SHARE_GC_Z_ZSTRINGDEDUP_HPP
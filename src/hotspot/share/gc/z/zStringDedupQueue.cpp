@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/shared/stringdedup/stringDedup.hpp"
+#include "gc/z/zArray.inline.hpp"
+#include "gc/z/zLock.inline.hpp"
+#include "gc/z/zStringDedupQueue.hpp"
+#include "gc/z/zValue.inline.hpp"
+#include "logging/log.hpp"
+#include "oops/access.inline.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/safepoint.hpp"
+#include "utilities/debug.hpp"
+
+ZStringDedupQueue::ZStringDedupQueue() :
+    _producers(),
+    _lock(),
+    _consumer(),
+    _consumer_next(0),
+    _cancel(false),
+    _npublished(0),
+    _ndropped(0) {}
+
+ZArray<oop>* ZStringDedupQueue::queue_at(size_t queue) {
+  // Producer queues first, followed by the consumer queue
+  if (queue < ZPerWorkerStorage::count()) {
+    return _producers.addr((uint32_t)queue);
+  }
+
+  assert(queue == ZPerWorkerStorage::count(), "Invalid queue");
+  return &_consumer;
+}
+
+size_t ZStringDedupQueue::num_queues() const {
+  return ZPerWorkerStorage::count() + 1;
+}
+
+void ZStringDedupQueue::publish() {
+  static_cast<ZStringDedupQueue*>(queue())->publish_impl();
+}
+
+void ZStringDedupQueue::publish_impl() {
+  assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
+
+  ZLocker<ZConditionLock> locker(&_lock);
+
+  // Compact consumer queue, dropping already popped and unlinked candidates
+  ZArray<oop> consumer;
+  for (size_t i = _consumer_next; i < _consumer.size(); i++) {
+    const oop obj = _consumer.at(i);
+    if (obj != NULL) {
+      consumer.add(obj);
+    }
+  }
+
+  // Move candidates from producer queues to consumer queue
+  ZPerWorkerIterator<ZArray<oop> > iter(&_producers);
+  for (ZArray<oop>* producer; iter.next(&producer);) {
+    for (size_t i = 0; i < producer->size(); i++) {
+      const oop obj = producer->at(i);
+      if (obj != NULL) {
+        consumer.add(obj);
+        _npublished++;
+      }
+    }
+
+    // Free producer queue
+    ZArray<oop> empty;
+    empty.transfer(producer);
+  }
+
+  // Install compacted consumer queue
+  ZArray<oop> old;
+  old.transfer(&_consumer);
+  _consumer.transfer(&consumer);
+  _consumer_next = 0;
+
+  if (!_consumer.is_empty()) {
+    // Wake up deduplication thread
+    _lock.notify_all();
+  }
+}
+
+void ZStringDedupQueue::wait_impl() {
+  ZLocker<ZConditionLock> locker(&_lock);
+  while (_consumer_next == _consumer.size() && !_cancel) {
+    _lock.wait();
+  }
+}
+
+void ZStringDedupQueue::cancel_wait_impl() {
+  ZLocker<ZConditionLock> locker(&_lock);
+  _cancel = true;
+  _lock.notify_all();
+}
+
+void ZStringDedupQueue::push_impl(uint worker_id, oop java_string) {
+  // Only the owning worker pushes to a producer queue, and only while
+  // the consumer does not access it, so no locking is needed.
+  ZArray<oop>* const producer = _producers.addr(worker_id);
+  if (producer->size() >= max_size) {
+    // Queue full, drop candidate
+    Atomic::inc(&_ndropped);
+    return;
+  }
+
+  producer->add(java_string);
+}
+
+oop ZStringDedupQueue::pop_impl() {
+  ZLocker<ZConditionLock> locker(&_lock);
+
+  while (_consumer_next < _consumer.size()) {
+    oop* const p = _consumer.addr(_consumer_next++);
+    const oop obj = NativeAccess<ON_PHANTOM_OOP_REF>::oop_load(p);
+    if (obj != NULL) {
+      return obj;
+    }
+  }
+
+  // Consumer queue drained, free it
+  ZArray<oop> empty;
+  empty.transfer(&_consumer);
+  _consumer_next = 0;
+
+  return NULL;
+}
+
+void ZStringDedupQueue::unlink_or_oops_do_impl(StringDedupUnlinkOrOopsDoClosure* cl, size_t queue) {
+  ZArray<oop>* const array = queue_at(queue);
+  const size_t start = (array == &_consumer) ? _consumer_next : 0;
+
+  for (size_t i = start; i < array->size(); i++) {
+    oop* const p = array->addr(i);
+    if (*p != NULL) {
+      if (cl->is_alive(*p)) {
+        cl->keep_alive(p);
+      } else {
+        // Clear dead candidate
+        *p = NULL;
+      }
+    }
+  }
+}
+
+void ZStringDedupQueue::print_statistics_impl() {
+  ZLocker<ZConditionLock> locker(&_lock);
+  log_debug(gc, stringdedup)("  Queue");
+  log_debug(gc, stringdedup)("    Published: " SIZE_FORMAT ", Dropped: " SIZE_FORMAT ", Pending: " SIZE_FORMAT,
+                             _npublished, Atomic::load(&_ndropped), _consumer.size() - _consumer_next);
+}
+
+void ZStringDedupQueue::verify_impl() {
+  ZLocker<ZConditionLock> locker(&_lock);
+  guarantee(_consumer_next <= _consumer.size(), "Invalid consumer queue");
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZSTRINGDEDUPQUEUE_HPP
+#define SHARE_GC_Z_ZSTRINGDEDUPQUEUE_HPP
+
+#include "gc/shared/stringdedup/stringDedupQueue.hpp"
+#include "gc/z/zArray.hpp"
+#include "gc/z/zLock.hpp"
+#include "gc/z/zValue.hpp"
+
+//
+// Candidates are pushed by GC workers during marking, each worker to
+// its own producer queue, without any locking. In the mark end pause,
+// after dead candidates have been unlinked, all producer queues are
+// published to the consumer queue, from which the deduplication thread
+// pops candidates. Candidates are loaded with a phantom load barrier,
+// since they are not necessarily good once relocation has started.
+//
+class ZStringDedupQueue : public StringDedupQueue {
+private:
+  static const size_t max_size = 1000000;
+
+  ZPerWorker<ZArray<oop> > _producers;
+  ZConditionLock           _lock;
+  ZArray<oop>              _consumer;
+  size_t                   _consumer_next;
+  bool                     _cancel;
+  size_t                   _npublished;
+  volatile size_t          _ndropped;
+
+  ZArray<oop>* queue_at(size_t queue);
+  void publish_impl();
+
+public:
+  ZStringDedupQueue();
+
+  static void publish();
+
+  virtual void wait_impl();
+  virtual void cancel_wait_impl();
+
+  virtual void push_impl(uint worker_id, oop java_string);
+  virtual oop pop_impl();
+
+  virtual void unlink_or_oops_do_impl(StringDedupUnlinkOrOopsDoClosure* cl, size_t queue);
+
+  virtual void print_statistics_impl();
+  virtual void verify_impl();
+
+  virtual size_t num_queues() const;
+};
+
+#endif // SHARE_GC_Z_ZSTRINGDEDUPQUEUE_HPP
@@ -22,21 +22,76 @@
  */
 
 #include "precompiled.hpp"
+#include "gc/z/zStat.hpp"
 #include "gc/z/zTask.hpp"
 #include "gc/z/zThread.hpp"
+#include "gc/z/zThreadPolicy.hpp"
+#include "runtime/atomic.hpp"
 
 ZTask::GangTask::GangTask(ZTask* ztask, const char* name) :
     AbstractGangTask(name),
-    _ztask(ztask) {}
+    _ztask(ztask),
+    _first_start(max_jlong),
+    _last_end(0) {}
+
+void ZTask::GangTask::register_start(jlong start) {
+  jlong prev = Atomic::load(&_first_start);
+  while (start < prev) {
+    const jlong fetched = Atomic::cmpxchg(&_first_start, prev, start);
+    if (fetched == prev) {
+      break;
+    }
+    prev = fetched;
+  }
+}
+
+void ZTask::GangTask::register_end(jlong end) {
+  jlong prev = Atomic::load(&_last_end);
+  while (end > prev) {
+    const jlong fetched = Atomic::cmpxchg(&_last_end, prev, end);
+    if (fetched == prev) {
+      break;
+    }
+    prev = fetched;
+  }
+}
+
+void ZTask::GangTask::reset_dispatch() {
+  _first_start = max_jlong;
+  _last_end = 0;
+}
+
+uint64_t ZTask::GangTask::dispatch_overhead(const Ticks& start, const Ticks& end) const {
+  const jlong first_start = Atomic::load(&_first_start);
+  const jlong last_end = Atomic::load(&_last_end);
+  if (first_start == max_jlong) {
+    // Not executed
+    return 0;
+  }
+
+  return MAX2(first_start - start.value(), (jlong)0) +
+         MAX2(end.value() - last_end, (jlong)0);
+}
 
 void ZTask::GangTask::work(uint worker_id) {
+  register_start(Ticks::now().value());
+
+  const uint64_t cpu_start = ZStatCPUTime::current_thread();
+
   ZThread::set_worker_id(worker_id);
+  ZThreadPolicy::set_current_thread_low_priority(_ztask->is_low_priority());
   _ztask->work();
   ZThread::clear_worker_id();
+
+  // Account CPU time to the phase running the task
+  ZStatCPUTime::add_workers(ZStatCPUTime::current_thread() - cpu_start);
+
+  register_end(Ticks::now().value());
 }
 
 ZTask::ZTask(const char* name) :
-    _gang_task(this, name) {}
+    _gang_task(this, name),
+    _low_priority(false) {}
 
 const char* ZTask::name() const {
   return _gang_task.name();
@@ -45,3 +100,19 @@ const char* ZTask::name() const {
 AbstractGangTask* ZTask::gang_task() {
   return &_gang_task;
 }
+
+void ZTask::reset_dispatch() {
+  _gang_task.reset_dispatch();
+}
+
+uint64_t ZTask::dispatch_overhead(const Ticks& start, const Ticks& end) const {
+  return _gang_task.dispatch_overhead(start, end);
+}
+
+bool ZTask::is_low_priority() const {
+  return _low_priority;
+}
+
+void ZTask::set_low_priority(bool low_priority) {
+  _low_priority = low_priority;
+}
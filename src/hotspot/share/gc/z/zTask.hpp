@@ -26,20 +26,30 @@
 
 #include "gc/shared/workgroup.hpp"
 #include "memory/allocation.hpp"
+#include "utilities/ticks.hpp"
 
 class ZTask : public StackObj {
 private:
   class GangTask : public AbstractGangTask {
   private:
-    ZTask* const _ztask;
+    ZTask* const   _ztask;
+    volatile jlong _first_start;
+    volatile jlong _last_end;
+
+    void register_start(jlong start);
+    void register_end(jlong end);
 
   public:
     GangTask(ZTask* ztask, const char* name);
 
+    void reset_dispatch();
+    uint64_t dispatch_overhead(const Ticks& start, const Ticks& end) const;
+
     virtual void work(uint worker_id);
   };
 
   GangTask _gang_task;
+  bool     _low_priority;
 
 public:
   ZTask(const char* name);
@@ -47,6 +57,13 @@ public:
   const char* name() const;
   AbstractGangTask* gang_task();
 
+  // Ticks spent starting the first worker and joining the last
+  void reset_dispatch();
+  uint64_t dispatch_overhead(const Ticks& start, const Ticks& end) const;
+
+  bool is_low_priority() const;
+  void set_low_priority(bool low_priority);
+
   virtual void work() = 0;
 };
 
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zTaskRange.inline.hpp"
+#include "gc/z/zWorkers.hpp"
+#include "memory/allocation.inline.hpp"
+#include "runtime/atomic.hpp"
+#include "utilities/align.hpp"
+
+ZTaskRange::ZTaskRange() :
+    _slots(NULL),
+    _nslots(0),
+    _size(0),
+    _chunk_size(1),
+    _block_size(1),
+    _cursor(0) {}
+
+ZTaskRange::ZTaskRange(size_t size, size_t chunk_size) :
+    _slots(NULL),
+    _nslots(0),
+    _size(0),
+    _chunk_size(1),
+    _block_size(1),
+    _cursor(0) {
+  reset(size, chunk_size);
+}
+
+ZTaskRange::~ZTaskRange() {
+  FREE_C_HEAP_ARRAY(Slot, _slots);
+}
+
+void ZTaskRange::reset(size_t size, size_t chunk_size) {
+  assert(size <= max_juint, "Range too large");
+  assert(chunk_size > 0, "Invalid chunk size");
+
+  if (_slots == NULL) {
+    // Allocated on first use, since the number of
+    // workers is not known when static instances
+    // are constructed
+    _nslots = ZWorkers::nworkers_max();
+    _slots = NEW_C_HEAP_ARRAY(Slot, _nslots, mtGC);
+  }
+
+  for (uint i = 0; i < _nslots; i++) {
+    _slots[i]._range = encode(0, 0);
+  }
+
+  // Split the range in one block per worker, so that all workers
+  // get a share of the range even when the range is small, without
+  // going below the chunk size
+  _size = size;
+  _chunk_size = chunk_size;
+  _block_size = MAX2(chunk_size, align_up(size / _nslots, chunk_size));
+  _cursor = 0;
+}
+
+bool ZTaskRange::is_claimed() const {
+  if (Atomic::load(&_cursor) < _size) {
+    return false;
+  }
+
+  for (uint i = 0; i < _nslots; i++) {
+    const uint64_t range = Atomic::load(&_slots[i]._range);
+    if (decode_start(range) != decode_end(range)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool ZTaskRange::claim_block(uint worker_id, size_t* start, size_t* end) {
+  if (Atomic::load(&_cursor) >= _size) {
+    // No blocks left
+    return false;
+  }
+
+  // Workers claim a whole block, other threads a single chunk
+  const size_t claim_size = (worker_id != no_worker) ? _block_size : _chunk_size;
+  const size_t claim_start = Atomic::add(&_cursor, claim_size) - claim_size;
+  if (claim_start >= _size) {
+    // No blocks left
+    return false;
+  }
+
+  const size_t claim_end = MIN2(claim_start + claim_size, _size);
+  const size_t chunk_end = MIN2(claim_start + _chunk_size, claim_end);
+  if (chunk_end < claim_end) {
+    // Keep the rest of the block
+    install(worker_id, chunk_end, claim_end);
+  }
+
+  *start = claim_start;
+  *end = chunk_end;
+  return true;
+}
+
+bool ZTaskRange::steal(uint worker_id, size_t* start, size_t* end) {
+  // Visit the other workers in order, starting with the next worker,
+  // to spread thieves over victims
+  const uint first = (worker_id != no_worker) ? worker_id + 1 : 0;
+
+  for (uint i = 0; i < _nslots; i++) {
+    const uint victim = (first + i) % _nslots;
+    if (victim == worker_id) {
+      continue;
+    }
+
+    Slot* const slot = _slots + victim;
+
+    for (uint64_t range = Atomic::load_acquire(&slot->_range);;) {
+      const size_t range_start = decode_start(range);
+      const size_t range_end = decode_end(range);
+      if (range_start == range_end) {
+        // Empty, try next victim
+        break;
+      }
+
+      // Workers steal the upper half, other threads a single chunk
+      const size_t remaining = range_end - range_start;
+      const size_t steal_size = (worker_id != no_worker) ? MAX2(remaining / 2, MIN2(remaining, _chunk_size))
+                                                        : MIN2(remaining, _chunk_size);
+      const size_t steal_start = range_end - steal_size;
+      const uint64_t prev_range = Atomic::cmpxchg(&slot->_range, range, encode(range_start, steal_start));
+      if (prev_range != range) {
+        // Retry
+        range = prev_range;
+        continue;
+      }
+
+      const size_t chunk_end = MIN2(steal_start + _chunk_size, range_end);
+      if (chunk_end < range_end) {
+        // Keep the rest of the stolen part
+        install(worker_id, chunk_end, range_end);
+      }
+
+      *start = steal_start;
+      *end = chunk_end;
+      return true;
+    }
+  }
+
+  // Nothing left to steal
+  return false;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZTASKRANGE_HPP
+#define SHARE_GC_Z_ZTASKRANGE_HPP
+
+#include "gc/z/zGlobals.hpp"
+#include "memory/allocation.hpp"
+
+//
+// Range of indices claimed in chunks by the threads executing a ZTask,
+// with work stealing. Each worker first claims a block of the range,
+// which it then processes one chunk at a time. When no blocks are left,
+// a worker steals the upper half of the remaining part of the block of
+// another worker. Threads that are not GC workers, such as threads
+// assisting the GC, claim single chunks of blocks or steal single chunks
+// from the workers.
+//
+// A block is encoded as the start and end index of its remaining part,
+// packed into a single 64-bit word, so ranges are limited to 2^32
+// indices.
+//
+class ZTaskRange : public CHeapObj<mtGC> {
+private:
+  struct Slot {
+    volatile uint64_t _range;
+    uint8_t           _pad[ZCacheLineSize - sizeof(uint64_t)];
+  };
+
+  Slot*                          _slots;
+  uint                           _nslots;
+  size_t                         _size;
+  size_t                         _chunk_size;
+  size_t                         _block_size;
+  ZCACHE_ALIGNED volatile size_t _cursor;
+
+  static uint64_t encode(size_t start, size_t end);
+  static size_t decode_start(uint64_t range);
+  static size_t decode_end(uint64_t range);
+
+  void install(uint worker_id, size_t start, size_t end);
+  bool claim_chunk(uint worker_id, size_t* start, size_t* end);
+  bool claim_block(uint worker_id, size_t* start, size_t* end);
+  bool steal(uint worker_id, size_t* start, size_t* end);
+
+public:
+  static const uint no_worker = (uint)-1;
+
+  ZTaskRange();
+  ZTaskRange(size_t size, size_t chunk_size);
+  ~ZTaskRange();
+
+  void reset(size_t size, size_t chunk_size);
+
+  bool is_claimed() const;
+
+  bool next(size_t* start, size_t* end);
+  bool next(uint worker_id, size_t* start, size_t* end);
+};
+
+#endif // SHARE_GC_Z_ZTASKRANGE_HPP
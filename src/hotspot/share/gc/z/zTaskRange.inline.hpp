@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZTASKRANGE_INLINE_HPP
+#define SHARE_GC_Z_ZTASKRANGE_INLINE_HPP
+
+#include "gc/z/zTaskRange.hpp"
+#include "gc/z/zThread.inline.hpp"
+#include "runtime/atomic.hpp"
+#include "utilities/debug.hpp"
+
+inline uint64_t ZTaskRange::encode(size_t start, size_t end) {
+  return ((uint64_t)start << 32) | (uint64_t)end;
+}
+
+inline size_t ZTaskRange::decode_start(uint64_t range) {
+  return (size_t)(range >> 32);
+}
+
+inline size_t ZTaskRange::decode_end(uint64_t range) {
+  return (size_t)(range & 0xffffffff);
+}
+
+inline void ZTaskRange::install(uint worker_id, size_t start, size_t end) {
+  // The slot of a worker is only written by other threads while it is
+  // non-empty, so an empty slot can be refilled with a plain store
+  Slot* const slot = _slots + worker_id;
+  assert(decode_start(slot->_range) == decode_end(slot->_range), "Slot not empty");
+  Atomic::release_store(&slot->_range, encode(start, end));
+}
+
+inline bool ZTaskRange::claim_chunk(uint worker_id, size_t* start, size_t* end) {
+  // Claim a chunk from the start of our own block
+  Slot* const slot = _slots + worker_id;
+
+  for (uint64_t range = Atomic::load_acquire(&slot->_range);;) {
+    const size_t range_start = decode_start(range);
+    const size_t range_end = decode_end(range);
+    if (range_start == range_end) {
+      // Empty
+      return false;
+    }
+
+    const size_t chunk_end = MIN2(range_start + _chunk_size, range_end);
+    const uint64_t prev_range = Atomic::cmpxchg(&slot->_range, range, encode(chunk_end, range_end));
+    if (prev_range == range) {
+      // Success
+      *start = range_start;
+      *end = chunk_end;
+      return true;
+    }
+
+    // Retry
+    range = prev_range;
+  }
+}
+
+inline bool ZTaskRange::next(size_t* start, size_t* end) {
+  return next(ZThread::has_worker_id() ? ZThread::worker_id() : no_worker, start, end);
+}
+
+inline bool ZTaskRange::next(uint worker_id, size_t* start, size_t* end) {
+  assert(worker_id == no_worker || worker_id < _nslots, "Invalid worker id");
+
+  if (worker_id != no_worker && claim_chunk(worker_id, start, end)) {
+    return true;
+  }
+
+  return claim_block(worker_id, start, end) || steal(worker_id, start, end);
+}
+
+#endif // SHARE_GC_Z_ZTASKRANGE_INLINE_HPP
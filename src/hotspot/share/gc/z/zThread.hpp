@@ -29,6 +29,7 @@
 
 class ZThread : public AllStatic {
   friend class ZTask;
+  friend class ZTaskRange;
   friend class ZWorkersInitializeTask;
   friend class ZRuntimeWorkersInitializeTask;
 
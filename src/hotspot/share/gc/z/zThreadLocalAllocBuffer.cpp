@@ -23,17 +23,35 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zAddress.inline.hpp"
+#include "gc/z/zArray.inline.hpp"
+#include "gc/z/zGlobals.hpp"
+#include "gc/z/zLock.inline.hpp"
+#include "gc/z/zOop.inline.hpp"
+#include "gc/z/zPage.inline.hpp"
+#include "gc/z/zPageTable.inline.hpp"
 #include "gc/z/zThreadLocalAllocBuffer.hpp"
+#include "gc/z/zUtils.inline.hpp"
 #include "gc/z/zValue.inline.hpp"
+#include "logging/log.hpp"
+#include "memory/iterator.hpp"
+#include "memory/universe.hpp"
+#include "oops/oop.inline.hpp"
 #include "runtime/globals.hpp"
+#include "runtime/safepoint.hpp"
 #include "runtime/thread.hpp"
+#include "runtime/threadSMR.hpp"
+#include "utilities/quickSort.hpp"
 
-ZPerWorker<ThreadLocalAllocStats>* ZThreadLocalAllocBuffer::_stats = NULL;
+ZPerWorker<ThreadLocalAllocStats>*               ZThreadLocalAllocBuffer::_stats     = NULL;
+ZLock*                                           ZThreadLocalAllocBuffer::_kept_lock = NULL;
+ZArray<ZThreadLocalAllocBuffer::ZKeptRange>*     ZThreadLocalAllocBuffer::_kept      = NULL;
 
 void ZThreadLocalAllocBuffer::initialize() {
   if (UseTLAB) {
     assert(_stats == NULL, "Already initialized");
     _stats = new ZPerWorker<ThreadLocalAllocStats>();
+    _kept_lock = new ZLock();
+    _kept = new ZArray<ZKeptRange>();
     reset_statistics();
   }
 }
@@ -44,6 +62,9 @@ void ZThreadLocalAllocBuffer::reset_statistics() {
     for (ThreadLocalAllocStats* stats; iter.next(&stats);) {
       stats->reset();
     }
+
+    // Forget TLABs kept across the previous mark start
+    _kept->clear();
   }
 }
 
@@ -75,8 +96,157 @@ void ZThreadLocalAllocBuffer::retire(Thread* thread) {
   }
 }
 
+bool ZThreadLocalAllocBuffer::should_keep(Thread* thread) {
+  // Keep the TLAB if the thread would keep it on a failed
+  // allocation, i.e. if the space left is not worth wasting.
+  const ThreadLocalAllocBuffer& tlab = thread->tlab();
+  return ZKeepTLABsAtMarkStart && tlab.free() > tlab.refill_waste_limit();
+}
+
+void ZThreadLocalAllocBuffer::keep(Thread* thread) {
+  ThreadLocalAllocBuffer& tlab = thread->tlab();
+
+  // Objects allocated from the current top are implicitly live
+  ZKeptRange range;
+  range._start = ZAddress::offset((uintptr_t)tlab.top());
+  range._end = ZAddress::offset((uintptr_t)tlab.hard_end());
+  range._allocating = false;
+
+  {
+    ZLocker<ZLock> locker(_kept_lock);
+    _kept->add(range);
+  }
+
+  // Continue allocating with good addresses
+  tlab.addresses_do(fixup_address);
+}
+
+void ZThreadLocalAllocBuffer::retire_or_keep(Thread* thread) {
+  if (UseTLAB && thread->is_Java_thread()) {
+    if (should_keep(thread)) {
+      keep(thread);
+    } else {
+      retire(thread);
+    }
+  }
+}
+
 void ZThreadLocalAllocBuffer::remap(Thread* thread) {
   if (UseTLAB && thread->is_Java_thread()) {
     thread->tlab().addresses_do(fixup_address);
   }
 }
+
+int ZThreadLocalAllocBuffer::compare_kept(const ZKeptRange& a, const ZKeptRange& b) {
+  if (a._start < b._start) {
+    return -1;
+  } else if (a._start > b._start) {
+    return 1;
+  } else {
+    return 0;
+  }
+}
+
+void ZThreadLocalAllocBuffer::register_kept(const ZPageTable* page_table) {
+  assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
+
+  if (!UseTLAB || _kept->is_empty()) {
+    return;
+  }
+
+  // Sort for lookup
+  QuickSort::sort(_kept->addr(0), _kept->size(), compare_kept, false /* idempotent */);
+
+  // Mark pages that contain kept TLABs
+  ZArrayIterator<ZKeptRange> iter(_kept);
+  for (ZKeptRange range; iter.next(&range);) {
+    page_table->get(range._start)->set_kept_tlab();
+  }
+
+  log_debug(gc, tlab)("Kept TLABs: " SIZE_FORMAT, _kept->size());
+}
+
+bool ZThreadLocalAllocBuffer::is_kept(uintptr_t offset) {
+  // Find the last range starting at or below the offset
+  size_t low = 0;
+  size_t high = _kept->size();
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    if (_kept->at(mid)._start <= offset) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  return low > 0 && offset < _kept->at(low - 1)._end;
+}
+
+void ZThreadLocalAllocBuffer::kept_parsable_ranges(const ZPage* page, ZArray<ZKeptRange>* ranges) {
+  // Collect the kept ranges on this page
+  ZArrayIterator<ZKeptRange> iter(_kept);
+  for (ZKeptRange range; iter.next(&range);) {
+    if (range._start >= page->start() && range._start < page->end()) {
+      ranges->add(range);
+    }
+  }
+
+  if (ranges->is_empty()) {
+    return;
+  }
+
+  // A retired TLAB has its free space filled with a filler object, so
+  // the kept range is parsable up to its end. If the thread is still
+  // allocating in the TLAB, the range is only parsable up to its top.
+  for (JavaThreadIteratorWithHandle jtiwh; JavaThread* const thread = jtiwh.next(); ) {
+    ThreadLocalAllocBuffer& tlab = thread->tlab();
+    if (tlab.end() == NULL) {
+      // No TLAB
+      continue;
+    }
+
+    const uintptr_t start = ZAddress::offset((uintptr_t)tlab.start());
+    const uintptr_t end = ZAddress::offset((uintptr_t)tlab.hard_end());
+    if (end <= page->start() || start >= page->end()) {
+      // Not on this page
+      continue;
+    }
+
+    for (size_t i = 0; i < ranges->size(); i++) {
+      ZKeptRange* const range = ranges->addr(i);
+      if (start <= range->_start && range->_start < end) {
+        range->_end = ZAddress::offset((uintptr_t)tlab.top());
+        range->_allocating = true;
+        break;
+      }
+    }
+  }
+}
+
+void ZThreadLocalAllocBuffer::kept_object_iterate(const ZPage* page, ObjectClosure* cl) {
+  assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
+
+  ZArray<ZKeptRange> ranges;
+  kept_parsable_ranges(page, &ranges);
+
+  // Objects in a kept range are allocated back to back, so
+  // they are visited by walking the range linearly
+  ZArrayIterator<ZKeptRange> iter(&ranges);
+  for (ZKeptRange range; iter.next(&range);) {
+    for (uintptr_t offset = range._start; offset < range._end;) {
+      const uintptr_t addr = ZAddress::good(offset);
+      const size_t size = ZUtils::object_size(addr);
+      offset += size;
+
+      if (!range._allocating && offset == range._end) {
+        // Filler object inserted when the TLAB was retired. Mutators
+        // never allocate into the alignment reserve at the end of the
+        // TLAB, so the object ending at the hard end is the filler.
+        assert(ZOop::from_address(addr)->klass() == Universe::intArrayKlassObj(), "Should be a filler array");
+        break;
+      }
+
+      cl->do_object(ZOop::from_address(addr));
+    }
+  }
+}
@@ -25,12 +25,32 @@
 #define SHARE_GC_Z_ZTHREADLOCALALLOCBUFFER_HPP
 
 #include "gc/shared/threadLocalAllocBuffer.hpp"
+#include "gc/z/zArray.hpp"
+#include "gc/z/zLock.hpp"
 #include "gc/z/zValue.hpp"
 #include "memory/allocation.hpp"
 
+class ObjectClosure;
+class ZPage;
+class ZPageTable;
+
 class ZThreadLocalAllocBuffer : public AllStatic {
 private:
+  struct ZKeptRange {
+    uintptr_t _start;
+    uintptr_t _end;
+    bool      _allocating;
+  };
+
   static ZPerWorker<ThreadLocalAllocStats>* _stats;
+  static ZLock*                             _kept_lock;
+  static ZArray<ZKeptRange>*                _kept;
+
+  static int compare_kept(const ZKeptRange& a, const ZKeptRange& b);
+  static void kept_parsable_ranges(const ZPage* page, ZArray<ZKeptRange>* ranges);
+
+  static bool should_keep(Thread* thread);
+  static void keep(Thread* thread);
 
 public:
   static void initialize();
@@ -39,7 +59,13 @@ public:
   static void publish_statistics();
 
   static void retire(Thread* thread);
+  static void retire_or_keep(Thread* thread);
   static void remap(Thread* thread);
+
+  // TLABs kept across mark start
+  static void register_kept(const ZPageTable* page_table);
+  static bool is_kept(uintptr_t offset);
+  static void kept_object_iterate(const ZPage* page, ObjectClosure* cl);
 };
 
 #endif // SHARE_GC_Z_ZTHREADLOCALALLOCBUFFER_HPP
@@ -24,22 +24,31 @@
 #ifndef SHARE_GC_Z_ZTHREADLOCALDATA_HPP
 #define SHARE_GC_Z_ZTHREADLOCALDATA_HPP
 
+#include "gc/z/zForwardingCache.hpp"
 #include "gc/z/zMarkStack.hpp"
 #include "gc/z/zGlobals.hpp"
+#include "gc/z/zPartition.hpp"
 #include "runtime/thread.hpp"
 #include "utilities/debug.hpp"
 #include "utilities/sizes.hpp"
+#include "utilities/ticks.hpp"
 
 class ZThreadLocalData {
 private:
   uintptr_t              _address_bad_mask;
   ZMarkThreadLocalStacks _stacks;
   oop*                   _invisible_root;
+  uint8_t                _partition;
+  ZForwardingCache       _forwarding_cache;
+  Ticks                  _pacing_start;
 
   ZThreadLocalData() :
       _address_bad_mask(0),
       _stacks(),
-      _invisible_root(NULL) {}
+      _invisible_root(NULL),
+      _partition(ZPartitionUnresolved),
+      _forwarding_cache(),
+      _pacing_start() {}
 
   static ZThreadLocalData* data(Thread* thread) {
     return thread->gc_data<ZThreadLocalData>();
@@ -79,6 +88,26 @@ public:
     }
   }
 
+  static uint8_t partition(Thread* thread) {
+    return data(thread)->_partition;
+  }
+
+  static void set_partition(Thread* thread, uint8_t partition) {
+    data(thread)->_partition = partition;
+  }
+
+  static ZForwardingCache* forwarding_cache(Thread* thread) {
+    return &data(thread)->_forwarding_cache;
+  }
+
+  static Ticks pacing_start(Thread* thread) {
+    return data(thread)->_pacing_start;
+  }
+
+  static void set_pacing_start(Thread* thread, const Ticks& start) {
+    data(thread)->_pacing_start = start;
+  }
+
   static ByteSize address_bad_mask_offset() {
     return Thread::gc_data_offset() + byte_offset_of(ZThreadLocalData, _address_bad_mask);
   }
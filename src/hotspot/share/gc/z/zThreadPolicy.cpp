@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zThreadPolicy.hpp"
+#include "runtime/globals.hpp"
+
+bool              ZThreadPolicy::_enabled = false;
+THREAD_LOCAL bool ZThreadPolicy::_low_priority = false;
+
+void ZThreadPolicy::initialize() {
+  if (ZThreadCPUs == NULL && !ZConcurrentLowPriority) {
+    // Not configured
+    return;
+  }
+
+  _enabled = initialize_platform();
+}
+
+void ZThreadPolicy::bind_current_thread() {
+  if (_enabled) {
+    bind_platform();
+  }
+}
+
+void ZThreadPolicy::set_current_thread_low_priority(bool low_priority) {
+  if (!_enabled || !ZConcurrentLowPriority || _low_priority == low_priority) {
+    // Nothing to change
+    return;
+  }
+
+  if (set_low_priority_platform(low_priority)) {
+    _low_priority = low_priority;
+  }
+}
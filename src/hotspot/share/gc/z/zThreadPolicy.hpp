@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_GC_Z_ZTHREADPOLICY_HPP
+#define SHARE_GC_Z_ZTHREADPOLICY_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class ZThreadPolicy : public AllStatic {
+private:
+  static bool              _enabled;
+  static THREAD_LOCAL bool _low_priority;
+
+  static bool initialize_platform();
+  static void bind_platform();
+  static bool set_low_priority_platform(bool low_priority);
+
+public:
+  static void initialize();
+
+  // Bind the current thread to the CPUs selected for GC threads
+  static void bind_current_thread();
+
+  // Run the current thread at a lower, or the normal, priority
+  static void set_current_thread_low_priority(bool low_priority);
+};
+
+#endif // SHARE_GC_Z_ZTHREADPOLICY_HPP
@@ -23,9 +23,14 @@
 
 #include "precompiled.hpp"
 #include "gc/shared/gcId.hpp"
+#include "gc/z/zGlobals.hpp"
+#include "gc/z/zObjectAllocator.hpp"
+#include "gc/z/zPage.inline.hpp"
+#include "gc/z/zRelocationSetSelector.hpp"
 #include "gc/z/zStat.hpp"
 #include "gc/z/zTracer.hpp"
 #include "jfr/jfrEvents.hpp"
+#include "jfr/support/jfrThreadId.hpp"
 #include "runtime/safepointVerifiers.hpp"
 #include "utilities/debug.hpp"
 #include "utilities/macros.hpp"
@@ -57,6 +62,38 @@ public:
   }
 };
 
+class ZPageTypeTypeConstant : public JfrSerializer {
+public:
+  virtual void serialize(JfrCheckpointWriter& writer) {
+    writer.write_count(3);
+    writer.write_key(ZPageTypeSmall);
+    writer.write("Small");
+    writer.write_key(ZPageTypeMedium);
+    writer.write("Medium");
+    writer.write_key(ZPageTypeLarge);
+    writer.write("Large");
+  }
+};
+
+class ZAllocationPathTypeConstant : public JfrSerializer {
+public:
+  virtual void serialize(JfrCheckpointWriter& writer) {
+    writer.write_count(ZAllocationPathCount);
+    writer.write_key(ZAllocationPathTLAB);
+    writer.write("TLAB");
+    writer.write_key(ZAllocationPathSharedSmall);
+    writer.write("Shared Small");
+    writer.write_key(ZAllocationPathPerCPUSmall);
+    writer.write("Per-CPU Small");
+    writer.write_key(ZAllocationPathSharedMedium);
+    writer.write("Shared Medium");
+    writer.write_key(ZAllocationPathPerCPUMedium);
+    writer.write("Per-CPU Medium");
+    writer.write_key(ZAllocationPathLarge);
+    writer.write("Large");
+  }
+};
+
 static void register_jfr_type_serializers() {
   JfrSerializer::register_serializer(TYPE_ZSTATISTICSCOUNTERTYPE,
                                      true /* permit_cache */,
@@ -64,6 +101,12 @@ static void register_jfr_type_serializers() {
   JfrSerializer::register_serializer(TYPE_ZSTATISTICSSAMPLERTYPE,
                                      true /* permit_cache */,
                                      new ZStatisticsSamplerTypeConstant());
+  JfrSerializer::register_serializer(TYPE_ZPAGETYPETYPE,
+                                     true /* permit_cache */,
+                                     new ZPageTypeTypeConstant());
+  JfrSerializer::register_serializer(TYPE_ZALLOCATIONPATHTYPE,
+                                     true /* permit_cache */,
+                                     new ZAllocationPathTypeConstant());
 }
 
 #endif // INCLUDE_JFR
@@ -129,3 +172,98 @@ void ZTracer::send_page_alloc(size_t size, size_t used, size_t free, size_t cach
     e.commit();
   }
 }
+
+void ZTracer::send_allocation_stall(uint8_t type, size_t size, const Ticks& start, const Ticks& end) {
+  NoSafepointVerifier nsv;
+
+  EventZAllocationStall e(UNTIMED);
+  if (e.should_commit()) {
+    e.set_type(type);
+    e.set_size(size);
+    e.set_starttime(start);
+    e.set_endtime(end);
+    e.commit();
+  }
+}
+
+void ZTracer::send_object_allocation_sample(uint8_t path, size_t size, ZPage* page, const Ticks& start, const Ticks& end) {
+  NoSafepointVerifier nsv;
+
+  EventZObjectAllocationSample e(UNTIMED);
+  if (e.should_commit()) {
+    e.set_path(path);
+    e.set_pageType(page->type());
+    e.set_objectSize(size);
+    e.set_pageSize(page->size());
+    e.set_numaNode(page->numa_id());
+    e.set_starttime(start);
+    e.set_endtime(end);
+    e.commit();
+  }
+}
+
+void ZTracer::send_relocation_set(const ZRelocationSetSelector& selector) {
+  NoSafepointVerifier nsv;
+
+  EventZRelocationSet e;
+  if (e.should_commit()) {
+    e.set_gcId(GCId::current());
+    e.set_smallPages(selector.small().nselected());
+    e.set_smallRelocating(selector.small().relocating());
+    e.set_mediumPages(selector.medium().nselected());
+    e.set_mediumRelocating(selector.medium().relocating());
+    e.set_largePages(selector.nremapped());
+    e.set_deferredPages(selector.small().ndeferred() + selector.medium().ndeferred());
+    e.set_live(selector.live());
+    e.set_garbage(selector.garbage());
+    e.set_fragmentation(selector.fragmentation());
+    e.commit();
+  }
+}
+
+void ZTracer::send_director_decision(GCCause::Cause cause, double alloc_rate, double alloc_rate_sd, double forecast_alloc_rate,
+                                     double max_alloc_rate, size_t free, double max_duration_of_gc, double time_until_oom,
+                                     bool alloc_stalled) {
+  NoSafepointVerifier nsv;
+
+  EventZDirectorDecision e;
+  if (e.should_commit()) {
+    e.set_cause((u2)cause);
+    e.set_allocationRate(alloc_rate);
+    e.set_allocationRateDeviation(alloc_rate_sd);
+    e.set_forecastAllocationRate(forecast_alloc_rate);
+    e.set_maxAllocationRate(max_alloc_rate);
+    e.set_free(free);
+    e.set_maxDurationOfGC((jlong)(max_duration_of_gc * MILLIUNITS));
+    e.set_timeUntilOOM((jlong)(time_until_oom * MILLIUNITS));
+    e.set_allocationStall(alloc_stalled);
+    e.commit();
+  }
+}
+
+void ZTracer::send_time_to_safepoint(const char* name, jlong time_to_safepoint, JavaThread* slowest_thread) {
+  NoSafepointVerifier nsv;
+
+  EventZTimeToSafepoint e;
+  if (e.should_commit()) {
+    e.set_gcId(GCId::current());
+    e.set_name(name);
+    e.set_timeToSafepoint(time_to_safepoint);
+    e.set_slowestThread((slowest_thread != NULL) ? JFR_THREAD_ID(slowest_thread) : 0);
+    e.commit();
+  }
+}
+
+void ZTracer::send_class_profile(const Klass* klass, uint64_t marked_bytes, uint64_t relocated_bytes, uint64_t relocated_objects) {
+  NoSafepointVerifier nsv;
+
+  EventZClassProfile e;
+  if (e.should_commit()) {
+    e.set_gcId(GCId::current());
+    e.set_objectClass(klass);
+    e.set_markedBytes(marked_bytes);
+    e.set_relocatedBytes(relocated_bytes);
+    e.set_relocatedObjects(relocated_objects);
+    e.commit();
+  }
+}
@@ -24,9 +24,14 @@
 #ifndef SHARE_GC_Z_ZTRACER_HPP
 #define SHARE_GC_Z_ZTRACER_HPP
 
+#include "gc/shared/gcCause.hpp"
 #include "gc/shared/gcTrace.hpp"
 #include "gc/z/zAllocationFlags.hpp"
 
+class JavaThread;
+class Klass;
+class ZPage;
+class ZRelocationSetSelector;
 class ZStatCounter;
 class ZStatPhase;
 class ZStatSampler;
@@ -41,6 +46,14 @@ private:
   void send_stat_sampler(const ZStatSampler& sampler, uint64_t value);
   void send_thread_phase(const char* name, const Ticks& start, const Ticks& end);
   void send_page_alloc(size_t size, size_t used, size_t free, size_t cache, ZAllocationFlags flags);
+  void send_allocation_stall(uint8_t type, size_t size, const Ticks& start, const Ticks& end);
+  void send_object_allocation_sample(uint8_t path, size_t size, ZPage* page, const Ticks& start, const Ticks& end);
+  void send_relocation_set(const ZRelocationSetSelector& selector);
+  void send_director_decision(GCCause::Cause cause, double alloc_rate, double alloc_rate_sd, double forecast_alloc_rate,
+                              double max_alloc_rate, size_t free, double max_duration_of_gc, double time_until_oom,
+                              bool alloc_stalled);
+  void send_time_to_safepoint(const char* name, jlong time_to_safepoint, JavaThread* slowest_thread);
+  void send_class_profile(const Klass* klass, uint64_t marked_bytes, uint64_t relocated_bytes, uint64_t relocated_objects);
 
 public:
   static ZTracer* tracer();
@@ -50,6 +63,14 @@ public:
   void report_stat_sampler(const ZStatSampler& sampler, uint64_t value);
   void report_thread_phase(const char* name, const Ticks& start, const Ticks& end);
   void report_page_alloc(size_t size, size_t used, size_t free, size_t cache, ZAllocationFlags flags);
+  void report_allocation_stall(uint8_t type, size_t size, const Ticks& start, const Ticks& end);
+  void report_object_allocation_sample(uint8_t path, size_t size, ZPage* page, const Ticks& start, const Ticks& end);
+  void report_relocation_set(const ZRelocationSetSelector& selector);
+  void report_director_decision(GCCause::Cause cause, double alloc_rate, double alloc_rate_sd, double forecast_alloc_rate,
+                                double max_alloc_rate, size_t free, double max_duration_of_gc, double time_until_oom,
+                                bool alloc_stalled);
+  void report_time_to_safepoint(const char* name, jlong time_to_safepoint, JavaThread* slowest_thread);
+  void report_class_profile(const Klass* klass, uint64_t marked_bytes, uint64_t relocated_bytes, uint64_t relocated_objects);
 };
 
 class ZTraceThreadPhase : public StackObj {
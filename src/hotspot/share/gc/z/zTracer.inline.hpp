@@ -56,6 +56,46 @@ inline void ZTracer::report_page_alloc(size_t size, size_t used, size_t free, si
   }
 }
 
+inline void ZTracer::report_allocation_stall(uint8_t type, size_t size, const Ticks& start, const Ticks& end) {
+  if (EventZAllocationStall::is_enabled()) {
+    send_allocation_stall(type, size, start, end);
+  }
+}
+
+inline void ZTracer::report_object_allocation_sample(uint8_t path, size_t size, ZPage* page, const Ticks& start, const Ticks& end) {
+  if (EventZObjectAllocationSample::is_enabled()) {
+    send_object_allocation_sample(path, size, page, start, end);
+  }
+}
+
+inline void ZTracer::report_relocation_set(const ZRelocationSetSelector& selector) {
+  if (EventZRelocationSet::is_enabled()) {
+    send_relocation_set(selector);
+  }
+}
+
+inline void ZTracer::report_director_decision(GCCause::Cause cause, double alloc_rate, double alloc_rate_sd, double forecast_alloc_rate,
+                                              double max_alloc_rate, size_t free, double max_duration_of_gc, double time_until_oom,
+                                              bool alloc_stalled) {
+  if (EventZDirectorDecision::is_enabled()) {
+    send_director_decision(cause, alloc_rate, alloc_rate_sd, forecast_alloc_rate,
+                           max_alloc_rate, free, max_duration_of_gc, time_until_oom,
+                           alloc_stalled);
+  }
+}
+
+inline void ZTracer::report_time_to_safepoint(const char* name, jlong time_to_safepoint, JavaThread* slowest_thread) {
+  if (EventZTimeToSafepoint::is_enabled()) {
+    send_time_to_safepoint(name, time_to_safepoint, slowest_thread);
+  }
+}
+
+inline void ZTracer::report_class_profile(const Klass* klass, uint64_t marked_bytes, uint64_t relocated_bytes, uint64_t relocated_objects) {
+  if (EventZClassProfile::is_enabled()) {
+    send_class_profile(klass, marked_bytes, relocated_bytes, relocated_objects);
+  }
+}
+
 inline ZTraceThreadPhase::ZTraceThreadPhase(const char* name) :
     _start(Ticks::now()),
     _name(name) {}
@@ -23,13 +23,16 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zHeap.inline.hpp"
+#include "gc/z/zStat.hpp"
+#include "gc/z/zThreadPolicy.hpp"
 #include "gc/z/zUncommitter.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/os.hpp"
 
 ZUncommitter::ZUncommitter() :
     _monitor(Monitor::leaf, "ZUncommitter", false, Monitor::_safepoint_check_never),
-    _stop(false) {
+    _stop(false),
+    _requested(false) {
   set_name("ZUncommitter");
   create_and_start();
 }
@@ -45,7 +48,7 @@ bool ZUncommitter::idle(uint64_t timeout) {
     const uint64_t remaining = expires - MIN2(expires, now);
 
     MonitorLocker ml(&_monitor, Monitor::_no_safepoint_check_flag);
-    if (remaining > 0 && !_stop) {
+    if (remaining > 0 && !_stop && !_requested) {
       ml.wait(remaining * MILLIUNITS);
     } else {
       return !_stop;
@@ -53,10 +56,47 @@ bool ZUncommitter::idle(uint64_t timeout) {
   }
 }
 
+bool ZUncommitter::is_requested() {
+  MonitorLocker ml(&_monitor, Monitor::_no_safepoint_check_flag);
+  const bool requested = _requested;
+  _requested = false;
+  return requested;
+}
+
+void ZUncommitter::request() {
+  MonitorLocker ml(&_monitor, Monitor::_no_safepoint_check_flag);
+  _requested = true;
+  ml.notify();
+}
+
+size_t ZUncommitter::budget() const {
+  // Uncommit at most ZUncommitBudget bytes per second. The budget is
+  // reduced by the current allocation rate, to back off when allocation
+  // picks up again, since the memory is then likely to soon be needed.
+  const size_t alloc_rate = ZStatAllocRate::avg();
+  return ZUncommitBudget - MIN2(ZUncommitBudget, alloc_rate);
+}
+
 void ZUncommitter::run_service() {
+  ZThreadPolicy::bind_current_thread();
+
   for (;;) {
-    // Try uncommit unused memory
-    const uint64_t timeout = ZHeap::heap()->uncommit(ZUncommitDelay);
+    // Destroy cached pages with fragmented physical memory
+    ZHeap::heap()->defragment();
+
+    // Try uncommit unused memory. While the soft max capacity is lowered
+    // due to memory pressure, unused memory is uncommitted after a short
+    // delay, so that pages freed and reused within a GC cycle are not
+    // uncommitted and committed again. When requested, all unused memory
+    // is uncommitted without delay.
+    const bool requested = is_requested();
+    const bool limited = ZHeap::heap()->is_soft_max_limited();
+    const uint64_t delay = requested ? 0 : (limited ? MIN2<uint64_t>(ZUncommitDelay, 1) : ZUncommitDelay);
+    const size_t limit = requested ? SIZE_MAX : budget();
+    uint64_t timeout = ZHeap::heap()->uncommit(delay, limit);
+    if (limited) {
+      timeout = MIN2<uint64_t>(timeout, 1);
+    }
 
     log_trace(gc, heap)("Uncommit Timeout: " UINT64_FORMAT "s", timeout);
 
@@ -31,8 +31,11 @@ class ZUncommitter : public ConcurrentGCThread {
 private:
   Monitor _monitor;
   bool    _stop;
+  bool    _requested;
 
   bool idle(uint64_t timeout);
+  bool is_requested();
+  size_t budget() const;
 
 protected:
   virtual void run_service();
@@ -40,6 +43,10 @@ protected:
 
 public:
   ZUncommitter();
+
+  // Uncommit unused memory without delay, and without
+  // the budget, such as after an explicit GC
+  void request();
 };
 
 #endif // SHARE_GC_Z_ZUNCOMMITTER_HPP
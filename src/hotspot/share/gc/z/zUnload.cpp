@@ -33,11 +33,16 @@
 #include "gc/z/zNMethod.hpp"
 #include "gc/z/zOopClosures.hpp"
 #include "gc/z/zStat.hpp"
+#include "gc/z/zTask.hpp"
 #include "gc/z/zUnload.hpp"
+#include "gc/z/zWorkers.hpp"
+#include "logging/log.hpp"
 #include "oops/access.inline.hpp"
 
 static const ZStatSubPhase ZSubPhaseConcurrentClassesUnlink("Concurrent Classes Unlink");
 static const ZStatSubPhase ZSubPhaseConcurrentClassesPurge("Concurrent Classes Purge");
+static const ZStatSampler  ZSamplerSuspendibleConcurrentClassesUnlink("Suspendible", "Concurrent Classes Unlink", ZStatUnitTime);
+static const ZStatSampler  ZSamplerSuspendibleConcurrentClassesPurge("Suspendible", "Concurrent Classes Purge", ZStatUnitTime);
 
 class ZIsUnloadingOopClosure : public OopClosure {
 private:
@@ -73,7 +78,7 @@ public:
     ZLocker<ZReentrantLock> locker(lock);
     ZIsUnloadingOopClosure cl;
     ZNMethod::nmethod_oops_do(nm, &cl);
-    return cl.is_unloading();
+    return cl.is_unloading() || ZNMethod::is_cold(nm);
   }
 };
 
@@ -103,8 +108,24 @@ public:
   }
 };
 
+class ZClassLoaderDataPurgeTask : public ZTask {
+private:
+  ClassLoaderDataGraphParPurge* const _purge;
+
+public:
+  ZClassLoaderDataPurgeTask(ClassLoaderDataGraphParPurge* purge) :
+      ZTask("ZClassLoaderDataPurgeTask"),
+      _purge(purge) {}
+
+  virtual void work() {
+    _purge->work();
+  }
+};
+
 ZUnload::ZUnload(ZWorkers* workers) :
-    _workers(workers) {
+    _workers(workers),
+    _unloading_occurred(false),
+    _nmethods_unlinked(false) {
 
   if (!ClassUnloading) {
     return;
@@ -133,15 +154,15 @@ void ZUnload::unlink() {
 
   ZStatTimer timer(ZSubPhaseConcurrentClassesUnlink);
   SuspendibleThreadSetJoiner sts;
-  bool unloading_occurred;
+  ZStatSuspendibleTimer sts_timer(ZSamplerSuspendibleConcurrentClassesUnlink);
 
   {
     MutexLocker ml(ClassLoaderDataGraph_lock);
-    unloading_occurred = SystemDictionary::do_unloading(ZStatPhase::timer());
+    _unloading_occurred = SystemDictionary::do_unloading(ZStatPhase::timer());
   }
 
-  Klass::clean_weak_klass_links(unloading_occurred);
-  ZNMethod::unlink(_workers, unloading_occurred);
+  Klass::clean_weak_klass_links(_unloading_occurred);
+  _nmethods_unlinked = ZNMethod::unlink(_workers, _unloading_occurred);
   DependencyContext::cleaning_end();
 }
 
@@ -150,17 +171,38 @@ void ZUnload::purge() {
     return;
   }
 
+  if (!_unloading_occurred && !_nmethods_unlinked) {
+    // No class loader died and no nmethod was unlinked, so there
+    // is nothing to purge except released exception caches.
+    log_debug(gc)("Concurrent Classes Purge: Skipped, nothing unlinked");
+    CodeCache::purge_exception_caches();
+    return;
+  }
+
   ZStatTimer timer(ZSubPhaseConcurrentClassesPurge);
 
   {
     SuspendibleThreadSetJoiner sts;
+    ZStatSuspendibleTimer sts_timer(ZSamplerSuspendibleConcurrentClassesPurge);
     ZNMethod::purge(_workers);
   }
 
-  ClassLoaderDataGraph::purge();
+  purge_class_loader_data();
   CodeCache::purge_exception_caches();
 }
 
+void ZUnload::purge_class_loader_data() {
+  ClassLoaderDataGraphParPurge purge;
+  if (purge.length() > 1) {
+    // Delete class loader data in parallel, the serial part of
+    // the purge is done when the purge object goes out of scope
+    ZClassLoaderDataPurgeTask task(&purge);
+    _workers->run_concurrent(&task);
+  } else {
+    purge.work();
+  }
+}
+
 void ZUnload::finish() {
   // Resize and verify metaspace
   MetaspaceGC::compute_new_size();
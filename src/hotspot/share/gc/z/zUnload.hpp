@@ -29,6 +29,10 @@ class ZWorkers;
 class ZUnload {
 private:
   ZWorkers* const _workers;
+  bool            _unloading_occurred;
+  bool            _nmethods_unlinked;
+
+  void purge_class_loader_data();
 
 public:
   ZUnload(ZWorkers* workers);
@@ -42,6 +42,11 @@ public:
   // Object
   static size_t object_size(uintptr_t addr);
   static void object_copy(uintptr_t from, uintptr_t to, size_t size);
+  static void object_copy_for_relocation(uintptr_t from, uintptr_t to, size_t size);
+  static void object_copy_conjoint(uintptr_t from, uintptr_t to, size_t size);
+  static void object_zero_non_temporal(uintptr_t addr, size_t size);
+  static uint object_age(uintptr_t addr);
+  static void object_increment_age(uintptr_t addr);
 };
 
 #endif // SHARE_GC_Z_ZUTILS_HPP
@@ -27,10 +27,12 @@
 #include "gc/z/zOop.inline.hpp"
 #include "gc/z/zUtils.hpp"
 #include "oops/oop.inline.hpp"
+#include "runtime/globals.hpp"
 #include "utilities/align.hpp"
 #include "utilities/copy.hpp"
 #include "utilities/debug.hpp"
 #include "utilities/globalDefinitions.hpp"
+#include CPU_HEADER_INLINE(gc/z/zUtils)
 
 inline size_t ZUtils::bytes_to_words(size_t size_in_bytes) {
   assert(is_aligned(size_in_bytes, BytesPerWord), "Size not word aligned");
@@ -49,4 +51,38 @@ inline void ZUtils::object_copy(uintptr_t from, uintptr_t to, size_t size) {
   Copy::aligned_disjoint_words((HeapWord*)from, (HeapWord*)to, bytes_to_words(size));
 }
 
+inline void ZUtils::object_copy_for_relocation(uintptr_t from, uintptr_t to, size_t size) {
+  if (ZNonTemporalCopyLimit > 0 && size >= ZNonTemporalCopyLimit) {
+    // Copy big objects using non-temporal stores. A relocated object is
+    // typically not accessed again soon, so bringing it into the caches
+    // of the relocating thread would mostly evict more useful data.
+    ZPlatformObjectCopyNonTemporal(from, to, size);
+  } else {
+    object_copy(from, to, size);
+  }
+}
+
+inline uint ZUtils::object_age(uintptr_t addr) {
+  // The age of an object with a displaced mark word is not available
+  // without inflating or walking the lock, so it is treated as new
+  const markWord mark = ZOop::from_address(addr)->mark();
+  return mark.has_displaced_mark_helper() ? 0 : mark.age();
+}
+
+inline void ZUtils::object_increment_age(uintptr_t addr) {
+  const oop obj = ZOop::from_address(addr);
+  const markWord mark = obj->mark();
+  if (!mark.has_displaced_mark_helper()) {
+    obj->set_mark(mark.incr_age());
+  }
+}
+
+inline void ZUtils::object_copy_conjoint(uintptr_t from, uintptr_t to, size_t size) {
+  Copy::aligned_conjoint_words((HeapWord*)from, (HeapWord*)to, bytes_to_words(size));
+}
+
+inline void ZUtils::object_zero_non_temporal(uintptr_t addr, size_t size) {
+  ZPlatformZeroNonTemporal(addr, size);
+}
+
 #endif // SHARE_GC_Z_ZUTILS_INLINE_HPP
@@ -30,6 +30,7 @@
 #include "gc/z/zThread.inline.hpp"
 #include "gc/z/zUtils.hpp"
 #include "gc/z/zValue.hpp"
+#include "gc/z/zWorkers.hpp"
 #include "runtime/globals.hpp"
 #include "utilities/align.hpp"
 
@@ -104,7 +105,7 @@ inline size_t ZPerWorkerStorage::alignment() {
 }
 
 inline uint32_t ZPerWorkerStorage::count() {
-  return MAX2(ParallelGCThreads, ConcGCThreads);
+  return ZWorkers::nworkers_max();
 }
 
 inline uint32_t ZPerWorkerStorage::id() {
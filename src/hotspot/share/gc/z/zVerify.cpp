@@ -23,16 +23,25 @@
 
 #include "precompiled.hpp"
 #include "classfile/classLoaderData.hpp"
+#include "classfile/classLoaderDataGraph.hpp"
 #include "gc/z/zAddress.hpp"
+#include "gc/z/zArray.inline.hpp"
 #include "gc/z/zHeap.inline.hpp"
 #include "gc/z/zOop.hpp"
+#include "gc/z/zPage.inline.hpp"
 #include "gc/z/zPageAllocator.hpp"
+#include "gc/z/zPageTable.inline.hpp"
 #include "gc/z/zResurrection.hpp"
 #include "gc/z/zRootsIterator.hpp"
 #include "gc/z/zStat.hpp"
+#include "gc/z/zTask.hpp"
 #include "gc/z/zVerify.hpp"
+#include "logging/log.hpp"
 #include "memory/iterator.inline.hpp"
 #include "oops/oop.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
+#include "utilities/ticks.hpp"
 
 #define BAD_OOP_ARG(o, p)   "Bad oop " PTR_FORMAT " found at " PTR_FORMAT, p2i(o), p2i(p)
 
@@ -100,6 +109,89 @@ public:
 #endif
 };
 
+class ZVerifyLiveObjectClosure : public ObjectClosure {
+private:
+  const bool _verify_weaks;
+
+public:
+  ZVerifyLiveObjectClosure(bool verify_weaks) :
+      _verify_weaks(verify_weaks) {}
+
+  virtual void do_object(oop o) {
+    if (!_verify_weaks && !ZHeap::heap()->is_object_strongly_live(ZOop::to_address(o))) {
+      // Only reachable through finalizable paths, which
+      // are not visited when verifying strong references
+      return;
+    }
+
+    ZVerifyOopClosure cl(_verify_weaks);
+    o->oop_iterate(&cl);
+  }
+};
+
+class ZVerifyObjectsTask : public ZTask {
+private:
+  ZArray<ZPage*>                 _pages;
+  ZArrayParallelIterator<ZPage*> _iter;
+  const bool                     _verify_weaks;
+  const Ticks                    _start;
+  const jlong                    _timeout;
+  volatile size_t                _nverified;
+
+  bool has_expired() const {
+    return _timeout > 0 && Ticks::now().value() >= _timeout;
+  }
+
+  void shuffle_pages() {
+    // Randomize the order, so that pages not verified because
+    // of the time budget are spread over the heap
+    for (size_t i = _pages.size(); i > 1; i--) {
+      const size_t j = (size_t)os::random() % i;
+      ZPage** const a = _pages.addr(i - 1);
+      ZPage** const b = _pages.addr(j);
+      ZPage* const tmp = *a;
+      *a = *b;
+      *b = tmp;
+    }
+  }
+
+public:
+  ZVerifyObjectsTask(const ZPageTable* page_table, bool verify_weaks) :
+      ZTask("ZVerifyObjectsTask"),
+      _pages(),
+      _iter(&_pages),
+      _verify_weaks(verify_weaks),
+      _start(Ticks::now()),
+      _timeout(ZVerifyObjectsTimeBudget > 0 ? _start.value() + TimeHelper::millis_to_counter(ZVerifyObjectsTimeBudget) : 0),
+      _nverified(0) {
+    // Collect a sample of the pages marked. Pages allocated since
+    // mark start have no live map, and are not verified.
+    ZPageTableIterator iter(page_table);
+    for (ZPage* page; iter.next(&page);) {
+      if (!page->is_allocating() && page->is_marked() &&
+          (uint)os::random() % 100 < ZVerifyObjectsSamplePercent) {
+        _pages.add(page);
+      }
+    }
+
+    shuffle_pages();
+  }
+
+  ~ZVerifyObjectsTask() {
+    const Tickspan duration = Ticks::now() - _start;
+    log_debug(gc, verify)("Verified Objects: " SIZE_FORMAT "/" SIZE_FORMAT " pages, %.3fms",
+                          _nverified, _pages.size(), TimeHelper::counter_to_millis(duration.value()));
+  }
+
+  virtual void work() {
+    ZVerifyLiveObjectClosure cl(_verify_weaks);
+    for (ZPage* page; !has_expired() && _iter.next(&page);) {
+      page->object_iterate(&cl);
+      Atomic::inc(&_nverified);
+    }
+  }
+};
+
 template <typename RootsIterator>
 void ZVerify::roots() {
   assert(SafepointSynchronize::is_at_safepoint(), "Must be at a safepoint");
@@ -137,12 +229,27 @@ void ZVerify::roots(bool verify_weaks) {
   }
 }
 
+void ZVerify::objects_parallel(bool verify_weaks) {
+  // All objects found live by marking are recorded in the live
+  // maps, so pages can be verified independently of each other
+  ZHeap* const heap = ZHeap::heap();
+  ZVerifyObjectsTask task(&heap->_page_table, verify_weaks);
+  heap->_workers.run_parallel(&task);
+
+  ClassLoaderDataGraph::clear_claimed_marks(ClassLoaderData::_claim_other);
+}
+
 void ZVerify::objects(bool verify_weaks) {
   assert(SafepointSynchronize::is_at_safepoint(), "Must be at a safepoint");
   assert(ZGlobalPhase == ZPhaseMarkCompleted, "Invalid phase");
   assert(!ZResurrection::is_blocked(), "Invalid phase");
 
   if (ZVerifyObjects) {
+    if (ZVerifyObjectsParallel) {
+      objects_parallel(verify_weaks);
+      return;
+    }
+
     ZVerifyOopClosure cl(verify_weaks);
     ObjectToOopClosure object_cl(&cl);
     ZHeap::heap()->object_iterate(&object_cl, verify_weaks);
@@ -38,6 +38,7 @@ private:
   static void roots_concurrent_weak();
 
   static void roots(bool verify_weaks);
+  static void objects_parallel(bool verify_weaks);
   static void objects(bool verify_weaks);
   static void roots_and_objects(bool verify_weaks);
 
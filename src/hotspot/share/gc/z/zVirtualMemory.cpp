@@ -24,6 +24,7 @@
 #include "precompiled.hpp"
 #include "gc/z/zAddressSpaceLimit.hpp"
 #include "gc/z/zGlobals.hpp"
+#include "gc/z/zLock.inline.hpp"
 #include "gc/z/zVirtualMemory.inline.hpp"
 #include "logging/log.hpp"
 #include "services/memTracker.hpp"
@@ -32,6 +33,9 @@
 
 ZVirtualMemoryManager::ZVirtualMemoryManager(size_t max_capacity) :
     _manager(),
+    _reserve_lock(),
+    _reserved(0),
+    _reserve_limit(0),
     _initialized(false) {
 
   // Check max supported heap size
@@ -118,30 +122,68 @@ bool ZVirtualMemoryManager::reserve_contiguous(size_t size) {
   return false;
 }
 
+size_t ZVirtualMemoryManager::reserve_inner(size_t size, bool* contiguous) {
+  // Prefer a contiguous address space
+  *contiguous = reserve_contiguous(size);
+  if (*contiguous) {
+    return size;
+  }
+
+  // Fall back to a discontiguous address space
+  return reserve_discontiguous(size);
+}
+
 bool ZVirtualMemoryManager::reserve(size_t max_capacity) {
   const size_t limit = MIN2(ZAddressOffsetMax, ZAddressSpaceLimit::heap_view());
-  const size_t size = MIN2(max_capacity * ZVirtualToPhysicalRatio, limit);
+  const size_t size = MIN2(max_capacity * ZVirtualReserveRatio, limit);
 
-  size_t reserved = size;
-  bool contiguous = true;
+  // Only reserve part of the address space up front. Reserving the whole
+  // address space hurts operations that scale with the number of mapped
+  // address ranges, such as fork(), core dumps and reading /proc/pid/maps.
+  // The reservation is instead extended on demand, see expand().
+  _reserve_limit = MIN2(max_capacity * ZVirtualToPhysicalRatio, limit);
 
-  // Prefer a contiguous address space
-  if (!reserve_contiguous(size)) {
-    // Fall back to a discontiguous address space
-    reserved = reserve_discontiguous(size);
-    contiguous = false;
-  }
+  bool contiguous;
+  const size_t reserved = reserve_inner(size, &contiguous);
+  _reserved = reserved;
 
   log_info(gc, init)("Address Space Type: %s/%s/%s",
                      (contiguous ? "Contiguous" : "Discontiguous"),
                      (limit == ZAddressOffsetMax ? "Unrestricted" : "Restricted"),
                      (reserved == size ? "Complete" : "Degraded"));
-  log_info(gc, init)("Address Space Size: " SIZE_FORMAT "M x " SIZE_FORMAT " = " SIZE_FORMAT "M",
-                     reserved / M, ZHeapViews, (reserved * ZHeapViews) / M);
+  log_info(gc, init)("Address Space Size: " SIZE_FORMAT "M x " SIZE_FORMAT " = " SIZE_FORMAT "M (Max " SIZE_FORMAT "M)",
+                     reserved / M, ZHeapViews, (reserved * ZHeapViews) / M, (_reserve_limit * ZHeapViews) / M);
 
   return reserved >= max_capacity;
 }
 
+bool ZVirtualMemoryManager::expand(size_t size) {
+  ZLocker<ZLock> locker(&_reserve_lock);
+
+  if (_manager.peek_from_back(size) != UINTPTR_MAX) {
+    // Another thread already expanded the reservation
+    return true;
+  }
+
+  if (_reserved >= _reserve_limit) {
+    // Reservation can not be extended further
+    return false;
+  }
+
+  // The reservation has become too fragmented to satisfy the allocation.
+  // Double the reservation, which keeps the number of extensions low as
+  // the fragmentation grows, while staying within the limit.
+  const size_t increment = MIN2(align_up(MAX2(_reserved, size), ZGranuleSize), _reserve_limit - _reserved);
+  bool contiguous;
+  const size_t reserved = reserve_inner(increment, &contiguous);
+  _reserved += reserved;
+
+  log_info(gc, heap)("Address Space Expanded: " SIZE_FORMAT "M x " SIZE_FORMAT " = " SIZE_FORMAT "M",
+                     _reserved / M, ZHeapViews, (_reserved * ZHeapViews) / M);
+
+  return reserved > 0;
+}
+
 void ZVirtualMemoryManager::nmt_reserve(uintptr_t start, size_t size) {
   MemTracker::record_virtual_memory_reserve((void*)start, size, CALLER_PC);
   MemTracker::record_virtual_memory_type((void*)start, mtJavaHeap);
@@ -152,19 +194,52 @@ bool ZVirtualMemoryManager::is_initialized() const {
 }
 
 ZVirtualMemory ZVirtualMemoryManager::alloc(size_t size, bool alloc_from_front) {
-  uintptr_t start;
-
-  if (alloc_from_front || size <= ZPageSizeSmall) {
-    // Small page
-    start = _manager.alloc_from_front(size);
-  } else {
-    // Medium/Large page
-    start = _manager.alloc_from_back(size);
+  for (;;) {
+    uintptr_t start;
+
+    if (alloc_from_front || size <= ZPageSizeSmall) {
+      // Small page
+      start = _manager.alloc_from_front(size);
+    } else {
+      // Medium/Large page
+      start = _manager.alloc_from_back(size);
+    }
+
+    if (start != UINTPTR_MAX || !expand(size)) {
+      return ZVirtualMemory(start, size);
+    }
+
+    // Retry with the expanded reservation
   }
+}
 
-  return ZVirtualMemory(start, size);
+ZVirtualMemory ZVirtualMemoryManager::alloc_above(const ZVirtualMemory& vmem) {
+  // Allocate a range of the same size as the given range, at the highest
+  // available address. Fails if that address is below the given range.
+  const uintptr_t start = _manager.alloc_from_back(vmem.size());
+  if (start == UINTPTR_MAX) {
+    // Out of address space
+    return ZVirtualMemory();
+  }
+
+  if (start < vmem.start()) {
+    // Not above the given range
+    _manager.free(start, vmem.size());
+    return ZVirtualMemory();
+  }
+
+  return ZVirtualMemory(start, vmem.size());
+}
+
+bool ZVirtualMemoryManager::has_free_above(const ZVirtualMemory& vmem) {
+  const uintptr_t start = _manager.peek_from_back(vmem.size());
+  return start != UINTPTR_MAX && start > vmem.start();
 }
 
 void ZVirtualMemoryManager::free(const ZVirtualMemory& vmem) {
   _manager.free(vmem.start(), vmem.size());
 }
+
+void ZVirtualMemoryManager::free_stats(size_t* nareas, size_t* size, size_t* largest) {
+  _manager.free_stats(nareas, size, largest);
+}
@@ -24,6 +24,7 @@
 #ifndef SHARE_GC_Z_ZVIRTUALMEMORY_HPP
 #define SHARE_GC_Z_ZVIRTUALMEMORY_HPP
 
+#include "gc/z/zLock.hpp"
 #include "gc/z/zMemory.hpp"
 
 class ZVirtualMemory {
@@ -48,6 +49,9 @@ public:
 class ZVirtualMemoryManager {
 private:
   ZMemoryManager _manager;
+  ZLock          _reserve_lock;
+  size_t         _reserved;
+  size_t         _reserve_limit;
   bool           _initialized;
 
   void initialize_os();
@@ -56,7 +60,9 @@ private:
   bool reserve_contiguous(size_t size);
   size_t reserve_discontiguous(uintptr_t start, size_t size, size_t min_range);
   size_t reserve_discontiguous(size_t size);
+  size_t reserve_inner(size_t size, bool* contiguous);
   bool reserve(size_t max_capacity);
+  bool expand(size_t size);
 
   void nmt_reserve(uintptr_t start, size_t size);
 
@@ -66,7 +72,11 @@ public:
   bool is_initialized() const;
 
   ZVirtualMemory alloc(size_t size, bool alloc_from_front = false);
+  ZVirtualMemory alloc_above(const ZVirtualMemory& vmem);
+  bool has_free_above(const ZVirtualMemory& vmem);
   void free(const ZVirtualMemory& vmem);
+
+  void free_stats(size_t* nareas, size_t* size, size_t* largest);
 };
 
 #endif // SHARE_GC_Z_ZVIRTUALMEMORY_HPP
@@ -24,7 +24,9 @@
 #include "precompiled.hpp"
 #include "gc/z/zHeap.inline.hpp"
 #include "gc/z/zOopClosures.inline.hpp"
+#include "gc/z/zReferenceProcessor.hpp"
 #include "gc/z/zStat.hpp"
+#include "gc/z/zStringDedup.hpp"
 #include "gc/z/zTask.hpp"
 #include "gc/z/zThread.hpp"
 #include "runtime/jniHandles.hpp"
@@ -39,12 +41,26 @@ private:
 public:
   ZProcessWeakRootsTask() :
       ZTask("ZProcessWeakRootsTask"),
-      _weak_roots() {}
+      _weak_roots() {
+    if (ZStringDedup::is_enabled()) {
+      ZStringDedup::weak_oops_do_begin();
+    }
+  }
+
+  ~ZProcessWeakRootsTask() {
+    if (ZStringDedup::is_enabled()) {
+      ZStringDedup::weak_oops_do_end();
+    }
+  }
 
   virtual void work() {
     ZPhantomIsAliveObjectClosure is_alive;
     ZPhantomKeepAliveOopClosure keep_alive;
     _weak_roots.weak_oops_do(&is_alive, &keep_alive);
+
+    if (ZStringDedup::is_enabled()) {
+      ZStringDedup::weak_oops_do(&is_alive, &keep_alive);
+    }
   }
 };
 
@@ -56,19 +72,42 @@ void ZWeakRootsProcessor::process_weak_roots() {
 class ZProcessConcurrentWeakRootsTask : public ZTask {
 private:
   ZConcurrentWeakRootsIterator _concurrent_weak_roots;
+  ZReferenceProcessor* const   _reference_processor;
 
 public:
-  ZProcessConcurrentWeakRootsTask() :
+  ZProcessConcurrentWeakRootsTask(ZReferenceProcessor* reference_processor) :
       ZTask("ZProcessConccurentWeakRootsTask"),
-      _concurrent_weak_roots() {}
+      _concurrent_weak_roots(),
+      _reference_processor(reference_processor) {}
 
   virtual void work() {
+    if (_reference_processor != NULL) {
+      // References are claimed one discovered list at a time. Workers
+      // that find no more lists to claim move on to the weak roots.
+      _reference_processor->work();
+    }
+
     ZPhantomCleanOopClosure cl;
     _concurrent_weak_roots.oops_do(&cl);
   }
 };
 
 void ZWeakRootsProcessor::process_concurrent_weak_roots() {
-  ZProcessConcurrentWeakRootsTask task;
+  ZProcessConcurrentWeakRootsTask task(NULL /* reference_processor */);
   _workers->run_concurrent(&task);
 }
+
+void ZWeakRootsProcessor::process_concurrent_weak_roots_and_references(ZReferenceProcessor* reference_processor) {
+  // Process references and weak roots in the same task, instead of one
+  // after the other, so that workers don't sit idle waiting for the last
+  // references to be processed before starting on the weak roots. This
+  // shortens the window where resurrection is blocked.
+  reference_processor->prepare_process();
+
+  {
+    ZProcessConcurrentWeakRootsTask task(reference_processor);
+    _workers->run_concurrent(&task);
+  }
+
+  reference_processor->complete_process();
+}
@@ -24,6 +24,7 @@
 #ifndef SHARE_GC_Z_ZWEAKROOTSPROCESSOR_HPP
 #define SHARE_GC_Z_ZWEAKROOTSPROCESSOR_HPP
 
+class ZReferenceProcessor;
 class ZWorkers;
 
 class ZWeakRootsProcessor {
@@ -35,6 +36,7 @@ public:
 
   void process_weak_roots();
   void process_concurrent_weak_roots();
+  void process_concurrent_weak_roots_and_references(ZReferenceProcessor* reference_processor);
 };
 
 #endif // SHARE_GC_Z_ZWEAKROOTSPROCESSOR_HPP
@@ -23,12 +23,18 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zGlobals.hpp"
+#include "gc/z/zStat.hpp"
 #include "gc/z/zTask.hpp"
 #include "gc/z/zThread.hpp"
+#include "gc/z/zThreadPolicy.hpp"
 #include "gc/z/zWorkers.inline.hpp"
+#include "logging/log.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
 #include "runtime/safepoint.hpp"
 
+static const ZStatSampler ZSamplerParallelTaskDispatch("Workers", "Parallel Task Dispatch", ZStatUnitTime);
+
 class ZWorkersInitializeTask : public ZTask {
 private:
   const uint _nworkers;
@@ -48,6 +54,7 @@ public:
   virtual void work() {
     // Register as worker
     ZThread::set_worker();
+    ZThreadPolicy::bind_current_thread();
 
     // Wait for all threads to start
     MonitorLocker ml(&_monitor, Monitor::_no_safepoint_check_flag);
@@ -62,10 +69,19 @@ public:
   }
 };
 
+uint ZWorkers::nworkers_max() {
+  // The number of workers can be changed at run time, up to the
+  // number of processors. Worker threads are created on demand.
+  return MAX3(ParallelGCThreads, ConcGCThreads, (uint)os::processor_count());
+}
+
 ZWorkers::ZWorkers() :
     _boost(false),
+    _nparallel(ParallelGCThreads),
+    _nconcurrent_no_boost(ConcGCThreads),
+    _nconcurrent(ConcGCThreads),
     _workers("ZWorker",
-             nworkers(),
+             nworkers_max(),
              true /* are_GC_task_threads */,
              true /* are_ConcurrentGC_threads */) {
 
@@ -78,11 +94,22 @@ ZWorkers::ZWorkers() :
     vm_exit_during_initialization("Failed to create ZWorkers");
   }
 
-  // Execute task to register threads as workers. This also helps
-  // reduce latency in early GC pauses, which otherwise would have
-  // to take on any warmup costs.
-  ZWorkersInitializeTask task(nworkers());
-  run(&task, nworkers());
+  // Register threads as workers. This also helps reduce latency in
+  // early GC pauses, which otherwise would have to take on any warmup
+  // costs.
+  register_workers();
+}
+
+void ZWorkers::register_workers() {
+  // Register all created threads, not only the active ones. Without
+  // UseDynamicNumberOfGCThreads the gang creates all threads up front,
+  // and any created thread can later pick up work from a task.
+  const uint ncreated = _workers.created_workers();
+  ZWorkersInitializeTask task(ncreated);
+  run(&task, ncreated);
+
+  // Restore the number of active workers
+  _workers.update_active_workers(MIN2(nworkers(), ncreated));
 }
 
 void ZWorkers::set_boost(bool boost) {
@@ -93,6 +120,45 @@ void ZWorkers::set_boost(bool boost) {
   _boost = boost;
 }
 
+void ZWorkers::set_nconcurrent(uint nconcurrent) {
+  _nconcurrent = clamp(nconcurrent, 1u, nworkers());
+}
+
+void ZWorkers::set_nworkers(uint nparallel, uint nconcurrent) {
+  assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
+
+  nparallel = clamp(nparallel, 1u, nworkers_max());
+  nconcurrent = clamp(nconcurrent, 1u, nworkers_max());
+  if (nparallel == _nparallel && nconcurrent == _nconcurrent_no_boost) {
+    // Unchanged
+    return;
+  }
+
+  const uint ncreated = _workers.created_workers();
+  _nparallel = nparallel;
+  _nconcurrent_no_boost = nconcurrent;
+
+  if (nworkers() > ncreated) {
+    // Create additional worker threads. Threads that are no longer
+    // needed after a decrease stay parked in the gang.
+    _workers.update_active_workers(nworkers());
+    const uint nworkers_created = _workers.created_workers();
+    if (nworkers_created < nworkers()) {
+      log_warning(gc)("Failed to create worker threads, using %u workers", nworkers_created);
+      _nparallel = MIN2(_nparallel, nworkers_created);
+      _nconcurrent_no_boost = MIN2(_nconcurrent_no_boost, nworkers_created);
+    }
+
+    if (_workers.created_workers() > ncreated) {
+      register_workers();
+    }
+  }
+
+  _nconcurrent = clamp(_nconcurrent, 1u, nworkers());
+
+  log_info(gc)("Workers: %u parallel, %u concurrent", _nparallel, _nconcurrent_no_boost);
+}
+
 void ZWorkers::run(ZTask* task, uint nworkers) {
   log_debug(gc, task)("Executing Task: %s, Active Workers: %u", task->name(), nworkers);
   _workers.update_active_workers(nworkers);
@@ -100,10 +166,22 @@ void ZWorkers::run(ZTask* task, uint nworkers) {
 }
 
 void ZWorkers::run_parallel(ZTask* task) {
+  task->set_low_priority(false);
+  task->reset_dispatch();
+
+  const Ticks start = Ticks::now();
   run(task, nparallel());
+  const Ticks end = Ticks::now();
+
+  // Sample the time spent dispatching the task to, and joining, the
+  // workers, which is part of the pause for tasks run in pauses
+  ZStatSample(ZSamplerParallelTaskDispatch, task->dispatch_overhead(start, end));
 }
 
 void ZWorkers::run_concurrent(ZTask* task) {
+  // Concurrent work only runs at low priority when explicitly
+  // enabled, and boosted work always runs at normal priority
+  task->set_low_priority(ZConcurrentLowPriority && !_boost);
   run(task, nconcurrent());
 }
 
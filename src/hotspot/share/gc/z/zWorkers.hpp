@@ -33,11 +33,17 @@ class ZTask;
 class ZWorkers {
 private:
   bool     _boost;
+  uint     _nparallel;
+  uint     _nconcurrent_no_boost;
+  uint     _nconcurrent;
   WorkGang _workers;
 
   void run(ZTask* task, uint nworkers);
+  void register_workers();
 
 public:
+  static uint nworkers_max();
+
   ZWorkers();
 
   uint nparallel() const;
@@ -47,6 +53,8 @@ public:
   uint nworkers() const;
 
   void set_boost(bool boost);
+  void set_nconcurrent(uint nconcurrent);
+  void set_nworkers(uint nparallel, uint nconcurrent);
 
   void run_parallel(ZTask* task);
   void run_concurrent(ZTask* task);
@@ -32,19 +32,19 @@ inline uint ZWorkers::nparallel() const {
 }
 
 inline uint ZWorkers::nparallel_no_boost() const {
-  return ParallelGCThreads;
+  return _nparallel;
 }
 
 inline uint ZWorkers::nconcurrent() const {
-  return _boost ? nworkers() : nconcurrent_no_boost();
+  return _boost ? nworkers() : _nconcurrent;
 }
 
 inline uint ZWorkers::nconcurrent_no_boost() const {
-  return ConcGCThreads;
+  return _nconcurrent_no_boost;
 }
 
 inline uint ZWorkers::nworkers() const {
-  return MAX2(ParallelGCThreads, ConcGCThreads);
+  return MAX2(_nparallel, _nconcurrent_no_boost);
 }
 
 #endif // SHARE_GC_Z_ZWORKERS_INLINE_HPP
@@ -46,16 +46,203 @@
   experimental(double, ZAllocationSpikeTolerance, 2.0,                      \
           "Allocation spike tolerance factor")                              \
                                                                             \
+  experimental(bool, ZAllocationRateTrend, true,                            \
+          "Forecast the allocation rate over the duration of a GC cycle "   \
+          "based on the allocation rate trend")                             \
+                                                                            \
   experimental(double, ZFragmentationLimit, 25.0,                           \
           "Maximum allowed heap fragmentation")                             \
                                                                             \
+  experimental(double, ZExplicitGCFragmentationLimit, 5.0,                  \
+          "Maximum allowed heap fragmentation after an explicit or idle "   \
+          "GC, which also ignores the relocation limits")                   \
+          range(0.0, 100.0)                                                 \
+                                                                            \
+  experimental(bool, ZExplicitGCUncommit, true,                             \
+          "Uncommit unused memory without delay after an explicit or "      \
+          "idle GC")                                                        \
+                                                                            \
+  experimental(ccstr, ZDirectorStateFile, NULL,                             \
+          "Save the allocation rate and GC duration learned by the "        \
+          "director to the specified file at exit, and seed them from "     \
+          "it at startup, to skip the warmup cycles after a restart")       \
+                                                                            \
+  experimental(bool, ZRelocationCostModel, true,                            \
+          "Select pages to relocate by their estimated relocation cost "    \
+          "per reclaimed byte, instead of by live bytes only")              \
+                                                                            \
+  experimental(uint, ZPageHotnessInterval, 0,                               \
+          "Sample how recently the memory of each page was accessed at "    \
+          "the specified interval (in seconds), using idle page tracking, " \
+          "and favor relocating cold pages (0 disables sampling)")          \
+          range(0, 3600)                                                    \
+                                                                            \
+  experimental(double, ZRelocationSkipLimit, 0.0,                           \
+          "Skip relocation, including the Relocate Start pause, in "        \
+          "proactive and timer GC cycles when relocating the selected "     \
+          "pages would reclaim less than this percentage of the max heap "  \
+          "size (0 means never skip)")                                      \
+          range(0.0, 100.0)                                                 \
+                                                                            \
+  experimental(size_t, ZRelocationLimit, 0,                                 \
+          "Maximum number of live bytes to relocate per GC cycle "          \
+          "(0 means no limit)")                                             \
+                                                                            \
+  experimental(double, ZRelocationTimeLimit, 0.0,                           \
+          "Maximum projected duration of relocation per GC cycle (in "      \
+          "seconds), based on the relocation throughput of previous "       \
+          "cycles (0 means no limit)")                                      \
+          range(0.0, 3600.0)                                                \
+                                                                            \
+  experimental(uint, ZTenuringThreshold, 3,                                 \
+          "Number of GC cycles an object must survive before it is "        \
+          "relocated to tenured pages (0 means no age segregation)")        \
+          range(0, 255)                                                     \
+                                                                            \
+  experimental(bool, ZTrackObjectAge, false,                                \
+          "Track the age of individual objects in the mark word when they " \
+          "are relocated, and tenure objects by their own age instead of "  \
+          "by the age of their page")                                       \
+                                                                            \
+  experimental(size_t, ZNonTemporalCopyLimit, 16*K,                         \
+          "Copy relocated objects of at least this size (in bytes) using "  \
+          "non-temporal stores (0 means never)")                            \
+                                                                            \
+  experimental(size_t, ZNonTemporalZeroLimit, 1*M,                          \
+          "Clear the elements of allocated arrays of at least this size "   \
+          "(in bytes) using non-temporal stores (0 means never)")           \
+                                                                            \
+  experimental(bool, ZRelocateInReferenceOrder, false,                      \
+          "Relocate objects referenced from newly relocated objects "       \
+          "first, to place related objects close to each other")            \
+                                                                            \
+  experimental(ccstr, ZAllocationStallPolicy, "fifo",                       \
+          "Order in which stalled page allocations are satisfied: fifo, "   \
+          "bypass (fifo, but requests that fit may bypass earlier "         \
+          "requests) or smallest (smallest request first)")                 \
+                                                                            \
+  experimental(bool, ZAllocationStallAssist, true,                          \
+          "Let threads stalled on allocation help relocate pages while "    \
+          "waiting")                                                        \
+                                                                            \
+  experimental(bool, ZPacing, false,                                        \
+          "Delay allocating threads in proportion to their allocation "     \
+          "rate when GC is not expected to complete before the heap runs "  \
+          "out of memory")                                                  \
+                                                                            \
+  experimental(uint, ZPacingMaxDelay, 10,                                   \
+          "Max delay of an allocating thread per pacing point when "        \
+          "pacing allocations (in milliseconds)")                           \
+          range(1, 1000)                                                    \
+                                                                            \
+  experimental(uint, ZSmallPageMagazineSize, 2,                             \
+          "Number of free small pages kept per CPU, to allocate and free "  \
+          "small pages without taking the page allocator lock (0 means "    \
+          "disabled)")                                                      \
+          range(0, 16)                                                      \
+                                                                            \
+  experimental(bool, ZKeepTLABsAtMarkStart, false,                          \
+          "Keep TLABs with enough space left across the mark start pause, " \
+          "instead of retiring them. Objects allocated in a kept TLAB are " \
+          "implicitly live, and its page is not relocated in that cycle")   \
+                                                                            \
+  experimental(bool, ZDedicatedTLABPages, false,                            \
+          "Let threads that allocate fast enough to want TLABs larger than "\
+          "the small object size limit take a whole small page as TLAB")    \
+                                                                            \
+  experimental(size_t, ZSmallObjectSizeLimit, 0,                            \
+          "Max size of objects allocated in small pages, such as 512K to "  \
+          "keep objects of a few hundred kilobytes off medium pages (0 "    \
+          "means 12.5% of the small page size)")                            \
+          range(0, 1*M)                                                     \
+                                                                            \
+  experimental(size_t, ZMediumPageSize, 0,                                  \
+          "Size of medium pages, rounded down to a power of two between "   \
+          "the small page size, which disables medium pages, and 16 times " \
+          "the small page size (0 means 3.125% of the max heap size)")      \
+          range(0, 32*M)                                                    \
+                                                                            \
+  experimental(ccstr, ZThreadCPUs, NULL,                                    \
+          "List of CPUs, such as 0-3,8, to bind the GC worker, director, "  \
+          "driver and uncommitter threads to")                              \
+                                                                            \
+  experimental(ccstr, ZAllocationPartitions, NULL,                          \
+          "List of Java thread name prefixes and soft max capacities, "     \
+          "such as tenant-a-:1G,tenant-b-:512M, dividing the heap into "    \
+          "allocation partitions")                                          \
+                                                                            \
+  experimental(bool, ZConcurrentLowPriority, false,                         \
+          "Run concurrent GC work at low priority (SCHED_IDLE on Linux), "  \
+          "unless the workers are boosted")                                 \
+                                                                            \
+  experimental(bool, ZNUMABindSmallPages, false,                            \
+          "Bind memory for small pages to the NUMA node of the allocating " \
+          "thread, instead of interleaving it across all NUMA nodes")       \
+                                                                            \
+  experimental(int, ZColdMemoryNode, -1,                                    \
+          "NUMA node of a slower memory tier, such as CXL or persistent "   \
+          "memory exposed as a memory-only node, on which to place "        \
+          "tenured pages (-1 means disabled, requires UseNUMA)")            \
+          range(-1, 255)                                                    \
+                                                                            \
+  experimental(bool, ZCollectClassHistogram, false,                         \
+          "Collect a class histogram of the live objects found during "     \
+          "marking, printed with -Xlog:gc+classhisto=trace")                \
+                                                                            \
+  experimental(bool, ZLiveMapHeapInspection, false,                         \
+          "Let parallel heap inspection, such as class histograms, visit "  \
+          "the objects found live by the last marking, by walking the "     \
+          "live maps instead of tracing the object graph, when no objects " \
+          "have moved since")                                               \
+                                                                            \
+  experimental(bool, ZHugeTLBFSFallback, false,                             \
+          "When using explicit large pages, commit memory from a tmpfs "    \
+          "backing file, with transparent huge pages if supported, when "   \
+          "the huge page pool is exhausted")                                \
+                                                                            \
+  experimental(bool, ZLargePagesForMetadata, false,                         \
+          "Back mark stack space and forwarding tables with transparent "   \
+          "huge pages, when the heap uses transparent huge pages")          \
+                                                                            \
   experimental(size_t, ZMarkStackSpaceLimit, 8*G,                           \
           "Maximum number of bytes allocated for mark stacks")              \
           range(32*M, 1024*G)                                               \
                                                                             \
+  manageable(uint, ZParallelGCThreads, 0,                                   \
+          "Number of parallel GC worker threads, which can be changed at "  \
+          "run time and takes effect at the next GC cycle (0 means use "    \
+          "ParallelGCThreads)")                                             \
+                                                                            \
+  manageable(uint, ZConcGCThreads, 0,                                       \
+          "Number of concurrent GC worker threads, which can be changed "   \
+          "at run time and takes effect at the next GC cycle (0 means use " \
+          "ConcGCThreads)")                                                 \
+                                                                            \
+  experimental(bool, ZLazyRuntimeWorkers, false,                            \
+          "Create the runtime worker threads, used for parallel safepoint " \
+          "cleanup and heap inspection, when first needed instead of at "   \
+          "startup")                                                        \
+                                                                            \
   experimental(uint, ZCollectionInterval, 0,                                \
           "Force GC at a fixed time interval (in seconds)")                 \
                                                                             \
+  experimental(uint, ZIdleGCDelay, 0,                                       \
+          "Force a compacting GC once the application has been idle for "   \
+          "the specified amount of time (in seconds, 0 means disabled)")    \
+                                                                            \
+  experimental(uint, ZIdleAllocationRate, 1,                                \
+          "Allocation rate (in MB/s) below which the application is "       \
+          "considered idle")                                                \
+                                                                            \
+  experimental(double, ZIdleCPULoad, 0.1,                                   \
+          "System load average per CPU below which the application is "     \
+          "considered idle")                                                \
+                                                                            \
+  experimental(uint, ZPageCacheRetentionTime, 10,                           \
+          "Keep enough memory committed for the forecasted page demand "    \
+          "during the specified amount of time (in seconds) when "          \
+          "uncommitting")                                                   \
+                                                                            \
   experimental(bool, ZUncommit, true,                                       \
           "Uncommit unused memory")                                         \
                                                                             \
@@ -63,6 +250,74 @@
           "Uncommit memory if it has been unused for the specified "        \
           "amount of time (in seconds)")                                    \
                                                                             \
+  experimental(size_t, ZUncommitBudget, 1*G,                                \
+          "Max amount of memory to uncommit per second, reduced by the "    \
+          "current allocation rate")                                        \
+                                                                            \
+  experimental(uint, ZVirtualReserveRatio, 4,                               \
+          "Amount of address space to initially reserve for the heap, as "  \
+          "a multiple of the max heap size. The reservation is extended "   \
+          "on demand when fragmentation exhausts it, up to 16 times the "   \
+          "max heap size")                                                  \
+          range(1, 16)                                                      \
+                                                                            \
+  experimental(bool, ZAdaptiveRelocationReserve, false,                     \
+          "Size the heap reserve each GC cycle from the to-space needed "   \
+          "to relocate the selected relocation set")                        \
+                                                                            \
+  experimental(bool, ZAdaptiveSoftMaxHeapSize, false,                       \
+          "Lower the soft max heap size under cgroup v2 memory pressure, "  \
+          "and to stay below the cgroup memory.high limit, and raise it "   \
+          "again when the pressure clears")                                 \
+                                                                            \
+  experimental(double, ZMemoryPressureLimit, 10.0,                          \
+          "Memory pressure (percentage of time stalled on memory) above "   \
+          "which the soft max heap size is lowered")                        \
+          range(0.0, 100.0)                                                 \
+                                                                            \
+  experimental(uint, ZCPUOverheadTarget, 0,                                 \
+          "Target CPU time spent by GC, as a percentage of the CPU time "   \
+          "used by the process. The director grows or shrinks the soft "    \
+          "max heap size and paces proactive GCs to hold this target "      \
+          "(0 means no target)")                                            \
+          range(0, 50)                                                      \
+                                                                            \
+  experimental(uint, ZNMethodColdCycles, 0,                                 \
+          "Number of GC cycles an nmethod can go without being called "     \
+          "before it is unloaded (0 means never, requires ClassUnloading)") \
+          range(0, 255)                                                     \
+                                                                            \
+  experimental(bool, ZDefragmentPageCache, true,                            \
+          "Periodically destroy cached pages backed by fragmented physical "\
+          "memory, to reduce the number of memory mappings")                \
+                                                                            \
+  experimental(size_t, ZZeroedPageCacheSize, 0,                             \
+          "Amount of free memory to zero in the background, which lets "    \
+          "medium and large arrays skip clearing (0 means disabled)")       \
+                                                                            \
+  experimental(double, ZCommitAheadTime, 1.0,                               \
+          "Commit memory ahead of allocation to cover the allocation "      \
+          "rate for the specified amount of time (in seconds), "            \
+          "0 disables committing ahead of allocation")                      \
+          range(0.0, 60.0)                                                  \
+                                                                            \
+  experimental(bool, ZDeferInitialCommit, false,                            \
+          "Commit only part of the initial heap at startup, and commit "    \
+          "the rest in the background, ahead of allocation")                \
+                                                                            \
+  experimental(bool, ZCommitAheadPreTouch, false,                           \
+          "Map and pre-touch memory committed ahead of allocation, so "     \
+          "that allocating threads don't take the page faults")             \
+                                                                            \
+  experimental(bool, ZCollapseTransparentHugePages, false,                  \
+          "Synchronously collapse memory committed ahead of allocation "    \
+          "into transparent huge pages (requires UseTransparentHugePages "  \
+          "and kernel support for MADV_COLLAPSE)")                          \
+                                                                            \
+  experimental(bool, ZRemapAfterRelocation, false,                          \
+          "Eagerly remap stale pointers in live objects after relocation, " \
+          "when the director expects a long time until the next GC")        \
+                                                                            \
   diagnostic(uint, ZStatisticsInterval, 10,                                 \
           "Time between statistics print outs (in seconds)")                \
           range(1, (uint)-1)                                                \
@@ -70,6 +325,33 @@
   diagnostic(bool, ZProactive, true,                                        \
           "Enable proactive GC cycles")                                     \
                                                                             \
+  experimental(bool, ZGraduatedSoftReferenceClearing, false,                \
+          "Clear SoftReferences progressively, based on the amount of "     \
+          "memory forecast to be free at the end of the GC cycle. All "     \
+          "SoftReferences are still cleared before a stalled allocation "   \
+          "fails")                                                          \
+                                                                            \
+  diagnostic(bool, ZDirectorWakeup, true,                                   \
+          "Wake up the director between ticks when heap usage crosses "     \
+          "the level at which it would start a GC cycle")                   \
+                                                                            \
+  diagnostic(bool, ZMarkStackCompactEntries, true,                          \
+          "Use compact 32-bit mark stack entries when the heap is small "   \
+          "enough")                                                         \
+                                                                            \
+  diagnostic(bool, ZMarkPrefetch, true,                                     \
+          "Prefetch objects and mark bits before marking")                  \
+                                                                            \
+  diagnostic(bool, ZProfileBarrierSlowPaths, false,                         \
+          "Count load barrier slow paths taken by mutators per class of "   \
+          "the healed object, and log the top classes after each GC "       \
+          "cycle (requires -Xlog:gc+barrier)")                              \
+                                                                            \
+  diagnostic(bool, ZProfileClasses, false,                                  \
+          "Accumulate marked and relocated bytes per class, and report "    \
+          "the classes with the highest GC cost after each GC cycle "       \
+          "(see -Xlog:gc+classhisto and jcmd GC.z_class_profile)")          \
+                                                                            \
   diagnostic(bool, ZVerifyViews, false,                                     \
           "Verify heap view accesses")                                      \
                                                                             \
@@ -79,9 +361,31 @@
   diagnostic(bool, ZVerifyObjects, false,                                   \
           "Verify objects")                                                 \
                                                                             \
+  diagnostic(bool, ZVerifyObjectsParallel, false,                           \
+          "Verify objects by walking the live maps of marked pages using "  \
+          "all workers, instead of tracing the object graph. Objects "      \
+          "allocated since mark start are not verified")                    \
+                                                                            \
+  diagnostic(uint, ZVerifyObjectsSamplePercent, 100,                        \
+          "Percentage of marked pages, picked at random, to verify when "   \
+          "verifying objects in parallel")                                  \
+          range(1, 100)                                                     \
+                                                                            \
+  diagnostic(uint, ZVerifyObjectsTimeBudget, 0,                             \
+          "Maximum time (in milliseconds) spent verifying objects in "      \
+          "parallel per verification (0 means no limit)")                   \
+                                                                            \
   diagnostic(bool, ZVerifyMarking, trueInDebug,                             \
           "Verify marking stacks")                                          \
                                                                             \
+  diagnostic(bool, ZCompactForwarding, true,                                \
+          "Use compact forwarding tables for densely populated small "      \
+          "pages")                                                          \
+                                                                            \
+  diagnostic(bool, ZRelocateLargePages, true,                               \
+          "Relocate large pages by remapping them at a higher address, "    \
+          "to reduce address space fragmentation")                          \
+                                                                            \
   diagnostic(bool, ZVerifyForwarding, false,                                \
           "Verify forwarding tables")
 
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "logging/log.hpp"
+#include "logging/logAsyncWriter.hpp"
+#include "logging/logConfiguration.hpp"
+#include "logging/logFileOutput.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/globals.hpp"
+
+AsyncLogWriter* AsyncLogWriter::_instance = NULL;
+
+AsyncLogMessage::AsyncLogMessage(LogFileOutput* output, const LogDecorations& decorations, const char* message) :
+    _next(NULL),
+    _output(output),
+    _decorations(decorations),
+    _message(os::strdup(message, mtLogging)) {}
+
+AsyncLogMessage::~AsyncLogMessage() {
+  os::free(_message);
+}
+
+AsyncLogWriter::AsyncLogWriter() :
+    _lock(),
+    _io_sem(1),
+    _first(NULL),
+    _last(NULL),
+    _buffer_size(0),
+    _initialized(os::create_thread(this, os::asynclog_thread)) {
+  if (_initialized) {
+    os::set_priority(this, NearMaxPriority);
+    os::start_thread(this);
+  }
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+  guarantee(false, "AsyncLogWriter deletion must fix the race with VM termination");
+}
+
+void AsyncLogWriter::initialize() {
+  if (!LogConfiguration::is_async_mode()) {
+    return;
+  }
+
+  assert(_instance == NULL, "Already initialized");
+  AsyncLogWriter* const writer = new AsyncLogWriter();
+  if (!writer->_initialized) {
+    log_warning(logging, thread)("Failed to create the asynchronous log writer thread, "
+                                 "falling back to synchronous logging");
+    return;
+  }
+
+  Atomic::release_store(&_instance, writer);
+  log_info(logging)("Asynchronous logging enabled, buffer size: " SIZE_FORMAT "K", AsyncLogBufferSize / K);
+}
+
+AsyncLogWriter* AsyncLogWriter::instance() {
+  return Atomic::load_acquire(&_instance);
+}
+
+bool AsyncLogWriter::enqueue_locked(LogFileOutput* output, const LogDecorations& decorations, const char* msg) {
+  const size_t size = sizeof(AsyncLogMessage) + strlen(msg) + 1;
+  if (_buffer_size + size > AsyncLogBufferSize) {
+    // Buffer full, drop message
+    output->increment_async_dropped();
+    return false;
+  }
+
+  AsyncLogMessage* const m = new AsyncLogMessage(output, decorations, msg);
+  if (_last == NULL) {
+    _first = m;
+  } else {
+    _last->_next = m;
+  }
+  _last = m;
+  _buffer_size += size;
+  return true;
+}
+
+void AsyncLogWriter::enqueue(LogFileOutput* output, const LogDecorations& decorations, const char* msg) {
+  _lock.lock();
+  if (enqueue_locked(output, decorations, msg)) {
+    _lock.notify();
+  }
+  _lock.unlock();
+}
+
+void AsyncLogWriter::enqueue(LogFileOutput* output, LogMessageBuffer::Iterator msg_iterator) {
+  // Enqueue all lines of the message under the lock, to keep them together
+  bool enqueued = false;
+  _lock.lock();
+  for (; !msg_iterator.is_at_end(); msg_iterator++) {
+    enqueued |= enqueue_locked(output, msg_iterator.decorations(), msg_iterator.message());
+  }
+  if (enqueued) {
+    _lock.notify();
+  }
+  _lock.unlock();
+}
+
+void AsyncLogWriter::write() {
+  // Writers are serialized, to keep the messages in order
+  _io_sem.wait();
+
+  // Drain buffer
+  _lock.lock();
+  AsyncLogMessage* m = _first;
+  _first = NULL;
+  _last = NULL;
+  _buffer_size = 0;
+  _lock.unlock();
+
+  // Write messages, without holding the lock
+  while (m != NULL) {
+    const size_t dropped = m->_output->reset_async_dropped();
+    if (dropped > 0) {
+      char buf[64];
+      jio_snprintf(buf, sizeof(buf), SIZE_FORMAT " messages dropped due to async logging", dropped);
+      m->_output->write_blocking(m->_decorations, buf);
+    }
+
+    m->_output->write_blocking(m->_decorations, m->_message);
+
+    AsyncLogMessage* const next = m->_next;
+    delete m;
+    m = next;
+  }
+
+  _io_sem.signal();
+}
+
+void AsyncLogWriter::flush() {
+  AsyncLogWriter* const writer = instance();
+  if (writer != NULL) {
+    writer->write();
+  }
+}
+
+void AsyncLogWriter::run() {
+  for (;;) {
+    // Wait for messages
+    _lock.lock();
+    while (_first == NULL) {
+      _lock.wait(0 /* no timeout */);
+    }
+    _lock.unlock();
+
+    write();
+  }
+}
+
+void AsyncLogWriter::print_on(outputStream* st) const {
+  st->print("\"%s\" ", name());
+  Thread::print_on(st);
+  st->cr();
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef SHARE_LOGGING_LOGASYNCWRITER_HPP
+#define SHARE_LOGGING_LOGASYNCWRITER_HPP
+
+#include "logging/logDecorations.hpp"
+#include "logging/logMessageBuffer.hpp"
+#include "memory/allocation.hpp"
+#include "runtime/os.hpp"
+#include "runtime/semaphore.hpp"
+#include "runtime/thread.hpp"
+
+class LogFileOutput;
+
+// A log message waiting to be written by the AsyncLogWriter.
+class AsyncLogMessage : public CHeapObj<mtLogging> {
+  friend class AsyncLogWriter;
+ private:
+  AsyncLogMessage* _next;
+  LogFileOutput*   _output;
+  LogDecorations   _decorations;
+  char*            _message;
+
+ public:
+  AsyncLogMessage(LogFileOutput* output, const LogDecorations& decorations, const char* message);
+  ~AsyncLogMessage();
+};
+
+// The asynchronous log writer, enabled with -Xlog:async. Threads logging
+// to file outputs append their messages to a bounded in-memory buffer,
+// which a dedicated thread drains to the files. A thread that logs never
+// waits for file I/O, only for the short critical section that appends
+// to the buffer. Messages that do not fit in the buffer are dropped and
+// counted, and the count is later written to the affected output.
+// Outputs to stdout and stderr are always written synchronously.
+class AsyncLogWriter : public NonJavaThread {
+ private:
+  static AsyncLogWriter* _instance;
+
+  os::PlatformMonitor _lock;        // Protects the buffer, never held during I/O
+  Semaphore           _io_sem;      // Serializes writing of drained messages
+  AsyncLogMessage*    _first;
+  AsyncLogMessage*    _last;
+  size_t              _buffer_size;
+  const bool          _initialized;
+
+  AsyncLogWriter();
+
+  // No destruction allowed
+  ~AsyncLogWriter();
+
+  bool enqueue_locked(LogFileOutput* output, const LogDecorations& decorations, const char* msg);
+  void write();
+
+ protected:
+  virtual void run();
+
+ public:
+  static void initialize();
+  static AsyncLogWriter* instance();
+
+  // Write all buffered messages, and wait until they have been written
+  static void flush();
+
+  void enqueue(LogFileOutput* output, const LogDecorations& decorations, const char* msg);
+  void enqueue(LogFileOutput* output, LogMessageBuffer::Iterator msg_iterator);
+
+  char* name() const { return (char*)"AsyncLog Thread"; }
+  void print_on(outputStream* st) const;
+};
+
+#endif // SHARE_LOGGING_LOGASYNCWRITER_HPP
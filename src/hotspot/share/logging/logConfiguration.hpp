@@ -58,6 +58,7 @@ class LogConfiguration : public AllStatic {
 
   static UpdateListenerFunction*    _listener_callbacks;
   static size_t                     _n_listener_callbacks;
+  static bool                       _async_mode;
 
   // Create a new output. Returns NULL if failed.
   static LogOutput* new_output(const char* name, const char* options, outputStream* errstream);
@@ -123,6 +124,10 @@ class LogConfiguration : public AllStatic {
 
   // Rotates all LogOutput
   static void rotate_all_outputs();
+
+  // Asynchronous logging to file outputs, enabled with -Xlog:async
+  static bool is_async_mode() { return _async_mode; }
+  static void set_async_mode(bool value) { _async_mode = value; }
 };
 
 #endif // SHARE_LOGGING_LOGCONFIGURATION_HPP
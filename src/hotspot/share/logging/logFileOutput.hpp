@@ -60,6 +60,9 @@ class LogFileOutput : public LogFileStreamOutput {
   size_t  _rotate_size;
   size_t  _current_size;
 
+  // Number of messages dropped by the asynchronous log writer
+  volatile size_t _async_dropped;
+
   // Semaphore used for synchronizing file rotations and writes
   Semaphore _rotation_semaphore;
 
@@ -85,6 +88,7 @@ class LogFileOutput : public LogFileStreamOutput {
   virtual bool initialize(const char* options, outputStream* errstream);
   virtual int write(const LogDecorations& decorations, const char* msg);
   virtual int write(LogMessageBuffer::Iterator msg_iterator);
+  int write_blocking(const LogDecorations& decorations, const char* msg);
   virtual void force_rotate();
   virtual void describe(outputStream* out);
 
@@ -92,6 +96,9 @@ class LogFileOutput : public LogFileStreamOutput {
     return _name;
   }
 
+  void increment_async_dropped();
+  size_t reset_async_dropped();
+
   const char* cur_log_file_name();
   static const char* const Prefix;
   static void set_file_name_parameters(jlong start_time);
@@ -88,6 +88,7 @@
   LOG_TAG(jfr) \
   LOG_TAG(jit) \
   LOG_TAG(jni) \
+  LOG_TAG(json) \
   LOG_TAG(jvmti) \
   LOG_TAG(liveness) \
   LOG_TAG(load) /* Trace all classes loaded */ \
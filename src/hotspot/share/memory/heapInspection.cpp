@@ -28,11 +28,13 @@
 #include "classfile/moduleEntry.hpp"
 #include "classfile/systemDictionary.hpp"
 #include "gc/shared/collectedHeap.hpp"
+#include "gc/shared/workgroup.hpp"
 #include "memory/heapInspection.hpp"
 #include "memory/resourceArea.hpp"
 #include "memory/universe.hpp"
 #include "oops/oop.inline.hpp"
 #include "oops/reflectionAccessorImplKlassHelper.hpp"
+#include "runtime/mutexLocker.hpp"
 #include "runtime/os.hpp"
 #include "utilities/globalDefinitions.hpp"
 #include "utilities/macros.hpp"
@@ -231,6 +233,42 @@ bool KlassInfoTable::record_instance(const oop obj) {
   }
 }
 
+bool KlassInfoTable::record_instances(Klass* k, long count, size_t words) {
+  KlassInfoEntry* elt = lookup(k);
+  // elt may be NULL if it's a new klass for which we
+  // could not allocate space for a new entry in the hashtable.
+  if (elt != NULL) {
+    elt->set_count(elt->count() + count);
+    elt->set_words(elt->words() + words);
+    _size_of_instances_in_words += words;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+class KlassInfoTableMergeClosure : public KlassInfoClosure {
+ private:
+  KlassInfoTable* _dest;
+  bool _success;
+ public:
+  KlassInfoTableMergeClosure(KlassInfoTable* table) : _dest(table), _success(true) {}
+
+  void do_cinfo(KlassInfoEntry* cie) {
+    _success &= _dest->record_instances(cie->klass(), cie->count(), cie->words());
+  }
+
+  bool success() { return _success; }
+};
+
+// Return false if some of the entries could not be merged on account
+// of running out of space required to create new entries.
+bool KlassInfoTable::merge(KlassInfoTable* table) {
+  KlassInfoTableMergeClosure closure(this);
+  table->iterate(&closure);
+  return closure.success();
+}
+
 void KlassInfoTable::iterate(KlassInfoClosure* cic) {
   assert(_buckets != NULL, "Allocation failure should have been caught");
   for (int index = 0; index < _num_buckets; index++) {
@@ -690,6 +728,7 @@ class HistoClosure : public KlassInfoClosure {
   }
 };
 
+// A NULL table records no instances, and counts all of them as missed.
 class RecordInstanceClosure : public ObjectClosure {
  private:
   KlassInfoTable* _cit;
@@ -701,7 +740,7 @@ class RecordInstanceClosure : public ObjectClosure {
 
   void do_object(oop obj) {
     if (should_visit(obj)) {
-      if (!_cit->record_instance(obj)) {
+      if (_cit == NULL || !_cit->record_instance(obj)) {
         _missed_count++;
       }
     }
@@ -715,9 +754,68 @@ class RecordInstanceClosure : public ObjectClosure {
   }
 };
 
-size_t HeapInspection::populate_table(KlassInfoTable* cit, BoolObjectClosure *filter) {
+// Populates per-worker tables in parallel, which are then merged into
+// the shared table.
+class ParHeapInspectTask : public AbstractGangTask {
+ private:
+  ParallelObjectIterator* _poi;
+  KlassInfoTable* _shared_cit;
+  BoolObjectClosure* _filter;
+  size_t _missed_count;
+  Mutex _mutex;
+
+ public:
+  ParHeapInspectTask(ParallelObjectIterator* poi, KlassInfoTable* shared_cit, BoolObjectClosure* filter) :
+    AbstractGangTask("Iterating heap"),
+    _poi(poi),
+    _shared_cit(shared_cit),
+    _filter(filter),
+    _missed_count(0),
+    _mutex(Mutex::leaf, "Parallel heap inspection merge lock", false, Mutex::_safepoint_check_never) {}
+
+  size_t missed_count() const { return _missed_count; }
+
+  virtual void work(uint worker_id) {
+    KlassInfoTable cit(false /* add_all_classes */);
+    if (cit.allocation_failed()) {
+      // Record nothing, but still take part in the iteration so
+      // that the other workers can terminate.
+      RecordInstanceClosure ric(NULL /* cit */, _filter);
+      _poi->object_iterate(&ric, worker_id);
+      MutexLocker ml(&_mutex, Mutex::_no_safepoint_check_flag);
+      _missed_count += ric.missed_count();
+      return;
+    }
+
+    RecordInstanceClosure ric(&cit, _filter);
+    _poi->object_iterate(&ric, worker_id);
+
+    MutexLocker ml(&_mutex, Mutex::_no_safepoint_check_flag);
+    _missed_count += ric.missed_count();
+    if (!_shared_cit->merge(&cit)) {
+      // Undercounted, but not by a known number of instances
+      _missed_count++;
+    }
+  }
+};
+
+size_t HeapInspection::populate_table(KlassInfoTable* cit, BoolObjectClosure *filter, uint parallel_thread_num) {
   ResourceMark rm;
 
+  if (parallel_thread_num > 1) {
+    WorkGang* const gang = Universe::heap()->get_safepoint_workers();
+    if (gang != NULL) {
+      const uint nworkers = MIN2(parallel_thread_num, gang->total_workers());
+      ParallelObjectIterator* const poi = Universe::heap()->parallel_object_iterator(nworkers);
+      if (poi != NULL) {
+        ParHeapInspectTask task(poi, cit, filter);
+        gang->run_task(&task, nworkers);
+        delete poi;
+        return task.missed_count();
+      }
+    }
+  }
+
   RecordInstanceClosure ric(cit, filter);
   Universe::heap()->object_iterate(&ric);
   return ric.missed_count();
@@ -747,7 +845,7 @@ void HeapInspection::heap_inspection(outputStream* st) {
   KlassInfoTable cit(_print_class_stats);
   if (!cit.allocation_failed()) {
     // populate table with object allocation info
-    size_t missed_count = populate_table(&cit);
+    size_t missed_count = populate_table(&cit, NULL /* filter */, ParallelGCThreads);
     if (missed_count != 0) {
       st->print_cr("WARNING: Ran out of C-heap; undercounted " SIZE_FORMAT
                    " total instances in data below",
@@ -95,6 +95,12 @@
 #include "gc/parallel/parallelScavengeHeap.inline.hpp"
 #include "gc/parallel/adjoiningGenerations.hpp"
 #endif // INCLUDE_PARALLELGC
+#if INCLUDE_ZGC
+#include "gc/z/zAddress.inline.hpp"
+#include "gc/z/zHeap.hpp"
+#include "gc/z/zOop.inline.hpp"
+#include "gc/z/zStat.hpp"
+#endif // INCLUDE_ZGC
 #if INCLUDE_NMT
 #include "services/mallocSiteTable.hpp"
 #include "services/memTracker.hpp"
@@ -704,6 +710,86 @@ WB_END
 
 #endif // INCLUDE_G1GC
 
+#if INCLUDE_ZGC
+
+static jlong z_ticks_to_nanos(uint64_t ticks) {
+  return (jlong)(TimeHelper::counter_to_seconds((jlong)ticks) * NANOSECS_PER_SEC);
+}
+
+WB_ENTRY(jdouble, WB_ZMinimumMutatorUtilization(JNIEnv* env, jobject o, jint time_slice_ms))
+  if (UseZGC) {
+    switch (time_slice_ms) {
+    case 2:   return ZStatMMU::mmu_2ms();
+    case 5:   return ZStatMMU::mmu_5ms();
+    case 10:  return ZStatMMU::mmu_10ms();
+    case 20:  return ZStatMMU::mmu_20ms();
+    case 50:  return ZStatMMU::mmu_50ms();
+    case 100: return ZStatMMU::mmu_100ms();
+    default:
+      THROW_MSG_0(vmSymbols::java_lang_IllegalArgumentException(),
+                  "WB_ZMinimumMutatorUtilization: time slice should be 2, 5, 10, 20, 50 or 100 ms");
+    }
+  }
+  THROW_MSG_0(vmSymbols::java_lang_UnsupportedOperationException(), "WB_ZMinimumMutatorUtilization: ZGC is not enabled");
+WB_END
+
+WB_ENTRY(jlong, WB_ZPausePercentile(JNIEnv* env, jobject o, jdouble percent))
+  if (UseZGC) {
+    return z_ticks_to_nanos(ZStatLatency::pauses().percentile(percent));
+  }
+  THROW_MSG_0(vmSymbols::java_lang_UnsupportedOperationException(), "WB_ZPausePercentile: ZGC is not enabled");
+WB_END
+
+WB_ENTRY(jlong, WB_ZPauseCount(JNIEnv* env, jobject o))
+  if (UseZGC) {
+    return (jlong)ZStatLatency::pauses().count();
+  }
+  THROW_MSG_0(vmSymbols::java_lang_UnsupportedOperationException(), "WB_ZPauseCount: ZGC is not enabled");
+WB_END
+
+WB_ENTRY(jlong, WB_ZAllocationStallTime(JNIEnv* env, jobject o))
+  if (UseZGC) {
+    return z_ticks_to_nanos(ZStatLatency::allocation_stalls().total());
+  }
+  THROW_MSG_0(vmSymbols::java_lang_UnsupportedOperationException(), "WB_ZAllocationStallTime: ZGC is not enabled");
+WB_END
+
+WB_ENTRY(jlong, WB_ZAllocationStallCount(JNIEnv* env, jobject o))
+  if (UseZGC) {
+    return (jlong)ZStatLatency::allocation_stalls().count();
+  }
+  THROW_MSG_0(vmSymbols::java_lang_UnsupportedOperationException(), "WB_ZAllocationStallCount: ZGC is not enabled");
+WB_END
+
+WB_ENTRY(void, WB_ZForceRelocation(JNIEnv* env, jobject o, jobject obj))
+  if (UseZGC) {
+    // Relocate the page holding the object in the next GC cycle
+    const oop p = JNIHandles::resolve(obj);
+    ZHeap::heap()->force_relocation(ZOop::to_address(p));
+    return;
+  }
+  THROW_MSG(vmSymbols::java_lang_UnsupportedOperationException(), "WB_ZForceRelocation: ZGC is not enabled");
+WB_END
+
+WB_ENTRY(jlong, WB_ZStatCounter(JNIEnv* env, jobject o, jstring group, jstring name))
+  if (UseZGC) {
+    ResourceMark rm(THREAD);
+    const char* const group_str = java_lang_String::as_utf8_string(JNIHandles::resolve_non_null(group));
+    const char* const name_str = java_lang_String::as_utf8_string(JNIHandles::resolve_non_null(name));
+    for (const ZStatCounter* counter = ZStatCounter::first(); counter != NULL; counter = counter->next()) {
+      if (strcmp(counter->group(), group_str) == 0 && strcmp(counter->name(), name_str) == 0) {
+        return (jlong)counter->total();
+      }
+    }
+
+    // Unknown counter
+    return -1;
+  }
+  THROW_MSG_0(vmSymbols::java_lang_UnsupportedOperationException(), "WB_ZStatCounter: ZGC is not enabled");
+WB_END
+
+#endif // INCLUDE_ZGC
+
 #if INCLUDE_NMT
 // Alloc memory using the test memory type so that we can use that to see if
 // NMT picks it up correctly
@@ -2238,6 +2324,16 @@ static JNINativeMethod methods[] = {
   {CC"g1MemoryNodeIds",    CC"()[I",                  (void*)&WB_G1MemoryNodeIds },
   {CC"g1GetMixedGCInfo",   CC"(I)[J",                 (void*)&WB_G1GetMixedGCInfo },
 #endif // INCLUDE_G1GC
+#if INCLUDE_ZGC
+  {CC"zMinimumMutatorUtilization", CC"(I)D",          (void*)&WB_ZMinimumMutatorUtilization },
+  {CC"zPausePercentile",   CC"(D)J",                  (void*)&WB_ZPausePercentile },
+  {CC"zPauseCount",        CC"()J",                   (void*)&WB_ZPauseCount },
+  {CC"zAllocationStallTime", CC"()J",                 (void*)&WB_ZAllocationStallTime },
+  {CC"zAllocationStallCount", CC"()J",                (void*)&WB_ZAllocationStallCount },
+  {CC"zForceRelocation",   CC"(Ljava/lang/Object;)V", (void*)&WB_ZForceRelocation },
+  {CC"zStatCounter",       CC"(Ljava/lang/String;Ljava/lang/String;)J",
+                                                      (void*)&WB_ZStatCounter },
+#endif // INCLUDE_ZGC
 #if INCLUDE_G1GC || INCLUDE_PARALLELGC
   {CC"dramReservedStart",   CC"()J",                  (void*)&WB_DramReservedStart },
   {CC"dramReservedEnd",     CC"()J",                  (void*)&WB_DramReservedEnd },
@@ -538,6 +538,12 @@ const size_t minimumSymbolTableSize = 1024;
           "directory) of the dump file (defaults to java_pid<pid>.hprof "   \
           "in the working directory)")                                      \
                                                                             \
+  manageable(uint, HeapDumpParallelThreads, 1,                              \
+          "Number of threads writing the objects of a heap dump, each to "  \
+          "its own part file, which is appended to the dump file when "     \
+          "done (1 means serial)")                                          \
+          range(1, max_jint)                                                \
+                                                                            \
   develop(bool, BreakAtWarning, false,                                      \
           "Execute breakpoint upon encountering VM warning")                \
                                                                             \
@@ -1134,6 +1140,10 @@ const size_t minimumSymbolTableSize = 1024;
   diagnostic(bool, LogVMOutput, false,                                      \
           "Save VM output to LogFile")                                      \
                                                                             \
+  product(size_t, AsyncLogBufferSize, 2*M,                                  \
+          "Memory budget (in bytes) for the buffer of -Xlog:async")         \
+          range(100*K, 50*M)                                                \
+                                                                            \
   diagnostic(ccstr, LogFile, NULL,                                          \
           "If LogVMOutput or LogCompilation is on, save VM output to "      \
           "this file [default: ./hotspot_pid%p.log] (%p replaced with pid)")\
@@ -51,6 +51,7 @@ public:
   void do_handshake(JavaThread* thread);
   bool thread_has_completed() { return _done.trywait(); }
   bool executed() const { return _executed; }
+  bool is_target(JavaThread* thread) { return _handshake_cl->is_target(thread); }
   const char* name() { return _handshake_cl->name(); }
 
 #ifdef ASSERT
@@ -181,8 +182,10 @@ class VM_HandshakeAllThreads: public VM_Handshake {
     JavaThreadIteratorWithHandle jtiwh;
     int number_of_threads_issued = 0;
     for (JavaThread *thr = jtiwh.next(); thr != NULL; thr = jtiwh.next()) {
-      set_handshake(thr);
-      number_of_threads_issued++;
+      if (_op->is_target(thr)) {
+        set_handshake(thr);
+        number_of_threads_issued++;
+      }
     }
 
     if (number_of_threads_issued < 1) {
@@ -246,7 +249,7 @@ public:
   void doit() {
     log_trace(handshake)("VMThread executing VM_HandshakeFallbackOperation, operation: %s", name());
     for (JavaThreadIteratorWithHandle jtiwh; JavaThread *t = jtiwh.next(); ) {
-      if (_all_threads || t == _target_thread) {
+      if ((_all_threads && _handshake_cl->is_target(t)) || t == _target_thread) {
         if (t == _target_thread) {
           _executed = true;
         }
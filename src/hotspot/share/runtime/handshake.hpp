@@ -36,7 +36,8 @@ class JavaThread;
 // while that thread is in a safepoint safe state. The callback is executed
 // either by the thread itself or by the VM thread while keeping the thread
 // in a blocked state. A handshake can be performed with a single
-// JavaThread as well.
+// JavaThread as well. A handshake with all threads only targets the
+// threads for which is_target() returns true.
 class HandshakeClosure : public ThreadClosure {
   const char* const _name;
  public:
@@ -44,6 +45,9 @@ class HandshakeClosure : public ThreadClosure {
   const char* name() const {
     return _name;
   }
+  virtual bool is_target(JavaThread* thread) {
+    return true;
+  }
   virtual void do_thread(Thread* thread) = 0;
 };
 
@@ -221,7 +221,7 @@ void mutex_init() {
 
     def(MonitoringSupport_lock     , PaddedMutex  , native   ,   true,  _safepoint_check_never);      // used for serviceability monitoring support
   }
-  if (UseShenandoahGC) {
+  if (UseShenandoahGC || UseZGC) {
     def(StringDedupQueue_lock      , PaddedMonitor, leaf,        true,  _safepoint_check_never);
     def(StringDedupTable_lock      , PaddedMutex  , leaf,        true,  _safepoint_check_never);
   }
@@ -65,6 +65,7 @@
 #include "runtime/thread.inline.hpp"
 #include "runtime/threadSMR.hpp"
 #include "runtime/timerTrace.hpp"
+#include "runtime/vmThread.hpp"
 #include "services/runtimeService.hpp"
 #include "utilities/events.hpp"
 #include "utilities/macros.hpp"
@@ -264,6 +265,7 @@ int SafepointSynchronize::synchronize_threads(jlong safepoint_limit_time, int no
       assert(cur_tss->is_running(), "Illegal initial state");
       if (thread_not_running(cur_tss)) {
         --still_running;
+        SafepointTracing::thread_synchronized(cur_tss->thread());
         *p_prev = NULL;
         ThreadSafepointState *tmp = cur_tss;
         cur_tss = cur_tss->get_next();
@@ -529,6 +531,8 @@ bool SafepointSynchronize::is_cleanup_needed() {
   if (!InlineCacheBuffer::is_empty()) return true;
   if (StringTable::needs_rehashing()) return true;
   if (SymbolTable::needs_rehashing()) return true;
+  // Need a safepoint if dictionary resizing was deferred by earlier safepoints
+  if (Dictionary::does_any_dictionary_needs_resizing()) return true;
   return false;
 }
 
@@ -562,13 +566,15 @@ private:
   ParallelSPCleanupThreadClosure _cleanup_threads_cl;
   uint _num_workers;
   DeflateMonitorCounters* _counters;
+  bool _defer_optional;
 public:
-  ParallelSPCleanupTask(uint num_workers, DeflateMonitorCounters* counters) :
+  ParallelSPCleanupTask(uint num_workers, DeflateMonitorCounters* counters, bool defer_optional) :
     AbstractGangTask("Parallel Safepoint Cleanup"),
     _subtasks(SubTasksDone(SafepointSynchronize::SAFEPOINT_CLEANUP_NUM_TASKS)),
     _cleanup_threads_cl(ParallelSPCleanupThreadClosure(counters)),
     _num_workers(num_workers),
-    _counters(counters) {}
+    _counters(counters),
+    _defer_optional(defer_optional) {}
 
   void work(uint worker_id) {
     uint64_t safepoint_id = SafepointSynchronize::safepoint_id();
@@ -593,7 +599,11 @@ public:
       post_safepoint_cleanup_task_event(event, safepoint_id, name);
     }
 
-    if (_subtasks.try_claim_task(SafepointSynchronize::SAFEPOINT_CLEANUP_COMPILATION_POLICY)) {
+    // The compilation policy work, table rehashing and dictionary resizing
+    // are optional, and are deferred to a later safepoint if requested.
+    // Rehashing needs are tracked by is_cleanup_needed(), which will force
+    // a cleanup safepoint if they are not handled by another safepoint.
+    if (_subtasks.try_claim_task(SafepointSynchronize::SAFEPOINT_CLEANUP_COMPILATION_POLICY) && !_defer_optional) {
       const char* name = "compilation policy safepoint handler";
       EventSafepointCleanupTask event;
       TraceTime timer(name, TRACETIME_LOG(Info, safepoint, cleanup));
@@ -602,7 +612,7 @@ public:
       post_safepoint_cleanup_task_event(event, safepoint_id, name);
     }
 
-    if (_subtasks.try_claim_task(SafepointSynchronize::SAFEPOINT_CLEANUP_SYMBOL_TABLE_REHASH)) {
+    if (_subtasks.try_claim_task(SafepointSynchronize::SAFEPOINT_CLEANUP_SYMBOL_TABLE_REHASH) && !_defer_optional) {
       if (SymbolTable::needs_rehashing()) {
         const char* name = "rehashing symbol table";
         EventSafepointCleanupTask event;
@@ -613,7 +623,7 @@ public:
       }
     }
 
-    if (_subtasks.try_claim_task(SafepointSynchronize::SAFEPOINT_CLEANUP_STRING_TABLE_REHASH)) {
+    if (_subtasks.try_claim_task(SafepointSynchronize::SAFEPOINT_CLEANUP_STRING_TABLE_REHASH) && !_defer_optional) {
       if (StringTable::needs_rehashing()) {
         const char* name = "rehashing string table";
         EventSafepointCleanupTask event;
@@ -624,7 +634,7 @@ public:
       }
     }
 
-    if (_subtasks.try_claim_task(SafepointSynchronize::SAFEPOINT_CLEANUP_SYSTEM_DICTIONARY_RESIZE)) {
+    if (_subtasks.try_claim_task(SafepointSynchronize::SAFEPOINT_CLEANUP_SYSTEM_DICTIONARY_RESIZE) && !_defer_optional) {
       if (Dictionary::does_any_dictionary_needs_resizing()) {
         const char* name = "resizing system dictionaries";
         EventSafepointCleanupTask event;
@@ -654,18 +664,26 @@ void SafepointSynchronize::do_cleanup_tasks() {
   DeflateMonitorCounters deflate_counters;
   ObjectSynchronizer::prepare_deflate_idle_monitors(&deflate_counters);
 
+  // The operation that started the safepoint can ask for the optional
+  // cleanup tasks to be deferred.
+  const VM_Operation* op = VMThread::vm_operation();
+  const bool defer_optional = (op != NULL) && op->defer_optional_safepoint_cleanup();
+  if (defer_optional) {
+    log_debug(safepoint, cleanup)("Deferring optional cleanup tasks for %s", op->name());
+  }
+
   CollectedHeap* heap = Universe::heap();
   assert(heap != NULL, "heap not initialized yet?");
   WorkGang* cleanup_workers = heap->get_safepoint_workers();
   if (cleanup_workers != NULL) {
     // Parallel cleanup using GC provided thread pool.
     uint num_cleanup_workers = cleanup_workers->active_workers();
-    ParallelSPCleanupTask cleanup(num_cleanup_workers, &deflate_counters);
+    ParallelSPCleanupTask cleanup(num_cleanup_workers, &deflate_counters, defer_optional);
     StrongRootsScope srs(num_cleanup_workers);
     cleanup_workers->run_task(&cleanup);
   } else {
     // Serial cleanup using VMThread.
-    ParallelSPCleanupTask cleanup(1, &deflate_counters);
+    ParallelSPCleanupTask cleanup(1, &deflate_counters, defer_optional);
     StrongRootsScope srs(1);
     cleanup.work(0);
   }
@@ -1154,6 +1172,7 @@ int SafepointTracing::_nof_threads = 0;
 int SafepointTracing::_nof_running = 0;
 int SafepointTracing::_page_trap = 0;
 VM_Operation::VMOp_Type SafepointTracing::_current_type;
+JavaThread* SafepointTracing::_slowest_threads[SafepointTracing::nof_slowest_threads] = {NULL};
 jlong     SafepointTracing::_max_sync_time = 0;
 jlong     SafepointTracing::_max_vmop_time = 0;
 uint64_t  SafepointTracing::_op_count[VM_Operation::VMOp_Terminating] = {0};
@@ -1242,6 +1261,10 @@ void SafepointTracing::begin(VM_Operation::VMOp_Type type) {
   _last_safepoint_sync_time_ns = 0;
   _last_safepoint_cleanup_time_ns = 0;
 
+  for (uint i = 0; i < nof_slowest_threads; i++) {
+    _slowest_threads[i] = NULL;
+  }
+
   _last_app_time_ns = _last_safepoint_begin_time_ns - _last_safepoint_end_time_ns;
   _last_safepoint_end_time_ns = 0;
 
@@ -1256,6 +1279,21 @@ void SafepointTracing::synchronized(int nof_threads, int nof_running, int traps)
   RuntimeService::record_safepoint_synchronized(_last_safepoint_sync_time_ns - _last_safepoint_begin_time_ns);
 }
 
+void SafepointTracing::thread_synchronized(JavaThread* thread) {
+  // Called for each thread that was still running after the first
+  // pass over all threads, in the order they reached the safepoint
+  for (uint i = nof_slowest_threads - 1; i > 0; i--) {
+    _slowest_threads[i] = _slowest_threads[i - 1];
+  }
+  _slowest_threads[0] = thread;
+}
+
+JavaThread* SafepointTracing::slowest_thread(uint index) {
+  assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
+  assert(index < nof_slowest_threads, "Invalid index");
+  return _slowest_threads[index];
+}
+
 void SafepointTracing::cleanup() {
   _last_safepoint_cleanup_time_ns = os::javaTimeNanos();
 }
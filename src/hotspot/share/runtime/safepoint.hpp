@@ -263,6 +263,7 @@ private:
   static int _page_trap;
 
   static VM_Operation::VMOp_Type _current_type;
+  static JavaThread* _slowest_threads[];
   static jlong     _max_sync_time;
   static jlong     _max_vmop_time;
   static uint64_t  _op_count[VM_Operation::VMOp_Terminating];
@@ -274,6 +275,7 @@ public:
 
   static void begin(VM_Operation::VMOp_Type type);
   static void synchronized(int nof_threads, int nof_running, int traps);
+  static void thread_synchronized(JavaThread* thread);
   static void cleanup();
   static void end();
 
@@ -290,6 +292,16 @@ public:
   static jlong start_of_safepoint() {
     return _last_safepoint_begin_time_ns;
   }
+
+  static jlong time_to_safepoint_ns() {
+    return _last_safepoint_sync_time_ns - _last_safepoint_begin_time_ns;
+  }
+
+  // The threads that were last to reach the current safepoint, slowest
+  // first. Returns NULL if fewer threads had to be waited for. Only valid
+  // while the safepoint is in progress.
+  static const uint nof_slowest_threads = 3;
+  static JavaThread* slowest_thread(uint index);
 };
 
 #endif // SHARE_RUNTIME_SAFEPOINT_HPP
@@ -183,6 +183,11 @@ class VM_Operation : public StackObj {
   // or concurrently with Java threads running.
   virtual bool evaluate_at_safepoint() const { return true; }
 
+  // An operation evaluated at a safepoint can defer the safepoint cleanup
+  // tasks that are not needed by the operation itself to a later safepoint,
+  // to keep its pause short.
+  virtual bool defer_optional_safepoint_cleanup() const { return false; }
+
   // Debugging
   virtual void print_on_error(outputStream* st) const;
   virtual const char* name() const  { return _names[type()]; }
@@ -51,6 +51,10 @@
 #include "utilities/events.hpp"
 #include "utilities/formatBuffer.hpp"
 #include "utilities/macros.hpp"
+#if INCLUDE_ZGC
+#include "gc/z/zClassProfile.hpp"
+#include "gc/z/zHeap.hpp"
+#endif
 
 
 static void loadAgentModule(TRAPS) {
@@ -87,6 +91,12 @@ void DCmdRegistrant::register_dcmds(){
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<RunFinalizationDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<HeapInfoDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<FinalizerInfoDCmd>(full_export, true, false));
+#if INCLUDE_ZGC
+  if (UseZGC) {
+    DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ZHeapMapDCmd>(full_export, true, false));
+    DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ZClassProfileDCmd>(full_export, true, false));
+  }
+#endif // INCLUDE_ZGC
 #if INCLUDE_SERVICES
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<HeapDumpDCmd>(DCmd_Source_Internal | DCmd_Source_AttachAPI, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ClassHistogramDCmd>(full_export, true, false));
@@ -454,6 +464,16 @@ void HeapInfoDCmd::execute(DCmdSource source, TRAPS) {
   Universe::heap()->print_on(output());
 }
 
+#if INCLUDE_ZGC
+void ZHeapMapDCmd::execute(DCmdSource source, TRAPS) {
+  ZHeap::heap()->print_heap_map_on(output());
+}
+
+void ZClassProfileDCmd::execute(DCmdSource source, TRAPS) {
+  ZClassProfile::print_on(output());
+}
+#endif // INCLUDE_ZGC
+
 void FinalizerInfoDCmd::execute(DCmdSource source, TRAPS) {
   ResourceMark rm;
 
@@ -304,6 +304,49 @@ public:
   virtual void execute(DCmdSource source, TRAPS);
 };
 
+#if INCLUDE_ZGC
+class ZHeapMapDCmd : public DCmd {
+public:
+  ZHeapMapDCmd(outputStream* output, bool heap) : DCmd(output, heap) { }
+  static const char* name() { return "GC.z_heap_map"; }
+  static const char* description() {
+    return "Provide a summary of the ZGC heap layout and fragmentation.";
+  }
+  static const char* impact() {
+    return "Low: Walks the page table without a safepoint";
+  }
+  static int num_arguments() { return 0; }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+      "monitor", NULL};
+      return p;
+  }
+
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
+class ZClassProfileDCmd : public DCmd {
+public:
+  ZClassProfileDCmd(outputStream* output, bool heap) : DCmd(output, heap) { }
+  static const char* name() { return "GC.z_class_profile"; }
+  static const char* description() {
+    return "Print the classes with the highest ZGC cost in the last GC cycle "
+           "(requires -XX:+ZProfileClasses).";
+  }
+  static const char* impact() {
+    return "Low";
+  }
+  static int num_arguments() { return 0; }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+      "monitor", NULL};
+      return p;
+  }
+
+  virtual void execute(DCmdSource source, TRAPS);
+};
+#endif // INCLUDE_ZGC
+
 class FinalizerInfoDCmd : public DCmd {
 public:
   FinalizerInfoDCmd(outputStream* output, bool heap) : DCmd(output, heap) { }
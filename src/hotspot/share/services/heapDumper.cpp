@@ -32,6 +32,7 @@
 #include "classfile/vmSymbols.hpp"
 #include "gc/shared/gcLocker.hpp"
 #include "gc/shared/gcVMOperations.hpp"
+#include "gc/shared/workgroup.hpp"
 #include "memory/allocation.inline.hpp"
 #include "memory/resourceArea.hpp"
 #include "memory/universe.hpp"
@@ -378,7 +379,7 @@ enum {
 
 // Supports I/O operations on a dump file
 
-class DumpWriter : public StackObj {
+class DumpWriter : public CHeapObj<mtInternal> {
  private:
   enum {
     io_buffer_size  = 8*M
@@ -403,8 +404,6 @@ class DumpWriter : public StackObj {
   size_t position() const                       { return _pos; }
   void set_position(size_t pos)                 { _pos = pos; }
 
-  void set_error(const char* error)             { _error = (char*)os::strdup(error); }
-
   // all I/O go through this function
   void write_internal(void* s, size_t len);
 
@@ -431,6 +430,7 @@ class DumpWriter : public StackObj {
   size_t bytes_unwritten() const        { return position(); }
 
   char* error() const                   { return _error; }
+  void set_error(const char* error)     { if (_error == NULL) _error = (char*)os::strdup(error); }
 
   jlong current_offset();
   void seek_to_offset(jlong pos);
@@ -445,6 +445,9 @@ class DumpWriter : public StackObj {
   void write_symbolID(Symbol* o);
   void write_classID(Klass* k);
   void write_id(u4 x);
+
+  // appends the contents of a file written by another dump writer
+  void append_file(const char* path);
 };
 
 DumpWriter::DumpWriter(const char* path) {
@@ -556,6 +559,34 @@ void DumpWriter::flush() {
   }
 }
 
+void DumpWriter::append_file(const char* path) {
+  const int fd = os::open(path, O_RDONLY, 0);
+  if (fd < 0) {
+    set_error(os::strerror(errno));
+    return;
+  }
+
+  // read through the I/O buffer, or a small local buffer if we don't have one
+  flush();
+  char local_buffer[4*K];
+  char* const buf = (buffer() != NULL) ? buffer() : local_buffer;
+  const size_t size = (buffer() != NULL) ? buffer_size() : sizeof(local_buffer);
+
+  while (is_open()) {
+    const ssize_t n = os::read(fd, buf, (uint)MIN2(size, (size_t)UINT_MAX));
+    if (n < 0) {
+      set_error(os::strerror(errno));
+      break;
+    }
+    if (n == 0) {
+      break;
+    }
+    write_internal(buf, n);
+  }
+
+  os::close(fd);
+}
+
 jlong DumpWriter::current_offset() {
   if (is_open()) {
     // the offset is the file offset plus whatever we have buffered
@@ -684,6 +715,9 @@ class DumperSupport : AllStatic {
   // fixes up the length of the current dump record
   static void write_current_dump_record_length(DumpWriter* writer);
 
+  // used on a sub-record boundary to check if we need to start a new segment
+  static void check_segment_length(DumpWriter* writer);
+
   // fixes up the current dump record and writes HPROF_HEAP_DUMP_END record
   static void end_of_dump(DumpWriter* writer);
 
@@ -1413,24 +1447,19 @@ class StickyClassDumper : public KlassClosure {
 };
 
 
-class VM_HeapDumper;
-
 // Support class using when iterating over the heap.
 
 class HeapObjectDumper : public ObjectClosure {
  private:
-  VM_HeapDumper* _dumper;
   DumpWriter* _writer;
 
-  VM_HeapDumper* dumper()               { return _dumper; }
   DumpWriter* writer()                  { return _writer; }
 
   // used to indicate that a record has been writen
   void mark_end_of_record();
 
  public:
-  HeapObjectDumper(VM_HeapDumper* dumper, DumpWriter* writer) {
-    _dumper = dumper;
+  HeapObjectDumper(DumpWriter* writer) {
     _writer = writer;
   }
 
@@ -1472,6 +1501,7 @@ class VM_HeapDumper : public VM_GC_Operation {
   static VM_HeapDumper* _global_dumper;
   static DumpWriter*    _global_writer;
   DumpWriter*           _local_writer;
+  const char*           _path;
   JavaThread*           _oome_thread;
   Method*               _oome_constructor;
   bool _gc_before_heap_dump;
@@ -1518,13 +1548,18 @@ class VM_HeapDumper : public VM_GC_Operation {
   // HPROF_TRACE and HPROF_FRAME records
   void dump_stack_traces();
 
+  // HPROF_GC_INSTANCE_DUMP, HPROF_GC_OBJ_ARRAY_DUMP and HPROF_GC_PRIM_ARRAY_DUMP records
+  void dump_objects();
+  bool dump_objects_parallel();
+
  public:
-  VM_HeapDumper(DumpWriter* writer, bool gc_before_heap_dump, bool oome) :
+  VM_HeapDumper(DumpWriter* writer, const char* path, bool gc_before_heap_dump, bool oome) :
     VM_GC_Operation(0 /* total collections,      dummy, ignored */,
                     GCCause::_heap_dump /* GC Cause */,
                     0 /* total full collections, dummy, ignored */,
                     gc_before_heap_dump) {
     _local_writer = writer;
+    _path = path;
     _gc_before_heap_dump = gc_before_heap_dump;
     _klass_map = new (ResourceObj::C_HEAP, mtInternal) GrowableArray<Klass*>(INITIAL_CLASS_COUNT, true);
     _stack_traces = NULL;
@@ -1606,17 +1641,21 @@ void DumperSupport::write_current_dump_record_length(DumpWriter* writer) {
 
 // used on a sub-record boundary to check if we need to start a
 // new segment.
-void VM_HeapDumper::check_segment_length() {
-  if (writer()->is_open()) {
-    julong dump_len = writer()->current_record_length();
+void DumperSupport::check_segment_length(DumpWriter* writer) {
+  if (writer->is_open()) {
+    julong dump_len = writer->current_record_length();
 
     if (dump_len > 2UL*G) {
-      DumperSupport::write_current_dump_record_length(writer());
-      DumperSupport::write_dump_header(writer());
+      write_current_dump_record_length(writer);
+      write_dump_header(writer);
     }
   }
 }
 
+void VM_HeapDumper::check_segment_length() {
+  DumperSupport::check_segment_length(writer());
+}
+
 // fixes up the current dump record and writes HPROF_HEAP_DUMP_END record
 void DumperSupport::end_of_dump(DumpWriter* writer) {
   if (writer->is_open()) {
@@ -1630,7 +1669,7 @@ void DumperSupport::end_of_dump(DumpWriter* writer) {
 
 // marks sub-record boundary
 void HeapObjectDumper::mark_end_of_record() {
-  dumper()->check_segment_length();
+  DumperSupport::check_segment_length(writer());
 }
 
 // writes a HPROF_LOAD_CLASS record for the class (and each of its
@@ -1794,6 +1833,100 @@ void VM_HeapDumper::do_threads() {
 }
 
 
+// Gang task used to dump the objects of the heap in parallel. Each worker
+// writes complete HPROF_HEAP_DUMP_SEGMENT records to its own part file.
+class ParHeapDumpTask : public AbstractGangTask {
+ private:
+  ParallelObjectIterator* _poi;
+  DumpWriter** _writers;
+
+ public:
+  ParHeapDumpTask(ParallelObjectIterator* poi, DumpWriter** writers) :
+    AbstractGangTask("Dumping heap"),
+    _poi(poi),
+    _writers(writers) {}
+
+  virtual void work(uint worker_id) {
+    DumpWriter* const writer = _writers[worker_id];
+    DumperSupport::write_dump_header(writer);
+    HeapObjectDumper obj_dumper(writer);
+    _poi->object_iterate(&obj_dumper, worker_id);
+    DumperSupport::write_current_dump_record_length(writer);
+    writer->close();
+  }
+};
+
+// returns false, without writing anything, if the objects can't be dumped in parallel
+bool VM_HeapDumper::dump_objects_parallel() {
+  WorkGang* const gang = Universe::heap()->get_safepoint_workers();
+  if (gang == NULL) {
+    return false;
+  }
+
+  const uint nworkers = MIN2(HeapDumpParallelThreads, gang->total_workers());
+  if (nworkers <= 1) {
+    return false;
+  }
+
+  // create a part file for each worker, next to the dump file
+  const size_t path_len = strlen(_path) + 16;
+  char** const paths = NEW_C_HEAP_ARRAY(char*, nworkers, mtInternal);
+  DumpWriter** const writers = NEW_C_HEAP_ARRAY(DumpWriter*, nworkers, mtInternal);
+  bool opened = true;
+  for (uint i = 0; i < nworkers; i++) {
+    paths[i] = NEW_C_HEAP_ARRAY(char, path_len, mtInternal);
+    jio_snprintf(paths[i], path_len, "%s.%u.part", _path, i);
+    writers[i] = new DumpWriter(paths[i]);
+    if (!writers[i]->is_open()) {
+      warning("Unable to create %s: %s, dumping heap serially", paths[i],
+              (writers[i]->error() != NULL) ? writers[i]->error() : "reason unknown");
+      opened = false;
+    }
+  }
+
+  ParallelObjectIterator* const poi = opened ? Universe::heap()->parallel_object_iterator(nworkers) : NULL;
+  if (poi != NULL) {
+    ParHeapDumpTask task(poi, writers);
+    gang->run_task(&task, nworkers);
+    delete poi;
+
+    // end the current segment, append the segments of the workers,
+    // and start a new segment for the records that follow
+    DumperSupport::write_current_dump_record_length(writer());
+    for (uint i = 0; i < nworkers; i++) {
+      if (writers[i]->error() != NULL) {
+        writer()->set_error(writers[i]->error());
+      }
+      writer()->append_file(paths[i]);
+    }
+    DumperSupport::write_dump_header(writer());
+  }
+
+  for (uint i = 0; i < nworkers; i++) {
+    // only remove the part files we created
+    const bool created = writers[i]->is_open() || poi != NULL;
+    delete writers[i];
+    if (created) {
+      remove(paths[i]);
+    }
+    FREE_C_HEAP_ARRAY(char, paths[i]);
+  }
+  FREE_C_HEAP_ARRAY(DumpWriter*, writers);
+  FREE_C_HEAP_ARRAY(char*, paths);
+
+  return poi != NULL;
+}
+
+void VM_HeapDumper::dump_objects() {
+  if (HeapDumpParallelThreads > 1 && dump_objects_parallel()) {
+    return;
+  }
+
+  HeapObjectDumper obj_dumper(writer());
+  Universe::heap()->object_iterate(&obj_dumper);
+}
+
+
 // The VM operation that dumps the heap. The dump consists of the following
 // records:
 //
@@ -1881,8 +2014,7 @@ void VM_HeapDumper::doit() {
   // segment is started.
   // The HPROF_GC_CLASS_DUMP and HPROF_GC_INSTANCE_DUMP are the vast bulk
   // of the heap dump.
-  HeapObjectDumper obj_dumper(this, writer());
-  Universe::heap()->object_iterate(&obj_dumper);
+  dump_objects();
 
   // HPROF_GC_ROOT_THREAD_OBJ + frames + jni locals
   do_threads();
@@ -1990,7 +2122,7 @@ int HeapDumper::dump(const char* path, outputStream* out) {
   }
 
   // generate the dump
-  VM_HeapDumper dumper(&writer, _gc_before_heap_dump, _oome);
+  VM_HeapDumper dumper(&writer, path, _gc_before_heap_dump, _oome);
   if (Thread::current()->is_VM_thread()) {
     assert(SafepointSynchronize::is_at_safepoint(), "Expected to be called at a safepoint");
     dumper.doit();
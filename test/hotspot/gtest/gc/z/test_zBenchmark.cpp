@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zAddress.inline.hpp"
+#include "gc/z/zForwarding.inline.hpp"
+#include "gc/z/zGlobals.hpp"
+#include "gc/z/zGranuleMap.inline.hpp"
+#include "gc/z/zLiveMap.inline.hpp"
+#include "gc/z/zMarkStack.inline.hpp"
+#include "gc/z/zPage.inline.hpp"
+#include "memory/iterator.hpp"
+#include "runtime/os.hpp"
+#include "utilities/ostream.hpp"
+#include "threadHelper.inline.hpp"
+#include "unittest.hpp"
+
+//
+// Microbenchmarks for core data structures. These are disabled by default,
+// and are run with:
+//
+//   gtestLauncher -jdk <jdk> --gtest_also_run_disabled_tests --gtest_filter='ZBenchmarkTest.*'
+//
+// Each benchmark is run a number of times and the fastest run is reported,
+// in nanoseconds per operation, which makes the numbers fairly stable and
+// comparable between builds on the same machine.
+//
+
+class ZBenchmarkTest : public ::testing::Test {
+protected:
+  static const uint nruns = 5;
+
+  class Benchmark : public StackObj {
+  private:
+    const char* const _name;
+    const size_t      _nops;
+    jlong             _best;
+    jlong             _start;
+
+  public:
+    Benchmark(const char* name, size_t nops) :
+        _name(name),
+        _nops(nops),
+        _best(max_jlong),
+        _start(0) {}
+
+    ~Benchmark() {
+      tty->print_cr("%-48s %10.2f ns/op", _name, (double)_best / _nops);
+    }
+
+    void start() {
+      _start = os::javaTimeNanos();
+    }
+
+    void stop() {
+      record(os::javaTimeNanos() - _start);
+    }
+
+    void record(jlong time) {
+      _best = MIN2(_best, time);
+    }
+  };
+
+  //
+  // ZForwarding
+  //
+
+  static void forwarding(uint32_t live_objects, double load_factor) {
+    // Create page
+    const ZVirtualMemory vmem(0, ZPageSizeSmall);
+    const ZPhysicalMemory pmem(ZPhysicalMemorySegment(0, ZPageSizeSmall));
+    ZPage page(ZPageTypeSmall, vmem, pmem);
+
+    page.reset();
+
+    const size_t object_size = 16;
+    const uintptr_t object = page.alloc_object(object_size);
+
+    ZGlobalSeqNum++;
+
+    bool dummy = false;
+    page.mark_object(ZAddress::marked(object), dummy, dummy);
+    page.inc_live(live_objects, live_objects * object_size);
+
+    // The table has twice as many entries as there are live objects,
+    // rounded up to a power of two
+    const size_t nentries = round_up_power_of_2(live_objects * 2);
+    const size_t ninserts = nentries * load_factor;
+
+    char name[64];
+    jio_snprintf(name, sizeof(name), "ZForwarding::insert (load %.0f%%)", load_factor * 100);
+    Benchmark insert(name, ninserts);
+    jio_snprintf(name, sizeof(name), "ZForwarding::find (load %.0f%%)", load_factor * 100);
+    Benchmark find(name, ninserts);
+
+    for (uint run = 0; run < nruns; run++) {
+      ZForwarding* const forwarding = ZForwarding::create(&page);
+
+      // Spread the from indices, as live objects typically are
+      insert.start();
+      for (size_t i = 0; i < ninserts; i++) {
+        ZForwardingCursor cursor;
+        const uintptr_t from_index = i * 3;
+        forwarding->find(from_index, &cursor);
+        forwarding->insert(from_index, i, &cursor);
+      }
+      insert.stop();
+
+      uintptr_t sum = 0;
+      find.start();
+      for (size_t i = 0; i < ninserts; i++) {
+        sum += forwarding->find(i * 3).to_offset();
+      }
+      find.stop();
+
+      ASSERT_EQ(sum, ninserts * (ninserts - 1) / 2);
+
+      ZForwarding::destroy(forwarding);
+    }
+  }
+
+  //
+  // ZLiveMap
+  //
+
+  class SetThread : public JavaTestThread {
+  private:
+    ZLiveMap* const _livemap;
+    const size_t    _nobjects;
+    const uint      _id;
+    const uint      _nthreads;
+
+  public:
+    SetThread(Semaphore* post, ZLiveMap* livemap, size_t nobjects, uint id, uint nthreads) :
+        JavaTestThread(post),
+        _livemap(livemap),
+        _nobjects(nobjects),
+        _id(id),
+        _nthreads(nthreads) {}
+
+    virtual void main_run() {
+      // Interleave the objects marked by the threads, so that
+      // they contend for the same bitmap words
+      bool inc_live;
+      uint32_t nmarked = 0;
+      for (size_t i = _id; i < _nobjects; i += _nthreads) {
+        if (_livemap->set(i * 2, false /* finalizable */, inc_live) && inc_live) {
+          nmarked++;
+        }
+      }
+
+      _livemap->inc_live(nmarked, nmarked << LogMinObjAlignmentInBytes);
+    }
+  };
+
+  static void livemap_set(uint nthreads) {
+    const size_t nobjects = ZPageSizeSmall >> LogMinObjAlignmentInBytes;
+
+    char name[64];
+    jio_snprintf(name, sizeof(name), "ZLiveMap::set (%u threads)", nthreads);
+    Benchmark set(name, nobjects);
+
+    for (uint run = 0; run < nruns; run++) {
+      ZLiveMap livemap(nobjects);
+      ZGlobalSeqNum++;
+
+      Semaphore post;
+      set.start();
+      for (uint i = 0; i < nthreads; i++) {
+        (new SetThread(&post, &livemap, nobjects, i, nthreads))->doit();
+      }
+      for (uint i = 0; i < nthreads; i++) {
+        post.wait();
+      }
+      set.stop();
+
+      ASSERT_EQ(livemap.live_objects(), (uint32_t)nobjects);
+    }
+  }
+
+  class CountClosure : public ObjectClosure {
+  private:
+    size_t _count;
+
+  public:
+    CountClosure() :
+        _count(0) {}
+
+    virtual void do_object(oop obj) {
+      _count++;
+    }
+
+    size_t count() const {
+      return _count;
+    }
+  };
+
+  static void livemap_iterate(size_t stride) {
+    // Two unit objects, one every stride units, with object ends
+    const size_t nunits = ZPageSizeSmall >> LogMinObjAlignmentInBytes;
+    const size_t nobjects = nunits / stride;
+
+    ZLiveMap livemap(nunits);
+    ZGlobalSeqNum++;
+
+    bool inc_live;
+    for (size_t i = 0; i < nobjects; i++) {
+      const size_t index = i * stride * 2;
+      livemap.set(index, false /* finalizable */, inc_live);
+      livemap.set_end(index, index + 3);
+    }
+
+    char name[64];
+    jio_snprintf(name, sizeof(name), "ZLiveMap::iterate (density %.1f%%)", 200.0 / stride);
+    Benchmark iterate(name, nobjects);
+
+    for (uint run = 0; run < nruns; run++) {
+      CountClosure cl;
+      iterate.start();
+      livemap.iterate(&cl, 0 /* page_start */, LogMinObjAlignmentInBytes);
+      iterate.stop();
+
+      ASSERT_EQ(cl.count(), nobjects);
+    }
+  }
+
+  //
+  // ZMarkStack
+  //
+
+  static void mark_stack() {
+    const size_t nrounds = 1000;
+    Benchmark push("ZMarkStack::push", nrounds * ZMarkStackSlots);
+    Benchmark pop("ZMarkStack::pop", nrounds * ZMarkStackSlots);
+
+    ZMarkStack* const stack = new ZMarkStack();
+
+    for (uint run = 0; run < nruns; run++) {
+      jlong push_time = 0;
+      jlong pop_time = 0;
+      size_t npopped = 0;
+
+      for (size_t round = 0; round < nrounds; round++) {
+        const jlong start = os::javaTimeNanos();
+        for (size_t i = 0; stack->push(ZMarkStackEntry(i * 8, false /* follow */, false /* finalizable */)); i++) {}
+        const jlong middle = os::javaTimeNanos();
+        for (ZMarkStackEntry entry; stack->pop(entry); npopped++) {}
+        const jlong end = os::javaTimeNanos();
+
+        push_time += middle - start;
+        pop_time += end - middle;
+      }
+
+      push.record(push_time);
+      pop.record(pop_time);
+
+      ASSERT_EQ(npopped, nrounds * ZMarkStackSlots);
+    }
+
+    delete stack;
+  }
+
+  //
+  // ZPageTable
+  //
+
+  static void page_table() {
+    // The page table is a granule map of page pointers
+    const size_t max_offset = 64 * G;
+    const size_t ngranules = max_offset >> ZGranuleSizeShift;
+    const size_t nlookups = 16 * M;
+    ZGranuleMap<ZPage*> map(max_offset);
+
+    for (size_t i = 0; i < ngranules; i++) {
+      map.put(i << ZGranuleSizeShift, (ZPage*)(i + 1));
+    }
+
+    Benchmark get("ZPageTable::get", nlookups);
+
+    for (uint run = 0; run < nruns; run++) {
+      // Look up pseudo-random addresses, like object references do
+      uintptr_t sum = 0;
+      uint64_t x = 88172645463325252ull;
+      get.start();
+      for (size_t i = 0; i < nlookups; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        sum += (uintptr_t)map.get(x % max_offset);
+      }
+      get.stop();
+
+      ASSERT_NE(sum, 0u);
+    }
+  }
+};
+
+TEST_VM_F(ZBenchmarkTest, DISABLED_forwarding) {
+  forwarding(8192, 0.25);
+  forwarding(8192, 0.50);
+  forwarding(8192, 0.75);
+}
+
+TEST_VM_F(ZBenchmarkTest, DISABLED_livemap_set) {
+  livemap_set(1);
+  livemap_set(2);
+  livemap_set(4);
+}
+
+TEST_VM_F(ZBenchmarkTest, DISABLED_livemap_iterate) {
+  livemap_iterate(2);
+  livemap_iterate(4);
+  livemap_iterate(20);
+  livemap_iterate(200);
+}
+
+TEST_VM_F(ZBenchmarkTest, DISABLED_mark_stack) {
+  mark_stack();
+}
+
+TEST_VM_F(ZBenchmarkTest, DISABLED_page_table) {
+  page_table();
+}
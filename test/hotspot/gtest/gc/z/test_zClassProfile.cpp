@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zClassProfile.hpp"
+#include "unittest.hpp"
+
+class ZClassProfileTest : public ::testing::Test {
+protected:
+  static Klass* klass(size_t i) {
+    // Fake, never dereferenced, Klass pointers
+    return (Klass*)((i + 1) * 8);
+  }
+
+  static const ZClassProfileEntry* find_entry(const ZClassProfileTable* table, Klass* klass) {
+    for (size_t i = 0; i < ZClassProfileTable::_nentries; i++) {
+      if (table->_entries[i]._klass == klass) {
+        return &table->_entries[i];
+      }
+    }
+
+    return NULL;
+  }
+
+  static size_t nused(const ZClassProfileTable* table) {
+    size_t n = 0;
+    for (size_t i = 0; i < ZClassProfileTable::_nentries; i++) {
+      if (table->_entries[i]._klass != NULL) {
+        n++;
+      }
+    }
+
+    return n;
+  }
+
+  static void test_record(bool atomic) {
+    ZClassProfileTable* const table = new ZClassProfileTable();
+
+    table->record(klass(0), 10, 20, 1, atomic);
+    table->record(klass(0), 30, 40, 2, atomic);
+
+    const ZClassProfileEntry* const entry = find_entry(table, klass(0));
+    ASSERT_TRUE(entry != NULL);
+    EXPECT_EQ(entry->_marked_bytes, 40u);
+    EXPECT_EQ(entry->_relocated_bytes, 60u);
+    EXPECT_EQ(entry->_relocated_objects, 3u);
+    EXPECT_EQ(nused(table), 1u);
+    EXPECT_EQ(table->_noverflow, 0u);
+
+    delete table;
+  }
+
+  static void test_overflow(bool atomic) {
+    ZClassProfileTable* const table = new ZClassProfileTable();
+    const size_t nentries = ZClassProfileTable::_nentries;
+    const size_t nklasses = nentries * 4;
+
+    // Record more classes than the table has entries, twice
+    for (size_t round = 0; round < 2; round++) {
+      for (size_t i = 0; i < nklasses; i++) {
+        table->record(klass(i), 1, 0, 0, atomic);
+      }
+    }
+
+    // Each class is either recorded in an entry both times,
+    // or counted as an overflow both times
+    size_t nrecorded = 0;
+    for (size_t i = 0; i < nklasses; i++) {
+      const ZClassProfileEntry* const entry = find_entry(table, klass(i));
+      if (entry != NULL) {
+        EXPECT_EQ(entry->_marked_bytes, 2u) << "Class " << i;
+        nrecorded++;
+      }
+    }
+
+    EXPECT_EQ(nrecorded, nused(table));
+    EXPECT_LE(nrecorded, nentries);
+    EXPECT_EQ(table->_noverflow, (nklasses - nrecorded) * 2);
+
+    // A full table keeps recording the classes it holds
+    for (size_t i = 0; i < nklasses; i++) {
+      const ZClassProfileEntry* const entry = find_entry(table, klass(i));
+      if (entry != NULL) {
+        const uint64_t noverflow = table->_noverflow;
+        table->record(klass(i), 1, 0, 0, atomic);
+        EXPECT_EQ(entry->_marked_bytes, 3u) << "Class " << i;
+        EXPECT_EQ(table->_noverflow, noverflow);
+      }
+    }
+
+    delete table;
+  }
+
+  static void test_merge() {
+    ZClassProfileTable* const table0 = new ZClassProfileTable();
+    ZClassProfileTable* const table1 = new ZClassProfileTable();
+
+    table0->record(klass(0), 1, 0, 0, false /* atomic */);
+    table0->record(klass(1), 2, 0, 0, false /* atomic */);
+    table1->record(klass(1), 4, 0, 0, true /* atomic */);
+    table1->record(klass(2), 8, 0, 0, true /* atomic */);
+
+    table0->merge(table1);
+
+    EXPECT_EQ(find_entry(table0, klass(0))->_marked_bytes, 1u);
+    EXPECT_EQ(find_entry(table0, klass(1))->_marked_bytes, 6u);
+    EXPECT_EQ(find_entry(table0, klass(2))->_marked_bytes, 8u);
+    EXPECT_EQ(nused(table0), 3u);
+
+    delete table0;
+    delete table1;
+  }
+};
+
+TEST_F(ZClassProfileTest, record) {
+  test_record(false /* atomic */);
+  test_record(true /* atomic */);
+}
+
+TEST_F(ZClassProfileTest, overflow) {
+  test_overflow(false /* atomic */);
+  test_overflow(true /* atomic */);
+}
+
+TEST_F(ZClassProfileTest, merge) {
+  test_merge();
+}
@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/shared/gcCause.hpp"
+#include "gc/z/zDirector.hpp"
+#include "gc/z/zStat.hpp"
+#include "memory/allocation.hpp"
+#include "runtime/flags/flagSetting.hpp"
+#include "runtime/globals_extension.hpp"
+#include "utilities/numberSeq.hpp"
+#include "unittest.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+//
+// Replays allocation rate and GC duration traces through the GC decision
+// rules of ZDirector, using a simple model of the heap, and reports the
+// number of GC cycles started by each rule, the time allocations were
+// stalled, and the CPU time spent by the concurrent workers. This makes
+// it possible to evaluate changes to the rules, or to the flags that
+// control them, against recorded traffic before deploying them.
+//
+// A trace is a list of samples, where each sample holds from its start
+// time until the start time of the next sample:
+//
+//   <start (s)> <allocation rate (MB/s)> <live (MB)> <GC duration (s)>
+//
+// The live size is what survives marking, and the GC duration is the
+// duration of a cycle using the default number of concurrent workers.
+// These can be extracted from the gc+heap and gc+phases logs, or from
+// the ZAllocationRate and GarbageCollection JFR events. To replay a
+// recorded trace, run the disabled replay test with ZDIRECTOR_TRACE
+// pointing to the trace file, and any flags to evaluate, for example:
+//
+//   ZDIRECTOR_TRACE=trace.txt ZDIRECTOR_HEAP=4096 gtestLauncher
+//       -jdk <jdk> --gtest_also_run_disabled_tests
+//       --gtest_filter=ZDirectorSimulatorTest.DISABLED_replay
+//       -XX:+UnlockExperimentalVMOptions -XX:ZAllocationSpikeTolerance=3
+//
+class ZDirectorSimulator {
+private:
+  struct Sample {
+    double _start;
+    double _alloc_rate;
+    size_t _live;
+    double _duration;
+  };
+
+  static const size_t max_samples = 4096;
+
+  const size_t   _max_capacity;
+  const size_t   _max_reserve;
+  const uint     _nworkers;
+  Sample* const  _samples;
+  size_t         _nsamples;
+
+  // Statistics, updated the same way as ZStatAllocRate and ZStatCycle
+  TruncatedSeq   _rate;
+  TruncatedSeq   _rate_avg;
+  ZStatTrend     _trend;
+  NumberSeq      _duration;
+  uint64_t       _nwarmup_cycles;
+  double         _end_of_last;
+  double         _idle_start;
+
+  // Heap model
+  size_t         _used;
+  size_t         _used_at_relocate_end;
+  bool           _is_alloc_stalled;
+  bool           _gc_active;
+  GCCause::Cause _gc_cause;
+  double         _gc_end;
+  size_t         _gc_live;
+
+  // Results
+  uint64_t       _ncycles[GCCause::_last_gc_cause];
+  uint64_t       _ncycles_total;
+  double         _stall_time;
+  double         _gc_cpu_time;
+
+  const Sample& sample_at(double now) const {
+    size_t i = 0;
+    while (i + 1 < _nsamples && _samples[i + 1]._start <= now) {
+      i++;
+    }
+    return _samples[i];
+  }
+
+  ZDirectorInputs inputs(double now) const {
+    ZDirectorInputs inputs;
+    inputs._time_since_last_gc = now - _end_of_last;
+    inputs._nwarmup_cycles = _nwarmup_cycles;
+    inputs._is_warm = _nwarmup_cycles >= 3;
+    inputs._is_duration_trustable = _nwarmup_cycles > 0;
+    inputs._duration_avg = _duration.davg();
+    inputs._duration_sd = _duration.dsd();
+    inputs._alloc_rate_avg = _rate.avg();
+    inputs._alloc_rate_avg_sd = _rate_avg.sd();
+    inputs._alloc_rate_trend = _trend;
+    inputs._soft_max_capacity = _max_capacity;
+    inputs._max_reserve = _max_reserve;
+    inputs._used = _used;
+    inputs._used_at_relocate_end = _used_at_relocate_end;
+    inputs._is_alloc_stalled = _is_alloc_stalled;
+    inputs._metaspace_committed = 0;
+    inputs._metaspace_capacity_until_gc = 0;
+    inputs._metaspace_rate_avg = 0.0;
+    inputs._metaspace_rate_avg_sd = 0.0;
+    inputs._idle_time = now - _idle_start;
+    return inputs;
+  }
+
+  void start_gc(double now, GCCause::Cause cause) {
+    const Sample& sample = sample_at(now);
+    _gc_active = true;
+    _gc_cause = cause;
+    _gc_end = now + sample._duration;
+    _gc_live = MIN2(sample._live, _used);
+    _gc_cpu_time += sample._duration * _nworkers;
+    _ncycles[cause]++;
+    _ncycles_total++;
+  }
+
+  void end_gc(double now, size_t allocated_during_gc) {
+    // Objects allocated during the cycle are not reclaimed
+    _gc_active = false;
+    _end_of_last = now;
+    _used = MIN2(_gc_live + allocated_during_gc, _max_capacity);
+    _used_at_relocate_end = _used;
+    _duration.add(sample_at(now)._duration);
+    if (_gc_cause == GCCause::_z_warmup) {
+      _nwarmup_cycles++;
+    }
+  }
+
+public:
+  ZDirectorSimulator(size_t max_capacity, size_t max_reserve, uint nworkers) :
+      _max_capacity(max_capacity),
+      _max_reserve(max_reserve),
+      _nworkers(nworkers),
+      _samples(NEW_C_HEAP_ARRAY(Sample, max_samples, mtGC)),
+      _nsamples(0),
+      _rate(ZStatAllocRate::sample_window_sec * ZStatAllocRate::sample_hz),
+      _rate_avg(ZStatAllocRate::sample_window_sec * ZStatAllocRate::sample_hz),
+      _trend(),
+      _duration(0.3 /* alpha */),
+      _nwarmup_cycles(0),
+      _end_of_last(0.0),
+      _idle_start(0.0),
+      _used(0),
+      _used_at_relocate_end(0),
+      _is_alloc_stalled(false),
+      _gc_active(false),
+      _gc_cause(GCCause::_no_gc),
+      _gc_end(0.0),
+      _gc_live(0),
+      _ncycles(),
+      _ncycles_total(0),
+      _stall_time(0.0),
+      _gc_cpu_time(0.0) {}
+
+  ~ZDirectorSimulator() {
+    FREE_C_HEAP_ARRAY(Sample, _samples);
+  }
+
+  void add_sample(double start, double alloc_rate, size_t live, double duration) {
+    ASSERT_LT(_nsamples, max_samples) << "Too many samples";
+    ASSERT_TRUE(_nsamples == 0 || _samples[_nsamples - 1]._start <= start) << "Samples out of order";
+    Sample& sample = _samples[_nsamples++];
+    sample._start = start;
+    sample._alloc_rate = alloc_rate;
+    sample._live = live;
+    sample._duration = duration;
+  }
+
+  bool load(const char* path) {
+    FILE* const file = fopen(path, "r");
+    if (file == NULL) {
+      return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL && _nsamples < max_samples) {
+      double start, alloc_rate_mb, live_mb, duration;
+      if (line[0] == '#' || sscanf(line, "%lf %lf %lf %lf", &start, &alloc_rate_mb, &live_mb, &duration) != 4) {
+        // Skip comments and malformed lines
+        continue;
+      }
+      add_sample(start, alloc_rate_mb * M, (size_t)(live_mb * M), duration);
+    }
+
+    fclose(file);
+    return _nsamples > 0;
+  }
+
+  void run(double seconds) {
+    const double tick = 1.0 / ZStatAllocRate::sample_hz;
+    const size_t limit = _max_capacity - MIN2(_max_capacity, _max_reserve);
+    size_t allocated_during_gc = 0;
+
+    for (double now = tick; now <= seconds; now += tick) {
+      // Allocate, stalling when the heap is full
+      const size_t wanted = sample_at(now)._alloc_rate * tick;
+      const size_t available = limit - MIN2(limit, _used);
+      const size_t allocated = MIN2(wanted, available);
+      _used += allocated;
+      _is_alloc_stalled = allocated < wanted;
+      if (_is_alloc_stalled) {
+        _stall_time += tick * (wanted - allocated) / wanted;
+      }
+
+      if (_gc_active) {
+        allocated_during_gc += allocated;
+        if (now >= _gc_end) {
+          end_gc(now, allocated_during_gc);
+          allocated_during_gc = 0;
+        }
+      }
+
+      // Sample allocation rate
+      const double bytes_per_second = allocated / tick;
+      _rate.add(bytes_per_second);
+      _rate_avg.add(_rate.avg());
+      _trend.add(bytes_per_second, tick);
+
+      // Sample idle time, the same way as ZDirector, except that
+      // the system load is not modelled
+      if (_rate.avg() > ZIdleAllocationRate * M) {
+        _idle_start = now;
+      }
+
+      if (_gc_active) {
+        // Decisions are only made while no cycle is running
+        continue;
+      }
+
+      if (_is_alloc_stalled) {
+        // Stalled allocations always start a cycle
+        start_gc(now, GCCause::_z_allocation_stall);
+        continue;
+      }
+
+      const GCCause::Cause cause = ZDirector::make_gc_decision(inputs(now));
+      if (cause != GCCause::_no_gc) {
+        start_gc(now, cause);
+      }
+    }
+  }
+
+  double end() const {
+    return (_nsamples > 0) ? _samples[_nsamples - 1]._start : 0.0;
+  }
+
+  uint64_t ncycles() const {
+    return _ncycles_total;
+  }
+
+  uint64_t ncycles(GCCause::Cause cause) const {
+    return _ncycles[cause];
+  }
+
+  double stall_time() const {
+    return _stall_time;
+  }
+
+  double gc_cpu_time() const {
+    return _gc_cpu_time;
+  }
+
+  void print(double seconds) const {
+    printf("Simulated %.1fs, heap " SIZE_FORMAT "M, reserve " SIZE_FORMAT "M, %u workers\n",
+           seconds, _max_capacity / M, _max_reserve / M, _nworkers);
+    printf("  GC cycles: " UINT64_FORMAT "\n", _ncycles_total);
+    for (int cause = 0; cause < GCCause::_last_gc_cause; cause++) {
+      if (_ncycles[cause] > 0) {
+        printf("    %s: " UINT64_FORMAT "\n", GCCause::to_string((GCCause::Cause)cause), _ncycles[cause]);
+      }
+    }
+    printf("  Allocation stalls: %.3fs\n", _stall_time);
+    printf("  GC CPU time: %.3fs (%.1f%% of one CPU)\n", _gc_cpu_time, _gc_cpu_time / seconds * 100.0);
+  }
+};
+
+TEST_VM(ZDirectorSimulatorTest, steady) {
+  // Steady allocation rate, with plenty of headroom
+  ZDirectorSimulator simulator(1024 * M, 32 * M, 2);
+  simulator.add_sample(0.0, 100 * M, 200 * M, 0.5);
+  simulator.run(60.0);
+
+  EXPECT_EQ(simulator.ncycles(GCCause::_z_warmup), 3u) << "Should warm up";
+  EXPECT_GT(simulator.ncycles(GCCause::_z_allocation_rate), 0u) << "Should collect on allocation rate";
+  EXPECT_EQ(simulator.ncycles(GCCause::_z_allocation_stall), 0u) << "Should not stall";
+  EXPECT_EQ(simulator.stall_time(), 0.0) << "Should not stall";
+}
+
+TEST_VM(ZDirectorSimulatorTest, overload) {
+  // Allocating more during a cycle than the heap can hold
+  ZDirectorSimulator simulator(1024 * M, 32 * M, 2);
+  simulator.add_sample(0.0, 2000 * M, 600 * M, 1.0);
+  simulator.run(30.0);
+
+  EXPECT_GT(simulator.ncycles(), 0u) << "Should collect";
+  EXPECT_GT(simulator.stall_time(), 0.0) << "Should stall";
+  EXPECT_GT(simulator.gc_cpu_time(), 0.0) << "Should use CPU";
+}
+
+static uint64_t idle_cycles(double seconds) {
+  // Allocate for 30 seconds, then go idle
+  ZDirectorSimulator simulator(1024 * M, 32 * M, 2);
+  simulator.add_sample(0.0, 20 * M, 200 * M, 0.5);
+  simulator.add_sample(30.0, 0, 200 * M, 0.5);
+  simulator.run(seconds);
+  return simulator.ncycles(GCCause::_z_idle);
+}
+
+TEST_VM(ZDirectorSimulatorTest, idle) {
+  FLAG_GUARD(ZIdleGCDelay);
+  FLAG_GUARD(ZProactive);
+
+  // Keep proactive cycles from claiming the idle period
+  FLAG_SET_CMDLINE(ZProactive, false);
+
+  FLAG_SET_CMDLINE(ZIdleGCDelay, 0);
+  EXPECT_EQ(idle_cycles(120.0), 0u) << "Should not collect when disabled";
+
+  FLAG_SET_CMDLINE(ZIdleGCDelay, 30);
+  EXPECT_EQ(idle_cycles(50.0), 0u) << "Should not collect before the delay";
+  EXPECT_EQ(idle_cycles(120.0), 1u) << "Should collect once per idle period";
+}
+
+TEST_VM(ZDirectorSimulatorTest, DISABLED_replay) {
+  const char* const path = getenv("ZDIRECTOR_TRACE");
+  ASSERT_TRUE(path != NULL) << "ZDIRECTOR_TRACE not set";
+
+  const char* const heap = getenv("ZDIRECTOR_HEAP");
+  const size_t max_capacity = (heap != NULL ? (size_t)atol(heap) : 1024) * M;
+  const size_t max_reserve = MIN2(max_capacity / 32, (size_t)(64 * M));
+
+  ZDirectorSimulator simulator(max_capacity, max_reserve, MAX2(ConcGCThreads, 1u));
+  ASSERT_TRUE(simulator.load(path)) << "Could not read trace: " << path;
+
+  // Replay until the start of the last sample
+  const double seconds = simulator.end();
+  simulator.run(seconds);
+  simulator.print(seconds);
+}
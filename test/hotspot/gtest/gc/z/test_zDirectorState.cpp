@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zDirectorState.hpp"
+#include "runtime/os.hpp"
+#include "unittest.hpp"
+
+#include <math.h>
+#include <stdio.h>
+
+class ZDirectorStateTest : public ::testing::Test {
+protected:
+  typedef ZDirectorState::ZData ZData;
+
+  char _path[JVM_MAXPATHLEN];
+
+  virtual void SetUp() {
+    jio_snprintf(_path, sizeof(_path), "%s%szdirectorstate.pid%d",
+                 os::get_temp_directory(), os::file_separator(), os::current_process_id());
+  }
+
+  virtual void TearDown() {
+    remove(_path);
+  }
+
+  static ZData valid_data() {
+    ZData data;
+    data._max_capacity = 512 * M;
+    data._duration_avg = 0.125;
+    data._duration_sd = 0.0625;
+    data._alloc_rate_avg = 100.0 * M;
+    data._alloc_rate_avg_sd = 10.0 * M;
+    return data;
+  }
+
+  void write_raw(const char* str) {
+    FILE* const file = fopen(_path, "w");
+    ASSERT_TRUE(file != NULL);
+    fputs(str, file);
+    fclose(file);
+  }
+
+  bool write(const ZData& data) {
+    return ZDirectorState::write(_path, data);
+  }
+
+  bool read(ZData* data) {
+    return ZDirectorState::read(_path, data);
+  }
+};
+
+TEST_F(ZDirectorStateTest, round_trip) {
+  const ZData data = valid_data();
+  ASSERT_TRUE(write(data));
+
+  ZData loaded;
+  ASSERT_TRUE(read(&loaded));
+  EXPECT_EQ(loaded._max_capacity, data._max_capacity);
+  EXPECT_DOUBLE_EQ(loaded._duration_avg, data._duration_avg);
+  EXPECT_DOUBLE_EQ(loaded._duration_sd, data._duration_sd);
+  EXPECT_DOUBLE_EQ(loaded._alloc_rate_avg, data._alloc_rate_avg);
+  EXPECT_DOUBLE_EQ(loaded._alloc_rate_avg_sd, data._alloc_rate_avg_sd);
+}
+
+TEST_F(ZDirectorStateTest, invalid_values) {
+  ZData data = valid_data();
+  data._duration_avg = NAN;
+  EXPECT_FALSE(write(data));
+
+  data = valid_data();
+  data._duration_sd = INFINITY;
+  EXPECT_FALSE(write(data));
+
+  data = valid_data();
+  data._alloc_rate_avg = -1.0;
+  EXPECT_FALSE(write(data));
+
+  data = valid_data();
+  data._duration_avg = 0.0;
+  EXPECT_FALSE(write(data));
+}
+
+TEST_F(ZDirectorStateTest, invalid_file) {
+  ZData data;
+
+  // Missing file
+  EXPECT_FALSE(read(&data));
+
+  // Floating point values, as written by the first version
+  write_raw("version=1\n"
+            "max_capacity=536870912\n"
+            "duration_avg=0,125000\n"
+            "duration_sd=0,062500\n"
+            "alloc_rate_avg=104857600,000000\n"
+            "alloc_rate_avg_sd=10485760,000000\n");
+  EXPECT_FALSE(read(&data));
+
+  // Truncated
+  write_raw("version=2\n"
+            "max_capacity=536870912\n"
+            "duration_avg_ns=125000000\n");
+  EXPECT_FALSE(read(&data));
+
+  // Negative values
+  write_raw("version=2\n"
+            "max_capacity=536870912\n"
+            "duration_avg_ns=-125000000\n"
+            "duration_sd_ns=62500000\n"
+            "alloc_rate_avg=104857600\n"
+            "alloc_rate_avg_sd=10485760\n");
+  EXPECT_FALSE(read(&data));
+
+  // Zero duration
+  write_raw("version=2\n"
+            "max_capacity=536870912\n"
+            "duration_avg_ns=0\n"
+            "duration_sd_ns=0\n"
+            "alloc_rate_avg=104857600\n"
+            "alloc_rate_avg_sd=10485760\n");
+  EXPECT_FALSE(read(&data));
+}
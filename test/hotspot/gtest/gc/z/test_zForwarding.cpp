@@ -24,6 +24,7 @@
 #include "precompiled.hpp"
 #include "gc/z/zAddress.inline.hpp"
 #include "gc/z/zForwarding.inline.hpp"
+#include "gc/z/zForwardingCompact.inline.hpp"
 #include "gc/z/zGlobals.hpp"
 #include "gc/z/zPage.inline.hpp"
 #include "unittest.hpp"
@@ -141,6 +142,111 @@ public:
     }
   }
 
+  // Looks up an entry using linear probing only, one entry at a time
+  static ZForwardingEntry find_linear(ZForwarding* forwarding, uintptr_t from_index, ZForwardingCursor* cursor) {
+    ZForwardingEntry entry = forwarding->first(from_index, cursor);
+    while (entry.populated()) {
+      if (entry.from_index() == from_index) {
+        return entry;
+      }
+
+      entry = forwarding->next(cursor);
+    }
+
+    return entry;
+  }
+
+  static void verify_find(ZForwarding* forwarding, uintptr_t from_index) {
+    const size_t size = forwarding->_entries.length();
+
+    ZForwardingCursor linear_cursor;
+    const ZForwardingEntry linear_entry = find_linear(forwarding, from_index, &linear_cursor);
+
+    ZForwardingCursor cursor;
+    const ZForwardingEntry entry = forwarding->find(from_index, &cursor);
+    ASSERT_EQ(entry.populated(), linear_entry.populated()) << CAPTURE2(from_index, size);
+    ASSERT_EQ(cursor, linear_cursor) << CAPTURE2(from_index, size);
+
+    if (size >= ZForwardingProbeLength) {
+      ZForwardingCursor probe_cursor;
+      const ZForwardingEntry probe_entry = forwarding->find_probe(from_index, &probe_cursor);
+      ASSERT_EQ(probe_entry.populated(), linear_entry.populated()) << CAPTURE2(from_index, size);
+      ASSERT_EQ(probe_cursor, linear_cursor) << CAPTURE2(from_index, size);
+    }
+
+    if (linear_entry.populated()) {
+      ASSERT_EQ(entry.from_index(), from_index) << CAPTURE(size);
+      ASSERT_EQ(entry.to_offset(), linear_entry.to_offset()) << CAPTURE2(from_index, size);
+    }
+  }
+
+  static void find_probe(ZForwarding* forwarding) {
+    const size_t size = forwarding->_entries.length();
+    const size_t entries_to_populate = size - 1;
+
+    // Populate all but one entry, verifying each lookup and insertion
+    // against linear probing. Spread out from indices make the probe
+    // sequences start at different offsets within groups, and wrap
+    // around the end of the table.
+    for (size_t i = 0; i < entries_to_populate; i++) {
+      const uintptr_t from_index = SequenceToFromIndex::odd(i * 3);
+      verify_find(forwarding, from_index);
+
+      ZForwardingCursor cursor;
+      ASSERT_FALSE(forwarding->find(from_index, &cursor).populated()) << CAPTURE2(from_index, size);
+      forwarding->insert(from_index, i, &cursor);
+      verify_find(forwarding, from_index);
+    }
+
+    // Verify populated and empty from indices
+    for (size_t i = 0; i < entries_to_populate * 2; i++) {
+      verify_find(forwarding, SequenceToFromIndex::odd(i * 3));
+      verify_find(forwarding, SequenceToFromIndex::even(i * 3));
+    }
+  }
+
+  static void claim_and_release(ZForwarding* forwarding) {
+    ZPage* const page = forwarding->page();
+
+    // Retain and release
+    ASSERT_TRUE(forwarding->retain_page());
+    ASSERT_EQ(forwarding->_refcount, 2);
+    forwarding->release_page();
+    ASSERT_EQ(forwarding->_refcount, 1);
+
+    // Claim for in-place relocation
+    ASSERT_EQ(forwarding->claim_page(), page);
+    ASSERT_EQ(forwarding->_refcount, -1);
+
+    // Release in-place relocated page
+    forwarding->set_in_place();
+    forwarding->release_page();
+    ASSERT_EQ(forwarding->_refcount, 0);
+
+    // Page is released but not freed
+    ASSERT_EQ(forwarding->page(), page);
+    ASSERT_FALSE(forwarding->retain_page());
+  }
+
+  static void claim_segments(ZForwarding* forwarding) {
+    // Claim all segments
+    for (size_t i = 0; i < ZLiveMap::nsegments; i++) {
+      size_t segment = 0;
+      ASSERT_TRUE(forwarding->claim_segment(&segment));
+      ASSERT_EQ(segment, i);
+    }
+
+    // No segments left to claim
+    size_t segment = 0;
+    ASSERT_FALSE(forwarding->claim_segment(&segment));
+
+    // Only the last segment completes the page
+    for (size_t i = 0; i < ZLiveMap::nsegments - 1; i++) {
+      ASSERT_FALSE(forwarding->complete_segment());
+    }
+    ASSERT_TRUE(forwarding->complete_segment());
+  }
+
   static void test(void (*function)(ZForwarding*), uint32_t size) {
     // Create page
     const ZVirtualMemory vmem(0, ZPageSizeSmall);
@@ -171,6 +277,78 @@ public:
     ZForwarding::destroy(forwarding);
   }
 
+  static void compact() {
+    // Create page
+    const ZVirtualMemory vmem(0, ZPageSizeSmall);
+    const ZPhysicalMemory pmem(ZPhysicalMemorySegment(0, ZPageSizeSmall));
+    ZPage page(ZPageTypeSmall, vmem, pmem);
+
+    page.reset();
+
+    // Allocate densely packed objects of different sizes
+    const size_t nobjects = 4096;
+    const size_t object_sizes[] = { 16, 24, 32 };
+    uintptr_t objects[nobjects];
+    for (size_t i = 0; i < nobjects; i++) {
+      objects[i] = page.alloc_object(object_sizes[i % 3]);
+    }
+
+    ZGlobalSeqNum++;
+
+    // Mark all objects, including their ends
+    for (size_t i = 0; i < nobjects; i++) {
+      bool dummy = false;
+      page.mark_object(ZAddress::marked(objects[i]), dummy, dummy);
+      page.mark_object_end(objects[i], object_sizes[i % 3]);
+      page.inc_live(1, object_sizes[i % 3]);
+    }
+
+    // Setup forwarding
+    ZForwarding* const forwarding = ZForwarding::create(&page);
+    ASSERT_TRUE(forwarding->is_compact());
+    ZForwardingCompact* const compact = forwarding->compact();
+
+    // Install a block for each segment
+    for (size_t i = 0; i < ZLiveMap::nsegments; i++) {
+      compact->install_block(i, ZPageSizeSmall * (i + 1));
+    }
+
+    // Relocate all objects
+    for (size_t i = 0; i < nobjects; i++) {
+      const uintptr_t from_index = (ZAddress::offset(objects[i]) - page.start()) >> page.object_alignment_shift();
+      ASSERT_FALSE(forwarding->find(from_index).populated());
+      ASSERT_TRUE(compact->claim(from_index));
+      ASSERT_FALSE(compact->claim(from_index));
+      ASSERT_FALSE(compact->is_relocated(from_index));
+      compact->set_relocated(from_index);
+      ASSERT_TRUE(compact->is_relocated(from_index));
+    }
+
+    // Objects in the same segment are relocated contiguously
+    size_t prev_segment = ZLiveMap::nsegments;
+    uintptr_t expected_to_offset = 0;
+    for (size_t i = 0; i < nobjects; i++) {
+      const uintptr_t from_index = (ZAddress::offset(objects[i]) - page.start()) >> page.object_alignment_shift();
+      const size_t segment = compact->segment(from_index);
+      if (segment != prev_segment) {
+        expected_to_offset = compact->block(segment);
+        prev_segment = segment;
+      }
+
+      const ZForwardingEntry entry = forwarding->find(from_index);
+      ASSERT_TRUE(entry.populated()) << CAPTURE(from_index);
+      ASSERT_EQ(entry.from_index(), from_index);
+      ASSERT_EQ(entry.to_offset(), expected_to_offset) << CAPTURE(from_index);
+
+      expected_to_offset += object_sizes[i % 3];
+    }
+
+    ASSERT_EQ(compact->verify(), nobjects);
+
+    // Teardown forwarding
+    ZForwarding::destroy(forwarding);
+  }
+
   // Run the given function with a few different input values.
   static void test(void (*function)(ZForwarding*)) {
     test(function, 1);
@@ -200,3 +378,19 @@ TEST_F(ZForwardingTest, find_full) {
 TEST_F(ZForwardingTest, find_every_other) {
   test(&ZForwardingTest::find_every_other);
 }
+
+TEST_F(ZForwardingTest, find_probe) {
+  test(&ZForwardingTest::find_probe);
+}
+
+TEST_F(ZForwardingTest, claim_and_release) {
+  test(&ZForwardingTest::claim_and_release);
+}
+
+TEST_F(ZForwardingTest, claim_segments) {
+  test(&ZForwardingTest::claim_segments);
+}
+
+TEST_F(ZForwardingTest, compact) {
+  compact();
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zGlobals.hpp"
+#include "gc/z/zGranuleMap.inline.hpp"
+#include "unittest.hpp"
+
+TEST(ZGranuleMapTest, test) {
+  ZGranuleMap<uintptr_t> map(64 * G);
+
+  // Empty map
+  {
+    ZGranuleMapIterator<uintptr_t> iter(&map);
+    uintptr_t value;
+    EXPECT_FALSE(iter.next(&value)) << "Should be empty";
+  }
+
+  const uintptr_t offsets[] = { 0, 3 * G, 3 * G + ZGranuleSize, 64 * G - ZGranuleSize };
+  const size_t noffsets = sizeof(offsets) / sizeof(offsets[0]);
+
+  for (size_t i = 0; i < noffsets; i++) {
+    map.put(offsets[i], offsets[i] + 1);
+  }
+
+  // Lookup
+  for (size_t i = 0; i < noffsets; i++) {
+    EXPECT_EQ(map.get(offsets[i]), offsets[i] + 1) << "Should be equal";
+  }
+  EXPECT_EQ(map.get(32 * G), 0u) << "Should be zero";
+
+  // Iteration visits all values
+  size_t found = 0;
+  ZGranuleMapIterator<uintptr_t> iter(&map);
+  for (uintptr_t value; iter.next(&value);) {
+    if (value != 0) {
+      EXPECT_EQ(value, offsets[found] + 1) << "Should be equal";
+      found++;
+    }
+  }
+  EXPECT_EQ(found, noffsets) << "Should be equal";
+}
@@ -23,8 +23,32 @@
 
 #include "precompiled.hpp"
 #include "gc/z/zLiveMap.inline.hpp"
+#include "memory/iterator.hpp"
 #include "unittest.hpp"
 
+class ZLiveMapTestClosure : public ObjectClosure {
+private:
+  uintptr_t _addrs[16];
+  size_t    _naddrs;
+
+public:
+  ZLiveMapTestClosure() :
+      _naddrs(0) {}
+
+  virtual void do_object(oop obj) {
+    ASSERT_LT(_naddrs, ARRAY_SIZE(_addrs));
+    _addrs[_naddrs++] = ZOop::to_address(obj);
+  }
+
+  size_t naddrs() const {
+    return _naddrs;
+  }
+
+  uintptr_t addr(size_t i) const {
+    return _addrs[i];
+  }
+};
+
 class ZLiveMapTest : public ::testing::Test {
 protected:
   static void strongly_live_for_large_zpage() {
@@ -48,8 +72,109 @@ protected:
 
     ASSERT_TRUE(inc_live);
   }
+
+  static void object_ends() {
+    ZLiveMap livemap(1024);
+
+    bool inc_live;
+
+    // Mark a two unit object, and an object spanning several segments.
+    livemap.set(0, false /* finalizable */, inc_live);
+    livemap.set_end(0, 3);
+    livemap.set(20, true /* finalizable */, inc_live);
+    livemap.set_end(20, 20 + 600 * 2 - 1);
+
+    // Check that the objects span the expected number of segments.
+    ASSERT_EQ(livemap.index_to_segment(0), livemap.index_to_segment(3));
+    ASSERT_NE(livemap.index_to_segment(20), livemap.index_to_segment(20 + 600 * 2 - 1));
+
+    // Check that the object sizes are found from the object ends.
+    ASSERT_EQ(livemap.object_size(0, 3), (size_t)2 * 8);
+    ASSERT_EQ(livemap.object_size(20, 3), (size_t)600 * 8);
+
+    // Check that the object ends are not mistaken for objects.
+    ASSERT_FALSE(livemap.get(2));
+    ASSERT_TRUE(livemap.get(20));
+  }
+
+  static void iterate() {
+    ZLiveMap livemap(1024);
+
+    bool inc_live;
+    const uintptr_t page_start = 1 * M;
+
+    // Mark objects in the first and last word of a segment, an object
+    // spanning several segments, and objects in adjacent words.
+    livemap.set(0, false /* finalizable */, inc_live);
+    livemap.set_end(0, 3);
+    livemap.set(4, true /* finalizable */, inc_live);
+    livemap.set(30, false /* finalizable */, inc_live);
+    livemap.set_end(30, 30 + 600 * 2 - 1);
+    livemap.set(1240, false /* finalizable */, inc_live);
+    livemap.set(1302, true /* finalizable */, inc_live);
+    livemap.set(2046, false /* finalizable */, inc_live);
+
+    ZLiveMapTestClosure cl;
+    livemap.iterate(&cl, page_start, 3);
+
+    // Check that all objects, and only those, are visited in order
+    const size_t expected[] = { 0, 4, 30, 1240, 1302, 2046 };
+    ASSERT_EQ(cl.naddrs(), ARRAY_SIZE(expected));
+    for (size_t i = 0; i < ARRAY_SIZE(expected); i++) {
+      ASSERT_EQ(cl.addr(i), page_start + ((expected[i] / 2) << 3));
+    }
+  }
+
+  static void iterate_small_segments() {
+    // Large ZPages have segments smaller than a bitmap word
+    ZLiveMap livemap(1);
+
+    bool inc_live;
+    livemap.set(0, false /* finalizable */, inc_live);
+
+    ZLiveMapTestClosure cl;
+    livemap.iterate(&cl, 1 * M, 21);
+
+    ASSERT_EQ(cl.naddrs(), 1u);
+    ASSERT_EQ(cl.addr(0), 1 * M);
+  }
+
+  static void lazy_bitmap() {
+    ZLiveMap livemap(1024);
+
+    // Check that the bitmap is allocated when first marked.
+    ASSERT_FALSE(livemap._bitmap.is_attached());
+    ASSERT_FALSE(livemap.get(0));
+    ASSERT_FALSE(livemap._bitmap.is_attached());
+
+    bool inc_live;
+    livemap.set(0, false /* finalizable */, inc_live);
+    ASSERT_TRUE(livemap._bitmap.is_attached());
+    ASSERT_TRUE(livemap.get(0));
+
+    // Check that a released live map is not marked.
+    livemap.release();
+    ASSERT_FALSE(livemap._bitmap.is_attached());
+    ASSERT_FALSE(livemap.get(0));
+  }
 };
 
 TEST_F(ZLiveMapTest, strongly_live_for_large_zpage) {
   strongly_live_for_large_zpage();
 }
+
+TEST_F(ZLiveMapTest, object_ends) {
+  object_ends();
+}
+
+TEST_F(ZLiveMapTest, iterate) {
+  iterate();
+}
+
+TEST_F(ZLiveMapTest, iterate_small_segments) {
+  iterate_small_segments();
+}
+
+TEST_F(ZLiveMapTest, lazy_bitmap) {
+  lazy_bitmap();
+}
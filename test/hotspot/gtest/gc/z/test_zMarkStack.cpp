@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zMarkStack.inline.hpp"
+#include "unittest.hpp"
+
+class ZMarkStackTest : public ::testing::Test {
+protected:
+  static void test_partial_array(uintptr_t compact_offset_limit, size_t offset) {
+    const uintptr_t saved_compact_offset_limit = ZMarkStackCompactOffsetLimit;
+    ZMarkStackCompactOffsetLimit = compact_offset_limit;
+
+    ZMarkStack* const stack = ::new (AllocateHeap(sizeof(ZMarkStack), mtTest)) ZMarkStack();
+    const size_t length = 17;
+    const size_t low_offset = 1;
+    const size_t low_length = 3;
+    ASSERT_TRUE(stack->push(ZMarkStackEntry(offset, length, true /* finalizable */)));
+    ASSERT_TRUE(stack->push(ZMarkStackEntry(low_offset, low_length, false /* finalizable */)));
+
+    ZMarkStackEntry entry;
+    ASSERT_TRUE(stack->pop(entry));
+    EXPECT_TRUE(entry.partial_array());
+    EXPECT_EQ(entry.partial_array_offset(), low_offset);
+    EXPECT_EQ(entry.partial_array_length(), low_length);
+    EXPECT_FALSE(entry.finalizable());
+
+    ASSERT_TRUE(stack->pop(entry));
+    EXPECT_TRUE(entry.partial_array());
+    EXPECT_EQ(entry.partial_array_offset(), offset);
+    EXPECT_EQ(entry.partial_array_length(), length);
+    EXPECT_TRUE(entry.finalizable());
+
+    EXPECT_TRUE(stack->is_empty());
+    EXPECT_FALSE(stack->pop(entry));
+
+    FreeHeap(stack);
+    ZMarkStackCompactOffsetLimit = saved_compact_offset_limit;
+  }
+};
+
+TEST_F(ZMarkStackTest, partial_array) {
+  // Offsets of partial arrays in heaps with 44 or more address offset
+  // bits have the top bit of the partial array offset field set
+  const size_t high_offset = ((size_t)1 << 31) | 5;
+
+  // Full entries only
+  test_partial_array(0 /* compact_offset_limit */, 5);
+  test_partial_array(0 /* compact_offset_limit */, high_offset);
+
+  // Compact entries, only used when all partial array offsets are low
+  test_partial_array(ZMarkStackCompactOffsetMax, 5);
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zGlobals.hpp"
+#include "gc/z/zPage.inline.hpp"
+#include "gc/z/zPageCache.hpp"
+#include "unittest.hpp"
+
+class ZPageCacheMergeTest : public ::testing::Test {
+protected:
+  static ZPage* create_page(uintptr_t start, uintptr_t physical_start, size_t size) {
+    const ZVirtualMemory vmem(start, size);
+    const ZPhysicalMemory pmem(ZPhysicalMemorySegment(physical_start, size));
+    ZPage* const page = new ZPage(ZPageTypeLarge, vmem, pmem);
+    page->set_pre_mapped();
+    return page;
+  }
+
+  static void collect(ZPageCacheMerge* merge, size_t size, ZPage** pages, size_t npages) {
+    merge->collect(size);
+    for (size_t i = 0; i < npages; i++) {
+      merge->add(pages[i]);
+    }
+  }
+
+  static void destroy(ZPage** pages, size_t npages) {
+    for (size_t i = 0; i < npages; i++) {
+      delete pages[i];
+    }
+  }
+
+  static bool contains(const ZPageCacheMerge* merge, const ZPage* page) {
+    return merge->contains(page);
+  }
+};
+
+TEST_F(ZPageCacheMergeTest, search) {
+  const size_t size = ZGranuleSize * 2;
+
+  // Collected out of address order, as from the cache lists. The two
+  // lowest pages form a run, and the highest page is not adjacent.
+  ZPage* pages[] = {
+    create_page(size * 3, size * 2, size),
+    create_page(size * 1, size * 1, size),
+    create_page(size * 0, size * 0, size)
+  };
+
+  ZPageCacheMerge merge;
+  EXPECT_FALSE(merge.is_collected());
+  collect(&merge, size * 2, pages, 3);
+  EXPECT_TRUE(merge.is_pending());
+
+  merge.search();
+  EXPECT_FALSE(merge.is_pending());
+  EXPECT_EQ(merge.run_length(), 2u);
+  EXPECT_EQ(merge.run_size(), size * 2);
+  EXPECT_TRUE(contains(&merge, pages[1]));
+  EXPECT_TRUE(contains(&merge, pages[2]));
+  EXPECT_FALSE(contains(&merge, pages[0]));
+
+  destroy(pages, 3);
+}
+
+TEST_F(ZPageCacheMergeTest, search_too_small) {
+  const size_t size = ZGranuleSize * 2;
+
+  ZPage* pages[] = {
+    create_page(size * 0, size * 0, size),
+    create_page(size * 1, size * 1, size)
+  };
+
+  // The run is smaller than requested
+  ZPageCacheMerge merge;
+  collect(&merge, size * 3, pages, 2);
+  merge.search();
+  EXPECT_EQ(merge.run_length(), 0u);
+  EXPECT_FALSE(contains(&merge, pages[0]));
+
+  destroy(pages, 2);
+}
+
+TEST_F(ZPageCacheMergeTest, search_physical_order) {
+  const size_t size = ZGranuleSize * 2;
+
+  // Adjacent in virtual memory, but the physical memory is out of order
+  ZPage* pages[] = {
+    create_page(size * 0, size * 1, size),
+    create_page(size * 1, size * 0, size)
+  };
+
+  ZPageCacheMerge merge;
+  collect(&merge, size * 2, pages, 2);
+  merge.search();
+  EXPECT_EQ(merge.run_length(), 0u);
+
+  destroy(pages, 2);
+}
+
+TEST_F(ZPageCacheMergeTest, contains_changed_page) {
+  const size_t size = ZGranuleSize * 2;
+
+  ZPage* pages[] = {
+    create_page(size * 0, size * 0, size),
+    create_page(size * 1, size * 1, size)
+  };
+
+  ZPageCacheMerge merge;
+  collect(&merge, size * 2, pages, 2);
+  merge.search();
+  ASSERT_EQ(merge.run_length(), 2u);
+
+  // A different page with the same address range, as when the page
+  // has left the cache and another page has been cached in its place
+  ZPage* const other = create_page(size * 1, size * 1, size);
+  EXPECT_FALSE(contains(&merge, other));
+  EXPECT_TRUE(contains(&merge, pages[1]));
+
+  delete other;
+  destroy(pages, 2);
+}
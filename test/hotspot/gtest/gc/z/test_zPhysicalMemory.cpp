@@ -113,6 +113,40 @@ TEST(ZPhysicalMemoryTest, segments) {
   EXPECT_EQ(pmem4.is_null(), false);
 }
 
+TEST(ZPhysicalMemoryTest, segments_out_of_order) {
+  const ZPhysicalMemorySegment seg0(0, 1);
+  const ZPhysicalMemorySegment seg1(1, 1);
+  const ZPhysicalMemorySegment seg2(2, 1);
+  const ZPhysicalMemorySegment seg4(4, 1);
+  const ZPhysicalMemorySegment seg6(6, 1);
+
+  ZPhysicalMemory pmem0;
+  pmem0.add_segment(seg6);
+  pmem0.add_segment(seg2);
+  pmem0.add_segment(seg0);
+  EXPECT_EQ(pmem0.nsegments(), 3u);
+  EXPECT_EQ(pmem0.segment(0).start(), 0u);
+  EXPECT_EQ(pmem0.segment(1).start(), 2u);
+  EXPECT_EQ(pmem0.segment(2).start(), 6u);
+
+  // Merge with previous and next segment
+  pmem0.add_segment(seg1);
+  EXPECT_EQ(pmem0.nsegments(), 2u);
+  EXPECT_EQ(pmem0.segment(0).start(), 0u);
+  EXPECT_EQ(pmem0.segment(0).size(), 3u);
+  EXPECT_EQ(pmem0.segment(1).start(), 6u);
+
+  ZPhysicalMemory pmem1;
+  pmem1.add_segment(seg4);
+  pmem1.add_segment(ZPhysicalMemorySegment(3, 1));
+  pmem1.add_segment(seg0);
+  EXPECT_EQ(pmem1.nsegments(), 2u);
+  EXPECT_EQ(pmem1.segment(0).start(), 0u);
+  EXPECT_EQ(pmem1.segment(1).start(), 3u);
+  EXPECT_EQ(pmem1.segment(1).size(), 2u);
+  EXPECT_EQ(pmem1.size(), 3u);
+}
+
 TEST(ZPhysicalMemoryTest, split) {
   ZPhysicalMemory pmem;
 
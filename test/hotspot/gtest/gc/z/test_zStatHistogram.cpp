@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zStat.hpp"
+#include "unittest.hpp"
+
+TEST(ZStatHistogramBucketsTest, test_index) {
+  // Small values have exact buckets
+  for (uint64_t value = 0; value < 8; value++) {
+    EXPECT_EQ(ZStatHistogramBuckets::index(value), value) << "Should be exact";
+    EXPECT_EQ(ZStatHistogramBuckets::upper(value), value) << "Should be exact";
+  }
+
+  // Every value falls within the bounds of its bucket
+  for (uint64_t value = 1; value < 10000000; value = value * 3 / 2 + 1) {
+    const size_t index = ZStatHistogramBuckets::index(value);
+    EXPECT_GE(ZStatHistogramBuckets::upper(index), value) << "Should be within bucket";
+    EXPECT_LT(ZStatHistogramBuckets::upper(index - 1), value) << "Should be within bucket";
+  }
+
+  // Large values are clamped to the last bucket
+  EXPECT_EQ(ZStatHistogramBuckets::index(~(uint64_t)0), ZStatHistogramBuckets::count - 1) << "Should be clamped";
+}
+
+TEST(ZStatHistogramBucketsTest, test_percentile) {
+  uint64_t buckets[ZStatHistogramBuckets::count] = {};
+  uint64_t nsamples = 0;
+  uint64_t max = 0;
+
+  // 99 samples of 2, and one sample of 1000
+  buckets[ZStatHistogramBuckets::index(2)] = 99;
+  buckets[ZStatHistogramBuckets::index(1000)] = 1;
+  nsamples = 100;
+  max = 1000;
+
+  EXPECT_EQ(ZStatHistogramBuckets::percentile(buckets, nsamples, max, 50.0), 2u);
+  EXPECT_EQ(ZStatHistogramBuckets::percentile(buckets, nsamples, max, 99.0), 2u);
+  EXPECT_EQ(ZStatHistogramBuckets::percentile(buckets, nsamples, max, 99.9), 1000u);
+  EXPECT_EQ(ZStatHistogramBuckets::percentile(buckets, 0, 0, 99.9), 0u);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/z/zTaskRange.inline.hpp"
+#include "gc/z/zWorkers.hpp"
+#include "unittest.hpp"
+
+class ZTaskRangeTest : public ::testing::Test {
+protected:
+  static void test(size_t size, size_t chunk_size, uint nthreads) {
+    nthreads = MIN2(nthreads, ZWorkers::nworkers_max());
+
+    ZTaskRange range(size, chunk_size);
+    bool* const claimed = NEW_C_HEAP_ARRAY(bool, size, mtTest);
+    for (size_t i = 0; i < size; i++) {
+      claimed[i] = false;
+    }
+
+    // Claim chunks round robin, interleaving workers with a thread
+    // that is not a worker, so that both blocks and steals are used
+    size_t nclaimed = 0;
+    bool done = false;
+    for (uint turn = 0; !done; turn++) {
+      const uint thread = turn % (nthreads + 1);
+      const uint worker_id = (thread == nthreads) ? ZTaskRange::no_worker : thread;
+
+      size_t start;
+      size_t end;
+      if (!range.next(worker_id, &start, &end)) {
+        done = true;
+        continue;
+      }
+
+      ASSERT_LT(start, end);
+      ASSERT_LE(end, size);
+      ASSERT_LE(end - start, chunk_size);
+
+      for (size_t i = start; i < end; i++) {
+        ASSERT_FALSE(claimed[i]) << "Index claimed twice: " << i;
+        claimed[i] = true;
+        nclaimed++;
+      }
+    }
+
+    // All indices claimed exactly once
+    EXPECT_EQ(nclaimed, size);
+    EXPECT_TRUE(range.is_claimed());
+
+    FREE_C_HEAP_ARRAY(bool, claimed);
+  }
+};
+
+TEST_VM_F(ZTaskRangeTest, test_claim) {
+  test(0, 1, 1);
+  test(1, 1, 1);
+  test(100, 1, 1);
+  test(100, 7, 2);
+  test(1000, 16, 3);
+  test(12345, 32, 2);
+}
@@ -224,3 +224,44 @@ TEST(LogDecorations, identifiers) {
     EXPECT_EQ(ids[i].expected, strtol(reported, NULL, 10));
   }
 }
+
+// Test that a copy has its own decorations, as needed by the
+// asynchronous log writer, which outlives the original
+TEST_VM(LogDecorations, copy) {
+  LogDecorators decorator_selection;
+  ASSERT_TRUE(decorator_selection.parse("uptime,time,level,tags,pid,tid"));
+
+  void* const mem = os::malloc(sizeof(LogDecorations), mtLogging);
+  LogDecorations* const original = ::new (mem) LogDecorations(LogLevel::Info, tagset, decorator_selection);
+  const LogDecorations copy(*original);
+
+  char expected[LogDecorators::Count][LogDecorations::DecorationsBufferSize];
+  for (uint i = 0; i < LogDecorators::Count; i++) {
+    const LogDecorators::Decorator decorator = static_cast<LogDecorators::Decorator>(i);
+    const char* const decoration = original->decoration(decorator);
+    if (decoration == NULL) {
+      EXPECT_TRUE(copy.decoration(decorator) == NULL) << "Decoration " << i << " should not be set";
+      expected[i][0] = '\0';
+      continue;
+    }
+
+    ASSERT_TRUE(copy.decoration(decorator) != NULL) << "Decoration " << i << " should be set";
+    EXPECT_STREQ(decoration, copy.decoration(decorator));
+    if (decorator != LogDecorators::level_decorator) {
+      EXPECT_NE(decoration, copy.decoration(decorator)) << "Decoration " << i << " should be copied";
+    }
+    strncpy(expected[i], decoration, sizeof(expected[i]) - 1);
+    expected[i][sizeof(expected[i]) - 1] = '\0';
+  }
+
+  // Overwrite and free the original
+  memset(mem, 'X', sizeof(LogDecorations));
+  os::free(mem);
+
+  for (uint i = 0; i < LogDecorators::Count; i++) {
+    const LogDecorators::Decorator decorator = static_cast<LogDecorators::Decorator>(i);
+    if (expected[i][0] != '\0') {
+      EXPECT_STREQ(expected[i], copy.decoration(decorator)) << "Decoration " << i << " changed with the original";
+    }
+  }
+}
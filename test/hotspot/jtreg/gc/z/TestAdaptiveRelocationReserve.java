@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.z;
+
+/*
+ * @test TestAdaptiveRelocationReserve
+ * @requires vm.gc.Z & !vm.graal.enabled
+ * @summary Relocate fragmented pages with a reserve sized from the relocation set
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -XX:+ZAdaptiveRelocationReserve -Xmx256M -Xlog:gc,gc+reloc=debug gc.z.TestAdaptiveRelocationReserve
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -XX:+ZAdaptiveRelocationReserve -XX:ConcGCThreads=1 -Xmx256M -Xlog:gc,gc+reloc=debug gc.z.TestAdaptiveRelocationReserve
+ */
+
+import java.util.ArrayList;
+
+//
+// Fills most of the heap with small and medium objects, drops every
+// other object to fragment the pages, and collects repeatedly, so that
+// each cycle relocates a large relocation set with the reserve sized by
+// ZAdaptiveRelocationReserve. The surviving objects must be intact, and
+// no allocation may fail with an OutOfMemoryError.
+//
+public class TestAdaptiveRelocationReserve {
+    private static final int SMALL_SIZE = 1024;
+    private static final int MEDIUM_SIZE = 512 * 1024;
+    private static final long LIVE_SIZE = 160 * 1024 * 1024;
+    private static final int CYCLES = 5;
+
+    private static void fill(ArrayList<byte[]> objects) {
+        for (long size = 0; size < LIVE_SIZE; ) {
+            final int length = (objects.size() % 64 == 0) ? MEDIUM_SIZE : SMALL_SIZE;
+            final byte[] object = new byte[length];
+            object[0] = (byte)objects.size();
+            object[length - 1] = (byte)objects.size();
+            objects.add(object);
+            size += length;
+        }
+    }
+
+    private static void fragment(ArrayList<byte[]> objects) {
+        for (int i = 0; i < objects.size(); i += 2) {
+            objects.set(i, null);
+        }
+    }
+
+    private static void verify(ArrayList<byte[]> objects) {
+        for (int i = 0; i < objects.size(); i++) {
+            final byte[] object = objects.get(i);
+            if (object != null && (object[0] != (byte)i || object[object.length - 1] != (byte)i)) {
+                throw new RuntimeException("Object " + i + " corrupted");
+            }
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        for (int cycle = 0; cycle < CYCLES; cycle++) {
+            final ArrayList<byte[]> objects = new ArrayList<>();
+            fill(objects);
+            fragment(objects);
+
+            System.gc();
+            verify(objects);
+            System.gc();
+            verify(objects);
+
+            System.out.println("Cycle " + cycle + ": " + objects.size() + " objects verified");
+        }
+    }
+}
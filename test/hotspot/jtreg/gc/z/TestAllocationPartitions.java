@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.z;
+
+/*
+ * @test TestAllocationPartitions
+ * @requires vm.gc.Z & !vm.graal.enabled
+ * @summary Allocations of a partition over its soft max capacity should not fail while the heap has memory available
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx256M -XX:SoftMaxHeapSize=64M -XX:ZAllocationPartitions=tenant-a-:16M -Xlog:gc,gc+heap gc.z.TestAllocationPartitions
+ */
+
+import java.util.ArrayList;
+
+//
+// Keeps more live objects in a limited partition than its soft max
+// capacity, and than the heap soft max capacity, but well below the max
+// heap size. The allocations of the partition stall at its soft max, but
+// once a GC cycle has completed they must continue beyond it, instead of
+// failing with an OutOfMemoryError.
+//
+public class TestAllocationPartitions {
+    private static final int OBJECT_SIZE = 64 * 1024;
+    private static final long LIVE_SIZE = 96 * 1024 * 1024;
+
+    private static volatile Throwable failure;
+
+    private static void allocate() {
+        final ArrayList<byte[]> live = new ArrayList<>();
+        for (long size = 0; size < LIVE_SIZE; size += OBJECT_SIZE) {
+            live.add(new byte[OBJECT_SIZE]);
+        }
+
+        System.out.println(Thread.currentThread().getName() + ": " + live.size() + " objects live");
+    }
+
+    public static void main(String[] args) throws Exception {
+        final Thread thread = new Thread(() -> {
+            try {
+                allocate();
+            } catch (Throwable t) {
+                failure = t;
+            }
+        }, "tenant-a-0");
+
+        thread.start();
+        thread.join();
+
+        if (failure != null) {
+            throw new RuntimeException("Allocation in partition failed", failure);
+        }
+    }
+}
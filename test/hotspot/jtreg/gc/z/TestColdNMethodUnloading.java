@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.z;
+
+/*
+ * @test TestColdNMethodUnloading
+ * @requires vm.gc.Z & !vm.graal.enabled & vm.compiler2.enabled
+ * @summary Test that nmethods not called for ZNMethodColdCycles GC cycles are unloaded
+ * @library /test/lib
+ * @build sun.hotspot.WhiteBox
+ * @run driver ClassFileInstaller sun.hotspot.WhiteBox
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -XX:ZNMethodColdCycles=2 -XX:-BackgroundCompilation -XX:-UseCounterDecay -XX:CompileCommand=dontinline,gc.z.TestColdNMethodUnloading::hot -Xlog:gc,gc+nmethod=debug gc.z.TestColdNMethodUnloading
+ */
+
+import java.lang.reflect.Method;
+import sun.hotspot.WhiteBox;
+
+//
+// Compiles two methods, and then keeps calling one of them from another
+// thread while GC cycles run, and leaves the other one alone. The called
+// method must stay compiled, while the cold method must be unloaded once
+// it has not been called for ZNMethodColdCycles GC cycles, but not before.
+//
+public class TestColdNMethodUnloading {
+    private static final WhiteBox WB = WhiteBox.getWhiteBox();
+    private static final int COMP_LEVEL_FULL_OPTIMIZATION = 4;
+    private static final int COLD_CYCLES = 2;
+
+    private static volatile int sink;
+    private static volatile boolean done;
+
+    public static int hot(int value) {
+        return value * 31 + 7;
+    }
+
+    public static int cold(int value) {
+        return value * 17 + 3;
+    }
+
+    private static void compile(Method method) {
+        if (!WB.enqueueMethodForCompilation(method, COMP_LEVEL_FULL_OPTIMIZATION)) {
+            throw new RuntimeException("Failed to enqueue " + method.getName());
+        }
+
+        if (!WB.isMethodCompiled(method)) {
+            throw new RuntimeException(method.getName() + " not compiled");
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        final Method hot = TestColdNMethodUnloading.class.getMethod("hot", int.class);
+        final Method cold = TestColdNMethodUnloading.class.getMethod("cold", int.class);
+
+        compile(hot);
+        compile(cold);
+
+        final Thread caller = new Thread(() -> {
+            while (!done) {
+                sink = hot(sink);
+            }
+        });
+        caller.start();
+
+        for (int cycle = 1; cycle <= COLD_CYCLES + 1; cycle++) {
+            WB.fullGC();
+
+            System.out.println("Cycle " + cycle + ": hot " + WB.isMethodCompiled(hot) + ", cold " + WB.isMethodCompiled(cold));
+
+            if (!WB.isMethodCompiled(hot)) {
+                throw new RuntimeException("Hot method unloaded after " + cycle + " cycles");
+            }
+
+            if (cycle < COLD_CYCLES && !WB.isMethodCompiled(cold)) {
+                throw new RuntimeException("Cold method unloaded after only " + cycle + " cycles");
+            }
+        }
+
+        done = true;
+        caller.join();
+
+        if (WB.isMethodCompiled(cold)) {
+            throw new RuntimeException("Cold method not unloaded after " + (COLD_CYCLES + 1) + " cycles");
+        }
+    }
+}
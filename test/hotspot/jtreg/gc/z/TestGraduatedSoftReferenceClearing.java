@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.z;
+
+/*
+ * @test TestGraduatedSoftReferenceClearing
+ * @requires vm.gc.Z & !vm.graal.enabled
+ * @summary Stalled allocations should not fail while softly reachable objects can be cleared
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -XX:+ZGraduatedSoftReferenceClearing -Xmx128M -Xlog:gc,gc+ref gc.z.TestGraduatedSoftReferenceClearing
+ */
+
+import java.lang.ref.SoftReference;
+import java.util.ArrayList;
+
+//
+// Fills most of the heap with softly reachable objects, which are
+// recently used and therefore kept by the forecast soft reference
+// policy, and then allocates more strongly reachable objects than fit
+// next to them. The allocations stall, and the first stall cycle uses
+// the forecast policy, but all SoftReferences must be cleared before a
+// stalled allocation fails with an OutOfMemoryError.
+//
+public class TestGraduatedSoftReferenceClearing {
+    private static final int OBJECT_SIZE = 64 * 1024;
+    private static final long SOFT_SIZE = 96 * 1024 * 1024;
+    private static final long STRONG_SIZE = 64 * 1024 * 1024;
+
+    private static ArrayList<SoftReference<byte[]>> soft = new ArrayList<>();
+    private static ArrayList<byte[]> strong = new ArrayList<>();
+
+    public static void main(String[] args) throws Exception {
+        for (long size = 0; size < SOFT_SIZE; size += OBJECT_SIZE) {
+            soft.add(new SoftReference<>(new byte[OBJECT_SIZE]));
+        }
+
+        for (long size = 0; size < STRONG_SIZE; size += OBJECT_SIZE) {
+            strong.add(new byte[OBJECT_SIZE]);
+        }
+
+        long cleared = 0;
+        for (SoftReference<byte[]> ref : soft) {
+            if (ref.get() == null) {
+                cleared++;
+            }
+        }
+
+        System.out.println(strong.size() + " objects allocated, " + cleared + " of " + soft.size() + " SoftReferences cleared");
+
+        if (cleared == 0) {
+            throw new RuntimeException("No SoftReferences cleared");
+        }
+    }
+}
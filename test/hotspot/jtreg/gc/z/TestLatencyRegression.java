@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.z;
+
+/*
+ * @test TestLatencyRegression
+ * @requires vm.gc.Z & !vm.graal.enabled
+ * @requires vm.debug == false
+ * @summary Check pause time, MMU and allocation stall bounds for calibrated allocation workloads
+ * @library /test/lib
+ * @build sun.hotspot.WhiteBox
+ * @run driver ClassFileInstaller sun.hotspot.WhiteBox
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx512M -Xlog:gc gc.z.TestLatencyRegression 64 100 10 10 50 100
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx512M -Xlog:gc gc.z.TestLatencyRegression 256 200 10 10 50 100
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx512M -Xlog:gc gc.z.TestLatencyRegression 64 400 10 10 50 100
+ */
+
+import java.util.Random;
+import sun.hotspot.WhiteBox;
+
+//
+// Runs an allocation workload with a fixed live set and a fixed
+// allocation rate, and fails if the p99 pause time, the minimum mutator
+// utilization over 10ms time slices, or the total allocation stall time,
+// as recorded by ZStatLatency and ZStatMMU, are outside the given bounds.
+// The bounds are chosen to be well within what ZGC achieves on any
+// supported machine, so that a failure points to a regression in, for
+// example, barriers, root processing or page allocation, rather than to
+// a slow or busy test machine. Debug builds do much more work in pauses,
+// such as verification, and are not held to these bounds.
+//
+// Arguments:
+//   live      - live set size in megabytes
+//   rate      - allocation rate in megabytes per second
+//   seconds   - duration of the workload
+//   p99       - maximum p99 pause time in milliseconds
+//   mmu       - minimum MMU over 10ms time slices, in percent
+//   stall     - maximum total allocation stall time in milliseconds
+//
+// The stall bound is a tolerance rather than zero. A busy test machine
+// can delay a GC cycle enough for a few short stalls, which is not a
+// regression, while running out of memory fails the test regardless.
+//
+public class TestLatencyRegression {
+    private static final WhiteBox WB = WhiteBox.getWhiteBox();
+
+    private static final int OBJECT_SIZE = 1024;
+    private static final int BATCH_SIZE = 1024 * 1024;
+    private static final long SEED = 4711;
+
+    private static Object[] live;
+    private static volatile Object sink;
+
+    private static void allocate(int liveMB, int rateMB, int seconds) throws InterruptedException {
+        final Random random = new Random(SEED);
+        live = new Object[liveMB * 1024 * 1024 / OBJECT_SIZE];
+        for (int i = 0; i < live.length; i++) {
+            live[i] = new byte[OBJECT_SIZE];
+        }
+
+        // Allocate in batches of 1M, replacing a random part of the live
+        // set each batch, and sleep between batches to keep the rate
+        final long batchesPerSecond = rateMB;
+        final long nanosPerBatch = 1_000_000_000L / batchesPerSecond;
+        final long nbatches = batchesPerSecond * seconds;
+        final long start = System.nanoTime();
+        for (long batch = 0; batch < nbatches; batch++) {
+            for (int allocated = 0; allocated < BATCH_SIZE; allocated += OBJECT_SIZE) {
+                final byte[] object = new byte[OBJECT_SIZE];
+                if (random.nextInt(16) == 0) {
+                    live[random.nextInt(live.length)] = object;
+                } else {
+                    sink = object;
+                }
+            }
+
+            final long ahead = start + (batch + 1) * nanosPerBatch - System.nanoTime();
+            if (ahead > 0) {
+                Thread.sleep(ahead / 1_000_000, (int)(ahead % 1_000_000));
+            }
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length != 6) {
+            throw new IllegalArgumentException("Usage: TestLatencyRegression <live> <rate> <seconds> <p99> <mmu> <stall>");
+        }
+
+        final int liveMB = Integer.parseInt(args[0]);
+        final int rateMB = Integer.parseInt(args[1]);
+        final int seconds = Integer.parseInt(args[2]);
+        final double maxP99Millis = Double.parseDouble(args[3]);
+        final double minMMU10ms = Double.parseDouble(args[4]);
+        final double maxStallMillis = Double.parseDouble(args[5]);
+
+        allocate(liveMB, rateMB, seconds);
+
+        final long npauses = WB.zPauseCount();
+        final double p99Millis = WB.zPausePercentile(99.0) / 1_000_000.0;
+        final double mmu10ms = WB.zMinimumMutatorUtilization(10);
+        final long nstalls = WB.zAllocationStallCount();
+        final double stallMillis = WB.zAllocationStallTime() / 1_000_000.0;
+
+        System.out.println("Pauses: " + npauses + ", p99: " + p99Millis + "ms");
+        System.out.println("MMU 10ms: " + mmu10ms + "%");
+        System.out.println("Allocation Stalls: " + nstalls + ", total: " + stallMillis + "ms");
+
+        if (npauses == 0) {
+            throw new RuntimeException("No GC cycles were run, the workload is not calibrated");
+        }
+
+        if (p99Millis > maxP99Millis) {
+            throw new RuntimeException("p99 pause time " + p99Millis + "ms exceeds " + maxP99Millis + "ms");
+        }
+
+        if (mmu10ms < minMMU10ms) {
+            throw new RuntimeException("MMU 10ms " + mmu10ms + "% below " + minMMU10ms + "%");
+        }
+
+        if (stallMillis > maxStallMillis) {
+            throw new RuntimeException("Allocation stall time " + stallMillis + "ms exceeds " + maxStallMillis + "ms");
+        }
+    }
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.z;
+
+/*
+ * @test TestMarkBenchmark
+ * @requires vm.gc.Z & !vm.graal.enabled
+ * @summary Mark synthetic heaps of different shapes
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx256M -XX:ConcGCThreads=2 -XX:-UseDynamicNumberOfGCThreads -Xlog:gc+marking gc.z.TestMarkBenchmark tree 100000 2
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx256M -XX:ConcGCThreads=2 -XX:-UseDynamicNumberOfGCThreads -Xlog:gc+marking gc.z.TestMarkBenchmark list 100000 2
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx256M -XX:ConcGCThreads=2 -XX:-UseDynamicNumberOfGCThreads -Xlog:gc+marking gc.z.TestMarkBenchmark array 100000 2
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx256M -XX:ConcGCThreads=2 -XX:-UseDynamicNumberOfGCThreads -Xlog:gc+marking gc.z.TestMarkBenchmark graph 100000 2
+ */
+
+import java.util.Random;
+
+//
+// Builds a synthetic heap with a controlled shape and runs a number of GC
+// cycles over it. The mark statistics, including mark throughput, steals,
+// partial array pushes and termination overhead, are printed per cycle
+// with -Xlog:gc+marking. To benchmark, run with a larger number of nodes
+// and cycles, and with an exact number of workers, for example:
+//
+//   java -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx16G
+//        -XX:ConcGCThreads=8 -XX:-UseDynamicNumberOfGCThreads
+//        -Xlog:gc+marking gc.z.TestMarkBenchmark graph 50000000 10
+//
+// Shapes:
+//   tree  - wide tree, where each node has 16 children
+//   list  - single long linked list
+//   array - one large Object[] referencing all nodes
+//   graph - random graph, with 4 edges per node
+//
+public class TestMarkBenchmark {
+    private static final int TREE_FANOUT = 16;
+    private static final int GRAPH_EDGES_PER_NODE = 4;
+    private static final long SEED = 4711;
+
+    static class Node {
+        Object[] edges;
+        Node next;
+        long payload;
+    }
+
+    private static Object root;
+
+    private static Object buildTree(int nnodes) {
+        // Breadth first, so that each level is fully populated
+        final Node[] nodes = new Node[nnodes];
+        for (int i = 0; i < nnodes; i++) {
+            nodes[i] = new Node();
+        }
+        for (int i = 0; i < nnodes; i++) {
+            final int first = i * TREE_FANOUT + 1;
+            if (first >= nnodes) {
+                break;
+            }
+            final int nchildren = Math.min(TREE_FANOUT, nnodes - first);
+            nodes[i].edges = new Object[nchildren];
+            for (int j = 0; j < nchildren; j++) {
+                nodes[i].edges[j] = nodes[first + j];
+            }
+        }
+        return nodes.length > 0 ? nodes[0] : null;
+    }
+
+    private static Object buildList(int nnodes) {
+        Node head = null;
+        for (int i = 0; i < nnodes; i++) {
+            final Node node = new Node();
+            node.next = head;
+            head = node;
+        }
+        return head;
+    }
+
+    private static Object buildArray(int nnodes) {
+        final Object[] array = new Object[nnodes];
+        for (int i = 0; i < nnodes; i++) {
+            array[i] = new Node();
+        }
+        return array;
+    }
+
+    private static Object buildGraph(int nnodes) {
+        final Random random = new Random(SEED);
+        final Node[] nodes = new Node[nnodes];
+        for (int i = 0; i < nnodes; i++) {
+            nodes[i] = new Node();
+        }
+        for (int i = 0; i < nnodes; i++) {
+            nodes[i].edges = new Object[GRAPH_EDGES_PER_NODE];
+            for (int j = 0; j < GRAPH_EDGES_PER_NODE; j++) {
+                nodes[i].edges[j] = nodes[random.nextInt(nnodes)];
+            }
+        }
+        // Keep only a single node reachable from the root, so that
+        // marking has to follow the random edges
+        return nodes.length > 0 ? nodes[0] : null;
+    }
+
+    private static Object build(String shape, int nnodes) {
+        switch (shape) {
+        case "tree":  return buildTree(nnodes);
+        case "list":  return buildList(nnodes);
+        case "array": return buildArray(nnodes);
+        case "graph": return buildGraph(nnodes);
+        default:
+            throw new IllegalArgumentException("Unknown shape: " + shape);
+        }
+    }
+
+    public static void main(String[] args) {
+        if (args.length != 3) {
+            throw new IllegalArgumentException("Usage: TestMarkBenchmark <tree|list|array|graph> <nodes> <cycles>");
+        }
+
+        final String shape = args[0];
+        final int nnodes = Integer.parseInt(args[1]);
+        final int ncycles = Integer.parseInt(args[2]);
+
+        root = build(shape, nnodes);
+
+        // Warm up, and let the heap settle
+        System.gc();
+
+        for (int i = 0; i < ncycles; i++) {
+            final long start = System.nanoTime();
+            System.gc();
+            final long end = System.nanoTime();
+            System.out.println("Cycle " + i + " (" + shape + ", " + nnodes + " nodes): " +
+                               (end - start) / 1000000.0 + "ms");
+        }
+
+        if (root == null && nnodes > 0) {
+            throw new RuntimeException("Root lost");
+        }
+    }
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.z;
+
+/*
+ * @test TestPageAllocatorBenchmark
+ * @requires vm.gc.Z & !vm.graal.enabled
+ * @summary Allocate and free small, medium and large pages from several threads
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xms128M -Xmx512M -XX:ZUncommitDelay=1 -Xlog:gc,gc+stats gc.z.TestPageAllocatorBenchmark 4 5 mixed 50
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xms128M -Xmx512M -XX:ZUncommitDelay=1 -Xlog:gc,gc+stats gc.z.TestPageAllocatorBenchmark 4 5 large 2
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xms128M -Xmx512M -XX:SoftMaxHeapSize=256M -XX:ZAllocationPartitions=Thread-0:64M,Thread-1:128M -Xlog:gc,gc+heap,gc+stats gc.z.TestPageAllocatorBenchmark 4 5 mixed 50
+ */
+
+import java.util.Arrays;
+import java.util.Random;
+
+//
+// Stresses the page allocator by allocating objects that are placed on
+// medium and large pages, and small objects that fill small pages, from a
+// number of threads. Each thread keeps a ring of recently allocated
+// objects alive, and the size of the ring controls how much of the
+// allocated memory survives, and so how often the page cache and the
+// commit path are hit. Uncommit is enabled, with a short delay, so that
+// memory is also returned and recommitted during the run.
+//
+// Each thread records the latency of every medium and large allocation,
+// since these go to the page allocator directly, and the percentiles are
+// printed at the end. The page allocator lock contention, the page
+// allocation latency histogram and the commit, uncommit, map and unmap
+// operation rates are printed by the VM with -Xlog:gc+stats. To
+// benchmark, run with a longer duration, for example:
+//
+//   java -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx8G
+//        -XX:ZUncommitDelay=1 -Xlog:gc+stats
+//        gc.z.TestPageAllocatorBenchmark 16 60 mixed 100
+//
+// Arguments: <threads> <seconds> <small|medium|large|mixed> <ring size>
+//
+public class TestPageAllocatorBenchmark {
+    private static final long SEED = 4711;
+
+    // Object sizes, in bytes, placed on the different page types,
+    // assuming the default page sizes (2M small, 32M medium pages)
+    private static final int SMALL_SIZE_MAX  = 64 * 1024;
+    private static final int MEDIUM_SIZE_MIN = 512 * 1024;
+    private static final int MEDIUM_SIZE_MAX = 4 * 1024 * 1024;
+    private static final int LARGE_SIZE_MIN  = 8 * 1024 * 1024;
+    private static final int LARGE_SIZE_MAX  = 32 * 1024 * 1024;
+
+    private static final int MAX_SAMPLES = 1 << 20;
+
+    static class Worker extends Thread {
+        private final String mix;
+        private final Object[] ring;
+        private final long deadline;
+        private final Random random;
+        private final long[] samples = new long[MAX_SAMPLES];
+        private int nsamples;
+        private long nallocations;
+
+        Worker(int id, String mix, int ringSize, long deadline) {
+            this.mix = mix;
+            this.ring = new Object[ringSize];
+            this.deadline = deadline;
+            this.random = new Random(SEED + id);
+        }
+
+        private int nextSize() {
+            String type = mix;
+            if (type.equals("mixed")) {
+                // Mostly small objects, with some medium and large
+                final int r = random.nextInt(100);
+                type = r < 90 ? "small" : (r < 98 ? "medium" : "large");
+            }
+
+            switch (type) {
+            case "small":  return 16 + random.nextInt(SMALL_SIZE_MAX - 16);
+            case "medium": return MEDIUM_SIZE_MIN + random.nextInt(MEDIUM_SIZE_MAX - MEDIUM_SIZE_MIN);
+            case "large":  return LARGE_SIZE_MIN + random.nextInt(LARGE_SIZE_MAX - LARGE_SIZE_MIN);
+            default:
+                throw new IllegalArgumentException("Unknown mix: " + mix);
+            }
+        }
+
+        @Override
+        public void run() {
+            int next = 0;
+            while (System.nanoTime() < deadline) {
+                final int size = nextSize();
+                final long start = System.nanoTime();
+                final byte[] object = new byte[size];
+                final long end = System.nanoTime();
+
+                if (size >= MEDIUM_SIZE_MIN && nsamples < samples.length) {
+                    samples[nsamples++] = end - start;
+                }
+
+                ring[next] = object;
+                next = (next + 1) % ring.length;
+                nallocations++;
+            }
+        }
+    }
+
+    private static long percentile(long[] sorted, double percentile) {
+        if (sorted.length == 0) {
+            return 0;
+        }
+        final int index = (int)Math.min(sorted.length - 1, Math.round(sorted.length * percentile / 100.0));
+        return sorted[index];
+    }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length != 4) {
+            throw new IllegalArgumentException("Usage: TestPageAllocatorBenchmark <threads> <seconds> <small|medium|large|mixed> <ring size>");
+        }
+
+        final int nthreads = Integer.parseInt(args[0]);
+        final int seconds = Integer.parseInt(args[1]);
+        final String mix = args[2];
+        final int ringSize = Integer.parseInt(args[3]);
+        final long deadline = System.nanoTime() + seconds * 1_000_000_000L;
+
+        final Worker[] workers = new Worker[nthreads];
+        for (int i = 0; i < nthreads; i++) {
+            workers[i] = new Worker(i, mix, ringSize, deadline);
+            workers[i].start();
+        }
+
+        long nallocations = 0;
+        int nsamples = 0;
+        for (Worker worker : workers) {
+            worker.join();
+            nallocations += worker.nallocations;
+            nsamples += worker.nsamples;
+        }
+
+        // Merge latency samples
+        final long[] samples = new long[nsamples];
+        int offset = 0;
+        for (Worker worker : workers) {
+            System.arraycopy(worker.samples, 0, samples, offset, worker.nsamples);
+            offset += worker.nsamples;
+        }
+        Arrays.sort(samples);
+
+        System.out.println("Allocations: " + nallocations + " (" + nallocations / seconds + "/s), " +
+                           "medium/large samples: " + nsamples);
+        System.out.println("Medium/large allocation latency (ns): " +
+                           "p50 " + percentile(samples, 50) + ", " +
+                           "p90 " + percentile(samples, 90) + ", " +
+                           "p99 " + percentile(samples, 99) + ", " +
+                           "p99.9 " + percentile(samples, 99.9) + ", " +
+                           "max " + percentile(samples, 100));
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.z;
+
+/*
+ * @test TestPageHotness
+ * @requires vm.gc.Z & !vm.graal.enabled
+ * @summary Relocate pages while their hotness is sampled
+ * @library /test/lib
+ * @run driver gc.z.TestPageHotness
+ */
+
+import java.util.ArrayList;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+//
+// Runs a workload with fragmented pages, some of which are kept hot by
+// a thread reading their objects, with page hotness sampling enabled.
+// Sampling needs idle page tracking, and disables itself at startup when
+// that is not available, which must be logged. Either way, the GC cycles
+// must relocate the pages without corrupting the surviving objects.
+//
+public class TestPageHotness {
+    static class Test {
+        private static final int OBJECT_SIZE = 1024;
+        private static final long LIVE_SIZE = 64 * 1024 * 1024;
+
+        private static volatile boolean done;
+        private static volatile long sink;
+
+        private static ArrayList<byte[]> allocate() {
+            final ArrayList<byte[]> objects = new ArrayList<>();
+            for (long size = 0; size < LIVE_SIZE; size += OBJECT_SIZE) {
+                final byte[] object = new byte[OBJECT_SIZE];
+                object[0] = (byte)objects.size();
+                objects.add(object);
+            }
+
+            // Fragment the pages
+            for (int i = 0; i < objects.size(); i += 2) {
+                objects.set(i, null);
+            }
+
+            return objects;
+        }
+
+        private static void verify(ArrayList<byte[]> objects) {
+            for (int i = 0; i < objects.size(); i++) {
+                final byte[] object = objects.get(i);
+                if (object != null && object[0] != (byte)i) {
+                    throw new RuntimeException("Object " + i + " corrupted");
+                }
+            }
+        }
+
+        public static void main(String[] args) throws Exception {
+            final ArrayList<byte[]> cold = allocate();
+            final ArrayList<byte[]> hot = allocate();
+
+            final Thread reader = new Thread(() -> {
+                while (!done) {
+                    long sum = 0;
+                    for (byte[] object : hot) {
+                        if (object != null) {
+                            sum += object[0];
+                        }
+                    }
+                    sink = sum;
+                }
+            });
+            reader.start();
+
+            // Let the sampler run a few times between the GC cycles
+            for (int i = 0; i < 3; i++) {
+                Thread.sleep(1500);
+                System.gc();
+            }
+
+            done = true;
+            reader.join();
+
+            verify(cold);
+            verify(hot);
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        final ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:+UnlockExperimentalVMOptions",
+            "-XX:+UseZGC",
+            "-Xmx512M",
+            "-XX:ZPageHotnessInterval=1",
+            "-Xlog:gc,gc+init",
+            Test.class.getName());
+        final OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        System.out.println(output.getStdout());
+        output.shouldHaveExitValue(0);
+        output.shouldMatch("Page Hotness Sampling: (Enabled|Disabled)");
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.z;
+
+/*
+ * @test TestParallelHeapDump
+ * @requires vm.gc.Z & !vm.graal.enabled
+ * @summary Test that a heap dump written by multiple threads is a valid HPROF file
+ * @library /test/lib
+ * @modules jdk.management
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx512M -XX:HeapDumpParallelThreads=4 gc.z.TestParallelHeapDump
+ */
+
+import com.sun.management.HotSpotDiagnosticMXBean;
+import java.io.BufferedInputStream;
+import java.io.File;
+import java.io.FileInputStream;
+import java.lang.management.ManagementFactory;
+import java.util.ArrayList;
+import jdk.test.lib.hprof.model.JavaClass;
+import jdk.test.lib.hprof.model.Snapshot;
+import jdk.test.lib.hprof.parser.HprofReader;
+import jdk.test.lib.hprof.parser.PositionDataInputStream;
+
+//
+// Dumps a heap with a known number of live objects, using multiple
+// threads, and checks that the dump file parses as a valid HPROF file,
+// that it holds an instance record for each of the live objects, and
+// that no part files are left behind.
+//
+public class TestParallelHeapDump {
+    private static final int OBJECT_SIZE = 64 * 1024;
+    private static final long LIVE_SIZE = 32 * 1024 * 1024;
+
+    private static class Live {
+        private final byte[] data = new byte[OBJECT_SIZE];
+    }
+
+    private static ArrayList<Live> live = new ArrayList<>();
+
+    private static void verify(File file) throws Exception {
+        if (!file.isFile()) {
+            throw new RuntimeException("Dump file not created: " + file);
+        }
+
+        if (file.length() < LIVE_SIZE) {
+            throw new RuntimeException("Dump file too small: " + file.length() + " bytes");
+        }
+
+        try (PositionDataInputStream in = new PositionDataInputStream(
+                new BufferedInputStream(new FileInputStream(file)))) {
+            final int magic = in.readInt();
+            if (!HprofReader.verifyMagicNumber(magic)) {
+                throw new RuntimeException("Invalid HPROF magic number: " + magic);
+            }
+
+            final HprofReader reader = new HprofReader(file.getPath(), in, 0, false, 0);
+            final Snapshot snapshot = reader.read();
+            snapshot.resolve(true);
+
+            final JavaClass clazz = snapshot.findClass(Live.class.getName());
+            if (clazz == null) {
+                throw new RuntimeException("Class record not found: " + Live.class.getName());
+            }
+
+            final int instances = clazz.getInstancesCount(false /* includeSubclasses */);
+            if (instances != live.size()) {
+                throw new RuntimeException("Instance records: " + instances + ", expected: " + live.size());
+            }
+        }
+
+        final File[] parts = file.getAbsoluteFile().getParentFile().listFiles(
+            (dir, name) -> name.startsWith(file.getName() + ".") && name.endsWith(".part"));
+        if (parts != null && parts.length != 0) {
+            throw new RuntimeException("Part files left behind: " + parts.length);
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        for (long size = 0; size < LIVE_SIZE; size += OBJECT_SIZE) {
+            live.add(new Live());
+        }
+
+        final File file = new File("TestParallelHeapDump.hprof");
+        file.delete();
+
+        final HotSpotDiagnosticMXBean bean = ManagementFactory.getPlatformMXBean(HotSpotDiagnosticMXBean.class);
+        bean.dumpHeap(file.getPath(), true /* live */);
+
+        System.out.println(live.size() + " objects live, dump file " + file.length() + " bytes");
+
+        try {
+            verify(file);
+        } finally {
+            file.delete();
+        }
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.z;
+
+/*
+ * @test TestPhaseControl
+ * @requires vm.gc.Z & !vm.graal.enabled
+ * @summary Hold ZGC at specific phases and relocate a fixed set of pages
+ * @library /test/lib
+ * @build sun.hotspot.WhiteBox
+ * @run driver ClassFileInstaller sun.hotspot.WhiteBox
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx256M -Xlog:gc,gc+reloc gc.z.TestPhaseControl
+ */
+
+import sun.hotspot.WhiteBox;
+
+//
+// Steps a GC cycle through the concurrent phases that can be requested,
+// with a relocation set consisting of only the page of a given object.
+// While the driver is held before Pause Relocate Start, the relocation
+// set is fixed and no objects have been moved, so a benchmark can set up
+// its state here, and then measure, for example, barrier slow paths while
+// the relocation runs.
+//
+public class TestPhaseControl {
+    private static final WhiteBox WB = WhiteBox.getWhiteBox();
+
+    // CONCURRENT_CYCLE is left out, since it is only left at the end of
+    // the cycle, and requesting it doesn't hold the driver at any phase
+    private static final String[] PHASES = {
+        "CONCURRENT_MARK",
+        "MARK_COMPLETED",
+        "BEFORE_RELOCATE_START",
+        "CONCURRENT_RELOCATE",
+        "CONCURRENT_REMAP",
+    };
+
+    private static Object[] objects;
+
+    public static void main(String[] args) throws Exception {
+        if (!WB.supportsConcurrentGCPhaseControl()) {
+            throw new RuntimeException("Concurrent phase control should be supported");
+        }
+
+        objects = new Object[1000];
+        for (int i = 0; i < objects.length; i++) {
+            objects[i] = new byte[64];
+        }
+
+        final long contention = WB.zStatCounter("Contention", "Relocation Contention");
+        if (contention < 0) {
+            throw new RuntimeException("Relocation Contention counter not found");
+        }
+
+        if (WB.zStatCounter("Contention", "No Such Counter") != -1) {
+            throw new RuntimeException("Unknown counters should not be found");
+        }
+
+        // Relocate only the page holding the first object
+        WB.zForceRelocation(objects[0]);
+
+        for (String phase : PHASES) {
+            System.out.println("Requesting " + phase);
+            WB.requestConcurrentGCPhase(phase);
+            System.out.println("Reached " + phase);
+        }
+
+        // Let the cycle complete, and wait until idle
+        WB.requestConcurrentGCPhase("IDLE");
+        WB.requestConcurrentGCPhase("ANY");
+
+        for (int i = 0; i < objects.length; i++) {
+            if (((byte[])objects[i]).length != 64) {
+                throw new RuntimeException("Object " + i + " corrupted");
+            }
+        }
+
+        System.out.println("Relocation Contention: " +
+                           (WB.zStatCounter("Contention", "Relocation Contention") - contention));
+
+        try {
+            WB.requestConcurrentGCPhase("NO_SUCH_PHASE");
+            throw new RuntimeException("Unknown phases should be rejected");
+        } catch (IllegalArgumentException e) {
+            // Expected
+        }
+    }
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.z;
+
+/*
+ * @test TestRelocationBenchmark
+ * @requires vm.gc.Z & !vm.graal.enabled
+ * @summary Relocate synthetic heaps with controlled live ratios and object sizes
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx512M -XX:ZFragmentationLimit=1 -XX:ConcGCThreads=2 -XX:-UseDynamicNumberOfGCThreads -Xlog:gc+reloc=debug gc.z.TestRelocationBenchmark 50 64 0 0 64 2
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx512M -XX:ZFragmentationLimit=1 -XX:ConcGCThreads=2 -XX:-UseDynamicNumberOfGCThreads -Xlog:gc+reloc=debug gc.z.TestRelocationBenchmark 50 64 2 50 64 2
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx512M -XX:ZFragmentationLimit=1 -XX:ConcGCThreads=2 -XX:-UseDynamicNumberOfGCThreads -Xlog:gc+reloc=debug gc.z.TestRelocationBenchmark 50 524288 2 50 64 2
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx512M -XX:ZFragmentationLimit=1 -XX:ConcGCThreads=2 -XX:-UseDynamicNumberOfGCThreads -Xlog:gc+reloc=debug gc.z.TestRelocationBenchmark 90 64 2 50 320 2
+ * @run main/othervm -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx512M -XX:ZFragmentationLimit=1 -XX:ConcGCThreads=2 -XX:-UseDynamicNumberOfGCThreads -XX:+ZKeepTLABsAtMarkStart -Xlog:gc+reloc=debug,gc+tlab=debug gc.z.TestRelocationBenchmark 50 64 2 50 64 4
+ */
+
+import java.util.ArrayList;
+import java.util.Random;
+
+//
+// Builds a synthetic heap where a controlled fraction of the objects of a
+// given size are kept alive, and runs a number of GC cycles over it while
+// mutator threads touch a fraction of the live objects. Touching an object
+// that is being relocated makes the mutator relocate it, which contends
+// with the GC workers. Filling most of the heap leaves too little free
+// memory to relocate into, which forces pages to be pinned and relocated
+// in-place.
+//
+// The relocation throughput and tail, the time spent waiting for the last
+// workers and assisting threads after the first worker ran out of pages,
+// are printed per cycle with -Xlog:gc+reloc. Contention counts, and the
+// time spent waiting for objects copied by other threads or for pages to
+// be relocated in-place, are printed with -Xlog:gc+stats. To benchmark,
+// run with a larger heap and more cycles, and with an exact number of
+// workers, for example:
+//
+//   java -XX:+UnlockExperimentalVMOptions -XX:+UseZGC -Xmx16G
+//        -XX:ZFragmentationLimit=1 -XX:ConcGCThreads=8
+//        -XX:-UseDynamicNumberOfGCThreads -XX:ZStatisticsInterval=1
+//        -Xlog:gc+reloc,gc+stats gc.z.TestRelocationBenchmark 25 64 8 10 8192 10
+//
+// Arguments:
+//   live     - percentage of the allocated objects kept alive
+//   size     - object size in bytes, which selects the page type; objects
+//              larger than 256K are allocated in medium pages, and objects
+//              larger than 4M in large pages
+//   mutators - number of mutator threads touching live objects
+//   touch    - percentage of the live objects touched per pass
+//   fill     - megabytes allocated, before dropping the dead objects
+//   cycles   - number of GC cycles to run
+//
+public class TestRelocationBenchmark {
+    private static final int HEADER_SIZE = 16;
+    private static final long SEED = 4711;
+
+    private static volatile Object[] live;
+    private static volatile boolean done;
+    private static volatile long sink;
+
+    private static Object[] build(int livePercent, int size, long fill) {
+        final Random random = new Random(SEED);
+        final int length = Math.max(size - HEADER_SIZE, 0);
+        final long nobjects = Math.max(fill / Math.max(size, HEADER_SIZE), 1);
+        final ArrayList<byte[]> kept = new ArrayList<>();
+
+        // Interleave live and dead objects, so that
+        // all pages end up with the same live ratio
+        for (long i = 0; i < nobjects; i++) {
+            final byte[] object = new byte[length];
+            if (random.nextInt(100) < livePercent) {
+                kept.add(object);
+            }
+        }
+
+        return kept.toArray();
+    }
+
+    private static class Mutator extends Thread {
+        private final int touchPercent;
+        private final Random random;
+        private long ntouched;
+
+        Mutator(int id, int touchPercent) {
+            super("Mutator-" + id);
+            this.touchPercent = touchPercent;
+            this.random = new Random(SEED + id);
+            setDaemon(true);
+        }
+
+        @Override
+        public void run() {
+            long sum = 0;
+            while (!done) {
+                final Object[] objects = live;
+                for (int i = 0; i < objects.length && !done; i++) {
+                    if (random.nextInt(100) < touchPercent) {
+                        // Loading the reference takes the load barrier,
+                        // which relocates the object if its page is
+                        // in the relocation set
+                        final byte[] object = (byte[])objects[i];
+                        sum += object.length;
+                        ntouched++;
+                    }
+                }
+            }
+            sink += sum;
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length != 6) {
+            throw new IllegalArgumentException("Usage: TestRelocationBenchmark <live> <size> <mutators> <touch> <fill> <cycles>");
+        }
+
+        final int livePercent = Integer.parseInt(args[0]);
+        final int size = Integer.parseInt(args[1]);
+        final int nmutators = Integer.parseInt(args[2]);
+        final int touchPercent = Integer.parseInt(args[3]);
+        final long fill = Long.parseLong(args[4]) * 1024 * 1024;
+        final int ncycles = Integer.parseInt(args[5]);
+
+        live = build(livePercent, size, fill);
+
+        final Mutator[] mutators = new Mutator[nmutators];
+        for (int i = 0; i < nmutators; i++) {
+            mutators[i] = new Mutator(i, touchPercent);
+            mutators[i].start();
+        }
+
+        for (int i = 0; i < ncycles; i++) {
+            final long start = System.nanoTime();
+            System.gc();
+            final long end = System.nanoTime();
+            System.out.println("Cycle " + i + " (" + livePercent + "% live, " + size + " bytes, " +
+                               nmutators + " mutators, " + touchPercent + "% touched): " +
+                               (end - start) / 1000000.0 + "ms");
+        }
+
+        done = true;
+        long ntouched = 0;
+        for (Mutator mutator : mutators) {
+            mutator.join();
+            ntouched += mutator.ntouched;
+        }
+
+        System.out.println("Touched " + ntouched + " objects");
+
+        if (live.length == 0 && livePercent > 0) {
+            throw new RuntimeException("Live objects lost");
+        }
+    }
+}
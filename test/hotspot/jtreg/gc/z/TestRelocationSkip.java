@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package gc.z;
+
+/*
+ * @test TestRelocationSkip
+ * @requires vm.gc.Z & !vm.graal.enabled
+ * @summary Run GC cycles after cycles that skipped relocation
+ * @library /test/lib
+ * @run driver gc.z.TestRelocationSkip
+ */
+
+import java.util.ArrayList;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+//
+// Runs timer GC cycles with a relocation skip limit that makes all of
+// them skip relocation, and therefore leave the heap in the mark
+// completed phase, and then an explicit GC cycle, which never skips
+// relocation. The explicit cycle must start from the skipped cycles,
+// finish their class unloading, and relocate the fragmented pages
+// without corrupting the surviving objects.
+//
+public class TestRelocationSkip {
+    private static final int MIN_SKIPPED = 2;
+
+    static class Test {
+        private static final int OBJECT_SIZE = 1024;
+        private static final long LIVE_SIZE = 32 * 1024 * 1024;
+
+        public static void main(String[] args) throws Exception {
+            final ArrayList<byte[]> objects = new ArrayList<>();
+            for (long size = 0; size < LIVE_SIZE; size += OBJECT_SIZE) {
+                final byte[] object = new byte[OBJECT_SIZE];
+                object[0] = (byte)objects.size();
+                objects.add(object);
+            }
+
+            // Fragment the pages
+            for (int i = 0; i < objects.size(); i += 2) {
+                objects.set(i, null);
+            }
+
+            // Let a few timer cycles skip relocation
+            Thread.sleep(5000);
+
+            System.gc();
+
+            for (int i = 0; i < objects.size(); i++) {
+                final byte[] object = objects.get(i);
+                if (object != null && object[0] != (byte)i) {
+                    throw new RuntimeException("Object " + i + " corrupted");
+                }
+            }
+        }
+    }
+
+    private static int count(String pattern, String output) {
+        final Matcher matcher = Pattern.compile(pattern).matcher(output);
+        int count = 0;
+        while (matcher.find()) {
+            count++;
+        }
+        return count;
+    }
+
+    public static void main(String[] args) throws Exception {
+        final ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:+UnlockExperimentalVMOptions",
+            "-XX:+UnlockDiagnosticVMOptions",
+            "-XX:+UseZGC",
+            "-Xmx256M",
+            "-XX:ZCollectionInterval=1",
+            "-XX:ZRelocationSkipLimit=100",
+            "-XX:+ZVerifyRoots",
+            "-XX:+ZVerifyObjects",
+            "-Xlog:gc,gc+reloc",
+            Test.class.getName());
+        final OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        System.out.println(output.getStdout());
+        output.shouldHaveExitValue(0);
+
+        final String stdout = output.getStdout();
+        final int skipped = count("Relocation Skipped", stdout);
+        if (skipped < MIN_SKIPPED) {
+            throw new RuntimeException("Too few cycles skipped relocation: " + skipped);
+        }
+
+        if (count("Garbage Collection \\(System.gc\\(\\)\\)", stdout) != 1) {
+            throw new RuntimeException("Explicit GC cycle not completed");
+        }
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2020, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test TestAsyncLogging
+ * @summary Test that -Xlog:async writes the messages of file outputs
+ * @library /test/lib
+ * @modules java.base/jdk.internal.misc
+ * @run driver TestAsyncLogging
+ */
+
+import java.io.File;
+import java.nio.file.Files;
+import java.util.List;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+//
+// Runs a VM logging to a file asynchronously, and checks that the
+// messages logged during startup and at exit reach the file, that stdout
+// is still written synchronously, and that a VM logging much more than
+// the smallest buffer holds still exits normally, with any dropped
+// messages reported in the file.
+//
+public class TestAsyncLogging {
+    static class Test {
+        public static void main(String[] args) throws Exception {
+            for (int i = 0; i < 10; i++) {
+                System.gc();
+            }
+            System.out.println("Test done");
+        }
+    }
+
+    private static List<String> run(String file, String... options) throws Exception {
+        new File(file).delete();
+
+        final String[] args = new String[options.length + 3];
+        args[0] = "-Xlog:async";
+        System.arraycopy(options, 0, args, 1, options.length);
+        args[options.length + 1] = "-Xlog:gc:stdout";
+        args[options.length + 2] = Test.class.getName();
+
+        final ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(args);
+        final OutputAnalyzer output = new OutputAnalyzer(pb.start());
+        output.shouldHaveExitValue(0);
+        output.shouldContain("Test done");
+        output.shouldContain("Using ");
+
+        final List<String> lines = Files.readAllLines(new File(file).toPath());
+        new File(file).delete();
+        return lines;
+    }
+
+    private static boolean contains(List<String> lines, String str) {
+        for (String line : lines) {
+            if (line.contains(str)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    public static void main(String[] args) throws Exception {
+        // All messages fit in the default buffer
+        final List<String> lines = run("async.log", "-Xlog:gc*=debug,safepoint=debug:file=async.log");
+        if (!contains(lines, "Using ")) {
+            throw new RuntimeException("GC initialization not logged to file");
+        }
+        if (!contains(lines, "Pause") && !contains(lines, "Safepoint")) {
+            throw new RuntimeException("GC cycles not logged to file");
+        }
+
+        // Far more messages than the smallest buffer holds
+        final List<String> flood = run("async-flood.log", "-XX:AsyncLogBufferSize=100K", "-Xlog:all=trace:file=async-flood.log");
+        if (flood.isEmpty()) {
+            throw new RuntimeException("Nothing logged to file");
+        }
+        System.out.println(contains(flood, "messages dropped due to async logging") ?
+                           "Dropped messages reported" : "No messages dropped");
+    }
+}